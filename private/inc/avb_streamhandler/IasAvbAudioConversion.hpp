@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbAudioConversion.hpp
+ * @brief   Conversion kernels between local audio samples and AAF or IEC 61883-6 payloads.
+ * @details Each kernel converts the samples of one channel to or from the big endian
+ *          wire format of an AAF stream (SAF16, SAF24, SAF32 or float) or an IEC 61883-6
+ *          stream (AM824 quadlets, label 0x40 followed by 24 bit MBLA data) and steps
+ *          through the interleaved payload by the given stride. Besides a scalar
+ *          version, there are SSE2 and AVX2 versions that convert a block of samples
+ *          per iteration. The best version supported by the CPU is detected once at
+ *          runtime and selected per format with getPackFunction()/getUnpackFunction().
+ *
+ *          Local samples are of the type selected at build time (IasLocalAudioBuffer::AudioData).
+ *          Integer samples are carried in the most significant bits, on reception the least
+ *          significant bits not covered by the local sample are dropped. Float samples have a full
+ *          scale of 1.0 and are saturated on reception if the local sample is an integer.
+ *          The SSE2/AVX2 kernels exist for 16 bit local samples, 32 bit local samples use the
+ *          scalar kernels. On reception of AM824, quadlets that don't carry an MBLA label are muted.
+ *
+ *          interleave()/deinterleave() convert between the planar layout of the local
+ *          audio buffers and the frame layout of the payload, so a packet can be converted
+ *          with a single contiguous kernel call for all channels. For the common channel
+ *          counts, the frame kernels do both steps in one pass.
+ *
+ *          scale()/mix() apply a gain to the samples of a channel, for the channel routing
+ *          of the audio streams. Integer samples are saturated.
+ * @date    2018
+ */
+
+#ifndef IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBAUDIOCONVERSION_HPP
+#define IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBAUDIOCONVERSION_HPP
+
+#include "IasAvbTypes.hpp"
+#include "IasLocalAudioBuffer.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbAudioConversion
+{
+  public:
+    typedef IasLocalAudioBuffer::AudioData AudioData;
+
+    /**
+     * @brief Instruction set a kernel is built for, ordered by preference.
+     */
+    enum Isa
+    {
+      eIsaScalar = 0,
+      eIsaSse2   = 1,
+      eIsaAvx2   = 2,
+    };
+
+    /// full scale of float samples for 16 bit local samples, in line with the float gain used elsewhere (audio.tx.floatconversiongain)
+    static const int32_t cFloatScale = 0x7FFF;
+
+    /// fractional bits of the fixed point gain applied to integer samples by scale() and mix()
+    static const int32_t cGainFracBits = 12;
+
+    /// largest gain magnitude for integer samples, larger gains are limited to it
+    static constexpr float cMaxGain = 8.0f;
+
+    /**
+     * @brief Writes numSamples samples of src to dst in wire format, advancing dst by stride bytes per sample.
+     */
+    typedef void (*PackFunction)(const AudioData *src, uint8_t *dst, uint32_t numSamples, uint32_t stride);
+
+    /**
+     * @brief Reads numSamples samples in wire format from src, advancing src by stride bytes per sample.
+     */
+    typedef void (*UnpackFunction)(const uint8_t *src, AudioData *dst, uint32_t numSamples, uint32_t stride);
+
+    /**
+     * @brief Interleaves numSamples samples of each channel and writes the frames to dst in wire format.
+     *
+     * The samples of channel n are read from src[n * pitch]. The channel count is fixed per kernel.
+     */
+    typedef void (*PackFramesFunction)(const AudioData *src, uint32_t pitch, uint8_t *dst, uint32_t numSamples);
+
+    /**
+     * @brief Reads numSamples frames in wire format from src and splits them into channels, channel n is written to dst[n * pitch].
+     */
+    typedef void (*UnpackFramesFunction)(const uint8_t *src, AudioData *dst, uint32_t pitch, uint32_t numSamples);
+
+    /**
+     * @brief Returns the best instruction set supported by both the build and the CPU.
+     */
+    static Isa getIsa();
+
+    /**
+     * @brief Returns the name of the instruction set, for logging.
+     */
+    static const char * getIsaName(Isa isa);
+
+    /**
+     * @brief Returns the kernel for the given format.
+     *
+     * If isa isn't available, the next lower one is used.
+     *
+     * @returns NULL if the format isn't supported
+     */
+    static PackFunction getPackFunction(IasAvbAudioFormat format, Isa isa = getIsa());
+
+    /**
+     * @brief Returns the kernel for the given format.
+     *
+     * If isa isn't available, the next lower one is used.
+     *
+     * @returns NULL if the format isn't supported
+     */
+    static UnpackFunction getUnpackFunction(IasAvbAudioFormat format, Isa isa = getIsa());
+
+    /**
+     * @brief Interleaves the samples of numChannels channels to frames.
+     *
+     * The samples of channel n are read from src[n * pitch], frame k is written to
+     * dst[k * numChannels]. For 16 bit samples SSE2 is used if available, a block of eight channels
+     * is transposed per step.
+     */
+    static void interleave(const AudioData *src, uint32_t pitch, AudioData *dst, uint16_t numChannels, uint32_t numSamples);
+
+    /**
+     * @brief Splits numSamples frames of numChannels channels into channels, the reverse of interleave().
+     */
+    static void deinterleave(const AudioData *src, AudioData *dst, uint32_t pitch, uint16_t numChannels, uint32_t numSamples);
+
+    /**
+     * @brief Returns a kernel that combines interleave() and the pack kernel for the given format.
+     *
+     * The kernels are instantiated for the common channel counts 1, 2, 4, 6 and 8, so the loop over
+     * the channels of a frame is unrolled at compile time. For AM824 and 16 bit samples, the frames
+     * of 2 to 8 channels are converted with SSE2 if available.
+     *
+     * @returns NULL if the format or the channel count isn't supported, use interleave() and
+     *          getPackFunction() instead
+     */
+    static PackFramesFunction getPackFramesFunction(IasAvbAudioFormat format, uint16_t numChannels);
+
+    /**
+     * @brief Returns a kernel that combines the unpack kernel for the given format and deinterleave().
+     *
+     * @returns NULL if the format or the channel count isn't supported, see getPackFramesFunction()
+     */
+    static UnpackFramesFunction getUnpackFramesFunction(IasAvbAudioFormat format, uint16_t numChannels);
+
+    /**
+     * @brief Writes numSamples samples of src multiplied by gain to dst.
+     *
+     * For integer samples, the gain is applied in fixed point with cGainFracBits fractional bits
+     * and the result is saturated. For 16 bit samples, SSE2 is used if available.
+     */
+    static void scale(const AudioData *src, AudioData *dst, float gain, uint32_t numSamples);
+
+    /**
+     * @brief Adds numSamples samples of src multiplied by gain to dst.
+     *
+     * Same as scale(), the sum is saturated for integer samples.
+     */
+    static void mix(const AudioData *src, AudioData *dst, float gain, uint32_t numSamples);
+
+  private:
+    /**
+     * @brief Constructor, private unimplemented, static helpers only.
+     */
+    IasAvbAudioConversion();
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBAUDIOCONVERSION_HPP */
@@ -28,7 +28,7 @@ namespace IasMediaTransportAvb {
 class IasAvbAudioShmProvider
 {
   public:
-    typedef int16_t AudioData;
+    typedef IasLocalAudioBuffer::AudioData AudioData;
 
     enum IasResult
     {
@@ -99,6 +99,11 @@ class IasAvbAudioShmProvider
      */
     inline const std::string & getDeviceName();
 
+    /**
+     * @brief Returns the data format of the samples in the shared memory, which is the local sample type.
+     */
+    static inline IasAudio::IasAudioCommonDataFormat getDataFormat();
+
 
   private:
 
@@ -133,6 +138,22 @@ class IasAvbAudioShmProvider
 
     inline bool hasBufferDesc() const;
 
+    /**
+     * @brief Write silence to the frames of one channel in the shared memory
+     *
+     * @param[in] shmData pointer to the first sample of the channel
+     * @param[in] frames number of frames to be silenced
+     * @param[in] step stride to the next sample in bytes
+     */
+    static void fillSilence(char *shmData, uint32_t frames, uint32_t step);
+
+    /**
+     * @brief Map the local sample type to the data format, resolved at compile time
+     */
+    static inline IasAudio::IasAudioCommonDataFormat toDataFormat(const int16_t *) { return IasAudio::eIasFormatInt16; }
+    static inline IasAudio::IasAudioCommonDataFormat toDataFormat(const int32_t *) { return IasAudio::eIasFormatInt32; }
+    static inline IasAudio::IasAudioCommonDataFormat toDataFormat(const float *)   { return IasAudio::eIasFormatFloat32; }
+
     /**
      * @brief Return TRUE if the ALSA prefilling feature is enabled
      */
@@ -177,6 +198,7 @@ class IasAvbAudioShmProvider
     bool                                   mIsClientSmartX;
     uint32_t                               mLastPtpEpoch;
     uint64_t                               mDbgLastTxBufOverrunIdx;
+    uint32_t                               mPlayoutTolerance;//!< Deviation from the presentation time left alone in presentation mode (samples)
 };
 
 
@@ -186,6 +208,12 @@ inline const std::string & IasAvbAudioShmProvider::getDeviceName()
 }
 
 
+inline IasAudio::IasAudioCommonDataFormat IasAvbAudioShmProvider::getDataFormat()
+{
+  return toDataFormat(static_cast<const AudioData*>(NULL));
+}
+
+
 inline bool IasAvbAudioShmProvider::hasBufferDesc() const
 {
   return (AudioBufferDescMode::eIasAudioBufferDescModeOff < mDescMode) &&
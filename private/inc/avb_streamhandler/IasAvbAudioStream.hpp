@@ -19,6 +19,9 @@
 #include "IasAvbStream.hpp"
 #include "IasLocalAudioBuffer.hpp"
 #include "IasLocalAudioStream.hpp"
+#include "IasAvbAudioConversion.hpp"
+#include "IasAvbSampleTime.hpp"
+#include <cmath>
 #include <fstream>
 #include <mutex>
 
@@ -58,6 +61,18 @@ class IasAvbAudioStream : public IasAvbStream, public virtual IasLocalAudioStrea
 
     IasAvbProcessingResult connectTo(IasLocalAudioStream* localStream);
 
+    /**
+     * @brief Sets the channel routing matrix between the AVB stream and the local stream.
+     *
+     * Each entry adds a source channel, multiplied by its gain, to a destination channel. Sources are
+     * AVB channels for receive streams and local channels for transmit streams. Destinations without
+     * an entry are silent. An empty list restores the 1:1 routing.
+     *
+     * @param[in] routing routing entries, all channel indices must be below the maximum number of channels
+     * @returns eIasAvbProcOK on success, eIasAvbProcInvalidParam if an entry is out of range
+     */
+    IasAvbProcessingResult setChannelRouting(const ChannelRoutingList & routing);
+
     static uint16_t getPacketSize(const IasAvbAudioFormat format, const uint16_t numSamples);
     static uint16_t getSampleSize(const IasAvbAudioFormat format);
     static uint8_t getFormatCode(const IasAvbAudioFormat format);
@@ -69,6 +84,7 @@ class IasAvbAudioStream : public IasAvbStream, public virtual IasLocalAudioStrea
     IasAvbAudioFormat getAudioFormat() const { return mAudioFormat;     }
     uint16_t getLocalNumChannels() const       { return (NULL != mLocalStream ? mLocalStream->getNumChannels() : 0); }
     uint16_t getLocalStreamId() const          { return (NULL != mLocalStream ? mLocalStream->getStreamId() : 0);    }
+    uint32_t getDbcDiscontinuities() const     { return mDbcDiscontinuities; }
 
   protected:
 
@@ -120,7 +136,15 @@ class IasAvbAudioStream : public IasAvbStream, public virtual IasLocalAudioStrea
     ///
     IasAvbProcessingResult prepareAllPackets();
     bool resetTime(uint64_t nextWindowStart);
+    void selectFrameKernels(uint16_t numChannels);
+    inline uint16_t getNetworkChannels(uint16_t numLocalChannels) const;
+    void routeChannels(const AudioData* src, uint32_t srcPitch, uint16_t numSrc, AudioData* dst, uint32_t dstPitch,
+                       uint16_t numDst, uint32_t numSamples) const;
+    void writeCipHeader(uint8_t* avtpBase8, uint16_t numChannels, uint16_t numSamples);
+    inline uint16_t getSytOffset(uint8_t dbc) const;
+    size_t getPayloadLength(const uint8_t* avtpBase8) const;
     static uint8_t getSampleFrequencyCode(uint32_t sampleFrequency);
+    static uint8_t getIec61883SampleFrequencyCode(uint32_t sampleFrequency);
     IasAvbCompatibility getCompatibilityModeAudio();
 
     ///
@@ -131,6 +155,7 @@ class IasAvbAudioStream : public IasAvbStream, public virtual IasLocalAudioStrea
     uint8_t                 mAudioFormatCode;
     uint16_t                mMaxNumChannels;
     IasLocalAudioStream   *mLocalStream;
+    uint16_t                mLocalReader;       // read cursor or mix source within mLocalStream
     uint32_t                mSampleFrequency;
     uint8_t                 mSampleFrequencyCode;
     uint64_t                mRefPlaneSampleCount;
@@ -148,10 +173,23 @@ class IasAvbAudioStream : public IasAvbStream, public virtual IasLocalAudioStrea
     uint16_t                mSamplesPerChannelPerPacket;
     uint16_t                mStride;
     uint8_t                 mSeqNum;
-    AudioData*            mTempBuffer;
+    AudioData*            mTempBuffer;     // planar samples of all channels of a packet
+    AudioData*            mFrameBuffer;    // same samples interleaved to frames
     AudioData             mConversionGain;
     bool                  mUseSaturation;
-    double               mSampleIntervalNs;
+    IasAvbAudioConversion::PackFunction   mPackSamples;    // local samples to payload, selected by format
+    IasAvbAudioConversion::UnpackFunction mUnpackSamples;  // payload to local samples, selected by format
+    // frame kernels and routing are changed and used under mLock only, see setChannelRouting()
+    IasAvbAudioConversion::PackFramesFunction   mPackFrames;     // interleave and pack, specialized for mFramesChannels
+    IasAvbAudioConversion::UnpackFramesFunction mUnpackFrames;   // unpack and deinterleave, specialized for mFramesChannels
+    uint16_t              mFramesChannels;
+    ChannelRoutingList    mRoutes;          // channel routing sorted by destination, empty for 1:1
+    uint16_t              mRoutedChannels;  // number of AVB channels addressed by mRoutes
+    AudioData*            mRouteBuffer;     // samples on the AVB side of the routing, planar
+    IasAvbSampleTime::Duration mSampleInterval;  // duration of one sample, 32.32 ns
+    uint8_t               mDbc;                  // IEC 61883: count of the next data block, sent or expected
+    uint16_t              mSytInterval;          // IEC 61883: data blocks between two time stamped ones
+    uint32_t              mDbcDiscontinuities;
     bool                  mWaitForData;
     double               mRatioBendRate;
     int32_t                 mRatioBendLimit;
@@ -182,9 +220,37 @@ inline bool IasAvbAudioStream::isConnected() const
   return (NULL != mLocalStream);
 }
 
+/*
+ * Returns the number of channels on the AVB side: the local channels for the 1:1 routing,
+ * otherwise the channels addressed by the routing (TX) or all channels the stream may carry (RX).
+ */
+inline uint16_t IasAvbAudioStream::getNetworkChannels(uint16_t numLocalChannels) const
+{
+  uint16_t numChannels = numLocalChannels;
+  if (!mRoutes.empty())
+  {
+    numChannels = isTransmitStream() ? mRoutedChannels : mMaxNumChannels;
+  }
+  return numChannels;
+}
+
+/*
+ * Returns the index of the first data block in a packet starting with dbc that is
+ * due for a time stamp, i.e. the one with DBC % SYT_INTERVAL == 0.
+ */
+inline uint16_t IasAvbAudioStream::getSytOffset(uint8_t dbc) const
+{
+  return (0u != mSytInterval) ? uint16_t((mSytInterval - (dbc % mSytInterval)) % mSytInterval) : 0u;
+}
+
 
 /**
  * @brief helper template to deal with audio format traits. Could go to separate header file later.
+ *
+ * The AAF formats also provide the scalar conversion of a single local sample to and from the
+ * big endian wire format, the reference for the vectorized kernels in IasAvbAudioConversion.
+ * Local samples of any type go through IasLocalAudioSampleTraits, so a high resolution local
+ * sample keeps its resolution in a SAF24/SAF32/float stream.
  */
 template<IasAvbAudioFormat>
 class IasAvbAudioFormatTraits;
@@ -192,12 +258,37 @@ class IasAvbAudioFormatTraits;
 static const uint16_t cIasAvtpHeaderSize = 24u;
 static const uint16_t cIasCipHeaderSize = 8u;
 
+/**
+ * IEC 61883-6 AM824 quadlets: label byte followed by a 24 bit big endian sample.
+ */
 template<>
 class IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883>
 {
   public:
     static const uint16_t cSampleSize = 4u;
     static const uint16_t cHeaderSize = cIasAvtpHeaderSize + cIasCipHeaderSize;
+    static const uint8_t  cLabel = 0x40u;       ///< multi-bit linear audio, 24 bit
+    static const uint8_t  cLabelMask = 0xFCu;   ///< labels 0x40..0x43 are multi-bit linear audio of 24..16 bits
+
+    static inline void pack(IasLocalAudioBuffer::AudioData sample, uint8_t *out)
+    {
+      const uint32_t value = uint32_t(IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::toInt32(sample));
+      out[0] = cLabel;
+      out[1] = uint8_t(value >> 24);
+      out[2] = uint8_t(value >> 16);
+      out[3] = uint8_t(value >> 8);
+    }
+
+    static inline IasLocalAudioBuffer::AudioData unpack(const uint8_t *in)
+    {
+      // quadlets with other labels (e.g. ancillary or MIDI data) are muted
+      uint32_t value = 0u;
+      if (cLabel == (in[0] & cLabelMask))
+      {
+        value = (uint32_t(in[1]) << 24) | (uint32_t(in[2]) << 16) | (uint32_t(in[3]) << 8);
+      }
+      return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromInt32(int32_t(value));
+    }
 };
 
 template<>
@@ -207,6 +298,19 @@ class IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>
     static const uint16_t cSampleSize = 2u;
     static const uint16_t cHeaderSize = cIasAvtpHeaderSize;
     static const uint8_t  cFormatCode = 4u;
+
+    static inline void pack(IasLocalAudioBuffer::AudioData sample, uint8_t *out)
+    {
+      const uint32_t value = uint32_t(IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::toInt32(sample));
+      out[0] = uint8_t(value >> 24);
+      out[1] = uint8_t(value >> 16);
+    }
+
+    static inline IasLocalAudioBuffer::AudioData unpack(const uint8_t *in)
+    {
+      const uint32_t value = (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16);
+      return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromInt32(int32_t(value));
+    }
 };
 
 template<>
@@ -216,6 +320,21 @@ class IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSaf24>
     static const uint16_t cSampleSize = 3u;
     static const uint16_t cHeaderSize = cIasAvtpHeaderSize;
     static const uint8_t  cFormatCode = 3u;
+
+    static inline void pack(IasLocalAudioBuffer::AudioData sample, uint8_t *out)
+    {
+      const uint32_t value = uint32_t(IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::toInt32(sample));
+      out[0] = uint8_t(value >> 24);
+      out[1] = uint8_t(value >> 16);
+      out[2] = uint8_t(value >> 8);
+    }
+
+    static inline IasLocalAudioBuffer::AudioData unpack(const uint8_t *in)
+    {
+      // drops the LSBs not covered by the local sample size
+      const uint32_t value = (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8);
+      return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromInt32(int32_t(value));
+    }
 };
 
 template<>
@@ -225,6 +344,22 @@ class IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSaf32>
     static const uint16_t cSampleSize = 4u;
     static const uint16_t cHeaderSize = cIasAvtpHeaderSize;
     static const uint8_t  cFormatCode = 2u;
+
+    static inline void pack(IasLocalAudioBuffer::AudioData sample, uint8_t *out)
+    {
+      const uint32_t value = uint32_t(IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::toInt32(sample));
+      out[0] = uint8_t(value >> 24);
+      out[1] = uint8_t(value >> 16);
+      out[2] = uint8_t(value >> 8);
+      out[3] = uint8_t(value);
+    }
+
+    static inline IasLocalAudioBuffer::AudioData unpack(const uint8_t *in)
+    {
+      // drops the LSBs not covered by the local sample size
+      const uint32_t value = (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+      return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromInt32(int32_t(value));
+    }
 };
 
 template<>
@@ -234,6 +369,25 @@ class IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat>
     static const uint16_t cSampleSize = 4u;
     static const uint16_t cHeaderSize = cIasAvtpHeaderSize;
     static const uint8_t  cFormatCode = 1u;
+
+    static inline void pack(IasLocalAudioBuffer::AudioData sample, uint8_t *out)
+    {
+      const float value = IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::toFloat(sample);
+      uint32_t bits = 0u;
+      (void) std::memcpy(&bits, &value, sizeof bits);
+      out[0] = uint8_t(bits >> 24);
+      out[1] = uint8_t(bits >> 16);
+      out[2] = uint8_t(bits >> 8);
+      out[3] = uint8_t(bits);
+    }
+
+    static inline IasLocalAudioBuffer::AudioData unpack(const uint8_t *in)
+    {
+      const uint32_t bits = (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) | (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+      float value = 0.0f;
+      (void) std::memcpy(&value, &bits, sizeof value);
+      return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromFloat(value);
+    }
 };
 
 template <IasAvbAudioFormat F>
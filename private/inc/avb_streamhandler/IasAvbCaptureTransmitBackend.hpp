@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbCaptureTransmitBackend.hpp
+ * @brief   Transmit backend writing the packets to a pcap file instead of sending them.
+ * @details Used to benchmark and verify the transmit path without a network: the sequencer
+ *          runs as usual, each packet is written to the file configured by
+ *          "transmit.capture.file", with its launch time as time stamp, and returned to its
+ *          pool right away. Without a file configured the packets are just counted. The file
+ *          name gets the index of the TX queue appended, so the sequencers don't share a file.
+ * @date    2018
+ */
+
+#ifndef IASAVBCAPTURETRANSMITBACKEND_HPP_
+#define IASAVBCAPTURETRANSMITBACKEND_HPP_
+
+#include "IasAvbTransmitBackend.hpp"
+#include "IasAvbPcapFile.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbCaptureTransmitBackend : public IasAvbTransmitBackend
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbCaptureTransmitBackend(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbCaptureTransmitBackend();
+
+    //{@
+    /// @brief IasAvbTransmitBackend implementation
+    virtual IasAvbProcessingResult init(uint32_t queueIndex, IasAvbSrClass qavClass);
+    virtual void cleanup();
+    virtual int32_t xmit(IasAvbPacket * packet);
+    virtual uint32_t reclaim(bool doReclaim);
+    virtual void updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh);
+    //@}
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbCaptureTransmitBackend(IasAvbCaptureTransmitBackend const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbCaptureTransmitBackend& operator=(IasAvbCaptureTransmitBackend const &other);
+
+    ///
+    /// Member Variables
+    ///
+
+    bool                  mInitialized;
+    IasAvbPcapFile        mFile;          // not open if no file is configured
+    uint32_t              mPacketCount;
+    uint64_t              mByteCount;
+    uint32_t              mWriteErrors;   // packets dropped because the file couldn't be written
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBCAPTURETRANSMITBACKEND_HPP_ */
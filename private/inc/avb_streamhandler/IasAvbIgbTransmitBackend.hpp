@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbIgbTransmitBackend.hpp
+ * @brief   Transmit backend handing packets over to the I210 through libigb.
+ * @details Packets are put on the TX DMA ring with igb_xmit(), the hardware launches them
+ *          at their launch time. Sent packets are collected with igb_clean(), which serves
+ *          all TX queues at once. The Qav shaper is configured through the TQAV registers.
+ *          libigb has no call for queueing several descriptors at once, so bursts are
+ *          submitted packet by packet (default xmitBurst() implementation).
+ * @date    2018
+ */
+
+#ifndef IASAVBIGBTRANSMITBACKEND_HPP_
+#define IASAVBIGBTRANSMITBACKEND_HPP_
+
+#include "IasAvbTransmitBackend.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbIgbTransmitBackend : public IasAvbTransmitBackend
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbIgbTransmitBackend(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbIgbTransmitBackend();
+
+    //{@
+    /// @brief IasAvbTransmitBackend implementation
+    virtual IasAvbProcessingResult init(uint32_t queueIndex, IasAvbSrClass qavClass);
+    virtual void cleanup();
+    virtual int32_t xmit(IasAvbPacket * packet);
+    virtual uint32_t reclaim(bool doReclaim);
+    virtual void updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh);
+    //@}
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbIgbTransmitBackend(IasAvbIgbTransmitBackend const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbIgbTransmitBackend& operator=(IasAvbIgbTransmitBackend const &other);
+
+    static const uint32_t cTxMaxInterferenceSize = 1522u; ///< assumed maximum frame size of Non-SR packets
+
+    ///
+    /// Member Variables
+    ///
+
+    device_t             *mIgbDevice;
+    uint32_t              mQueueIndex;
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBIGBTRANSMITBACKEND_HPP_ */
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbLaunchTimeQueue.hpp
+ * @brief   Launch time ordered queue used by the transmit sequencer.
+ * @details The queue is a binary min-heap stored in a flat vector. The vector is split into
+ *          two partitions: entries [0, readyCount) form the heap of entries that still need
+ *          to be serviced in the current TX window, entries [readyCount, size) are "parked",
+ *          i.e. done for the current window. Parking the top entry and updating the key of
+ *          the top entry are O(log n), re-arming all entries for the next window is O(n).
+ *          The element type needs to provide operator< (earlier launch time first).
+ * @date    2018
+ */
+
+#ifndef IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBLAUNCHTIMEQUEUE_HPP
+#define IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBLAUNCHTIMEQUEUE_HPP
+
+#include "IasAvbTypes.hpp"
+#include <vector>
+#include <algorithm>
+
+namespace IasMediaTransportAvb {
+
+template<class T>
+class IasAvbLaunchTimeQueue
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    IasAvbLaunchTimeQueue();
+
+    /**
+     * @brief pre-allocate storage for the given number of entries
+     */
+    inline void reserve(size_t count);
+
+    /**
+     * @brief total number of entries (ready and parked)
+     */
+    inline size_t size() const;
+
+    /**
+     * @brief number of entries still to be serviced in the current window
+     */
+    inline size_t readyCount() const;
+
+    /**
+     * @brief returns true if no entry is left to be serviced in the current window
+     */
+    inline bool empty() const;
+
+    /**
+     * @brief access the entry with the earliest launch time
+     *
+     * Must not be called if the queue is empty().
+     */
+    inline T & top();
+
+    /**
+     * @brief access an entry by its storage index [0, size())
+     *
+     * Used to iterate over all entries regardless of their state. The storage order
+     * is undefined and changes with every heap operation.
+     */
+    inline T & operator[](size_t index);
+
+    /**
+     * @brief re-establish the heap order after the key of the top entry has been changed
+     *
+     * @returns true if the top entry has been moved, false if it is still the earliest one
+     */
+    bool updateTop();
+
+    /**
+     * @brief remove the top entry from the heap but keep it in storage
+     */
+    void parkTop();
+
+    /**
+     * @brief move all parked entries back into the heap
+     */
+    void rearm();
+
+    /**
+     * @brief add an entry, all entries are re-armed afterwards
+     */
+    void push(const T & entry);
+
+    /**
+     * @brief remove the entry at the given storage index, all entries are re-armed afterwards
+     */
+    void erase(size_t index);
+
+    /**
+     * @brief remove all entries
+     */
+    inline void clear();
+
+  private:
+    typedef std::vector<T> EntryVector;
+
+    /// @brief comparator turning std heap algorithms (max-heap) into a min-heap
+    struct Later
+    {
+      bool operator()(const T & a, const T & b) const { return b < a; }
+    };
+
+    void siftDown(size_t index);
+
+    EntryVector mEntries;
+    size_t      mReadyCount;
+};
+
+
+template<class T>
+IasAvbLaunchTimeQueue<T>::IasAvbLaunchTimeQueue()
+  : mEntries()
+  , mReadyCount(0u)
+{
+  // do nothing
+}
+
+template<class T>
+inline void IasAvbLaunchTimeQueue<T>::reserve(size_t count)
+{
+  mEntries.reserve(count);
+}
+
+template<class T>
+inline size_t IasAvbLaunchTimeQueue<T>::size() const
+{
+  return mEntries.size();
+}
+
+template<class T>
+inline size_t IasAvbLaunchTimeQueue<T>::readyCount() const
+{
+  return mReadyCount;
+}
+
+template<class T>
+inline bool IasAvbLaunchTimeQueue<T>::empty() const
+{
+  return (0u == mReadyCount);
+}
+
+template<class T>
+inline T & IasAvbLaunchTimeQueue<T>::top()
+{
+  AVB_ASSERT(0u != mReadyCount);
+  return mEntries[0];
+}
+
+template<class T>
+inline T & IasAvbLaunchTimeQueue<T>::operator[](size_t index)
+{
+  AVB_ASSERT(index < mEntries.size());
+  return mEntries[index];
+}
+
+template<class T>
+inline void IasAvbLaunchTimeQueue<T>::clear()
+{
+  mEntries.clear();
+  mReadyCount = 0u;
+}
+
+template<class T>
+bool IasAvbLaunchTimeQueue<T>::updateTop()
+{
+  bool moved = false;
+
+  if (mReadyCount > 1u)
+  {
+    // cheap check first: in most cases the top entry stays in front of both children
+    const bool leftEarlier = mEntries[1] < mEntries[0];
+    const bool rightEarlier = (mReadyCount > 2u) && (mEntries[2] < mEntries[0]);
+    if (leftEarlier || rightEarlier)
+    {
+      siftDown(0u);
+      moved = true;
+    }
+  }
+
+  return moved;
+}
+
+template<class T>
+void IasAvbLaunchTimeQueue<T>::parkTop()
+{
+  AVB_ASSERT(0u != mReadyCount);
+
+  // swap top with the last heap entry, which moves it to the front of the parked partition
+  mReadyCount--;
+  if (0u != mReadyCount)
+  {
+    std::swap(mEntries[0], mEntries[mReadyCount]);
+    siftDown(0u);
+  }
+}
+
+template<class T>
+void IasAvbLaunchTimeQueue<T>::rearm()
+{
+  mReadyCount = mEntries.size();
+  std::make_heap(mEntries.begin(), mEntries.end(), Later());
+}
+
+template<class T>
+void IasAvbLaunchTimeQueue<T>::push(const T & entry)
+{
+  mEntries.push_back(entry);
+  rearm();
+}
+
+template<class T>
+void IasAvbLaunchTimeQueue<T>::erase(size_t index)
+{
+  AVB_ASSERT(index < mEntries.size());
+  if (index != (mEntries.size() - 1u))
+  {
+    std::swap(mEntries[index], mEntries.back());
+  }
+  mEntries.pop_back();
+  rearm();
+}
+
+template<class T>
+void IasAvbLaunchTimeQueue<T>::siftDown(size_t index)
+{
+  const T entry = mEntries[index];
+
+  for (;;)
+  {
+    size_t child = (2u * index) + 1u;
+    if (child >= mReadyCount)
+    {
+      break;
+    }
+    if (((child + 1u) < mReadyCount) && (mEntries[child + 1u] < mEntries[child]))
+    {
+      child++;
+    }
+    if (!(mEntries[child] < entry))
+    {
+      break;
+    }
+    mEntries[index] = mEntries[child];
+    index = child;
+  }
+
+  mEntries[index] = entry;
+}
+
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBLAUNCHTIMEQUEUE_HPP */
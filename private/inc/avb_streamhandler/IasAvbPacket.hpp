@@ -16,6 +16,7 @@
 #define IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBPACKET_HPP
 
 #include "IasAvbTypes.hpp"
+#include <atomic>
 extern "C"
 {
   #include "igb.h"
@@ -25,6 +26,7 @@ namespace IasMediaTransportAvb
 {
 
 class IasAvbPacketPool;
+struct IasAvbPacketLessee;
 
 /*
  * We inherit from the igb_packet C-struct in order to convert back and forth between the types without
@@ -124,6 +126,9 @@ private:
     uint32_t mMagic;
     size_t mPayloadOffset;
     bool mDummyFlag;
+    std::atomic<uint32_t> mNextFree; ///< index of the next packet in the home pool's free list
+    std::atomic<bool> mInFreeList; ///< set while the packet is on the home pool's free list, catches double returns
+    IasAvbPacketLessee* mLessee; ///< handle of the stream a packet of the shared arena is leased to, NULL otherwise
 };
 
 inline void* IasAvbPacket::getBasePtr() const
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbPacketArena.hpp
+ * @brief   Packet memory shared by all transmit streams, organized in size classes.
+ * @details Instead of every transmit stream allocating a packet pool of its own, streams lease
+ *          packets from the size class fitting their packet size (see IasAvbPacketPool::initShared).
+ *          Each size class grows on demand by chunks of cChunkSize packets, each chunk being an
+ *          IasAvbPacketPool of its own, so DMA memory scales with the number of packets actually
+ *          in flight rather than with the number of configured streams. Chunks are kept until
+ *          the arena is destroyed. The arena is enabled by the "transmit.pool.shared" registry key.
+ * @date    2018
+ */
+
+#ifndef IASAVBPACKETARENA_HPP_
+#define IASAVBPACKETARENA_HPP_
+
+#include "IasAvbTypes.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace IasMediaTransportAvb {
+
+class IasAvbPacket;
+class IasAvbPacketPool;
+class IasAvbPacketArena;
+
+/**
+ * @brief Handle of a stream leasing packets from the arena, see IasAvbPacketArena::attach().
+ *
+ * The handle is owned by the arena, so packets still in flight can be returned after the pool of
+ * the stream has been destroyed.
+ */
+struct IasAvbPacketLessee
+{
+  IasAvbPacketArena *arena;
+  size_t packetSize;
+  uint32_t quota;
+  std::atomic<uint32_t> available;   ///< quota left, all packets are back when it equals quota
+  bool attached;                     ///< protected by the lessee lock of the arena
+};
+
+class IasAvbPacketArena
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbPacketArena(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbPacketArena();
+
+    /**
+     * @brief Initializes the arena.
+     *
+     * No packet memory is allocated here, the size classes grow on demand.
+     *
+     * @param[in] maxPacketsPerClass upper limit of packets in each size class
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult init(uint32_t maxPacketsPerClass);
+
+    /**
+     *  @brief Clean up all allocated resources.
+     */
+    void cleanup();
+
+    /**
+     * @brief get a packet from the smallest size class holding packetSize bytes
+     *
+     * Allocates a new chunk if the size class is exhausted. The packet has to be returned
+     * with IasAvbPacketPool::returnPacket().
+     *
+     * @param[in] packetSize required packet size in bytes
+     * @returns pointer to the packet, NULL if the size class is exhausted or packetSize is too large
+     */
+    IasAvbPacket* lease(size_t packetSize);
+
+    /**
+     * @brief book-keeping for a leased packet that has been returned
+     *
+     * @param[in] packetSize packet size that was passed to lease()
+     */
+    void release(size_t packetSize);
+
+    /**
+     * @brief get a handle to lease packets of packetSize bytes, at most quota of them at the same time
+     *
+     * A handle detached before is reused once all packets leased through it are back.
+     *
+     * @returns pointer to the handle, owned by the arena, NULL if out of memory
+     */
+    IasAvbPacketLessee* attach(size_t packetSize, uint32_t quota);
+
+    /**
+     * @brief give up a handle, packets still in flight are released when they are returned
+     */
+    void detach(IasAvbPacketLessee* lessee);
+
+    /**
+     * @brief book-keeping for a packet leased through the handle that has been returned
+     *
+     * The handle isn't accessed anymore once the quota has been given back.
+     */
+    void release(IasAvbPacketLessee* lessee);
+
+    /**
+     * @brief returns the index of the smallest size class holding packetSize bytes, cNumClasses if none
+     */
+    static uint32_t getClassIndex(size_t packetSize);
+
+    /**
+     * @brief returns the packet size of a size class
+     */
+    static inline size_t getClassSize(uint32_t classIndex);
+
+    /**
+     * @brief returns the number of packets currently leased from a size class
+     */
+    inline uint32_t getInUse(uint32_t classIndex) const;
+
+    /**
+     * @brief returns the highest number of packets leased at the same time from a size class
+     */
+    inline uint32_t getHighWaterMark(uint32_t classIndex) const;
+
+    /**
+     * @brief returns the number of packets allocated for a size class
+     */
+    inline uint32_t getAllocated(uint32_t classIndex) const;
+
+    /**
+     * @brief log the usage of all size classes
+     */
+    void logStatistics();
+
+    static const uint32_t cNumClasses = 5u;
+    static const uint32_t cChunkSize = 64u;       ///< packets allocated at once when a size class grows
+    static const uint32_t cMaxChunks = 64u;       ///< chunks per size class
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbPacketArena(IasAvbPacketArena const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbPacketArena& operator=(IasAvbPacketArena const &other);
+
+    struct SizeClass
+    {
+      std::atomic<IasAvbPacketPool*> chunks[cMaxChunks];
+      std::atomic<uint32_t> numChunks;
+      std::atomic<uint32_t> hint;           ///< chunk the last packet was taken from
+      std::atomic<uint32_t> inUse;
+      std::atomic<uint32_t> highWater;
+    };
+
+    /**
+     * @brief allocate another chunk for a size class
+     *
+     * @returns true if a chunk has been added (by this or a concurrent call)
+     */
+    bool grow(uint32_t classIndex, uint32_t seenChunks);
+
+    typedef std::vector<IasAvbPacketLessee*> LesseeList;
+
+    static const size_t cClassSizes[cNumClasses];
+
+    ///
+    /// Member Variables
+    ///
+
+    SizeClass             mClasses[cNumClasses];
+    uint32_t              mMaxChunks;
+    std::mutex            mGrowLock;      // serializes chunk allocation, not taken on the lease path
+    LesseeList            mLessees;       // kept until cleanup(), reused when detached and all packets are back
+    std::mutex            mLesseeLock;    // protects mLessees, not taken on the lease path
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+
+inline size_t IasAvbPacketArena::getClassSize(uint32_t classIndex)
+{
+  return (classIndex < cNumClasses) ? cClassSizes[classIndex] : 0u;
+}
+
+inline uint32_t IasAvbPacketArena::getInUse(uint32_t classIndex) const
+{
+  return (classIndex < cNumClasses) ? mClasses[classIndex].inUse.load(std::memory_order_relaxed) : 0u;
+}
+
+inline uint32_t IasAvbPacketArena::getHighWaterMark(uint32_t classIndex) const
+{
+  return (classIndex < cNumClasses) ? mClasses[classIndex].highWater.load(std::memory_order_relaxed) : 0u;
+}
+
+inline uint32_t IasAvbPacketArena::getAllocated(uint32_t classIndex) const
+{
+  return (classIndex < cNumClasses) ? (mClasses[classIndex].numChunks.load(std::memory_order_acquire) * cChunkSize) : 0u;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBPACKETARENA_HPP_ */
@@ -16,9 +16,10 @@
 #include "IasAvbPacket.hpp"
 #include "IasAvbTypes.hpp"
 #include "IasAvbStreamHandlerEnvironment.hpp"
+#include "IasAvbPacketArena.hpp"
 #include <vector>
 #include <linux/if_ether.h>
-#include <mutex>
+#include <atomic>
 
 extern "C"
 {
@@ -47,6 +48,20 @@ class IasAvbPacketPool
     // Operations
 
     IasAvbProcessingResult init(size_t packetSize, uint32_t poolSize);
+
+    /**
+     * @brief Initializes the pool as a front end to the shared packet arena.
+     *
+     * The pool does not own any packets then. getPacket() leases a packet from the arena and applies
+     * the template set by initAllPacketsFromTemplate(), returned packets go back to the arena.
+     * The quota is kept by a handle of the arena, so cleanup() doesn't wait for the packets in flight.
+     *
+     * @param[in] arena the shared arena
+     * @param[in] packetSize maximum packet size of the stream
+     * @param[in] quota maximum number of packets the stream may hold at the same time, reported as pool size
+     */
+    IasAvbProcessingResult initShared(IasAvbPacketArena* arena, size_t packetSize, uint32_t quota);
+
     void cleanup();
     IasAvbPacket* getPacket();
     inline IasAvbPacket* getDummyPacket();
@@ -55,6 +70,8 @@ class IasAvbPacketPool
     static IasAvbProcessingResult returnPacket(IasAvbPacket* packet);
     inline size_t getPacketSize() const;
     inline uint32_t getPoolSize() const;
+    inline uint32_t getFreeCount() const;
+    inline bool isShared() const;
     IasAvbProcessingResult reset();
 
   private:
@@ -71,12 +88,13 @@ class IasAvbPacketPool
   private:
     // Local Types
     typedef igb_dma_alloc Page;
-    typedef std::vector<IasAvbPacket*> PacketStack;
     typedef std::vector<Page*> PageList;
 
     // Constants
 
     static const uint32_t cMaxPoolSize = 2048u;                // derived from max TX ring size / 2
+    static const uint32_t cHostPageSize = 4096u;               // page size used if there is no igb device
+    static const uint32_t cEndOfList = 0xFFFFFFFFu;            // index terminating the free list
 #if defined(DIRECT_RX_DMA)
     static const size_t cMaxBufferSize = 2048u;              // fixed value by libigb
 #else
@@ -85,16 +103,38 @@ class IasAvbPacketPool
 
     // helpers
     IasAvbProcessingResult initPage(Page * page, const uint32_t packetsPerPage, uint32_t & packetCountTotal);
+    int32_t allocPage(device_t * igbDevice, Page * page);
+    void freePage(device_t * igbDevice, Page * page);
     IasAvbProcessingResult doReturnPacket(IasAvbPacket* packet);
+    IasAvbPacket* leasePacket();
+
+    /**
+     * @brief lock-free free list operations
+     *
+     * The free list is a Treiber stack of indices into mBase, linked through IasAvbPacket::mNextFree.
+     * The head holds the index of the top packet in the lower and a modification tag in the upper
+     * 32 bits, the tag prevents the ABA problem when a packet is popped and pushed again while
+     * another thread is about to pop it. IasAvbPacket::mInFreeList is set by whoever puts a packet
+     * on the list and cleared by popFree(), so a packet is never pushed twice.
+     */
+    void pushFree(IasAvbPacket* packet);
+    IasAvbPacket* popFree();
+    void rebuildFreeList();
+    static inline uint64_t makeHead(uint64_t oldHead, uint32_t index);
 
     // Members
     DltContext *mLog;
-    std::mutex mLock;
     size_t mPacketSize;
     uint32_t mPoolSize;
-    PacketStack mFreeBufferStack;
+    std::atomic<uint64_t> mFreeHead;
+    std::atomic<uint32_t> mFreeCount;
     IasAvbPacket* mBase;
     PageList mDmaPages;
+    bool mHostMemory; // pages are plain memory, used by the socket transmit backend
+    IasAvbPacketArena* mArena; // shared mode only
+    IasAvbPacketLessee* mLessee; // shared mode only, holds the remaining quota
+    IasAvbPacket mTemplate; // shared mode: header applied to each leased packet
+    bool mTemplateValid;
 };
 
 
@@ -114,6 +154,21 @@ inline uint32_t IasAvbPacketPool::getPoolSize() const
   return mPoolSize;
 }
 
+inline uint32_t IasAvbPacketPool::getFreeCount() const
+{
+  return (NULL != mLessee) ? mLessee->available.load(std::memory_order_relaxed) : mFreeCount.load(std::memory_order_relaxed);
+}
+
+inline bool IasAvbPacketPool::isShared() const
+{
+  return (NULL != mArena);
+}
+
+inline uint64_t IasAvbPacketPool::makeHead(uint64_t oldHead, uint32_t index)
+{
+  return (((oldHead >> 32) + 1u) << 32) | uint64_t(index);
+}
+
 inline IasAvbPacket* IasAvbPacketPool::getDummyPacket()
 {
   IasAvbPacket* ret = getPacket();
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbPcapFile.hpp
+ * @brief   Reads and writes Ethernet frames in the pcap capture file format.
+ * @details Used to record the traffic of the receive engine, to replay it into the receive
+ *          engine and to capture the output of the transmit sequencers, so problems seen in the
+ *          field can be reproduced and stream processing can be benchmarked without a network.
+ *          Files are written with nanosecond time stamps, both micro- and nanosecond files of
+ *          either byte order are read. pcapng files have to be converted first, e.g. with
+ *          "editcap -F pcap". Frames are written with a lock held, so several threads may share
+ *          a file.
+ * @date    2018
+ */
+
+#ifndef IASAVBPCAPFILE_HPP_
+#define IASAVBPCAPFILE_HPP_
+
+#include "avb_streamhandler/IasAvbTypes.hpp"
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace IasMediaTransportAvb {
+
+class IasAvbPcapFile
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    IasAvbPcapFile();
+
+    /**
+     *  @brief Destructor, virtual by default. Closes the file.
+     */
+    virtual ~IasAvbPcapFile();
+
+    /**
+     * @brief Creates the file, or truncates it, and writes the file header.
+     *
+     * @param[in] fileName path of the file
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult openWrite(const std::string & fileName);
+
+    /**
+     * @brief Opens the file and checks the file header.
+     *
+     * @param[in] fileName path of the file
+     * @returns eIasAvbProcOK on success, eIasAvbProcUnsupportedFormat if it isn't an Ethernet pcap file,
+     *          otherwise an error will be returned.
+     */
+    IasAvbProcessingResult openRead(const std::string & fileName);
+
+    /**
+     * @brief Closes the file, frames written are flushed.
+     */
+    void close();
+
+    /**
+     * @brief Appends a frame to a file opened by openWrite().
+     *
+     * @param[in] frame frame including the Ethernet header
+     * @param[in] length length of the frame in bytes
+     * @param[in] time time stamp of the frame in ns
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult writeFrame(const void * frame, uint32_t length, uint64_t time);
+
+    /**
+     * @brief Reads the next frame of a file opened by openRead().
+     *
+     * Frames longer than the buffer are truncated.
+     *
+     * @param[out] buffer buffer the frame is copied to
+     * @param[in] size size of the buffer in bytes
+     * @param[out] length length of the frame copied
+     * @param[out] time time stamp of the frame in ns
+     * @returns eIasAvbProcOK on success, eIasAvbProcOff at the end of the file, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult readFrame(void * buffer, uint32_t size, uint32_t & length, uint64_t & time);
+
+    /**
+     * @brief returns true if a file is open
+     */
+    inline bool isOpen() const;
+
+    /**
+     * @brief returns the number of frames written or read since the file has been opened
+     */
+    inline uint32_t getFrameCount() const;
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbPcapFile(IasAvbPcapFile const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbPcapFile& operator=(IasAvbPcapFile const &other);
+
+    /**
+     * @brief converts a header field read from the file to host byte order
+     */
+    inline uint32_t toHost(uint32_t value) const;
+
+    static const uint32_t cMagicMicro = 0xA1B2C3D4u;  ///< time stamps in us
+    static const uint32_t cMagicNano = 0xA1B23C4Du;   ///< time stamps in ns
+    static const uint32_t cLinkTypeEthernet = 1u;
+    static const uint32_t cSnapLength = 65535u;
+
+    ///
+    /// Member Variables
+    ///
+
+    FILE                 *mFile;
+    bool                  mWriting;
+    bool                  mSwapped;        // file has been written on a host of the other byte order
+    bool                  mNanoseconds;
+    uint32_t              mFrameCount;
+    std::mutex            mLock;           // serializes writers
+};
+
+
+inline bool IasAvbPcapFile::isOpen() const
+{
+  return (NULL != mFile);
+}
+
+inline uint32_t IasAvbPcapFile::getFrameCount() const
+{
+  return mFrameCount;
+}
+
+inline uint32_t IasAvbPcapFile::toHost(uint32_t value) const
+{
+  return mSwapped ? __builtin_bswap32(value) : value;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBPCAPFILE_HPP_ */
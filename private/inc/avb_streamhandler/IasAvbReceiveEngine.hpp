@@ -18,10 +18,15 @@
 #include "avb_streamhandler/IasAvbTypes.hpp"
 #include "avb_helper/IasThread.hpp"
 #include "avb_streamhandler/IasAvbStream.hpp"
+#include "avb_streamhandler/IasAvbRxStreamTable.hpp"
+#include "avb_streamhandler/IasAvbReceiveFilter.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
 #include "avb_watchdog/IasWatchdogInterface.hpp"
 #include "avb_helper/IasIRunnable.hpp"
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include <limits>
 #include <linux/if_ether.h>
 
 namespace IasMediaTransportAvb {
@@ -30,6 +35,9 @@ class IasLocalAudioStream;
 class IasLocalVideoStream;
 class IasAvbClockDomain;
 class IasAvbStreamHandlerEventInterface;
+class IasAvbReceiveRing;
+class IasAvbPcapFile;
+class IasDiaLogger;
 
 class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
 {
@@ -76,6 +84,22 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
      */
     IasAvbProcessingResult stop();
 
+    /**
+     * @brief Feeds the frames of a pcap file into the stream dispatch, as if they had been received.
+     *
+     * Used to reproduce recordings made with IasRegKeys::cRxRecordFile and to benchmark stream processing
+     * without a network. The frames are processed in the calling thread, which is blocked until the end of
+     * the file, with the time stamps of the file as the receive time. So the result does not depend on the
+     * pacing. The engine has to be initialized but not started. With several workers configured, stream
+     * timeouts are only supervised for the streams of worker 0.
+     *
+     * @param[in] fileName path of the pcap file
+     * @param[in] speed 1.0 replays at the original timing, 2.0 twice as fast and so on, 0 as fast as possible
+     * @param[out] numFrames number of frames replayed
+     * @returns eIasAvbProcOK at the end of the file, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult replay(const std::string & fileName, float speed, uint32_t & numFrames);
+
     /**
      * @brief Creates an AvbAudioStream. This stream can be used to be connected
      *        to an local audio stream.
@@ -169,6 +193,15 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
      */
     IasAvbProcessingResult disconnectStreams(const IasAvbStreamId & avbStreamId);
 
+    /**
+     * @brief Sets the channel routing of an AVB audio stream.
+     *
+     * @param[in] avbStreamId The id of the AVB (audio) stream.
+     * @param[in] routing The routing entries, see IasAvbAudioStream::setChannelRouting()
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setChannelRouting(const IasAvbStreamId & avbStreamId, const ChannelRoutingList & routing);
+
     /**
      * @brief Opens the receive raw socket on the device.
      *
@@ -237,14 +270,13 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
 
   private:
 
-    struct StreamData
-    {
-      IasAvbStream* stream;
-      IasAvbStreamState lastState;
-      uint64_t lastTimeDispatched;
-    };
+    typedef IasAvbRxStreamData StreamData;
 
-    typedef std::map<IasAvbStreamId, StreamData> AvbStreamMap;
+    /*
+     * The map is the master copy used by the API calls, protected by mLock. The receive thread
+     * only uses the table published in mStreamTable, see updateStreamTable().
+     */
+    typedef std::map<IasAvbStreamId, StreamData*> AvbStreamMap;
 
 #if defined(DIRECT_RX_DMA)
     static const size_t cReceiveFilterDataSize = 128u;  // flexible filter maximum data length
@@ -273,7 +305,93 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
     typedef std::vector<IasAvbPacket*> PacketList;
 #else
     static const size_t cReceiveBufferSize = ETH_FRAME_LEN + 4u; // consider VLAN TAG
+    static const uint32_t cRingBlockSizeDefault = 65536u;
+    static const int32_t cMaxEpollEvents = 2;                    // receive socket and timer
 #endif /* DIRECT_RX_DMA */
+    static const uint64_t cTimeoutTick = 1000000u;              // resolution of the stream timeouts in ns
+    static const uint32_t cMaxWorkers = 16u;
+    static const uint32_t cTimestampOff = 0u;                   // values of IasRegKeys::cRxTimestamping
+    static const uint32_t cTimestampSoftware = 1u;
+    static const uint32_t cTimestampHardware = 2u;
+    static const uint64_t cMaxTimestampDeviation = 1000000000u; // ns, kernel time stamps further off are not trusted
+    static const uint32_t cAvtpStreamHeaderSize = 24u;          // AVTP stream data header, up to the format specific data
+
+    /**
+     * @brief State of one receive thread.
+     *
+     * Worker 0 runs on mReceiveThread and receives on mReceiveSocket. With more than one worker
+     * configured, every worker has a socket of its own in a PACKET_FANOUT group and the kernel
+     * hands each packet to the worker owning its stream ID, see getShard(). So all packets of
+     * a stream are processed by the same thread, in order.
+     *
+     * When the distribution changes, a worker takes over its streams only after every worker has
+     * switched to the new distribution, see processTimeouts(). Until then it drops their packets.
+     */
+    class Worker : public IasMediaTransportAvb::IasIRunnable
+    {
+      public:
+        Worker(IasAvbReceiveEngine & engine, uint32_t index);
+        virtual ~Worker();
+
+        virtual IasResult beforeRun();
+        virtual IasResult run();
+        virtual IasResult shutDown();
+        virtual IasResult afterRun();
+
+        IasAvbReceiveEngine     &mEngine;
+        uint32_t                 mIndex;
+        bool                     mEndThread;
+        IasThread               *mThread;             // NULL for worker 0, it runs on mReceiveThread
+        int32_t                  mCpu;                // CPU the thread is bound to, -1 for no affinity
+        std::atomic<uint32_t>    mReadSeq;            // odd while the worker is in a read section
+        IasAvbTimeoutWheel       mTimeoutWheel;
+        uint64_t                 mTimeoutGeneration;  // generation of the stream table the wheel has been built for
+        bool                     mClaimed;            // the wheel holds the streams of mTimeoutGeneration
+        std::atomic<uint64_t>    mShardGeneration;    // distribution the worker has switched to, max while stopped
+        bool                     mReplay;             // replaying a file, the other workers are stopped
+        uint8_t                 *mReceiveBuffer;
+#if !defined(DIRECT_RX_DMA)
+        int32_t                  mSocket;             // owned by the worker, except for worker 0
+        IasAvbReceiveRing       *mReceiveRing;
+        int32_t                  mEpollFd;
+        int32_t                  mTimerFd;
+        uint64_t                 mTimerExpiry;        // time the timer is armed for, 0 if not armed
+#endif /* !DIRECT_RX_DMA */
+
+      private:
+        /**
+         * @brief Copy constructor, private unimplemented to prevent misuse.
+         */
+        Worker(Worker const &other);
+
+        /**
+         * @brief Assignment operator, private unimplemented to prevent misuse.
+         */
+        Worker& operator=(Worker const &other);
+    };
+
+    typedef std::vector<Worker*> WorkerList;
+
+    /**
+     * @brief Settings and statistics of the frame processing of a receive loop, see processFrame().
+     */
+    struct FrameContext
+    {
+      IasWatchdog::IasWatchdogInterface *watchdog;  // reset when a packet has been accepted, NULL for none
+      IasDiaLogger      *diaLogger;
+      bool               handleWildcard;            // frames of unknown streams are matched against the wildcard stream
+      bool               doDiscardByPts;
+      uint32_t           discardAfter;              // ns
+      uint64_t           timeout;                   // ns without packet until a stream is notified
+      uint32_t           packetsReceived;
+      uint32_t           packetsDispatched;
+      uint32_t           packetsDiscarded;
+      uint32_t           packetsValid;
+      int32_t            timeDiffMin;
+      int32_t            timeDiffMax;
+      int64_t            timeDiffAcc;
+    };
+
     ///
     /// Inherited from IasRunnable
     ///
@@ -319,16 +437,186 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
      */
     virtual IasResult afterRun();
 
+    /**
+     * @brief the receive loop, run by each worker on its own thread
+     */
+    IasResult receive(Worker & worker);
+
+    /**
+     * @brief Reads the receive settings from the registry and resets the statistics.
+     *
+     * @param[in] worker worker the context is used by
+     * @param[out] context context to be initialized
+     * @param[out] idleWait configured idle wait in us
+     */
+    void initFrameContext(const Worker & worker, FrameContext & context, uint32_t & idleWait);
+
+    /**
+     * @brief resets the statistics of the context
+     */
+    static inline void resetFrameStatistics(FrameContext & context);
+
+    /**
+     * @brief Processes a received frame, passing it to its stream if it is AVTP stream data of a stream received.
+     *
+     * Called by the receive loop and replay() within a read section.
+     *
+     * @param[in] worker worker processing the frame
+     * @param[in,out] table the stream table in use by the worker, updated if a wildcard stream has been promoted
+     * @param[in] frame frame including the Ethernet header
+     * @param[in] length length of the frame in bytes
+     * @param[in] now current time in ns
+     * @param[in] rxTime time the frame has been received in ns
+     * @param[in,out] context settings and statistics
+     */
+    void processFrame(Worker & worker, IasAvbRxStreamTable * &table, const uint8_t * frame, int32_t length,
+                      uint64_t now, uint64_t rxTime, FrameContext & context);
+
+    /**
+     * @brief Creates the workers as configured.
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult createWorkers();
+
+    /**
+     * @brief returns the index of the worker which receives the packets of the stream
+     *
+     * While a wildcard stream exists, all packets go to worker 0: packets of unknown streams
+     * have to meet the wildcard stream, wherever their ID would put them.
+     */
+    inline uint32_t getShard(uint64_t streamId) const;
+
+    /**
+     * @brief returns the index of the worker owning the stream if the packets are distributed to numShards workers
+     */
+    static inline uint32_t getShard(uint64_t streamId, uint32_t numShards);
+
+    /**
+     * @brief checks whether the worker owns the stream according to the table it uses
+     */
+    static inline bool isOwner(const Worker & worker, const IasAvbRxStreamTable * table, uint64_t streamId);
+
+    /**
+     * @brief checks whether all workers have dropped the streams they owned before the distribution changed
+     *
+     * @param[in] shardGeneration generation of the first table with the current distribution
+     * @returns true if the streams may be taken over by their new owners
+     */
+    bool isShardingSettled(uint64_t shardGeneration) const;
+
     /**
      * @brief close receive socket
      */
     inline void closeSocket();
 
+#if !defined(DIRECT_RX_DMA)
+    /**
+     * @brief Opens the sockets of the workers other than worker 0 and joins all of them to a
+     *        PACKET_FANOUT group which distributes the packets by stream ID.
+     * @returns eIasAvbProcOK on success or if there is only one worker, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setupFanout();
+
+    /**
+     * @brief Installs the program distributing the packets of the fanout group by stream ID.
+     * @param[in] numShards number of workers to distribute to, 1 sends all packets to worker 0
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setFanoutProgram(uint32_t numShards);
+
+    /**
+     * @brief Sets up the TPACKET_V3 RX ring on the receive socket of the worker if configured.
+     * @returns eIasAvbProcOK on success or if no ring is configured, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setupReceiveRing(Worker & worker);
+
+    /**
+     * @brief Creates the epoll instance waiting for the receive socket and the stream timeout timer.
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setupEventLoop(Worker & worker);
+
+    /**
+     * @brief Closes the epoll instance and the timer.
+     */
+    static void closeEventLoop(Worker & worker);
+
+    /**
+     * @brief Arms the timer for the next stream timeout, if it has changed.
+     */
+    static void armTimeoutTimer(Worker & worker, uint64_t now);
+
+    /**
+     * @brief Regenerates the socket filter from the stream list and attaches it to the sockets of all workers,
+     *        so packets of streams not received are dropped by the kernel. Needs mLock to be held.
+     *
+     * If the filter can't be generated or attached, the sockets are left unfiltered.
+     */
+    void updateReceiveFilter();
+
+    /**
+     * @brief Asks the network interface to time stamp all received packets, keeping its transmit setting.
+     * @returns true if the interface delivers hardware time stamps for all received packets
+     */
+    bool enableHardwareTimestamps();
+
+    /**
+     * @brief Requests kernel receive time stamps on the socket of the worker, according to mTimestamping.
+     * @returns eIasAvbProcOK on success or if time stamps are off, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setupTimestamping(Worker & worker);
+
+    /**
+     * @brief Receives a frame into the receive buffer of the worker, along with its kernel time stamp if requested.
+     *
+     * @param[in] worker worker whose socket is read, without waiting
+     * @param[out] kernelTime receive time stamp in ns, 0 if there is none
+     * @param[out] hardware true if kernelTime has been taken by the network interface, false for CLOCK_REALTIME
+     * @returns length of the frame, negative on error
+     */
+    int32_t receiveFrame(Worker & worker, uint64_t & kernelTime, bool & hardware);
+#endif /* !DIRECT_RX_DMA */
+
+    /**
+     * @brief converts a kernel receive time stamp to local time
+     *
+     * Hardware time stamps are taken by the clock the local time is read from. Software time stamps are
+     * converted by their distance to CLOCK_REALTIME read along with the local time.
+     *
+     * @param[in] kernelTime receive time stamp in ns, 0 if there is none
+     * @param[in] hardware true if kernelTime has been taken by the network interface
+     * @param[in] now current local time in ns
+     * @param[in] realNow CLOCK_REALTIME in ns, read right after now
+     * @returns receive time in local time, now if there is no time stamp or it can't be trusted
+     */
+    static inline uint64_t toLocalTime(uint64_t kernelTime, bool hardware, uint64_t now, uint64_t realNow);
+
+    /**
+     * @brief notifies the streams whose timeout has expired, called by the receive thread within a read section
+     *
+     * Each stream has its own deadline, the time of the last dispatch plus the timeout. When it expires
+     * without a packet in between, the stream is dispatched an empty packet and taken out of the wheel
+     * until the next packet arrives.
+     *
+     * If the distribution of the streams to the workers has changed with the table, the worker drops
+     * all streams and takes over the ones it owns now as soon as isShardingSettled(). Until then the
+     * previous owners may still process them.
+     *
+     * @param[in] worker worker whose streams are checked
+     * @param[in] table current stream table, the wheel is rebuilt if the table has changed
+     * @param[in] now current time in ns
+     * @param[in] timeout timeout in ns
+     */
+    void processTimeouts(Worker & worker, const IasAvbRxStreamTable * table, uint64_t now, uint64_t timeout);
+
     /**
      * @brief dispatch received packet to AvbStream
+     *
+     * @param[in] now current time, the time the stream has been dispatched
+     * @param[in] rxTime time the packet has been received
      * @returns true if packet has been marked valid by AvbStream
      */
-    bool dispatchPacket(StreamData &streamData, const void* packet, size_t length, uint64_t now);
+    bool dispatchPacket(StreamData &streamData, const void* packet, size_t length, uint64_t now, uint64_t rxTime);
 
     /**
      * @brief checks for a change in stream status and notifies client
@@ -343,6 +631,63 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
      */
     IasAvbProcessingResult checkStreamIdInUse(const IasAvbStreamId & streamId) const;
 
+    /**
+     * @brief adds a new stream to the stream list and publishes the updated stream table
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult addStream(const IasAvbStreamId & streamId, IasAvbStream * stream);
+
+    /**
+     * @brief removes a stream from the stream list and publishes the updated stream table
+     *
+     * When the call returns, the receive thread does not use the stream anymore, so it can be deleted.
+     *
+     * @param[in] streamId id of the stream
+     * @param[out] stream the stream removed, owned by the caller now
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult removeStream(const IasAvbStreamId & streamId, IasAvbStream * &stream);
+
+    /**
+     * @brief builds a new stream table from the stream list and publishes it. Needs mLock to be held.
+     *
+     * @param[out] oldTable the table replaced, to be deleted after waitForReaders()
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult updateStreamTable(IasAvbRxStreamTable * &oldTable);
+
+    /**
+     * @brief waits until the workers have left the read section they might be in
+     *
+     * Afterwards the workers do not hold any reference to tables or streams removed before the call.
+     *
+     * @param[in] self the worker calling, which is not waited for, NULL if called by an API call
+     */
+    void waitForReaders(const Worker * self = NULL) const;
+
+    /**
+     * @brief turns the wildcard stream into a regular stream. Called by a worker only.
+     *
+     * Does not block on the lock: if the stream list is locked by an API call, the next packet will try again.
+     *
+     * @param[in] worker the worker calling
+     * @param[in,out] table the stream table in use by the worker, updated on success
+     * @param[in] wildcardId the current id of the stream
+     * @param[in] streamId the new id of the stream
+     */
+    void promoteWildcardStream(Worker & worker, IasAvbRxStreamTable * &table, const IasAvbStreamId & wildcardId,
+                               const IasAvbStreamId & streamId);
+
+    /**
+     * @brief enter a read section of a worker and get the current stream table
+     */
+    inline IasAvbRxStreamTable * beginRead(Worker & worker);
+
+    /**
+     * @brief leave a read section of a worker
+     */
+    static inline void endRead(Worker & worker);
+
     /**
      * @brief lock access to the stream list
      */
@@ -382,22 +727,29 @@ class IasAvbReceiveEngine : private IasMediaTransportAvb::IasIRunnable
     //
 
     std::string const			mInstanceName;
-    bool				mEndThread;
-    IasThread				*mReceiveThread;
+    IasThread				*mReceiveThread;   // runs worker 0
+    WorkerList				mWorkers;          // fixed between init() and cleanup()
+    std::atomic<uint32_t>		mNumShards;        // workers receiving packets, see getShard()
     AvbStreamMap			mAvbStreams;
+    std::atomic<IasAvbRxStreamTable*>	mStreamTable;
+    uint64_t				mTableGeneration;   // protected by mLock
+    uint64_t				mShardGeneration;   // first table generation with the current mNumShards, protected by mLock
     std::mutex				mLock;
     IasAvbStreamHandlerEventInterface*	mEventInterface;
     int32_t				mReceiveSocket;
-    uint8_t				*mReceiveBuffer;
     bool				mIgnoreStreamId;
     DltContext				*mLog;           // context for Log & Trace
     IasWatchdog::IasWatchdogInterface	*mWatchdog;
+    IasAvbPcapFile			*mRecorder;        // records the frames received, NULL if not configured
 
 #if defined(DIRECT_RX_DMA)
     device_t         * mIgbDevice;
     IasAvbPacketPool * mRcvPacketPool;
     PacketList         mPacketList;
     bool               mRecoverIgbReceiver;
+#else
+    IasAvbReceiveFilter mReceiveFilter;   // protected by mLock
+    uint32_t            mTimestamping;    // cTimestampOff, cTimestampSoftware or cTimestampHardware if supported
 #endif /* DIRECT_RX_DMA */
     int32_t              mRcvPortIfIndex;
 };
@@ -418,7 +770,7 @@ inline IasAvbStream * IasAvbReceiveEngine::getStreamById( IasAvbStreamId streamI
   AvbStreamMap::iterator it = mAvbStreams.find(streamId);
   if (it != mAvbStreams.end())
   {
-    ret = it->second.stream;
+    ret = it->second->stream;
   }
 
   return ret;
@@ -434,6 +786,63 @@ inline IasAvbProcessingResult IasAvbReceiveEngine::unbindMcastAddr(const IasAvbM
   return bindMcastAddr(mCastMacAddr, false);
 }
 
+inline IasAvbRxStreamTable * IasAvbReceiveEngine::beginRead(Worker & worker)
+{
+  (void) worker.mReadSeq.fetch_add(1u);
+  return mStreamTable.load();
+}
+
+inline void IasAvbReceiveEngine::endRead(Worker & worker)
+{
+  (void) worker.mReadSeq.fetch_add(1u);
+}
+
+inline uint32_t IasAvbReceiveEngine::getShard(uint64_t streamId) const
+{
+  return getShard(streamId, mNumShards.load());
+}
+
+inline uint32_t IasAvbReceiveEngine::getShard(uint64_t streamId, uint32_t numShards)
+{
+  // must match the fanout program installed by setFanoutProgram()
+  return (numShards > 1u) ? ((uint32_t(streamId >> 32) ^ uint32_t(streamId)) % numShards) : 0u;
+}
+
+inline bool IasAvbReceiveEngine::isOwner(const Worker & worker, const IasAvbRxStreamTable * table, uint64_t streamId)
+{
+  return worker.mReplay || ((NULL != table) && (getShard(streamId, table->getNumShards()) == worker.mIndex));
+}
+
+inline void IasAvbReceiveEngine::resetFrameStatistics(FrameContext & context)
+{
+  context.packetsReceived = 0u;
+  context.packetsDispatched = 0u;
+  context.packetsDiscarded = 0u;
+  context.packetsValid = 0u;
+  context.timeDiffMin = std::numeric_limits<int32_t>::max();
+  context.timeDiffMax = std::numeric_limits<int32_t>::min();
+  context.timeDiffAcc = 0;
+}
+
+inline uint64_t IasAvbReceiveEngine::toLocalTime(uint64_t kernelTime, bool hardware, uint64_t now, uint64_t realNow)
+{
+  uint64_t ret = now;
+
+  if (0u != kernelTime)
+  {
+    const uint64_t rxTime = hardware ? kernelTime : (now + (kernelTime - realNow));
+    const uint64_t deviation = (rxTime > now) ? (rxTime - now) : (now - rxTime);
+
+    // e.g. hardware time stamps of an interface whose clock isn't the one local time is read from
+    if (deviation < cMaxTimestampDeviation)
+    {
+      ret = rxTime;
+    }
+  }
+
+  return ret;
+}
+
 inline void IasAvbReceiveEngine::lock()
 {
   mLock.lock();
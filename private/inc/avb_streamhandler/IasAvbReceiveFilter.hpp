@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbReceiveFilter.hpp
+ * @brief   Classic BPF socket filter passing the frames of the subscribed AVTP streams only.
+ * @details Generated by the receive engine from its stream list and attached to the receive
+ *          sockets, so frames of talkers nobody listens to are dropped in the kernel instead of
+ *          being copied to user space. The stream IDs are grouped by their upper 32 bits, which
+ *          mostly hold the talker's MAC address, so a frame is compared with the streams of its
+ *          own talker only. Frames are addressed relative to the network header, so VLAN tags
+ *          don't matter.
+ * @date    2018
+ */
+
+#ifndef IASAVBRECEIVEFILTER_HPP_
+#define IASAVBRECEIVEFILTER_HPP_
+
+#include "avb_streamhandler/IasAvbTypes.hpp"
+#include <linux/filter.h>
+#include <vector>
+
+namespace IasMediaTransportAvb {
+
+class IasAvbReceiveFilter
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    IasAvbReceiveFilter();
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbReceiveFilter();
+
+    /**
+     * @brief Removes all streams. A filter built without streams drops all frames.
+     */
+    void clear();
+
+    /**
+     * @brief Adds a stream whose frames are to be passed.
+     */
+    void addStream(uint64_t streamId);
+
+    /**
+     * @brief Adds a wildcard stream, its frames are recognized by the destination MAC address.
+     *
+     * @param[in] dmac destination MAC address, all zero to pass the frames of any stream
+     */
+    void addWildcard(const IasAvbMacAddress & dmac);
+
+    /**
+     * @brief Generates the filter program from the streams added.
+     *
+     * @returns eIasAvbProcOK on success, eIasAvbProcNoSpaceLeft if there are too many streams for a program
+     */
+    IasAvbProcessingResult build();
+
+    /**
+     * @brief Attaches the program built last to the socket, replacing the filter attached before.
+     *
+     * @param[in] socket socket to filter
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult attach(int32_t socket) const;
+
+    /**
+     * @brief Removes the filter from the socket, so it receives all frames again.
+     *
+     * @param[in] socket socket to remove the filter from
+     * @returns eIasAvbProcOK on success or if no filter was attached, otherwise an error will be returned.
+     */
+    static IasAvbProcessingResult detach(int32_t socket);
+
+    /**
+     * @brief returns the number of instructions of the program built last, 0 if none
+     */
+    inline uint32_t getLength() const;
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbReceiveFilter(IasAvbReceiveFilter const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbReceiveFilter& operator=(IasAvbReceiveFilter const &other);
+
+    /**
+     * @brief appends an instruction to the program
+     */
+    inline void emit(uint16_t code, uint32_t k, uint8_t jt = 0u, uint8_t jf = 0u);
+
+    static const uint32_t cMaxLength = 4096u;     ///< BPF_MAXINSNS of the kernel
+    static const uint32_t cAccept = 0xFFFFFFFFu;  ///< return value passing the whole frame
+
+    ///
+    /// Member Variables
+    ///
+
+    std::vector<uint64_t>       mStreamIds;
+    std::vector<uint64_t>       mWildcardMacs;      // MAC addresses in the lower 48 bits
+    bool                        mAcceptAnyStream;
+    std::vector<sock_filter>    mProgram;
+};
+
+
+inline uint32_t IasAvbReceiveFilter::getLength() const
+{
+  return uint32_t(mProgram.size());
+}
+
+inline void IasAvbReceiveFilter::emit(uint16_t code, uint32_t k, uint8_t jt, uint8_t jf)
+{
+  sock_filter insn;
+  insn.code = code;
+  insn.jt = jt;
+  insn.jf = jf;
+  insn.k = k;
+  mProgram.push_back(insn);
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBRECEIVEFILTER_HPP_ */
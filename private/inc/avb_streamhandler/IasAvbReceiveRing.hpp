@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbReceiveRing.hpp
+ * @brief   PACKET_MMAP RX ring (TPACKET_V3) of an AF_PACKET socket.
+ * @details Used by the receive engine if the receive path does not use libigb (DIRECT_RX_DMA off).
+ *          The kernel fills blocks of frames and hands over a complete block, or a partly filled
+ *          one after the block timeout. Frames are processed in place, so neither a recvfrom()
+ *          per frame nor a copy is needed. Each frame carries the kernel's receive timestamp.
+ *          Works with any network interface, including veth pairs and loopback.
+ * @date    2018
+ */
+
+#ifndef IASAVBRECEIVERING_HPP_
+#define IASAVBRECEIVERING_HPP_
+
+#include "IasAvbTypes.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbReceiveRing
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbReceiveRing(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbReceiveRing();
+
+    /**
+     * @brief Sets up and maps the RX ring of a packet socket.
+     *
+     * Has to be called before any frame is read from the socket, the socket is switched to TPACKET_V3.
+     *
+     * @param[in] socket AF_PACKET socket, remains owned by the caller
+     * @param[in] blockSize size of a block in bytes, rounded up to a multiple of the page size
+     * @param[in] blockCount number of blocks
+     * @param[in] blockTimeout time in ms after which the kernel hands over a partly filled block
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult init(int32_t socket, uint32_t blockSize, uint32_t blockCount, uint32_t blockTimeout);
+
+    /**
+     *  @brief Unmaps the ring. The socket has to be closed by the caller.
+     */
+    void cleanup();
+
+    /**
+     * @brief get the next received frame
+     *
+     * The frame stays valid until the next call, then its block may be handed back to the kernel.
+     *
+     * @param[out] length number of bytes of the frame, starting with the Ethernet header
+     * @param[out] timestamp kernel receive timestamp in ns, CLOCK_REALTIME or the clock of the network
+     *             interface, see hasHardwareTimestamp()
+     * @returns pointer to the frame, NULL if there is no frame pending
+     */
+    uint8_t* nextFrame(uint32_t &length, uint64_t &timestamp);
+
+    /**
+     * @brief returns true if the timestamp of the frame returned last has been taken by the network interface
+     *
+     * Only if requested with PACKET_TIMESTAMP on the socket and supported by the interface.
+     */
+    inline bool hasHardwareTimestamp() const;
+
+    /**
+     * @brief read and reset the socket's ring statistics
+     *
+     * @param[out] packets number of frames received by the kernel
+     * @param[out] drops number of frames dropped because no block was free
+     * @param[out] freezes number of times the ring ran full
+     * @returns true on success
+     */
+    bool getStatistics(uint32_t &packets, uint32_t &drops, uint32_t &freezes);
+
+    /**
+     * @brief returns true if the ring is mapped
+     */
+    inline bool isInitialized() const;
+
+    /**
+     * @brief returns the number of blocks handed over by the kernel since init
+     */
+    inline uint64_t getBlockCount() const;
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbReceiveRing(IasAvbReceiveRing const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbReceiveRing& operator=(IasAvbReceiveRing const &other);
+
+    /**
+     * @brief hand the current block back to the kernel and move on to the next one
+     */
+    void releaseBlock();
+
+    static const uint32_t cFrameSize = 2048u;   ///< only used by the kernel for sanity checks, frames are packed in V3
+
+    ///
+    /// Member Variables
+    ///
+
+    int32_t               mSocket;
+    uint8_t              *mRing;
+    size_t                mRingSize;
+    uint32_t              mBlockSize;
+    uint32_t              mBlockNum;
+    uint32_t              mBlockIdx;      // block currently processed or waited for
+    uint8_t              *mFrame;         // next frame of the current block, NULL if no block is open
+    uint32_t              mFramesLeft;    // frames of the current block not yet returned
+    uint64_t              mBlockCount;
+    bool                  mHardwareTimestamp;
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+
+inline bool IasAvbReceiveRing::isInitialized() const
+{
+  return (NULL != mRing);
+}
+
+inline bool IasAvbReceiveRing::hasHardwareTimestamp() const
+{
+  return mHardwareTimestamp;
+}
+
+inline uint64_t IasAvbReceiveRing::getBlockCount() const
+{
+  return mBlockCount;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBRECEIVERING_HPP_ */
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbRxStreamTable.hpp
+ * @brief   Lookup table used by the receive engine to dispatch packets to the receive streams.
+ * @details The table is a flat open addressing hash table (linear probing) keyed on the 64 bit
+ *          stream ID, plus a dense list of all entries for iterating. It is built once and never
+ *          modified afterwards. The receive engine publishes a new table whenever the set of
+ *          streams changes, so the receive thread can look up streams without taking a lock.
+ * @date    2018
+ */
+
+#ifndef IASAVBRXSTREAMTABLE_HPP_
+#define IASAVBRXSTREAMTABLE_HPP_
+
+#include "avb_streamhandler/IasAvbTypes.hpp"
+#include "avb_streamhandler/IasAvbTimeoutWheel.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbStream;
+
+/**
+ * @brief Per stream data of the receive engine, shared by all tables
+ *
+ * The timeout node is used by the receive thread only.
+ */
+struct IasAvbRxStreamData : public IasAvbTimeoutWheel::Node
+{
+  IasAvbStream* stream;
+  IasAvbStreamState lastState;
+  uint64_t lastTimeDispatched;
+};
+
+class IasAvbRxStreamTable
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    IasAvbRxStreamTable();
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbRxStreamTable();
+
+    /**
+     * @brief Allocates the table.
+     *
+     * @param[in] maxEntries maximum number of entries, zero results in an empty table
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult init(uint32_t maxEntries);
+
+    /**
+     * @brief Adds an entry. Only to be used while building the table, before it is published.
+     *
+     * @param[in] streamId key of the entry
+     * @param[in] data stream data, remains owned by the caller
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult insert(uint64_t streamId, IasAvbRxStreamData * data);
+
+    /**
+     * @brief Looks up the stream data by stream ID.
+     *
+     * @returns pointer to the stream data or NULL if not found
+     */
+    inline IasAvbRxStreamData * find(uint64_t streamId) const;
+
+    /**
+     * @brief returns the number of entries
+     */
+    inline uint32_t getSize() const;
+
+    /**
+     * @brief returns the entry at position idx (0..getSize()-1) in insertion order
+     */
+    inline IasAvbRxStreamData * getEntry(uint32_t idx) const;
+
+    /**
+     * @brief returns the stream ID of the entry at position idx (0..getSize()-1)
+     */
+    inline uint64_t getEntryStreamId(uint32_t idx) const;
+
+    /**
+     * @brief sets the generation, used to tell tables apart without comparing pointers
+     */
+    inline void setGeneration(uint64_t generation);
+
+    /**
+     * @brief returns the generation
+     */
+    inline uint64_t getGeneration() const;
+
+    /**
+     * @brief sets how the streams are distributed to the receive workers
+     *
+     * @param[in] numShards number of workers receiving packets
+     * @param[in] shardGeneration generation of the first table distributing the streams this way
+     */
+    inline void setSharding(uint32_t numShards, uint64_t shardGeneration);
+
+    /**
+     * @brief returns the number of workers receiving packets
+     */
+    inline uint32_t getNumShards() const;
+
+    /**
+     * @brief returns the generation of the first table distributing the streams the way this one does
+     */
+    inline uint64_t getShardGeneration() const;
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbRxStreamTable(IasAvbRxStreamTable const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbRxStreamTable& operator=(IasAvbRxStreamTable const &other);
+
+    /**
+     * @brief scrambles the stream ID, the lower bits of most stream IDs are just a counter
+     */
+    static inline uint64_t hash(uint64_t streamId);
+
+    struct Slot
+    {
+      uint64_t streamId;
+      IasAvbRxStreamData * data;   // NULL if the slot is empty
+    };
+
+    static const uint32_t cMinSlots = 8u;
+
+    ///
+    /// Member Variables
+    ///
+
+    Slot                  *mSlots;
+    uint32_t               mMask;         // number of slots - 1, at least twice as many slots as entries
+    Slot                  *mEntries;      // dense copy of the used slots in insertion order
+    uint32_t               mNumEntries;
+    uint32_t               mMaxEntries;
+    uint64_t               mGeneration;
+    uint32_t               mNumShards;
+    uint64_t               mShardGeneration;
+};
+
+
+inline uint64_t IasAvbRxStreamTable::hash(uint64_t streamId)
+{
+  // finalizer of MurmurHash3
+  uint64_t h = streamId;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+inline IasAvbRxStreamData * IasAvbRxStreamTable::find(uint64_t streamId) const
+{
+  IasAvbRxStreamData * ret = NULL;
+
+  if (0u != mNumEntries)
+  {
+    uint32_t idx = uint32_t(hash(streamId) & mMask);
+    // the table is never full, so the probe ends at an empty slot at the latest
+    while (NULL != mSlots[idx].data)
+    {
+      if (streamId == mSlots[idx].streamId)
+      {
+        ret = mSlots[idx].data;
+        break;
+      }
+      idx = (idx + 1u) & mMask;
+    }
+  }
+
+  return ret;
+}
+
+inline uint32_t IasAvbRxStreamTable::getSize() const
+{
+  return mNumEntries;
+}
+
+inline IasAvbRxStreamData * IasAvbRxStreamTable::getEntry(uint32_t idx) const
+{
+  return (idx < mNumEntries) ? mEntries[idx].data : NULL;
+}
+
+inline uint64_t IasAvbRxStreamTable::getEntryStreamId(uint32_t idx) const
+{
+  return (idx < mNumEntries) ? mEntries[idx].streamId : 0u;
+}
+
+inline void IasAvbRxStreamTable::setGeneration(uint64_t generation)
+{
+  mGeneration = generation;
+}
+
+inline uint64_t IasAvbRxStreamTable::getGeneration() const
+{
+  return mGeneration;
+}
+
+inline void IasAvbRxStreamTable::setSharding(uint32_t numShards, uint64_t shardGeneration)
+{
+  mNumShards = numShards;
+  mShardGeneration = shardGeneration;
+}
+
+inline uint32_t IasAvbRxStreamTable::getNumShards() const
+{
+  return mNumShards;
+}
+
+inline uint64_t IasAvbRxStreamTable::getShardGeneration() const
+{
+  return mShardGeneration;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBRXSTREAMTABLE_HPP_ */
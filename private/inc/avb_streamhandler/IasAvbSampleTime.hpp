@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbSampleTime.hpp
+ * @brief   Fixed point arithmetic for sample durations and reference plane times.
+ * @details Sample durations are held in nanoseconds as unsigned 32.32 fixed point values,
+ *          rate ratios as 32.32 factors. All operations are integer only, so the time stamps
+ *          derived from them are exactly reproducible and don't depend on the floating
+ *          point rounding of the platform. Products and quotients are computed with 128 bit
+ *          intermediates, so a duration can be applied to any sample count that fits into 64 bits.
+ * @date    2018
+ */
+
+#ifndef IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBSAMPLETIME_HPP
+#define IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBSAMPLETIME_HPP
+
+#include <cstdint>
+
+namespace IasMediaTransportAvb {
+
+class IasAvbSampleTime
+{
+  public:
+    /// nanoseconds in 32.32 fixed point
+    typedef uint64_t Duration;
+
+    /// number of fractional bits of a Duration or a rate ratio
+    static const uint32_t cFracBits = 32u;
+
+    /// 1.0 in 32.32 fixed point
+    static const uint64_t cOne = uint64_t(1u) << cFracBits;
+
+    /**
+     * @brief Returns the duration of one sample at the given sample frequency.
+     *
+     * The result is rounded up, so that the number of samples within an interval
+     * that is an exact multiple of the sample period isn't overestimated by samplesCeil().
+     */
+    static inline Duration fromFrequency(uint32_t frequency);
+
+    /**
+     * @brief Returns the duration of one of count events spread evenly over ns nanoseconds.
+     */
+    static inline Duration fromInterval(uint64_t ns, uint64_t count);
+
+    /**
+     * @brief Converts a (positive) rate ratio to 32.32 fixed point.
+     */
+    static inline uint64_t fromRatio(double ratio);
+
+    /**
+     * @brief Returns duration scaled by the 32.32 rate ratio.
+     */
+    static inline Duration scale(Duration duration, uint64_t ratio);
+
+    /**
+     * @brief Returns the time covered by count samples of the given duration, rounded to the nearest nanosecond.
+     */
+    static inline uint64_t toNs(Duration duration, uint64_t count);
+
+    /**
+     * @brief Same as toNs() for a signed sample count, the result is symmetric around zero.
+     */
+    static inline int64_t toNsSigned(Duration duration, int64_t count);
+
+    /**
+     * @brief Returns the number of samples of the given duration needed to cover ns nanoseconds, rounded up.
+     */
+    static inline uint64_t samplesCeil(uint64_t ns, Duration duration);
+
+    /**
+     * @brief Returns the number of samples per packet interval, rounded to the nearest integer.
+     */
+    static inline uint32_t samplesPerInterval(uint32_t frequency, uint32_t intervalsPerSecond);
+
+  private:
+    __extension__ typedef unsigned __int128 Wide;
+
+    /**
+     * @brief Constructor, private unimplemented, static helpers only.
+     */
+    IasAvbSampleTime();
+};
+
+
+inline IasAvbSampleTime::Duration IasAvbSampleTime::fromFrequency(uint32_t frequency)
+{
+  Duration ret = 0u;
+  if (0u != frequency)
+  {
+    const uint64_t oneSecond = uint64_t(1000000000u) << cFracBits;
+    ret = (oneSecond + frequency - 1u) / frequency;
+  }
+  return ret;
+}
+
+
+inline IasAvbSampleTime::Duration IasAvbSampleTime::fromInterval(uint64_t ns, uint64_t count)
+{
+  Duration ret = 0u;
+  if (0u != count)
+  {
+    ret = Duration((Wide(ns) << cFracBits) / count);
+  }
+  return ret;
+}
+
+
+inline uint64_t IasAvbSampleTime::fromRatio(double ratio)
+{
+  return (ratio > 0.0) ? uint64_t(ratio * double(cOne) + 0.5) : 0u;
+}
+
+
+inline IasAvbSampleTime::Duration IasAvbSampleTime::scale(Duration duration, uint64_t ratio)
+{
+  return Duration(((Wide(duration) * ratio) + (cOne >> 1)) >> cFracBits);
+}
+
+
+inline uint64_t IasAvbSampleTime::toNs(Duration duration, uint64_t count)
+{
+  return uint64_t(((Wide(duration) * count) + (cOne >> 1)) >> cFracBits);
+}
+
+
+inline int64_t IasAvbSampleTime::toNsSigned(Duration duration, int64_t count)
+{
+  // negate in the unsigned domain, INT64_MIN has no positive counterpart
+  const uint64_t magnitude = (count < 0) ? (0u - uint64_t(count)) : uint64_t(count);
+  const int64_t ns = int64_t(toNs(duration, magnitude));
+  return (count < 0) ? -ns : ns;
+}
+
+
+inline uint64_t IasAvbSampleTime::samplesCeil(uint64_t ns, Duration duration)
+{
+  uint64_t ret = 0u;
+  if (0u != duration)
+  {
+    ret = uint64_t(((Wide(ns) << cFracBits) + duration - 1u) / duration);
+  }
+  return ret;
+}
+
+
+inline uint32_t IasAvbSampleTime::samplesPerInterval(uint32_t frequency, uint32_t intervalsPerSecond)
+{
+  uint32_t ret = 0u;
+  if (0u != intervalsPerSecond)
+  {
+    ret = uint32_t((uint64_t(frequency) + (intervalsPerSecond >> 1)) / intervalsPerSecond);
+  }
+  return ret;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IAS_MEDIATRANSPORT_AVBSTREAMHANDLER_AVBSAMPLETIME_HPP */
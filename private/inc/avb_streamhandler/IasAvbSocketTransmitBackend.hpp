@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbSocketTransmitBackend.hpp
+ * @brief   Transmit backend using an AF_PACKET socket with SO_TXTIME launch times.
+ * @details This backend does not need libigb and works on any network interface, including
+ *          veth pairs. Each packet carries its own SCM_TXTIME control message, so the ETF qdisc
+ *          of the interface launches it at the packet's launch time. By default a burst of packets
+ *          is handed over with a single sendmmsg() call. Optionally packets are copied into a
+ *          PACKET_MMAP TX ring (TPACKET_V2) instead; as the launch time applies to a complete
+ *          ring flush, the ring is flushed once per frame then. The packet buffer is returned to
+ *          its pool as soon as the kernel has copied it, ring frames are released by the kernel
+ *          once the qdisc has sent them.
+ *          Launch times are converted from PTP time to CLOCK_TAI. An etf qdisc using
+ *          "clockid CLOCK_TAI" has to be installed on the TX queue the socket priority of the
+ *          class is mapped to (see "transmit.socket.prio.*"). Credit based shaping is left to a
+ *          cbs qdisc configured by the system integrator.
+ * @date    2018
+ */
+
+#ifndef IASAVBSOCKETTRANSMITBACKEND_HPP_
+#define IASAVBSOCKETTRANSMITBACKEND_HPP_
+
+#include "IasAvbTransmitBackend.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbSocketTransmitBackend : public IasAvbTransmitBackend
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbSocketTransmitBackend(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbSocketTransmitBackend();
+
+    //{@
+    /// @brief IasAvbTransmitBackend implementation
+    virtual IasAvbProcessingResult init(uint32_t queueIndex, IasAvbSrClass qavClass);
+    virtual void cleanup();
+    virtual int32_t xmit(IasAvbPacket * packet);
+    virtual uint32_t xmitBurst(IasAvbPacket * const * packets, uint32_t count, int32_t &result);
+    virtual uint32_t reclaim(bool doReclaim);
+    virtual void updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh);
+    //@}
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbSocketTransmitBackend(IasAvbSocketTransmitBackend const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbSocketTransmitBackend& operator=(IasAvbSocketTransmitBackend const &other);
+
+    /**
+     * @brief set up the PACKET_MMAP TX ring
+     *
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setupRing(uint32_t frameCount);
+
+    /**
+     * @brief send one frame, either a ring frame (data == NULL) or a buffer
+     *
+     * @returns 0 on success or a positive errno value
+     */
+    int32_t sendFrame(const void * data, size_t len, uint64_t txTime);
+
+    /**
+     * @brief check whether a packet can be sent by this backend
+     */
+    bool isSendable(const IasAvbPacket * packet) const;
+
+    /**
+     * @brief convert an errno value to the xmit() return code convention
+     */
+    static int32_t toXmitResult(int32_t err);
+
+    /**
+     * @brief re-calculate the offset between PTP time and CLOCK_TAI
+     *
+     * @param[in] force update even if the update interval has not elapsed yet
+     */
+    void updateClockOffset(bool force);
+
+    /**
+     * @brief read errors reported by the qdisc from the socket's error queue
+     *
+     * @returns number of packets dropped by the qdisc
+     */
+    uint32_t readErrorQueue();
+
+    static const uint32_t cFrameSize = 2048u;              ///< size of one TX ring frame in bytes
+    static const uint32_t cDefaultRingSize = 0u;           ///< default number of TX ring frames (0: use sendmmsg)
+    static const uint32_t cMaxBurstSize = 64u;             ///< maximum number of packets per sendmmsg() call
+    static const uint32_t cDefaultPriorityHigh = 3u;       ///< default socket priority for the high class
+    static const uint32_t cDefaultPriorityLow = 2u;        ///< default socket priority for the low class
+    static const uint64_t cClockOffsetUpdateInterval = 100000000u; ///< ns between two updates of the PTP to TAI offset
+
+    ///
+    /// Member Variables
+    ///
+
+    int32_t               mSocket;
+    int32_t               mIfIndex;
+    uint8_t              *mRing;
+    size_t                mRingSize;
+    uint32_t              mFrameCount;
+    uint32_t              mHead;          // next frame to be filled
+    uint32_t              mTail;          // oldest frame not yet released by the kernel
+    uint32_t              mInFlight;      // number of frames handed over to the kernel
+    int64_t               mClockOffset;   // CLOCK_TAI - PTP time in ns
+    uint64_t              mLastOffsetUpdate; // CLOCK_TAI time of the last offset update
+    uint32_t              mQdiscDropped;
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBSOCKETTRANSMITBACKEND_HPP_ */
@@ -21,6 +21,8 @@
 
 #include "avb_streamhandler/IasAvbClockDomain.hpp"
 
+#include <mutex>
+
 #if defined(DIRECT_RX_DMA)
 #include <linux/if_ether.h>
 #endif /* DIRECT_RX_DMA */
@@ -62,20 +64,63 @@ class IasAvbStream
     inline const IasAvbMacAddress & getSmac() const;
     inline void setSmac(const uint8_t * sMac);
     inline IasAvbStreamState getStreamState() const;
-    IasAvbProcessingResult resetPacketPool() const;
+    IasAvbProcessingResult resetPacketPool();
 
     virtual void dispatchPacket(const void* packet, size_t length, uint64_t now);
+
+    /**
+     * @brief get the next packet to be sent
+     *
+     * Returns the oldest packet rendered by prefetchPackets(), or renders a new one if there is none.
+     *
+     * @param[in] nextWindowStart start of the TX window following the current one
+     * @returns packet or NULL if no packet could be prepared
+     */
     virtual IasAvbPacket* preparePacket(uint64_t nextWindowStart);
+
+    /**
+     * @brief render packets ahead of their TX window into the prefetch queue
+     *
+     * Rendering stops when the queue is full, when the launch time of the newest queued packet
+     * reaches the horizon or when a packet has been prepared that needs the attention of the
+     * sequencer (dummy packet or stream reset). May be called from another thread than preparePacket(),
+     * both render under the same lock.
+     *
+     * @param[in] nextWindowStart start of the TX window following the current one
+     * @param[in] horizon render packets until their launch time reaches this time
+     * @returns number of packets rendered
+     */
+    uint32_t prefetchPackets(uint64_t nextWindowStart, uint64_t horizon);
+
+    /**
+     * @brief return all packets of the prefetch queue to the packet pool
+     */
+    void flushPrefetchedPackets();
+
+    inline uint32_t getPrefetchedPacketCount() const;
+
     void activate(bool isError=false);
     void deactivate(bool isError=false);
     IasAvbProcessingResult hookClockDomain(IasAvbClockDomain * clockDomain);
 
+    static const uint32_t cMaxPrefetchPackets = 64u; ///< capacity of the prefetch queue
+
   private:
 
 #if defined(DIRECT_RX_DMA)
     static const uint16_t cMaxFrameSize = ETH_FRAME_LEN + 4u; // consider VLAN TAG
 #endif /* DIRECT_RX_DMA */
 
+    /**
+     * @brief get a packet from the pool and let the derived class fill it
+     */
+    IasAvbPacket* renderPacket(uint64_t nextWindowStart);
+
+    /**
+     * @brief return all packets of the prefetch queue to the packet pool, mRenderLock must be held
+     */
+    void flushPrefetchQueue();
+
     /**
      * @brief Copy constructor, private unimplemented to prevent misuse.
      */
@@ -142,6 +187,10 @@ class IasAvbStream
     uint16_t                  mVlanData;
     uint32_t                  mPresentationTimeOffset;
     bool                    mPreconfigured;
+    std::mutex              mRenderLock;     // serializes rendering, the prefetch queue and (de)activation
+    IasAvbPacket*           mPrefetchQueue[cMaxPrefetchPackets];
+    uint32_t                mPrefetchHead;   // index of the oldest queued packet
+    volatile uint32_t       mPrefetchCount;
 };
 
 
@@ -240,6 +289,12 @@ inline uint32_t IasAvbStream::adjustPresentationTimeOffset(uint32_t stepWidth)
 }
 
 
+inline uint32_t IasAvbStream::getPrefetchedPacketCount() const
+{
+  return mPrefetchCount;
+}
+
+
 inline IasAvbStreamState IasAvbStream::getStreamState() const
 {
   return mStreamState;
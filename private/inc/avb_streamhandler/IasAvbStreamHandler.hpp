@@ -195,6 +195,8 @@ class IAS_DSO_PUBLIC IasAvbStreamHandler : public IasAvbStreamHandlerInterface
 
     virtual IasAvbResult disconnectStreams(AvbStreamId networkStreamId);
 
+    virtual IasAvbResult setChannelRouting(AvbStreamId networkStreamId, const ChannelRoutingList &routing);
+
     virtual IasAvbResult setChannelLayout(uint16_t localStreamId, uint8_t channelLayout);
 
     virtual IasAvbResult setTestToneParams(uint16_t localStreamId, uint16_t channel, uint32_t signalFrequency,
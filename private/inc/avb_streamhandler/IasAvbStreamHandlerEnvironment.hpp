@@ -32,6 +32,7 @@ namespace IasMediaTransportAvb {
 class IasLibPtpDaemon;
 class IasLibMrpDaemon;
 class IasDiaLogger;
+class IasAvbPacketArena;
 
 //@{
 /**
@@ -44,9 +45,11 @@ class IasDiaLogger;
 namespace IasRegKeys {
 static const char cBootTimeMeasurement[] = "debug.boottime.enable"; // bool
 static const char cAudioSaturate[] = "audio.tx.saturate"; // bool
-static const char cAudioTstampBuffer[] = "audio.tstamp.buffer"; // time-aware buffer (0 = disable, 1 = fail-safe, 2 = hard)
+static const char cAudioTstampBuffer[] = "audio.tstamp.buffer"; // time-aware buffer (0 = disable, 1 = fail-safe, 2 = hard, 3 = presentation)
+static const char cAudioPlayoutTolerance[] = "audio.playout.tolerance"; // ns, deviation from the presentation time corrected in presentation mode (default 100000)
 static const char cAudioBaseFillMultiplier[] = "audio.basefill.multiplier"; // threshold to allow read access to the local audio buffer (default 15)
 static const char cAudioBaseFillMultiplierTx[] = "audio.basefill.multiplier.tx"; // overwrite cAudioBaseFillMultiplier for xmit streams
+static const char cAudioMixMaxLag[] = "audio.mix.maxlag"; // ns, lag of a mixed source after which the mix proceeds without it (default 4000000)
 static const char cCrfRxHoldoff[] = "crf.rx.holdoff"; // ms
 static const char cAudioMaxBend[] = "clock.maxbend"; // ppm
 static const char cAudioBendRate[] = "clock.bendrate"; // 1-999
@@ -106,17 +109,36 @@ static const char cRxDiscardOverrun[] = "receive.discard.overrun"; // 1=on, 0=of
 static const char cRxClkUpdateInterval[] = "receive.clock.updateinterval"; // us
 static const char cRxExcessPayload[] = "receive.excess.payload"; // samples
 static const char cRxRecoverIgbReceiver[] = "receive.recover.igb.receiver"; // 1=on (default), 0=off
+static const char cRxRingBlocks[] = "receive.ring.blocks"; // blocks of the TPACKET_V3 RX ring, socket receive path only (default 0=no ring, recvfrom per frame)
+static const char cRxRingBlockSize[] = "receive.ring.blocksize"; // bytes per RX ring block (default 65536)
+static const char cRxRingTimeout[] = "receive.ring.timeout"; // ms after which the kernel hands over a partly filled RX ring block (default 1)
+static const char cRxWorkers[] = "receive.workers"; // receive threads sharing the streams by stream ID, socket receive path only (default 1, max 16)
+static const char cRxWorkerCpu[] = "receive.worker.cpu."; // CPU a receive thread is bound to, worker index suffix "0", "1", ... (default: no affinity)
+static const char cRxTimestamping[] = "receive.timestamping"; // packet receive time, socket receive path only: 0=time of processing, 1=kernel software time stamps, 2=hardware time stamps if the interface supports them, software otherwise (default)
+static const char cRxRecordFile[] = "receive.record.file"; // pcap file all frames received are recorded to, see IasAvbReceiveEngine::replay() (default: no recording)
 static const char cXmitWndWidth[] = "transmit.window.width"; // ns
 static const char cXmitWndPitch[] = "transmit.window.pitch"; // ns
 static const char cXmitCueThresh[] = "transmit.window.threshold.cue"; // ns
 static const char cXmitResetThresh[] = "transmit.window.threshold.reset"; // ns
+static const char cXmitWndAdaptive[] = "transmit.window.adaptive"; // 1=adapt the window width to the system load within the bounds below, 0=fixed width (default)
+static const char cXmitWndWidthMin[] = "transmit.window.width.min"; // ns, lower bound of the adaptive window width (default pitch + 125000)
+static const char cXmitWndWidthMax[] = "transmit.window.width.max"; // ns, upper bound of the adaptive window width (default 2 * width)
 static const char cXmitPrefetchThresh[] = "transmit.window.threshold.prefetch"; // ns (default 1000000000 = 1 sec, 0=off)
 static const char cXmitResetMaxCount[] = "transmit.window.maxcount.reset"; // allowable max reset count per stream in a transmit window
 static const char cXmitDropMaxCount[] = "transmit.window.maxcount.drop"; // allowable max number of dropped packages in a transmit window
 static const char cXmitUseShaper[] = "transmit.shaper.enable"; // 0=disabled
 static const char cUseWatchdog[] = "watchdog.enable";
-static const char cXmitStrictPktOrder[] = "transmit.pktorder.enable"; // 1=on (default), 0=off
+static const char cXmitStrictPktOrder[] = "transmit.pktorder.enable"; // deprecated, ignored: packets are always sent in launch time order
 static const char cXmitClkUpdateInterval[] = "transmit.clock.updateinterval"; // us
+static const char cXmitBackend[] = "transmit.backend"; // "igb" (default), "socket" (AF_PACKET with SO_TXTIME, needs the etf qdisc) or "capture" (no network, packets are written to transmit.capture.file)
+static const char cXmitSocketRingSize[] = "transmit.socket.ringsize"; // frames of the socket backend's TX ring per class (default 0=no ring, send bursts with sendmmsg)
+static const char cXmitSocketPrio[] = "transmit.socket.prio."; // socket priority selecting the TX queue of the socket backend (default high=3, low=2)
+static const char cXmitCaptureFile[] = "transmit.capture.file"; // pcap file of the capture backend, the TX queue index is appended (default: packets are counted and dropped)
+static const char cXmitRenderAhead[] = "transmit.render.ahead"; // ns, render packets up to x ns ahead of the TX window (default 0=off, render on demand)
+static const char cXmitRenderThread[] = "transmit.render.thread"; // 0=render in the TX thread after submitting a burst (default), 1=separate render thread
+static const char cXmitRenderCpu[] = "transmit.render.cpu."; // CPU the render thread of a class is bound to, class suffix "high"/"low" (default: no affinity)
+static const char cXmitSharedPool[] = "transmit.pool.shared"; // 1=transmit streams lease packets from a shared arena of size classes, 0=pool per stream (default)
+static const char cXmitSharedPoolMax[] = "transmit.pool.shared.max"; // upper limit of packets per size class of the shared arena (default 1024)
 static const char cPtpPdelayCount[] = "ptp.pdelaycount"; //
 static const char cPtpSyncCount[] = "ptp.synccount"; //
 static const char cPtpLoopSleep[] = "ptp.loopsleep"; // ns
@@ -183,6 +205,7 @@ class IasAvbStreamHandlerEnvironment : private virtual IasAvbConfigRegistryInter
 
     static inline const std::string *getNetworkInterfaceName();
     static inline IasLibPtpDaemon *getPtpProxy();
+    static inline IasAvbPacketArena *getPacketArena();
     static inline IasLibMrpDaemon *getMrpProxy();
     static inline device_t *getIgbDevice();
     static inline IasAvbClockDriverInterface *getClockDriver();
@@ -193,6 +216,7 @@ class IasAvbStreamHandlerEnvironment : private virtual IasAvbConfigRegistryInter
     static inline uint32_t getTxRingSize();
     static inline bool isLinkUp();
     static inline bool isTestProfileEnabled();
+    static inline bool isIgbTransmitBackend();
 
     template<class T>
     static inline bool getConfigValue(const std::string &key, T &value);
@@ -263,6 +287,7 @@ class IasAvbStreamHandlerEnvironment : private virtual IasAvbConfigRegistryInter
     bool validateRegistryEntries();
     IasAvbProcessingResult setTxRingSize();
     IasAvbProcessingResult createPtpProxy();
+    IasAvbProcessingResult createPacketArena();
     IasAvbProcessingResult createMrpProxy();
     IasAvbProcessingResult createIgbDevice();
     IasAvbProcessingResult querySourceMac();
@@ -287,6 +312,7 @@ class IasAvbStreamHandlerEnvironment : private virtual IasAvbConfigRegistryInter
     std::string mInterfaceName;
 
     IasLibPtpDaemon* mPtpProxy;
+    IasAvbPacketArena* mPacketArena;
     IasLibMrpDaemon* mMrpProxy;
     device_t* mIgbDevice;
     IasAvbMacAddress mSourceMac;
@@ -353,6 +379,16 @@ inline IasLibPtpDaemon* IasAvbStreamHandlerEnvironment::getPtpProxy()
   return ret;
 }
 
+inline IasAvbPacketArena* IasAvbStreamHandlerEnvironment::getPacketArena()
+{
+  IasAvbPacketArena* ret = NULL;
+  if (NULL != mInstance)
+  {
+    ret = mInstance->mPacketArena;
+  }
+  return ret;
+}
+
 inline IasLibMrpDaemon* IasAvbStreamHandlerEnvironment::getMrpProxy()
 {
   IasLibMrpDaemon* ret = NULL;
@@ -432,6 +468,14 @@ inline bool IasAvbStreamHandlerEnvironment::isTestProfileEnabled()
   return ret;
 }
 
+inline bool IasAvbStreamHandlerEnvironment::isIgbTransmitBackend()
+{
+  std::string backend;
+  (void) getConfigValue(IasRegKeys::cXmitBackend, backend);
+
+  return (backend != "socket") && (backend != "capture");
+}
+
 template<class T>
 inline bool IasAvbStreamHandlerEnvironment::getConfigValue(const std::string &key, T &value)
 {
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbTimeoutWheel.hpp
+ * @brief   Hierarchical timing wheel for the per stream timeouts of the receive engine.
+ * @details Two levels: 256 slots of one tick each, and 64 slots of 256 ticks each which are
+ *          cascaded into the first level when their time has come. Deadlines further away are
+ *          put into the last slot and re-inserted when they are cascaded. Adding, removing and
+ *          expiring a timeout is constant time. The nodes are intrusive, the wheel does not own
+ *          them. Not thread safe, to be used by one thread only.
+ * @date    2018
+ */
+
+#ifndef IASAVBTIMEOUTWHEEL_HPP_
+#define IASAVBTIMEOUTWHEEL_HPP_
+
+#include "avb_streamhandler/IasAvbTypes.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbTimeoutWheel
+{
+  public:
+    struct Node
+    {
+      Node      *next;
+      Node     **pprev;      // NULL if the node is not in the wheel
+      uint64_t   deadline;
+    };
+
+    /**
+     *  @brief Constructor.
+     */
+    IasAvbTimeoutWheel();
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbTimeoutWheel();
+
+    /**
+     * @brief Sets the resolution and the start time, removes all timeouts.
+     *
+     * @param[in] tick duration of a tick in ns
+     * @param[in] now current time in ns
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult init(uint64_t tick, uint64_t now);
+
+    /**
+     * @brief Removes all timeouts. The nodes are not touched, so they may have been deleted already.
+     *
+     * @param[in] now current time in ns
+     */
+    void clear(uint64_t now);
+
+    /**
+     * @brief Adds a timeout. A deadline in the past expires with the next tick.
+     *
+     * @param[in] node node not in the wheel
+     * @param[in] deadline time in ns
+     */
+    void add(Node * node, uint64_t deadline);
+
+    /**
+     * @brief Removes a timeout, nothing happens if the node is not in the wheel.
+     */
+    void remove(Node * node);
+
+    /**
+     * @brief Takes all timeouts out of the wheel whose deadline has been reached.
+     *
+     * @param[in] now current time in ns, must not go backwards
+     * @returns list of the expired nodes linked by their next pointers, NULL if none.
+     *          The nodes may be added again while walking the list, read next before.
+     */
+    Node * expire(uint64_t now);
+
+    /**
+     * @brief returns the time in ns when expire() has to be called next, UINT64_MAX if the wheel is empty
+     *
+     * May be earlier than the earliest deadline, e.g. when timeouts have to be cascaded.
+     */
+    inline uint64_t getNextExpiry() const;
+
+    /**
+     * @brief returns the number of timeouts in the wheel
+     */
+    inline uint32_t getSize() const;
+
+    /**
+     * @brief returns true if the node is in a wheel
+     */
+    static inline bool isLinked(const Node * node);
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbTimeoutWheel(IasAvbTimeoutWheel const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbTimeoutWheel& operator=(IasAvbTimeoutWheel const &other);
+
+    /**
+     * @brief puts the node into the slot matching its deadline
+     */
+    void insert(Node * node);
+
+    /**
+     * @brief links the node into a slot list
+     */
+    static inline void link(Node * &head, Node * node);
+
+    /**
+     * @brief recalculates mNextExpiry by scanning for the next non-empty slot
+     */
+    void updateNextExpiry();
+
+    static const uint32_t cLevel0Bits = 8u;
+    static const uint32_t cLevel0Size = 1u << cLevel0Bits;
+    static const uint32_t cLevel1Size = 64u;
+
+    ///
+    /// Member Variables
+    ///
+
+    Node        *mLevel0[cLevel0Size];
+    Node        *mLevel1[cLevel1Size];
+    uint64_t     mTick;
+    uint64_t     mCurrent;      // last tick processed
+    uint64_t     mNextExpiry;
+    uint32_t     mCount;
+};
+
+
+inline uint64_t IasAvbTimeoutWheel::getNextExpiry() const
+{
+  return mNextExpiry;
+}
+
+inline uint32_t IasAvbTimeoutWheel::getSize() const
+{
+  return mCount;
+}
+
+inline bool IasAvbTimeoutWheel::isLinked(const Node * node)
+{
+  return (NULL != node->pprev);
+}
+
+inline void IasAvbTimeoutWheel::link(Node * &head, Node * node)
+{
+  node->next = head;
+  node->pprev = &head;
+  if (NULL != head)
+  {
+    head->pprev = &node->next;
+  }
+  head = node;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBTIMEOUTWHEEL_HPP_ */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbTransmitBackend.hpp
+ * @brief   Interface between the transmit sequencer and the device that actually sends the packets.
+ * @details This is a pure virtual interface class. Each transmit sequencer owns one backend
+ *          instance which serves the sequencer's TX queue. The backend is selected through the
+ *          "transmit.backend" registry key, see IasAvbIgbTransmitBackend,
+ *          IasAvbSocketTransmitBackend and IasAvbCaptureTransmitBackend for the available
+ *          implementations.
+ * @date    2018
+ */
+
+#ifndef IASAVBTRANSMITBACKEND_HPP_
+#define IASAVBTRANSMITBACKEND_HPP_
+
+#include "IasAvbTypes.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbPacket;
+
+class IasAvbTransmitBackend
+{
+  public:
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbTransmitBackend() {}
+
+    /**
+     * @brief Allocates internal resources and initializes instance.
+     *
+     * @param[in] queueIndex index of the TX queue served by the owning sequencer
+     * @param[in] qavClass SR class of the owning sequencer
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    virtual IasAvbProcessingResult init(uint32_t queueIndex, IasAvbSrClass qavClass) = 0;
+
+    /**
+     *  @brief Clean up all allocated resources.
+     */
+    virtual void cleanup() = 0;
+
+    /**
+     * @brief hand a packet over for transmission at packet->attime
+     *
+     * The return codes follow the igb_xmit() convention:
+     * 0 on success, the packet is owned by the backend until it has been reclaimed.
+     * ENOSPC if the TX ring is full, the packet remains owned by the caller.
+     * -EINVAL or -ENXIO on fatal errors, the packet remains owned by the caller.
+     * Any other value is a non-fatal error, sending may be retried later.
+     *
+     * @param[in] packet packet to be sent
+     * @returns status code as described above
+     */
+    virtual int32_t xmit(IasAvbPacket * packet) = 0;
+
+    /**
+     * @brief hand a burst of packets over for transmission
+     *
+     * Packets are submitted in array order. Submission stops at the first packet that is not
+     * accepted, its xmit() status code is returned in result. The default implementation
+     * submits the packets one by one, backends able to submit several packets at once
+     * override it.
+     *
+     * @param[in] packets array of packets to be sent, ordered by launch time
+     * @param[in] count number of packets in the array
+     * @param[out] result status code of the first packet not accepted, 0 if all were accepted
+     * @returns number of packets accepted, i.e. now owned by the backend
+     */
+    virtual uint32_t xmitBurst(IasAvbPacket * const * packets, uint32_t count, int32_t &result)
+    {
+      uint32_t accepted = 0u;
+
+      result = 0;
+      while ((accepted < count) && (0 == (result = xmit(packets[accepted]))))
+      {
+        accepted++;
+      }
+
+      return accepted;
+    }
+
+    /**
+     * @brief returns the buffers of packets that have been sent to their packet pools
+     *
+     * Backends which cannot reclaim per queue (e.g. igb) only reclaim if doReclaim is set,
+     * which is the case for exactly one sequencer.
+     *
+     * @param[in] doReclaim true if the caller is responsible for reclaiming the packets of all queues
+     * @returns number of re-claimed buffers
+     */
+    virtual uint32_t reclaim(bool doReclaim) = 0;
+
+    /**
+     * @brief configure the credit based shaper of the TX queue
+     *
+     * @param[in] bandwidth bandwidth to be reserved for the queue in kBit/s
+     * @param[in] maxFrameSizeHigh MaxFrameSize of the high class, used when configuring the low class
+     */
+    virtual void updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh) = 0;
+
+  protected:
+    //@{
+    /// can only be created through implementation class
+    IasAvbTransmitBackend() {}
+    //@}
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBTRANSMITBACKEND_HPP_ */
@@ -220,6 +220,15 @@ class IasAvbTransmitEngine : private IasAvbStreamHandlerEventInterface
      */
     IasAvbProcessingResult disconnectStreams(const IasAvbStreamId & avbStreamId);
 
+    /**
+     * @brief Sets the channel routing of an AVB audio stream.
+     *
+     * @param[in] avbStreamId The id of the AVB (audio) stream.
+     * @param[in] routing The routing entries, see IasAvbAudioStream::setChannelRouting()
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult setChannelRouting(const IasAvbStreamId & avbStreamId, const ChannelRoutingList & routing);
+
     /**
      * @brief checks if the given stream id is valid (available)
      *
@@ -287,6 +296,7 @@ class IasAvbTransmitEngine : private IasAvbStreamHandlerEventInterface
     ///
 
     device_t          *mIgbDevice;
+    bool               mInitialized;
     AvbStreamMap       mAvbStreams;
     bool               mUseShaper;
     bool               mUseResume;
@@ -299,7 +309,7 @@ class IasAvbTransmitEngine : private IasAvbStreamHandlerEventInterface
 
 inline bool IasAvbTransmitEngine::isInitialized() const
 {
-  return (NULL != mIgbDevice);
+  return mInitialized;
 }
 
 
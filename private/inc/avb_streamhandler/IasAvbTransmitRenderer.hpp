@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbTransmitRenderer.hpp
+ * @brief   Rendering stage preparing the packets of transmit streams ahead of their TX window.
+ * @details Rendering a packet (reading samples from the local buffer, format conversion, time
+ *          stamp calculation) is moved out of the TX window, so a stream with a heavy payload does
+ *          not delay the launch of the streams behind it. The renderer fills the prefetch queue of
+ *          each stream up to "transmit.render.ahead" ns ahead of the current TX window. It either
+ *          runs in the context of the TX thread after a burst has been submitted, or in a thread of
+ *          its own ("transmit.render.thread"), which can be bound to a CPU core of its own.
+ * @date    2018
+ */
+
+#ifndef IASAVBTRANSMITRENDERER_HPP_
+#define IASAVBTRANSMITRENDERER_HPP_
+
+#include "IasAvbTypes.hpp"
+#include "avb_helper/IasThread.hpp"
+#include "avb_helper/IasIRunnable.hpp"
+#include <mutex>
+#include <vector>
+
+namespace IasMediaTransportAvb {
+
+class IasAvbStream;
+
+class IasAvbTransmitRenderer : private IasMediaTransportAvb::IasIRunnable
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbTransmitRenderer(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbTransmitRenderer();
+
+    /**
+     * @brief Allocates internal resources and initializes instance.
+     *
+     * @param[in] qavClass SR class of the owning sequencer
+     * @param[in] renderAhead packets are rendered up to x ns ahead of the current window
+     * @param[in] pitch interval in ns between two render passes of the render thread
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult init(IasAvbSrClass qavClass, uint64_t renderAhead, uint64_t pitch);
+
+    /**
+     *  @brief Clean up all allocated resources.
+     */
+    void cleanup();
+
+    /**
+     * @brief Starts the render thread, if configured.
+     *
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult start();
+
+    /**
+     * @brief Stops the render thread, if configured.
+     *
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult stop();
+
+    /**
+     * @brief replace the set of streams to be rendered
+     *
+     * Blocks until a render pass in progress has finished, so streams removed from the set
+     * can safely be destroyed once the call returns.
+     */
+    void setStreams(const std::vector<IasAvbStream*> & streams);
+
+    /**
+     * @brief render packets of all streams up to the configured time ahead of windowStart
+     *
+     * @param[in] windowStart start of the next TX window
+     * @returns number of packets rendered
+     */
+    uint32_t render(uint64_t windowStart);
+
+    /**
+     * @brief true if rendering is done by a thread of its own
+     */
+    inline bool isThreaded() const;
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbTransmitRenderer(IasAvbTransmitRenderer const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbTransmitRenderer& operator=(IasAvbTransmitRenderer const &other);
+
+    //{@
+    /// @brief IasRunnable implementation
+    virtual IasResult beforeRun();
+    virtual IasResult run();
+    virtual IasResult shutDown();
+    virtual IasResult afterRun();
+    //@}
+
+    /**
+     * @brief apply scheduling parameters and CPU affinity to the render thread
+     */
+    void setupThread();
+
+    ///
+    /// Member Variables
+    ///
+
+    IasThread            *mRenderThread;
+    IasAvbSrClass         mClass;
+    uint64_t              mRenderAhead;
+    uint64_t              mPitch;
+    int32_t               mCpu;           // CPU the render thread is bound to, -1 for none
+    volatile bool         mEndThread;
+    std::mutex            mLock;          // protects mStreams during a render pass
+    std::vector<IasAvbStream*> mStreams;
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+
+inline bool IasAvbTransmitRenderer::isThreaded() const
+{
+  return (NULL != mRenderThread);
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBTRANSMITRENDERER_HPP_ */
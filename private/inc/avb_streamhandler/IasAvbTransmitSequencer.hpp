@@ -8,10 +8,15 @@
  * @brief   Transmit sequenced perform the actual sending of AVB packets on a per-class basis.
  * @details The transmit sequencer runs a worker thread that checks a vector for active
  *          streams. If there are any, their packets will be requested from 'AvbStream' and
- *          be handed over to the 'igb' device. Packets from multiple streams are multiplexed
- *          based on their packet launch times. The worker thread starts on activation of
- *          the first AVB stream and will be stopped if the last AVB stream has been
- *          deactivated.
+ *          be handed over to the transmit backend ('igb' device or AF_PACKET socket, selected by
+ *          the "transmit.backend" registry key). Packets from multiple streams are multiplexed
+ *          based on their packet launch times, using a heap ordered by launch time. All packets
+ *          due within the current TX window are collected in a burst which is handed over to the
+ *          backend with a single call. Optionally, packets are rendered ahead of the TX window
+ *          by an IasAvbTransmitRenderer ("transmit.render.ahead"), and the window width can be adapted
+ *          to the system load by an IasAvbTransmitWindowController ("transmit.window.adaptive").
+ *          The worker thread starts on activation of the first AVB stream and will be stopped if
+ *          the last AVB stream has been deactivated.
  * @date    2013
  */
 
@@ -21,11 +26,13 @@
 #include "IasAvbTypes.hpp"
 #include "IasAvbStream.hpp"
 #include "IasAvbStreamHandlerEnvironment.hpp"
+#include "IasAvbLaunchTimeQueue.hpp"
 #include "avb_helper/IasThread.hpp"
 #include "avb_helper/IasIRunnable.hpp"
 #include "avb_watchdog/IasWatchdogInterface.hpp"
 #include <mutex>
 #include <set>
+#include <vector>
 
 namespace IasMediaTransportAvb {
 
@@ -33,6 +40,9 @@ class IasLocalAudioStream;
 class IasLocalVideoStream;
 class IasAvbClockDomain;
 class IasAvbStreamHandlerEventInterface;
+class IasAvbTransmitBackend;
+class IasAvbTransmitRenderer;
+class IasAvbTransmitWindowController;
 
 class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
 {
@@ -158,6 +168,7 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
       uint64_t txWindowMaxDropCount;    ///< maximum drop count TX engine can do for each stream during one TX window
       uint64_t txDelay;                 ///< delay launch of packet by x ns (to accomodate travel time through libigb and DMA)
       uint64_t txMaxBandwidth;          ///< maximum bandwidth to be used by all active streams in kBit/s
+      uint64_t txRenderAhead;           ///< render packets up to x ns ahead of the TX window, 0 renders on demand
     };
 
     /**
@@ -178,6 +189,13 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
       uint64_t debugLastLaunchTime;
       IasAvbStream * debugLastStream;
       uint64_t debugLastResetMsgOutputTime;
+      uint32_t bursts;                  ///< number of bursts handed over to the backend
+      uint32_t burstPackets;            ///< number of packets in these bursts
+      uint32_t burstMaxSize;            ///< largest burst
+      uint64_t burstTime;               ///< time spent in the backend for these bursts in ns
+      uint64_t burstMaxTime;            ///< longest time spent in the backend for a single burst in ns
+      uint32_t renderMisses;            ///< packets that had to be rendered on demand despite render-ahead
+      uint32_t burstRetries;            ///< packets the backend did not accept and which were kept for another attempt
     };
 
     enum DoneState
@@ -204,8 +222,10 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
       }
     };
 
-    typedef std::list<StreamData> AvbStreamDataList;
+    typedef IasAvbLaunchTimeQueue<StreamData> AvbStreamDataQueue;
     typedef std::set<IasAvbStream*> AvbStreamSet;
+    typedef std::vector<IasAvbPacket*> PacketBurst;
+    typedef std::vector<IasAvbStream*> StreamBurst;
 
     //
     // helpers
@@ -226,12 +246,11 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
     static const uint64_t cMinTxWindowPitch = 125000u; ///< minimum TX window pitch in ns
     static const uint64_t cMinTxWindowWidth = 250000u; ///< minimum TX window width in ns
     static const uint64_t cTxWindowAdjust = 125000u; ///< step width in ns for adjusting the TX window
+    static const uint32_t cMaxBurstSize = 256u;      ///< burst is handed over early when reaching this size
 
     static const uint32_t cFlagEndThread = 1u;           ///< used to signal the worker thread it should end
     static const uint32_t cFlagRestartThread = 2u;       ///< used to signal the worker thread it should start over
 
-    static const uint32_t cTxMaxInterferenceSize = 1522u; ///< assumed maximum frame size of Non-SR packets
-
 
     /**
      * @brief Copy constructor, private unimplemented to prevent misuse.
@@ -243,6 +262,13 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
      */
     IasAvbTransmitSequencer& operator=(IasAvbTransmitSequencer const &other);
 
+    /**
+     * @brief create the transmit backend selected in the registry
+     *
+     * @returns eIasAvbProcOK on success, otherwise an error will be returned.
+     */
+    IasAvbProcessingResult createBackend();
+
     /**
      * @brief re-claims the buffers for sent packets from the driver
      *
@@ -258,46 +284,56 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
     /**
      * @brief check for requests to activate/deactive streams and update TX sequence
      */
-    void updateSequence(AvbStreamDataList::iterator & it);
+    void updateSequence();
 
     /**
-     * @brief send packet, fetch next one, reorder TX sequence if necessary
+     * @brief queue packet of the stream with the earliest launch time for transmission, fetch next
+     *        one and re-insert the stream into the TX sequence according to the new launch time
+     *
+     * Streams that are done for the current window are parked and not serviced again
+     * until the sequence is re-armed for the next window.
+     *
      * @param[in] windowStart begin of TX window
-     * @param[inout] nextStreamToService reference to next stream to service, affected by reordering
      * @return code for state of the serviced stream
      */
-    DoneState serviceStream(uint64_t windowStart, AvbStreamDataList::iterator & nextStreamToService);
+    DoneState serviceStream(uint64_t windowStart);
 
     /**
-     * @brief update TX sequence depending on packet launch times, determine the next stream that sends a packet
-     * @param[inout] iterator pointing to the element to be sorted
+     * @brief hand all packets queued by serviceStream() over to the backend
+     *
+     * Packets the backend did not accept due to a non-fatal error stay at the head of the burst
+     * and are handed over again by the next call, unless their launch time has passed by then.
+     * After fatal errors and ring overflows they are disposed of.
+     *
+     * @param[in] windowStart start of the current TX window
+     * @return eTxError if the backend reported a fatal error, eNotDone otherwise
      */
-    void sortByLaunchTime(AvbStreamDataList::iterator & it);
+    DoneState flushBurst(uint64_t windowStart);
 
     /**
-     * @brief generate diagnostic output for verbose mode
+     * @brief return the packets of a stream leaving the sequence which are still queued for the backend
      */
-    void logOutput(float elapsed, float reclaimed);
+    void discardBurstPackets(const IasAvbStream * stream);
 
     /**
-     * @brief helper to provide memory barrier functionality
+     * @brief go back to the configured TX window width and pitch
      */
-    inline void sync();
+    void resetTxWindow();
 
     /**
-     * @brief let the thread sleep
+     * @brief generate diagnostic output for verbose mode
      */
-    inline void nssleep(uint32_t ns);
+    void logOutput(float elapsed, float reclaimed);
 
     /**
-     * @brief return next iterator in sequence, considering wrap-around
+     * @brief helper to provide memory barrier functionality
      */
-    inline AvbStreamDataList::iterator next(AvbStreamDataList::iterator it);
+    inline void sync();
 
     /**
-     * @brief return previous iterator in sequence, considering wrap-around
+     * @brief let the thread sleep
      */
-    inline AvbStreamDataList::iterator prev(AvbStreamDataList::iterator it);
+    inline void nssleep(uint32_t ns);
 
     /**
      * @brief reset all packet pools of a the active streams
@@ -312,7 +348,9 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
 
     volatile uint32_t     mThreadControl;
     IasThread            *mTransmitThread;
-    device_t             *mIgbDevice;
+    IasAvbTransmitBackend *mBackend;
+    IasAvbTransmitRenderer *mRenderer;
+    IasAvbTransmitWindowController *mWindowController;
     uint32_t              mQueueIndex;
     IasAvbSrClass         mClass;
     int32_t               mRequestCount;
@@ -322,8 +360,11 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
     uint32_t              mMaxFrameSizeHigh; // used calculate HiCredit for Class B/C
     bool                  mUseShaper;
     uint32_t              mShaperBwRate;
-    AvbStreamDataList     mSequence;
+    AvbStreamDataQueue    mSequence;
     AvbStreamSet          mActiveStreams;
+    PacketBurst           mBurstPackets;
+    StreamBurst           mBurstStreams;  // stream of each packet in mBurstPackets
+    size_t                mBurstRetained; // packets at the head of mBurstPackets carried over from the previous burst
     bool                  mDoReclaim;
     std::mutex            mLock;
     Diag                  mDiag;
@@ -334,7 +375,6 @@ class IasAvbTransmitSequencer : private IasMediaTransportAvb::IasIRunnable
     //IasWatchdog::IasSystemdWatchdogManager *mWatchdog;
     bool                  mFirstRun;
     bool                  mBTMEnable;
-    bool                  mStrictPktOrderEn;
 };
 
 
@@ -364,30 +404,6 @@ inline uint32_t IasAvbTransmitSequencer::getMaxFrameSizeHigh()
   return mMaxFrameSizeHigh;
 }
 
-inline IasAvbTransmitSequencer::AvbStreamDataList::iterator IasAvbTransmitSequencer::next(AvbStreamDataList::iterator it)
-{
-  AVB_ASSERT(it != mSequence.end());
-  it++;
-  if (mSequence.end() == it)
-  {
-    it = mSequence.begin();
-  }
-  return it;
-}
-
-inline IasAvbTransmitSequencer::AvbStreamDataList::iterator IasAvbTransmitSequencer::prev(AvbStreamDataList::iterator it)
-{
-  if (it != mSequence.end())
-  {
-    if (mSequence.begin() == it)
-    {
-      it = mSequence.end();
-    }
-    it--;
-  }
-  return it;
-}
-
 
 inline IasAvbSrClass IasAvbTransmitSequencer::getClass() const
 {
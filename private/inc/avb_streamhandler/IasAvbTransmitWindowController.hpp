@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasAvbTransmitWindowController.hpp
+ * @brief   Closed-loop controller adapting the width of the TX window to the system load.
+ * @details The TX window has to cover the time the TX thread might be late (wakeup oversleep
+ *          plus the time needed to service all streams), otherwise packets miss their launch time.
+ *          A wide window is safe but increases latency and the number of packets in flight, i.e.
+ *          the required TX ring size. The controller measures the demand in each cycle and widens
+ *          the window at once if the slack (width - pitch) gets tight. If the demand stays low for
+ *          a whole evaluation period, the window is narrowed by one step. A TX ring overflow caps
+ *          the width, the cap is lifted step by step while no overflows occur. The pitch is not changed, so the wakeup rate of the TX thread stays the same.
+ * @date    2018
+ */
+
+#ifndef IASAVBTRANSMITWINDOWCONTROLLER_HPP_
+#define IASAVBTRANSMITWINDOWCONTROLLER_HPP_
+
+#include "IasAvbTypes.hpp"
+#include "IasAvbStreamHandlerEnvironment.hpp"
+
+namespace IasMediaTransportAvb {
+
+class IasAvbTransmitWindowController
+{
+  public:
+    /**
+     *  @brief Constructor.
+     */
+    explicit IasAvbTransmitWindowController(DltContext &ctx);
+
+    /**
+     *  @brief Destructor, virtual by default.
+     */
+    virtual ~IasAvbTransmitWindowController();
+
+    /**
+     * @brief Initializes the controller.
+     *
+     * @param[in] widthInit initial width of the TX window in ns
+     * @param[in] pitch TX window pitch in ns
+     * @param[in] minWidth lower bound for the width in ns, at least pitch + cStep
+     * @param[in] maxWidth upper bound for the width in ns
+     * @returns eIasAvbProcOK on success, eIasAvbProcInvalidParam if the bounds are inconsistent
+     */
+    IasAvbProcessingResult init(uint64_t widthInit, uint64_t pitch, uint64_t minWidth, uint64_t maxWidth);
+
+    /**
+     * @brief go back to the initial width and the configured upper bound, e.g. after the TX thread has been restarted
+     */
+    void reset();
+
+    /**
+     * @brief feed the measurements of one TX cycle
+     *
+     * @param[in] oversleep time in ns the TX thread woke up late
+     * @param[in] serviceTime time in ns needed to service all streams and submit the packets
+     * @returns true if the width has been changed
+     */
+    bool update(uint64_t oversleep, uint64_t serviceTime);
+
+    /**
+     * @brief report a TX ring overflow, the current width is too large for the ring
+     *
+     * The width is reduced by one step and is not widened beyond that value until
+     * cCapRecoveryPeriod cycles have passed without another overflow. Then the cap is raised
+     * by one step per period until the configured upper bound is reached again.
+     */
+    void ringFull();
+
+    /**
+     * @brief returns the current TX window width in ns
+     */
+    inline uint64_t getWidth() const;
+
+    /**
+     * @brief returns the upper bound of the width in ns, possibly lowered by ringFull()
+     */
+    inline uint64_t getMaxWidth() const;
+
+    /**
+     * @brief returns the highest demand (oversleep + service time) seen since the last change in ns
+     */
+    inline uint64_t getPeakDemand() const;
+
+    /**
+     * @brief returns the number of times the window has been widened/narrowed
+     */
+    inline uint32_t getWidenCount() const;
+    inline uint32_t getNarrowCount() const;
+
+    static const uint64_t cStep = 125000u;          ///< granularity of width changes in ns
+    static const uint32_t cEvalPeriod = 500u;       ///< cycles of low demand needed before the window is narrowed
+    static const uint32_t cCapRecoveryPeriod = 4000u; ///< cycles without TX ring overflow needed before the cap is raised
+
+  private:
+    /**
+     * @brief Copy constructor, private unimplemented to prevent misuse.
+     */
+    IasAvbTransmitWindowController(IasAvbTransmitWindowController const &other);
+
+    /**
+     * @brief Assignment operator, private unimplemented to prevent misuse.
+     */
+    IasAvbTransmitWindowController& operator=(IasAvbTransmitWindowController const &other);
+
+    ///
+    /// Member Variables
+    ///
+
+    uint64_t              mWidthInit;
+    uint64_t              mWidth;
+    uint64_t              mPitch;
+    uint64_t              mMinWidth;
+    uint64_t              mMaxWidth;      // current upper bound, lowered by ringFull()
+    uint64_t              mMaxWidthConfig;
+    uint64_t              mPeakDemand;
+    uint32_t              mLowCycles;     // consecutive cycles with low demand
+    uint32_t              mCapCycles;     // cycles since the last TX ring overflow
+    uint32_t              mWidenCount;
+    uint32_t              mNarrowCount;
+    DltContext           *mLog;           // context for Log & Trace
+};
+
+
+inline uint64_t IasAvbTransmitWindowController::getWidth() const
+{
+  return mWidth;
+}
+
+inline uint64_t IasAvbTransmitWindowController::getMaxWidth() const
+{
+  return mMaxWidth;
+}
+
+inline uint64_t IasAvbTransmitWindowController::getPeakDemand() const
+{
+  return mPeakDemand;
+}
+
+inline uint32_t IasAvbTransmitWindowController::getWidenCount() const
+{
+  return mWidenCount;
+}
+
+inline uint32_t IasAvbTransmitWindowController::getNarrowCount() const
+{
+  return mNarrowCount;
+}
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASAVBTRANSMITWINDOWCONTROLLER_HPP_ */
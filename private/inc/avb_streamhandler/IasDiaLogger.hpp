@@ -61,6 +61,11 @@ public:
    */
   inline void incTxCount();
 
+  /**
+   * @brief Add a number of sent packets to the packet transmit counter.
+   */
+  inline void addTxCount(uint32_t count);
+
   /**
    * @brief Increment the packet sequence number.
    */
@@ -187,6 +192,12 @@ inline void IasDiaLogger::incTxCount()
 }
 
 
+inline void IasDiaLogger::addTxCount(uint32_t count)
+{
+  mFramesTxCount += count;
+}
+
+
 inline void IasDiaLogger::incSequenceNumber()
 {
   ++mSequenceNumber;
@@ -9,6 +9,24 @@
  * @details Each channel of a local audio stream handles its data via a
  *          separate ring buffer.
  *
+ *          The ring buffer is a wait-free single producer/single consumer queue:
+ *          write() must only be called by one thread and read() by one other thread.
+ *          Each side owns its index and publishes it with release semantics, the
+ *          indices live on separate cache lines so producer and consumer don't
+ *          bounce a shared line. reset() and trim() may be called from any thread,
+ *          they only post a request: the next read() moves the read cursors relative
+ *          to the write index at the time of the request, the next write() afterwards
+ *          resets the state owned by the producer. The monotonic indices keep counting
+ *          across a reset. A read running concurrently with the request being taken
+ *          over doesn't move the read index any further.
+ *
+ *          To feed several consumers from one producer without copying the samples,
+ *          the buffer has up to cMaxReaders read cursors. Each cursor is read by one
+ *          thread of its own, setReaders() selects the cursors in use. The producer
+ *          only sees the slowest cursor in use: free space, overrun accounting and the
+ *          fill level reported by getFillLevel() are based on it. Cursor 0 is the one
+ *          used by the methods without a reader argument.
+ *
  * @date    2013
  */
 
@@ -18,16 +36,23 @@
 
 #include "avb_streamhandler/IasAvbTypes.hpp"
 #include <cstring>
-#include <mutex>
+#include <atomic>
+#include <cmath>
 #include <dlt.h>
 
 namespace IasMediaTransportAvb {
 
 
-class IasLocalAudioBuffer
+/**
+ * @brief Ring buffer for the samples of one channel, T is the local sample type (int16_t, int32_t or float).
+ *
+ * Use IasLocalAudioBuffer, the instance for the sample type the stream handler is built for.
+ */
+template<typename T>
+class IasLocalAudioBufferT
 {
   public:
-    typedef int16_t AudioData;
+    typedef T AudioData;
 
     enum IasAudioBufferState
     {
@@ -37,6 +62,9 @@ class IasLocalAudioBuffer
       eIasAudioBufferStateOverrun  = 3,
     };
 
+    /// number of read cursors
+    static const uint32_t cMaxReaders = 4u;
+
     struct DiagData
     {
         uint32_t numOverrun;
@@ -51,12 +79,12 @@ class IasLocalAudioBuffer
     /**
      *  @brief Constructor.
      */
-    IasLocalAudioBuffer();
+    IasLocalAudioBufferT();
 
     /**
      *  @brief Destructor, virtual by default.
      */
-    virtual ~IasLocalAudioBuffer();
+    virtual ~IasLocalAudioBufferT();
 
     /**
      *  @brief Initialize method.
@@ -68,28 +96,80 @@ class IasLocalAudioBuffer
 
     /**
      *  @brief Reset functionality for the channel buffers
+     *
+     *  Requests all read cursors in use to be set optimalFillLevel samples behind the write index, missing
+     *  samples are zeroed. The request is taken over by the next read(), the samples written since the
+     *  request are kept. The reference fill, the read ready flag and the diagnostic counters are reset by
+     *  the write() following it.
      */
     IasAvbProcessingResult reset(uint32_t optimalFillLevel);
 
+    /**
+     *  @brief Requests the read cursors in use holding more than fillLevel samples to drop the oldest ones
+     *
+     *  Like reset(), the request is taken over by the next read(). Cursors holding fillLevel samples or less
+     *  aren't touched and the producer's state is left alone.
+     */
+    IasAvbProcessingResult trim(uint32_t fillLevel);
+
     /**
      *  @brief Writes data into the local ring buffer
      */
-    uint32_t write(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples);
+    uint32_t write(AudioData * buffer, uint32_t nrSamples);
 
     /**
      *  @brief Writes data into the local ring buffer iterating through samples here instead of in copyJob
      */
-    uint32_t write(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples, uint32_t step);
+    uint32_t write(AudioData * buffer, uint32_t nrSamples, uint32_t step);
 
     /**
      *  @brief Reads data from the local ring buffer iterating through samples here instead of in copyJob
      */
-    uint32_t read(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples, uint32_t step);
+    uint32_t read(AudioData * buffer, uint32_t nrSamples, uint32_t step);
 
     /**
      *  @brief Reads data from the local ring buffer
      */
-    uint32_t read(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples);
+    uint32_t read(AudioData * buffer, uint32_t nrSamples);
+
+    /**
+     *  @brief Reads data from the local ring buffer through the given read cursor
+     */
+    uint32_t read(uint32_t reader, AudioData * buffer, uint32_t nrSamples);
+
+    /**
+     * @brief Selects the read cursors in use, bit n of readerMask stands for cursor n.
+     *
+     * A cursor that is newly taken into use starts at the position of the slowest cursor that has
+     * been in use so far, including its monotonic read index. Taking a cursor out of use doesn't
+     * touch it. Must not be called concurrently with the readers of the cursors affected.
+     *
+     * @returns eIasAvbProcInvalidParam if the mask is empty or refers to a cursor that doesn't exist
+     */
+    IasAvbProcessingResult setReaders(uint32_t readerMask);
+
+    /**
+     * @brief Moves the given read cursor back to the position of the slowest cursor in use.
+     *
+     * Unlike reset(), the other cursors and the producer's state are left alone, so the consumers reading
+     * through them aren't affected. Takes effect immediately, must be called by the consumer owning the cursor.
+     *
+     * @returns eIasAvbProcInvalidParam if the cursor doesn't exist or isn't in use
+     */
+    IasAvbProcessingResult resetReader(uint32_t reader);
+
+    /**
+     * @brief Takes over a pending reset() or trim() request.
+     *
+     * Called by read(), a consumer looking at its monotonic read index before reading calls it first,
+     * so the index already reflects the request. Must only be called by a consumer.
+     */
+    void applyReaderReset();
+
+    /**
+     * @brief get the read cursors in use
+     */
+    inline uint32_t getReaders() const;
 
     /**
      *  @brief Clean up all allocated resources.
@@ -97,10 +177,15 @@ class IasLocalAudioBuffer
     void cleanup();
 
     /**
-     * @brief get current fill level
+     * @brief get current fill level of the slowest read cursor in use
      */
     inline uint32_t getFillLevel() const;
 
+    /**
+     * @brief get current fill level as seen by the given read cursor
+     */
+    inline uint32_t getReaderFillLevel(uint32_t reader) const;
+
     /**
      * @brief get current fill level compared to reference level
      */
@@ -127,10 +212,20 @@ class IasLocalAudioBuffer
     inline uint32_t getReadThreshold();
 
     /**
-     * @brief get current continuous read index
+     * @brief get current continuous read index of the slowest read cursor in use
      */
     inline uint64_t getMonotonicReadIndex() const;
 
+    /**
+     * @brief get current continuous read index of the given read cursor
+     */
+    inline uint64_t getMonotonicReadIndex(uint32_t reader) const;
+
+    /**
+     * @brief get the continuous read index of the slowest read cursor right after the last reset() taken over
+     */
+    inline uint64_t getMonotonicResetIndex() const;
+
     /**
      * @brief get current continuous write index
      */
@@ -146,38 +241,138 @@ class IasLocalAudioBuffer
     /**
      * @brief Copy constructor, private unimplemented to prevent misuse.
      */
-    IasLocalAudioBuffer(IasLocalAudioBuffer const &other);
+    IasLocalAudioBufferT(IasLocalAudioBufferT const &other);
 
     /**
      * @brief Assignment operator, private unimplemented to prevent misuse.
      */
-    IasLocalAudioBuffer& operator=(IasLocalAudioBuffer const &other);
+    IasLocalAudioBufferT& operator=(IasLocalAudioBufferT const &other);
 
-    uint32_t              mReadIndex;
-    uint32_t              mWriteIndex;
-    uint32_t              mReadCnt;
-    uint32_t              mWriteCnt;
-    uint32_t              mTotalSize;       //in samples (IasLocalAudioBuffer::AudioData)
-    uint32_t              mReferenceFill;   //in samples (IasLocalAudioBuffer::AudioData)
+    /**
+     * @brief fill level for the given indices, the index difference wraps around below zero
+     */
+    inline uint32_t getFillLevel(uint32_t writeIndex, uint32_t readIndex) const;
+
+    /**
+     * @brief the read cursor in use that is furthest behind the given write index
+     */
+    inline uint32_t getSlowestReader(uint32_t writeIndex) const;
+
+    /**
+     * @brief resets the state owned by the producer once the consumers have taken over a reset(), called by write()
+     */
+    void applyWriterReset();
+
+    /**
+     * @brief moves the read cursor to newReadIndex, keeping its monotonic read index consistent with the move
+     */
+    void moveReader(uint32_t reader, uint32_t newReadIndex);
+
+    /**
+     * @brief publishes the new read index of the cursor unless a reset has moved it since oldReadIndex has been loaded
+     */
+    void commitRead(uint32_t reader, uint32_t oldReadIndex, uint32_t newReadIndex, uint32_t samplesRead);
+
+    /**
+     * @brief logs the state of the cursor every 32000 reads or when the number of samples read changes
+     */
+    void logRead(uint32_t reader, uint32_t readIndex, uint32_t writeIndex, uint32_t fill, uint32_t samplesRead);
+
+    /**
+     * @brief publishes the new write index and updates the state derived from the fill level
+     */
+    void commitWrite(uint32_t newWriteIndex, uint32_t samplesWritten, uint32_t referenceFill);
+
+    /// padding that keeps the members of producer and consumer on separate cache lines
+    static const size_t cCacheLineSize = 64u;
+
+    /// bits of mResetRequest
+    static const uint32_t cResetReaders = 1u;   ///< reset() posted, to be taken over by a consumer
+    static const uint32_t cTrimReaders  = 2u;   ///< trim() posted, to be taken over by a consumer
+    static const uint32_t cResetWriter  = 4u;   ///< reset() taken over by a consumer, to be finished by the producer
+
+    /**
+     * @brief a read cursor, owned by the consumer reading through it
+     */
+    struct Reader
+    {
+      std::atomic<uint32_t> readIndex;
+      std::atomic<uint64_t> monotonicReadIndex;
+      uint32_t              readCnt;
+      uint32_t              lastRead;
+      uint8_t               padding[cCacheLineSize];
+
+      Reader();
+    };
+
+    // set up by init(), read-only afterwards
+    uint32_t              mTotalSize;       //in samples (AudioData)
+    AudioData            *mBuffer;
+    bool                  mDoAnalysis;
+    DltContext           *mLog;
+    uint32_t              mReadThreshold;
     IasAudioBufferState   mBufferState;
     IasAudioBufferState   mBufferStateLast;
-    bool                  mDoAnalysis;
     uint32_t              mReadIndexLastWriteCall;
-    std::mutex            mLock;
-    int16_t              *mBuffer;
-    uint32_t              mLastRead;
     DiagData              mDiagData;
-    DltContext           *mLog;
-    bool                  mReadReady;
-    uint32_t              mReadThreshold;
-    uint64_t              mMonotonicReadIndex;
-    uint64_t              mMonotonicWriteIndex;
+    std::atomic<uint32_t> mReaderMask;      // changed by setReaders() only
+    std::atomic<uint32_t> mResetRequest;    // posted by reset() and trim(), taken over by read() and write()
+    std::atomic<uint32_t> mResetLevel;      // fill level of the request posted last
+    std::atomic<uint32_t> mResetMark;       // write index when the request has been posted
+    std::atomic<uint64_t> mResetIndex;      // set by the consumer taking over a reset()
+    uint8_t               mPadding0[cCacheLineSize];
+
+    // owned by the producer
+    std::atomic<uint32_t> mWriteIndex;
+    std::atomic<uint64_t> mMonotonicWriteIndex;
+    std::atomic<uint32_t> mReferenceFill;   //in samples (AudioData)
+    std::atomic<bool>     mReadReady;
+    uint32_t              mWriteCnt;
+    uint8_t               mPadding1[cCacheLineSize];
+
+    // owned by the consumers, one per cursor
+    Reader                mReaders[cMaxReaders];
 };
 
 
-inline uint32_t IasLocalAudioBuffer::getFillLevel() const
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getSlowestReader(uint32_t writeIndex) const
+{
+  uint32_t mask = mReaderMask.load(std::memory_order_acquire);
+  uint32_t slowest = 0u;
+
+  if (1u != mask)
+  {
+    uint32_t maxFill = 0u;
+    for (uint32_t reader = 0u; 0u != mask; reader++, mask >>= 1)
+    {
+      if (0u != (mask & 1u))
+      {
+        const uint32_t fill = getFillLevel(writeIndex, mReaders[reader].readIndex.load(std::memory_order_acquire));
+        if (fill >= maxFill)
+        {
+          maxFill = fill;
+          slowest = reader;
+        }
+      }
+    }
+  }
+
+  return slowest;
+}
+
+
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getReaders() const
+{
+  return mReaderMask.load(std::memory_order_relaxed);
+}
+
+
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getFillLevel(uint32_t writeIndex, uint32_t readIndex) const
 {
-  uint32_t ret = mWriteIndex - mReadIndex;
+  uint32_t ret = writeIndex - readIndex;
 
   if (ret > mTotalSize)
   {
@@ -188,32 +383,54 @@ inline uint32_t IasLocalAudioBuffer::getFillLevel() const
 }
 
 
-inline int32_t IasLocalAudioBuffer::getRelativeFillLevel() const
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getFillLevel() const
+{
+  const uint32_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+  return getReaderFillLevel(getSlowestReader(writeIndex));
+}
+
+
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getReaderFillLevel(uint32_t reader) const
+{
+  AVB_ASSERT(reader < cMaxReaders);
+  return getFillLevel(mWriteIndex.load(std::memory_order_acquire),
+                      mReaders[reader].readIndex.load(std::memory_order_acquire));
+}
+
+
+template<typename T>
+inline int32_t IasLocalAudioBufferT<T>::getRelativeFillLevel() const
 {
   int32_t ret = 0;
 
-  if (0 != mReferenceFill)
+  const uint32_t referenceFill = mReferenceFill.load(std::memory_order_relaxed);
+  if (0 != referenceFill)
   {
-    ret = int32_t(getFillLevel() - mReferenceFill);
+    ret = int32_t(getFillLevel() - referenceFill);
   }
 
   return ret;
 }
 
 
-inline uint32_t IasLocalAudioBuffer::getTotalSize() const
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getTotalSize() const
 {
   return mTotalSize;
 }
 
 
-inline bool IasLocalAudioBuffer::isReadReady() const
+template<typename T>
+inline bool IasLocalAudioBufferT<T>::isReadReady() const
 {
-  return mReadReady;
+  return mReadReady.load(std::memory_order_acquire);
 }
 
 
-inline IasAvbProcessingResult IasLocalAudioBuffer::setReadThreshold(uint32_t fillLevel)
+template<typename T>
+inline IasAvbProcessingResult IasLocalAudioBufferT<T>::setReadThreshold(uint32_t fillLevel)
 {
   IasAvbProcessingResult result = eIasAvbProcInvalidParam;
 
@@ -226,24 +443,171 @@ inline IasAvbProcessingResult IasLocalAudioBuffer::setReadThreshold(uint32_t fil
 }
 
 
-inline uint32_t IasLocalAudioBuffer::getReadThreshold()
+template<typename T>
+inline uint32_t IasLocalAudioBufferT<T>::getReadThreshold()
 {
   return mReadThreshold;
 }
 
 
-inline uint64_t IasLocalAudioBuffer::getMonotonicReadIndex() const
+template<typename T>
+inline uint64_t IasLocalAudioBufferT<T>::getMonotonicReadIndex() const
+{
+  return getMonotonicReadIndex(getSlowestReader(mWriteIndex.load(std::memory_order_acquire)));
+}
+
+
+template<typename T>
+inline uint64_t IasLocalAudioBufferT<T>::getMonotonicReadIndex(uint32_t reader) const
+{
+  AVB_ASSERT(reader < cMaxReaders);
+  return mReaders[reader].monotonicReadIndex.load(std::memory_order_relaxed);
+}
+
+
+template<typename T>
+inline uint64_t IasLocalAudioBufferT<T>::getMonotonicWriteIndex() const
 {
-  return mMonotonicReadIndex;
+  return mMonotonicWriteIndex.load(std::memory_order_relaxed);
 }
 
 
-inline uint64_t IasLocalAudioBuffer::getMonotonicWriteIndex() const
+template<typename T>
+inline uint64_t IasLocalAudioBufferT<T>::getMonotonicResetIndex() const
 {
-  return mMonotonicWriteIndex;
+  return mResetIndex.load(std::memory_order_relaxed);
 }
 
 
+/**
+ * @brief Conversion of a local sample from and to the two intermediate representations used at the
+ *        packet boundary: a left-justified 32 bit integer and a float with a full scale of 1.0.
+ *
+ * The conversion to the integer representation is exact, converting back drops the LSBs that
+ * don't fit into T. Conversions from float saturate.
+ */
+template<typename T>
+struct IasLocalAudioSampleTraits;
+
+template<>
+struct IasLocalAudioSampleTraits<int16_t>
+{
+  /// value of a sample at full scale, also the default of audio.tx.floatconversiongain
+  static constexpr float cFullScale = 32767.0f;
+
+  static inline int32_t toInt32(int16_t sample)
+  {
+    return int32_t(uint32_t(uint16_t(sample)) << 16);
+  }
+
+  static inline int16_t fromInt32(int32_t value)
+  {
+    return int16_t(value >> 16);
+  }
+
+  static inline float toFloat(int16_t sample)
+  {
+    return float(sample) * (1.0f / cFullScale);
+  }
+
+  static inline int16_t fromScaledFloat(float value)
+  {
+    // same order of operands as minps/maxps so NaN ends up at full scale like in the SIMD kernels
+    value = (value < 32767.0f) ? value : 32767.0f;
+    value = (value > -32768.0f) ? value : -32768.0f;
+    return int16_t(lrintf(value));
+  }
+
+  static inline int16_t fromFloat(float value)
+  {
+    return fromScaledFloat(value * cFullScale);
+  }
+};
+
+template<>
+struct IasLocalAudioSampleTraits<int32_t>
+{
+  static constexpr float cFullScale = 2147483647.0f;
+
+  static inline int32_t toInt32(int32_t sample)
+  {
+    return sample;
+  }
+
+  static inline int32_t fromInt32(int32_t value)
+  {
+    return value;
+  }
+
+  static inline float toFloat(int32_t sample)
+  {
+    return float(double(sample) * (1.0 / 2147483647.0));
+  }
+
+  static inline int32_t fromScaledFloat(float value)
+  {
+    // float can't represent the integer limits, saturate in double
+    double scaled = double(value);
+    scaled = (scaled < 2147483647.0) ? scaled : 2147483647.0;
+    scaled = (scaled > -2147483648.0) ? scaled : -2147483648.0;
+    return int32_t(lrint(scaled));
+  }
+
+  static inline int32_t fromFloat(float value)
+  {
+    double scaled = double(value) * 2147483647.0;
+    scaled = (scaled < 2147483647.0) ? scaled : 2147483647.0;
+    scaled = (scaled > -2147483648.0) ? scaled : -2147483648.0;
+    return int32_t(lrint(scaled));
+  }
+};
+
+template<>
+struct IasLocalAudioSampleTraits<float>
+{
+  static constexpr float cFullScale = 1.0f;
+
+  static inline int32_t toInt32(float sample)
+  {
+    return IasLocalAudioSampleTraits<int32_t>::fromFloat(sample);
+  }
+
+  static inline float fromInt32(int32_t value)
+  {
+    return IasLocalAudioSampleTraits<int32_t>::toFloat(value);
+  }
+
+  static inline float toFloat(float sample)
+  {
+    return sample;
+  }
+
+  static inline float fromScaledFloat(float value)
+  {
+    return value;
+  }
+
+  static inline float fromFloat(float value)
+  {
+    return value;
+  }
+};
+
+
+/**
+ * @brief The local audio buffer of the sample type selected at build time (LOCAL_AUDIO_SAMPLE_FORMAT).
+ *
+ * All local streams and the shared memory towards the ALSA clients use this sample type, the
+ * conversion to and from the AAF wire format is done once when the packet is written or read.
+ */
+#if defined(IAS_LOCAL_AUDIO_SAMPLE_FLOAT32)
+typedef IasLocalAudioBufferT<float> IasLocalAudioBuffer;
+#elif defined(IAS_LOCAL_AUDIO_SAMPLE_INT32)
+typedef IasLocalAudioBufferT<int32_t> IasLocalAudioBuffer;
+#else
+typedef IasLocalAudioBufferT<int16_t> IasLocalAudioBuffer;
+#endif
+
 } // namespace IasMediaTransportAvb
 
 #endif /* IASLOCALAUDIOBUFFER_HPP_ */
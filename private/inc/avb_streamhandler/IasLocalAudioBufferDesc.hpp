@@ -27,6 +27,7 @@ static const char* AudioBufferDescModeNames[] =
       "off",
       "fail-safe",
       "hard",
+      "presentation",
       "invalid"
   };
 
@@ -39,6 +40,7 @@ class IasLocalAudioBufferDesc
       eIasAudioBufferDescModeOff,
       eIasAudioBufferDescModeFailSafe,
       eIasAudioBufferDescModeHard,
+      eIasAudioBufferDescModePresentation,
       eIasAudioBufferDescModeLast     // invalid entry
     };
 
@@ -84,6 +86,20 @@ class IasLocalAudioBufferDesc
      */
     IasAvbProcessingResult peekX(IasLocalAudioBufferDesc::AudioBufferDesc &desc, uint32_t index);
 
+    /**
+     *  @brief get how far a sample is off its presentation time
+     *
+     *  The presentation time of the sample is extrapolated from the oldest descriptor, using the
+     *  sample rate seen between the two oldest descriptors if available.
+     *
+     *  @param[in] index monotonic buffer index of the sample
+     *  @param[in] now local time at which the sample would be played
+     *  @param[in] sampleFrequency nominal sample frequency of the stream
+     *  @param[out] offset number of samples the sample is early (positive) or late (negative)
+     *  @returns eIasAvbProcOK upon success, eIasAvbProcErr if the queue is empty
+     */
+    IasAvbProcessingResult getPlayoutOffset(uint64_t index, uint64_t now, uint32_t sampleFrequency, int64_t &offset);
+
     /**
      *  @brief flush all descriptors from FIFO
      */
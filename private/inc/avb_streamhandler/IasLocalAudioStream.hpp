@@ -11,6 +11,15 @@
  *          a wave file player or pulse etc. The standard audio format
  *          which is handled currently are 32-bit float values.
  *
+ *          A local stream that transmits to the network can be connected to several
+ *          AVB streams at the same time. Each of them reads the shared ring buffers
+ *          through a read cursor of its own, see IasLocalAudioBuffer::setReaders().
+ *
+ *          A local stream that receives from the network can likewise be connected to
+ *          several AVB streams, e.g. chimes and navigation prompts played on the same sink.
+ *          Their samples are mixed before they enter the ring buffers, see
+ *          writeLocalAudioBuffers(). Each source is placed by its own presentation time.
+ *
  * @date    2013
  */
 
@@ -25,6 +34,8 @@
 #include "avb_streamhandler/IasAvbClockDomain.hpp"
 
 #include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 namespace IasMediaTransportAvb {
@@ -55,6 +66,8 @@ class IasLocalAudioStreamClientInterface
      * samples get lost) or whether it tries to conceal the problem by losing as few samples
      * as possible, without a ringbuffer reset.
      *
+     * The stream doesn't hold any of its locks while calling, the client may call back into it.
+     *
      * @param[in] event code indicating the type of event
      * @param[in] number of affected samples or 0 if unknown
      * @returns true if ring buffer shall be reset, false otherwise
@@ -176,6 +189,9 @@ class IasLocalAudioStream
 
     typedef std::vector<IasLocalAudioBuffer*> LocalAudioBufferVec;
 
+    /// maximum number of clients of a local stream, one per read cursor or mix source
+    static const uint16_t cMaxClients = uint16_t(IasLocalAudioBuffer::cMaxReaders);
+
     /**
      *  @brief Destructor, virtual by default.
      */
@@ -206,11 +222,60 @@ class IasLocalAudioStream
      * @param[in] bufferSize      number of samples to be copied into the buffer
      * @param[out] samplesRead
      * @param[out] timestamp      timestamp which the read samples belong to
+     * @param[in] reader          read cursor of the client, see getReader()
      */
     virtual IasAvbProcessingResult readLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer,
-                                                        uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp);
+                                                        uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp,
+                                                        uint16_t reader = 0u);
 
-    virtual IasAvbProcessingResult dumpFromLocalAudioBuffer(uint16_t &numSamples);
+    /**
+     * @brief write the samples of several channels to the local audio buffers
+     *
+     * Same as calling writeLocalAudioBuffer() for the channels 0 to numChannels-1 in turn,
+     * but the parameters are checked only once per call.
+     *
+     * While several clients are connected to a stream receiving from the network (see isMixing()),
+     * the samples are added to the mix instead. They are placed at the position given by the
+     * presentation time, measured against the presentation time of the other sources. The mix is
+     * passed on to the ring buffers up to the position all active sources have delivered.
+     * Samples of a client that isn't active yet are discarded.
+     *
+     * @param[in] numChannels     number of channels to be written, starting at channel 0
+     * @param[in] buffer          planar buffer, the samples of channel n start at buffer[n * bufferSize]
+     * @param[in] bufferSize      number of samples per channel to be copied into the ring buffers
+     * @param[out] samplesWritten number of samples written to the last channel, or taken into the mix
+     * @param[in] timestamp       timestamp which the samples belong to
+     * @param[in] source          mix source of the client, see getReader()
+     */
+    virtual IasAvbProcessingResult writeLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer,
+                                                          uint32_t bufferSize, uint16_t &samplesWritten, uint32_t timestamp,
+                                                          uint16_t source = 0u);
+
+    /**
+     * @brief read the samples of several channels from the local audio buffers
+     *
+     * Reads the channels 0 to numChannels-1 in one call. The descriptor of the time-aware buffer
+     * is looked up once for all channels, and all channels deliver the same number of samples;
+     * a channel that holds less samples than channel 0 is padded with zeros.
+     *
+     * @param[in] numChannels     number of channels to be read, starting at channel 0
+     * @param[in] buffer          planar buffer, the samples of channel n are copied to buffer[n * bufferSize]
+     * @param[in] bufferSize      maximum number of samples per channel to be copied into the buffer
+     * @param[out] samplesRead    number of samples read per channel
+     * @param[out] timestamp      timestamp which the read samples belong to
+     * @param[in] reader          read cursor of the client, see getReader()
+     */
+    virtual IasAvbProcessingResult readLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer,
+                                                         uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp,
+                                                         uint16_t reader = 0u);
+
+    /**
+     * @brief discards samples from the local audio buffers, at most numSamples per channel
+     *
+     * @param[in,out] numSamples  maximum number of samples to discard, returns the number discarded
+     * @param[in] reader          read cursor of the client, see getReader()
+     */
+    virtual IasAvbProcessingResult dumpFromLocalAudioBuffer(uint16_t &numSamples, uint16_t reader = 0u);
 
 
     inline bool isInitialized() const;
@@ -238,28 +303,67 @@ class IasLocalAudioStream
     /**
      * @brief called by client to register at the local stream upon connection
      *
+     * A local stream backed by ring buffers accepts up to cMaxClients clients, unless it receives
+     * from the network and has a side channel. Any other local stream accepts a single one.
+     * Connecting a second client to a stream receiving from the network turns on mixing.
+     *
      * @param[in] client instance pointer of the object implementing the client interface
      * @returns eIasAvbProcOK on success
      * @returns eIasAvbProcInvalidParam on invalid client pointer
-     * @returns eIasAvbProcAlreadyInUse when already connected
+     * @returns eIasAvbProcAlreadyInUse when already connected or no further client is accepted
      */
     virtual IasAvbProcessingResult connect( IasLocalAudioStreamClientInterface * client );
 
     /**
-     * @brief called by client to unregister at the local stream upon disconnection
+     * @brief unregisters all clients
      * @returns eIasAvbProcOK
      */
     virtual IasAvbProcessingResult disconnect();
 
+    /**
+     * @brief called by client to unregister at the local stream upon disconnection
+     * @returns eIasAvbProcOK
+     */
+    IasAvbProcessingResult disconnect( IasLocalAudioStreamClientInterface * client );
+
+    /**
+     * @brief notifies local audio stream about activity state of the first client, see setClientActive(client, active)
+     */
+    virtual void setClientActive( bool active );
+
     /**
      * @brief notifies local audio stream about activity state of client
      *
-     * A change from inactive to active resets the ring buffer to optimal fill level.
-     * In inactive state, the local stream will not report discontinuity events to the client.
+     * A change from inactive to active resets the ring buffer to optimal fill level, unless another
+     * client is active already. In that case the read cursor of the client joins the slowest one in use.
+     * In inactive state, the local stream will not report discontinuity events to the client and
+     * its read cursor doesn't hold back the writer.
      *
+     * @param[in] client instance pointer of the client
      * @param[in] active true if client is now active, false otherwise
      */
-    virtual void setClientActive( bool active );
+    void setClientActive( IasLocalAudioStreamClientInterface * client, bool active );
+
+    /**
+     * @brief returns the read cursor of a connected client, cMaxClients if the client isn't connected
+     *
+     * For a stream receiving from the network, this is the mix source of the client.
+     */
+    inline uint16_t getReader( const IasLocalAudioStreamClientInterface * client ) const;
+
+    /**
+     * @brief returns true while the samples written by the clients are mixed
+     */
+    inline bool isMixing() const;
+
+    /**
+     * @brief number of times a mixed source fell behind the others by more than the maximum lag
+     *
+     * The mix doesn't wait for such a source any longer, its part is left silent. The maximum lag
+     * is set by the registry key audio.mix.maxlag.
+     */
+    inline uint32_t getMixStalls() const;
+
     inline bool isConnected() const;
     inline bool isReadReady() const;
     inline IasAvbProcessingResult setChannelLayout(uint8_t layout);
@@ -281,8 +385,10 @@ class IasLocalAudioStream
 
     /**
      *  @brief get current timestamp value from the time-aware descriptors FIFO
+     *
+     *  @param[in] reader  read cursor of the client, see getReader()
      */
-    uint64_t getCurrentTimestamp();
+    uint64_t getCurrentTimestamp(uint16_t reader = 0u);
 
     /**
      * @brief get diagnostics counters and info
@@ -306,7 +412,14 @@ class IasLocalAudioStream
     IasAvbProcessingResult init(uint8_t channelLayout, uint16_t numChannels, bool hasSideChannel,
         uint32_t totalSize, uint32_t sampleFrequency, uint32_t alsaPeriodSize = 0u);
 
+    /**
+     * @brief state of the client returned by getClient()
+     */
     inline ClientState getClientState() const;
+
+    /**
+     * @brief the first connected client, it receives the fill level updates of the derived class
+     */
     inline IasLocalAudioStreamClientInterface * getClient() const;
 
     //
@@ -343,11 +456,90 @@ class IasLocalAudioStream
      */
     void updateRxTimestamp(const uint32_t timestamp);
 
+    /**
+     * @brief writes the samples of one channel, the parameters have been checked by the caller
+     *
+     * An overrun is reported to the clients right away. A caller holding mMixLock passes overrun instead,
+     * the largest number of samples lost is collected there and reported by the caller with signalOverrun()
+     * once the lock has been released.
+     */
+    void writeChannel(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize,
+                      uint16_t &samplesWritten, uint32_t timestamp, uint32_t *overrun = NULL);
+
+    /**
+     * @brief reads the samples of numChannels channels starting at firstChannel, the parameters have been checked by the caller
+     */
+    void readChannels(uint16_t firstChannel, uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer,
+                      uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader);
+
+    /**
+     * @brief returns true if at least one client is active
+     */
+    bool hasActiveClient() const;
+
+    /**
+     * @brief state of the client reading through the given cursor
+     */
+    ClientState getReaderState(uint16_t reader) const;
+
+    /**
+     * @brief reports a discontinuity to all active clients, returns true if any of them requests a reset
+     */
+    bool signalDiscontinuity(IasLocalAudioStreamClientInterface::DiscontinuityEvent event, uint32_t numSamples);
+
+    /**
+     * @brief reports an overrun to all active clients and resets the buffers if requested, mMixLock must not be held
+     */
+    void signalOverrun(uint32_t numSamples);
+
+    /**
+     * @brief puts the read cursors of the active clients into use, cursor 0 if there is none
+     */
+    void updateReaders();
+
+    /**
+     * @brief turns mixing on when a receive stream has more than one client, off otherwise
+     */
+    IasAvbProcessingResult updateMixing();
+
+    /**
+     * @brief adds the samples of a source to the mix and passes the completed part on, mMixLock is held by the caller
+     */
+    void mixChannels(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize,
+                     uint16_t &samplesWritten, uint32_t timestamp, uint16_t source);
+
+    /**
+     * @brief writes the mix up to endIndex to the ring buffers, mMixLock is held by the caller
+     */
+    void commitMix(uint64_t endIndex);
+
+    /**
+     * @brief discards the mix, the sources are realigned with their next samples, mMixLock is held by the caller
+     */
+    void resetMix();
+
+    /**
+     * @brief position of the sample with the given presentation time on the mix time line
+     */
+    uint64_t getMixIndex(uint32_t timestamp) const;
+
+    /**
+     * @brief state of a source while mixing
+     */
+    struct MixSource
+    {
+      uint64_t nextIndex;   // position of the next sample of the source on the mix time line
+      uint64_t delay;       // samples the source is played later than its presentation time
+      bool     aligned;     // false until the first samples of the source have been placed
+
+      MixSource();
+    };
+
     //
     // Members
     //
-    ClientState                                 mClientState;
-    IasLocalAudioStreamClientInterface *        mClient;
+    ClientState                                 mClientStates[cMaxClients];   // indexed by read cursor, guarded by mMixLock
+    IasLocalAudioStreamClientInterface *        mClients[cMaxClients];
     IasLocalAudioBufferDesc *                   mBufferDescQ;
     AudioBufferDescMode                         mDescMode;            // -k audio.tstamp.buffer option
     IasLibPtpDaemon *                           mPtpProxy;
@@ -363,6 +555,20 @@ class IasLocalAudioStream
     IasLocalAudioBufferDesc::AudioBufferDesc    mPendingDesc;
     IasLocalAudioStreamDiagnostics              mDiag;
     bool                                        mAlsaRxSyncStart;
+
+    // mixing of several receive streams, guarded by mMixLock
+    mutable std::recursive_mutex                mMixLock;             // reentered by hasActiveClient() on the write path
+    std::atomic<bool>                           mMixing;
+    IasLocalAudioBuffer::AudioData *            mMixBuffer;           // planar, mMixSize samples per channel
+    uint32_t                                    mMixSize;
+    bool                                        mMixAnchored;
+    uint64_t                                    mMixAnchorIndex;      // position that has the presentation time mMixAnchorTime
+    uint32_t                                    mMixAnchorTime;
+    uint64_t                                    mMixCommitIndex;      // the mix before this position has been written
+    MixSource                                   mMixSources[cMaxClients];   // indexed by client
+    uint32_t                                    mMixMaxLag;           // samples a source may fall behind before the mix proceeds without it
+    std::atomic<uint32_t>                       mMixStalls;
+    uint32_t                                    mMixOverrun;          // samples lost while mMixLock was held, reported after it is released
 };
 
 inline bool IasLocalAudioStream::isInitialized() const
@@ -417,17 +623,54 @@ inline IasLocalStreamType IasLocalAudioStream::getType() const
 
 inline IasLocalAudioStream::ClientState IasLocalAudioStream::getClientState() const
 {
-  return mClientState;
+  std::lock_guard<std::recursive_mutex> lock(mMixLock);
+  ClientState state = eIasNotConnected;
+
+  for (uint16_t reader = 0u; (reader < cMaxClients) && (eIasNotConnected == state); reader++)
+  {
+    state = mClientStates[reader];
+  }
+
+  return state;
 }
 
 inline IasLocalAudioStreamClientInterface * IasLocalAudioStream::getClient() const
 {
-  return mClient;
+  IasLocalAudioStreamClientInterface * client = NULL;
+
+  for (uint16_t reader = 0u; (reader < cMaxClients) && (NULL == client); reader++)
+  {
+    client = mClients[reader];
+  }
+
+  return client;
+}
+
+inline uint16_t IasLocalAudioStream::getReader(const IasLocalAudioStreamClientInterface * client) const
+{
+  uint16_t reader = 0u;
+
+  while ((reader < cMaxClients) && ((NULL == client) || (client != mClients[reader])))
+  {
+    reader++;
+  }
+
+  return reader;
+}
+
+inline bool IasLocalAudioStream::isMixing() const
+{
+  return mMixing.load(std::memory_order_relaxed);
+}
+
+inline uint32_t IasLocalAudioStream::getMixStalls() const
+{
+  return mMixStalls.load(std::memory_order_relaxed);
 }
 
 inline bool IasLocalAudioStream::isConnected() const
 {
-  return (eIasNotConnected != mClientState);
+  return (eIasNotConnected != getClientState());
 }
 
 inline bool IasLocalAudioStream::isReadReady() const
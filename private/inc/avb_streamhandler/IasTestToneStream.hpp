@@ -101,9 +101,19 @@ class IasTestToneStream : public IasLocalAudioStream
     virtual IasAvbProcessingResult writeLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesWritten, uint32_t timeStamp);
 
     /**
-     * @brief overwritten version of base class implementation
+     * @brief overwritten version of base class implementation, all readers get the same samples
      */
-    virtual IasAvbProcessingResult readLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp);
+    virtual IasAvbProcessingResult readLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader = 0u);
+
+    /**
+     * @brief overwritten version of base class implementation, only as debug safeguard
+     */
+    virtual IasAvbProcessingResult writeLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesWritten, uint32_t timeStamp, uint16_t source = 0u);
+
+    /**
+     * @brief overwritten version of base class implementation, generates the samples of all channels
+     */
+    virtual IasAvbProcessingResult readLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader = 0u);
 
 
     /**
@@ -118,7 +128,7 @@ class IasTestToneStream : public IasLocalAudioStream
     ///@brief helper for setting the right process method
     void setProcessMethod(ChannelData & ch);
 
-    inline int16_t convertFloatToPcm16(AudioData val);
+    inline IasLocalAudioBuffer::AudioData convertFloatToSample(AudioData val);
 
     uint32_t generateSineWave(IasLocalAudioBuffer::AudioData *buf, uint32_t numSamples, GeneratorParams & params);
     uint32_t generatePulseWave(IasLocalAudioBuffer::AudioData *buf, uint32_t numSamples, GeneratorParams & params);
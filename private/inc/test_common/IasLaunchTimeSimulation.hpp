@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasLaunchTimeSimulation.hpp
+ *  @brief Simulated TX windows, sequenced by the list the transmit sequencer used before and by IasAvbLaunchTimeQueue.
+ *  @date 2018
+ */
+
+#ifndef IASLAUNCHTIMESIMULATION_HPP_
+#define IASLAUNCHTIMESIMULATION_HPP_
+
+#include "avb_streamhandler/IasAvbLaunchTimeQueue.hpp"
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+namespace IasMediaTransportAvb
+{
+
+class IasLaunchTimeSimulation
+{
+  public:
+    enum DoneState
+    {
+      eNotDone,
+      eEndOfWindow
+    };
+
+    /// @brief simplified version of IasAvbTransmitSequencer::StreamData
+    struct Entry
+    {
+      uint32_t stream;
+      bool hasPacket;
+      uint64_t launchTime;
+      DoneState done;
+
+      bool operator<(const Entry& x) const
+      {
+        return launchTime < x.launchTime;
+      }
+    };
+
+    /// @brief simulated stream delivering packets with a fixed interval
+    struct SimStream
+    {
+      uint64_t nextLaunchTime;
+      uint64_t interval;
+    };
+
+    struct Sent
+    {
+      uint32_t window;
+      uint32_t stream;
+      uint64_t launchTime;
+
+      bool operator<(const Sent& x) const
+      {
+        return (window < x.window) || ((window == x.window) && (launchTime < x.launchTime));
+      }
+    };
+
+    typedef std::vector<Sent> SentList;
+    typedef std::list<Entry> EntryList;
+
+    static const uint64_t cWindowWidth = 24u * 125000u;
+    static const uint64_t cWindowPitch = 16u * 125000u;
+
+    /**
+     * @brief creates class A and class B streams with distinct phases, using rand()
+     */
+    static void createStreams(std::vector<SimStream> & streams, uint32_t count);
+
+    /**
+     * @brief runs the list based sequencing the transmit sequencer used before switching to the heap
+     *
+     * @param[in,out] streams the streams to be serviced, their next launch times advance
+     * @param[in] windows number of TX windows to run
+     * @param[out] sent packets sent, in the order sent, NULL if not needed
+     */
+    static void runList(std::vector<SimStream> & streams, uint32_t windows, SentList * sent);
+
+    /**
+     * @brief runs the heap based sequencing, see runList()
+     */
+    static void runHeap(std::vector<SimStream> & streams, uint32_t windows, SentList * sent);
+
+  private:
+    static EntryList::iterator next(EntryList & seq, EntryList::iterator it);
+    static EntryList::iterator prev(EntryList & seq, EntryList::iterator it);
+    static void sortByLaunchTime(EntryList & seq, EntryList::iterator & it);
+    static DoneState serviceList(EntryList & seq, std::vector<SimStream> & streams, uint32_t window, uint64_t windowStart,
+                                 EntryList::iterator & it, SentList * sent);
+    static DoneState serviceHeap(IasAvbLaunchTimeQueue<Entry> & seq, std::vector<SimStream> & streams, uint32_t window,
+                                 uint64_t windowStart, SentList * sent);
+};
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASLAUNCHTIMESIMULATION_HPP_ */
@@ -301,7 +301,7 @@ IasAvbProcessingResult IasAlsaEngine::createAlsaStream(IasAvbStreamDirection dir
           /*.name        = */ "invalid",              // will be overwritten later
           /*.numChannels = */ numChannels,
           /*.samplerate  = */ sampleFreqASRC,
-          /*.dataFormat  = */ eIasFormatInt16,        // ABu: ToDo: currently only int16 supported
+          /*.dataFormat  = */ IasAvbAudioShmProvider::getDataFormat(), // local sample type
           /*.clockType   = */ eIasClockReceivedAsync, // ABu:  ToDo: check with Alsa Clock Domain
           /*.periodSize  = */ periodSize,
           /*.numPeriodsAsrcBuffer  = */ 4,            // use default: 4 -> default is set in IasAudioCommonTypes IasAudioDeviceParams() line 328.
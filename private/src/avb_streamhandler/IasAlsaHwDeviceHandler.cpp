@@ -695,14 +695,6 @@ IasAvbProcessingResult IasAlsaHwDeviceHandler::resetBuffers()
 
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
 
-  IasLocalAudioBufferDesc *descQ = NULL;
-  if (true == hasBufferDesc())
-  {
-    descQ = getBufferDescQ();
-    AVB_ASSERT(NULL != descQ);
-    descQ->lock();
-  }
-
   for(int channelIdx=0; channelIdx< mNumChannels; channelIdx++)
   {
     IasLocalAudioBuffer *buffer = IasLocalAudioStream::getChannelBuffers()[channelIdx];
@@ -710,30 +702,16 @@ IasAvbProcessingResult IasAlsaHwDeviceHandler::resetBuffers()
 
     if (true == hasBufferDesc())
     {
-      IasLocalAudioBuffer::AudioData * dummyData = NULL;
-
-      uint32_t fillLevel = buffer->getFillLevel();
-      if (mOptimalFillLevel == fillLevel)
-      {
-        continue;
-      }
-      else if (mOptimalFillLevel < fillLevel)
+      if (mOptimalFillLevel < buffer->getFillLevel())
       {
-        // discard samples
-        uint32_t bufferSize  = fillLevel - mOptimalFillLevel;
-        uint16_t samplesRead = 0;
-
-        dummyData = new (nothrow) IasLocalAudioBuffer::AudioData[bufferSize];
-        AVB_ASSERT(dummyData != NULL);
-
         /*
-         * dumpFromLocalAudioBuffer() should not be used to discard samples here
-         * because we need to discard corresponding descriptors as well.
+         * Discard the samples beyond the optimal fill level. This may run on the producer's thread after an
+         * overrun, so the samples are not read from here: each consumer drops them from its own read cursor
+         * with its next read and the descriptors passed by all cursors are deleted along with them.
          */
-        uint64_t timeStamp = 0u;
-        (void) readLocalAudioBuffer(uint16_t(channelIdx), dummyData, bufferSize, samplesRead, timeStamp);
+        (void) buffer->trim(mOptimalFillLevel);
       }
-      else // fillLevel < mOptimalFillLevel
+      else
       {
         /*
          * The time-aware buffer accumulates samples up to half-full before allowing initial read access.
@@ -745,12 +723,6 @@ IasAvbProcessingResult IasAlsaHwDeviceHandler::resetBuffers()
          * freewheels. We don't need to fill the buffer with dummy samples here.
          */
       }
-
-      if (NULL != dummyData)
-      {
-        delete[] dummyData;
-        dummyData = NULL;
-      }
     }
     else
     {
@@ -758,11 +730,6 @@ IasAvbProcessingResult IasAlsaHwDeviceHandler::resetBuffers()
     }
   }
 
-  if (true == hasBufferDesc())
-  {
-    descQ->unlock();
-  }
-
   return error;
 }
 
@@ -932,6 +899,12 @@ void IasAlsaHwDeviceHandler::copyJob(uint64_t timestamp)
 
       if (IasAudio::eIasRingBufferAccessWrite == accessDirection) // receive stream
       {
+        // a reset requested by another thread moves the read indices, take it over before they are looked at
+        for (uint32_t channel = 0; channel < numChannels; channel++)
+        {
+          buffers[channel]->applyReaderReset();
+        }
+
         /*
          * wait until buffer fill level reaches at least half-full in time-aware buffering mode
          */
@@ -950,7 +923,8 @@ void IasAlsaHwDeviceHandler::copyJob(uint64_t timestamp)
 
             // detect a far-away timestamp
             uint64_t timeGap = (now > desc.timeStamp) ? (now - desc.timeStamp) : (desc.timeStamp - now);
-            if ((maxPtGap < timeGap) && (IasLocalAudioBufferDesc::eIasAudioBufferDescModeHard == mDescMode))
+            if ((maxPtGap < timeGap) && ((IasLocalAudioBufferDesc::eIasAudioBufferDescModeHard == mDescMode) ||
+                                         (IasLocalAudioBufferDesc::eIasAudioBufferDescModePresentation == mDescMode)))
             {
               DLT_LOG(*mLog, DLT_LOG_WARN, DLT_STRING("[IasAvbAudioShmProvider::copyJob]"),
                   DLT_STRING("detected out-of-bound presentation timestamp"), DLT_STRING("timestamp="),
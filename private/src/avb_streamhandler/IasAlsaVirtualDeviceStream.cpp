@@ -126,14 +126,6 @@ IasAvbProcessingResult IasAlsaVirtualDeviceStream::resetBuffers()
 
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
 
-  IasLocalAudioBufferDesc *descQ = NULL;
-  if (true == hasBufferDesc())
-  {
-    descQ = getBufferDescQ();
-    AVB_ASSERT(NULL != descQ);
-    descQ->lock();
-  }
-
   for(int channelIdx=0; channelIdx< mNumChannels; channelIdx++)
   {
     IasLocalAudioBuffer *buffer = IasLocalAudioStream::getChannelBuffers()[channelIdx];
@@ -141,30 +133,16 @@ IasAvbProcessingResult IasAlsaVirtualDeviceStream::resetBuffers()
 
     if (true == hasBufferDesc())
     {
-      IasLocalAudioBuffer::AudioData * dummyData = NULL;
-
-      uint32_t fillLevel = buffer->getFillLevel();
-      if (mOptimalFillLevel == fillLevel)
+      if (mOptimalFillLevel < buffer->getFillLevel())
       {
-        continue;
-      }
-      else if (mOptimalFillLevel < fillLevel)
-      {
-        // discard samples
-        uint32_t bufferSize = fillLevel - mOptimalFillLevel;
-        uint16_t samplesRead = 0;
-
-        dummyData = new (nothrow) IasLocalAudioBuffer::AudioData[bufferSize];
-        AVB_ASSERT(dummyData != NULL);
-
         /*
-         * dumpFromLocalAudioBuffer() should not be used to discard samples here
-         * because we need to discard corresponding descriptors as well.
+         * Discard the samples beyond the optimal fill level. This may run on the producer's thread after an
+         * overrun, so the samples are not read from here: each consumer drops them from its own read cursor
+         * with its next read and the descriptors passed by all cursors are deleted along with them.
          */
-        uint64_t timeStamp = 0u;
-        (void) readLocalAudioBuffer(uint16_t(channelIdx), dummyData, bufferSize, samplesRead, timeStamp);
+        (void) buffer->trim(mOptimalFillLevel);
       }
-      else // fillLevel < mOptimalFillLevel
+      else
       {
         /*
          * The time-aware buffer accumulates samples up to half-full before allowing initial read access.
@@ -176,12 +154,6 @@ IasAvbProcessingResult IasAlsaVirtualDeviceStream::resetBuffers()
          * freewheels. We don't need to fill the buffer with dummy samples here.
          */
       }
-
-      if (NULL != dummyData)
-      {
-        delete[] dummyData;
-        dummyData = NULL;
-      }
     }
     else
     {
@@ -189,11 +161,6 @@ IasAvbProcessingResult IasAlsaVirtualDeviceStream::resetBuffers()
     }
   }
 
-  if (true == hasBufferDesc())
-  {
-    descQ->unlock();
-  }
-
   return error;
 }
 
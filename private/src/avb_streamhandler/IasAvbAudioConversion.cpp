@@ -0,0 +1,1415 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbAudioConversion.cpp
+ * @brief   The definition of the IasAvbAudioConversion class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbAudioConversion.hpp"
+#include "avb_streamhandler/IasAvbAudioStream.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * The AVX2 kernels are built with the target pragma of GCC, so the library doesn't need to be
+ * compiled for AVX2. They are only used if the CPU reports AVX2 support.
+ */
+#if defined(__SSE2__) && defined(__GNUC__) && !defined(__clang__)
+#define IAS_AVB_CONVERSION_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace IasMediaTransportAvb {
+
+typedef IasAvbAudioConversion::AudioData AudioData;
+
+
+/*
+ * Scalar kernels, also used for the samples left over by the block kernels
+ */
+template<IasAvbAudioFormat F>
+static void packScalar(const AudioData *src, uint8_t *dst, uint32_t numSamples, uint32_t stride)
+{
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    IasAvbAudioFormatTraits<F>::pack(src[sample], dst);
+    dst += stride;
+  }
+}
+
+template<IasAvbAudioFormat F>
+static void unpackScalar(const uint8_t *src, AudioData *dst, uint32_t numSamples, uint32_t stride)
+{
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    dst[sample] = IasAvbAudioFormatTraits<F>::unpack(src);
+    src += stride;
+  }
+}
+
+
+#ifdef __SSE2__
+/*
+ * SSE2 kernels
+ *
+ * A block converts cSamples samples between the local buffer and cSlotSize byte slots in wire
+ * format. For a single channel the slots are the payload, otherwise the slots are scattered
+ * to/gathered from the interleaved payload. SAF24 uses the SAF32 block and ignores the last byte
+ * of each slot. Gathering costs more than the plain byte swap of the integer formats saves, so
+ * only blocks with cGather set are used to read interleaved payloads.
+ */
+static inline __m128i swap16(__m128i v)
+{
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline __m128i swap32(__m128i v)
+{
+  v = swap16(v);
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+struct Sse2Saf16Block
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 2u;
+  static const bool cGather = false;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire), swap16(v));
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wire));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), swap16(v));
+  }
+};
+
+struct Sse2Saf32Block
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = false;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    // swapped sample goes to the lower half of the little endian slot, i.e. the first two bytes on the wire
+    const __m128i v = swap16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire), _mm_unpacklo_epi16(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire + 16), _mm_unpackhi_epi16(v, zero));
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    // sign extend the first two bytes of each slot, so the pack doesn't saturate
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wire));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wire + 16));
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), swap16(_mm_packs_epi32(lo, hi)));
+  }
+};
+
+struct Sse2SafFloatBlock
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = true;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128 scale = _mm_set1_ps(1.0f / float(IasAvbAudioConversion::cFloatScale));
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire),
+        swap32(_mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(lo), scale))));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire + 16),
+        swap32(_mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(hi), scale))));
+  }
+
+  static inline __m128i toInt(__m128i bits)
+  {
+    __m128 value = _mm_mul_ps(_mm_castsi128_ps(swap32(bits)), _mm_set1_ps(float(IasAvbAudioConversion::cFloatScale)));
+    value = _mm_min_ps(value, _mm_set1_ps(32767.0f));
+    value = _mm_max_ps(value, _mm_set1_ps(-32768.0f));
+    return _mm_cvtps_epi32(value);
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    const __m128i lo = toInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wire)));
+    const __m128i hi = toInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wire + 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(lo, hi));
+  }
+};
+
+struct Sse2Am824Block
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = true;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    // label in the first byte, the swapped sample in the two bytes after it, the last byte stays zero
+    const __m128i v = swap16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i label = _mm_set1_epi32(IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883>::cLabel);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire), _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(v, zero), 8), label));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wire + 16), _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(v, zero), 8), label));
+  }
+
+  // sign extended sample bytes of four quadlets, zero if the label isn't audio
+  static inline __m128i strip(__m128i quadlets)
+  {
+    typedef IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883> Traits;
+    const __m128i isAudio = _mm_cmpeq_epi32(_mm_and_si128(quadlets, _mm_set1_epi32(Traits::cLabelMask)),
+                                            _mm_set1_epi32(Traits::cLabel));
+    const __m128i sample = _mm_srai_epi32(_mm_slli_epi32(quadlets, 8), 16);
+    return _mm_and_si128(sample, isAudio);
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    const __m128i lo = strip(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wire)));
+    const __m128i hi = strip(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wire + 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), swap16(_mm_packs_epi32(lo, hi)));
+  }
+};
+
+template<IasAvbAudioFormat F> struct Sse2Block;
+template<> struct Sse2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf16> : public Sse2Saf16Block {};
+template<> struct Sse2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf24> : public Sse2Saf32Block {};
+template<> struct Sse2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf32> : public Sse2Saf32Block {};
+template<> struct Sse2Block<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat> : public Sse2SafFloatBlock {};
+template<> struct Sse2Block<IasAvbAudioFormat::eIasAvbAudioFormatIec61883> : public Sse2Am824Block {};
+
+template<IasAvbAudioFormat F>
+static void packSse2(const int16_t *src, uint8_t *dst, uint32_t numSamples, uint32_t stride)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+  typedef Sse2Block<F> Block;
+  uint32_t sample = 0u;
+
+  if ((Block::cSlotSize == Traits::cSampleSize) && (Block::cSlotSize == stride))
+  {
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::pack(src + sample, dst);
+      dst += Block::cSamples * Block::cSlotSize;
+    }
+  }
+  else
+  {
+    uint8_t wire[Block::cSamples * Block::cSlotSize];
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::pack(src + sample, wire);
+      for (uint32_t idx = 0u; idx < Block::cSamples; idx++)
+      {
+        (void) std::memcpy(dst, wire + (idx * Block::cSlotSize), Traits::cSampleSize);
+        dst += stride;
+      }
+    }
+  }
+
+  packScalar<F>(src + sample, dst, numSamples - sample, stride);
+}
+
+template<IasAvbAudioFormat F>
+static void unpackSse2(const uint8_t *src, int16_t *dst, uint32_t numSamples, uint32_t stride)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+  typedef Sse2Block<F> Block;
+  uint32_t sample = 0u;
+
+  if ((Block::cSlotSize == Traits::cSampleSize) && (Block::cSlotSize == stride))
+  {
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::unpack(src, dst + sample);
+      src += Block::cSamples * Block::cSlotSize;
+    }
+  }
+  else if (Block::cGather)
+  {
+    uint8_t wire[Block::cSamples * Block::cSlotSize] = {0u};
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      for (uint32_t idx = 0u; idx < Block::cSamples; idx++)
+      {
+        (void) std::memcpy(wire + (idx * Block::cSlotSize), src, Traits::cSampleSize);
+        src += stride;
+      }
+      Block::unpack(wire, dst + sample);
+    }
+  }
+
+  unpackScalar<F>(src, dst + sample, numSamples - sample, stride);
+}
+#endif /* __SSE2__ */
+
+
+#ifdef IAS_AVB_CONVERSION_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2")
+/*
+ * AVX2 kernels, same scheme as the SSE2 ones
+ */
+static inline __m256i swap16Avx2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+}
+
+static inline __m256i swap32Avx2(__m256i v)
+{
+  const __m256i mask = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                       12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+  return _mm256_shuffle_epi8(v, mask);
+}
+
+// packs 8 sign extended 32 bit values to 16 bit, in order
+static inline __m128i narrowAvx2(__m256i v)
+{
+  return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi32(v, v), _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+struct Avx2Saf16Block
+{
+  static const uint32_t cSamples = 16u;
+  static const uint32_t cSlotSize = 2u;
+  static const bool cGather = false;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(wire), swap16Avx2(v));
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wire));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), swap16Avx2(v));
+  }
+};
+
+struct Avx2Saf32Block
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = false;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    const __m128i v = swap16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(wire), _mm256_cvtepu16_epi32(v));
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wire));
+    v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), swap16(narrowAvx2(v)));
+  }
+};
+
+struct Avx2SafFloatBlock
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = true;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m256 value = _mm256_mul_ps(_mm256_cvtepi32_ps(v), _mm256_set1_ps(1.0f / float(IasAvbAudioConversion::cFloatScale)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(wire), swap32Avx2(_mm256_castps_si256(value)));
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    const __m256i bits = swap32Avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(wire)));
+    __m256 value = _mm256_mul_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(float(IasAvbAudioConversion::cFloatScale)));
+    value = _mm256_min_ps(value, _mm256_set1_ps(32767.0f));
+    value = _mm256_max_ps(value, _mm256_set1_ps(-32768.0f));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), narrowAvx2(_mm256_cvtps_epi32(value)));
+  }
+};
+
+struct Avx2Am824Block
+{
+  static const uint32_t cSamples = 8u;
+  static const uint32_t cSlotSize = 4u;
+  static const bool cGather = true;
+
+  static inline void pack(const int16_t *src, uint8_t *wire)
+  {
+    typedef IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883> Traits;
+    const __m128i v = swap16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    const __m256i quadlets = _mm256_or_si256(_mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 8), _mm256_set1_epi32(Traits::cLabel));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(wire), quadlets);
+  }
+
+  static inline void unpack(const uint8_t *wire, int16_t *dst)
+  {
+    typedef IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883> Traits;
+    const __m256i quadlets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wire));
+    const __m256i isAudio = _mm256_cmpeq_epi32(_mm256_and_si256(quadlets, _mm256_set1_epi32(Traits::cLabelMask)),
+                                               _mm256_set1_epi32(Traits::cLabel));
+    const __m256i sample = _mm256_and_si256(_mm256_srai_epi32(_mm256_slli_epi32(quadlets, 8), 16), isAudio);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), swap16(narrowAvx2(sample)));
+  }
+};
+
+template<IasAvbAudioFormat F> struct Avx2Block;
+template<> struct Avx2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf16> : public Avx2Saf16Block {};
+template<> struct Avx2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf24> : public Avx2Saf32Block {};
+template<> struct Avx2Block<IasAvbAudioFormat::eIasAvbAudioFormatSaf32> : public Avx2Saf32Block {};
+template<> struct Avx2Block<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat> : public Avx2SafFloatBlock {};
+template<> struct Avx2Block<IasAvbAudioFormat::eIasAvbAudioFormatIec61883> : public Avx2Am824Block {};
+
+/*
+ * same as packSse2()/unpackSse2(), but built for AVX2 so the blocks get inlined
+ */
+template<IasAvbAudioFormat F>
+static void packAvx2(const int16_t *src, uint8_t *dst, uint32_t numSamples, uint32_t stride)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+  typedef Avx2Block<F> Block;
+  uint32_t sample = 0u;
+
+  if ((Block::cSlotSize == Traits::cSampleSize) && (Block::cSlotSize == stride))
+  {
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::pack(src + sample, dst);
+      dst += Block::cSamples * Block::cSlotSize;
+    }
+  }
+  else
+  {
+    uint8_t wire[Block::cSamples * Block::cSlotSize];
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::pack(src + sample, wire);
+      for (uint32_t idx = 0u; idx < Block::cSamples; idx++)
+      {
+        (void) std::memcpy(dst, wire + (idx * Block::cSlotSize), Traits::cSampleSize);
+        dst += stride;
+      }
+    }
+  }
+
+  packScalar<F>(src + sample, dst, numSamples - sample, stride);
+}
+
+template<IasAvbAudioFormat F>
+static void unpackAvx2(const uint8_t *src, int16_t *dst, uint32_t numSamples, uint32_t stride)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+  typedef Avx2Block<F> Block;
+  uint32_t sample = 0u;
+
+  if ((Block::cSlotSize == Traits::cSampleSize) && (Block::cSlotSize == stride))
+  {
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      Block::unpack(src, dst + sample);
+      src += Block::cSamples * Block::cSlotSize;
+    }
+  }
+  else if (Block::cGather)
+  {
+    uint8_t wire[Block::cSamples * Block::cSlotSize] = {0u};
+    for (; (sample + Block::cSamples) <= numSamples; sample += Block::cSamples)
+    {
+      for (uint32_t idx = 0u; idx < Block::cSamples; idx++)
+      {
+        (void) std::memcpy(wire + (idx * Block::cSlotSize), src, Traits::cSampleSize);
+        src += stride;
+      }
+      Block::unpack(wire, dst + sample);
+    }
+  }
+
+  unpackScalar<F>(src, dst + sample, numSamples - sample, stride);
+}
+#pragma GCC pop_options
+#endif /* IAS_AVB_CONVERSION_AVX2 */
+
+
+/*
+ * Interleaving
+ *
+ * Channel counts of eight and more are handled as blocks of eight channels by an 8x8 transpose
+ * of 16 bit samples, two and four channels have their own kernels. Everything else, and the
+ * samples left over by the blocks, is copied sample by sample. This is pure data movement, so
+ * SSE2 is sufficient and there are no AVX2 versions.
+ */
+static void interleaveScalar(const AudioData *src, uint32_t pitch, AudioData *dst, uint16_t numChannels,
+                             uint16_t firstChannel, uint32_t firstSample, uint32_t numSamples)
+{
+  for (uint32_t sample = firstSample; sample < numSamples; sample++)
+  {
+    AudioData * const frame = dst + (sample * numChannels);
+    for (uint16_t channel = firstChannel; channel < numChannels; channel++)
+    {
+      frame[channel] = src[(channel * pitch) + sample];
+    }
+  }
+}
+
+static void deinterleaveScalar(const AudioData *src, AudioData *dst, uint32_t pitch, uint16_t numChannels,
+                               uint16_t firstChannel, uint32_t firstSample, uint32_t numSamples)
+{
+  for (uint32_t sample = firstSample; sample < numSamples; sample++)
+  {
+    const AudioData * const frame = src + (sample * numChannels);
+    for (uint16_t channel = firstChannel; channel < numChannels; channel++)
+    {
+      dst[(channel * pitch) + sample] = frame[channel];
+    }
+  }
+}
+
+#ifdef __SSE2__
+static inline __m128i load(const int16_t *src)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+static inline void store(int16_t *dst, __m128i v)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+}
+
+/*
+ * Transposes eight rows of eight 16 bit samples, the rows are read from src, src + srcStep, ...
+ * and written to dst, dst + dstStep, ... Everything is spelled out, so the compiler keeps the
+ * rows in registers.
+ */
+static inline void transpose8x8(const int16_t *src, uint32_t srcStep, int16_t *dst, uint32_t dstStep)
+{
+  const __m128i r0 = load(src);
+  const __m128i r1 = load(src + srcStep);
+  const __m128i r2 = load(src + (2u * srcStep));
+  const __m128i r3 = load(src + (3u * srcStep));
+  const __m128i r4 = load(src + (4u * srcStep));
+  const __m128i r5 = load(src + (5u * srcStep));
+  const __m128i r6 = load(src + (6u * srcStep));
+  const __m128i r7 = load(src + (7u * srcStep));
+
+  const __m128i t0 = _mm_unpacklo_epi16(r0, r1);
+  const __m128i t1 = _mm_unpackhi_epi16(r0, r1);
+  const __m128i t2 = _mm_unpacklo_epi16(r2, r3);
+  const __m128i t3 = _mm_unpackhi_epi16(r2, r3);
+  const __m128i t4 = _mm_unpacklo_epi16(r4, r5);
+  const __m128i t5 = _mm_unpackhi_epi16(r4, r5);
+  const __m128i t6 = _mm_unpacklo_epi16(r6, r7);
+  const __m128i t7 = _mm_unpackhi_epi16(r6, r7);
+
+  const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+  const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+  const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+  const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+  const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+  const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+  const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+  const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+  store(dst,                  _mm_unpacklo_epi64(u0, u4));
+  store(dst + dstStep,        _mm_unpackhi_epi64(u0, u4));
+  store(dst + (2u * dstStep), _mm_unpacklo_epi64(u1, u5));
+  store(dst + (3u * dstStep), _mm_unpackhi_epi64(u1, u5));
+  store(dst + (4u * dstStep), _mm_unpacklo_epi64(u2, u6));
+  store(dst + (5u * dstStep), _mm_unpackhi_epi64(u2, u6));
+  store(dst + (6u * dstStep), _mm_unpacklo_epi64(u3, u7));
+  store(dst + (7u * dstStep), _mm_unpackhi_epi64(u3, u7));
+}
+
+// returns the number of samples done per channel
+static inline uint32_t interleaveSse2(const int16_t *src, uint32_t pitch, int16_t *dst, uint16_t numChannels,
+                               uint32_t numSamples, uint16_t &channelsDone)
+{
+  const uint32_t blockSamples = numSamples & ~7u;
+  uint32_t sample = 0u;
+  channelsDone = numChannels;
+
+  if (2u == numChannels)
+  {
+    for (; sample < blockSamples; sample += 8u)
+    {
+      const __m128i a = load(src + sample);
+      const __m128i b = load(src + pitch + sample);
+      int16_t * const frame = dst + (sample * 2u);
+      store(frame, _mm_unpacklo_epi16(a, b));
+      store(frame + 8, _mm_unpackhi_epi16(a, b));
+    }
+  }
+  else if (4u == numChannels)
+  {
+    for (; sample < blockSamples; sample += 8u)
+    {
+      const __m128i ab0 = _mm_unpacklo_epi16(load(src + sample), load(src + pitch + sample));
+      const __m128i ab1 = _mm_unpackhi_epi16(load(src + sample), load(src + pitch + sample));
+      const __m128i cd0 = _mm_unpacklo_epi16(load(src + (2u * pitch) + sample), load(src + (3u * pitch) + sample));
+      const __m128i cd1 = _mm_unpackhi_epi16(load(src + (2u * pitch) + sample), load(src + (3u * pitch) + sample));
+      int16_t * const frame = dst + (sample * 4u);
+      store(frame,      _mm_unpacklo_epi32(ab0, cd0));
+      store(frame + 8,  _mm_unpackhi_epi32(ab0, cd0));
+      store(frame + 16, _mm_unpacklo_epi32(ab1, cd1));
+      store(frame + 24, _mm_unpackhi_epi32(ab1, cd1));
+    }
+  }
+  else if (8u <= numChannels)
+  {
+    channelsDone = uint16_t(numChannels & ~7u);
+    for (; sample < blockSamples; sample += 8u)
+    {
+      for (uint16_t channel = 0u; channel < channelsDone; channel = uint16_t(channel + 8u))
+      {
+        transpose8x8(src + (channel * pitch) + sample, pitch, dst + (sample * numChannels) + channel, numChannels);
+      }
+    }
+  }
+  else
+  {
+    channelsDone = 0u;
+  }
+
+  return sample;
+}
+
+// returns the number of samples done per channel
+static inline uint32_t deinterleaveSse2(const int16_t *src, int16_t *dst, uint32_t pitch, uint16_t numChannels,
+                                 uint32_t numSamples, uint16_t &channelsDone)
+{
+  const uint32_t blockSamples = numSamples & ~7u;
+  uint32_t sample = 0u;
+  channelsDone = numChannels;
+
+  if (2u == numChannels)
+  {
+    for (; sample < blockSamples; sample += 8u)
+    {
+      const __m128i f0 = load(src + (sample * 2u));
+      const __m128i f1 = load(src + (sample * 2u) + 8u);
+      // sign extend the samples of the first channel, so the pack doesn't saturate
+      const __m128i a0 = _mm_srai_epi32(_mm_slli_epi32(f0, 16), 16);
+      const __m128i a1 = _mm_srai_epi32(_mm_slli_epi32(f1, 16), 16);
+      store(dst + sample, _mm_packs_epi32(a0, a1));
+      store(dst + pitch + sample, _mm_packs_epi32(_mm_srai_epi32(f0, 16), _mm_srai_epi32(f1, 16)));
+    }
+  }
+  else if (4u == numChannels)
+  {
+    for (; sample < blockSamples; sample += 8u)
+    {
+      const int16_t * const frame = src + (sample * 4u);
+      const __m128i t0 = _mm_unpacklo_epi16(load(frame), load(frame + 8));
+      const __m128i t1 = _mm_unpackhi_epi16(load(frame), load(frame + 8));
+      const __m128i t2 = _mm_unpacklo_epi16(load(frame + 16), load(frame + 24));
+      const __m128i t3 = _mm_unpackhi_epi16(load(frame + 16), load(frame + 24));
+      const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+      const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+      const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+      const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+      store(dst + sample,                _mm_unpacklo_epi64(u0, u2));
+      store(dst + pitch + sample,        _mm_unpackhi_epi64(u0, u2));
+      store(dst + (2u * pitch) + sample, _mm_unpacklo_epi64(u1, u3));
+      store(dst + (3u * pitch) + sample, _mm_unpackhi_epi64(u1, u3));
+    }
+  }
+  else if (8u <= numChannels)
+  {
+    channelsDone = uint16_t(numChannels & ~7u);
+    for (; sample < blockSamples; sample += 8u)
+    {
+      for (uint16_t channel = 0u; channel < channelsDone; channel = uint16_t(channel + 8u))
+      {
+        transpose8x8(src + (sample * numChannels) + channel, numChannels, dst + (channel * pitch) + sample, pitch);
+      }
+    }
+  }
+  else
+  {
+    channelsDone = 0u;
+  }
+
+  return sample;
+}
+
+// 32 bit local samples: no vector kernels, everything is done by the scalar loops
+template<typename T>
+static inline uint32_t interleaveSse2(const T *, uint32_t, T *, uint16_t, uint32_t, uint16_t &channelsDone)
+{
+  channelsDone = 0u;
+  return 0u;
+}
+
+template<typename T>
+static inline uint32_t deinterleaveSse2(const T *, T *, uint32_t, uint16_t, uint32_t, uint16_t &channelsDone)
+{
+  channelsDone = 0u;
+  return 0u;
+}
+#endif /* __SSE2__ */
+
+
+/*
+ * Frame kernels
+ *
+ * Interleaving and format conversion in one pass for a channel count known at compile time.
+ * Packets carry a few samples per channel only (e.g. six at 48 kHz, class A), too few for the
+ * block kernels above, so the scalar loop with the unrolled channel loop is the fastest option
+ * and saves the intermediate frame buffer.
+ */
+template<IasAvbAudioFormat F, uint16_t N>
+static void packFrames(const AudioData *src, uint32_t pitch, uint8_t *dst, uint32_t numSamples)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    for (uint16_t channel = 0u; channel < N; channel++)
+    {
+      Traits::pack(src[(channel * pitch) + sample], dst + (channel * Traits::cSampleSize));
+    }
+    dst += N * Traits::cSampleSize;
+  }
+}
+
+template<IasAvbAudioFormat F, uint16_t N>
+static void unpackFrames(const uint8_t *src, AudioData *dst, uint32_t pitch, uint32_t numSamples)
+{
+  typedef IasAvbAudioFormatTraits<F> Traits;
+
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    for (uint16_t channel = 0u; channel < N; channel++)
+    {
+      dst[(channel * pitch) + sample] = Traits::unpack(src + (channel * Traits::cSampleSize));
+    }
+    src += N * Traits::cSampleSize;
+  }
+}
+
+template<IasAvbAudioFormat F>
+static IasAvbAudioConversion::PackFramesFunction selectPackFrames(uint16_t numChannels)
+{
+  IasAvbAudioConversion::PackFramesFunction function = NULL;
+
+  switch (numChannels)
+  {
+  case 1u:
+    function = &packFrames<F, 1u>;
+    break;
+  case 2u:
+    function = &packFrames<F, 2u>;
+    break;
+  case 4u:
+    function = &packFrames<F, 4u>;
+    break;
+  case 6u:
+    function = &packFrames<F, 6u>;
+    break;
+  case 8u:
+    function = &packFrames<F, 8u>;
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+template<IasAvbAudioFormat F>
+static IasAvbAudioConversion::UnpackFramesFunction selectUnpackFrames(uint16_t numChannels)
+{
+  IasAvbAudioConversion::UnpackFramesFunction function = NULL;
+
+  switch (numChannels)
+  {
+  case 1u:
+    function = &unpackFrames<F, 1u>;
+    break;
+  case 2u:
+    function = &unpackFrames<F, 2u>;
+    break;
+  case 4u:
+    function = &unpackFrames<F, 4u>;
+    break;
+  case 6u:
+    function = &unpackFrames<F, 6u>;
+    break;
+  case 8u:
+    function = &unpackFrames<F, 8u>;
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+
+/*
+ * AM824 frame kernels
+ *
+ * A frame of two to eight 16 bit channels fits into one SSE2 register, so label insertion and
+ * stripping is done for all channels of a frame at once. The channels are gathered from/scattered
+ * to the planar buffers lane by lane, the quadlets of the frame are stored/loaded in one or two
+ * steps. Even channel counts only, so a frame always ends on a 64 bit boundary.
+ */
+#ifdef __SSE2__
+template<uint16_t I, uint16_t N>
+struct Am824Lanes
+{
+  static inline __m128i gather(const int16_t *src, uint32_t pitch, __m128i v)
+  {
+    return Am824Lanes<I + 1u, N>::gather(src, pitch, _mm_insert_epi16(v, src[I * pitch], I));
+  }
+
+  static inline void scatter(__m128i v, int16_t *dst, uint32_t pitch)
+  {
+    dst[I * pitch] = int16_t(_mm_extract_epi16(v, I));
+    Am824Lanes<I + 1u, N>::scatter(v, dst, pitch);
+  }
+};
+
+template<uint16_t N>
+struct Am824Lanes<N, N>
+{
+  static inline __m128i gather(const int16_t *, uint32_t, __m128i v)
+  {
+    return v;
+  }
+
+  static inline void scatter(__m128i, int16_t *, uint32_t)
+  {
+  }
+};
+
+template<uint16_t N>
+static void packFramesAm824Sse2(const int16_t *src, uint32_t pitch, uint8_t *dst, uint32_t numSamples)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i label = _mm_set1_epi32(IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatIec61883>::cLabel);
+
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    const __m128i v = swap16(Am824Lanes<0u, N>::gather(src + sample, pitch, zero));
+    const __m128i lo = _mm_or_si128(_mm_slli_epi32(_mm_unpacklo_epi16(v, zero), 8), label);
+    const __m128i hi = _mm_or_si128(_mm_slli_epi32(_mm_unpackhi_epi16(v, zero), 8), label);
+
+    if (2u == N)
+    {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), lo);
+    }
+    else
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), lo);
+      if (6u == N)
+      {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 16), hi);
+      }
+      else if (8u == N)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), hi);
+      }
+    }
+    dst += N * Sse2Am824Block::cSlotSize;
+  }
+}
+
+template<uint16_t N>
+static void unpackFramesAm824Sse2(const uint8_t *src, int16_t *dst, uint32_t pitch, uint32_t numSamples)
+{
+  for (uint32_t sample = 0u; sample < numSamples; sample++)
+  {
+    __m128i lo = _mm_setzero_si128();
+    __m128i hi = _mm_setzero_si128();
+
+    if (2u == N)
+    {
+      lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    }
+    else
+    {
+      lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      if (6u == N)
+      {
+        hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 16));
+      }
+      else if (8u == N)
+      {
+        hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+      }
+    }
+
+    const __m128i v = swap16(_mm_packs_epi32(Sse2Am824Block::strip(lo), Sse2Am824Block::strip(hi)));
+    Am824Lanes<0u, N>::scatter(v, dst + sample, pitch);
+    src += N * Sse2Am824Block::cSlotSize;
+  }
+}
+#endif /* __SSE2__ */
+
+// other local sample types and odd channel counts use the generic frame kernels (F is always IEC 61883)
+template<typename T, IasAvbAudioFormat F>
+struct Am824FrameSelect
+{
+  static IasAvbAudioConversion::PackFramesFunction pack(uint16_t numChannels)
+  {
+    return selectPackFrames<F>(numChannels);
+  }
+
+  static IasAvbAudioConversion::UnpackFramesFunction unpack(uint16_t numChannels)
+  {
+    return selectUnpackFrames<F>(numChannels);
+  }
+};
+
+#ifdef __SSE2__
+template<IasAvbAudioFormat F>
+struct Am824FrameSelect<int16_t, F>
+{
+  static IasAvbAudioConversion::PackFramesFunction pack(uint16_t numChannels)
+  {
+    IasAvbAudioConversion::PackFramesFunction function = NULL;
+
+    switch (numChannels)
+    {
+    case 2u:
+      function = &packFramesAm824Sse2<2u>;
+      break;
+    case 4u:
+      function = &packFramesAm824Sse2<4u>;
+      break;
+    case 6u:
+      function = &packFramesAm824Sse2<6u>;
+      break;
+    case 8u:
+      function = &packFramesAm824Sse2<8u>;
+      break;
+    default:
+      function = selectPackFrames<F>(numChannels);
+      break;
+    }
+
+    return function;
+  }
+
+  static IasAvbAudioConversion::UnpackFramesFunction unpack(uint16_t numChannels)
+  {
+    IasAvbAudioConversion::UnpackFramesFunction function = NULL;
+
+    switch (numChannels)
+    {
+    case 2u:
+      function = &unpackFramesAm824Sse2<2u>;
+      break;
+    case 4u:
+      function = &unpackFramesAm824Sse2<4u>;
+      break;
+    case 6u:
+      function = &unpackFramesAm824Sse2<6u>;
+      break;
+    case 8u:
+      function = &unpackFramesAm824Sse2<8u>;
+      break;
+    default:
+      function = selectUnpackFrames<F>(numChannels);
+      break;
+    }
+
+    return function;
+  }
+};
+#endif /* __SSE2__ */
+
+
+/*
+ * Kernel selection. The vectorized kernels are written for 16 bit local samples, other local
+ * sample types use the scalar kernels.
+ */
+template<typename T, IasAvbAudioFormat F>
+struct KernelSelect
+{
+  static IasAvbAudioConversion::PackFunction pack(IasAvbAudioConversion::Isa)
+  {
+    return &packScalar<F>;
+  }
+
+  static IasAvbAudioConversion::UnpackFunction unpack(IasAvbAudioConversion::Isa)
+  {
+    return &unpackScalar<F>;
+  }
+};
+
+template<IasAvbAudioFormat F>
+struct KernelSelect<int16_t, F>
+{
+  static IasAvbAudioConversion::PackFunction pack(IasAvbAudioConversion::Isa isa)
+  {
+    IasAvbAudioConversion::PackFunction function = &packScalar<F>;
+    (void) isa;
+
+#ifdef __SSE2__
+    if (IasAvbAudioConversion::eIsaSse2 <= isa)
+    {
+      function = &packSse2<F>;
+    }
+#endif
+#ifdef IAS_AVB_CONVERSION_AVX2
+    if (IasAvbAudioConversion::eIsaAvx2 <= isa)
+    {
+      function = &packAvx2<F>;
+    }
+#endif
+
+    return function;
+  }
+
+  static IasAvbAudioConversion::UnpackFunction unpack(IasAvbAudioConversion::Isa isa)
+  {
+    IasAvbAudioConversion::UnpackFunction function = &unpackScalar<F>;
+    (void) isa;
+
+#ifdef __SSE2__
+    if (IasAvbAudioConversion::eIsaSse2 <= isa)
+    {
+      function = &unpackSse2<F>;
+    }
+#endif
+#ifdef IAS_AVB_CONVERSION_AVX2
+    if (IasAvbAudioConversion::eIsaAvx2 <= isa)
+    {
+      function = &unpackAvx2<F>;
+    }
+#endif
+
+    return function;
+  }
+};
+
+template<IasAvbAudioFormat F>
+static IasAvbAudioConversion::PackFunction selectPack(IasAvbAudioConversion::Isa isa)
+{
+  return KernelSelect<AudioData, F>::pack(isa);
+}
+
+template<IasAvbAudioFormat F>
+static IasAvbAudioConversion::UnpackFunction selectUnpack(IasAvbAudioConversion::Isa isa)
+{
+  return KernelSelect<AudioData, F>::unpack(isa);
+}
+
+
+/*
+ * Gain
+ *
+ * Integer samples are multiplied by the gain in fixed point, rounded and saturated; mixing
+ * saturates the sum once more. The SSE2 kernel for 16 bit samples computes the 32 bit products
+ * with mullo/mulhi, so it matches the scalar version bit by bit.
+ */
+constexpr float IasAvbAudioConversion::cMaxGain;
+
+static inline int32_t toFixedGain(float gain)
+{
+  const float limited = std::min(std::max(gain, -IasAvbAudioConversion::cMaxGain), IasAvbAudioConversion::cMaxGain);
+  const int32_t fixed = int32_t(lrintf(limited * float(1 << IasAvbAudioConversion::cGainFracBits)));
+  return std::min(std::max(fixed, int32_t(INT16_MIN)), int32_t(INT16_MAX));
+}
+
+template<typename T>
+struct GainTraits;
+
+template<>
+struct GainTraits<int16_t>
+{
+  typedef int32_t Gain;
+
+  static inline Gain toGain(float gain)
+  {
+    return toFixedGain(gain);
+  }
+
+  static inline int16_t saturate(int32_t value)
+  {
+    return int16_t(std::min(std::max(value, int32_t(INT16_MIN)), int32_t(INT16_MAX)));
+  }
+
+  static inline int16_t apply(int16_t sample, Gain gain)
+  {
+    return saturate(((int32_t(sample) * gain) + (1 << (IasAvbAudioConversion::cGainFracBits - 1)))
+                    >> IasAvbAudioConversion::cGainFracBits);
+  }
+
+  static inline int16_t add(int16_t a, int16_t b)
+  {
+    return saturate(int32_t(a) + int32_t(b));
+  }
+};
+
+template<>
+struct GainTraits<int32_t>
+{
+  typedef int32_t Gain;
+
+  static inline Gain toGain(float gain)
+  {
+    return toFixedGain(gain);
+  }
+
+  static inline int32_t saturate(int64_t value)
+  {
+    return int32_t(std::min(std::max(value, int64_t(INT32_MIN)), int64_t(INT32_MAX)));
+  }
+
+  static inline int32_t apply(int32_t sample, Gain gain)
+  {
+    return saturate(((int64_t(sample) * gain) + (1 << (IasAvbAudioConversion::cGainFracBits - 1)))
+                    >> IasAvbAudioConversion::cGainFracBits);
+  }
+
+  static inline int32_t add(int32_t a, int32_t b)
+  {
+    return saturate(int64_t(a) + int64_t(b));
+  }
+};
+
+template<>
+struct GainTraits<float>
+{
+  typedef float Gain;
+
+  static inline Gain toGain(float gain)
+  {
+    return gain;
+  }
+
+  static inline float apply(float sample, Gain gain)
+  {
+    return sample * gain;
+  }
+
+  static inline float add(float a, float b)
+  {
+    return a + b;
+  }
+};
+
+template<typename T>
+static void scaleScalar(const T *src, T *dst, typename GainTraits<T>::Gain gain, uint32_t first, uint32_t numSamples)
+{
+  for (uint32_t sample = first; sample < numSamples; sample++)
+  {
+    dst[sample] = GainTraits<T>::apply(src[sample], gain);
+  }
+}
+
+template<typename T>
+static void mixScalar(const T *src, T *dst, typename GainTraits<T>::Gain gain, uint32_t first, uint32_t numSamples)
+{
+  for (uint32_t sample = first; sample < numSamples; sample++)
+  {
+    dst[sample] = GainTraits<T>::add(dst[sample], GainTraits<T>::apply(src[sample], gain));
+  }
+}
+
+#ifdef __SSE2__
+static inline __m128i applySse2(__m128i samples, __m128i gain)
+{
+  const __m128i round = _mm_set1_epi32(1 << (IasAvbAudioConversion::cGainFracBits - 1));
+  const __m128i lo = _mm_mullo_epi16(samples, gain);
+  const __m128i hi = _mm_mulhi_epi16(samples, gain);
+  const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), IasAvbAudioConversion::cGainFracBits);
+  const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), IasAvbAudioConversion::cGainFracBits);
+  return _mm_packs_epi32(p0, p1);
+}
+
+static inline uint32_t scaleSse2(const int16_t *src, int16_t *dst, int32_t gain, uint32_t numSamples)
+{
+  const __m128i g = _mm_set1_epi16(int16_t(gain));
+  uint32_t sample = 0u;
+  for (; (sample + 8u) <= numSamples; sample += 8u)
+  {
+    store(dst + sample, applySse2(load(src + sample), g));
+  }
+  return sample;
+}
+
+static inline uint32_t mixSse2(const int16_t *src, int16_t *dst, int32_t gain, uint32_t numSamples)
+{
+  const __m128i g = _mm_set1_epi16(int16_t(gain));
+  uint32_t sample = 0u;
+  for (; (sample + 8u) <= numSamples; sample += 8u)
+  {
+    store(dst + sample, _mm_adds_epi16(load(dst + sample), applySse2(load(src + sample), g)));
+  }
+  return sample;
+}
+
+// other local sample types: no vector kernels
+template<typename T, typename G>
+static inline uint32_t scaleSse2(const T *, T *, G, uint32_t)
+{
+  return 0u;
+}
+
+template<typename T, typename G>
+static inline uint32_t mixSse2(const T *, T *, G, uint32_t)
+{
+  return 0u;
+}
+#endif /* __SSE2__ */
+
+
+static IasAvbAudioConversion::Isa detectIsa()
+{
+  IasAvbAudioConversion::Isa isa = IasAvbAudioConversion::eIsaScalar;
+
+#ifdef __SSE2__
+  isa = IasAvbAudioConversion::eIsaSse2;
+#endif
+#ifdef IAS_AVB_CONVERSION_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+  {
+    isa = IasAvbAudioConversion::eIsaAvx2;
+  }
+#endif
+
+  return isa;
+}
+
+
+IasAvbAudioConversion::Isa IasAvbAudioConversion::getIsa()
+{
+  static const Isa isa = detectIsa();
+  return isa;
+}
+
+
+const char * IasAvbAudioConversion::getIsaName(Isa isa)
+{
+  const char * name = "scalar";
+
+  switch (isa)
+  {
+  case eIsaSse2:
+    name = "sse2";
+    break;
+  case eIsaAvx2:
+    name = "avx2";
+    break;
+  case eIsaScalar:
+  default:
+    break;
+  }
+
+  return name;
+}
+
+
+IasAvbAudioConversion::PackFunction IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat format, Isa isa)
+{
+  PackFunction function = NULL;
+
+  if (isa > getIsa())
+  {
+    isa = getIsa();
+  }
+
+  switch (format)
+  {
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf16:
+    function = selectPack<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf24:
+    function = selectPack<IasAvbAudioFormat::eIasAvbAudioFormatSaf24>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf32:
+    function = selectPack<IasAvbAudioFormat::eIasAvbAudioFormatSaf32>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSafFloat:
+    function = selectPack<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatIec61883:
+    function = selectPack<IasAvbAudioFormat::eIasAvbAudioFormatIec61883>(isa);
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+
+IasAvbAudioConversion::UnpackFunction IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat format, Isa isa)
+{
+  UnpackFunction function = NULL;
+
+  if (isa > getIsa())
+  {
+    isa = getIsa();
+  }
+
+  switch (format)
+  {
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf16:
+    function = selectUnpack<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf24:
+    function = selectUnpack<IasAvbAudioFormat::eIasAvbAudioFormatSaf24>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf32:
+    function = selectUnpack<IasAvbAudioFormat::eIasAvbAudioFormatSaf32>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSafFloat:
+    function = selectUnpack<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat>(isa);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatIec61883:
+    function = selectUnpack<IasAvbAudioFormat::eIasAvbAudioFormatIec61883>(isa);
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+
+IasAvbAudioConversion::PackFramesFunction IasAvbAudioConversion::getPackFramesFunction(IasAvbAudioFormat format,
+                                                                                       uint16_t numChannels)
+{
+  PackFramesFunction function = NULL;
+
+  switch (format)
+  {
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf16:
+    function = selectPackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf24:
+    function = selectPackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf24>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf32:
+    function = selectPackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf32>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSafFloat:
+    function = selectPackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatIec61883:
+    function = Am824FrameSelect<AudioData, IasAvbAudioFormat::eIasAvbAudioFormatIec61883>::pack(numChannels);
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+
+IasAvbAudioConversion::UnpackFramesFunction IasAvbAudioConversion::getUnpackFramesFunction(IasAvbAudioFormat format,
+                                                                                           uint16_t numChannels)
+{
+  UnpackFramesFunction function = NULL;
+
+  switch (format)
+  {
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf16:
+    function = selectUnpackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf24:
+    function = selectUnpackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf24>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSaf32:
+    function = selectUnpackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSaf32>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatSafFloat:
+    function = selectUnpackFrames<IasAvbAudioFormat::eIasAvbAudioFormatSafFloat>(numChannels);
+    break;
+  case IasAvbAudioFormat::eIasAvbAudioFormatIec61883:
+    function = Am824FrameSelect<AudioData, IasAvbAudioFormat::eIasAvbAudioFormatIec61883>::unpack(numChannels);
+    break;
+  default:
+    break;
+  }
+
+  return function;
+}
+
+
+void IasAvbAudioConversion::interleave(const AudioData *src, uint32_t pitch, AudioData *dst, uint16_t numChannels,
+                                       uint32_t numSamples)
+{
+  uint32_t sample = 0u;
+  uint16_t channelsDone = 0u;
+
+#ifdef __SSE2__
+  sample = interleaveSse2(src, pitch, dst, numChannels, numSamples, channelsDone);
+#endif
+
+  // channels left over by the blocks, then the remaining samples of all channels
+  interleaveScalar(src, pitch, dst, numChannels, channelsDone, 0u, sample);
+  interleaveScalar(src, pitch, dst, numChannels, 0u, sample, numSamples);
+}
+
+
+void IasAvbAudioConversion::deinterleave(const AudioData *src, AudioData *dst, uint32_t pitch, uint16_t numChannels,
+                                         uint32_t numSamples)
+{
+  uint32_t sample = 0u;
+  uint16_t channelsDone = 0u;
+
+#ifdef __SSE2__
+  sample = deinterleaveSse2(src, dst, pitch, numChannels, numSamples, channelsDone);
+#endif
+
+  deinterleaveScalar(src, dst, pitch, numChannels, channelsDone, 0u, sample);
+  deinterleaveScalar(src, dst, pitch, numChannels, 0u, sample, numSamples);
+}
+
+
+void IasAvbAudioConversion::scale(const AudioData *src, AudioData *dst, float gain, uint32_t numSamples)
+{
+  const GainTraits<AudioData>::Gain g = GainTraits<AudioData>::toGain(gain);
+  uint32_t sample = 0u;
+
+#ifdef __SSE2__
+  sample = scaleSse2(src, dst, g, numSamples);
+#endif
+
+  scaleScalar(src, dst, g, sample, numSamples);
+}
+
+
+void IasAvbAudioConversion::mix(const AudioData *src, AudioData *dst, float gain, uint32_t numSamples)
+{
+  const GainTraits<AudioData>::Gain g = GainTraits<AudioData>::toGain(gain);
+  uint32_t sample = 0u;
+
+#ifdef __SSE2__
+  sample = mixSse2(src, dst, g, numSamples);
+#endif
+
+  mixScalar(src, dst, g, sample, numSamples);
+}
+
+} // namespace IasMediaTransportAvb
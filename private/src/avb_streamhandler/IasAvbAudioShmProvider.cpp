@@ -12,6 +12,7 @@
  */
 
 #include <pthread.h>
+#include <cstring>
 #include "avb_streamhandler/IasAvbAudioShmProvider.hpp"
 #include "internal/audio/common/audiobuffer/IasAudioRingBuffer.hpp"
 #include "internal/audio/common/alsa_smartx_plugin/IasAlsaPluginIpc.hpp"
@@ -47,6 +48,7 @@ IasAvbAudioShmProvider::IasAvbAudioShmProvider(const std::string & deviceName)
   ,mIsClientSmartX(true)
   ,mLastPtpEpoch(0u)
   ,mDbgLastTxBufOverrunIdx(0u)
+  ,mPlayoutTolerance(0u)
 {
 }
 
@@ -86,7 +88,7 @@ IasAvbProcessingResult IasAvbAudioShmProvider::init(uint16_t numChannels, uint32
     mParams->name        = mDeviceName;    // name of the AVB Alsa device. This is the ALSA PCM device name
     mParams->numChannels = numChannels;    // number of channels
     mParams->samplerate  = sampleRate;     // sample rate in Hz, e.g. 48000
-    mParams->dataFormat  = IasAudio::eIasFormatInt16;
+    mParams->dataFormat  = getDataFormat();  // sample type of the local audio buffers
     mParams->clockType   = IasAudio::eIasClockProvided;
     mParams->periodSize  = alsaPeriodSize; // period size in frames
     mParams->numPeriods  = numAlsaPeriods; // number of periods that the ring buffer consists of
@@ -238,6 +240,14 @@ IasAvbProcessingResult IasAvbAudioShmProvider::init(uint16_t numChannels, uint32
       }
     }
 
+    if (AudioBufferDescMode::eIasAudioBufferDescModePresentation == mDescMode)
+    {
+      uint32_t tolerance = 100000u; // ns
+      (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cAudioPlayoutTolerance, tolerance);
+      mPlayoutTolerance = uint32_t(uint64_t(tolerance) * sampleRate / 1000000000u);
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "presentation mode, playout tolerance =", mPlayoutTolerance, "samples");
+    }
+
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cAlsaSmartXSwitch, mIsClientSmartX);
   }
 
@@ -500,6 +510,7 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
 
         bool   alsaRxSyncStart = false;
         uint64_t skippedTime = 0u;
+        uint32_t playoutLead = 0u; // silence preceding the samples in presentation mode
 
         if (true == useDesc)
         {
@@ -537,6 +548,12 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
 
           if (IasAudio::eIasRingBufferAccessWrite == accessDirection) // receive stream
           {
+            // a reset requested by another thread moves the read indices, take it over before they are looked at
+            for (uint32_t channel = 0; channel < numChannels; channel++)
+            {
+              buffers[channel]->applyReaderReset();
+            }
+
             /*
              * wait until buffer fill level reaches at least half-full in time-aware buffering mode
              */
@@ -552,8 +569,10 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
                 readIndex  = buffers[0]->getMonotonicReadIndex();
                 writeIndex = buffers[0]->getMonotonicWriteIndex();
                 uint32_t readIndexPerSampleRate = uint32_t(readIndex % mParams->samplerate);
+                // the indices keep counting across a reset, the initial reading starts where the last one left them
+                const uint64_t resetIndex = buffers[0]->getMonotonicResetIndex();
 
-                if (alsaRxSyncStart && (0u != readIndex) && (0u != desc.bufIndex)) // not initial reading
+                if (alsaRxSyncStart && (resetIndex != readIndex) && (resetIndex != desc.bufIndex)) // not initial reading
                 {
                   // adjust timestamp
                   int64_t skippedSamples = readIndex - desc.bufIndex;
@@ -592,20 +611,68 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
 
                 // detect a far-away timestamp
                 uint64_t timeGap = (now > desc.timeStamp) ? (now - desc.timeStamp) : (desc.timeStamp - now);
-                if ((maxPtGap < timeGap) && (IasLocalAudioBufferDesc::eIasAudioBufferDescModeHard == mDescMode))
+                if ((maxPtGap < timeGap) && ((IasLocalAudioBufferDesc::eIasAudioBufferDescModeHard == mDescMode) ||
+                                             (IasLocalAudioBufferDesc::eIasAudioBufferDescModePresentation == mDescMode)))
                 {
                   DLT_LOG(*mLog, DLT_LOG_WARN, DLT_STRING("[IasAvbAudioShmProvider::copyJob]"),
                       DLT_STRING("detected out-of-bound presentation timestamp"), DLT_STRING("timestamp="),
                       DLT_UINT64(desc.timeStamp), DLT_STRING("now="), DLT_UINT64(now));
                   resetRequested = true;
                 }
+                else if (IasLocalAudioBufferDesc::eIasAudioBufferDescModePresentation == mDescMode)
+                {
+                  /*
+                   * The first frame of this period is played at 'now'. Samples ahead of their presentation
+                   * time are preceded by silence, samples behind it are dropped. Deviations within the
+                   * tolerance are left alone, they are mostly jitter of the worker's wake-up time.
+                   */
+                  toBePresented = true;
+
+                  int64_t offset = 0;
+                  const uint64_t nextIndex = std::max(readIndex, desc.bufIndex);
+                  if (eIasAvbProcOK == descQ->getPlayoutOffset(nextIndex, now, mParams->samplerate, offset))
+                  {
+                    if (int64_t(mPlayoutTolerance) < offset)
+                    {
+                      playoutLead = uint32_t(std::min(offset, int64_t(numFrames)));
+                    }
+                    else if (int64_t(mPlayoutTolerance) < -offset)
+                    {
+                      const uint32_t samplesToSkip = uint32_t(std::min(-offset, int64_t(buffers[0]->getFillLevel())));
+                      for (uint32_t channel = 0; channel < numChannels; channel++)
+                      {
+                        IasLocalAudioBuffer *buffer = buffers[channel];
+                        AVB_ASSERT(nullptr != buffer);
+                        uint32_t remaining = samplesToSkip;
+                        while (0u != remaining)
+                        {
+                          // mNullData has only buffer of mParams->periodSize
+                          const uint32_t samplesRead = buffer->read(mNullData, std::min(remaining, mParams->periodSize));
+                          if (0u == samplesRead)
+                          {
+                            break;
+                          }
+                          remaining -= samplesRead;
+                        }
+                      }
+                      // mNullData also serves as silence
+                      (void) std::memset(mNullData, 0, mParams->periodSize * sizeof(AudioData));
+                    }
+
+                    if (0 != offset)
+                    {
+                      DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX, "playout offset =", offset, "samples",
+                                  "lead =", playoutLead);
+                    }
+                  }
+                }
                 else
                 {
                   if (desc.timeStamp <= now)
                   {
                     toBePresented = true; // to be presented now
 
-                    if (alsaRxSyncStart && (0u == readIndex) && (0u == desc.bufIndex)) // initial reading
+                    if (alsaRxSyncStart && (resetIndex == readIndex) && (resetIndex == desc.bufIndex)) // initial reading
                     {
                       IasLocalAudioBuffer *buffer = buffers[0];
                       if (nullptr != buffer)
@@ -858,6 +925,11 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
                       nrSamples = buffer->getFillLevel();
                     }
                     nrSamples = std::min(numFrames, nrSamples);
+                    if (IasLocalAudioBufferDesc::eIasAudioBufferDescModePresentation == mDescMode)
+                    {
+                      // the samples run back to back after the lead
+                      nrSamples = numFrames - playoutLead;
+                    }
 
                     // to be presented now
                     buffer->read(mNullData, nrSamples);
@@ -1025,7 +1097,19 @@ IasAvbProcessingResult IasAvbAudioShmProvider::copyJob(const IasLocalAudioStream
                       }
                       nrSamples = std::min(shmFrames, nrSamples);
 
-                      buffer->read(reinterpret_cast<AudioData*>(shmData), nrSamples, step);
+                      if (IasLocalAudioBufferDesc::eIasAudioBufferDescModePresentation == mDescMode)
+                      {
+                        // the samples run back to back after the lead, a shortage is filled with silence
+                        const uint32_t lead = std::min(playoutLead, shmFrames);
+                        char * const playoutData = shmData + lead * step;
+                        fillSilence(shmData, lead, step);
+                        nrSamples = buffer->read(reinterpret_cast<AudioData*>(playoutData), shmFrames - lead, step);
+                        fillSilence(playoutData + nrSamples * step, shmFrames - lead - nrSamples, step);
+                      }
+                      else
+                      {
+                        buffer->read(reinterpret_cast<AudioData*>(shmData), nrSamples, step);
+                      }
 
 #if defined(PERFORMANCE_MEASUREMENT)
                       if (IasAvbStreamHandlerEnvironment::isAudioFlowLogEnabled()) // latency analysis
@@ -1232,6 +1316,23 @@ void IasAvbAudioShmProvider::abortTransmission()
 }
 
 
+void IasAvbAudioShmProvider::fillSilence(char *shmData, uint32_t frames, uint32_t step)
+{
+  if (sizeof(AudioData) == step) // not interleaved
+  {
+    (void) std::memset(shmData, 0, frames * sizeof(AudioData));
+  }
+  else // interleaved
+  {
+    for (uint32_t frame = 0u; frame < frames; frame++)
+    {
+      *reinterpret_cast<AudioData*>(shmData) = 0;
+      shmData += step;
+    }
+  }
+}
+
+
 void IasAvbAudioShmProvider::setHwConstraints()
 {
   // Set the hardware device parameters.
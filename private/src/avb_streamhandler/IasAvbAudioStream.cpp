@@ -18,7 +18,9 @@
 #include "avb_helper/ias_safe.h"
 
 #include <arpa/inet.h>
+#include <algorithm>
 #include <cstdlib>
+#include <cmath>
 #include <math.h>
 #include <iomanip>
 // TO BE REPLACED #include "core_libraries/btm/ias_dlt_btm.h"
@@ -56,6 +58,27 @@ uint32_t IasAvbAudioStream::sampleRateTable[] =
   24000u
 };
 
+/*
+ * IEC 61883-6 sample frequency codes (SFC) are the index into this table,
+ * along with the number of data blocks between two time stamped ones (SYT_INTERVAL).
+ */
+static const struct
+{
+  uint32_t sampleFrequency;
+  uint16_t sytInterval;
+} cIec61883SampleRateTable[] =
+{
+  {  32000u,  8u },
+  {  44100u,  8u },
+  {  48000u,  8u },
+  {  88200u, 16u },
+  {  96000u, 16u },
+  { 176400u, 32u },
+  { 192000u, 32u }
+};
+
+static const uint8_t cIec61883SfcInvalid = 0xFFu;
+
 uint8_t IasAvbAudioStream::getSampleFrequencyCode(const uint32_t sampleFrequency)
 {
   uint8_t code = 0u;
@@ -98,6 +121,22 @@ uint8_t IasAvbAudioStream::getSampleFrequencyCode(const uint32_t sampleFrequency
   return code;
 }
 
+uint8_t IasAvbAudioStream::getIec61883SampleFrequencyCode(const uint32_t sampleFrequency)
+{
+  uint8_t code = cIec61883SfcInvalid;
+
+  for (uint8_t i = 0u; i < (sizeof(cIec61883SampleRateTable)/sizeof(cIec61883SampleRateTable[0])); i++)
+  {
+    if (sampleFrequency == cIec61883SampleRateTable[i].sampleFrequency)
+    {
+      code = i;
+      break;
+    }
+  }
+
+  return code;
+}
+
 /*
  *  Constructor.
  */
@@ -108,6 +147,7 @@ IasAvbAudioStream::IasAvbAudioStream()
   , mAudioFormatCode(0u)
   , mMaxNumChannels(0u)
   , mLocalStream(NULL)
+  , mLocalReader(0u)
   , mSampleFrequency(0u)
   , mSampleFrequencyCode(0u)
   , mRefPlaneSampleCount(0u)
@@ -125,9 +165,21 @@ IasAvbAudioStream::IasAvbAudioStream()
   , mStride(0u)
   , mSeqNum(0u)
   , mTempBuffer(NULL)
+  , mFrameBuffer(NULL)
   , mConversionGain(AudioData(0x7FFF))
   , mUseSaturation(true)
-  , mSampleIntervalNs(0.0)
+  , mPackSamples(NULL)
+  , mUnpackSamples(NULL)
+  , mPackFrames(NULL)
+  , mUnpackFrames(NULL)
+  , mFramesChannels(0u)
+  , mRoutes()
+  , mRoutedChannels(0u)
+  , mRouteBuffer(NULL)
+  , mSampleInterval(0u)
+  , mDbc(0u)
+  , mSytInterval(0u)
+  , mDbcDiscontinuities(0u)
   , mWaitForData(false)
   , mRatioBendRate(0.0)
   , mRatioBendLimit(0)
@@ -178,9 +230,23 @@ void IasAvbAudioStream::derivedCleanup()
   mAudioFormat = IasAvbAudioFormat::eIasAvbAudioFormatSaf16;
   mAudioFormatCode = getFormatCode(mAudioFormat);
   mCompatibilityModeAudio = eIasAvbCompLatest;
+  mPackSamples = NULL;
+  mUnpackSamples = NULL;
+  mPackFrames = NULL;
+  mUnpackFrames = NULL;
+  mFramesChannels = 0u;
+  mDbc = 0u;
+  mSytInterval = 0u;
+  mDbcDiscontinuities = 0u;
 
   delete[] mTempBuffer;
   mTempBuffer = NULL;
+  delete[] mFrameBuffer;
+  mFrameBuffer = NULL;
+  delete[] mRouteBuffer;
+  mRouteBuffer = NULL;
+  mRoutes.clear();
+  mRoutedChannels = 0u;
 
   delete[] mFillLevelFifo;
   mFillLevelFifo = NULL;
@@ -237,11 +303,17 @@ IasAvbProcessingResult IasAvbAudioStream::initTransmit(IasAvbSrClass srClass, ui
     if (eIasAvbProcOK == result)
     {
       if ( !(48000u == sampleFreq || 24000 == sampleFreq) ||
-            (IasAvbAudioFormat::eIasAvbAudioFormatSaf16 != format)
+            (NULL == IasAvbAudioConversion::getPackFunction(format))
          )
       {
           result = eIasAvbProcUnsupportedFormat;
       }
+      else if ((IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == format) &&
+               ((cIec61883SfcInvalid == getIec61883SampleFrequencyCode(sampleFreq)) || (maxNumberChannels > 0xFFu)))
+      {
+        // no SFC for the frequency, or more channels than the 8 bit DBS field can describe
+        result = eIasAvbProcUnsupportedFormat;
+      }
     }
 
     if (eIasAvbProcOK == result)
@@ -273,16 +345,18 @@ IasAvbProcessingResult IasAvbAudioStream::initTransmit(IasAvbSrClass srClass, ui
 
       if (eIasAvbProcOK == result)
       {
-        mTempBuffer = new (nothrow) AudioData[mSamplesPerChannelPerPacket];
+        const uint32_t bufferSize = uint32_t(maxNumberChannels) * mSamplesPerChannelPerPacket;
+        mTempBuffer = new (nothrow) AudioData[bufferSize];
+        mFrameBuffer = new (nothrow) AudioData[bufferSize];
 
-        if (NULL == mTempBuffer)
+        if ((NULL == mTempBuffer) || (NULL == mFrameBuffer))
         {
           /**
-           * @log Not enough memory to allocate AudioData[mSamplesPerChannelPerPacket]
+           * @log Not enough memory to allocate the sample buffers of maxNumberChannels * mSamplesPerChannelPerPacket samples
            */
           DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX,
-                  "Not enough memory to allocate AudioData[mSamplesPerChannelPerPacket]! mSamplesPerChannelPerPacket=",
-                  mSamplesPerChannelPerPacket);
+                  "Not enough memory to allocate AudioData[maxNumberChannels * mSamplesPerChannelPerPacket]! mSamplesPerChannelPerPacket=",
+                  mSamplesPerChannelPerPacket, "maxNumberChannels=", maxNumberChannels);
           result = eIasAvbProcNotEnoughMemory;
         }
       }
@@ -343,15 +417,26 @@ IasAvbProcessingResult IasAvbAudioStream::initTransmit(IasAvbSrClass srClass, ui
       mSampleFrequency = sampleFreq;
       mSampleFrequencyCode = getSampleFrequencyCode(sampleFreq);
       mAudioFormat = format;
+      if (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == format)
+      {
+        mSampleFrequencyCode = getIec61883SampleFrequencyCode(sampleFreq);
+        mSytInterval = cIec61883SampleRateTable[mSampleFrequencyCode].sytInterval;
+        mDbc = 0u;
+      }
       mAudioFormatCode = getFormatCode(mAudioFormat);
-      mSampleIntervalNs = 1.0e9 / double(sampleFreq);
+      mPackSamples = IasAvbAudioConversion::getPackFunction(mAudioFormat);
+      selectFrameKernels(maxNumberChannels);
+      mSampleInterval = IasAvbSampleTime::fromFrequency(sampleFreq);
+
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "sample conversion:",
+                  IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::getIsa()));
 
       const uint32_t ptOffsetOrig = getPresentationTimeOffset();
-      const uint32_t steps = adjustPresentationTimeOffset((uint32_t)mSampleIntervalNs);
+      const uint32_t steps = adjustPresentationTimeOffset(uint32_t(IasAvbSampleTime::toNs(mSampleInterval, 1u)));
 
       DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "adjusted presentation time offset:",
                   "new =", getPresentationTimeOffset(), "orig =", ptOffsetOrig,
-                  "stepWidth =", uint32_t(mSampleIntervalNs), "steps =", steps);
+                  "stepWidth =", uint32_t(IasAvbSampleTime::toNs(mSampleInterval, 1u)), "steps =", steps);
 
       result = prepareAllPackets();
 
@@ -405,11 +490,16 @@ IasAvbProcessingResult IasAvbAudioStream::initReceive(IasAvbSrClass srClass, uin
     if (eIasAvbProcOK == result)
     {
       if ( !(48000u == sampleFreq || 24000 == sampleFreq) ||
-            (IasAvbAudioFormat::eIasAvbAudioFormatSaf16 != format)
+            (NULL == IasAvbAudioConversion::getUnpackFunction(format))
          )
       {
         result = eIasAvbProcUnsupportedFormat;
       }
+      else if ((IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == format) &&
+               ((cIec61883SfcInvalid == getIec61883SampleFrequencyCode(sampleFreq)) || (maxNumberChannels > 0xFFu)))
+      {
+        result = eIasAvbProcUnsupportedFormat;
+      }
     }
 
     const uint32_t packetsPerSec = IasAvbTSpec::getPacketsPerSecondByClass(srClass);
@@ -432,9 +522,11 @@ IasAvbProcessingResult IasAvbAudioStream::initReceive(IasAvbSrClass srClass, uin
         mExcessSamples = 1u;
         (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxExcessPayload, mExcessSamples);
 
-        mTempBuffer = new (nothrow) AudioData[mSamplesPerChannelPerPacket + mExcessSamples];
+        const uint32_t bufferSize = uint32_t(maxNumberChannels) * (mSamplesPerChannelPerPacket + mExcessSamples);
+        mTempBuffer = new (nothrow) AudioData[bufferSize];
+        mFrameBuffer = new (nothrow) AudioData[bufferSize];
 
-        if (NULL == mTempBuffer)
+        if ((NULL == mTempBuffer) || (NULL == mFrameBuffer))
         {
           result = eIasAvbProcNotEnoughMemory;
         }
@@ -448,8 +540,16 @@ IasAvbProcessingResult IasAvbAudioStream::initReceive(IasAvbSrClass srClass, uin
       mSampleFrequency = sampleFreq;
       mSampleFrequencyCode = getSampleFrequencyCode(sampleFreq);
       mAudioFormat = format;
+      if (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == format)
+      {
+        mSampleFrequencyCode = getIec61883SampleFrequencyCode(sampleFreq);
+        mSytInterval = cIec61883SampleRateTable[mSampleFrequencyCode].sytInterval;
+        mDbc = 0u;
+      }
       mAudioFormatCode = getFormatCode(mAudioFormat);
-      mSampleIntervalNs = 1.0e9 / double(sampleFreq);
+      mUnpackSamples = IasAvbAudioConversion::getUnpackFunction(mAudioFormat);
+      selectFrameKernels(maxNumberChannels);
+      mSampleInterval = IasAvbSampleTime::fromFrequency(sampleFreq);
       (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxValidationMode, mValidationMode);
       mValidationThreshold = 100u;
       (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxValidationThreshold, mValidationThreshold);
@@ -548,47 +648,73 @@ IasAvbProcessingResult IasAvbAudioStream::prepareAllPackets()
 
     packetData += 4;        // time stamp, filled in per packet
 
-    *(packetData++) = mAudioFormatCode;
-
-    if (eIasAvbCompLatest == mCompatibilityModeAudio)
+    if (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == mAudioFormat)
     {
-      packetData++;           // nsr + rsv + part of ch per frame, filled in per packet
-      // ToDo: Check if reserved is set to 0 if not, set here
-      packetData++;           // rest of ch per frame, filled in per packet
+      // gateway_info, not used
+      *(packetData++) = 0x00u;
+      *(packetData++) = 0x00u;
+      *(packetData++) = 0x00u;
+      *(packetData++) = 0x00u;
+
+      packetData += 2; // skip stream_data_length
+
+      *(packetData++) = 0x5Fu; // tag = 01 (CIP header present), channel = 31 (native AVB)
+      *(packetData++) = 0xA0u; // tcode = 0xA, sy = 0
+
+      // CIP header
+      *(packetData++) = 0x3Fu; // SID = 63, no IEEE 1394 node
+      packetData++;            // DBS, filled in per packet
+      *(packetData++) = 0x00u; // FN = 0, QPC = 0, SPH = 0
+      packetData++;            // DBC, filled in per packet
+      *(packetData++) = 0x90u; // FMT = 0x10, audio and music
+      *(packetData++) = mSampleFrequencyCode; // FDF: EVT = 0 (AM824), SFC
+      *(packetData++) = 0xFFu; // SYT, not used by AVTP, the time stamp is carried in the AVTP header
+      *(packetData++) = 0xFFu;
     }
     else
     {
-      packetData++;           // channel layout, filled in per packet
-      *(packetData++) = mSampleFrequencyCode;
-    }
-    *(packetData++) = 16u;   // number of valid MSBs in each sample (BitDepth)
+      *(packetData++) = mAudioFormatCode;
 
-    packetData += 2; // skip stream_data_length
-
-    // Set the sparse time stamp bit, set reserved field and evt field to a constant zero
-    // the rest of Packet_info will be filled in per packet
-    bool isSparse = false;
-    if (eIasAvbCompLatest == mCompatibilityModeAudio)
-    {
-      if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cAudioSparseTS, isSparse) && isSparse)
+      if (eIasAvbCompLatest == mCompatibilityModeAudio)
       {
-        *(packetData++) = 0x10; // rsv|sp=1|evt
+        packetData++;           // nsr + rsv + part of ch per frame, filled in per packet
+        // ToDo: Check if reserved is set to 0 if not, set here
+        packetData++;           // rest of ch per frame, filled in per packet
       }
       else
       {
-        *(packetData++) = 0x00; // rsv|sp=0|evt
+        packetData++;           // channel layout, filled in per packet
+        *(packetData++) = mSampleFrequencyCode;
       }
-    }
-    else // Draft 6
-    {
-      *(packetData++) = 0x00; // M3,M2,M1,M0,evt, first part of channels_per_frame
-    }
-    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Sparse Time Stamping is",
-            (isSparse ? "ENABLED" : "DISABLED"));
+      *(packetData++) = uint8_t(getSampleSize(mAudioFormat) * 8u);   // number of valid MSBs in each sample (BitDepth)
 
-    if (eIasAvbCompLatest == mCompatibilityModeAudio)
-    {
-      *(packetData++) = 0x00u; // reserved filed
+      packetData += 2; // skip stream_data_length
+
+      // Set the sparse time stamp bit, set reserved field and evt field to a constant zero
+      // the rest of Packet_info will be filled in per packet
+      bool isSparse = false;
+      if (eIasAvbCompLatest == mCompatibilityModeAudio)
+      {
+        if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cAudioSparseTS, isSparse) && isSparse)
+        {
+          *(packetData++) = 0x10; // rsv|sp=1|evt
+        }
+        else
+        {
+          *(packetData++) = 0x00; // rsv|sp=0|evt
+        }
+      }
+      else // Draft 6
+      {
+        *(packetData++) = 0x00; // M3,M2,M1,M0,evt, first part of channels_per_frame
+      }
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Sparse Time Stamping is",
+              (isSparse ? "ENABLED" : "DISABLED"));
+
+      if (eIasAvbCompLatest == mCompatibilityModeAudio)
+      {
+        *(packetData++) = 0x00u; // reserved filed
+      }
     }
 
     /*
@@ -647,13 +773,25 @@ void IasAvbAudioStream::activationChanged()
   if (isConnected())
   {
     AVB_ASSERT(NULL != mLocalStream);
-    mLocalStream->setClientActive(isActive());
+    mLocalStream->setClientActive(this, isActive());
   }
 
   mLock.unlock();
 }
 
 
+void IasAvbAudioStream::selectFrameKernels(uint16_t numChannels)
+{
+  // the direction isn't known yet when called from initTransmit/initReceive, select both
+  mFramesChannels = numChannels;
+  mPackFrames = IasAvbAudioConversion::getPackFramesFunction(mAudioFormat, numChannels);
+  mUnpackFrames = IasAvbAudioConversion::getUnpackFramesFunction(mAudioFormat, numChannels);
+
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "frame kernel for", numChannels, "channels:",
+              (NULL != mPackFrames) ? "specialized" : "generic");
+}
+
+
 bool IasAvbAudioStream::resetTime(uint64_t nextWindowStart)
 {
   bool ret = false;
@@ -699,7 +837,7 @@ bool IasAvbAudioStream::resetTime(uint64_t nextWindowStart)
     if (nextWindowStart > mMasterTime)
     {
       // calculate first point in time where samples will cross the ref plane during the next TX window
-      samplesToSkip = uint32_t(ceil(double(nextWindowStart - mMasterTime) / mSampleIntervalNs));
+      samplesToSkip = uint32_t(IasAvbSampleTime::samplesCeil(nextWindowStart - mMasterTime, mSampleInterval));
     }
     else
     {
@@ -711,7 +849,7 @@ bool IasAvbAudioStream::resetTime(uint64_t nextWindowStart)
       uint32_t samplesAlreadySent = 0u; // samples already sent before reset happened due to underrun
 
       // calculate first point in time where samples will cross the timestamp of the last sent packet
-      samplesAlreadySent = uint32_t(ceil(double(mLastRefPlaneSampleTime - mMasterTime) / mSampleIntervalNs));
+      samplesAlreadySent = uint32_t(IasAvbSampleTime::samplesCeil(mLastRefPlaneSampleTime - mMasterTime, mSampleInterval));
 
       if (samplesToSkip < samplesAlreadySent)
       {
@@ -721,7 +859,9 @@ bool IasAvbAudioStream::resetTime(uint64_t nextWindowStart)
 
     // adjust ref plane
     mRefPlaneSampleCount += samplesToSkip;
-    mRefPlaneSampleTime = mMasterTime + uint64_t(double(samplesToSkip) * mSampleIntervalNs * clock->getRateRatio());
+    const IasAvbSampleTime::Duration sampleDuration = IasAvbSampleTime::scale(mSampleInterval,
+        IasAvbSampleTime::fromRatio(clock->getRateRatio()));
+    mRefPlaneSampleTime = mMasterTime + IasAvbSampleTime::toNs(sampleDuration, samplesToSkip);
 
     /* adapt launch time
      * without syntonized mode, time needs to be converted from PTP time (ref plane) to I210 time
@@ -772,6 +912,8 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
     uint16_t numChannels = 0u;
     uint16_t written = 0u;
     bool   isReadReady = false;
+    const bool isIec61883 = (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == mAudioFormat);
+    uint8_t* const payload = avtpBase8 + (isIec61883 ? (cIasAvtpHeaderSize + cIasCipHeaderSize) : cIasAvtpHeaderSize);
 
     if ((0u == mRefPlaneSampleCount) && (0u == mRefPlaneSampleTime))
     {
@@ -795,8 +937,8 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
 
     packet->attime = mPacketLaunchTime;
 
-    // If sparse time stamping bit (sp) is set to true
-    if (avtpBase8[22] & 0x10)
+    // If sparse time stamping bit (sp) is set to true (AAF only, IEC 61883 stamps every SYT_INTERVAL data blocks)
+    if (!isIec61883 && (avtpBase8[22] & 0x10))
     {
         // Set time stamp valid bit (tv) to true every 8th packet
         if (!(mSeqNum % 8))
@@ -820,7 +962,6 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
     if (isConnected())
     {
       AVB_ASSERT(NULL != mLocalStream);
-      uint16_t ch;
 
       numChannels = mLocalStream->getNumChannels();
 
@@ -838,7 +979,7 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
          */
 
         uint16_t dump = uint16_t(mDummySamplesSent);
-        mLocalStream->dumpFromLocalAudioBuffer(dump);
+        mLocalStream->dumpFromLocalAudioBuffer(dump, mLocalReader);
         mDummySamplesSent -= dump;
 
         if (dump > 0u)
@@ -879,14 +1020,14 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
         if (isReadReady &&  // local buffer is ready for reading
               (0u == mLocalStreamReadSampleCount))  // about to start reading samples from local buffer
         {
-          uint64_t timeStamp = mLocalStream->getCurrentTimestamp();
+          uint64_t timeStamp = mLocalStream->getCurrentTimestamp(mLocalReader);
           /*
            * dispose of samples behind mRefPlaneSampleTime
            */
           while ((0u != timeStamp) && (timeStamp < mRefPlaneSampleTime))
           {
-            mLocalStream->dumpFromLocalAudioBuffer(mSamplesPerChannelPerPacket);
-            timeStamp = mLocalStream->getCurrentTimestamp();
+            mLocalStream->dumpFromLocalAudioBuffer(mSamplesPerChannelPerPacket, mLocalReader);
+            timeStamp = mLocalStream->getCurrentTimestamp(mLocalReader);
 
             /*
              * If timeStamps in descriptors are too far away, all data samples will be discarded.
@@ -902,10 +1043,12 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
             IasAvbClockDomain * const clock = getClockDomain();
             AVB_ASSERT(NULL != clock);
 
-            samplesToSkip = uint32_t(ceil(double(timeStamp - mRefPlaneSampleTime) / mSampleIntervalNs));
+            samplesToSkip = uint32_t(IasAvbSampleTime::samplesCeil(timeStamp - mRefPlaneSampleTime, mSampleInterval));
 
             // timestamp aligned in multiples of sample period
-            alignedTimestamp = mRefPlaneSampleTime + uint64_t(double(samplesToSkip) * mSampleIntervalNs * clock->getRateRatio());
+            const IasAvbSampleTime::Duration sampleDuration = IasAvbSampleTime::scale(mSampleInterval,
+                IasAvbSampleTime::fromRatio(clock->getRateRatio()));
+            alignedTimestamp = mRefPlaneSampleTime + IasAvbSampleTime::toNs(sampleDuration, samplesToSkip);
 
             // offset to be applied on each timestamp read from the descriptor buffer so that it can be multiples of sample period
             mLocalStreamSampleOffset = alignedTimestamp - timeStamp;
@@ -913,104 +1056,102 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
         }
       }
 
-      // hard-coded SAF16 routine
       // observation logic only active for first channel, assume all others behave synchronously
-      for (ch = 0u; ch < numChannels; ch++)
+      if (mDummySamplesSent > 0u)
       {
-        uint8_t * pBase = avtpBase8 + 24 + getSampleSize(mAudioFormat) * ch;
-
-        if (mDummySamplesSent > 0u)
-        {
-          written = 0u;
-        }
-        else
+        written = 0u;
+      }
+      else
+      {
+        if (true == isReadReady)
         {
-          if (true == isReadReady)
-          {
-            uint64_t timeStamp = 0u;
-            mLocalStream->readLocalAudioBuffer(ch, mTempBuffer, mSamplesPerChannelPerPacket, written, timeStamp);
+          uint64_t timeStamp = 0u;
+          // all channels of the packet in one go, mTempBuffer holds them one after the other
+          mLocalStream->readLocalAudioBuffers(numChannels, mTempBuffer, mSamplesPerChannelPerPacket, written, timeStamp,
+                                              mLocalReader);
 
-            if ((0u == ch) && (0u != written) && (0u != timeStamp))
-            {
-              timeStamp += mLocalStreamSampleOffset;
-              mLocalStreamReadSampleCount += written;
-            }
-          }
-          else
+          if ((0u != written) && (0u != timeStamp))
           {
-            written = 0u;
+            timeStamp += mLocalStreamSampleOffset;
+            mLocalStreamReadSampleCount += written;
           }
         }
-
-        if (0u == written)
+        else
         {
-          if (0u == ch)
-          {
-            if (true == isReadReady)
-            {
-              if (!mWaitForData)
-              {
-                DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Underrun condition begins at",
-                    mRefPlaneSampleCount, "samples, launch time=",
-                    mPacketLaunchTime);
-                mWaitForData = true;
-              }
-              mDummySamplesSent += mSamplesPerChannelPerPacket;
-            }
-            else // !isReadReady
-            {
-              /*
-               * nop: this will not be the underrun case since local stream will accumulate samples
-               * up to half-full of the ring buffer at the beginning in case of time-aware buffering
-               */
-            }
-          }
-
-          // create '0' samples to be sent
-          written = mSamplesPerChannelPerPacket;
-          for (uint32_t sample = 0u; sample < written; sample++)
-          {
-            mTempBuffer[sample] = 0.0;
-          }
+          written = 0u;
         }
-        else
+      }
+
+      if (0u == written)
+      {
+        if (true == isReadReady)
         {
-          if ((0u == ch) && mWaitForData)
+          if (!mWaitForData)
           {
-            DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Underrun condition ended after",
+            DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Underrun condition begins at",
                 mRefPlaneSampleCount, "samples, launch time=",
                 mPacketLaunchTime);
-            mWaitForData = false;
-            // no soft reset required anymore; either, the dummy payload is balanced out, or the stream is reset anyway
+            mWaitForData = true;
           }
+          mDummySamplesSent += mSamplesPerChannelPerPacket;
         }
-
-        // copy samples to packet and do format conversion
-        if (mUseSaturation)
+        else // !isReadReady
         {
-          for (uint32_t sample = 0u; sample < written; sample++)
-          {
-            *reinterpret_cast<uint16_t*>(pBase) = htons(uint16_t(mTempBuffer[sample]));
-            pBase += mStride;
-          }
+          /*
+           * nop: this will not be the underrun case since local stream will accumulate samples
+           * up to half-full of the ring buffer at the beginning in case of time-aware buffering
+           */
         }
-        else
+
+        // create '0' samples to be sent
+        written = mSamplesPerChannelPerPacket;
+        (void) memset(mTempBuffer, 0, numChannels * mSamplesPerChannelPerPacket * sizeof (AudioData));
+      }
+      else
+      {
+        if (mWaitForData)
         {
-          for (uint32_t sample = 0u; sample < written; sample++)
-          {
-            *reinterpret_cast<uint16_t*>(pBase) = htons(uint16_t(int16_t(mTempBuffer[sample])));
-            pBase += mStride;
-          }
+          DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Underrun condition ended after",
+              mRefPlaneSampleCount, "samples, launch time=",
+              mPacketLaunchTime);
+          mWaitForData = false;
+          // no soft reset required anymore; either, the dummy payload is balanced out, or the stream is reset anyway
         }
       }
 
+      const uint16_t numLocalChannels = numChannels;
+      const AudioData* planar = mTempBuffer;
+      if (!mRoutes.empty())
+      {
+        // local channels to AVB channels through the routing matrix
+        AVB_ASSERT(NULL != mRouteBuffer);
+        routeChannels(mTempBuffer, mSamplesPerChannelPerPacket, numLocalChannels,
+                      mRouteBuffer, mSamplesPerChannelPerPacket, mRoutedChannels, written);
+        planar = mRouteBuffer;
+        numChannels = mRoutedChannels;
+      }
+
+      if ((NULL != mPackFrames) && (numChannels == mFramesChannels))
+      {
+        // kernel specialized for the channel count, interleave and convert in one pass
+        mPackFrames(planar, mSamplesPerChannelPerPacket, payload, written);
+      }
+      else
+      {
+        // interleave to frames, then copy all samples to packet and do format conversion in one pass
+        IasAvbAudioConversion::interleave(planar, mSamplesPerChannelPerPacket, mFrameBuffer, numChannels, written);
+        AVB_ASSERT(NULL != mPackSamples);
+        mPackSamples(mFrameBuffer, payload, uint32_t(numChannels * written), getSampleSize(mAudioFormat));
+      }
+
       uint8_t layout = 0u;
       if (mLocalStream->hasSideChannel())
       {
         uint16_t samplesWritten = 0;
         uint64_t timeStamp = 0u;
         // side channel is always the last one
-        mLocalStream->readLocalAudioBuffer(ch, mTempBuffer, mSamplesPerChannelPerPacket, samplesWritten, timeStamp);
+        mLocalStream->readLocalAudioBuffer(numLocalChannels, mTempBuffer, mSamplesPerChannelPerPacket, samplesWritten, timeStamp,
+                                           mLocalReader);
         if (samplesWritten > 0u)
         {
           SideChannel temp;
@@ -1034,7 +1175,11 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
         mLocalStream->unlock();
       }
 
-      if ((eIasAvbCompSaf== mCompatibilityModeAudio) || (eIasAvbCompD6 == mCompatibilityModeAudio))
+      if (isIec61883)
+      {
+        // do nothing, there is no field for the channel layout in IEC 61883
+      }
+      else if ((eIasAvbCompSaf== mCompatibilityModeAudio) || (eIasAvbCompD6 == mCompatibilityModeAudio))
       {
         avtpBase8[17] = layout;
       }
@@ -1057,7 +1202,11 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
     // set channels_per_frame
     AVB_ASSERT(numChannels <= mMaxNumChannels);
 
-    if (eIasAvbCompLatest == mCompatibilityModeAudio)
+    if (isIec61883)
+    {
+      writeCipHeader(avtpBase8, numChannels, written);
+    }
+    else if (eIasAvbCompLatest == mCompatibilityModeAudio)
     {
       uint8_t *avtpData = &avtpBase8[17];
       *avtpData++ = static_cast<uint8_t>((mSampleFrequencyCode << 4) | (uint8_t) ((numChannels >> 8) & 0x0003u));
@@ -1069,12 +1218,13 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
     }
 
     // set packet length and stream_data_length
-    const uint16_t streamDataLength = uint16_t(written * numChannels * getSampleSize(mAudioFormat));
+    // for IEC 61883, stream_data_length includes the CIP header
+    const uint16_t streamDataLength = uint16_t((written * numChannels * getSampleSize(mAudioFormat)) +
+        (isIec61883 ? cIasCipHeaderSize : 0u));
     *(avtpBase16 + 10) = htons(streamDataLength);
-    packet->len = streamDataLength + IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>::cHeaderSize +
-        IasAvbTSpec::cIasAvbPerFrameOverhead;
+    packet->len = streamDataLength + cIasAvtpHeaderSize + IasAvbTSpec::cIasAvbPerFrameOverhead;
 #if DEBUG_LAUNCHTIME
-    (void) memcpy(avtpBase8 + IasAvbAudioFormatTraits<IasAvbAudioFormat::eIasAvbAudioFormatSaf16>::cHeaderSize + streamDataLength, &mPacketLaunchTime, 8);
+    (void) memcpy(avtpBase8 + cIasAvtpHeaderSize + streamDataLength, &mPacketLaunchTime, 8);
     packet->len += 8;
 #endif
     bool btmEnable = false;
@@ -1140,21 +1290,22 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
 
     if (0u != mMasterTime)
     {
-      double sampleDuration = 0.0;
+      IasAvbSampleTime::Duration sampleDuration = 0u;
       if (0u == mLastMasterTime)
       {
         // first cycle after reset. use rateRatio instead
-        AVB_ASSERT(0.0 != mSampleFrequency);
-        sampleDuration = 1e9 * pClockDomain->getRateRatio() / double(mSampleFrequency);
+        AVB_ASSERT(0u != mSampleFrequency);
+        sampleDuration = IasAvbSampleTime::scale(mSampleInterval, IasAvbSampleTime::fromRatio(pClockDomain->getRateRatio()));
       }
       else
       {
         AVB_ASSERT(mMasterCount - mLastMasterCount);
-        sampleDuration = double(mMasterTime - mLastMasterTime) / double(mMasterCount - mLastMasterCount);
+        sampleDuration = IasAvbSampleTime::fromInterval(mMasterTime - mLastMasterTime, mMasterCount - mLastMasterCount);
       }
 
       mRefPlaneSampleCount += written;
-      mRefPlaneSampleTime = mMasterTime + uint64_t(int64_t(sampleDuration * double(int64_t(mRefPlaneSampleCount - (mMasterCount + mRefPlaneSampleOffset)))));
+      mRefPlaneSampleTime = mMasterTime + uint64_t(IasAvbSampleTime::toNsSigned(sampleDuration,
+          int64_t(mRefPlaneSampleCount - (mMasterCount + mRefPlaneSampleOffset))));
       mPacketLaunchTime = mRefPlaneSampleTime;
 
 #if HURGHBLURB
@@ -1175,6 +1326,50 @@ bool IasAvbAudioStream::writeToAvbPacket(IasAvbPacket* packet, uint64_t nextWind
   return result;
 }
 
+void IasAvbAudioStream::writeCipHeader(uint8_t* const avtpBase8, const uint16_t numChannels, const uint16_t numSamples)
+{
+  AVB_ASSERT(NULL != avtpBase8);
+  AVB_ASSERT(0u != mSytInterval);
+
+  avtpBase8[25] = uint8_t(numChannels); // DBS, one AM824 quadlet per channel
+  avtpBase8[27] = mDbc;
+
+  /*
+   * IEEE 1722 carries the SYT in the AVTP time stamp: it refers to the first data block with
+   * DBC % SYT_INTERVAL == 0. Packets without such a data block don't carry a valid time stamp.
+   */
+  const uint16_t sytOffset = getSytOffset(mDbc);
+  if (sytOffset < numSamples)
+  {
+    const uint64_t presentationTime = mRefPlaneSampleTime + getPresentationTimeOffset() +
+        IasAvbSampleTime::toNs(mSampleInterval, sytOffset);
+    reinterpret_cast<uint32_t*>(avtpBase8)[3] = htonl(uint32_t(presentationTime));
+    avtpBase8[1] |= 0x01u;
+  }
+  else
+  {
+    avtpBase8[1] &= uint8_t(~0x01u);
+  }
+
+  // the NULL stream advances the DBC as well, so the time stamps keep the SYT_INTERVAL spacing
+  mDbc = uint8_t(mDbc + numSamples);
+}
+
+
+size_t IasAvbAudioStream::getPayloadLength(const uint8_t* const avtpBase8) const
+{
+  size_t payloadLength = ntohs(reinterpret_cast<const uint16_t*>(avtpBase8)[10]);
+
+  if (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == mAudioFormat)
+  {
+    // stream_data_length includes the CIP header
+    payloadLength = (payloadLength > cIasCipHeaderSize) ? (payloadLength - cIasCipHeaderSize) : 0u;
+  }
+
+  return payloadLength;
+}
+
+
 void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t length)
 {
   mLock.lock();
@@ -1205,7 +1400,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
       if (cValidateNever == mValidationMode)
       {
         // just assume a healthy packet (should only be used under lab/debugging conditions)
-        payloadLength = ntohs(avtpBase16[10]);
+        payloadLength = getPayloadLength(avtpBase8);
         newState = IasAvbStreamState::eIasAvbStreamValid;
       }
       else
@@ -1218,6 +1413,43 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
             validationStage++;
             if (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == mAudioFormat)
             {
+              validationStage++;
+              // validate AVTP subtype and presence of the CIP header
+              if ((0x00 == avtpBase8[0]) && (0x40 == (avtpBase8[22] & 0xC0)) && (length >= (cAvtpHeaderSize + cIasCipHeaderSize)))
+              {
+                validationStage++;
+                // validate format (audio and music)
+                if (0x10 == (avtpBase8[28] & 0x3F))
+                {
+                  validationStage++;
+                  // validate sample frequency
+                  if ((avtpBase8[29] & 0x07u) == mSampleFrequencyCode)
+                  {
+                    validationStage++;
+                    // validate stream data length
+                    payloadLength = getPayloadLength(avtpBase8);
+
+                    // ignore potential padding, just make sure packet is long enough
+                    if ((length - (cAvtpHeaderSize + cIasCipHeaderSize)) >= payloadLength)
+                    {
+                      validationStage++;
+                      newState = IasAvbStreamState::eIasAvbStreamValid;
+                    }
+                  }
+                }
+                else
+                {
+                  // not the expected format
+                  // @@DIAG inc UNSUPPORTED FORMAT
+                  mDiag.setUnsupportedFormat(mDiag.getUnsupportedFormat()+1);
+                }
+              }
+              else
+              {
+                // not AVTP IEC 61883
+                // @@DIAG inc UNSUPPORTED FORMAT
+                mDiag.setUnsupportedFormat(mDiag.getUnsupportedFormat()+1);
+              }
             }
             else
             {
@@ -1274,7 +1506,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
 
         if (IasAvbStreamState::eIasAvbStreamValid == oldState)
         {
-          payloadLength = ntohs(avtpBase16[10]);
+          payloadLength = getPayloadLength(avtpBase8);
           if (avtpBase8[2] == uint8_t(mSeqNum + 1u))
           {
             newState = IasAvbStreamState::eIasAvbStreamValid;
@@ -1307,7 +1539,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
         setStreamState(newState);
         if (isConnected())
         {
-          mLocalStream->setClientActive(true);
+          mLocalStream->setClientActive(this, true);
         }
       }
     }
@@ -1335,7 +1567,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
         setStreamState(newState);
         if (isConnected())
         {
-          mLocalStream->setClientActive(false);
+          mLocalStream->setClientActive(this, false);
         }
         IasAvbClockDomain* const clockDomain = getClockDomain();
         if ((NULL != clockDomain) && (clockDomain->getType() == eIasAvbClockDomainRx))
@@ -1359,9 +1591,26 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
       bool sideChannel = false;
       uint16_t numChannels;
 
-      const uint32_t timestamp = ntohl(avtpBase32[3]);
+      uint32_t timestamp = ntohl(avtpBase32[3]);
+      const bool isIec61883 = (IasAvbAudioFormat::eIasAvbAudioFormatIec61883 == mAudioFormat);
+      const uint8_t* const payload = avtpBase8 + (isIec61883 ? (cAvtpHeaderSize + cIasCipHeaderSize) : cAvtpHeaderSize);
 
-      if (eIasAvbCompLatest == mCompatibilityModeAudio)
+      if (isIec61883)
+      {
+        numChannels = avtpBase8[25]; // DBS, one AM824 quadlet per channel
+
+        if (avtpBase8[1] & 0x01)
+        {
+          // the time stamp refers to the first data block with DBC % SYT_INTERVAL == 0, move it to the first one
+          timestamp -= uint32_t(IasAvbSampleTime::toNs(mSampleInterval, getSytOffset(avtpBase8[27])));
+        }
+        else
+        {
+          // no time stamped data block in this packet, extrapolate from the last time stamp
+          timestamp = uint32_t(mRefPlaneSampleTime + IasAvbSampleTime::toNs(mSampleInterval, mRefPlaneSampleCount));
+        }
+      }
+      else if (eIasAvbCompLatest == mCompatibilityModeAudio)
       {
         numChannels = static_cast<uint16_t>((((uint16_t)avtpBase8[17]) & 0x0003u) | ((uint16_t)avtpBase8[18]));
       }
@@ -1390,6 +1639,23 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
       {
           numSamplesPerChannel = static_cast<uint16_t>(payloadLength / stride);
       }
+
+      if (isIec61883)
+      {
+        // check the DBC continuity, unlike the sequence number it also reveals data blocks dropped by the talker
+        const uint8_t dbc = avtpBase8[27];
+        if ((IasAvbStreamState::eIasAvbStreamValid == oldState) && (dbc != mDbc))
+        {
+          mDbcDiscontinuities++;
+          DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX, "DBC discontinuity (", mDbcDiscontinuities,
+              ") DBC:", uint32_t(dbc), "Expected:", uint32_t(mDbc));
+        }
+
+        // the NULL stream advances the DBC by the samples of one packet interval
+        const uint16_t numDataBlocks = (0u != stride) ? numSamplesPerChannel :
+            uint16_t(IasAvbSampleTime::samplesPerInterval(mSampleFrequency, getTSpec().getPacketsPerSecond()));
+        mDbc = uint8_t(dbc + numDataBlocks);
+      }
       // ignore excess samples above the limit we allow
       if (numSamplesPerChannel > (mSamplesPerChannelPerPacket + mExcessSamples))
       {
@@ -1398,9 +1664,11 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
 
       // ignore excess audio channels
       // implies limit to mMaxNumChannels
-      if (numChannels > numLocalChannels)
+      const bool routed = !mRoutes.empty() && (numLocalChannels > 0u);
+      const uint16_t maxChannels = routed ? mMaxNumChannels : numLocalChannels;
+      if (numChannels > maxChannels)
       {
-        numChannels = numLocalChannels;
+        numChannels = maxChannels;
       }
 
       if (isConnected() && (numChannels > 0u))
@@ -1412,7 +1680,8 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
         {
           mLocalStream->lock();
 
-          if (IasAvbStreamState::eIasAvbStreamValid != oldState)
+          // while mixing, the buffers hold the samples of the other sources as well
+          if ((IasAvbStreamState::eIasAvbStreamValid != oldState) && !mLocalStream->isMixing())
           {
             // reset buffers to flush old data samples and timestamp epoch
             for (channel = 0u; channel < mLocalStream->getNumChannels(); channel++)
@@ -1427,62 +1696,90 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
           }
         }
 
-        for (channel = 0u; channel < numChannels; channel++)
+        if (0u != numSamplesPerChannel)
         {
-          AVB_ASSERT(IasAvbAudioFormat::eIasAvbAudioFormatSaf16 == mAudioFormat);
+          AVB_ASSERT(NULL != mUnpackSamples);
 
-          const uint8_t* in = avtpBase8 + (24u + (sampleSize * channel));
+          // with a routing matrix, the AVB channels are unpacked to the route buffer first
+          AudioData* const planar = routed ? mRouteBuffer : mTempBuffer;
+          AVB_ASSERT(NULL != planar);
 
-          for (uint32_t sample = 0u; sample < numSamplesPerChannel; sample++)
+          if ((stride == (sampleSize * numChannels)) && (NULL != mUnpackFrames) && (numChannels == mFramesChannels))
           {
-            // orig
-            mTempBuffer[sample] = AudioData(int16_t(ntohs(*reinterpret_cast<const uint16_t*>(in))));
-            in += stride;
+            // kernel specialized for the channel count, convert and split into channels in one pass
+            mUnpackFrames(payload, planar, numSamplesPerChannel, numSamplesPerChannel);
           }
-
-          mLocalStream->writeLocalAudioBuffer(channel, mTempBuffer, numSamplesPerChannel, written, timestamp);
-
-#if defined(DEBUG_LISTENER_UNCERTAINTY)
-          /* DO NOT ENABLE THESE LINES FOR PRODUCTION SW */
-          if (0u == channel)
+          else if (stride == (sampleSize * numChannels))
           {
-            IasLibPtpDaemon* ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
-            const uint64_t now = ptp->getLocalTime();
-
-            uint64_t rxTstamp = 0u;
-            const size_t rxTstampSz = sizeof(rxTstamp);
-
-            uint64_t rxTstampBuf = uint64_t(((uint8_t*)packet + length + (rxTstampSz - 1u))) & ~(rxTstampSz - 1u);
-            rxTstamp = *((uint64_t*)rxTstampBuf);
-            if (rxTstamp <= now)
+            // convert the frames of all channels in one pass, then split them into channels
+            mUnpackSamples(payload, mFrameBuffer, uint32_t(numChannels * numSamplesPerChannel), sampleSize);
+            IasAvbAudioConversion::deinterleave(mFrameBuffer, planar, numSamplesPerChannel, numChannels,
+                                                numSamplesPerChannel);
+          }
+          else
+          {
+            // the packet carries more channels than the local stream takes, pick the channels one by one
+            for (channel = 0u; channel < numChannels; channel++)
             {
-              const uint64_t elapsed = now - rxTstamp;
-
-              if (gDebugRxDelayWorst < elapsed)
-              {
-                gDebugRxDelayWorst = elapsed;
-
-                DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Rx elapsed time from MAC to Local Audio Buffer (worst case) = ",
-                    uint64_t(elapsed));
-              }
+              const uint8_t* in = payload + (sampleSize * channel);
+              mUnpackSamples(in, planar + (channel * numSamplesPerChannel), numSamplesPerChannel, stride);
             }
           }
-#endif
         }
 
+        if (routed)
+        {
+          // AVB channels to local channels through the routing matrix, unrouted local channels are silent
+          routeChannels(mRouteBuffer, numSamplesPerChannel, numChannels,
+                        mTempBuffer, numSamplesPerChannel, numLocalChannels, numSamplesPerChannel);
+        }
         // if there are local channels left, fill them with zero
-        (void) memset(mTempBuffer, 0, (mSamplesPerChannelPerPacket + mExcessSamples) * sizeof (AudioData));
+        else if (numChannels < numLocalChannels)
+        {
+          (void) memset(mTempBuffer + (numChannels * numSamplesPerChannel), 0,
+                        (numLocalChannels - numChannels) * numSamplesPerChannel * sizeof (AudioData));
+        }
 
-        for (; channel < numLocalChannels; channel++)
+        mLocalStream->writeLocalAudioBuffers(numLocalChannels, mTempBuffer, numSamplesPerChannel, written, timestamp,
+                                             mLocalReader);
+        channel = numLocalChannels;
+
+#if defined(DEBUG_LISTENER_UNCERTAINTY)
+        /* DO NOT ENABLE THESE LINES FOR PRODUCTION SW */
         {
-          mLocalStream->writeLocalAudioBuffer(channel, mTempBuffer, numSamplesPerChannel, written, timestamp);
+          IasLibPtpDaemon* ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
+          const uint64_t now = ptp->getLocalTime();
+
+          uint64_t rxTstamp = 0u;
+          const size_t rxTstampSz = sizeof(rxTstamp);
+
+          uint64_t rxTstampBuf = uint64_t(((uint8_t*)packet + length + (rxTstampSz - 1u))) & ~(rxTstampSz - 1u);
+          rxTstamp = *((uint64_t*)rxTstampBuf);
+          if (rxTstamp <= now)
+          {
+            const uint64_t elapsed = now - rxTstamp;
+
+            if (gDebugRxDelayWorst < elapsed)
+            {
+              gDebugRxDelayWorst = elapsed;
+
+              DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Rx elapsed time from MAC to Local Audio Buffer (worst case) = ",
+                  uint64_t(elapsed));
+            }
+          }
         }
+#endif
 
         // fill side channel
         if (sideChannel)
         {
           SideChannel layout;
-          if ((eIasAvbCompSaf == mCompatibilityModeAudio) || (eIasAvbCompD6 == mCompatibilityModeAudio))
+          if (isIec61883)
+          {
+            // no channel layout in IEC 61883
+            layout.value = 0u;
+          }
+          else if ((eIasAvbCompSaf == mCompatibilityModeAudio) || (eIasAvbCompD6 == mCompatibilityModeAudio))
           {
             layout.value = uint32_t(avtpBase8[17]);
           }
@@ -1536,7 +1833,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
         {
           // NULL stream, use fictitious number of samples that would fit into one packet interval
           // NOTE: only works reliably for non-fractional values (e.g. 48000 samples/8000 Packets=6 samples)
-          numSamplesPerChannel = uint16_t((1.0e9 / double(getTSpec().getPacketsPerSecond()) / mSampleIntervalNs) + 0.5);
+          numSamplesPerChannel = uint16_t(IasAvbSampleTime::samplesPerInterval(mSampleFrequency, getTSpec().getPacketsPerSecond()));
         }
 
         // check time stamp valid flag
@@ -1547,7 +1844,7 @@ void IasAvbAudioStream::readFromAvbPacket(const void* const packet, const size_t
 
         if ((avtpBase8[1] & 0x01) && mNumSkippedPackets >= mNumPacketsToSkip)
         {
-          uint32_t deltaMediaClock = static_cast<uint32_t>(double(mRefPlaneSampleCount) * mSampleIntervalNs);
+          uint32_t deltaMediaClock = static_cast<uint32_t>(IasAvbSampleTime::toNs(mSampleInterval, mRefPlaneSampleCount));
 
           // skip first time we receive a time stamp after creation of the stream
           // Also, check for reset request. Someone might detected that a reset is needed (e.g. PTP epoch change)
@@ -1618,8 +1915,10 @@ IasAvbProcessingResult IasAvbAudioStream::connectTo(IasLocalAudioStream* localSt
       // first, disconnect from old stream, if any
       if (NULL != mLocalStream)
       {
-        mLocalStream->disconnect();
+        // other talkers may still read from the old stream
+        mLocalStream->disconnect(this);
         mLocalStream = NULL;
+        mLocalReader = 0u;
         mStride      = 0u;
       }
 
@@ -1647,9 +1946,11 @@ IasAvbProcessingResult IasAvbAudioStream::connectTo(IasLocalAudioStream* localSt
 
         if (eIasAvbProcOK == result)
         {
-          localStream->setClientActive(isTransmitStream() && isActive());
+          mLocalReader = localStream->getReader(this);
+          localStream->setClientActive(this, isTransmitStream() && isActive());
           mLocalStream = localStream;
           mStride = uint16_t(numChannels * getSampleSize(mAudioFormat));
+          selectFrameKernels(getNetworkChannels(numChannels));
           mRefPlaneSampleCount  = 0u;
           mDummySamplesSent     = 0u;
           mDumpCount            = 0u;
@@ -1681,6 +1982,132 @@ IasAvbProcessingResult IasAvbAudioStream::connectTo(IasLocalAudioStream* localSt
 }
 
 
+IasAvbProcessingResult IasAvbAudioStream::setChannelRouting(const ChannelRoutingList & routing)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (!isInitialized())
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else
+  {
+    ChannelRoutingList routes(routing);
+    uint16_t routedChannels = 0u;
+
+    for (ChannelRoutingList::const_iterator it = routes.begin(); it != routes.end(); ++it)
+    {
+      if ((it->source >= mMaxNumChannels) || (it->destination >= mMaxNumChannels) || !std::isfinite(it->gain))
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "invalid route", it->source, "->", it->destination,
+            "max channels", mMaxNumChannels);
+        result = eIasAvbProcInvalidParam;
+        break;
+      }
+      const uint16_t avbChannel = isTransmitStream() ? it->destination : it->source;
+      routedChannels = std::max(routedChannels, uint16_t(avbChannel + 1u));
+    }
+
+    // routeChannels() walks the entries destination by destination
+    std::stable_sort(routes.begin(), routes.end(),
+        [](const IasAvbChannelRoute & a, const IasAvbChannelRoute & b) { return a.destination < b.destination; });
+
+    // allocated outside of the lock, so the packet path doesn't wait for it; dropped below if not needed
+    AudioData* routeBuffer = NULL;
+    if ((eIasAvbProcOK == result) && !routes.empty())
+    {
+      routeBuffer = new (nothrow) AudioData[uint32_t(mMaxNumChannels) * (mSamplesPerChannelPerPacket + mExcessSamples)];
+      if (NULL == routeBuffer)
+      {
+        result = eIasAvbProcNotEnoughMemory;
+      }
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      const uint32_t numRoutes = uint32_t(routes.size());
+
+      // the packet paths read the routing state under mLock, so all of it changes at once
+      mLock.lock();
+
+      mRoutes.swap(routes);
+      mRoutedChannels = routedChannels;
+      if (NULL == mRouteBuffer)
+      {
+        mRouteBuffer = routeBuffer;
+        routeBuffer = NULL;
+      }
+
+      uint16_t numLocalChannels = mMaxNumChannels;
+      if (isConnected())
+      {
+        numLocalChannels = mLocalStream->getNumChannels();
+        if (mLocalStream->hasSideChannel() && (numLocalChannels > 0u))
+        {
+          numLocalChannels--;
+        }
+      }
+      selectFrameKernels(getNetworkChannels(numLocalChannels));
+
+      mLock.unlock();
+
+      delete[] routeBuffer;
+
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "routing entries:", numRoutes,
+          "AVB channels:", routedChannels);
+    }
+  }
+
+  if (eIasAvbProcOK != result)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Error=", int32_t(result));
+  }
+
+  return result;
+}
+
+
+void IasAvbAudioStream::routeChannels(const AudioData* const src, const uint32_t srcPitch, const uint16_t numSrc,
+                                      AudioData* const dst, const uint32_t dstPitch, const uint16_t numDst,
+                                      const uint32_t numSamples) const
+{
+  ChannelRoutingList::const_iterator route = mRoutes.begin();
+
+  for (uint16_t channel = 0u; channel < numDst; channel++)
+  {
+    AudioData* const out = dst + (channel * dstPitch);
+    bool silent = true;
+
+    // the entries are sorted by destination, sources the packet or the local stream doesn't have are skipped
+    for (; (route != mRoutes.end()) && (route->destination <= channel); ++route)
+    {
+      if ((route->destination == channel) && (route->source < numSrc))
+      {
+        const AudioData* const in = src + (route->source * srcPitch);
+        if (!silent)
+        {
+          IasAvbAudioConversion::mix(in, out, route->gain, numSamples);
+        }
+        else if (1.0f == route->gain)
+        {
+          (void) memcpy(out, in, numSamples * sizeof (AudioData));
+        }
+        else
+        {
+          IasAvbAudioConversion::scale(in, out, route->gain, numSamples);
+        }
+        silent = false;
+      }
+    }
+
+    if (silent)
+    {
+      (void) memset(out, 0, numSamples * sizeof (AudioData));
+    }
+  }
+}
+
+
 bool IasAvbAudioStream::signalDiscontinuity(DiscontinuityEvent event, uint32_t numSamples)
 {
   bool requestReset = false;
@@ -1718,7 +2145,7 @@ bool IasAvbAudioStream::signalDiscontinuity(DiscontinuityEvent event, uint32_t n
          */
         if (NULL != mLocalStream)
         {
-          mLocalStream->setClientActive(false);
+          mLocalStream->setClientActive(this, false);
         }
       }
       break;
@@ -1828,6 +2255,16 @@ uint32_t IasAvbAudioStream::getMinTransmitBufferSize(uint32_t periodCycle)
   (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndWidth, txWindowWidth);
   (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndPitch, txWindowPitch);
 
+  uint64_t adaptive = 0u;
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndAdaptive, adaptive);
+  if (0u != adaptive)
+  {
+    // the TX window might grow up to its upper bound
+    uint64_t txWindowWidthMax = 2u * txWindowWidth;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndWidthMax, txWindowWidthMax);
+    txWindowWidth = txWindowWidthMax;
+  }
+
   const uint32_t packetsPerSecond = getTSpec().getPacketsPerSecond();
 
   // the maximum number of packets could be passed to igb_avb during txWindowWidth + txWindowPitch.
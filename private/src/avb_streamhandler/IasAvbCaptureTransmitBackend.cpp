@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbCaptureTransmitBackend.cpp
+ * @brief   The definition of the IasAvbCaptureTransmitBackend class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbCaptureTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include <dlt/dlt_cpp_extension.hpp>
+
+#include <errno.h>
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbCaptureTransmitBackend::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+/*
+ *  Constructor.
+ */
+IasAvbCaptureTransmitBackend::IasAvbCaptureTransmitBackend(DltContext &ctx)
+  : mInitialized(false)
+  , mFile()
+  , mPacketCount(0u)
+  , mByteCount(0u)
+  , mWriteErrors(0u)
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbCaptureTransmitBackend::~IasAvbCaptureTransmitBackend()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+IasAvbProcessingResult IasAvbCaptureTransmitBackend::init(uint32_t queueIndex, IasAvbSrClass qavClass)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  std::string fileName;
+
+  (void) qavClass;
+
+  if (mInitialized)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "already initialized!");
+    result = eIasAvbProcInitializationFailed;
+  }
+  else if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitCaptureFile, fileName))
+  {
+    fileName += std::to_string(queueIndex);
+    if (eIasAvbProcOK != mFile.openWrite(fileName))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create capture file", fileName);
+      result = eIasAvbProcInitializationFailed;
+    }
+    else
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "capturing TX queue", queueIndex, "to", fileName);
+    }
+  }
+  else
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "no capture file, packets of TX queue", queueIndex, "are dropped");
+  }
+
+  if (eIasAvbProcOK == result)
+  {
+    mPacketCount = 0u;
+    mByteCount = 0u;
+    mWriteErrors = 0u;
+    mInitialized = true;
+  }
+
+  return result;
+}
+
+
+void IasAvbCaptureTransmitBackend::cleanup()
+{
+  if (mInitialized)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "captured", mPacketCount, "packets,", mByteCount, "bytes,",
+        mWriteErrors, "write errors");
+    mFile.close();
+    mInitialized = false;
+  }
+}
+
+
+int32_t IasAvbCaptureTransmitBackend::xmit(IasAvbPacket * packet)
+{
+  int32_t ret = 0;
+
+  AVB_ASSERT(NULL != packet);
+
+  if (!mInitialized)
+  {
+    ret = -ENXIO;
+  }
+  else if ((NULL == packet) || !packet->isValid())
+  {
+    ret = -EINVAL;
+  }
+  else
+  {
+    if (mFile.isOpen() && (eIasAvbProcOK != mFile.writeFrame(packet->getBasePtr(), uint32_t(packet->len), packet->attime)))
+    {
+      if (0u == mWriteErrors)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't write to capture file, packets are dropped");
+      }
+      mWriteErrors++;
+    }
+    mPacketCount++;
+    mByteCount += packet->len;
+
+    // nothing in flight, the packet is done with
+    (void) IasAvbPacketPool::returnPacket(packet);
+  }
+
+  return ret;
+}
+
+
+uint32_t IasAvbCaptureTransmitBackend::reclaim(bool doReclaim)
+{
+  (void) doReclaim;
+
+  // packets are returned to their pools by xmit() already
+  return 0u;
+}
+
+
+void IasAvbCaptureTransmitBackend::updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh)
+{
+  (void) maxFrameSizeHigh;
+
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "no shaper, bandwidth reserved:", bandwidth, "kBit/s");
+}
+
+
+} // namespace IasMediaTransportAvb
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbIgbTransmitBackend.cpp
+ * @brief   The definition of the IasAvbIgbTransmitBackend class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbIgbTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include <dlt/dlt_cpp_extension.hpp>
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbIgbTransmitBackend::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+#define TQAVCTRL      0x03570
+#define TQAVHC(_n)    (0x0300C + ((_n) * 0x40))
+#define TQAVCC(_n)    (0x03004 + ((_n) * 0x40))
+
+#define TQAVCH_ZERO_CREDIT 0x80000000 /* not configured and always defaults to this value */
+#define TQAVCC_LINKRATE    0x7735     /* not configured and always defaults to this value */
+#define TQAVCC_QUEUEMODE   0x80000000 /* queue mode, 0=strict, 1=SR mode */
+#define TQAVCTRL_TX_ARB    0x00000100 /* data transmit arbitration */
+
+/*
+ *  Constructor.
+ */
+IasAvbIgbTransmitBackend::IasAvbIgbTransmitBackend(DltContext &ctx)
+  : mIgbDevice(NULL)
+  , mQueueIndex(uint32_t(-1))
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbIgbTransmitBackend::~IasAvbIgbTransmitBackend()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+IasAvbProcessingResult IasAvbIgbTransmitBackend::init(uint32_t queueIndex, IasAvbSrClass qavClass)
+{
+  (void) qavClass;
+
+  mQueueIndex = queueIndex;
+  mIgbDevice = IasAvbStreamHandlerEnvironment::getIgbDevice();
+  AVB_ASSERT(NULL != mIgbDevice);
+
+  return eIasAvbProcOK;
+}
+
+
+void IasAvbIgbTransmitBackend::cleanup()
+{
+  mIgbDevice = NULL;
+}
+
+
+int32_t IasAvbIgbTransmitBackend::xmit(IasAvbPacket * packet)
+{
+  AVB_ASSERT(NULL != packet);
+  return packet->xmit(mIgbDevice, mQueueIndex);
+}
+
+
+uint32_t IasAvbIgbTransmitBackend::reclaim(bool doReclaim)
+{
+  uint32_t ret = 0u;
+  igb_packet* packetList = NULL;
+
+  if (doReclaim)
+  {
+    // check and return packets that are not used any longer
+    // NOTE: this is done for all sequencers, not only for this one!
+    igb_clean(mIgbDevice, &packetList);
+    while (NULL != packetList)
+    {
+      IasAvbPacketPool::returnPacket(packetList);
+      ret++;
+      packetList = packetList->next;
+    }
+  }
+
+  return ret;
+}
+
+
+void IasAvbIgbTransmitBackend::updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh)
+{
+  double bandWidth = 0.0;
+  int32_t  linkSpeed = 0;
+  int32_t  idleSlope = -1;
+  uint32_t linkRate  = TQAVCC_LINKRATE;
+  uint32_t maxInterferenceSize = cTxMaxInterferenceSize;
+
+  uint32_t tqavhcReg   = 0u; // Tx Qav Hi Credit TQAVHC
+  uint32_t tqavccReg   = 0u; // Tx Qav Credit Control TQAVCC
+  uint32_t tqavctrlReg = 0u; // Tx Qav Control TQAVCTRL
+
+  // get current link speed
+  linkSpeed = IasAvbStreamHandlerEnvironment::getLinkSpeed();
+
+  if (100 == linkSpeed)
+  {
+    // the percentage bandwith out of full line rate @ 100Mbps (bandwidth = kBit/s)
+    bandWidth = bandwidth * 1000.0 / 100000000.0;
+    idleSlope = static_cast<uint32_t>(bandWidth * 0.2 * (double)linkRate + 0.5);
+  }
+  else if (1000 == linkSpeed)
+  {
+    // the percentage bandwith out of full line rate @ 1Gbps (bandwidth = kBit/s)
+    bandWidth = bandwidth * 1000.0 / 1000000000.0;
+    idleSlope = static_cast<uint32_t>(bandWidth * 2.0 * (double)linkRate + 0.5);
+  }
+  else
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "unknown link speed", linkSpeed);
+    AVB_ASSERT(false);
+  }
+
+  if (0 == idleSlope)
+  {
+    // reset the registers with default value
+    tqavhcReg = TQAVCH_ZERO_CREDIT;
+    tqavccReg = TQAVCC_QUEUEMODE; // no idle slope
+  }
+  else if ((0 < idleSlope) && (static_cast<uint32_t>(idleSlope) < linkRate))
+  {
+    // idleSlope must be smaller than linkRate = 0x7735 credits/byte.
+
+    if (0u == mQueueIndex)
+    {
+      tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
+    }
+    else
+    {
+      uint32_t idleSlopeClassA = 0u;
+
+      (void) igb_readreg(mIgbDevice, TQAVHC(0), &idleSlopeClassA);
+      idleSlopeClassA ^= TQAVCC_QUEUEMODE;
+
+      if ((0 == idleSlopeClassA) || (0xFFFFu == static_cast<uint16_t>(idleSlopeClassA)))
+      {
+        // idleSlope has not been set. i.e. Class A (Queue0) is not used.
+        tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
+      }
+      else if (static_cast<int32_t>(linkRate - idleSlopeClassA) > 0)
+      {
+        /*
+         * Add 43 bytes to maxFrameSizeHigh since it is the size of AVTP payload without media overhead nor header.
+         * (43 = 8 bytes preamble + SFD, 14 bytes Ethernet header, 4 bytes VLAN tag, 4 bytes CRC, 12 bytes IPG, 1 byte SRP)
+         */
+        maxInterferenceSize = maxInterferenceSize + (maxFrameSizeHigh + 43u);
+        linkRate = linkRate - idleSlopeClassA;
+        tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
+      }
+    }
+
+    tqavccReg = (TQAVCC_QUEUEMODE | idleSlope);
+  }
+
+  if ((0u != tqavhcReg) && (0u != tqavccReg))
+  {
+    // HiCredit
+    (void) igb_writereg(mIgbDevice, TQAVHC(mQueueIndex), tqavhcReg);
+
+    // QueueMode and IdleSlope
+    (void) igb_writereg(mIgbDevice, TQAVCC(mQueueIndex), tqavccReg);
+
+    // implicitly enable the Qav shaper
+    (void) igb_readreg(mIgbDevice, TQAVCTRL, &tqavctrlReg);
+    tqavctrlReg |= TQAVCTRL_TX_ARB;
+    (void) igb_writereg(mIgbDevice, TQAVCTRL, tqavctrlReg);
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "set shaping params (",
+        "Queue:", mQueueIndex,
+        "Bandwidth:", bandwidth, "kBit/s",
+        "HiCredit:", tqavhcReg,
+        "IdleSlope:", idleSlope,
+        "");
+  }
+}
+
+
+} // namespace IasMediaTransportAvb
@@ -20,6 +20,9 @@ IasAvbPacket::IasAvbPacket()
   , mMagic(cMagic)
   , mPayloadOffset(0u)
   , mDummyFlag(false)
+  , mNextFree(0u)
+  , mInFreeList(false)
+  , mLessee(NULL)
 {
 }
 
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbPacketArena.cpp
+ * @brief   The definition of the IasAvbPacketArena class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbPacketArena::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+const size_t IasAvbPacketArena::cClassSizes[cNumClasses] = { 128u, 256u, 512u, 1024u, 1536u };
+
+/*
+ *  Constructor.
+ */
+IasAvbPacketArena::IasAvbPacketArena(DltContext &ctx)
+  : mMaxChunks(0u)
+  , mGrowLock()
+  , mLessees()
+  , mLesseeLock()
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+
+  for (uint32_t cl = 0u; cl < cNumClasses; cl++)
+  {
+    SizeClass & sizeClass = mClasses[cl];
+    for (uint32_t idx = 0u; idx < cMaxChunks; idx++)
+    {
+      sizeClass.chunks[idx].store(NULL);
+    }
+    sizeClass.numChunks.store(0u);
+    sizeClass.hint.store(0u);
+    sizeClass.inUse.store(0u);
+    sizeClass.highWater.store(0u);
+  }
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbPacketArena::~IasAvbPacketArena()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+IasAvbProcessingResult IasAvbPacketArena::init(uint32_t maxPacketsPerClass)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if ((0u == maxPacketsPerClass) || (maxPacketsPerClass > (cMaxChunks * cChunkSize)))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "invalid number of packets per size class:", maxPacketsPerClass);
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    mMaxChunks = (maxPacketsPerClass + cChunkSize - 1u) / cChunkSize;
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "shared packet arena, up to", mMaxChunks * cChunkSize,
+        "packets per size class");
+  }
+
+  return result;
+}
+
+
+void IasAvbPacketArena::cleanup()
+{
+  std::lock_guard<std::mutex> lock(mGrowLock);
+
+  for (uint32_t cl = 0u; cl < cNumClasses; cl++)
+  {
+    SizeClass & sizeClass = mClasses[cl];
+    const uint32_t numChunks = sizeClass.numChunks.load();
+
+    sizeClass.numChunks.store(0u);
+    for (uint32_t idx = 0u; idx < numChunks; idx++)
+    {
+      delete sizeClass.chunks[idx].exchange(NULL);
+    }
+    sizeClass.hint.store(0u);
+  }
+
+  std::lock_guard<std::mutex> lesseeLock(mLesseeLock);
+  for (LesseeList::iterator it = mLessees.begin(); mLessees.end() != it; it++)
+  {
+    delete *it;
+  }
+  mLessees.clear();
+}
+
+
+uint32_t IasAvbPacketArena::getClassIndex(size_t packetSize)
+{
+  uint32_t cl = 0u;
+
+  while ((cl < cNumClasses) && (cClassSizes[cl] < packetSize))
+  {
+    cl++;
+  }
+
+  return cl;
+}
+
+
+IasAvbPacket* IasAvbPacketArena::lease(size_t packetSize)
+{
+  IasAvbPacket * packet = NULL;
+  const uint32_t cl = getClassIndex(packetSize);
+
+  if ((0u != packetSize) && (cl < cNumClasses))
+  {
+    SizeClass & sizeClass = mClasses[cl];
+    bool retry = true;
+
+    while ((NULL == packet) && retry)
+    {
+      const uint32_t numChunks = sizeClass.numChunks.load(std::memory_order_acquire);
+      const uint32_t hint = sizeClass.hint.load(std::memory_order_relaxed);
+
+      // start with the chunk that served the previous request, it most likely has packets left
+      for (uint32_t i = 0u; (i < numChunks) && (NULL == packet); i++)
+      {
+        const uint32_t idx = (hint + i) % numChunks;
+        IasAvbPacketPool * const chunk = sizeClass.chunks[idx].load(std::memory_order_acquire);
+        packet = chunk->getPacket();
+        if ((NULL != packet) && (idx != hint))
+        {
+          sizeClass.hint.store(idx, std::memory_order_relaxed);
+        }
+      }
+
+      if (NULL == packet)
+      {
+        retry = grow(cl, numChunks);
+      }
+    }
+
+    if (NULL != packet)
+    {
+      const uint32_t inUse = sizeClass.inUse.fetch_add(1u, std::memory_order_relaxed) + 1u;
+      uint32_t highWater = sizeClass.highWater.load(std::memory_order_relaxed);
+      while ((inUse > highWater) &&
+             !sizeClass.highWater.compare_exchange_weak(highWater, inUse, std::memory_order_relaxed))
+      {
+        // highWater has been reloaded, try again
+      }
+    }
+  }
+
+  return packet;
+}
+
+
+void IasAvbPacketArena::release(size_t packetSize)
+{
+  const uint32_t cl = getClassIndex(packetSize);
+
+  if (cl < cNumClasses)
+  {
+    (void) mClasses[cl].inUse.fetch_sub(1u, std::memory_order_relaxed);
+  }
+}
+
+
+IasAvbPacketLessee* IasAvbPacketArena::attach(size_t packetSize, uint32_t quota)
+{
+  IasAvbPacketLessee * lessee = NULL;
+  std::lock_guard<std::mutex> lock(mLesseeLock);
+
+  for (LesseeList::iterator it = mLessees.begin(); (NULL == lessee) && (mLessees.end() != it); it++)
+  {
+    // returns of the previous stream would otherwise end up in the quota of the new one
+    if (!(*it)->attached && ((*it)->quota == (*it)->available.load(std::memory_order_acquire)))
+    {
+      lessee = *it;
+    }
+  }
+
+  if (NULL == lessee)
+  {
+    lessee = new (nothrow) IasAvbPacketLessee;
+    if (NULL == lessee)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Not enough memory to allocate lessee!");
+    }
+    else
+    {
+      mLessees.push_back(lessee);
+    }
+  }
+
+  if (NULL != lessee)
+  {
+    lessee->arena = this;
+    lessee->packetSize = packetSize;
+    lessee->quota = quota;
+    lessee->available.store(quota, std::memory_order_relaxed);
+    lessee->attached = true;
+  }
+
+  return lessee;
+}
+
+
+void IasAvbPacketArena::detach(IasAvbPacketLessee* lessee)
+{
+  AVB_ASSERT(NULL != lessee);
+  std::lock_guard<std::mutex> lock(mLesseeLock);
+  lessee->attached = false;
+}
+
+
+void IasAvbPacketArena::release(IasAvbPacketLessee* lessee)
+{
+  AVB_ASSERT(NULL != lessee);
+  release(lessee->packetSize);
+
+  // last access, the handle may be reused as soon as the quota is complete
+  (void) lessee->available.fetch_add(1u, std::memory_order_release);
+}
+
+
+bool IasAvbPacketArena::grow(uint32_t classIndex, uint32_t seenChunks)
+{
+  bool grown = false;
+  std::lock_guard<std::mutex> lock(mGrowLock);
+  SizeClass & sizeClass = mClasses[classIndex];
+  const uint32_t numChunks = sizeClass.numChunks.load(std::memory_order_relaxed);
+
+  if (numChunks != seenChunks)
+  {
+    // another thread has added a chunk meanwhile
+    grown = true;
+  }
+  else if (numChunks >= mMaxChunks)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "size class", uint64_t(cClassSizes[classIndex]),
+        "exhausted:", numChunks * cChunkSize, "packets");
+  }
+  else
+  {
+    IasAvbPacketPool * const chunk = new (nothrow) IasAvbPacketPool(*mLog);
+    if (NULL == chunk)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Not enough memory to allocate chunk!");
+    }
+    else if (eIasAvbProcOK != chunk->init(cClassSizes[classIndex], cChunkSize))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "failed to allocate packet memory for size class",
+          uint64_t(cClassSizes[classIndex]));
+      delete chunk;
+    }
+    else
+    {
+      sizeClass.chunks[numChunks].store(chunk, std::memory_order_release);
+      sizeClass.numChunks.store(numChunks + 1u, std::memory_order_release);
+      sizeClass.hint.store(numChunks, std::memory_order_relaxed);
+      grown = true;
+
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "size class", uint64_t(cClassSizes[classIndex]),
+          "grown to", (numChunks + 1u) * cChunkSize, "packets");
+    }
+  }
+
+  return grown;
+}
+
+
+void IasAvbPacketArena::logStatistics()
+{
+  for (uint32_t cl = 0u; cl < cNumClasses; cl++)
+  {
+    if (0u != getAllocated(cl))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "size class", uint64_t(cClassSizes[cl]),
+          "allocated:", getAllocated(cl),
+          "in use:", getInUse(cl),
+          "high water:", getHighWaterMark(cl));
+    }
+  }
+}
+
+} // namespace IasMediaTransportAvb
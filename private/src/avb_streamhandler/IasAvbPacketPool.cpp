@@ -11,8 +11,11 @@
 
 #include "avb_streamhandler/IasAvbPacketPool.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
 #include <cstring>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
 #include <dlt/dlt_cpp_extension.hpp>
 
 namespace IasMediaTransportAvb {
@@ -25,14 +28,20 @@ static const std::string cClassName = "IasAvbPacketPool::";
  */
 IasAvbPacketPool::IasAvbPacketPool(DltContext &dltContext) :
   mLog(&dltContext),
-  mLock(),
   mPacketSize(0u),
   mPoolSize(0u),
-  mFreeBufferStack(),
+  mFreeHead(cEndOfList),
+  mFreeCount(0u),
   mBase(NULL),
-  mDmaPages()
+  mDmaPages(),
+  mHostMemory(false),
+  mArena(NULL),
+  mLessee(NULL),
+  mTemplate(),
+  mTemplateValid(false)
 {
-  // do nothing
+  mTemplate.vaddr = NULL;
+  mTemplate.len = 0u;
 }
 
 
@@ -49,7 +58,7 @@ IasAvbProcessingResult IasAvbPacketPool::init(const size_t packetSize, const uin
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
 
-  if (NULL != mBase)
+  if ((NULL != mBase) || (NULL != mArena))
   {
     DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Already initialized");
     ret = eIasAvbProcInitializationFailed;
@@ -98,7 +107,9 @@ IasAvbProcessingResult IasAvbPacketPool::init(const size_t packetSize, const uin
       device_t* igbDevice = IasAvbStreamHandlerEnvironment::getIgbDevice();
       Page* page = NULL;
 
-      if (NULL == igbDevice)
+      mHostMemory = (NULL == igbDevice) && !IasAvbStreamHandlerEnvironment::isIgbTransmitBackend();
+
+      if ((NULL == igbDevice) && !mHostMemory)
       {
         /*
          * @log Init failed: Returned igbDevice == nullptr
@@ -123,7 +134,7 @@ IasAvbProcessingResult IasAvbPacketPool::init(const size_t packetSize, const uin
       if (eIasAvbProcOK == ret)
       {
         // allocate one DMA page to retrieve properties
-        if (0 != igb_dma_malloc_page( igbDevice, page ))
+        if (0 != allocPage( igbDevice, page ))
         {
           /*
            * @log Init failed: Failed to retrieve DMA page.
@@ -170,7 +181,7 @@ IasAvbProcessingResult IasAvbPacketPool::init(const size_t packetSize, const uin
                 DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Not enough memory to allocate Page!");
                 ret = eIasAvbProcNotEnoughMemory;
               }
-              else if (0 != igb_dma_malloc_page( igbDevice, page ))
+              else if (0 != allocPage( igbDevice, page ))
               {
                 DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " igb dma memory allocation failure");
                 ret = eIasAvbProcInitializationFailed;
@@ -195,6 +206,57 @@ IasAvbProcessingResult IasAvbPacketPool::init(const size_t packetSize, const uin
 }
 
 
+IasAvbProcessingResult IasAvbPacketPool::initShared(IasAvbPacketArena* const arena, const size_t packetSize, const uint32_t quota)
+{
+  IasAvbProcessingResult ret = eIasAvbProcOK;
+
+  if ((NULL != mBase) || (NULL != mArena))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Already initialized");
+    ret = eIasAvbProcInitializationFailed;
+  }
+  else if ((NULL == arena) || (0u == packetSize) || (IasAvbPacketArena::getClassIndex(packetSize) >= IasAvbPacketArena::cNumClasses))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "no arena or no size class for packetSize =", uint64_t(packetSize));
+    ret = eIasAvbProcInvalidParam;
+  }
+  else if ((0u == quota) || (quota > cMaxPoolSize))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "quota = 0 or quota > cMaxPoolSize. quota =", quota);
+    ret = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    // the template header lives in plain memory, it is never handed to the hardware
+    mTemplate.vaddr = new (nothrow) uint8_t[packetSize];
+    if (NULL == mTemplate.vaddr)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Not enough memory to allocate template packet!");
+      ret = eIasAvbProcNotEnoughMemory;
+    }
+    else
+    {
+      mLessee = arena->attach(packetSize, quota);
+      if (NULL == mLessee)
+      {
+        delete[] static_cast<uint8_t*>(mTemplate.vaddr);
+        mTemplate.vaddr = NULL;
+        ret = eIasAvbProcNotEnoughMemory;
+      }
+      else
+      {
+        mArena = arena;
+        mPacketSize = packetSize;
+        mPoolSize = quota;
+        mTemplateValid = false;
+      }
+    }
+  }
+
+  return ret;
+}
+
+
 IasAvbProcessingResult IasAvbPacketPool::initPage(Page * page, const uint32_t packetsPerPage, uint32_t & packetCountTotal)
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
@@ -220,20 +282,75 @@ IasAvbProcessingResult IasAvbPacketPool::initPage(Page * page, const uint32_t pa
     packet.map.paddr = page->dma_paddr;
 
     packet.setHomePool( this );
-    mFreeBufferStack.push_back( &packet );
+    packet.mInFreeList.store(true, std::memory_order_relaxed);
+    pushFree( &packet );
+    mFreeCount++;
   }
 
   return ret;
 }
 
 
+int32_t IasAvbPacketPool::allocPage(device_t * igbDevice, Page * page)
+{
+  int32_t err = 0;
+
+  AVB_ASSERT( NULL != page );
+
+  if (mHostMemory)
+  {
+    // packets are copied by the kernel when sent through a socket, so no DMA memory is needed
+    void * const mem = ::mmap(NULL, cHostPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == mem)
+    {
+      err = errno;
+    }
+    else
+    {
+      page->dma_vaddr = mem;
+      page->dma_paddr = 0u;
+      page->mmap_size = cHostPageSize;
+    }
+  }
+  else
+  {
+    err = igb_dma_malloc_page( igbDevice, page );
+  }
+
+  return err;
+}
+
+
+void IasAvbPacketPool::freePage(device_t * igbDevice, Page * page)
+{
+  AVB_ASSERT( NULL != page );
+
+  if (mHostMemory)
+  {
+    (void) ::munmap(page->dma_vaddr, page->mmap_size);
+  }
+  else
+  {
+    igb_dma_free_page( igbDevice, page );
+  }
+}
+
+
 void IasAvbPacketPool::cleanup()
 {
-  if (mFreeBufferStack.size() < mPoolSize)
+  if (NULL != mLessee)
+  {
+    // packets in flight are released through the handle when they come back, no need to wait for them
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "detaching from arena, packets in flight:",
+                mPoolSize - getFreeCount());
+    mArena->detach(mLessee);
+    mLessee = NULL;
+  }
+  else if (getFreeCount() < mPoolSize)
   {
     DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX,
                 " waiting for remaining buffers before pool destruction.",
-                uint32_t(mFreeBufferStack.size()),
+                getFreeCount(),
                 "/",
                 mPoolSize);
 
@@ -241,18 +358,18 @@ void IasAvbPacketPool::cleanup()
     for (uint32_t i = 0u; i < 10u; i++)
     {
       ::usleep(5000u);
-      if (mFreeBufferStack.size() >= mPoolSize)
+      if (getFreeCount() >= mPoolSize)
       {
         break;
       }
     }
   }
 
-  if (mFreeBufferStack.size() < mPoolSize)
+  if ((NULL == mArena) && (getFreeCount() < mPoolSize))
   {
     DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX,
                 " warning: not all buffers returned before pool destruction!",
-                uint32_t(mFreeBufferStack.size()), "/", mPoolSize);
+                getFreeCount(), "/", mPoolSize);
   }
 
   device_t* igbDevice = IasAvbStreamHandlerEnvironment::getIgbDevice();
@@ -264,18 +381,25 @@ void IasAvbPacketPool::cleanup()
 
     AVB_ASSERT( NULL != page  );
 
-    if (NULL == igbDevice)
+    if ((NULL == igbDevice) && !mHostMemory)
     {
     }
     else
     {
-      igb_dma_free_page( igbDevice, page );
+      freePage( igbDevice, page );
       delete page;
     }
   }
 
   delete[] mBase;
   mBase = NULL;
+  mFreeHead.store(cEndOfList);
+  mFreeCount.store(0u);
+
+  delete[] static_cast<uint8_t*>(mTemplate.vaddr);
+  mTemplate.vaddr = NULL;
+  mTemplateValid = false;
+  mArena = NULL;
 }
 
 
@@ -283,33 +407,116 @@ IasAvbPacket* IasAvbPacketPool::getPacket()
 {
   IasAvbPacket* ret = NULL;
 
-  mLock.lock();
+  if (NULL != mArena)
+  {
+    ret = leasePacket();
+  }
+  else if (NULL != mBase)
+  {
+    ret = popFree();
+  }
 
-  if (NULL != mBase)
+  if (NULL != ret)
   {
-    if (!mFreeBufferStack.empty())
-    {
-      ret = mFreeBufferStack.back();
-      mFreeBufferStack.pop_back();
+    ret->flags = 0u;
+    ret->dmatime = 0u;
+  }
 
-      AVB_ASSERT(NULL != ret);
-      ret->flags = 0u;
-      ret->dmatime = 0u;
+  return ret;
+}
+
+
+IasAvbPacket* IasAvbPacketPool::leasePacket()
+{
+  IasAvbPacket* ret = NULL;
+  AVB_ASSERT( NULL != mLessee );
+  uint32_t quota = mLessee->available.load(std::memory_order_relaxed);
+
+  // take one unit of the quota first, so concurrent callers cannot exceed it
+  while ((0u != quota) && !mLessee->available.compare_exchange_weak(quota, quota - 1u, std::memory_order_relaxed))
+  {
+    // quota has been reloaded, try again
+  }
+
+  if (0u != quota)
+  {
+    ret = mArena->lease(mPacketSize);
+
+    if (NULL == ret)
+    {
+      mLessee->available.fetch_add(1u, std::memory_order_relaxed);
     }
+    else
+    {
+      ret->mLessee = mLessee;
+      if (mTemplateValid)
+      {
+        *ret = mTemplate;
+      }
+    }
+  }
+
+  return ret;
+}
+
+
+void IasAvbPacketPool::pushFree(IasAvbPacket* const packet)
+{
+  AVB_ASSERT( NULL != mBase );
+  const uint32_t index = uint32_t(packet - mBase);
+  uint64_t head = mFreeHead.load(std::memory_order_relaxed);
+
+  do
+  {
+    packet->mNextFree.store(uint32_t(head), std::memory_order_relaxed);
   }
+  while (!mFreeHead.compare_exchange_weak(head, makeHead(head, index),
+      std::memory_order_release, std::memory_order_relaxed));
+}
+
 
-  mLock.unlock();
+IasAvbPacket* IasAvbPacketPool::popFree()
+{
+  IasAvbPacket* ret = NULL;
+  uint64_t head = mFreeHead.load(std::memory_order_acquire);
+
+  while (cEndOfList != uint32_t(head))
+  {
+    // the packet might be popped and pushed again meanwhile, the tag in the head makes the CAS fail then
+    IasAvbPacket * const top = &mBase[uint32_t(head)];
+    const uint32_t next = top->mNextFree.load(std::memory_order_relaxed);
+
+    if (mFreeHead.compare_exchange_weak(head, makeHead(head, next),
+        std::memory_order_acquire, std::memory_order_acquire))
+    {
+      mFreeCount.fetch_sub(1u, std::memory_order_relaxed);
+      top->mInFreeList.store(false, std::memory_order_relaxed);
+      ret = top;
+      break;
+    }
+  }
 
   return ret;
 }
 
 
+void IasAvbPacketPool::rebuildFreeList()
+{
+  // push all packets in index order, so the packet with the highest index is on top
+  for (uint32_t packetIdx = 0u; packetIdx < mPoolSize; packetIdx++)
+  {
+    mBase[packetIdx].mNextFree.store((0u == packetIdx) ? cEndOfList : (packetIdx - 1u), std::memory_order_relaxed);
+    mBase[packetIdx].mInFreeList.store(true, std::memory_order_relaxed);
+  }
+  mFreeCount.store(mPoolSize, std::memory_order_relaxed);
+  mFreeHead.store(makeHead(mFreeHead.load(std::memory_order_relaxed), mPoolSize - 1u), std::memory_order_release);
+}
+
+
 IasAvbProcessingResult IasAvbPacketPool::doReturnPacket(IasAvbPacket* const packet)
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
 
-  mLock.lock();
-
   if (NULL == mBase)
   {
     ret = eIasAvbProcNotInitialized;
@@ -319,31 +526,37 @@ IasAvbProcessingResult IasAvbPacketPool::doReturnPacket(IasAvbPacket* const pack
     AVB_ASSERT( NULL != packet );
     AVB_ASSERT( packet->getHomePool() == this );
 
-    packet->mDummyFlag = false;
-
-    if (mFreeBufferStack.size() < mPoolSize)
-    {
-      mFreeBufferStack.push_back(packet);
-
-      if (mFreeBufferStack.size() == mPoolSize)
-      {
-        DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " All buffers returned\n");
-      }
-    }
-    else if (mFreeBufferStack.size() == mPoolSize)
+    if ((packet < mBase) || (packet >= (mBase + mPoolSize)))
     {
-      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Too many packets returned\n");
-      // put it on the stack to avoid further LAT messages - stack is inconsistent anyway
-      mFreeBufferStack.push_back(packet);
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " packet does not belong to the pool\n");
+      ret = eIasAvbProcInvalidParam;
     }
     else
     {
-      // do nothing to avoid further stack growth
+      bool inFreeList = false;
+
+      // claim the packet first, a packet returned twice would corrupt the free list
+      if (!packet->mInFreeList.compare_exchange_strong(inFreeList, true, std::memory_order_relaxed))
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " packet returned twice\n");
+        ret = eIasAvbProcInvalidParam;
+      }
+      else
+      {
+        const uint32_t freeCount = mFreeCount.fetch_add(1u, std::memory_order_relaxed);
+        AVB_ASSERT( freeCount < mPoolSize );
+
+        packet->mDummyFlag = false;
+        pushFree(packet);
+
+        if ((freeCount + 1u) == mPoolSize)
+        {
+          DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " All buffers returned\n");
+        }
+      }
     }
   }
 
-  mLock.unlock();
-
   return ret;
 }
 
@@ -352,7 +565,7 @@ IasAvbProcessingResult IasAvbPacketPool::initAllPacketsFromTemplate(const IasAvb
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
 
-  if (NULL == mBase)
+  if ((NULL == mBase) && (NULL == mArena))
   {
     ret = eIasAvbProcNotInitialized;
   }
@@ -360,14 +573,26 @@ IasAvbProcessingResult IasAvbPacketPool::initAllPacketsFromTemplate(const IasAvb
   {
     ret = eIasAvbProcInvalidParam;
   }
+  else if (NULL != mArena)
+  {
+    // packets are leased on demand, the template is applied to each of them in getPacket()
+    if (templatePacket->len > mPacketSize)
+    {
+      ret = eIasAvbProcInvalidParam;
+    }
+    else
+    {
+      mTemplate = *templatePacket;
+      mTemplateValid = true;
+    }
+  }
   else
   {
-    for (PacketStack::iterator it = mFreeBufferStack.begin(); it != mFreeBufferStack.end(); it++)
+    // walks the free list, so this must not be called while packets are being fetched or returned
+    for (uint32_t idx = uint32_t(mFreeHead.load(std::memory_order_acquire)); cEndOfList != idx; idx = mBase[idx].mNextFree.load(std::memory_order_relaxed))
     {
-      IasAvbPacket * packet = *it;
-      AVB_ASSERT( NULL != packet);
-
-      *packet = *templatePacket;
+      AVB_ASSERT( idx < mPoolSize );
+      mBase[idx] = *templatePacket;
     }
   }
 
@@ -379,24 +604,21 @@ IasAvbProcessingResult IasAvbPacketPool::reset()
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
 
-  mLock.lock();
-
-  if (NULL == mBase)
+  if (NULL != mArena)
+  {
+    // leased packets are owned by the arena, they come back when the transmit backend reclaims them
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " shared pool, packets in use:", mPoolSize - getFreeCount());
+  }
+  else if (NULL == mBase)
   {
     ret = eIasAvbProcNotInitialized;
   }
   else
   {
-    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " clear FreeBufferStack and push back all buffer");
-    mFreeBufferStack.clear();
-    for (uint32_t packetIdx = 0u; packetIdx < mPoolSize; packetIdx++)
-    {
-      mFreeBufferStack.push_back( &mBase[packetIdx] );
-    }
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " clear free list and push back all buffers");
+    rebuildFreeList();
   }
 
-  mLock.unlock();
-
   return ret;
 }
 
@@ -423,6 +645,13 @@ IasAvbProcessingResult IasAvbPacketPool::returnPacket(IasAvbPacket* packet)
     {
       IasAvbPacketPool * const home = packet->getHomePool();
       AVB_ASSERT(NULL != home);
+      IasAvbPacketLessee * const lessee = packet->mLessee;
+      if (NULL != lessee)
+      {
+        // leased from the shared arena, give the quota back first; the pool of the stream may be gone already
+        packet->mLessee = NULL;
+        lessee->arena->release(lessee);
+      }
       ret = home->doReturnPacket(packet);
     }
   }
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbPcapFile.cpp
+ * @brief   The definition of the IasAvbPcapFile class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbPcapFile.hpp"
+
+#include <cstring>
+
+namespace IasMediaTransportAvb {
+
+/*
+ * file and record headers as defined by libpcap, fields in the byte order of the writing host
+ */
+struct PcapFileHeader
+{
+  uint32_t magic;
+  uint16_t versionMajor;
+  uint16_t versionMinor;
+  int32_t  thisZone;
+  uint32_t sigFigs;
+  uint32_t snapLength;
+  uint32_t linkType;
+};
+
+struct PcapRecordHeader
+{
+  uint32_t seconds;
+  uint32_t fraction;       // us or ns, depending on the magic number
+  uint32_t capturedLength;
+  uint32_t frameLength;
+};
+
+
+/*
+ *  Constructor.
+ */
+IasAvbPcapFile::IasAvbPcapFile()
+  : mFile(NULL)
+  , mWriting(false)
+  , mSwapped(false)
+  , mNanoseconds(true)
+  , mFrameCount(0u)
+  , mLock()
+{
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbPcapFile::~IasAvbPcapFile()
+{
+  close();
+}
+
+
+IasAvbProcessingResult IasAvbPcapFile::openWrite(const std::string & fileName)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  close();
+
+  mFile = std::fopen(fileName.c_str(), "wb");
+  if (NULL == mFile)
+  {
+    result = eIasAvbProcErr;
+  }
+  else
+  {
+    PcapFileHeader header;
+    header.magic = cMagicNano;
+    header.versionMajor = 2u;
+    header.versionMinor = 4u;
+    header.thisZone = 0;
+    header.sigFigs = 0u;
+    header.snapLength = cSnapLength;
+    header.linkType = cLinkTypeEthernet;
+
+    mWriting = true;
+    mSwapped = false;
+    mNanoseconds = true;
+
+    if (1u != std::fwrite(&header, sizeof header, 1u, mFile))
+    {
+      close();
+      result = eIasAvbProcErr;
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbPcapFile::openRead(const std::string & fileName)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  PcapFileHeader header;
+
+  close();
+
+  mFile = std::fopen(fileName.c_str(), "rb");
+  if (NULL == mFile)
+  {
+    result = eIasAvbProcErr;
+  }
+  else if (1u != std::fread(&header, sizeof header, 1u, mFile))
+  {
+    result = eIasAvbProcUnsupportedFormat;
+  }
+  else
+  {
+    mWriting = false;
+    mSwapped = (cMagicMicro == __builtin_bswap32(header.magic)) || (cMagicNano == __builtin_bswap32(header.magic));
+    mNanoseconds = (cMagicNano == toHost(header.magic));
+
+    if (((cMagicMicro != toHost(header.magic)) && !mNanoseconds) || (cLinkTypeEthernet != toHost(header.linkType)))
+    {
+      result = eIasAvbProcUnsupportedFormat;
+    }
+  }
+
+  if ((eIasAvbProcOK != result) && (NULL != mFile))
+  {
+    close();
+  }
+
+  return result;
+}
+
+
+void IasAvbPcapFile::close()
+{
+  if (NULL != mFile)
+  {
+    (void) std::fclose(mFile);
+    mFile = NULL;
+  }
+  mFrameCount = 0u;
+}
+
+
+IasAvbProcessingResult IasAvbPcapFile::writeFrame(const void * frame, uint32_t length, uint64_t time)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if ((NULL == frame) || (length > cSnapLength))
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    PcapRecordHeader header;
+    header.seconds = uint32_t(time / 1000000000u);
+    header.fraction = uint32_t(time % 1000000000u);
+    header.capturedLength = length;
+    header.frameLength = length;
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if ((NULL == mFile) || !mWriting)
+    {
+      result = eIasAvbProcNotInitialized;
+    }
+    else if ((1u != std::fwrite(&header, sizeof header, 1u, mFile)) ||
+             (length != std::fwrite(frame, 1u, length, mFile)))
+    {
+      result = eIasAvbProcNoSpaceLeft;
+    }
+    else
+    {
+      mFrameCount++;
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbPcapFile::readFrame(void * buffer, uint32_t size, uint32_t & length, uint64_t & time)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  PcapRecordHeader header;
+  size_t headerLength = 0u;
+
+  if (NULL == buffer)
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else if ((NULL == mFile) || mWriting)
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else if (sizeof header != (headerLength = std::fread(&header, 1u, sizeof header, mFile)))
+  {
+    // a partial header is a truncated file
+    result = ((0u == headerLength) && std::feof(mFile)) ? eIasAvbProcOff : eIasAvbProcErr;
+  }
+  else
+  {
+    const uint32_t captured = toHost(header.capturedLength);
+    const uint32_t fraction = toHost(header.fraction);
+
+    length = (captured < size) ? captured : size;
+    time = (uint64_t(toHost(header.seconds)) * 1000000000u) + (mNanoseconds ? fraction : (uint64_t(fraction) * 1000u));
+
+    if ((captured > cSnapLength) ||
+        (length != std::fread(buffer, 1u, length, mFile)) ||
+        ((captured != length) && (0 != std::fseek(mFile, long(captured - length), SEEK_CUR))))
+    {
+      result = eIasAvbProcErr;
+    }
+    else
+    {
+      mFrameCount++;
+    }
+  }
+
+  return result;
+}
+
+} // namespace IasMediaTransportAvb
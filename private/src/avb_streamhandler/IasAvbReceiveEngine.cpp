@@ -19,6 +19,8 @@
 #include "avb_streamhandler/IasAvbClockReferenceStream.hpp"
 #include "avb_streamhandler/IasAvbPacket.hpp"
 #include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPcapFile.hpp"
+#include "avb_streamhandler/IasAvbReceiveRing.hpp"
 #include "avb_streamhandler/IasAvbStreamId.hpp"
 #include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEventInterface.hpp"
@@ -35,6 +37,9 @@
 #include <sys/socket.h>
 
 #include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <linux/if_arp.h>
 #include <linux/if_vlan.h>
 #include <linux/sockios.h>
@@ -46,9 +51,11 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <cstdio>
-#include <sys/select.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 
 #include <limits>
+#include <thread>
 
 #ifndef ETH_P_IEEE1722
 #define ETH_P_IEEE1722 0x22F0
@@ -73,20 +80,27 @@ static const std::string cClassName = "IasAvbReceiveEngine::";
  */
 IasAvbReceiveEngine::IasAvbReceiveEngine()
 : mInstanceName("IasAvbReceiveEngine")
-, mEndThread(false)
 , mReceiveThread(NULL)
+, mWorkers()
+, mNumShards(1u)
+, mStreamTable(NULL)
+, mTableGeneration(0u)
+, mShardGeneration(0u)
 , mLock()
 , mEventInterface(NULL)
 , mReceiveSocket(-1)
-, mReceiveBuffer(NULL)
 , mIgnoreStreamId(false)
 , mLog(&IasAvbStreamHandlerEnvironment::getDltContext("_RXE"))
 , mWatchdog(NULL)
+, mRecorder(NULL)
 #if defined(DIRECT_RX_DMA)
 , mIgbDevice(NULL)
 , mRcvPacketPool(NULL)
 , mPacketList()
 , mRecoverIgbReceiver(true)
+#else
+, mReceiveFilter()
+, mTimestamping(cTimestampOff)
 #endif /* DIRECT_RX_DMA */
 , mRcvPortIfIndex(0)
 {
@@ -132,20 +146,12 @@ IasAvbProcessingResult IasAvbReceiveEngine::init()
       result = eIasAvbProcInitializationFailed;
     }
 
-#if !defined(DIRECT_RX_DMA)
     if (eIasAvbProcOK == result)
     {
-      mReceiveBuffer = new (nothrow) uint8_t[cReceiveBufferSize];
-      if (NULL == mReceiveBuffer)
-      {
-        /**
-         * @log Init failed: Not enough memory to create the buffer.
-         */
-        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create receive buffer!");
-        result = eIasAvbProcInitializationFailed;
-      }
+      result = createWorkers();
     }
-#else
+
+#if defined(DIRECT_RX_DMA)
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxRecoverIgbReceiver, mRecoverIgbReceiver);
     DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Rx IGB Recovery:", mRecoverIgbReceiver ? "on" : "off");
 
@@ -160,6 +166,56 @@ IasAvbProcessingResult IasAvbReceiveEngine::init()
       result = openReceiveSocket();
     }
 
+#if !defined(DIRECT_RX_DMA)
+    if (eIasAvbProcOK == result)
+    {
+      mWorkers[0]->mSocket = mReceiveSocket;
+      result = setupFanout();
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      mTimestamping = cTimestampHardware;
+      (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxTimestamping, mTimestamping);
+      if (mTimestamping > cTimestampHardware)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Invalid receive time stamp mode:", mTimestamping);
+        result = eIasAvbProcInitializationFailed;
+      }
+      else if ((cTimestampHardware == mTimestamping) && !enableHardwareTimestamps())
+      {
+        mTimestamping = cTimestampSoftware;
+      }
+      else
+      {
+        // mode configured is supported
+      }
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "receive time stamps:", (cTimestampOff == mTimestamping) ? "off" :
+          ((cTimestampSoftware == mTimestamping) ? "software" : "hardware"));
+    }
+
+    for (WorkerList::iterator it = mWorkers.begin(); (eIasAvbProcOK == result) && (mWorkers.end() != it); it++)
+    {
+      result = setupReceiveRing(**it);
+      if (eIasAvbProcOK == result)
+      {
+        result = setupEventLoop(**it);
+      }
+      if (eIasAvbProcOK == result)
+      {
+        result = setupTimestamping(**it);
+      }
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      // no streams yet, nothing to receive
+      (void) lock();
+      updateReceiveFilter();
+      (void) unlock();
+    }
+#endif /* !DIRECT_RX_DMA */
+
     if (result == eIasAvbProcOK)
     {
       uint64_t val = 0u;
@@ -196,6 +252,26 @@ IasAvbProcessingResult IasAvbReceiveEngine::init()
       }
     }
 
+    std::string recordFile;
+    if ((eIasAvbProcOK == result) && IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxRecordFile, recordFile))
+    {
+      mRecorder = new (nothrow) IasAvbPcapFile();
+      if (NULL == mRecorder)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create recorder!");
+        result = eIasAvbProcInitializationFailed;
+      }
+      else if (eIasAvbProcOK != mRecorder->openWrite(recordFile))
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create record file", recordFile);
+        result = eIasAvbProcInitializationFailed;
+      }
+      else
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "recording received frames to", recordFile);
+      }
+    }
+
     if (eIasAvbProcOK != result)
     {
       cleanup();
@@ -272,6 +348,23 @@ IasAvbProcessingResult IasAvbReceiveEngine::start()
       {
         result = eIasAvbProcThreadStartFailed;
       }
+
+      for (WorkerList::iterator it = mWorkers.begin(); (eIasAvbProcOK == result) && (mWorkers.end() != it); it++)
+      {
+        if (NULL != (*it)->mThread)
+        {
+          res = (*it)->mThread->start(true);
+          if ((res != IasResult::cOk) && (res != IasThreadResult::cThreadAlreadyStarted))
+          {
+            result = eIasAvbProcThreadStartFailed;
+          }
+        }
+      }
+
+      if (eIasAvbProcOK != result)
+      {
+        (void) stop();
+      }
     }
     else
     {
@@ -312,6 +405,17 @@ IasAvbProcessingResult IasAvbReceiveEngine::stop()
 
   if (NULL != mReceiveThread)
   {
+    for (WorkerList::iterator it = mWorkers.begin(); mWorkers.end() != it; it++)
+    {
+      if ((NULL != (*it)->mThread) && (*it)->mThread->isRunning())
+      {
+        if ((*it)->mThread->stop() != IasResult::cOk)
+        {
+          result = eIasAvbProcThreadStopFailed;
+        }
+      }
+    }
+
     if (mReceiveThread->isRunning())
     {
       if (mReceiveThread->stop() != IasResult::cOk)
@@ -336,6 +440,113 @@ IasAvbProcessingResult IasAvbReceiveEngine::stop()
 }
 
 
+IasAvbProcessingResult IasAvbReceiveEngine::replay(const std::string & fileName, float speed, uint32_t & numFrames)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  IasAvbPcapFile file;
+
+  numFrames = 0u;
+
+  if ((NULL == mReceiveThread) || mWorkers.empty())
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else if (mReceiveThread->isRunning())
+  {
+    // the frames would be processed concurrently with the ones received
+    result = eIasAvbProcAlreadyInUse;
+  }
+  else if (speed < 0.0f)
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    result = file.openRead(fileName);
+    if (eIasAvbProcOK != result)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "can't open", fileName, "error:", int32_t(result));
+    }
+  }
+
+  if (eIasAvbProcOK == result)
+  {
+    Worker & worker = *mWorkers[0];
+    FrameContext context;
+    uint32_t idleWait = 0u;
+    uint32_t length = 0u;
+    uint64_t time = 0u;
+    uint64_t firstTime = 0u;
+    uint64_t lastTime = 0u;
+    struct timespec start;
+
+    initFrameContext(worker, context, idleWait);
+    // all frames are processed here, no other worker is going to take the unknown streams
+    context.watchdog = NULL;
+    context.handleWildcard = true;
+    worker.mReplay = true;
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "replaying", fileName, "speed:", speed);
+
+    while (eIasAvbProcOK == (result = file.readFrame(worker.mReceiveBuffer, uint32_t(cReceiveBufferSize), length, time)))
+    {
+      if (0u == numFrames)
+      {
+        firstTime = time;
+        (void) worker.mTimeoutWheel.init(cTimeoutTick, time);
+        worker.mTimeoutGeneration = 0u;
+        worker.mClaimed = false;
+      }
+      else if (time < lastTime)
+      {
+        // frames out of order, e.g. recorded by several workers, are processed right away, time doesn't go back
+        time = lastTime;
+      }
+      else
+      {
+        // in order
+      }
+      lastTime = time;
+
+      if (speed > 0.0f)
+      {
+        const uint64_t due = IasLibPtpDaemon::convertTimespecToNs(start) + uint64_t(double(time - firstTime) / double(speed));
+        struct timespec wakeup;
+        wakeup.tv_sec = time_t(due / 1000000000u);
+        wakeup.tv_nsec = long(due % 1000000000u);
+        while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL))
+        {
+        }
+      }
+
+      // the time stamps of the file are used as current time, so the result does not depend on the pacing
+      IasAvbRxStreamTable * table = beginRead(worker);
+      processTimeouts(worker, table, time, context.timeout);
+      processFrame(worker, table, worker.mReceiveBuffer, int32_t(length), time, time, context);
+      endRead(worker);
+
+      numFrames++;
+    }
+
+    worker.mReplay = false;
+    worker.mShardGeneration = std::numeric_limits<uint64_t>::max();
+
+    if (eIasAvbProcOff == result)
+    {
+      // end of file
+      result = eIasAvbProcOK;
+    }
+
+    DLT_LOG_CXX(*mLog, (eIasAvbProcOK == result) ? DLT_LOG_INFO : DLT_LOG_ERROR, LOG_PREFIX, "replayed", numFrames,
+        "frames,", context.packetsReceived, "AVTP,", context.packetsDispatched, "dispatched,", context.packetsValid,
+        "valid,", context.packetsDiscarded, "discarded, result:", int32_t(result));
+  }
+
+  return result;
+}
+
+
 IasAvbProcessingResult IasAvbReceiveEngine::checkStreamIdInUse(const IasAvbStreamId & avbStreamId) const
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
@@ -374,14 +585,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveAudioStream(IasAvbSrCla
 
       if (eIasAvbProcOK == result)
       {
-        // add stream to vector
-        StreamData data;
-        data.stream = newAudioStream;
-        data.lastState = newAudioStream->getStreamState();
-        data.lastTimeDispatched = 0u;
-        (void) lock();
-        mAvbStreams[streamId] = data;
-        (void) unlock();
+        result = addStream(streamId, newAudioStream);
+        if (eIasAvbProcOK != result)
+        {
+          delete newAudioStream;
+        }
       }
       else
       {
@@ -406,11 +614,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveAudioStream(IasAvbSrCla
        * just to be safe. Because it internally calls unbindMcastAddr() which
        * might decrease the mac's ref counter despite of the failure of binding.
        */
-      (void) lock();
-      IasAvbStream *avbStream = mAvbStreams[streamId].stream;
-      mAvbStreams.erase(streamId);
-      delete avbStream;
-      (void) unlock();
+      IasAvbStream *avbStream = NULL;
+      if (eIasAvbProcOK == removeStream(streamId, avbStream))
+      {
+        delete avbStream;
+      }
     }
   }
 
@@ -439,14 +647,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveVideoStream(IasAvbSrCla
 
       if (eIasAvbProcOK == result)
       {
-        // add stream to vector
-        StreamData data;
-        data.stream = newVideoStream;
-        data.lastState = newVideoStream->getStreamState();
-        data.lastTimeDispatched = 0u;
-        (void) lock();
-        mAvbStreams[streamId] = data;
-        (void) unlock();
+        result = addStream(streamId, newVideoStream);
+        if (eIasAvbProcOK != result)
+        {
+          delete newVideoStream;
+        }
       }
       else
       {
@@ -469,11 +674,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveVideoStream(IasAvbSrCla
     result = bindMcastAddr(destMacAddr);
     if (eIasAvbProcOK != result)
     {
-      (void) lock();
-      IasAvbStream *avbStream = mAvbStreams[streamId].stream;
-      mAvbStreams.erase(streamId);
-      delete avbStream;
-      (void) unlock();
+      IasAvbStream *avbStream = NULL;
+      if (eIasAvbProcOK == removeStream(streamId, avbStream))
+      {
+        delete avbStream;
+      }
     }
   }
 
@@ -500,14 +705,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveClockReferenceStream(Ia
 
       if (eIasAvbProcOK == result)
       {
-        // add stream to vector
-        StreamData data;
-        data.stream = newStream;
-        data.lastState = newStream->getStreamState();
-        data.lastTimeDispatched = 0u;
-        (void) lock();
-        mAvbStreams[streamId] = data;
-        (void) unlock();
+        result = addStream(streamId, newStream);
+        if (eIasAvbProcOK != result)
+        {
+          delete newStream;
+        }
       }
       else
       {
@@ -527,11 +729,11 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveClockReferenceStream(Ia
     result = bindMcastAddr(destMacAddr);
     if (eIasAvbProcOK != result)
     {
-      (void) lock();
-      IasAvbStream *avbStream = mAvbStreams[streamId].stream;
-      mAvbStreams.erase(streamId);
-      delete avbStream;
-      (void) unlock();
+      IasAvbStream *avbStream = NULL;
+      if (eIasAvbProcOK == removeStream(streamId, avbStream))
+      {
+        delete avbStream;
+      }
     }
   }
 
@@ -541,141 +743,330 @@ IasAvbProcessingResult IasAvbReceiveEngine::createReceiveClockReferenceStream(Ia
 
 IasAvbProcessingResult IasAvbReceiveEngine::destroyAvbStream(IasAvbStreamId const & streamId)
 {
-  IasAvbProcessingResult result = eIasAvbProcOK;
-  (void) lock();
-  AvbStreamMap::iterator it = mAvbStreams.find(streamId);
+  IasAvbStream *avbStream = NULL;
+  IasAvbProcessingResult result = removeStream(streamId, avbStream);
 
-  if (it == mAvbStreams.end())
-  {
-    result = eIasAvbProcInvalidParam;
-  }
-  else
+  if (eIasAvbProcOK == result)
   {
-    IasAvbStream *avbStream = it->second.stream;
-
-    mAvbStreams.erase(streamId);
-
     (void) unbindMcastAddr(avbStream->getDmac());
 
     delete avbStream;
   }
 
-  (void) unlock();
   return result;
 }
 
 
-IasAvbProcessingResult IasAvbReceiveEngine::connectAudioStreams(const IasAvbStreamId & avbStreamId, IasLocalAudioStream * localStream)
+IasAvbProcessingResult IasAvbReceiveEngine::addStream(const IasAvbStreamId & streamId, IasAvbStream * stream)
 {
-  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
-
-  /*
-   * Should we hold the lock here to access mAvbStreams? No, because ApiLock guarantees that
-   * concurrent API calls must not happen, we can trust mAvbStreams does not change while
-   * connectAudioStreams() API is being served. i.e. destroyStream cannot be served in parallel.
-   * It is applicable to connectVideoStreams, disconnectStreams and getAvbStreamInfo as well.
-   * Also getStreamById and isValidStreamId do not need locking because they are called only
-   * at the init phase before either RX engine or IPC thread starts up.
-   */
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  IasAvbRxStreamTable * oldTable = NULL;
 
-  // look-up AVB stream using the specified AVB stream id
-  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
-  if (it != mAvbStreams.end())
+  AVB_ASSERT(NULL != stream);
+  StreamData * data = new (nothrow) StreamData;
+  if (NULL == data)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Not enough memory to add stream!");
+    result = eIasAvbProcNotEnoughMemory;
+  }
+  else
   {
-    AVB_ASSERT(NULL != it->second.stream);
+    data->stream = stream;
+    data->lastState = stream->getStreamState();
+    data->lastTimeDispatched = 0u;
 
-    // if AVB stream has been found, hand-over instance of local
-    // audio stream to the AVB audio stream so they can connect
-    if (eIasAvbAudioStream == it->second.stream->getStreamType())
+    (void) lock();
+    mAvbStreams[streamId] = data;
+    result = updateStreamTable(oldTable);
+    if (eIasAvbProcOK != result)
     {
-      result = static_cast<IasAvbAudioStream*>(it->second.stream)->connectTo(localStream);
+      mAvbStreams.erase(streamId);
+      delete data;
     }
-    else
+    (void) unlock();
+
+    if (eIasAvbProcOK == result)
     {
-      /**
-       * @log The StreamId parameter provided does not have a AudioStream type.
-       */
-      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbAudioStream");
+      waitForReaders();
+      delete oldTable;
     }
   }
-  else // no stream has been found related to specified stream id
-  {
-    /**
-     * @log The StreamId parameter provided can not be found in the AvbStream list.
-     */
-    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Could not connect since AVB stream could not be found!");
-  }
 
   return result;
 }
 
 
-IasAvbProcessingResult IasAvbReceiveEngine::connectVideoStreams(const IasAvbStreamId & avbStreamId, IasLocalVideoStream * localStream)
+IasAvbProcessingResult IasAvbReceiveEngine::removeStream(const IasAvbStreamId & streamId, IasAvbStream * &stream)
 {
-  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  IasAvbRxStreamTable * oldTable = NULL;
+  StreamData * data = NULL;
 
-  // look-up AVB stream using the specified AVB stream id
-  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
-  if (it != mAvbStreams.end())
+  (void) lock();
+  AvbStreamMap::iterator it = mAvbStreams.find(streamId);
+
+  if (it == mAvbStreams.end())
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
   {
-    AVB_ASSERT(NULL != it->second.stream);
+    data = it->second;
+    mAvbStreams.erase(it);
 
-    // if AVB stream has been found, hand-over instance of local
-    // audio stream to the AVB audio stream so they can connect
-    if (eIasAvbVideoStream == it->second.stream->getStreamType())
-    {
-      result = static_cast<IasAvbVideoStream*>(it->second.stream)->connectTo(localStream);
-    }
-    else
+    result = updateStreamTable(oldTable);
+    if (eIasAvbProcOK != result)
     {
-      /**
-       * @log The StreamId parameter provided does not have a VideoStream type.
-       */
-      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbVideoStream");
+      mAvbStreams[streamId] = data;
     }
   }
-  else // no stream has been found related to specified stream id
+  (void) unlock();
+
+  if (eIasAvbProcOK == result)
   {
-    /**
-     * @log The StreamId parameter provided can not be found in the AvbStream list.
-     */
-    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Could not connect since AVB stream could not be found!");
+    // the receive thread may still be dispatching to the stream through the old table
+    waitForReaders();
+    delete oldTable;
+
+    AVB_ASSERT(NULL != data);
+    stream = data->stream;
+    delete data;
   }
 
   return result;
 }
 
 
-IasAvbProcessingResult IasAvbReceiveEngine::disconnectStreams(const IasAvbStreamId & avbStreamId)
+IasAvbProcessingResult IasAvbReceiveEngine::updateStreamTable(IasAvbRxStreamTable * &oldTable)
 {
   IasAvbProcessingResult result = eIasAvbProcOK;
 
-  // look-up AVB stream using the specified AVB stream id
-  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
-  if (it != mAvbStreams.end())
+  IasAvbRxStreamTable * newTable = new (nothrow) IasAvbRxStreamTable();
+  if (NULL == newTable)
+  {
+    result = eIasAvbProcNotEnoughMemory;
+  }
+  else
   {
-    AVB_ASSERT(NULL != it->second.stream);
+    result = newTable->init(uint32_t(mAvbStreams.size()));
+    for (AvbStreamMap::iterator it = mAvbStreams.begin(); (eIasAvbProcOK == result) && (mAvbStreams.end() != it); it++)
+    {
+      result = newTable->insert(uint64_t(it->first), it->second);
+    }
 
-    // if AVB stream has been found, check type and connect to NULL to disconnect,
-    // else return error.
-    IasAvbStreamType streamType = it->second.stream->getStreamType();
-    if (eIasAvbVideoStream == streamType)
+#if !defined(DIRECT_RX_DMA)
+    const uint32_t numWorkers = uint32_t(mWorkers.size());
+    const uint32_t numShards = (mAvbStreams.end() != mAvbStreams.find(IasAvbStreamId(uint64_t(0u)))) ? 1u : numWorkers;
+    if ((eIasAvbProcOK == result) && (numWorkers > 1u) && (numShards != mNumShards.load()))
     {
-      result = static_cast<IasAvbVideoStream*>(it->second.stream)->connectTo(NULL);
+      /*
+       * The fanout program can't tell known from unknown stream IDs, so while there is a wildcard
+       * stream, worker 0 gets all packets. The table published carries the new sharding, the workers
+       * hand over the streams as soon as all of them have seen it, see processTimeouts().
+       */
+      result = setFanoutProgram(numShards);
+      if (eIasAvbProcOK == result)
+      {
+        mNumShards = numShards;
+        mShardGeneration = mTableGeneration + 1u;
+        DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "packets distributed to", numShards, "receive workers",
+            (1u == numShards) ? "while a wildcard stream exists" : "");
+      }
     }
-    else if (eIasAvbAudioStream == streamType)
+#endif /* !DIRECT_RX_DMA */
+
+    if (eIasAvbProcOK == result)
     {
-      result = static_cast<IasAvbAudioStream*>(it->second.stream)->connectTo(NULL);
+      newTable->setGeneration(++mTableGeneration);
+      newTable->setSharding(mNumShards.load(), mShardGeneration);
+      oldTable = mStreamTable.exchange(newTable);
+#if !defined(DIRECT_RX_DMA)
+      updateReceiveFilter();
+#endif /* !DIRECT_RX_DMA */
     }
     else
     {
-      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX,
-        "Wrong type! AvbStreamId does not correspond to an AvbVideo or AvbAudio stream.");
-
-      result = eIasAvbProcInvalidParam;
+      delete newTable;
     }
   }
-  else
+
+  if (eIasAvbProcOK != result)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't build stream table! Error=", int32_t(result));
+  }
+
+  return result;
+}
+
+
+void IasAvbReceiveEngine::waitForReaders(const Worker * self) const
+{
+  for (WorkerList::const_iterator it = mWorkers.begin(); mWorkers.end() != it; it++)
+  {
+    const uint32_t seq = (*it)->mReadSeq.load();
+
+    if ((self != *it) && (0u != (seq & 1u)))
+    {
+      // read sections are short, they never wait for anything but other read sections to end
+      while (seq == (*it)->mReadSeq.load())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+
+void IasAvbReceiveEngine::promoteWildcardStream(Worker & worker, IasAvbRxStreamTable * &table,
+                                                const IasAvbStreamId & wildcardId, const IasAvbStreamId & streamId)
+{
+  if (mLock.try_lock())
+  {
+    AvbStreamMap::iterator it = mAvbStreams.find(wildcardId);
+
+    if ((mAvbStreams.end() != it) && (mAvbStreams.end() == mAvbStreams.find(streamId)))
+    {
+      StreamData * data = it->second;
+      IasAvbRxStreamTable * oldTable = NULL;
+
+      mAvbStreams.erase(it);
+      mAvbStreams[streamId] = data;
+
+      if (eIasAvbProcOK == updateStreamTable(oldTable))
+      {
+        /*
+         * The table replaced is either the one the worker is using, or one published by an API call
+         * in the meantime which it has never seen. The table the API call replaced is deleted by
+         * the API call itself. The other workers might still use the table replaced. They never
+         * wait for this worker while in a read section, as they don't get the lock.
+         */
+        waitForReaders(&worker);
+        delete oldTable;
+        table = mStreamTable.load();
+      }
+      else
+      {
+        mAvbStreams.erase(streamId);
+        mAvbStreams[wildcardId] = data;
+      }
+    }
+
+    (void) mLock.unlock();
+  }
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::connectAudioStreams(const IasAvbStreamId & avbStreamId, IasLocalAudioStream * localStream)
+{
+  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+
+  /*
+   * Should we hold the lock here to access mAvbStreams? No, because ApiLock guarantees that
+   * concurrent API calls must not happen, we can trust mAvbStreams does not change while
+   * connectAudioStreams() API is being served. i.e. destroyStream cannot be served in parallel.
+   * It is applicable to connectVideoStreams, disconnectStreams and getAvbStreamInfo as well.
+   * Also getStreamById and isValidStreamId do not need locking because they are called only
+   * at the init phase before either RX engine or IPC thread starts up.
+   */
+
+  // look-up AVB stream using the specified AVB stream id
+  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
+  if (it != mAvbStreams.end())
+  {
+    AVB_ASSERT(NULL != it->second->stream);
+
+    // if AVB stream has been found, hand-over instance of local
+    // audio stream to the AVB audio stream so they can connect
+    if (eIasAvbAudioStream == it->second->stream->getStreamType())
+    {
+      result = static_cast<IasAvbAudioStream*>(it->second->stream)->connectTo(localStream);
+    }
+    else
+    {
+      /**
+       * @log The StreamId parameter provided does not have a AudioStream type.
+       */
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbAudioStream");
+    }
+  }
+  else // no stream has been found related to specified stream id
+  {
+    /**
+     * @log The StreamId parameter provided can not be found in the AvbStream list.
+     */
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Could not connect since AVB stream could not be found!");
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::connectVideoStreams(const IasAvbStreamId & avbStreamId, IasLocalVideoStream * localStream)
+{
+  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+
+  // look-up AVB stream using the specified AVB stream id
+  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
+  if (it != mAvbStreams.end())
+  {
+    AVB_ASSERT(NULL != it->second->stream);
+
+    // if AVB stream has been found, hand-over instance of local
+    // audio stream to the AVB audio stream so they can connect
+    if (eIasAvbVideoStream == it->second->stream->getStreamType())
+    {
+      result = static_cast<IasAvbVideoStream*>(it->second->stream)->connectTo(localStream);
+    }
+    else
+    {
+      /**
+       * @log The StreamId parameter provided does not have a VideoStream type.
+       */
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbVideoStream");
+    }
+  }
+  else // no stream has been found related to specified stream id
+  {
+    /**
+     * @log The StreamId parameter provided can not be found in the AvbStream list.
+     */
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Could not connect since AVB stream could not be found!");
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::disconnectStreams(const IasAvbStreamId & avbStreamId)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  // look-up AVB stream using the specified AVB stream id
+  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
+  if (it != mAvbStreams.end())
+  {
+    AVB_ASSERT(NULL != it->second->stream);
+
+    // if AVB stream has been found, check type and connect to NULL to disconnect,
+    // else return error.
+    IasAvbStreamType streamType = it->second->stream->getStreamType();
+    if (eIasAvbVideoStream == streamType)
+    {
+      result = static_cast<IasAvbVideoStream*>(it->second->stream)->connectTo(NULL);
+    }
+    else if (eIasAvbAudioStream == streamType)
+    {
+      result = static_cast<IasAvbAudioStream*>(it->second->stream)->connectTo(NULL);
+    }
+    else
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX,
+        "Wrong type! AvbStreamId does not correspond to an AvbVideo or AvbAudio stream.");
+
+      result = eIasAvbProcInvalidParam;
+    }
+  }
+  else
   {
     uint64_t sid = avbStreamId;
     DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Invalid streamId", sid);
@@ -687,11 +1078,42 @@ IasAvbProcessingResult IasAvbReceiveEngine::disconnectStreams(const IasAvbStream
 }
 
 
+IasAvbProcessingResult IasAvbReceiveEngine::setChannelRouting(const IasAvbStreamId & avbStreamId, const ChannelRoutingList & routing)
+{
+  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+
+  // look-up AVB stream using the specified AVB stream id
+  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
+  if (it != mAvbStreams.end())
+  {
+    AVB_ASSERT(NULL != it->second->stream);
+
+    if (eIasAvbAudioStream == it->second->stream->getStreamType())
+    {
+      result = static_cast<IasAvbAudioStream*>(it->second->stream)->setChannelRouting(routing);
+    }
+    else
+    {
+      /**
+       * @log The StreamId parameter provided does not have a AudioStream type.
+       */
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbAudioStream");
+    }
+  }
+  else
+  {
+    uint64_t sid = avbStreamId;
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Invalid streamId", sid);
+  }
+
+  return result;
+}
+
+
 IasResult IasAvbReceiveEngine::shutDown()
 {
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
-  mEndThread = true;
-  return IasResult::cOk;
+  return mWorkers.empty() ? IasResult::cOk : mWorkers[0]->shutDown();
 }
 
 
@@ -705,11 +1127,179 @@ IasResult IasAvbReceiveEngine::afterRun()
 IasResult IasAvbReceiveEngine::beforeRun()
 {
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  return mWorkers.empty() ? IasResult::cNotInitialized : mWorkers[0]->beforeRun();
+}
+
+
+IasResult IasAvbReceiveEngine::run()
+{
+  AVB_ASSERT(!mWorkers.empty());
+  return receive(*mWorkers[0]);
+}
+
+
+IasAvbReceiveEngine::Worker::Worker(IasAvbReceiveEngine & engine, uint32_t index)
+  : mEngine(engine)
+  , mIndex(index)
+  , mEndThread(false)
+  , mThread(NULL)
+  , mCpu(-1)
+  , mReadSeq(0u)
+  , mTimeoutWheel()
+  , mTimeoutGeneration(0u)
+  , mClaimed(false)
+  , mShardGeneration(std::numeric_limits<uint64_t>::max())
+  , mReplay(false)
+  , mReceiveBuffer(NULL)
+#if !defined(DIRECT_RX_DMA)
+  , mSocket(-1)
+  , mReceiveRing(NULL)
+  , mEpollFd(-1)
+  , mTimerFd(-1)
+  , mTimerExpiry(0u)
+#endif /* !DIRECT_RX_DMA */
+{
+}
+
+
+IasAvbReceiveEngine::Worker::~Worker()
+{
+  if ((NULL != mThread) && mThread->isRunning())
+  {
+    mThread->stop();
+  }
+  delete mThread;
+  mThread = NULL;
+
+#if !defined(DIRECT_RX_DMA)
+  // in direct DMA mode the buffer points into the packet pool
+  delete[] mReceiveBuffer;
+
+  delete mReceiveRing;
+  mReceiveRing = NULL;
+
+  closeEventLoop(*this);
+
+  if ((0u != mIndex) && (-1 != mSocket))
+  {
+    (void) close(mSocket);
+  }
+  mSocket = -1;
+#endif /* !DIRECT_RX_DMA */
+  mReceiveBuffer = NULL;
+}
+
+
+IasResult IasAvbReceiveEngine::Worker::beforeRun()
+{
   mEndThread = false;
   return IasResult::cOk;
 }
 
 
+IasResult IasAvbReceiveEngine::Worker::run()
+{
+  return mEngine.receive(*this);
+}
+
+
+IasResult IasAvbReceiveEngine::Worker::shutDown()
+{
+  mEndThread = true;
+  return IasResult::cOk;
+}
+
+
+IasResult IasAvbReceiveEngine::Worker::afterRun()
+{
+  return IasResult::cOk;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::createWorkers()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  uint32_t numWorkers = 1u;
+
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxWorkers, numWorkers);
+
+#if defined(DIRECT_RX_DMA)
+  if (numWorkers > 1u)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "direct RX DMA uses a single receive queue, ignoring",
+        IasRegKeys::cRxWorkers, "=", numWorkers);
+  }
+  numWorkers = 1u;
+#else
+  if (mIgnoreStreamId && (numWorkers > 1u))
+  {
+    // streams are distributed by ID, which is just what the ignore mode doesn't care about
+    DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "ignore stream ID mode needs a single receive thread");
+    numWorkers = 1u;
+  }
+#endif /* DIRECT_RX_DMA */
+
+  if ((0u == numWorkers) || (numWorkers > cMaxWorkers))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "invalid number of receive workers:", numWorkers);
+    result = eIasAvbProcInitializationFailed;
+  }
+
+  for (uint32_t idx = 0u; (eIasAvbProcOK == result) && (idx < numWorkers); idx++)
+  {
+    Worker * worker = new (nothrow) Worker(*this, idx);
+    if (NULL == worker)
+    {
+      result = eIasAvbProcInitializationFailed;
+    }
+    else
+    {
+      mWorkers.push_back(worker);
+
+      uint64_t cpu = uint64_t(-1);
+      if (IasAvbStreamHandlerEnvironment::getConfigValue(std::string(IasRegKeys::cRxWorkerCpu) + std::to_string(idx), cpu))
+      {
+        worker->mCpu = int32_t(cpu);
+      }
+
+      if (0u != idx)
+      {
+        worker->mThread = new (nothrow) IasThread(worker, std::string("AvbRxWrk") + std::to_string(idx));
+        if (NULL == worker->mThread)
+        {
+          result = eIasAvbProcInitializationFailed;
+        }
+      }
+
+#if !defined(DIRECT_RX_DMA)
+      if (eIasAvbProcOK == result)
+      {
+        worker->mReceiveBuffer = new (nothrow) uint8_t[cReceiveBufferSize];
+        if (NULL == worker->mReceiveBuffer)
+        {
+          result = eIasAvbProcInitializationFailed;
+        }
+      }
+#endif /* !DIRECT_RX_DMA */
+    }
+  }
+
+  if (eIasAvbProcOK != result)
+  {
+    /**
+     * @log Init failed: Not enough memory to create the receive workers.
+     */
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create receive workers!");
+  }
+  else
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "receive workers:", numWorkers);
+  }
+
+  return result;
+}
+
+
 IasAvbProcessingResult IasAvbReceiveEngine::openReceiveSocket()
 {
   IasAvbProcessingResult result = eIasAvbProcOK;
@@ -863,32 +1453,493 @@ IasAvbProcessingResult IasAvbReceiveEngine::openReceiveSocket()
     }
   }
 
-  if (eIasAvbProcOK != result)
+  if (eIasAvbProcOK != result)
+  {
+    closeSocket();
+  }
+
+  return result;
+}
+
+
+#if !defined(DIRECT_RX_DMA)
+IasAvbProcessingResult IasAvbReceiveEngine::setupFanout()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  const uint32_t numWorkers = uint32_t(mWorkers.size());
+
+  if (numWorkers > 1u)
+  {
+    typedef int Int; // avoid complaints about naked fundamental types
+    Int bufSize = 0;
+    const bool setBufSize = IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxSocketRxBufSize, bufSize);
+
+    // the group ID has to be unique within the system, several stream handler instances may be running
+    const Int fanout = Int(uint32_t(getpid()) & 0xFFFFu) | (PACKET_FANOUT_CBPF << 16);
+
+    for (uint32_t idx = 0u; (eIasAvbProcOK == result) && (idx < numWorkers); idx++)
+    {
+      Worker & worker = *mWorkers[idx];
+
+      if (0u != idx)
+      {
+        // the members of a fanout group have to be bound to the same interface and protocol
+        struct sockaddr_ll recv_sa;
+        memset(&recv_sa, 0, sizeof recv_sa);
+        recv_sa.sll_family = AF_PACKET;
+        recv_sa.sll_ifindex = mRcvPortIfIndex;
+        recv_sa.sll_protocol = htons(ETH_P_IEEE1722);
+
+        worker.mSocket = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_IEEE1722));
+        if ((worker.mSocket < 0) ||
+            (setBufSize && (setsockopt(worker.mSocket, SOL_SOCKET, SO_RCVBUFFORCE, &bufSize, sizeof bufSize) < 0)) ||
+            (bind(worker.mSocket, reinterpret_cast<sockaddr*>(&recv_sa), sizeof recv_sa) < 0))
+        {
+          DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't open socket of receive worker", idx, "(",
+              int32_t(errno), ",", strerror(errno), ")");
+          result = eIasAvbProcInitializationFailed;
+        }
+      }
+
+      if ((eIasAvbProcOK == result) && (setsockopt(worker.mSocket, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof fanout) < 0))
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't join fanout group (", int32_t(errno), ",",
+            strerror(errno), ")");
+        result = eIasAvbProcInitializationFailed;
+      }
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      result = setFanoutProgram(numWorkers);
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      mNumShards = numWorkers;
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "packets distributed to", numWorkers, "receive workers");
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::setFanoutProgram(uint32_t numShards)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  /*
+   * Select the socket by the stream ID, same as getShard(). The kernel runs the program on the
+   * network header, i.e. the AVTP header, with the VLAN tag already removed. The kernel takes the
+   * result modulo the number of sockets again, and packets too short to hold a stream ID go to
+   * the first socket.
+   */
+  struct sock_filter hash[] = {
+    BPF_STMT(BPF_LD  | BPF_W   | BPF_ABS, uint32_t(SKF_NET_OFF) + 4u),  // A = upper half of stream ID
+    BPF_STMT(BPF_MISC | BPF_TAX, 0u),                                    // X = A
+    BPF_STMT(BPF_LD  | BPF_W   | BPF_ABS, uint32_t(SKF_NET_OFF) + 8u),  // A = lower half of stream ID
+    BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0u),                             // A ^= X
+    BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, numShards),                      // A %= number of workers
+    BPF_STMT(BPF_RET | BPF_A, 0u)
+  };
+  struct sock_filter first[] = {
+    BPF_STMT(BPF_RET | BPF_K, 0u)                                        // all packets to worker 0
+  };
+  struct sock_fprog prog;
+  if (numShards > 1u)
+  {
+    prog.len = sizeof hash / sizeof hash[0];
+    prog.filter = hash;
+  }
+  else
+  {
+    prog.len = sizeof first / sizeof first[0];
+    prog.filter = first;
+  }
+
+  if (setsockopt(mReceiveSocket, SOL_PACKET, PACKET_FANOUT_DATA, &prog, sizeof prog) < 0)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't set fanout program (", int32_t(errno), ",",
+        strerror(errno), ")");
+    result = eIasAvbProcInitializationFailed;
+  }
+
+  return result;
+}
+
+
+void IasAvbReceiveEngine::updateReceiveFilter()
+{
+  if (!mIgnoreStreamId)
+  {
+    IasAvbProcessingResult result = eIasAvbProcOK;
+
+    mReceiveFilter.clear();
+    for (AvbStreamMap::const_iterator it = mAvbStreams.begin(); mAvbStreams.end() != it; it++)
+    {
+      if (0u == uint64_t(it->first))
+      {
+        AVB_ASSERT((NULL != it->second) && (NULL != it->second->stream));
+        mReceiveFilter.addWildcard(it->second->stream->getDmac());
+      }
+      else
+      {
+        mReceiveFilter.addStream(uint64_t(it->first));
+      }
+    }
+
+    result = mReceiveFilter.build();
+    for (WorkerList::const_iterator it = mWorkers.begin(); (eIasAvbProcOK == result) && (mWorkers.end() != it); it++)
+    {
+      result = mReceiveFilter.attach((*it)->mSocket);
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "receive filter updated, streams:", uint32_t(mAvbStreams.size()),
+          "instructions:", mReceiveFilter.getLength());
+    }
+    else
+    {
+      // better receive too much than miss packets of a stream
+      DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "Couldn't set receive filter, receiving all packets (",
+          int32_t(result), ",", int32_t(errno), ")");
+      for (WorkerList::const_iterator it = mWorkers.begin(); mWorkers.end() != it; it++)
+      {
+        (void) IasAvbReceiveFilter::detach((*it)->mSocket);
+      }
+    }
+  }
+}
+
+
+bool IasAvbReceiveEngine::enableHardwareTimestamps()
+{
+  bool enabled = false;
+  const std::string* recvport = IasAvbStreamHandlerEnvironment::getNetworkInterfaceName();
+  struct hwtstamp_config config;
+  struct ifreq ifr;
+
+  std::memset(&config, 0, sizeof config);
+  std::memset(&ifr, 0, sizeof ifr);
+  if (NULL != recvport)
+  {
+    strncpy(ifr.ifr_name, recvport->c_str(), (sizeof ifr.ifr_name) - 1u);
+  }
+  ifr.ifr_data = reinterpret_cast<char*>(&config);
+
+  // the PTP daemon configures the interface as well, so only change what's needed and only if it can be read back
+  if ((NULL != recvport) && (ioctl(mReceiveSocket, SIOCGHWTSTAMP, &ifr) >= 0))
+  {
+    if (HWTSTAMP_FILTER_ALL != config.rx_filter)
+    {
+      // time stamping all packets includes the PTP packets the daemon needs
+      config.rx_filter = HWTSTAMP_FILTER_ALL;
+      if (ioctl(mReceiveSocket, SIOCSHWTSTAMP, &ifr) < 0)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "Interface can't time stamp all packets (", int32_t(errno), ",",
+            strerror(errno), ")");
+        config.rx_filter = HWTSTAMP_FILTER_NONE;
+      }
+    }
+
+    enabled = (HWTSTAMP_FILTER_ALL == config.rx_filter);
+  }
+
+  return enabled;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::setupTimestamping(Worker & worker)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (cTimestampOff != mTimestamping)
+  {
+    typedef int Int; // avoid complaints about naked fundamental types
+    Int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    Int ringFlags = 0;
+
+    if (cTimestampHardware == mTimestamping)
+    {
+      flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+      ringFlags = SOF_TIMESTAMPING_RAW_HARDWARE;
+    }
+
+    // the ring always carries a time stamp, software unless told otherwise
+    if ((setsockopt(worker.mSocket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof flags) < 0) ||
+        ((0 != ringFlags) && (setsockopt(worker.mSocket, SOL_PACKET, PACKET_TIMESTAMP, &ringFlags, sizeof ringFlags) < 0)))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't enable receive time stamps (", int32_t(errno), ",",
+          strerror(errno), ")");
+      result = eIasAvbProcInitializationFailed;
+    }
+  }
+
+  return result;
+}
+
+
+int32_t IasAvbReceiveEngine::receiveFrame(Worker & worker, uint64_t & kernelTime, bool & hardware)
+{
+  int32_t length = -1;
+
+  kernelTime = 0u;
+  hardware = false;
+
+  if (cTimestampOff == mTimestamping)
+  {
+    length = static_cast<int32_t>(recvfrom(worker.mSocket, worker.mReceiveBuffer, cReceiveBufferSize, MSG_DONTWAIT, NULL, NULL));
+  }
+  else
+  {
+    union
+    {
+      struct cmsghdr align;
+      uint8_t buf[CMSG_SPACE(sizeof(struct scm_timestamping))];
+    } control;
+    struct iovec iov;
+    struct msghdr msg;
+
+    iov.iov_base = worker.mReceiveBuffer;
+    iov.iov_len = cReceiveBufferSize;
+    std::memset(&msg, 0, sizeof msg);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1u;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof control.buf;
+
+    length = static_cast<int32_t>(recvmsg(worker.mSocket, &msg, MSG_DONTWAIT));
+
+    for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); (length >= 0) && (NULL != cmsg); cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if ((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMPING == cmsg->cmsg_type))
+      {
+        // ts[0] is the software time stamp, ts[2] the hardware one, zero if not available
+        struct scm_timestamping stamps;
+        std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof stamps);
+
+        hardware = (0 != stamps.ts[2].tv_sec) || (0 != stamps.ts[2].tv_nsec);
+        kernelTime = IasLibPtpDaemon::convertTimespecToNs(stamps.ts[hardware ? 2 : 0]);
+      }
+    }
+  }
+
+  return length;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::setupReceiveRing(Worker & worker)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  uint32_t blocks = 0u;
+
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxRingBlocks, blocks);
+
+  if ((0u != blocks) && (NULL == worker.mReceiveRing))
+  {
+    uint32_t blockSize = cRingBlockSizeDefault;
+    uint32_t timeout = 1u; // ms
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxRingBlockSize, blockSize);
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxRingTimeout, timeout);
+
+    worker.mReceiveRing = new (nothrow) IasAvbReceiveRing(*mLog);
+    if (NULL == worker.mReceiveRing)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create receive ring!");
+      result = eIasAvbProcNotEnoughMemory;
+    }
+    else
+    {
+      result = worker.mReceiveRing->init(worker.mSocket, blockSize, blocks, timeout);
+      if (eIasAvbProcOK != result)
+      {
+        delete worker.mReceiveRing;
+        worker.mReceiveRing = NULL;
+      }
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveEngine::setupEventLoop(Worker & worker)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (-1 == worker.mEpollFd)
+  {
+    worker.mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    worker.mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    worker.mTimerExpiry = 0u;
+
+    if ((worker.mEpollFd < 0) || (worker.mTimerFd < 0))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create epoll instance or timer (",
+          int32_t(errno), ", ", strerror(errno), ")");
+      result = eIasAvbProcInitializationFailed;
+    }
+    else
+    {
+      struct epoll_event event;
+      std::memset(&event, 0, sizeof event);
+      event.events = EPOLLIN;
+      event.data.fd = worker.mSocket;
+
+      if (epoll_ctl(worker.mEpollFd, EPOLL_CTL_ADD, worker.mSocket, &event) < 0)
+      {
+        result = eIasAvbProcInitializationFailed;
+      }
+      else
+      {
+        event.data.fd = worker.mTimerFd;
+        if (epoll_ctl(worker.mEpollFd, EPOLL_CTL_ADD, worker.mTimerFd, &event) < 0)
+        {
+          result = eIasAvbProcInitializationFailed;
+        }
+      }
+
+      if (eIasAvbProcOK != result)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't add file descriptors to epoll instance (",
+            int32_t(errno), ", ", strerror(errno), ")");
+      }
+    }
+
+    if (eIasAvbProcOK != result)
+    {
+      closeEventLoop(worker);
+    }
+  }
+
+  return result;
+}
+
+
+void IasAvbReceiveEngine::closeEventLoop(Worker & worker)
+{
+  if (worker.mTimerFd >= 0)
+  {
+    (void) close(worker.mTimerFd);
+  }
+  worker.mTimerFd = -1;
+
+  if (worker.mEpollFd >= 0)
+  {
+    (void) close(worker.mEpollFd);
+  }
+  worker.mEpollFd = -1;
+}
+
+
+void IasAvbReceiveEngine::armTimeoutTimer(Worker & worker, uint64_t now)
+{
+  const uint64_t expiry = worker.mTimeoutWheel.getNextExpiry();
+
+  if (expiry != worker.mTimerExpiry)
+  {
+    struct itimerspec spec;
+    std::memset(&spec, 0, sizeof spec);
+
+    if (std::numeric_limits<uint64_t>::max() != expiry)
+    {
+      // all zero would disarm the timer
+      const uint64_t delay = (expiry > now) ? (expiry - now) : 1u;
+      spec.it_value.tv_sec = time_t(delay / 1000000000u);
+      spec.it_value.tv_nsec = long(delay % 1000000000u);
+    }
+
+    (void) timerfd_settime(worker.mTimerFd, 0, &spec, NULL);
+    worker.mTimerExpiry = expiry;
+  }
+}
+#endif /* !DIRECT_RX_DMA */
+
+
+void IasAvbReceiveEngine::processTimeouts(Worker & worker, const IasAvbRxStreamTable * table, uint64_t now,
+                                          uint64_t timeout)
+{
+  const uint64_t generation = (NULL != table) ? table->getGeneration() : 0u;
+
+  if (generation != worker.mTimeoutGeneration)
+  {
+    // the set of streams has changed, streams removed may have been deleted already, so don't touch the old nodes
+    worker.mTimeoutWheel.clear(now);
+    worker.mTimeoutGeneration = generation;
+    worker.mClaimed = false;
+
+    // from now on, the streams owned according to a previous distribution are left alone
+    worker.mShardGeneration = (NULL != table) ? table->getShardGeneration() : 0u;
+  }
+
+  if (!worker.mClaimed && (worker.mReplay || isShardingSettled(worker.mShardGeneration.load())))
+  {
+    const uint32_t numStreams = (NULL != table) ? table->getSize() : 0u;
+    for (uint32_t idx = 0u; idx < numStreams; idx++)
+    {
+      // each stream is watched by the worker receiving its packets only
+      if (isOwner(worker, table, table->getEntryStreamId(idx)))
+      {
+        StreamData * const data = table->getEntry(idx);
+        data->next = NULL;
+        data->pprev = NULL;
+        worker.mTimeoutWheel.add(data, ((0u != data->lastTimeDispatched) ? data->lastTimeDispatched : now) + timeout);
+      }
+    }
+    worker.mClaimed = true;
+  }
+
+  if (now >= worker.mTimeoutWheel.getNextExpiry())
+  {
+    IasAvbTimeoutWheel::Node * node = worker.mTimeoutWheel.expire(now);
+    while (NULL != node)
+    {
+      StreamData * const data = static_cast<StreamData*>(node);
+      node = node->next;
+
+      if ((now - data->lastTimeDispatched) >= timeout)
+      {
+        // trigger stream state change notification, the stream stays out of the wheel until data arrives again
+        (void) dispatchPacket(*data, NULL, 0u, now, now);
+      }
+      else
+      {
+        // serviced in the meantime
+        worker.mTimeoutWheel.add(data, data->lastTimeDispatched + timeout);
+      }
+    }
+  }
+}
+
+
+bool IasAvbReceiveEngine::isShardingSettled(uint64_t shardGeneration) const
+{
+  bool settled = true;
+
+  // a worker which has switched to a newer distribution has dropped the streams of this one as well
+  for (WorkerList::const_iterator it = mWorkers.begin(); settled && (mWorkers.end() != it); it++)
   {
-    closeSocket();
+    settled = ((*it)->mShardGeneration.load() >= shardGeneration);
   }
 
-  return result;
+  return settled;
 }
 
 
-IasResult IasAvbReceiveEngine::run()
+IasResult IasAvbReceiveEngine::receive(Worker & worker)
 {
-  IasAvbStreamId avbStreamId;
   int32_t recv_length = 0;
-  uint32_t packetsReceived = 0u;
-  uint32_t packetsDispatched = 0u;
-  uint32_t packetsDiscarded = 0u;
-  uint32_t packetsValid = 0u;
   uint32_t cycles = 0u;
   uint64_t lastDebugOut = 0u;
-  int32_t timeDiffMin = std::numeric_limits<int32_t>::max();
-  int32_t timeDiffMax = std::numeric_limits<int32_t>::min();
-  int64_t timeDiffAcc = 0;
+  FrameContext context;
+  uint32_t idleWait = 0u; // us
 
-  IasDiaLogger* diaLogger = IasAvbStreamHandlerEnvironment::getDiaLogger();
+  initFrameContext(worker, context, idleWait);
+  IasWatchdog::IasWatchdogInterface * const watchdog = context.watchdog;
 
-  DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX);
+  DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "worker", worker.mIndex);
 
   struct sched_param sparam;
   std::string policyStr = "fifo";
@@ -920,49 +1971,60 @@ IasResult IasAvbReceiveEngine::run()
     DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Error setting scheduler parameter: ", strerror(errval));
   }
 
+  if (0 <= worker.mCpu)
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(worker.mCpu, &cpuSet);
+    errval = pthread_setaffinity_np(pthread_self(), sizeof cpuSet, &cpuSet);
+    if (0 != errval)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Error setting CPU affinity to", worker.mCpu, ":", strerror(errval));
+    }
+  }
+
 #if defined(DIRECT_RX_DMA)
   IasAvbPacket* packet = NULL;
   uint32_t elapsedTimeNs = 0u; /* elapsed time (ns) without packet reception */
   uint32_t count = 0;
 #else
-  fd_set readSet;
-  fd_set exceptSet;
-  timeval selectWaitTime;
+  struct epoll_event events[cMaxEpollEvents];
+  uint64_t ringDelayMax = 0u; // ns from kernel timestamp until the frame is processed
+  uint64_t realNow = 0u;      // CLOCK_REALTIME read along with now, to convert software time stamps
 #endif /* DIRECT_RX_DMA */
+  uint8_t * rxBuffer = worker.mReceiveBuffer;
   int32_t selectResult;
-  IasAvbStreamId wildcardId(uint64_t(0u));
-  IasAvbMacAddress wildcardMac;
-  std::memset(wildcardMac, 0, cIasAvbMacAddressLength);
+  bool rxReady = false;
 
   uint32_t cycleWait = 2000000u; // ns
-  uint32_t idleWait = 25000u; // 25ms, enough to deal with standard clock reference streams (50 PDU/s)
-  uint32_t discardAfter = 0u; // ns
-  bool doDiscardByPts;
 
   (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxCycleWait, cycleWait);
 #if defined(DIRECT_RX_DMA)
   /* cycleWait must be a non-zero value to calculate the time-out value */
   AVB_ASSERT(cycleWait != 0u);
 #endif
-  if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxIdleWait, idleWait))
-  {
-    // config value is specified in ns
-    idleWait /= 1000u;
-  }
-  doDiscardByPts = IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxDiscardAfter, discardAfter);
 
   IasLibPtpDaemon* ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
   AVB_ASSERT(NULL != ptp);
   uint64_t now = ptp->getLocalTime();
-  uint64_t lastTimeoutCheck = now;  // This is used to perform an timeout check for individual streams
+  uint64_t lastWatchdogReset = now;
+  const uint64_t timeout = context.timeout;
+
+  // rebuilt with the current stream table in the first cycle
+  (void) worker.mTimeoutWheel.init(cTimeoutTick, now);
+  worker.mTimeoutGeneration = 0u;
+  worker.mClaimed = false;
+#if !defined(DIRECT_RX_DMA)
+  worker.mTimerExpiry = 0u;
+#endif
 
-  while (!mEndThread)
+  while (!worker.mEndThread)
   {
-    while (!IasAvbStreamHandlerEnvironment::isLinkUp() && !mEndThread)
+    while (!IasAvbStreamHandlerEnvironment::isLinkUp() && !worker.mEndThread)
     {
       /* Don't monitor if the link is down */
-      if (mWatchdog && (mWatchdog->isRegistered()))
-        (void) mWatchdog->unregisterWatchdog();
+      if (watchdog && (watchdog->isRegistered()))
+        (void) watchdog->unregisterWatchdog();
 
       DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "waiting for network link...");
       ::sleep( 1u );
@@ -971,7 +2033,7 @@ IasResult IasAvbReceiveEngine::run()
 #if defined(DIRECT_RX_DMA)
     if ((elapsedTimeNs / 1000) >= idleWait) /* us */
     {
-      /* invoke the error handling since the 'idleWait' time elapsed without packet reception */
+      /* no packet reception within 'idleWait' */
       selectResult  = 0u;
 
       /* reset the counter */
@@ -982,370 +2044,220 @@ IasResult IasAvbReceiveEngine::run()
       /* poll the network interface to retrieve a received packet */
       selectResult = 1u;
     }
+    rxReady = (0 != selectResult);
 #else
-    FD_ZERO(&readSet);
-    FD_SET(mReceiveSocket, &readSet);
-    FD_ZERO(&exceptSet);
-    FD_SET(mReceiveSocket, &exceptSet);
+    selectResult = epoll_wait(worker.mEpollFd, events, cMaxEpollEvents, int32_t((idleWait + 999u) / 1000u));
 
-    selectWaitTime.tv_sec = 0u;
-    selectWaitTime.tv_usec = idleWait;
-
-    selectResult = select( FD_SETSIZE, &readSet, NULL, &exceptSet, &selectWaitTime );
-#endif /* DIRECT_RX_DMA */
-
-    // should "now" be updated here rather than after the nanosleep?
-
-    if (0 == selectResult)
+    rxReady = false;
+    for (int32_t idx = 0; idx < selectResult; idx++)
     {
-      // general timeout, notify streams that no data has arrived
-      (void) lock();
-      for (AvbStreamMap::iterator it = mAvbStreams.begin(); mAvbStreams.end() != it; it++)
+      if (worker.mTimerFd == events[idx].data.fd)
       {
-        (void) dispatchPacket(it->second, NULL, 0u, now);
+        uint64_t expirations = 0u;
+        (void) ::read(worker.mTimerFd, &expirations, sizeof expirations);
+        worker.mTimerExpiry = 0u; // one-shot, has to be armed again
       }
-      (void) unlock();
-
-      /* Reset the timer even if we're idle waiting for packets */
-      if (mWatchdog)
+      else
       {
-        if(!mWatchdog->isRegistered())
-        {
-          if (mWatchdog->registerWatchdog() != IasResult::cOk)
-          {
-            DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " watchdog registration failure...");
-            mEndThread = true;
-          }
-        }
-	(void) mWatchdog->reset();
+        rxReady = true;
       }
     }
-    else if (selectResult < 0)
+
+    // the wait may have lasted up to idleWait, timeouts and packets need the current time
+    now = ptp->getLocalTime();
+    struct timespec tsRealNow;
+    (void) clock_gettime(CLOCK_REALTIME, &tsRealNow);
+    realNow = IasLibPtpDaemon::convertTimespecToNs(tsRealNow);
+#endif /* DIRECT_RX_DMA */
+
+    if (selectResult < 0)
     {
-      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "select error: ",
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "wait error: ",
           int32_t(errno), " (", strerror(errno), ")");
-      mEndThread = true;
+      worker.mEndThread = true;
     }
     else
     {
-      // If idleWait period is over check whether a timeout for a particular stream has occurred. */
-      if (now - lastTimeoutCheck > (idleWait * 1000u))
-      {
-        // Iterate over stream list and check for individual timeouts
-        (void) lock();
-        for (AvbStreamMap::iterator it = mAvbStreams.begin(); mAvbStreams.end() != it; it++)
-        {
-          // If the stream hasn't been serviced for idleWait period trigger stream state change notification
-          if (now - it->second.lastTimeDispatched > (idleWait * 1000u))
-          {
-            (void) dispatchPacket(it->second, NULL, 0u, now);
-          }
-        }
-        (void) unlock();
-        lastTimeoutCheck = now; // Memorize the time of the last timeout check
+      // no lock needed, changes of the stream list are published as a new table
+      IasAvbRxStreamTable * table = beginRead(worker);
+
+      // each stream not serviced within idleWait is notified when its own deadline expires
+      processTimeouts(worker, table, now, timeout);
 
-        /* For a specific stream timeout, it should still be valid to reset the watchdog timer */
-        if (mWatchdog)
+      if ((0 == selectResult) || ((now - lastWatchdogReset) > timeout))
+      {
+        /* Reset the timer even if we're idle waiting for packets */
+        if (watchdog)
         {
-          if(!mWatchdog->isRegistered())
+          if(!watchdog->isRegistered())
           {
-            if (mWatchdog->registerWatchdog() != IasResult::cOk)
+            if (watchdog->registerWatchdog() != IasResult::cOk)
             {
               DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " watchdog registration failure...");
-              mEndThread = true;
+              worker.mEndThread = true;
             }
           }
-          (void) mWatchdog->reset();
+          (void) watchdog->reset();
         }
+        lastWatchdogReset = now;
       }
-      else
+
+      if (rxReady)
       {
-#if !DIRECT_RX_DMA
-        if (FD_ISSET(mReceiveSocket, &readSet))
-#endif /* !DIRECT_RX_DMA */
+
+        for(;;)
         {
-          (void) lock(); // protect mAvbStreams
+          uint64_t rxTime = now; // time the packet has been received, local time
 
-          for(;;)
-          {
 #if defined(DIRECT_RX_DMA)
-            if (NULL != packet)
+          if (NULL != packet)
+          {
+            /* put back the used packet buffer */
+            if (igb_refresh_buffers(mIgbDevice, eRxQueue0, reinterpret_cast<struct igb_packet **>(&packet), 1u) == 0)
             {
-              /* put back the used packet buffer */
-              if (igb_refresh_buffers(mIgbDevice, eRxQueue0, reinterpret_cast<struct igb_packet **>(&packet), 1u) == 0)
-              {
-                packet = NULL;
-              }
+              packet = NULL;
             }
+          }
 
-            /* reset the variable */
-            recv_length = -1u;
+          /* reset the variable */
+          recv_length = -1u;
 
-            if (NULL == packet)
-            {
+          if (NULL == packet)
+          {
 #if defined(DEBUG_LISTENER_UNCERTAINTY)
-              const uint64_t rxTstamp = ptp->getLocalTime();
-              const size_t rxTstampSz = sizeof(rxTstamp);
+            const uint64_t rxTstamp = ptp->getLocalTime();
+            const size_t rxTstampSz = sizeof(rxTstamp);
 #endif
-              /* try getting a received packet */
-              count = 1u;
-              if (igb_receive(mIgbDevice, eRxQueue0, reinterpret_cast<struct igb_packet **>(&packet), &count) == 0)
+            /* try getting a received packet */
+            count = 1u;
+            if (igb_receive(mIgbDevice, eRxQueue0, reinterpret_cast<struct igb_packet **>(&packet), &count) == 0)
+            {
+              if (NULL != packet)
               {
-                if (NULL != packet)
-                {
-                  /* a packet is available */
-                  mReceiveBuffer = reinterpret_cast<uint8_t*>(packet->getBasePtr());
-                  recv_length = packet->len;
+                /* a packet is available */
+                worker.mReceiveBuffer = reinterpret_cast<uint8_t*>(packet->getBasePtr());
+                rxBuffer = worker.mReceiveBuffer;
+                recv_length = packet->len;
 
-                  /* reset the counter */
-                  elapsedTimeNs = 0u;
+                /* reset the counter */
+                elapsedTimeNs = 0u;
 
 #if defined(DEBUG_LISTENER_UNCERTAINTY)
-                  /* DO NOT ENABLE THESE LINES FOR PRODUCTION SW */
-                  if ((recv_length + rxTstampSz) <= cReceiveBufferSize)
-                  {
-                    /*
-                     * put the current time to the bottom of the receive buffer
-                     * assuming the received packet size is smaller than the buffer size of 2KB
-                     */
-                    uint64_t rxTstampBuf = uint64_t((mReceiveBuffer + recv_length + (rxTstampSz - 1u))) & ~(rxTstampSz - 1u);
-
-                    // insert the received timestamp to the buffer just after the payload
-                    *((uint64_t*)rxTstampBuf) = rxTstamp;
-                  }
-#endif
+                /* DO NOT ENABLE THESE LINES FOR PRODUCTION SW */
+                if ((recv_length + rxTstampSz) <= cReceiveBufferSize)
+                {
+                  /*
+                   * put the current time to the bottom of the receive buffer
+                   * assuming the received packet size is smaller than the buffer size of 2KB
+                   */
+                  uint64_t rxTstampBuf = uint64_t((worker.mReceiveBuffer + recv_length + (rxTstampSz - 1u))) & ~(rxTstampSz - 1u);
+
+                  // insert the received timestamp to the buffer just after the payload
+                  *((uint64_t*)rxTstampBuf) = rxTstamp;
                 }
+#endif
               }
-              else
+            }
+            else
+            {
+              /*
+               * RCTL.RXEN bit could mistakenly be turned off as initializing i210's direct rx mode if some programs
+               * such as ifconfig or commnand concurrently access network interface on i210. This will drop all
+               * incoming packets. Root cause is synchronization problem between libigb (user-side) and igb_avb
+               * (kernel-side). As a workaround, monitor the bit if there is no incoming packet and enable it in case.
+               * (defect: 201518)
+               */
+              if (mRecoverIgbReceiver)
               {
-                /*
-                 * RCTL.RXEN bit could mistakenly be turned off as initializing i210's direct rx mode if some programs
-                 * such as ifconfig or commnand concurrently access network interface on i210. This will drop all
-                 * incoming packets. Root cause is synchronization problem between libigb (user-side) and igb_avb
-                 * (kernel-side). As a workaround, monitor the bit if there is no incoming packet and enable it in case.
-                 * (defect: 201518)
-                 */
-                if (mRecoverIgbReceiver)
+                uint32_t rctlReg = 0u;
+                (void) igb_readreg(mIgbDevice, RCTL, &rctlReg);
+                if (!(rctlReg & RCTL_RXEN))
                 {
-                  uint32_t rctlReg = 0u;
-                  (void) igb_readreg(mIgbDevice, RCTL, &rctlReg);
-                  if (!(rctlReg & RCTL_RXEN))
-                  {
-                    rctlReg |= RCTL_RXEN;
-                    (void) igb_writereg(mIgbDevice, RCTL, rctlReg);
-
-                    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Rx IGB Recovery: enabled RCTL.RXEN ( regval =", rctlReg, ")");
-                  }
+                  rctlReg |= RCTL_RXEN;
+                  (void) igb_writereg(mIgbDevice, RCTL, rctlReg);
+
+                  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "Rx IGB Recovery: enabled RCTL.RXEN ( regval =", rctlReg, ")");
                 }
               }
             }
+          }
 #else
-            recv_length = static_cast<int32_t>(recvfrom(mReceiveSocket, &mReceiveBuffer[0], cReceiveBufferSize, MSG_DONTWAIT, NULL, NULL ));
-#endif /* DIRECT_RX_DMA */
-            if (recv_length < 0)
-            {
-              const int32_t err = errno;
-              if ((EAGAIN == err) || (EWOULDBLOCK == err))
-              {
-                // no new packets, just leave loop
-              }
-              else
-              {
-                DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "recvfrom error: ", int32_t(err),
-                    " (", strerror(err), ")");
-                mEndThread = true;
-              }
+          if (NULL != worker.mReceiveRing)
+          {
+            uint32_t frameLength = 0u;
+            uint64_t rxTimestamp = 0u;
 
+            rxBuffer = worker.mReceiveRing->nextFrame(frameLength, rxTimestamp);
+            if (NULL == rxBuffer)
+            {
+              // ring drained, no syscall needed to find out
               break;
             }
-            else if (recv_length > 0)
-            {
-              const uint16_t * ethType = reinterpret_cast<uint16_t*>(mReceiveBuffer + (ETH_HLEN - 2u));
-              if (*ethType == htons(ETH_P_8021Q))
-              {
-                ethType += 2u;
-              }
-
-              if (*ethType == htons(ETH_P_IEEE1722)) // valid AVTP packet detected
-              {
-                bool updateSmac = false;
-                packetsReceived++;
-                if (NULL != diaLogger)
-                {
-                  diaLogger->incRxCount();
-                }
-
-                const uint16_t* avtpBase16 = ethType + 1u;
-                const uint8_t* avtpBase8 = reinterpret_cast<const uint8_t*>(avtpBase16);
-                const uint32_t* avtpBase32 = reinterpret_cast<const uint32_t*>(avtpBase16);
-
-#if defined(PERFORMANCE_MEASUREMENT)
-                if (IasAvbStreamHandlerEnvironment::isAudioFlowLogEnabled()) // latency analysis
-                {
-                  uint32_t state = 0u;
-                  uint64_t logtime = 0u;
-                  (void) IasAvbStreamHandlerEnvironment::getAudioFlowLoggingState(state, logtime);
-
-                  uint64_t tscNow = ptp->getTsc();
-
-                  if ((0x02 == avtpBase8[0]) && // AAF
-                          ((0u == state) || (tscNow - logtime > (uint64_t)(1e9)))) // measurement is not ongoing or timed-out
-                  {
-                    uint16_t streamDataLen = ntohs(avtpBase16[10]);
-                    const uint32_t cBufSize = sizeof(uint16_t) * 64u;
-                    static uint8_t zeroBuf[cBufSize];
-                    if (0 != zeroBuf[0])
-                    {
-                      (void) std::memset(zeroBuf, 0, cBufSize);
-                    }
-
-                    if (streamDataLen > cBufSize)
-                    {
-                      streamDataLen = cBufSize;
-                    }
-
-                    if ((0 != avtpBase16[12]) ||
-                        (0 != std::memcmp(&avtpBase16[12], zeroBuf, streamDataLen)))
-                    {
-                      DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX,
-                                  "latency-analysis(1): received samples from MAC system time =", tscNow);
-
-                      IasAvbStreamHandlerEnvironment::setAudioFlowLoggingState(1u, tscNow);
-                    }
-                  }
-                }
-#endif
-
-                avbStreamId.setStreamId(avtpBase8 + 4u);
+            recv_length = int32_t(frameLength);
 
-                bool dispatch = true;
-
-                if ((avtpBase8[1] & 0x80) == 0)
-                {
-                  // streamId invalid
+            const bool hardware = worker.mReceiveRing->hasHardwareTimestamp();
+            if (!hardware)
+            {
+              struct timespec tsNow;
+              (void) clock_gettime(CLOCK_REALTIME, &tsNow);
+              const uint64_t rxDelay = (uint64_t(tsNow.tv_sec) * 1000000000u) + uint64_t(tsNow.tv_nsec) - rxTimestamp;
+              ringDelayMax = (rxDelay > ringDelayMax) ? rxDelay : ringDelayMax;
+            }
 
-                  /* NOTE: The RX engine does only handle stream data. Any other
-                   * AVTPPDU has to be handled by other processes opening their
-                   * own raw sockets (such as MRPD).
-                   */
-                  dispatch = false;
-                }
-                else if (doDiscardByPts && (avtpBase8[1] & 0x01))
-                {
-                  // timestamp valid
-                  const int32_t delta = int32_t(now - ntohl(avtpBase32[3]));
-
-                  timeDiffMin = timeDiffMin < delta ? timeDiffMin : delta;
-                  timeDiffMax = timeDiffMax > delta ? timeDiffMax : delta;
-                  timeDiffAcc += delta;
-
-                  if (delta > int32_t(discardAfter))
-                  {
-                    dispatch = false;
-                    packetsDiscarded++;
-                  }
-                }
-                else
-                {
-                  // do nothing, dispatch is true already
-                }
+            if (cTimestampOff != mTimestamping)
+            {
+              rxTime = toLocalTime(rxTimestamp, hardware, now, realNow);
+            }
+          }
+          else
+          {
+            uint64_t kernelTime = 0u;
+            bool hardware = false;
 
-                if (dispatch)
-                {
-                  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
-
-                  if (mAvbStreams.end() == it)
-                  {
-                    // not found, look for wildcard
-                    it = mAvbStreams.find(wildcardId);
-
-                    /*
-                     * Extended wildcard semantics:
-                     * If stream has been found by wildcard, and wildcard stream has DMAC != 0,
-                     * and the DMAC matches, turn wildcard stream into regular stream by
-                     * setting the StreamId and replacing it in the lookup map.
-                     */
-
-                    if (mAvbStreams.end() != it)
-                    {
-                      StreamData data = it->second;
-                      AVB_ASSERT(NULL != data.stream);
-                      if (0 == std::memcmp(data.stream->getDmac(), mReceiveBuffer, cIasAvbMacAddressLength))
-                      {
-                        data.stream->changeStreamId(avbStreamId);
-                        mAvbStreams.erase(wildcardId);
-                        mAvbStreams[avbStreamId] = data;
-                        it = mAvbStreams.find(avbStreamId);
-                      }
-                      else if (0 == std::memcmp(data.stream->getDmac(), wildcardMac, cIasAvbMacAddressLength))
-                      {
-                        // just use the wildcard stream found
-                      }
-                      else
-                      {
-                        // no matching entry found
-                        it = mAvbStreams.end();
-                      }
-                    }
-                  }
-
-                  if (mIgnoreStreamId && (mAvbStreams.end() == it))
-                  {
-                    /*
-                     * still not found, "ignore mode" active, use first available stream
-                     * NOTE: For testing only, this should be used only under lab conditions!
-                     */
-
-                    it = mAvbStreams.begin();
-                  }
-
-                  if (mAvbStreams.end() != it)
-                  {
-                    packetsDispatched++;
-
-                    const uint8_t * sMac= mReceiveBuffer + 6u;
-                    IasAvbStream *stream = it->second.stream;
-                    AVB_ASSERT(NULL != stream);
-                    if (0 != std::memcmp(stream->getSmac(), sMac, cIasAvbMacAddressLength))
-                    {
-                      updateSmac = true;
-                    }
-
-                    if (dispatchPacket(it->second, avtpBase8, recv_length - (avtpBase8 - mReceiveBuffer), now))
-                    {
-                      if (updateSmac)
-                      {
-                        stream->setSmac(sMac);
-                      }
-                      packetsValid++;
-
-                      /* Finally, if the pkt was set successfully, we reset the watchdog timer */
-                      if (mWatchdog)
-                      {
-                        if (!mWatchdog->isRegistered())
-                        {
-                          if (mWatchdog->registerWatchdog() != IasResult::cOk)
-                          {
-                            DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " watchdog registration failure...");
-                            mEndThread = true;
-                          }
-                        }
-                        (void) mWatchdog->reset();
-                      }
-                    }
-                  }
-                }
-              }
+            rxBuffer = worker.mReceiveBuffer;
+            recv_length = receiveFrame(worker, kernelTime, hardware);
+            rxTime = toLocalTime(kernelTime, hardware, now, realNow);
+          }
+#endif /* DIRECT_RX_DMA */
+          if (recv_length < 0)
+          {
+            const int32_t err = errno;
+            if ((EAGAIN == err) || (EWOULDBLOCK == err))
+            {
+              // no new packets, just leave loop
             }
             else
             {
-              DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX,  "unexpected: recvfrom( returned 0)");
+              DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "recvfrom error: ", int32_t(err),
+                  " (", strerror(err), ")");
+              worker.mEndThread = true;
             }
-          }
 
-          (void) unlock();
+            break;
+          }
+          else if (recv_length > 0)
+          {
+            if (NULL != mRecorder)
+            {
+              (void) mRecorder->writeFrame(rxBuffer, uint32_t(recv_length), rxTime);
+            }
+            processFrame(worker, table, rxBuffer, recv_length, now, rxTime, context);
+          }
+          else
+          {
+            DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX,  "unexpected: recvfrom( returned 0)");
+          }
         }
+      }
+
+#if !defined(DIRECT_RX_DMA)
+      // packets may have brought streams back into the wheel
+      armTimeoutTimer(worker, now);
+#endif /* !DIRECT_RX_DMA */
+      endRead(worker);
 
+      if (rxReady)
+      {
         cycles++;
 
         if (cycleWait != 0u)
@@ -1370,48 +2282,291 @@ IasResult IasAvbReceiveEngine::run()
     if ((now - lastDebugOut) > 1000000000u)
     {
       lastDebugOut = now;
-      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, packetsReceived,
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "worker", worker.mIndex, ":", context.packetsReceived,
           " SAF packets received , ",
-          packetsDispatched, " dispatched, ",
-          packetsValid, " valid, ",
-          packetsDiscarded, " discarded, ",
+          context.packetsDispatched, " dispatched, ",
+          context.packetsValid, " valid, ",
+          context.packetsDiscarded, " discarded, ",
           cycles, " cycles, ",
-          (cycles > 0) ? float(packetsReceived)/float(cycles) : float(0), " pkt/cycle"
+          (cycles > 0) ? float(context.packetsReceived)/float(cycles) : float(0), " pkt/cycle"
           );
-      packetsDispatched = 0u;
-      packetsValid = 0u;
-      packetsDiscarded = 0u;
       cycles = 0u;
 
-      if (doDiscardByPts)
+      if (context.doDiscardByPts)
       {
         DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "presentation time delta: ",
-            timeDiffMin, " min, ",
-            timeDiffMax, " max, ",
-            (packetsReceived > 0) ? float(timeDiffAcc) / float(packetsReceived) : float(0), " avg/"
+            context.timeDiffMin, " min, ",
+            context.timeDiffMax, " max, ",
+            (context.packetsReceived > 0) ? float(context.timeDiffAcc) / float(context.packetsReceived) : float(0), " avg/"
             );
-        timeDiffMin = std::numeric_limits<int32_t>::max();
-        timeDiffMax = std::numeric_limits<int32_t>::min();
-        timeDiffAcc = 0;
       }
-      packetsReceived = 0u;
+      resetFrameStatistics(context);
+
+#if !defined(DIRECT_RX_DMA)
+      uint32_t ringPackets = 0u;
+      uint32_t ringDrops = 0u;
+      uint32_t ringFreezes = 0u;
+      if ((NULL != worker.mReceiveRing) && worker.mReceiveRing->getStatistics(ringPackets, ringDrops, ringFreezes))
+      {
+        DLT_LOG_CXX(*mLog, (0u != ringDrops) ? DLT_LOG_WARN : DLT_LOG_DEBUG, LOG_PREFIX, "RX ring:", ringPackets,
+            "frames,", ringDrops, "dropped,", ringFreezes, "times full, max delay(ns):", ringDelayMax,
+            "blocks:", worker.mReceiveRing->getBlockCount());
+      }
+      ringDelayMax = 0u;
+#endif /* !DIRECT_RX_DMA */
 
-      if (NULL != diaLogger)
+      if ((NULL != context.diaLogger) && (0u == worker.mIndex))
       {
-        diaLogger->clearRxCount();
+        context.diaLogger->clearRxCount();
       }
     }
   }
 
   /* Unregister the watchdog on thread exit */
-  if (mWatchdog && mWatchdog->isRegistered())
-    mWatchdog->unregisterWatchdog();
+  if (watchdog && watchdog->isRegistered())
+    watchdog->unregisterWatchdog();
+
+  // a stopped worker doesn't hold back the other ones
+  worker.mShardGeneration = std::numeric_limits<uint64_t>::max();
 
   return IasResult::cOk;
 }
 
 
-bool IasAvbReceiveEngine::dispatchPacket(StreamData &streamData, const void* packet, size_t length, uint64_t now)
+void IasAvbReceiveEngine::initFrameContext(const Worker & worker, FrameContext & context, uint32_t & idleWait)
+{
+  idleWait = 25000u; // 25ms, enough to deal with standard clock reference streams (50 PDU/s)
+  if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxIdleWait, idleWait))
+  {
+    // config value is specified in ns
+    idleWait /= 1000u;
+  }
+
+  // the watchdog supervises worker 0, which wakes up at least every idleWait
+  context.watchdog = (0u == worker.mIndex) ? mWatchdog : NULL;
+  context.diaLogger = IasAvbStreamHandlerEnvironment::getDiaLogger();
+  // while a wildcard stream exists, worker 0 receives all packets, see updateStreamTable()
+  context.handleWildcard = (0u == worker.mIndex);
+  context.discardAfter = 0u;
+  context.doDiscardByPts = IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cRxDiscardAfter, context.discardAfter);
+  context.timeout = uint64_t(idleWait) * 1000u;
+  resetFrameStatistics(context);
+}
+
+
+void IasAvbReceiveEngine::processFrame(Worker & worker, IasAvbRxStreamTable * &table, const uint8_t * frame,
+                                       int32_t length, uint64_t now, uint64_t rxTime, FrameContext & context)
+{
+  IasAvbStreamId avbStreamId;
+  const IasAvbStreamId wildcardId(uint64_t(0u));
+  IasAvbMacAddress wildcardMac;
+  std::memset(wildcardMac, 0, cIasAvbMacAddressLength);
+
+  const uint16_t * ethType = reinterpret_cast<const uint16_t*>(frame + (ETH_HLEN - 2u));
+  if (*ethType == htons(ETH_P_8021Q))
+  {
+    ethType += 2u;
+  }
+
+  // runt frames don't even hold the AVTP stream header
+  const int32_t headerLength = int32_t(reinterpret_cast<const uint8_t*>(ethType + 1u) - frame) + int32_t(cAvtpStreamHeaderSize);
+
+  if ((*ethType == htons(ETH_P_IEEE1722)) && (length >= headerLength)) // valid AVTP packet detected
+  {
+    bool updateSmac = false;
+    context.packetsReceived++;
+    if (NULL != context.diaLogger)
+    {
+      context.diaLogger->incRxCount();
+    }
+
+    const uint16_t* avtpBase16 = ethType + 1u;
+    const uint8_t* avtpBase8 = reinterpret_cast<const uint8_t*>(avtpBase16);
+    const uint32_t* avtpBase32 = reinterpret_cast<const uint32_t*>(avtpBase16);
+
+#if defined(PERFORMANCE_MEASUREMENT)
+    if (IasAvbStreamHandlerEnvironment::isAudioFlowLogEnabled()) // latency analysis
+    {
+      uint32_t state = 0u;
+      uint64_t logtime = 0u;
+      (void) IasAvbStreamHandlerEnvironment::getAudioFlowLoggingState(state, logtime);
+
+      IasLibPtpDaemon* ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
+      uint64_t tscNow = ptp->getTsc();
+
+      if ((0x02 == avtpBase8[0]) && // AAF
+              ((0u == state) || (tscNow - logtime > (uint64_t)(1e9)))) // measurement is not ongoing or timed-out
+      {
+        uint16_t streamDataLen = ntohs(avtpBase16[10]);
+        const uint32_t cBufSize = sizeof(uint16_t) * 64u;
+        static uint8_t zeroBuf[cBufSize];
+        if (0 != zeroBuf[0])
+        {
+          (void) std::memset(zeroBuf, 0, cBufSize);
+        }
+
+        if (streamDataLen > cBufSize)
+        {
+          streamDataLen = cBufSize;
+        }
+
+        if ((0 != avtpBase16[12]) ||
+            (0 != std::memcmp(&avtpBase16[12], zeroBuf, streamDataLen)))
+        {
+          DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX,
+                      "latency-analysis(1): received samples from MAC system time =", tscNow);
+
+          IasAvbStreamHandlerEnvironment::setAudioFlowLoggingState(1u, tscNow);
+        }
+      }
+    }
+#endif
+
+    avbStreamId.setStreamId(avtpBase8 + 4u);
+
+    bool dispatch = true;
+
+    if ((avtpBase8[1] & 0x80) == 0)
+    {
+      // streamId invalid
+
+      /* NOTE: The RX engine does only handle stream data. Any other
+       * AVTPPDU has to be handled by other processes opening their
+       * own raw sockets (such as MRPD).
+       */
+      dispatch = false;
+    }
+    else if (context.doDiscardByPts && (avtpBase8[1] & 0x01))
+    {
+      // timestamp valid
+      const int32_t delta = int32_t(rxTime - ntohl(avtpBase32[3]));
+
+      context.timeDiffMin = (context.timeDiffMin < delta) ? context.timeDiffMin : delta;
+      context.timeDiffMax = (context.timeDiffMax > delta) ? context.timeDiffMax : delta;
+      context.timeDiffAcc += delta;
+
+      if (delta > int32_t(context.discardAfter))
+      {
+        dispatch = false;
+        context.packetsDiscarded++;
+      }
+    }
+    else
+    {
+      // do nothing, dispatch is true already
+    }
+
+    if (dispatch && (NULL != table))
+    {
+      uint64_t key = uint64_t(avbStreamId);
+      StreamData * data = table->find(key);
+
+      if ((NULL == data) && context.handleWildcard)
+      {
+        // not found, look for wildcard
+        key = uint64_t(wildcardId);
+        data = table->find(key);
+
+        /*
+         * Extended wildcard semantics:
+         * If stream has been found by wildcard, and wildcard stream has DMAC != 0,
+         * and the DMAC matches, turn wildcard stream into regular stream by
+         * setting the StreamId and replacing it in the lookup table.
+         */
+
+        if (NULL != data)
+        {
+          AVB_ASSERT(NULL != data->stream);
+          if (0 == std::memcmp(data->stream->getDmac(), frame, cIasAvbMacAddressLength))
+          {
+            const IasAvbRxStreamTable * const previous = table;
+            data->stream->changeStreamId(avbStreamId);
+            promoteWildcardStream(worker, table, wildcardId, avbStreamId);
+            if (previous != table)
+            {
+              // the stream may belong to another worker now, drop it from the wheel before that one takes it
+              key = uint64_t(avbStreamId);
+              processTimeouts(worker, table, now, context.timeout);
+            }
+          }
+          else if (0 == std::memcmp(data->stream->getDmac(), wildcardMac, cIasAvbMacAddressLength))
+          {
+            // just use the wildcard stream found
+          }
+          else
+          {
+            // no matching entry found
+            data = NULL;
+          }
+        }
+      }
+
+      if (mIgnoreStreamId && (NULL == data))
+      {
+        /*
+         * still not found, "ignore mode" active, use first available stream
+         * NOTE: For testing only, this should be used only under lab conditions!
+         */
+
+        data = table->getEntry(0u);
+        key = table->getEntryStreamId(0u);
+      }
+
+      if ((NULL != data) && !(worker.mClaimed && isOwner(worker, table, key)))
+      {
+        // queued before the distribution has changed, or the previous owner may still process the stream
+        data = NULL;
+        context.packetsDiscarded++;
+      }
+
+      if (NULL != data)
+      {
+        context.packetsDispatched++;
+
+        const uint8_t * sMac = frame + 6u;
+        IasAvbStream *stream = data->stream;
+        AVB_ASSERT(NULL != stream);
+        if (0 != std::memcmp(stream->getSmac(), sMac, cIasAvbMacAddressLength))
+        {
+          updateSmac = true;
+        }
+
+        if (!IasAvbTimeoutWheel::isLinked(data))
+        {
+          // stream has timed out before, watch it again
+          worker.mTimeoutWheel.add(data, now + context.timeout);
+        }
+
+        if (dispatchPacket(*data, avtpBase8, size_t(length - (avtpBase8 - frame)), now, rxTime))
+        {
+          if (updateSmac)
+          {
+            stream->setSmac(sMac);
+          }
+          context.packetsValid++;
+
+          /* Finally, if the pkt was set successfully, we reset the watchdog timer */
+          if (NULL != context.watchdog)
+          {
+            if (!context.watchdog->isRegistered())
+            {
+              if (context.watchdog->registerWatchdog() != IasResult::cOk)
+              {
+                DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " watchdog registration failure...");
+                worker.mEndThread = true;
+              }
+            }
+            (void) context.watchdog->reset();
+          }
+        }
+      }
+    }
+  }
+}
+
+
+bool IasAvbReceiveEngine::dispatchPacket(StreamData &streamData, const void* packet, size_t length, uint64_t now,
+                                         uint64_t rxTime)
 {
   IasAvbStream* stream = streamData.stream;
   AVB_ASSERT(NULL != streamData.stream);
@@ -1419,7 +2574,7 @@ bool IasAvbReceiveEngine::dispatchPacket(StreamData &streamData, const void* pac
   (void) checkStreamState(streamData);
 
   // @@DIAG EARLY/LATE_TIMESTAMP
-  stream->dispatchPacket(packet, length, now);
+  stream->dispatchPacket(packet, length, rxTime);
   streamData.lastTimeDispatched = now;          // Memorize the time when the stream has been dispatched
 
   return checkStreamState(streamData);
@@ -1464,10 +2619,17 @@ void IasAvbReceiveEngine::cleanup()
   delete mReceiveThread;
   mReceiveThread = NULL;
 
-#if !defined(DIRECT_RX_DMA)
-  delete[] mReceiveBuffer;
-  mReceiveBuffer = NULL;
-#endif /* !DIRECT_RX_DMA */
+  // stops the threads of the other workers and closes their sockets
+  for (WorkerList::iterator it = mWorkers.begin(); mWorkers.end() != it; it++)
+  {
+    delete *it;
+  }
+  mWorkers.clear();
+  mNumShards = 1u;
+
+  // no worker is writing anymore
+  delete mRecorder;
+  mRecorder = NULL;
 
   if (mWatchdog)
   {
@@ -1483,7 +2645,7 @@ void IasAvbReceiveEngine::cleanup()
 
   for (AvbStreamMap::iterator it = mAvbStreams.begin(); it != mAvbStreams.end(); it++)
   {
-    IasAvbStream * s = it->second.stream;
+    IasAvbStream * s = it->second->stream;
     AVB_ASSERT( NULL != s );
 
     /*
@@ -1496,9 +2658,13 @@ void IasAvbReceiveEngine::cleanup()
     ssStreamId << "0x" << std::hex << s->getStreamId();
     DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "destroying stream", ssStreamId.str());
     delete s;
+    delete it->second;
   }
   mAvbStreams.clear();
 
+  // the receive thread has been stopped already
+  delete mStreamTable.exchange(NULL);
+
   (void) closeSocket();
 
 #if defined(DIRECT_RX_DMA)
@@ -1518,7 +2684,7 @@ bool IasAvbReceiveEngine::getAvbStreamInfo(const IasAvbStreamId &id,
   {
     if (uint64_t(0u) == streamId || it->first == id)
     {
-      IasAvbStream *stream = it->second.stream;
+      IasAvbStream *stream = it->second->stream;
       IasAvbStreamDiagnostics diag = stream->getDiagnostics();
       bool preConfigured = stream->getPreconfigured();
       // Add info into list
@@ -1528,7 +2694,7 @@ bool IasAvbReceiveEngine::getAvbStreamInfo(const IasAvbStreamId &id,
         IasAvbAudioStream *audioStream = static_cast<IasAvbAudioStream *>(stream);
         IasAvbAudioStreamAttributes att;
         att.setStreamId(it->first);
-        att.setRxStatus(it->second.lastState);
+        att.setRxStatus(it->second->lastState);
         att.setDirection(stream->getDirection());
 
         const IasAvbMacAddress &smac_array = audioStream->getSmac();
@@ -1575,7 +2741,7 @@ bool IasAvbReceiveEngine::getAvbStreamInfo(const IasAvbStreamId &id,
         IasAvbVideoStream *videoStream = static_cast<IasAvbVideoStream *>(stream);
         IasAvbVideoStreamAttributes att;
         att.setStreamId(it->first);
-        att.setRxStatus(it->second.lastState);
+        att.setRxStatus(it->second->lastState);
         att.setDirection(stream->getDirection());
 
         const IasAvbMacAddress &smac_array = videoStream->getSmac();
@@ -1654,7 +2820,7 @@ bool IasAvbReceiveEngine::getAvbStreamInfo(const IasAvbStreamId &id,
         att.setDmac(dmac);
         att.setSourceMac(smac);
 
-        att.setRxStatus(it->second.lastState);
+        att.setRxStatus(it->second->lastState);
 
         att.setAssignMode(IasAvbIdAssignMode::eIasAvbIdAssignModeStatic);
         att.setPreconfigured(preConfigured);
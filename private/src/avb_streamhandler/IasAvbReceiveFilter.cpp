@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbReceiveFilter.cpp
+ * @brief   The definition of the IasAvbReceiveFilter class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbReceiveFilter.hpp"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <algorithm>
+
+namespace IasMediaTransportAvb {
+
+/*
+ *  Constructor.
+ */
+IasAvbReceiveFilter::IasAvbReceiveFilter()
+  : mStreamIds()
+  , mWildcardMacs()
+  , mAcceptAnyStream(false)
+  , mProgram()
+{
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbReceiveFilter::~IasAvbReceiveFilter()
+{
+}
+
+
+void IasAvbReceiveFilter::clear()
+{
+  mStreamIds.clear();
+  mWildcardMacs.clear();
+  mAcceptAnyStream = false;
+}
+
+
+void IasAvbReceiveFilter::addStream(uint64_t streamId)
+{
+  mStreamIds.push_back(streamId);
+}
+
+
+void IasAvbReceiveFilter::addWildcard(const IasAvbMacAddress & dmac)
+{
+  uint64_t mac = 0u;
+  for (uint32_t idx = 0u; idx < cIasAvbMacAddressLength; idx++)
+  {
+    mac = (mac << 8) | dmac[idx];
+  }
+
+  if (0u == mac)
+  {
+    mAcceptAnyStream = true;
+  }
+  else
+  {
+    mWildcardMacs.push_back(mac);
+  }
+}
+
+
+IasAvbProcessingResult IasAvbReceiveFilter::build()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  std::vector<uint64_t> streamIds(mStreamIds);
+  std::sort(streamIds.begin(), streamIds.end());
+  streamIds.erase(std::unique(streamIds.begin(), streamIds.end()), streamIds.end());
+
+  mProgram.clear();
+
+  // stream data only, the stream ID valid bit has to be set
+  emit(BPF_LD | BPF_B | BPF_ABS, uint32_t(SKF_NET_OFF) + 1u);
+  emit(BPF_JMP | BPF_JSET | BPF_K, 0x80u, 1u, 0u);
+  emit(BPF_RET | BPF_K, 0u);
+
+  if (mAcceptAnyStream)
+  {
+    emit(BPF_RET | BPF_K, cAccept);
+  }
+  else
+  {
+    for (std::vector<uint64_t>::const_iterator it = mWildcardMacs.begin(); mWildcardMacs.end() != it; it++)
+    {
+      emit(BPF_LD | BPF_W | BPF_ABS, uint32_t(SKF_LL_OFF));
+      emit(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(*it >> 16), 0u, 3u);
+      emit(BPF_LD | BPF_H | BPF_ABS, uint32_t(SKF_LL_OFF) + 4u);
+      emit(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(*it & 0xFFFFu), 0u, 1u);
+      emit(BPF_RET | BPF_K, cAccept);
+    }
+
+    /*
+     * One block per upper half of the stream IDs. The conditional jumps only reach 255 instructions
+     * ahead, so a block is skipped by an unconditional jump, and each comparison is directly
+     * followed by its accept.
+     */
+    size_t idx = 0u;
+    while (idx < streamIds.size())
+    {
+      const uint32_t upper = uint32_t(streamIds[idx] >> 32);
+      size_t end = idx;
+      while ((end < streamIds.size()) && (upper == uint32_t(streamIds[end] >> 32)))
+      {
+        end++;
+      }
+
+      emit(BPF_LD | BPF_W | BPF_ABS, uint32_t(SKF_NET_OFF) + 4u);
+      emit(BPF_JMP | BPF_JEQ | BPF_K, upper, 1u, 0u);
+      emit(BPF_JMP | BPF_JA, uint32_t(1u + (2u * (end - idx))));
+      emit(BPF_LD | BPF_W | BPF_ABS, uint32_t(SKF_NET_OFF) + 8u);
+      for (; idx < end; idx++)
+      {
+        emit(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(streamIds[idx]), 0u, 1u);
+        emit(BPF_RET | BPF_K, cAccept);
+      }
+    }
+
+    emit(BPF_RET | BPF_K, 0u);
+  }
+
+  if (mProgram.size() > cMaxLength)
+  {
+    mProgram.clear();
+    result = eIasAvbProcNoSpaceLeft;
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveFilter::attach(int32_t socket) const
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (mProgram.empty())
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else
+  {
+    struct sock_fprog prog;
+    prog.len = static_cast<unsigned short>(mProgram.size());
+    prog.filter = const_cast<sock_filter*>(&mProgram[0]);
+
+    if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof prog) < 0)
+    {
+      result = eIasAvbProcErr;
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbReceiveFilter::detach(int32_t socket)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  int32_t dummy = 0;
+
+  if ((setsockopt(socket, SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof dummy) < 0) && (ENOENT != errno))
+  {
+    result = eIasAvbProcErr;
+  }
+
+  return result;
+}
+
+} // namespace IasMediaTransportAvb
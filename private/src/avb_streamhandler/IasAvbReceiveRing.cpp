@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbReceiveRing.cpp
+ * @brief   The definition of the IasAvbReceiveRing class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbReceiveRing.hpp"
+#include <dlt/dlt_cpp_extension.hpp>
+
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <cstring>
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbReceiveRing::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+/*
+ *  Constructor.
+ */
+IasAvbReceiveRing::IasAvbReceiveRing(DltContext &ctx)
+  : mSocket(-1)
+  , mRing(NULL)
+  , mRingSize(0u)
+  , mBlockSize(0u)
+  , mBlockNum(0u)
+  , mBlockIdx(0u)
+  , mFrame(NULL)
+  , mFramesLeft(0u)
+  , mBlockCount(0u)
+  , mHardwareTimestamp(false)
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbReceiveRing::~IasAvbReceiveRing()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+IasAvbProcessingResult IasAvbReceiveRing::init(int32_t socket, uint32_t blockSize, uint32_t blockCount, uint32_t blockTimeout)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  const long pageSize = ::sysconf(_SC_PAGESIZE);
+
+  if (NULL != mRing)
+  {
+    result = eIasAvbProcInitializationFailed;
+  }
+  else if ((socket < 0) || (0u == blockSize) || (0u == blockCount) || (pageSize <= 0))
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    const int32_t version = TPACKET_V3;
+
+    if (::setsockopt(socket, SOL_PACKET, PACKET_VERSION, &version, sizeof version) < 0)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't select TPACKET_V3 (", int32_t(errno), ", ", strerror(errno), ")");
+      result = eIasAvbProcErr;
+    }
+    else
+    {
+      // block size must be a multiple of the page size and hold at least one maximum frame
+      uint32_t size = (blockSize < cFrameSize) ? cFrameSize : blockSize;
+      size = ((size + uint32_t(pageSize) - 1u) / uint32_t(pageSize)) * uint32_t(pageSize);
+
+      struct tpacket_req3 req;
+      std::memset(&req, 0, sizeof req);
+      req.tp_block_size = size;
+      req.tp_block_nr = blockCount;
+      req.tp_frame_size = cFrameSize;
+      req.tp_frame_nr = (size / cFrameSize) * blockCount;
+      req.tp_retire_blk_tov = blockTimeout;
+
+      if (::setsockopt(socket, SOL_PACKET, PACKET_RX_RING, &req, sizeof req) < 0)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't set up RX ring (", int32_t(errno), ", ", strerror(errno), ")");
+        result = eIasAvbProcErr;
+      }
+      else
+      {
+        mRingSize = size_t(req.tp_block_size) * size_t(req.tp_block_nr);
+        void * ring = ::mmap(NULL, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, socket, 0);
+        if (MAP_FAILED == ring)
+        {
+          // locking the pages needs CAP_IPC_LOCK or a sufficient RLIMIT_MEMLOCK
+          ring = ::mmap(NULL, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, socket, 0);
+        }
+
+        if (MAP_FAILED == ring)
+        {
+          DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't map RX ring (", int32_t(errno), ", ", strerror(errno), ")");
+          mRingSize = 0u;
+          result = eIasAvbProcErr;
+        }
+        else
+        {
+          mSocket = socket;
+          mRing = static_cast<uint8_t*>(ring);
+          mBlockSize = req.tp_block_size;
+          mBlockNum = req.tp_block_nr;
+          mBlockIdx = 0u;
+          mFrame = NULL;
+          mFramesLeft = 0u;
+          mBlockCount = 0u;
+          DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "RX ring blocks:", mBlockNum, "block size:", mBlockSize,
+              "timeout(ms):", blockTimeout);
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+
+void IasAvbReceiveRing::cleanup()
+{
+  if (NULL != mRing)
+  {
+    (void) ::munmap(mRing, mRingSize);
+    mRing = NULL;
+    mRingSize = 0u;
+    mFrame = NULL;
+    mFramesLeft = 0u;
+  }
+  mSocket = -1;
+}
+
+
+uint8_t* IasAvbReceiveRing::nextFrame(uint32_t &length, uint64_t &timestamp)
+{
+  uint8_t * frame = NULL;
+
+  if (NULL != mRing)
+  {
+    if ((NULL != mFrame) && (0u == mFramesLeft))
+    {
+      // all frames of the block have been processed
+      releaseBlock();
+    }
+
+    if (NULL == mFrame)
+    {
+      struct tpacket_block_desc * const desc = reinterpret_cast<struct tpacket_block_desc*>(mRing + (size_t(mBlockIdx) * mBlockSize));
+
+      if (0u != (__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+      {
+        mFramesLeft = desc->hdr.bh1.num_pkts;
+        mFrame = reinterpret_cast<uint8_t*>(desc) + desc->hdr.bh1.offset_to_first_pkt;
+        mBlockCount++;
+
+        if (0u == mFramesLeft)
+        {
+          // empty block retired by the timeout
+          releaseBlock();
+        }
+      }
+    }
+
+    if ((NULL != mFrame) && (0u != mFramesLeft))
+    {
+      const struct tpacket3_hdr * const hdr = reinterpret_cast<const struct tpacket3_hdr*>(mFrame);
+
+      frame = mFrame + hdr->tp_mac;
+      length = hdr->tp_snaplen;
+      timestamp = (uint64_t(hdr->tp_sec) * 1000000000u) + uint64_t(hdr->tp_nsec);
+      mHardwareTimestamp = (0u != (hdr->tp_status & TP_STATUS_TS_RAW_HARDWARE));
+
+      mFrame += hdr->tp_next_offset;
+      mFramesLeft--;
+    }
+  }
+
+  return frame;
+}
+
+
+void IasAvbReceiveRing::releaseBlock()
+{
+  struct tpacket_block_desc * const desc = reinterpret_cast<struct tpacket_block_desc*>(mRing + (size_t(mBlockIdx) * mBlockSize));
+
+  __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  mBlockIdx = (mBlockIdx + 1u) % mBlockNum;
+  mFrame = NULL;
+  mFramesLeft = 0u;
+}
+
+
+bool IasAvbReceiveRing::getStatistics(uint32_t &packets, uint32_t &drops, uint32_t &freezes)
+{
+  bool ok = false;
+
+  if (mSocket >= 0)
+  {
+    struct tpacket_stats_v3 stats;
+    socklen_t len = sizeof stats;
+    std::memset(&stats, 0, sizeof stats);
+
+    if (::getsockopt(mSocket, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0)
+    {
+      packets = stats.tp_packets;
+      drops = stats.tp_drops;
+      freezes = stats.tp_freeze_q_cnt;
+      ok = true;
+    }
+  }
+
+  return ok;
+}
+
+} // namespace IasMediaTransportAvb
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbRxStreamTable.cpp
+ * @brief   The definition of the IasAvbRxStreamTable class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbRxStreamTable.hpp"
+
+#include <new>
+#include <cstring>
+
+namespace IasMediaTransportAvb {
+
+/*
+ *  Constructor.
+ */
+IasAvbRxStreamTable::IasAvbRxStreamTable()
+  : mSlots(NULL)
+  , mMask(0u)
+  , mEntries(NULL)
+  , mNumEntries(0u)
+  , mMaxEntries(0u)
+  , mGeneration(0u)
+  , mNumShards(1u)
+  , mShardGeneration(0u)
+{
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbRxStreamTable::~IasAvbRxStreamTable()
+{
+  delete[] mSlots;
+  mSlots = NULL;
+  delete[] mEntries;
+  mEntries = NULL;
+}
+
+
+IasAvbProcessingResult IasAvbRxStreamTable::init(uint32_t maxEntries)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (NULL != mSlots)
+  {
+    result = eIasAvbProcInitializationFailed;
+  }
+  else if (maxEntries > 0x40000000u)
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    // keep the load factor at or below 0.5 so that probe sequences stay short
+    uint32_t numSlots = cMinSlots;
+    while (numSlots < (2u * maxEntries))
+    {
+      numSlots *= 2u;
+    }
+
+    mSlots = new (std::nothrow) Slot[numSlots];
+    mEntries = new (std::nothrow) Slot[(0u == maxEntries) ? 1u : maxEntries];
+
+    if ((NULL == mSlots) || (NULL == mEntries))
+    {
+      delete[] mSlots;
+      mSlots = NULL;
+      delete[] mEntries;
+      mEntries = NULL;
+      result = eIasAvbProcNotEnoughMemory;
+    }
+    else
+    {
+      std::memset(mSlots, 0, sizeof(Slot) * numSlots);
+      mMask = numSlots - 1u;
+      mMaxEntries = maxEntries;
+      mNumEntries = 0u;
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbRxStreamTable::insert(uint64_t streamId, IasAvbRxStreamData * data)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (NULL == mSlots)
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else if ((NULL == data) || (mNumEntries >= mMaxEntries))
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    uint32_t idx = uint32_t(hash(streamId) & mMask);
+    while (NULL != mSlots[idx].data)
+    {
+      if (streamId == mSlots[idx].streamId)
+      {
+        result = eIasAvbProcAlreadyInUse;
+        break;
+      }
+      idx = (idx + 1u) & mMask;
+    }
+
+    if (eIasAvbProcOK == result)
+    {
+      mSlots[idx].streamId = streamId;
+      mSlots[idx].data = data;
+      mEntries[mNumEntries++] = mSlots[idx];
+    }
+  }
+
+  return result;
+}
+
+} // namespace IasMediaTransportAvb
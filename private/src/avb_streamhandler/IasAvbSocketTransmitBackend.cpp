@@ -0,0 +1,621 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbSocketTransmitBackend.cpp
+ * @brief   The definition of the IasAvbSocketTransmitBackend class.
+ * @date    2018
+ */
+
+#include <time.h> // make sure we include the right timespec definition
+#include "avb_streamhandler/IasAvbSocketTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbTSpec.hpp"
+#include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
+#include <dlt/dlt_cpp_extension.hpp>
+
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <cstring>
+
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbSocketTransmitBackend::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+/*
+ * offset of the frame data within a TPACKET_V2 TX ring frame
+ * (the sockaddr_ll part of the header is only used on the receive side)
+ */
+static const size_t cRingDataOffset = TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+
+/*
+ *  Constructor.
+ */
+IasAvbSocketTransmitBackend::IasAvbSocketTransmitBackend(DltContext &ctx)
+  : mSocket(-1)
+  , mIfIndex(0)
+  , mRing(NULL)
+  , mRingSize(0u)
+  , mFrameCount(0u)
+  , mHead(0u)
+  , mTail(0u)
+  , mInFlight(0u)
+  , mClockOffset(0)
+  , mLastOffsetUpdate(0u)
+  , mQdiscDropped(0u)
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbSocketTransmitBackend::~IasAvbSocketTransmitBackend()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+IasAvbProcessingResult IasAvbSocketTransmitBackend::init(uint32_t queueIndex, IasAvbSrClass qavClass)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  const std::string * ifname = IasAvbStreamHandlerEnvironment::getNetworkInterfaceName();
+
+  // the TX queue is selected through the socket priority
+  (void) queueIndex;
+
+  if (mSocket >= 0)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "already initialized!");
+    result = eIasAvbProcInitializationFailed;
+  }
+  else if ((NULL == ifname) || ifname->empty())
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Network interface name missing!");
+    result = eIasAvbProcInitializationFailed;
+  }
+  else
+  {
+    mIfIndex = int32_t(::if_nametoindex(ifname->c_str()));
+    if (0 == mIfIndex)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "unknown network interface", ifname->c_str());
+      result = eIasAvbProcInitializationFailed;
+    }
+  }
+
+  if (eIasAvbProcOK == result)
+  {
+    // protocol 0: the socket is used for sending only and must not receive any frames
+    mSocket = ::socket(AF_PACKET, SOCK_RAW, 0);
+    if (mSocket < 0)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't open transmit socket! (", int32_t(errno), ", ", strerror(errno), ")");
+      result = eIasAvbProcInitializationFailed;
+    }
+  }
+
+  if (eIasAvbProcOK == result)
+  {
+    uint32_t prio = (IasAvbSrClass::eIasAvbSrClassHigh == qavClass) ? cDefaultPriorityHigh : cDefaultPriorityLow;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(std::string(IasRegKeys::cXmitSocketPrio) + IasAvbTSpec::getClassSuffix(qavClass), prio);
+
+    const int32_t sockPrio = int32_t(prio);
+    if (::setsockopt(mSocket, SOL_SOCKET, SO_PRIORITY, &sockPrio, sizeof sockPrio) < 0)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't set socket priority", sockPrio, "(", int32_t(errno), ", ", strerror(errno), ")");
+      result = eIasAvbProcInitializationFailed;
+    }
+    else
+    {
+      struct sock_txtime txtimeCfg;
+      txtimeCfg.clockid = CLOCK_TAI;
+      txtimeCfg.flags = SOF_TXTIME_REPORT_ERRORS;
+
+      if (::setsockopt(mSocket, SOL_SOCKET, SO_TXTIME, &txtimeCfg, sizeof txtimeCfg) < 0)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "SO_TXTIME not supported by the kernel! (", int32_t(errno), ", ", strerror(errno), ")");
+        result = eIasAvbProcInitializationFailed;
+      }
+      else
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "using", ifname->c_str(), "socket priority", sockPrio);
+      }
+    }
+  }
+
+  if (eIasAvbProcOK == result)
+  {
+    uint32_t ringSize = cDefaultRingSize;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitSocketRingSize, ringSize);
+
+    if ((0u != ringSize) && (eIasAvbProcOK != setupRing(ringSize)))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "TX ring not available, falling back to sendmsg");
+    }
+
+    updateClockOffset(true);
+  }
+
+  if (eIasAvbProcOK != result)
+  {
+    cleanup();
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbSocketTransmitBackend::setupRing(uint32_t frameCount)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  const int32_t version = TPACKET_V2;
+
+  if (::setsockopt(mSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof version) < 0)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't select TPACKET_V2 (", int32_t(errno), ", ", strerror(errno), ")");
+    result = eIasAvbProcErr;
+  }
+  else
+  {
+    // block size must be a multiple of the page size, frames must not cross block boundaries
+    const long pageSize = ::sysconf(_SC_PAGESIZE);
+    const uint32_t blockSize = ((pageSize > 0) && (uint32_t(pageSize) > cFrameSize)) ? uint32_t(pageSize) : cFrameSize;
+    const uint32_t framesPerBlock = blockSize / cFrameSize;
+
+    struct tpacket_req req;
+    std::memset(&req, 0, sizeof req);
+    req.tp_block_size = blockSize;
+    req.tp_block_nr = (frameCount + framesPerBlock - 1u) / framesPerBlock;
+    req.tp_frame_size = cFrameSize;
+    req.tp_frame_nr = req.tp_block_nr * framesPerBlock;
+
+    if (::setsockopt(mSocket, SOL_PACKET, PACKET_TX_RING, &req, sizeof req) < 0)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't set up TX ring (", int32_t(errno), ", ", strerror(errno), ")");
+      result = eIasAvbProcErr;
+    }
+    else
+    {
+      mRingSize = size_t(req.tp_block_size) * size_t(req.tp_block_nr);
+      void * ring = ::mmap(NULL, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, mSocket, 0);
+      if (MAP_FAILED == ring)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't map TX ring (", int32_t(errno), ", ", strerror(errno), ")");
+        mRingSize = 0u;
+        result = eIasAvbProcErr;
+      }
+      else
+      {
+        mRing = static_cast<uint8_t*>(ring);
+        mFrameCount = req.tp_frame_nr;
+        mHead = 0u;
+        mTail = 0u;
+        mInFlight = 0u;
+        DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "TX ring frames:", mFrameCount);
+      }
+    }
+  }
+
+  return result;
+}
+
+
+void IasAvbSocketTransmitBackend::cleanup()
+{
+  if (NULL != mRing)
+  {
+    (void) ::munmap(mRing, mRingSize);
+    mRing = NULL;
+    mRingSize = 0u;
+    mFrameCount = 0u;
+  }
+
+  if (mSocket >= 0)
+  {
+    (void) ::close(mSocket);
+    mSocket = -1;
+  }
+}
+
+
+int32_t IasAvbSocketTransmitBackend::xmit(IasAvbPacket * packet)
+{
+  int32_t ret = 0;
+
+  AVB_ASSERT(NULL != packet);
+
+  if (mSocket < 0)
+  {
+    ret = -ENXIO;
+  }
+  else if (!isSendable(packet))
+  {
+    ret = -EINVAL;
+  }
+  else
+  {
+    const uint64_t txTime = uint64_t(int64_t(packet->attime) + mClockOffset);
+
+    if (NULL != mRing)
+    {
+      uint8_t * const frame = mRing + (size_t(mHead) * cFrameSize);
+      volatile struct tpacket2_hdr * const hdr = reinterpret_cast<volatile struct tpacket2_hdr*>(frame);
+
+      if (TP_STATUS_AVAILABLE != hdr->tp_status)
+      {
+        // frame still owned by the kernel, i.e. the qdisc holds as many packets as the ring has frames
+        ret = ENOSPC;
+      }
+      else
+      {
+        std::memcpy(frame + cRingDataOffset, packet->getBasePtr(), packet->len);
+        hdr->tp_len = packet->len;
+        __sync_synchronize();
+        hdr->tp_status = TP_STATUS_SEND_REQUEST;
+
+        ret = sendFrame(NULL, 0u, txTime);
+        if ((0 == ret) || (ENOBUFS == ret))
+        {
+          mHead = (mHead + 1u) % mFrameCount;
+          mInFlight++;
+        }
+        else if (TP_STATUS_SENDING != hdr->tp_status)
+        {
+          // frame has not been picked up by the kernel, make it available again
+          hdr->tp_status = TP_STATUS_AVAILABLE;
+        }
+        else
+        {
+          // kernel will release the frame later
+          mHead = (mHead + 1u) % mFrameCount;
+          mInFlight++;
+        }
+      }
+    }
+    else
+    {
+      ret = sendFrame(packet->getBasePtr(), packet->len, txTime);
+    }
+
+    if (ENOBUFS == ret)
+    {
+      // dropped by the qdisc, e.g. launch time already passed: the packet is gone, nothing to retry
+      mQdiscDropped++;
+      ret = 0;
+    }
+
+    if (0 == ret)
+    {
+      // data has been copied, buffer can be re-used right away
+      (void) IasAvbPacketPool::returnPacket(packet);
+    }
+    else
+    {
+      ret = toXmitResult(ret);
+    }
+  }
+
+  return ret;
+}
+
+
+uint32_t IasAvbSocketTransmitBackend::xmitBurst(IasAvbPacket * const * packets, uint32_t count, int32_t &result)
+{
+  uint32_t accepted = 0u;
+
+  AVB_ASSERT((NULL != packets) || (0u == count));
+
+  if ((mSocket < 0) || (NULL != mRing))
+  {
+    // the launch time of a ring flush applies to all frames, so the ring is flushed per frame
+    accepted = IasAvbTransmitBackend::xmitBurst(packets, count, result);
+  }
+  else
+  {
+    struct sockaddr_ll addr;
+    std::memset(&addr, 0, sizeof addr);
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_8021Q);
+    addr.sll_ifindex = mIfIndex;
+
+    struct mmsghdr msgs[cMaxBurstSize];
+    struct iovec iovs[cMaxBurstSize];
+    union
+    {
+      struct cmsghdr align;
+      uint8_t buf[CMSG_SPACE(sizeof(uint64_t))];
+    } control[cMaxBurstSize];
+
+    result = 0;
+    while ((accepted < count) && (0 == result))
+    {
+      // collect as many sendable packets as fit into one call
+      uint32_t num = 0u;
+      while ((num < cMaxBurstSize) && ((accepted + num) < count) && isSendable(packets[accepted + num]))
+      {
+        IasAvbPacket * const packet = packets[accepted + num];
+        const uint64_t txTime = uint64_t(int64_t(packet->attime) + mClockOffset);
+
+        iovs[num].iov_base = packet->getBasePtr();
+        iovs[num].iov_len = packet->len;
+
+        struct msghdr & msg = msgs[num].msg_hdr;
+        std::memset(&msg, 0, sizeof msg);
+        msg.msg_name = &addr;
+        msg.msg_namelen = sizeof addr;
+        msg.msg_iov = &iovs[num];
+        msg.msg_iovlen = 1u;
+        std::memset(control[num].buf, 0, sizeof control[num].buf);
+        msg.msg_control = control[num].buf;
+        msg.msg_controllen = sizeof control[num].buf;
+
+        struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof txTime);
+        std::memcpy(CMSG_DATA(cmsg), &txTime, sizeof txTime);
+
+        msgs[num].msg_len = 0u;
+        num++;
+      }
+
+      if (0u == num)
+      {
+        // first packet of the remaining burst is not sendable
+        result = -EINVAL;
+        break;
+      }
+
+      const int32_t sent = int32_t(::sendmmsg(mSocket, msgs, num, MSG_DONTWAIT));
+      if (sent < 0)
+      {
+        if (ENOBUFS == errno)
+        {
+          // first message dropped by the qdisc, e.g. launch time already passed, nothing to retry
+          mQdiscDropped++;
+          (void) IasAvbPacketPool::returnPacket(packets[accepted]);
+          accepted++;
+        }
+        else
+        {
+          result = toXmitResult(errno);
+        }
+      }
+      else
+      {
+        // data has been copied, buffers can be re-used right away
+        for (int32_t i = 0; i < sent; i++)
+        {
+          (void) IasAvbPacketPool::returnPacket(packets[accepted]);
+          accepted++;
+        }
+        // on a partial send the next iteration retries the remainder and fetches the error
+      }
+    }
+  }
+
+  return accepted;
+}
+
+
+bool IasAvbSocketTransmitBackend::isSendable(const IasAvbPacket * packet) const
+{
+  return (NULL != packet) && packet->isValid() && (packet->len <= (cFrameSize - cRingDataOffset));
+}
+
+
+int32_t IasAvbSocketTransmitBackend::toXmitResult(int32_t err)
+{
+  int32_t ret = err;
+
+  if ((ENXIO == err) || (ENODEV == err))
+  {
+    ret = -ENXIO;
+  }
+  else if ((EINVAL == err) || (EMSGSIZE == err))
+  {
+    ret = -EINVAL;
+  }
+  else
+  {
+    // ENOSPC or non-fatal error, caller keeps the packet
+  }
+
+  return ret;
+}
+
+
+int32_t IasAvbSocketTransmitBackend::sendFrame(const void * data, size_t len, uint64_t txTime)
+{
+  int32_t ret = 0;
+
+  struct sockaddr_ll addr;
+  std::memset(&addr, 0, sizeof addr);
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_8021Q);
+  addr.sll_ifindex = mIfIndex;
+
+  union
+  {
+    struct cmsghdr align;
+    uint8_t buf[CMSG_SPACE(sizeof txTime)];
+  } control;
+  std::memset(control.buf, 0, sizeof control.buf);
+
+  struct iovec iov;
+  iov.iov_base = const_cast<void*>(data);
+  iov.iov_len = len;
+
+  struct msghdr msg;
+  std::memset(&msg, 0, sizeof msg);
+  msg.msg_name = &addr;
+  msg.msg_namelen = sizeof addr;
+  if (NULL != data)
+  {
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1u;
+  }
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof control.buf;
+
+  struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_TXTIME;
+  cmsg->cmsg_len = CMSG_LEN(sizeof txTime);
+  std::memcpy(CMSG_DATA(cmsg), &txTime, sizeof txTime);
+
+  if (::sendmsg(mSocket, &msg, MSG_DONTWAIT) < 0)
+  {
+    ret = errno;
+  }
+
+  return ret;
+}
+
+
+uint32_t IasAvbSocketTransmitBackend::reclaim(bool doReclaim)
+{
+  uint32_t ret = 0u;
+
+  // each instance has its own socket and TX ring, so there is nothing shared to reclaim
+  (void) doReclaim;
+
+  if (mSocket >= 0)
+  {
+    // count the ring frames that have been released since the last call
+    while (0u != mInFlight)
+    {
+      volatile struct tpacket2_hdr * const hdr = reinterpret_cast<volatile struct tpacket2_hdr*>(mRing + (size_t(mTail) * cFrameSize));
+      const uint32_t status = hdr->tp_status;
+
+      if (0u != (status & TP_STATUS_WRONG_FORMAT))
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "malformed frame rejected by the kernel");
+        hdr->tp_status = TP_STATUS_AVAILABLE;
+      }
+      else if (TP_STATUS_AVAILABLE != status)
+      {
+        break;
+      }
+      else
+      {
+        // frame has been sent
+      }
+
+      mTail = (mTail + 1u) % mFrameCount;
+      mInFlight--;
+      ret++;
+    }
+
+    mQdiscDropped += readErrorQueue();
+    updateClockOffset(false);
+  }
+
+  return ret;
+}
+
+
+uint32_t IasAvbSocketTransmitBackend::readErrorQueue()
+{
+  uint32_t dropped = 0u;
+  union
+  {
+    struct cmsghdr align;
+    uint8_t buf[256];
+  } control;
+  struct msghdr msg;
+
+  for (;;)
+  {
+    std::memset(&msg, 0, sizeof msg);
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof control.buf;
+
+    if (::recvmsg(mSocket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+    {
+      break;
+    }
+
+    for (struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); NULL != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if ((SOL_PACKET == cmsg->cmsg_level) && (PACKET_TX_TIMESTAMP == cmsg->cmsg_type))
+      {
+        struct sock_extended_err err;
+        std::memcpy(&err, CMSG_DATA(cmsg), sizeof err);
+#if defined(SO_EE_ORIGIN_TXTIME)
+        if (SO_EE_ORIGIN_TXTIME == err.ee_origin)
+        {
+          dropped++;
+        }
+#else
+        (void) err;
+        dropped++;
+#endif
+      }
+    }
+  }
+
+  return dropped;
+}
+
+
+void IasAvbSocketTransmitBackend::updateClockOffset(bool force)
+{
+  IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
+  struct timespec tai1;
+  struct timespec tai2;
+
+  (void) ::clock_gettime(CLOCK_TAI, &tai1);
+  const uint64_t t1 = (uint64_t(tai1.tv_sec) * uint64_t(1000000000u)) + uint64_t(tai1.tv_nsec);
+
+  if ((NULL != ptp) && (force || ((t1 - mLastOffsetUpdate) > cClockOffsetUpdateInterval)))
+  {
+    // sample PTP time between two TAI readings to compensate for the time getLocalTime() takes
+    const uint64_t ptpTime = ptp->getLocalTime();
+    (void) ::clock_gettime(CLOCK_TAI, &tai2);
+    const uint64_t t2 = (uint64_t(tai2.tv_sec) * uint64_t(1000000000u)) + uint64_t(tai2.tv_nsec);
+
+    mClockOffset = int64_t(t1 + ((t2 - t1) / 2u)) - int64_t(ptpTime);
+    mLastOffsetUpdate = t1;
+
+    if (0u != mQdiscDropped)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "qdisc dropped", mQdiscDropped,
+          "packets (launch time missed or invalid), PTP to TAI offset:", mClockOffset);
+      mQdiscDropped = 0u;
+    }
+  }
+}
+
+
+void IasAvbSocketTransmitBackend::updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh)
+{
+  (void) maxFrameSizeHigh;
+
+  DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "shaping is done by the qdisc, cbs idleslope needed:",
+      bandwidth, "kBit/s");
+}
+
+
+} // namespace IasMediaTransportAvb
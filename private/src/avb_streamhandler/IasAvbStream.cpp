@@ -12,6 +12,7 @@
 #include "avb_streamhandler/IasAvbStream.hpp"
 
 #include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
 
 #include <cstring>
 #include <netinet/in.h>
@@ -44,6 +45,9 @@ IasAvbStream::IasAvbStream(DltContext &dltContext, const IasAvbStreamType stream
   , mVlanData(0u)
   , mPresentationTimeOffset(0u)
   , mPreconfigured(true)
+  , mRenderLock()
+  , mPrefetchHead(0u)
+  , mPrefetchCount(0u)
 {
   // yes, I know, the default ctor should have zeroed it already, but you never know.
   (void) std::memset( &mDmac, 0, cIasAvbMacAddressLength);
@@ -80,6 +84,7 @@ IasAvbStream::~IasAvbStream()
   mPresentationTimeOffset = 0u;
   mAvbClockDomain = NULL;
 
+  flushPrefetchedPackets();
   delete mPacketPool;
   mPacketPool = NULL;
 
@@ -195,6 +200,14 @@ IasAvbProcessingResult IasAvbStream::initTransmit(const IasAvbTSpec & tSpec, con
     }
 
 
+    uint64_t renderAhead = 0u;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitRenderAhead, renderAhead);
+    if (0u != renderAhead)
+    {
+      // packets waiting in the prefetch queue
+      poolSize += cMaxPrefetchPackets;
+    }
+
     if (eIasAvbProcOK == ret)
     {
       mPacketPool = new (nothrow) IasAvbPacketPool(*mLog);
@@ -205,7 +218,18 @@ IasAvbProcessingResult IasAvbStream::initTransmit(const IasAvbTSpec & tSpec, con
       }
       else
       {
-        ret = mPacketPool->init( tSpec.getMaxFrameSize() + IasAvbTSpec::cIasAvbPerFrameOverhead, poolSize );
+        const size_t packetSize = tSpec.getMaxFrameSize() + IasAvbTSpec::cIasAvbPerFrameOverhead;
+        IasAvbPacketArena * const arena = IasAvbStreamHandlerEnvironment::getPacketArena();
+
+        if ((NULL != arena) && (IasAvbPacketArena::getClassIndex(packetSize) < IasAvbPacketArena::cNumClasses))
+        {
+          // the pool size becomes the quota of the stream, memory is taken from the arena on demand
+          ret = mPacketPool->initShared( arena, packetSize, poolSize );
+        }
+        else
+        {
+          ret = mPacketPool->init( packetSize, poolSize );
+        }
       }
     }
 
@@ -278,6 +302,28 @@ IasAvbPacket* IasAvbStream::preparePacket(uint64_t nextWindowStart)
 {
    IasAvbPacket* packet = NULL;
 
+   // the queue is popped and a missing packet is rendered under one lock, so a packet rendered
+   // concurrently by prefetchPackets() can't end up behind a newer one
+   std::lock_guard<std::mutex> lock(mRenderLock);
+   if (0u != mPrefetchCount)
+   {
+     packet = mPrefetchQueue[mPrefetchHead];
+     mPrefetchHead = (mPrefetchHead + 1u) % cMaxPrefetchPackets;
+     mPrefetchCount--;
+   }
+   else
+   {
+     packet = renderPacket(nextWindowStart);
+   }
+
+   return packet;
+}
+
+
+IasAvbPacket* IasAvbStream::renderPacket(uint64_t nextWindowStart)
+{
+   IasAvbPacket* packet = NULL;
+
    if (isInitialized() && isTransmitStream())
    {
      AVB_ASSERT(NULL != mPacketPool);
@@ -299,6 +345,70 @@ IasAvbPacket* IasAvbStream::preparePacket(uint64_t nextWindowStart)
 }
 
 
+uint32_t IasAvbStream::prefetchPackets(uint64_t nextWindowStart, uint64_t horizon)
+{
+  uint32_t rendered = 0u;
+  bool done = false;
+
+  while (!done)
+  {
+    // one packet per lock, so the sequencer can keep on popping packets in between
+    std::lock_guard<std::mutex> lock(mRenderLock);
+
+    if (!isInitialized() || !isTransmitStream() || !isActive() || (cMaxPrefetchPackets == mPrefetchCount))
+    {
+      done = true;
+    }
+    else if (0u != mPrefetchCount)
+    {
+      const IasAvbPacket * const newest = mPrefetchQueue[(mPrefetchHead + mPrefetchCount - 1u) % cMaxPrefetchPackets];
+      done = (newest->attime >= horizon) || (0u == newest->attime) || newest->isDummyPacket();
+    }
+    else
+    {
+      // queue empty, render
+    }
+
+    if (!done)
+    {
+      IasAvbPacket * const packet = renderPacket(nextWindowStart);
+
+      if (NULL == packet)
+      {
+        done = true;
+      }
+      else
+      {
+        mPrefetchQueue[(mPrefetchHead + mPrefetchCount) % cMaxPrefetchPackets] = packet;
+        mPrefetchCount++;
+        rendered++;
+      }
+    }
+  }
+
+  return rendered;
+}
+
+
+void IasAvbStream::flushPrefetchedPackets()
+{
+  std::lock_guard<std::mutex> lock(mRenderLock);
+  flushPrefetchQueue();
+}
+
+
+void IasAvbStream::flushPrefetchQueue()
+{
+  while (0u != mPrefetchCount)
+  {
+    IasAvbPacketPool::returnPacket(mPrefetchQueue[mPrefetchHead]);
+    mPrefetchHead = (mPrefetchHead + 1u) % cMaxPrefetchPackets;
+    mPrefetchCount--;
+  }
+  mPrefetchHead = 0u;
+}
+
+
 void IasAvbStream::dispatchPacket(const void* packet, size_t length, uint64_t now)
 {
    if (isInitialized() && isReceiveStream())
@@ -334,9 +444,12 @@ void IasAvbStream::dispatchPacket(const void* packet, size_t length, uint64_t no
 }
 
 
-IasAvbProcessingResult IasAvbStream::resetPacketPool() const
+IasAvbProcessingResult IasAvbStream::resetPacketPool()
 {
   AVB_ASSERT( NULL != mPacketPool );
+  std::lock_guard<std::mutex> lock(mRenderLock);
+  // prefetched packets become invalid when the pool is reset
+  flushPrefetchQueue();
   return mPacketPool->reset();
 }
 
@@ -344,9 +457,12 @@ IasAvbProcessingResult IasAvbStream::resetPacketPool() const
 
 void IasAvbStream::activate(bool isError)
 {
+  // wait for a packet being rendered in another thread, it belongs to the previous activation
+  std::lock_guard<std::mutex> lock(mRenderLock);
   if (!mActive)
   {
     mActive = true;
+    flushPrefetchQueue();
     activationChanged();
 
     if (isError)
@@ -359,10 +475,12 @@ void IasAvbStream::activate(bool isError)
 
 void IasAvbStream::deactivate(bool isError)
 {
+  std::lock_guard<std::mutex> lock(mRenderLock);
   if (mActive)
   {
     mActive = false;
     activationChanged();
+    flushPrefetchQueue();
 
     if (isError)
     {
@@ -259,13 +259,33 @@ IasAvbProcessingResult IasAvbStreamHandler::init( const std::string& configName,
       {
         AVB_ASSERT( NULL != mEnvironment );
 
-        if (mEnvironment->createIgbDevice() != eIasAvbProcOK)
+        if (!IasAvbStreamHandlerEnvironment::isIgbTransmitBackend())
+        {
+          // socket and capture transmit backends do not need libigb, but the source MAC is still needed
+          DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, " using socket or capture transmit backend, igb_avb device not used");
+          if (mEnvironment->querySourceMac() != eIasAvbProcOK)
+          {
+            DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Couldn't query MAC address of network interface");
+            result = eIasAvbProcInitializationFailed;
+          }
+        }
+        else if (mEnvironment->createIgbDevice() != eIasAvbProcOK)
         {
           DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Init of igb_avb device failed");
           result = eIasAvbProcInitializationFailed;
         }
       }
       if (eIasAvbProcOK == result)
+      {
+        uint64_t sharedPool = 0u;
+        (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitSharedPool, sharedPool);
+        if ((0u != sharedPool) && (mEnvironment->createPacketArena() != eIasAvbProcOK))
+        {
+          DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Creation of shared packet arena failed!");
+          result = eIasAvbProcInitializationFailed;
+        }
+      }
+      if (eIasAvbProcOK == result)
       {
         if (mBTMEnable)
         {
@@ -1324,6 +1344,49 @@ IasAvbResult IasAvbStreamHandler::disconnectStreams(AvbStreamId networkStreamId)
 }
 
 
+IasAvbResult IasAvbStreamHandler::setChannelRouting(AvbStreamId networkStreamId, const ChannelRoutingList &routing)
+{
+  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+  IasAvbStreamId avbStreamId(networkStreamId);
+
+  lockApiMutex();
+
+  if (!isInitialized())
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else if ((NULL != mAvbTransmitEngine) && mAvbTransmitEngine->isValidStreamId(avbStreamId))
+  {
+    result = mAvbTransmitEngine->setChannelRouting(avbStreamId, routing);
+  }
+  else if ((NULL != mAvbReceiveEngine) && mAvbReceiveEngine->isValidStreamId(avbStreamId))
+  {
+    result = mAvbReceiveEngine->setChannelRouting(avbStreamId, routing);
+  }
+  else
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Invalid AVB stream ID!");
+  }
+
+  std::stringstream ssStreamId;
+  ssStreamId << "0x" << std::hex << networkStreamId;
+  if (eIasAvbProcOK == result)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, " Channel routing of", ssStreamId.str(), "set,",
+        uint32_t(routing.size()), "entries");
+  }
+  else
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Couldn't set channel routing of", ssStreamId.str(),
+        "ErrorCode", int32_t(result));
+  }
+
+  unlockApiMutex();
+
+  return mapResultCode(result);
+}
+
+
 IasAvbResult IasAvbStreamHandler::setChannelLayout(uint16_t localStreamId, uint8_t channelLayout)
 {
   IasAvbResult result = IasAvbResult::eIasAvbResultInvalidParam;
@@ -2097,7 +2160,7 @@ IasAvbProcessingResult IasAvbStreamHandler::start( bool resume)
             result = eIasAvbProcInitializationFailed;
           }
         }
-        else
+        else if (IasAvbStreamHandlerEnvironment::isIgbTransmitBackend())
         {
           result = eIasAvbProcErr;
           DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Resume: pIgbDev == NULL!");
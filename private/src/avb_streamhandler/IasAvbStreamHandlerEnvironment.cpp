@@ -12,6 +12,7 @@
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
 #include "avb_streamhandler/IasDiaLogger.hpp"
 #include "avb_streamhandler/IasAvbTSpec.hpp"
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
 #include "avb_streamhandler/IasLocalAudioBufferDesc.hpp"
 #include "avb_watchdog/IasSystemdWatchdogManager.hpp"
 #include "avb_watchdog/IasWatchdogTimerRegistration.hpp"
@@ -96,6 +97,7 @@ const size_t IasAvbStreamHandlerEnvironment::numDltContexts = sizeof dltContextN
 IasAvbStreamHandlerEnvironment::IasAvbStreamHandlerEnvironment(DltLogLevelType dltLogLevel)
   : mInterfaceName()
   , mPtpProxy(NULL)
+  , mPacketArena(NULL)
   , mMrpProxy(NULL)
   , mIgbDevice(NULL)
   , mStatusSocket(-1)
@@ -145,6 +147,10 @@ IasAvbStreamHandlerEnvironment::~IasAvbStreamHandlerEnvironment()
   delete mPtpProxy;
   mPtpProxy = NULL;
 
+  // all streams are gone by now, so no packet is leased anymore
+  delete mPacketArena;
+  mPacketArena = NULL;
+
   AVB_ASSERT(NULL == mMrpProxy); // not yet implemented, should not be set
 
   if (NULL != mIgbDevice)
@@ -221,7 +227,7 @@ IasAvbProcessingResult IasAvbStreamHandlerEnvironment::createPtpProxy()
     mPtpProxy = new (nothrow) IasLibPtpDaemon("/ptp", static_cast<uint32_t>(SHM_SIZE));
     if (NULL != mPtpProxy)
     {
-      if (NULL == mIgbDevice)
+      if ((NULL == mIgbDevice) && isIgbTransmitBackend())
       {
         // must create igb device first
         ret = eIasAvbProcInitializationFailed;
@@ -248,6 +254,36 @@ IasAvbProcessingResult IasAvbStreamHandlerEnvironment::createPtpProxy()
 }
 
 
+IasAvbProcessingResult IasAvbStreamHandlerEnvironment::createPacketArena()
+{
+  IasAvbProcessingResult ret = eIasAvbProcOK;
+
+  if (NULL == mPacketArena)
+  {
+    uint64_t maxPackets = 1024u;
+    (void) getConfigValue(IasRegKeys::cXmitSharedPoolMax, maxPackets);
+
+    mPacketArena = new (nothrow) IasAvbPacketArena(*mLog);
+    if (NULL == mPacketArena)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Not enough memory to allocate IasAvbPacketArena");
+      ret = eIasAvbProcNotEnoughMemory;
+    }
+    else
+    {
+      ret = mPacketArena->init(uint32_t(maxPackets));
+      if (eIasAvbProcOK != ret)
+      {
+        delete mPacketArena;
+        mPacketArena = NULL;
+      }
+    }
+  }
+
+  return ret;
+}
+
+
 IasAvbProcessingResult IasAvbStreamHandlerEnvironment::createMrpProxy()
 {
   return eIasAvbProcNotImplemented;
@@ -853,6 +889,15 @@ bool IasAvbStreamHandlerEnvironment::validateRegistryEntries()
    * to actually do the checks.
    */
 
+  {
+    std::string backend;
+    if (getConfigValue(IasRegKeys::cXmitBackend, backend) && (backend != "igb") && (backend != "socket") && (backend != "capture"))
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "invalid transmit backend", backend.c_str());
+      ret = false;
+    }
+  }
+
 #if !IAS_PREPRODUCTION_SW
   {
     uint64_t val = 0u;
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbTimeoutWheel.cpp
+ * @brief   The definition of the IasAvbTimeoutWheel class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbTimeoutWheel.hpp"
+
+#include <limits>
+
+namespace IasMediaTransportAvb {
+
+/*
+ *  Constructor.
+ */
+IasAvbTimeoutWheel::IasAvbTimeoutWheel()
+  : mTick(1u)
+  , mCurrent(0u)
+  , mNextExpiry(std::numeric_limits<uint64_t>::max())
+  , mCount(0u)
+{
+  clear(0u);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbTimeoutWheel::~IasAvbTimeoutWheel()
+{
+}
+
+
+IasAvbProcessingResult IasAvbTimeoutWheel::init(uint64_t tick, uint64_t now)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (0u == tick)
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    mTick = tick;
+    clear(now);
+  }
+
+  return result;
+}
+
+
+void IasAvbTimeoutWheel::clear(uint64_t now)
+{
+  for (uint32_t idx = 0u; idx < cLevel0Size; idx++)
+  {
+    mLevel0[idx] = NULL;
+  }
+  for (uint32_t idx = 0u; idx < cLevel1Size; idx++)
+  {
+    mLevel1[idx] = NULL;
+  }
+  mCurrent = now / mTick;
+  mNextExpiry = std::numeric_limits<uint64_t>::max();
+  mCount = 0u;
+}
+
+
+void IasAvbTimeoutWheel::add(Node * node, uint64_t deadline)
+{
+  AVB_ASSERT(NULL != node);
+  AVB_ASSERT(!isLinked(node));
+
+  node->deadline = deadline;
+  insert(node);
+  mCount++;
+}
+
+
+void IasAvbTimeoutWheel::remove(Node * node)
+{
+  AVB_ASSERT(NULL != node);
+
+  if (isLinked(node))
+  {
+    *node->pprev = node->next;
+    if (NULL != node->next)
+    {
+      node->next->pprev = node->pprev;
+    }
+    node->next = NULL;
+    node->pprev = NULL;
+    mCount--;
+  }
+}
+
+
+void IasAvbTimeoutWheel::insert(Node * node)
+{
+  // round up, a timeout must not expire before its deadline
+  uint64_t tick = (node->deadline / mTick) + ((0u != (node->deadline % mTick)) ? 1u : 0u);
+  if (tick <= mCurrent)
+  {
+    tick = mCurrent + 1u;
+  }
+
+  const uint64_t group = tick >> cLevel0Bits;
+  const uint64_t currentGroup = mCurrent >> cLevel0Bits;
+  uint64_t expiry = tick * mTick;
+
+  if ((tick - mCurrent) <= cLevel0Size)
+  {
+    // the slot of the current tick has been processed already, it is the one for current + size now
+    link(mLevel0[tick & (cLevel0Size - 1u)], node);
+  }
+  else
+  {
+    // groups ahead of the current one, the last slot also takes everything further away
+    const uint64_t ahead = ((group - currentGroup) < cLevel1Size) ? (group - currentGroup) : (cLevel1Size - 1u);
+    link(mLevel1[(currentGroup + ahead) & (cLevel1Size - 1u)], node);
+    expiry = ((currentGroup + ahead) << cLevel0Bits) * mTick;
+  }
+
+  if (expiry < mNextExpiry)
+  {
+    mNextExpiry = expiry;
+  }
+}
+
+
+IasAvbTimeoutWheel::Node * IasAvbTimeoutWheel::expire(uint64_t now)
+{
+  Node * expired = NULL;
+  const uint64_t nowTick = now / mTick;
+
+  if (0u == mCount)
+  {
+    mCurrent = (nowTick > mCurrent) ? nowTick : mCurrent;
+  }
+
+  while ((mCurrent < nowTick) && (0u != mCount))
+  {
+    mCurrent++;
+
+    if (0u == (mCurrent & (cLevel0Size - 1u)))
+    {
+      // entering a new group, distribute its timeouts to the first level
+      Node * node = mLevel1[(mCurrent >> cLevel0Bits) & (cLevel1Size - 1u)];
+      mLevel1[(mCurrent >> cLevel0Bits) & (cLevel1Size - 1u)] = NULL;
+      mCurrent--;   // so the timeouts due with this tick still go to the first level
+      while (NULL != node)
+      {
+        Node * const next = node->next;
+        node->pprev = NULL;
+        insert(node);
+        node = next;
+      }
+      mCurrent++;
+    }
+
+    Node * node = mLevel0[mCurrent & (cLevel0Size - 1u)];
+    mLevel0[mCurrent & (cLevel0Size - 1u)] = NULL;
+    while (NULL != node)
+    {
+      Node * const next = node->next;
+      node->pprev = NULL;
+      node->next = expired;
+      expired = node;
+      mCount--;
+      node = next;
+    }
+  }
+
+  if (mCurrent < nowTick)
+  {
+    // wheel ran empty
+    mCurrent = nowTick;
+  }
+
+  updateNextExpiry();
+
+  return expired;
+}
+
+
+void IasAvbTimeoutWheel::updateNextExpiry()
+{
+  mNextExpiry = std::numeric_limits<uint64_t>::max();
+
+  if (0u != mCount)
+  {
+    for (uint64_t tick = mCurrent + 1u; tick <= (mCurrent + cLevel0Size); tick++)
+    {
+      if (NULL != mLevel0[tick & (cLevel0Size - 1u)])
+      {
+        mNextExpiry = tick * mTick;
+        break;
+      }
+    }
+
+    const uint64_t currentGroup = mCurrent >> cLevel0Bits;
+    for (uint64_t group = currentGroup + 1u; group < (currentGroup + cLevel1Size); group++)
+    {
+      if (NULL != mLevel1[group & (cLevel1Size - 1u)])
+      {
+        const uint64_t expiry = (group << cLevel0Bits) * mTick;
+        mNextExpiry = (expiry < mNextExpiry) ? expiry : mNextExpiry;
+        break;
+      }
+    }
+  }
+}
+
+} // namespace IasMediaTransportAvb
@@ -45,6 +45,7 @@ static const std::string cClassName = "IasAvbTransmitEngine::";
  */
 IasAvbTransmitEngine::IasAvbTransmitEngine()
   : mIgbDevice(NULL)
+  , mInitialized(false)
   , mAvbStreams()
   , mUseShaper(false)
   , mUseResume(false)
@@ -82,7 +83,12 @@ IasAvbProcessingResult IasAvbTransmitEngine::init()
   }
 
   mIgbDevice = IasAvbStreamHandlerEnvironment::getIgbDevice();
-  if (NULL == mIgbDevice)
+  if (!IasAvbStreamHandlerEnvironment::isIgbTransmitBackend())
+  {
+    // socket or capture transmit backend, the sequencers send through their own sockets or files
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "using socket or capture transmit backend");
+  }
+  else if (NULL == mIgbDevice)
   {
     /**
      * @log Init failed: Returned igbDevice == NULL
@@ -90,8 +96,12 @@ IasAvbProcessingResult IasAvbTransmitEngine::init()
     DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "mIgbDevice == NULL!");
     result = eIasAvbProcInitializationFailed;
   }
+  else
+  {
+    // igb transmit backend
+  }
 
-  if (eIasAvbProcOK == result)
+  if ((eIasAvbProcOK == result) && (NULL != mIgbDevice))
   {
     uint64_t val = 0u;
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitUseShaper, val);
@@ -132,6 +142,10 @@ IasAvbProcessingResult IasAvbTransmitEngine::init()
   {
     cleanup();
   }
+  else
+  {
+    mInitialized = true;
+  }
   return result;
 }
 
@@ -158,6 +172,7 @@ void IasAvbTransmitEngine::cleanup()
   }
 
   mIgbDevice = NULL;
+  mInitialized = false;
   mAvbStreams.clear();
 }
 
@@ -261,7 +276,7 @@ void IasAvbTransmitEngine::updateLinkStatus(const bool linkIsUp)
                 strerror(err));
         }
       }
-      else
+      else if (IasAvbStreamHandlerEnvironment::isIgbTransmitBackend())
       {
         DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "mIgbDevice == NULL!");
       }
@@ -861,11 +876,14 @@ void IasAvbTransmitEngine::updateShapers()
    * in a packet on the wire of exactly 1000bits, which enables us to use the class_a and class_b
    * parameters to specify the bandwidth in kbit/observationInterval
    */
-  const int32_t err = igb_set_class_bandwidth(mIgbDevice, bwHigh, bwLow, 83u, 83u);
-  if (err < 0)
+  if (NULL != mIgbDevice)
   {
-      DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "Couldn't configure shaper: ",
-          strerror(err));
+    const int32_t err = igb_set_class_bandwidth(mIgbDevice, bwHigh, bwLow, 83u, 83u);
+    if (err < 0)
+    {
+        DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "Couldn't configure shaper: ",
+            strerror(err));
+    }
   }
 }
 
@@ -982,6 +1000,38 @@ IasAvbProcessingResult IasAvbTransmitEngine::disconnectStreams(const IasAvbStrea
 }
 
 
+IasAvbProcessingResult IasAvbTransmitEngine::setChannelRouting(const IasAvbStreamId & avbStreamId, const ChannelRoutingList & routing)
+{
+  IasAvbProcessingResult result = eIasAvbProcInvalidParam;
+
+  // look-up AVB stream using the specified AVB stream id
+  AvbStreamMap::iterator it = mAvbStreams.find(avbStreamId);
+  if (it != mAvbStreams.end())
+  {
+    AVB_ASSERT(NULL != it->second);
+
+    if (eIasAvbAudioStream == it->second->getStreamType())
+    {
+      result = static_cast<IasAvbAudioStream*>(it->second)->setChannelRouting(routing);
+    }
+    else
+    {
+      /**
+       * @log The StreamId parameter provided does not have a AudioStream type.
+       */
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Wrong type! AvbStreamId does not correspond to an AvbAudioStream");
+    }
+  }
+  else
+  {
+    uint64_t sid = avbStreamId;
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Invalid streamId", sid);
+  }
+
+  return result;
+}
+
+
 bool IasAvbTransmitEngine::getAvbStreamInfo(const IasAvbStreamId &id,
                                             AudioStreamInfoList &audioStreamInfo,
                                             VideoStreamInfoList &videoStreamInfo,
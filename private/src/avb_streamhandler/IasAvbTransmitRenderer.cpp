@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbTransmitRenderer.cpp
+ * @brief   The definition of the IasAvbTransmitRenderer class.
+ * @date    2018
+ */
+
+#include <time.h> // make sure we include the right timespec definition
+#include "avb_streamhandler/IasAvbTransmitRenderer.hpp"
+#include "avb_streamhandler/IasAvbStream.hpp"
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbTransmitRenderer::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+/*
+ *  Constructor.
+ */
+IasAvbTransmitRenderer::IasAvbTransmitRenderer(DltContext &ctx)
+  : mRenderThread(NULL)
+  , mClass(IasAvbSrClass::eIasAvbSrClassHigh)
+  , mRenderAhead(0u)
+  , mPitch(0u)
+  , mCpu(-1)
+  , mEndThread(false)
+  , mLock()
+  , mStreams()
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbTransmitRenderer::~IasAvbTransmitRenderer()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+  cleanup();
+}
+
+
+/*
+ *  Initialization method.
+ */
+IasAvbProcessingResult IasAvbTransmitRenderer::init(IasAvbSrClass qavClass, uint64_t renderAhead, uint64_t pitch)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+  const char * const suffix = IasAvbTSpec::getClassSuffix(qavClass);
+
+  if ((0u == renderAhead) || (0u == pitch))
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    mClass = qavClass;
+    mRenderAhead = renderAhead;
+    mPitch = pitch;
+
+    uint64_t useThread = 0u;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitRenderThread, useThread);
+
+    if (0u != useThread)
+    {
+      uint64_t cpu = uint64_t(-1);
+      if (IasAvbStreamHandlerEnvironment::getConfigValue(std::string(IasRegKeys::cXmitRenderCpu) + suffix, cpu))
+      {
+        mCpu = int32_t(cpu);
+      }
+
+      mRenderThread = new (nothrow) IasThread(this, std::string("AvbTxRnd") + suffix);
+      if (NULL == mRenderThread)
+      {
+        /**
+         * @log Not enough memory to create the thread.
+         */
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create render thread!");
+        result = eIasAvbProcNotEnoughMemory;
+      }
+    }
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "rendering", mRenderAhead, "ns ahead",
+        (NULL != mRenderThread) ? "in render thread" : "in TX thread", "cpu:", mCpu);
+  }
+
+  return result;
+}
+
+
+void IasAvbTransmitRenderer::cleanup()
+{
+  if ((NULL != mRenderThread) && mRenderThread->isRunning())
+  {
+    mRenderThread->stop();
+  }
+  delete mRenderThread;
+  mRenderThread = NULL;
+
+  std::lock_guard<std::mutex> lock(mLock);
+  mStreams.clear();
+}
+
+
+IasAvbProcessingResult IasAvbTransmitRenderer::start()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if (NULL != mRenderThread)
+  {
+    IasThreadResult res = mRenderThread->start(true);
+    if ((res != IasResult::cOk) && (res != IasThreadResult::cThreadAlreadyStarted))
+    {
+      result = eIasAvbProcThreadStartFailed;
+    }
+  }
+
+  return result;
+}
+
+
+IasAvbProcessingResult IasAvbTransmitRenderer::stop()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if ((NULL != mRenderThread) && mRenderThread->isRunning())
+  {
+    if (mRenderThread->stop() != IasResult::cOk)
+    {
+      result = eIasAvbProcThreadStopFailed;
+    }
+  }
+
+  return result;
+}
+
+
+void IasAvbTransmitRenderer::setStreams(const std::vector<IasAvbStream*> & streams)
+{
+  std::lock_guard<std::mutex> lock(mLock);
+  mStreams = streams;
+}
+
+
+uint32_t IasAvbTransmitRenderer::render(uint64_t windowStart)
+{
+  uint32_t rendered = 0u;
+
+  std::lock_guard<std::mutex> lock(mLock);
+  for (size_t idx = 0u; idx < mStreams.size(); idx++)
+  {
+    AVB_ASSERT(NULL != mStreams[idx]);
+    rendered += mStreams[idx]->prefetchPackets(windowStart + mPitch, windowStart + mRenderAhead);
+  }
+
+  return rendered;
+}
+
+
+void IasAvbTransmitRenderer::setupThread()
+{
+  struct sched_param sparam;
+  std::string policyStr = "fifo";
+  int32_t priority = 1;
+
+  // same scheduling parameters as the TX thread, the render thread has to keep up with it
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cSchedPolicy, policyStr);
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cSchedPriority, priority);
+
+  int32_t policy = (policyStr == "other") ? SCHED_OTHER : (policyStr == "rr") ? SCHED_RR : SCHED_FIFO;
+  sparam.sched_priority = priority;
+
+  int32_t errval = pthread_setschedparam(pthread_self(), policy, &sparam);
+  if (0 != errval)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Error setting scheduler parameter:", strerror(errval));
+  }
+
+  if (0 <= mCpu)
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(mCpu, &cpuSet);
+    errval = pthread_setaffinity_np(pthread_self(), sizeof cpuSet, &cpuSet);
+    if (0 != errval)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Error setting CPU affinity to", mCpu, ":", strerror(errval));
+    }
+  }
+}
+
+
+IasResult IasAvbTransmitRenderer::beforeRun()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX);
+  mEndThread = false;
+  return IasResult::cOk;
+}
+
+
+IasResult IasAvbTransmitRenderer::run()
+{
+  IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
+  AVB_ASSERT(NULL != ptp);
+
+  setupThread();
+
+  while (!mEndThread)
+  {
+    (void) render(ptp->getLocalTime());
+
+    timespec req;
+    IasLibPtpDaemon::convertNsToTimespec(mPitch, req);
+    (void) clock_nanosleep(CLOCK_MONOTONIC, 0, &req, NULL);
+  }
+
+  return IasResult::cOk;
+}
+
+
+IasResult IasAvbTransmitRenderer::shutDown()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX);
+  mEndThread = true;
+  return IasResult::cOk;
+}
+
+
+IasResult IasAvbTransmitRenderer::afterRun()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX);
+  return IasResult::cOk;
+}
+
+} // namespace IasMediaTransportAvb
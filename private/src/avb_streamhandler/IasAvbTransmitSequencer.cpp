@@ -18,6 +18,12 @@
 #include "avb_streamhandler/IasAvbVideoStream.hpp"
 #include "avb_streamhandler/IasAvbPacket.hpp"
 #include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
+#include "avb_streamhandler/IasAvbIgbTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbSocketTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbCaptureTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbTransmitRenderer.hpp"
+#include "avb_streamhandler/IasAvbTransmitWindowController.hpp"
 #include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEventInterface.hpp"
 // TO BE REPLACED #include "core_libraries/btm/ias_dlt_btm.h"
@@ -42,22 +48,15 @@ namespace IasMediaTransportAvb {
 static const std::string cClassName = "IasAvbTransmitSequencer::";
 #define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
 
-#define TQAVCTRL      0x03570
-#define TQAVHC(_n)    (0x0300C + ((_n) * 0x40))
-#define TQAVCC(_n)    (0x03004 + ((_n) * 0x40))
-
-#define TQAVCH_ZERO_CREDIT 0x80000000 /* not configured and always defaults to this value */
-#define TQAVCC_LINKRATE    0x7735     /* not configured and always defaults to this value */
-#define TQAVCC_QUEUEMODE   0x80000000 /* queue mode, 0=strict, 1=SR mode */
-#define TQAVCTRL_TX_ARB    0x00000100 /* data transmit arbitration */
-
 /*
  *  Constructor.
  */
 IasAvbTransmitSequencer::IasAvbTransmitSequencer(DltContext &ctx)
   : mThreadControl(0u)
   , mTransmitThread(NULL)
-  , mIgbDevice(NULL)
+  , mBackend(NULL)
+  , mRenderer(NULL)
+  , mWindowController(NULL)
   , mQueueIndex(uint32_t(-1))
   , mClass(IasAvbSrClass::eIasAvbSrClassHigh)
   , mRequestCount(0)
@@ -69,6 +68,9 @@ IasAvbTransmitSequencer::IasAvbTransmitSequencer(DltContext &ctx)
   , mShaperBwRate(100u)
   , mSequence()
   , mActiveStreams()
+  , mBurstPackets()
+  , mBurstStreams()
+  , mBurstRetained(0u)
   , mDoReclaim(false)
   , mLock()
   , mEventInterface(NULL)
@@ -76,7 +78,6 @@ IasAvbTransmitSequencer::IasAvbTransmitSequencer(DltContext &ctx)
   , mWatchdog(NULL)
   , mFirstRun(true)
   , mBTMEnable(false)
-  , mStrictPktOrderEn(true)
 {
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
 }
@@ -93,6 +94,7 @@ IasAvbTransmitSequencer::Config::Config()
   , txWindowMaxDropCount(8000u)
   , txDelay(100000u)
   , txMaxBandwidth(70000u)
+  , txRenderAhead(0u)
 {
   // do nothing
 }
@@ -110,6 +112,14 @@ IasAvbTransmitSequencer::Diag::Diag()
   , avgPacketReclaim(0.0f)
   , debugLastLaunchTime(0u)
   , debugLastStream(NULL)
+  , debugLastResetMsgOutputTime(0u)
+  , bursts(0u)
+  , burstPackets(0u)
+  , burstMaxSize(0u)
+  , burstTime(0u)
+  , burstMaxTime(0u)
+  , renderMisses(0u)
+  , burstRetries(0u)
 {
   // do nothing
 }
@@ -165,8 +175,17 @@ IasAvbProcessingResult IasAvbTransmitSequencer::init(uint32_t queueIndex, IasAvb
     mClass = qavClass;
     mQueueIndex = queueIndex;
     mDoReclaim = doReclaim;
-    mIgbDevice = IasAvbStreamHandlerEnvironment::getIgbDevice();
-    AVB_ASSERT(NULL != mIgbDevice);
+
+    result = createBackend();
+    if (eIasAvbProcOK == result)
+    {
+      result = mBackend->init(queueIndex, qavClass);
+    }
+
+    // avoid re-allocation in the worker thread
+    // leave room for packets carried over from a burst the backend did not accept completely
+    mBurstPackets.reserve(2u * cMaxBurstSize);
+    mBurstStreams.reserve(2u * cMaxBurstSize);
 
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndWidth, mConfig.txWindowWidthInit);
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndPitch, mConfig.txWindowPitchInit);
@@ -177,6 +196,7 @@ IasAvbProcessingResult IasAvbTransmitSequencer::init(uint32_t queueIndex, IasAvb
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitPrefetchThresh, mConfig.txWindowPrefetchThreshold);
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitDelay, mConfig.txDelay );
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(std::string(IasRegKeys::cTxMaxBw) + suffix, mConfig.txMaxBandwidth );
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitRenderAhead, mConfig.txRenderAhead);
 
     if ((mConfig.txWindowWidthInit < mConfig.txWindowPitchInit)
         || (mConfig.txWindowWidthInit < cMinTxWindowWidth)
@@ -189,7 +209,42 @@ IasAvbProcessingResult IasAvbTransmitSequencer::init(uint32_t queueIndex, IasAvb
       result = eIasAvbProcInitializationFailed;
     }
 
+    if ((eIasAvbProcOK == result) && (0u != mConfig.txRenderAhead))
+    {
+      mRenderer = new (nothrow) IasAvbTransmitRenderer(*mLog);
+      if (NULL == mRenderer)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create transmit renderer!");
+        result = eIasAvbProcNotEnoughMemory;
+      }
+      else
+      {
+        result = mRenderer->init(qavClass, mConfig.txRenderAhead, mConfig.txWindowPitchInit);
+      }
+    }
+
     uint64_t val = 0u;
+    (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndAdaptive, val);
+    if ((eIasAvbProcOK == result) && (0u != val))
+    {
+      uint64_t minWidth = mConfig.txWindowPitchInit + IasAvbTransmitWindowController::cStep;
+      uint64_t maxWidth = 2u * mConfig.txWindowWidthInit;
+      (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndWidthMin, minWidth);
+      (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitWndWidthMax, maxWidth);
+
+      mWindowController = new (nothrow) IasAvbTransmitWindowController(*mLog);
+      if (NULL == mWindowController)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create TX window controller!");
+        result = eIasAvbProcNotEnoughMemory;
+      }
+      else
+      {
+        result = mWindowController->init(mConfig.txWindowWidthInit, mConfig.txWindowPitchInit, minWidth, maxWidth);
+      }
+    }
+
+    val = 0u;
     (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitUseShaper, val);
 
     mUseShaper = (0u != val);
@@ -247,8 +302,15 @@ IasAvbProcessingResult IasAvbTransmitSequencer::init(uint32_t queueIndex, IasAvb
     }
   }
 
-  // the flag ensures xmit packets being sorted in ascending launchtime order but cpu load may increase
-  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitStrictPktOrder, mStrictPktOrderEn);
+  /* the flag used to enable sorting xmit packets in ascending launchtime order at the expense of cpu load,
+   * the launch time heap now always does this in O(log n), so the key is deprecated and has no effect
+   */
+  uint64_t strictPktOrder = 0u;
+  if (IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitStrictPktOrder, strictPktOrder))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, IasRegKeys::cXmitStrictPktOrder, "=", strictPktOrder,
+                "is deprecated and ignored, packets are always sent in launch time order");
+  }
 
   if (eIasAvbProcOK != result)
   {
@@ -267,6 +329,15 @@ void IasAvbTransmitSequencer::cleanup()
   delete mTransmitThread;
   mTransmitThread = NULL;
 
+  delete mRenderer;
+  mRenderer = NULL;
+
+  delete mWindowController;
+  mWindowController = NULL;
+
+  delete mBackend;
+  mBackend = NULL;
+
   if (NULL != mWatchdog)
   {
     IasWatchdog::IasSystemdWatchdogManager* wdManager = NULL;
@@ -388,22 +459,45 @@ IasAvbProcessingResult IasAvbTransmitSequencer::stop()
 }
 
 
+IasAvbProcessingResult IasAvbTransmitSequencer::createBackend()
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  AVB_ASSERT(NULL == mBackend);
+
+  std::string backend;
+  (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cXmitBackend, backend);
+
+  if (IasAvbStreamHandlerEnvironment::isIgbTransmitBackend())
+  {
+    mBackend = new (nothrow) IasAvbIgbTransmitBackend(*mLog);
+  }
+  else if ("capture" == backend)
+  {
+    mBackend = new (nothrow) IasAvbCaptureTransmitBackend(*mLog);
+  }
+  else
+  {
+    mBackend = new (nothrow) IasAvbSocketTransmitBackend(*mLog);
+  }
+
+  if (NULL == mBackend)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Couldn't create transmit backend!");
+    result = eIasAvbProcNotEnoughMemory;
+  }
+
+  return result;
+}
+
+
 uint32_t IasAvbTransmitSequencer::reclaimPackets()
 {
   uint32_t ret = 0u;
-  igb_packet* packetList = NULL;
 
-  if (mDoReclaim)
+  if (NULL != mBackend)
   {
-    // check and return packets that are not used any longer
-    // NOTE: this is done for all sequencers, not only for this one!
-    igb_clean(mIgbDevice, &packetList);
-    while (NULL != packetList)
-    {
-      IasAvbPacketPool::returnPacket(packetList);
-      ret++;
-      packetList = packetList->next;
-    }
+    ret = mBackend->reclaim(mDoReclaim);
   }
 
   return ret;
@@ -423,22 +517,12 @@ IasResult IasAvbTransmitSequencer::run()
   IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
   AVB_ASSERT(NULL != ptp);
   uint64_t windowStart = 0u;
-  size_t streamsToService = 0u;
   bool linkState = false;
   uint32_t linkStateWaitCount = 0u;
   uint64_t lastOversleep = 0u;
   uint32_t oversleepCount = 0u;
 
-  /*
-   * nextStreamToService either points to:
-   * 1) nothing (i.e. mSequence.end()) when the list is empty
-   * 2) a stream which does not currently have a packet to be sent (stream out of buffers, aka dry stream)
-   * 3) the packet with the closest launch time
-   */
-  AvbStreamDataList::iterator nextStreamToService = mSequence.end();
-
-  mConfig.txWindowWidth = mConfig.txWindowWidthInit;
-  mConfig.txWindowPitch = mConfig.txWindowPitchInit;
+  resetTxWindow();
 
   struct sched_param sparam;
   std::string policyStr = "fifo";
@@ -476,6 +560,13 @@ IasResult IasAvbTransmitSequencer::run()
   mDiag.debugLastResetMsgOutputTime = 0u;
   windowStart = ptp->getLocalTime();
   uint32_t lastEpoch = ptp->getEpochCounter();
+
+  // the renderer keeps running across the restarts after a PTP recovery
+  if ((NULL != mRenderer) && (eIasAvbProcOK != mRenderer->start()))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "failed to start render thread");
+  }
+
   while (0u == (mThreadControl & cFlagEndThread))
   {
     if (0u != mThreadControl)
@@ -509,7 +600,7 @@ IasResult IasAvbTransmitSequencer::run()
     {
       bool oldLinkState = linkState;
       checkLinkStatus(linkState);
-      updateSequence(nextStreamToService);
+      updateSequence();
 
       if (!linkState)
       {
@@ -547,9 +638,7 @@ IasResult IasAvbTransmitSequencer::run()
       {
         continue;
       }
-      streamsToService = mSequence.size();
-
-      if (0u != streamsToService)
+      if (0u != mSequence.size())
       {
         // there is at least one active stream, enable the watchdog
         if ((NULL != mWatchdog) && (false == mWatchdog->isRegistered()))
@@ -573,47 +662,55 @@ IasResult IasAvbTransmitSequencer::run()
           (void) mWatchdog->unregisterWatchdog();
       }
 
-      for (AvbStreamDataList::iterator it = mSequence.begin(); it != mSequence.end(); it++)
+      // move all streams parked during the previous window back into the heap
+      for (size_t idx = 0u; idx < mSequence.size(); idx++)
       {
-        it->done = eNotDone;
+        mSequence[idx].done = eNotDone;
       }
+      mSequence.rearm();
 
-      /* iterate through our sequence while dynamically resorting it until all streams have delivered
+      /* always service the stream with the earliest launch time until all streams have delivered
        * all packets belonging to the current TX window
        *
        * Note: By design, this could lead to the same stream being serviced multiple times in a row!
        */
-      while (!mThreadControl && (streamsToService > 0u))
+      bool abortWindow = false;
+      while (!mThreadControl && !abortWindow && !mSequence.empty())
       {
-        DoneState done = serviceStream(windowStart, nextStreamToService);
+        DoneState done = serviceStream(windowStart);
         switch (done)
         {
         case eNotDone:
-          // do nothing
-          break;
-
         case eEndOfWindow:
         case eDry:
-          streamsToService--;
+          // do nothing, serviceStream() already parked or re-inserted the stream
           break;
 
         case eWindowAdjust:
         case eTxError:
         default:
           // abort cycle and sleep
-          streamsToService = 0u;
+          abortWindow = true;
         }
-      }
 
-      if (mStrictPktOrderEn)
-      {
-        // re-sort streams based on launch time
-        (void) mSequence.sort();
-        nextStreamToService = mSequence.begin();
+        if (((mBurstPackets.size() - mBurstRetained) >= cMaxBurstSize) && (eTxError == flushBurst(windowStart)))
+        {
+          abortWindow = true;
+        }
       }
 
+      // hand over all packets collected for the current window at once
+      (void) flushBurst(windowStart);
+      const uint64_t serviceTime = ptp->getTsc() - previousSleepTimestamp;
+
       // advance TX window and sleep until the new window is reached
       windowStart += mConfig.txWindowPitch;
+
+      if ((NULL != mRenderer) && !mRenderer->isThreaded())
+      {
+        // packets are on their way, use the remaining time to prepare the next windows
+        (void) mRenderer->render(windowStart);
+      }
       const uint64_t sleepUntil = ptp->ptpToSys(windowStart);
 
       // Before triggering the sleep, ensure windowStart is still aligned with PTP Clock
@@ -636,6 +733,10 @@ IasResult IasAvbTransmitSequencer::run()
 
       const uint64_t timestampNow =  ptp->getTsc();
       int64_t over = timestampNow - sleepUntil;
+      if ((NULL != mWindowController) && mWindowController->update((over > 0) ? uint64_t(over) : 0u, serviceTime))
+      {
+        mConfig.txWindowWidth = mWindowController->getWidth();
+      }
       if (over > int64_t(mConfig.txWindowWidth - mConfig.txWindowPitch))
       {
         oversleepCount++;
@@ -669,20 +770,33 @@ IasResult IasAvbTransmitSequencer::run()
     (void) reclaimPackets();
 
     // return the packets still held by the sequence
-    for (AvbStreamDataList::iterator it = mSequence.begin(); it != mSequence.end(); it++)
+    for (size_t idx = 0u; idx < mBurstPackets.size(); idx++)
     {
-      if (NULL != it->packet)
+      IasAvbPacketPool::returnPacket(mBurstPackets[idx]);
+    }
+    mBurstPackets.clear();
+    mBurstStreams.clear();
+    mBurstRetained = 0u;
+
+    for (size_t idx = 0u; idx < mSequence.size(); idx++)
+    {
+      StreamData & data = mSequence[idx];
+      if (NULL != data.packet)
       {
-        IasAvbPacketPool::returnPacket(it->packet);
-        it->packet = NULL;
+        IasAvbPacketPool::returnPacket(data.packet);
+        data.packet = NULL;
       }
     }
 
-    nextStreamToService = mSequence.end();
     mSequence.clear();
 
   }
 
+  if (NULL != mRenderer)
+  {
+    (void) mRenderer->stop();
+  }
+
   // unregister the watchdog before exiting the thread
   if ((NULL != mWatchdog) && mWatchdog->isRegistered())
   {
@@ -725,7 +839,7 @@ void IasAvbTransmitSequencer::checkLinkStatus(bool &linkState)
   }
 }
 
-void IasAvbTransmitSequencer::updateSequence(AvbStreamDataList::iterator & nextStreamToService)
+void IasAvbTransmitSequencer::updateSequence()
 {
   // check for changes in the active streams set, indicated by an increased request counter
 
@@ -746,38 +860,29 @@ void IasAvbTransmitSequencer::updateSequence(AvbStreamDataList::iterator & nextS
     mLock.lock();
 
     AvbStreamSet temp = mActiveStreams;
-    for (AvbStreamDataList::iterator s = mSequence.begin(); s != mSequence.end(); /*in loop*/)
+    for (size_t idx = 0u; idx < mSequence.size(); /*in loop*/)
     {
-      if (temp.find(s->stream) == temp.end())
+      StreamData & data = mSequence[idx];
+      if (temp.find(data.stream) == temp.end())
       {
         // stream not found in active set anymore -> erase from sequence
-        if (nextStreamToService == s)
-        {
-          nextStreamToService++;
-          if (mSequence.end() == nextStreamToService)
-          {
-            nextStreamToService = mSequence.begin();
-          }
-        }
-        if (NULL != s->packet)
-        {
-          IasAvbPacketPool::returnPacket(s->packet);
-        }
-        s = mSequence.erase(s);
-        if (mSequence.size() == 0u)
+        if (NULL != data.packet)
         {
-          nextStreamToService = mSequence.end();
+          IasAvbPacketPool::returnPacket(data.packet);
         }
+        discardBurstPackets(data.stream);
+        // erase() moves another entry to idx, so do not advance
+        mSequence.erase(idx);
       }
       else
       {
         // take away from temp set so only the new ones remain
-        temp.erase(s->stream);
-        s++;
+        temp.erase(data.stream);
+        idx++;
       }
     }
 
-    // insert new streams into sequence
+    // insert new streams into sequence, launch time 0 makes them being serviced first
     for (AvbStreamSet::iterator it = temp.begin(); it != temp.end(); it++)
     {
       IasAvbStream * stream = *it;
@@ -787,19 +892,23 @@ void IasAvbTransmitSequencer::updateSequence(AvbStreamDataList::iterator & nextS
       newData.stream = stream;
       newData.packet = NULL;
       newData.launchTime = 0u;
-      mSequence.push_front( newData );
+      mSequence.push( newData );
+    }
+
+    mLock.unlock();
 
-      // this happens only when mSequence is empty
-      if (mSequence.end() == nextStreamToService)
+    if (NULL != mRenderer)
+    {
+      // blocks until the renderer has finished a pass over the previous set
+      std::vector<IasAvbStream*> streams;
+      streams.reserve(mSequence.size());
+      for (size_t idx = 0u; idx < mSequence.size(); idx++)
       {
-        nextStreamToService = mSequence.begin();
+        streams.push_back(mSequence[idx].stream);
       }
-
-      sortByLaunchTime(nextStreamToService);
+      mRenderer->setStreams(streams);
     }
 
-    mLock.unlock();
-
     /*
      * respond to client after sequence list is updated. In case of destroy stream request
      * client might destroy stream once sequencer responded to the request.
@@ -817,21 +926,17 @@ void IasAvbTransmitSequencer::updateSequence(AvbStreamDataList::iterator & nextS
     if (numStreamsOld > mSequence.size())
     {
       // less active streams, try if we can use the original TX timing
-      mConfig.txWindowWidth = mConfig.txWindowWidthInit;
-      mConfig.txWindowPitch = mConfig.txWindowPitchInit;
+      resetTxWindow();
     }
   }
 }
 
-IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64_t windowStart, AvbStreamDataList::iterator & nextStreamToService)
+IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64_t windowStart)
 {
-  int32_t result;
-  StreamData & current = *nextStreamToService;
+  StreamData & current = mSequence.top();
   bool fetch = true;
   uint64_t streamId = 0;
 
-  IasDiaLogger *diaLogger = IasAvbStreamHandlerEnvironment::getDiaLogger();
-
   if (NULL != current.stream)
   {
     streamId = uint64_t(current.stream->getStreamId());
@@ -853,7 +958,6 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
       {
         // stream does not need to be serviced within the current window
         current.done = eEndOfWindow;
-        nextStreamToService = next(nextStreamToService);
         fetch = false;
       }
       else
@@ -880,7 +984,7 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
         }
         else
         {
-          // send the packet
+          // set the final launch time, the packet is sent with the rest of the burst
           current.packet->attime = current.launchTime + mConfig.txDelay;
           if (current.packet->attime < mDiag.debugLastLaunchTime)
           {
@@ -935,85 +1039,10 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
           }
 #endif
 
-          result = current.packet->xmit(mIgbDevice, mQueueIndex);
-          if (mFirstRun && mBTMEnable)
-          {
-            mFirstRun = false;
-            // TO BE REPLACED ias_dlt_log_btm_mark(mLog, "avb sending now",NULL);
-          }
-          uint32_t counterTx = 0u;
-          switch (result)
-          {
-          case -EINVAL:
-          case -ENXIO:
-            // fatal errors, dispose of packet
-            IasAvbPacketPool::returnPacket(current.packet);
-            DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "igb_xmit error:", int32_t(result));
-            fetch = false;
-            current.done = eTxError;
-            break;
-
-          case 0:
-            // success
-            fetch = true;
-
-            counterTx = current.stream->incFramesTx();
-            (void) counterTx;
-            mDiag.sent++;
-
-            // Where to reset the counter
-            if (NULL != diaLogger)
-            {
-              diaLogger->incTxCount();
-            }
-
-            // reset the watchdog timer when packet was successfully sent
-            if ((NULL != mWatchdog) && mWatchdog->isRegistered())
-            {
-              (void) mWatchdog->reset();
-            }
-
-            break;
-
-          case ENOSPC:
-            {
-              // Insufficient ring size: Calculate the required ring size for diagnostic purposes
-              uint32_t frames = 0u;
-              for (AvbStreamDataList::iterator it = mSequence.begin(); it != mSequence.end(); it++)
-              {
-                AVB_ASSERT(NULL != it->stream);
-                frames += it->stream->getTSpec().getMaxIntervalFrames();
-              }
-              AVB_ASSERT(0u != mConfig.txWindowWidth);
-
-              const uint64_t reqRingSize = uint64_t(IasAvbTSpec::getPacketsPerSecondByClass(mClass)) * uint64_t(frames)
-                  * mConfig.txWindowWidth / uint64_t(1e9)
-                  * 2u // two entries per packet
-                  * 130u / 100u; // 30% margin
-
-              DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "TX ring buffer overflow detected! Try changing the ring buffer size.",
-                  "TX window:", mConfig.txWindowWidth,
-                  "active streams:", uint64_t(mSequence.size()),
-                  "frames/interval:", frames,
-                  "min ring size:", reqRingSize);
-
-              if ((mUseShaper) && (100u != mShaperBwRate))
-              {
-                DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Ignoring the TX ring buffer overflow error since the shaper is under debugging.");
-              }
-              else
-              {
-                mThreadControl |= cFlagRestartThread;
-              }
-            }
-            break;
-
-          default:
-            // unknown or non-fatal errors, try again
-            fetch = false;
-            DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "igb_xmit returns\n", int32_t(result));
-            break;
-          }
+          // queue the packet, it is handed over to the backend together with the rest of the window
+          mBurstPackets.push_back(current.packet);
+          mBurstStreams.push_back(current.stream);
+          fetch = true;
         }
       }
     } // if packet to send
@@ -1027,6 +1056,10 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
       // fetch new packet and re-sort the stream in the sequence, depending on the new packet's launch time
       fetch = false;
       bool isDry = (NULL == current.packet);
+      if ((NULL != mRenderer) && (0u == current.stream->getPrefetchedPacketCount()))
+      {
+        mDiag.renderMisses++;
+      }
       current.packet = current.stream->preparePacket(windowStart + mConfig.txWindowPitch);
 
       if (NULL != current.packet)
@@ -1076,7 +1109,6 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
           {
             // we're out of the tx window, done with this stream for now
             current.done = eEndOfWindow;
-            nextStreamToService = next(nextStreamToService);
           }
         }
         else if (timeFromWindowStart < -int64_t(mConfig.txWindowResetThreshold))
@@ -1144,11 +1176,7 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
         }
         else
         {
-          // yay, we're inside the window!
-          /* Note that the sort method also skips to the next stream already, but
-           * that skipping does not consider the 'done' state of that stream.
-           */
-          sortByLaunchTime(nextStreamToService);
+          // yay, we're inside the window! Re-insertion into the sequence is done below.
         }
       }
       else
@@ -1162,24 +1190,231 @@ IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::serviceStream(uint64
 
         current.launchTime = 0u;
         current.done = eDry;
-        nextStreamToService = next(nextStreamToService);
       }
     } // while fetch
   }
 
-  // if the next stream is done already, try to find one that is not done yet
-  AvbStreamDataList::iterator startPoint = nextStreamToService;
-  while (nextStreamToService->done != eNotDone)
+  /*
+   * Note: 'current' refers to the top of the heap, so it must not be accessed anymore
+   * once the sequence has been updated below.
+   */
+  const DoneState done = current.done;
+  if (eNotDone == done)
   {
-    nextStreamToService = next(nextStreamToService);
-    mDiag.debugSkipCount++;
-    if (startPoint == nextStreamToService)
+    // re-insert the stream according to the launch time of its new packet
+    if (mSequence.updateTop())
     {
-      break;
+      mDiag.reordered++;
     }
   }
+  else
+  {
+    // stream is done for this window, do not consider it until the sequence is re-armed
+    mSequence.parkTop();
+  }
 
-  return current.done;
+  return done;
+}
+
+void IasAvbTransmitSequencer::discardBurstPackets(const IasAvbStream * stream)
+{
+  size_t keep = 0u;
+  size_t retained = 0u;
+  for (size_t idx = 0u; idx < mBurstPackets.size(); idx++)
+  {
+    if (mBurstStreams[idx] == stream)
+    {
+      IasAvbPacketPool::returnPacket(mBurstPackets[idx]);
+    }
+    else
+    {
+      mBurstPackets[keep] = mBurstPackets[idx];
+      mBurstStreams[keep] = mBurstStreams[idx];
+      keep++;
+      if (idx < mBurstRetained)
+      {
+        retained++;
+      }
+    }
+  }
+  mBurstPackets.resize(keep);
+  mBurstStreams.resize(keep);
+  mBurstRetained = retained;
+}
+
+IasAvbTransmitSequencer::DoneState IasAvbTransmitSequencer::flushBurst(uint64_t windowStart)
+{
+  DoneState ret = eNotDone;
+
+  if (0u != mBurstRetained)
+  {
+    // packets the backend did not take last time go first, unless their launch time has passed meanwhile
+    size_t keep = 0u;
+    for (size_t idx = 0u; idx < mBurstRetained; idx++)
+    {
+      if (int64_t(mBurstPackets[idx]->attime - windowStart) < -int64_t(mConfig.txWindowCueThreshold))
+      {
+        IasAvbPacketPool::returnPacket(mBurstPackets[idx]);
+        mDiag.dropped++;
+      }
+      else
+      {
+        mBurstPackets[keep] = mBurstPackets[idx];
+        mBurstStreams[keep] = mBurstStreams[idx];
+        keep++;
+      }
+    }
+    mBurstPackets.erase(mBurstPackets.begin() + long(keep), mBurstPackets.begin() + long(mBurstRetained));
+    mBurstStreams.erase(mBurstStreams.begin() + long(keep), mBurstStreams.begin() + long(mBurstRetained));
+    mBurstRetained = 0u;
+  }
+
+  const uint32_t count = uint32_t(mBurstPackets.size());
+
+  if (0u != count)
+  {
+    int32_t result = 0;
+    const uint64_t start = IasLibPtpDaemon::getTsc();
+    const uint32_t accepted = mBackend->xmitBurst(&mBurstPackets[0], count, result);
+    const uint64_t cost = IasLibPtpDaemon::getTsc() - start;
+
+    mDiag.bursts++;
+    mDiag.burstPackets += count;
+    mDiag.burstTime += cost;
+    if (count > mDiag.burstMaxSize)
+    {
+      mDiag.burstMaxSize = count;
+    }
+    if (cost > mDiag.burstMaxTime)
+    {
+      mDiag.burstMaxTime = cost;
+    }
+
+    if (mFirstRun && mBTMEnable)
+    {
+      mFirstRun = false;
+      // TO BE REPLACED ias_dlt_log_btm_mark(mLog, "avb sending now",NULL);
+    }
+
+    if (0u != accepted)
+    {
+      for (uint32_t idx = 0u; idx < accepted; idx++)
+      {
+        (void) mBurstStreams[idx]->incFramesTx();
+      }
+      mDiag.sent += accepted;
+
+      IasDiaLogger *diaLogger = IasAvbStreamHandlerEnvironment::getDiaLogger();
+      if (NULL != diaLogger)
+      {
+        diaLogger->addTxCount(accepted);
+      }
+
+      // reset the watchdog timer when packets were successfully sent
+      if ((NULL != mWatchdog) && mWatchdog->isRegistered())
+      {
+        (void) mWatchdog->reset();
+      }
+    }
+
+    bool retry = false;
+    if (accepted < count)
+    {
+      switch (result)
+      {
+      case -EINVAL:
+      case -ENXIO:
+        // fatal errors, dispose of packets
+        DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "xmit error:", int32_t(result));
+        ret = eTxError;
+        break;
+
+      case ENOSPC:
+        {
+          // Insufficient ring size: Calculate the required ring size for diagnostic purposes
+          uint32_t frames = 0u;
+          for (size_t idx = 0u; idx < mSequence.size(); idx++)
+          {
+            AVB_ASSERT(NULL != mSequence[idx].stream);
+            frames += mSequence[idx].stream->getTSpec().getMaxIntervalFrames();
+          }
+          AVB_ASSERT(0u != mConfig.txWindowWidth);
+
+          const uint64_t reqRingSize = uint64_t(IasAvbTSpec::getPacketsPerSecondByClass(mClass)) * uint64_t(frames)
+              * mConfig.txWindowWidth / uint64_t(1e9)
+              * 2u // two entries per packet
+              * 130u / 100u; // 30% margin
+
+          DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "TX ring buffer overflow detected! Try changing the ring buffer size.",
+              "TX window:", mConfig.txWindowWidth,
+              "active streams:", uint64_t(mSequence.size()),
+              "frames/interval:", frames,
+              "min ring size:", reqRingSize);
+
+          if (NULL != mWindowController)
+          {
+            // fewer packets in flight with a narrower window
+            mWindowController->ringFull();
+            mConfig.txWindowWidth = mWindowController->getWidth();
+          }
+
+          if ((mUseShaper) && (100u != mShaperBwRate))
+          {
+            DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "Ignoring the TX ring buffer overflow error since the shaper is under debugging.");
+          }
+          else
+          {
+            mThreadControl |= cFlagRestartThread;
+          }
+        }
+        break;
+
+      default:
+        // unknown or non-fatal errors, keep the rest of the burst and try again in the next pass
+        DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "xmit returns", int32_t(result),
+            "retrying", count - accepted, "packets");
+        retry = true;
+        break;
+      }
+
+      if (!retry)
+      {
+        for (uint32_t idx = accepted; idx < count; idx++)
+        {
+          IasAvbPacketPool::returnPacket(mBurstPackets[idx]);
+        }
+        mDiag.dropped += count - accepted;
+      }
+    }
+
+    if (retry)
+    {
+      // the packets not sent stay at the head of the burst with their launch times
+      mBurstPackets.erase(mBurstPackets.begin(), mBurstPackets.begin() + long(accepted));
+      mBurstStreams.erase(mBurstStreams.begin(), mBurstStreams.begin() + long(accepted));
+      mBurstRetained = mBurstPackets.size();
+      mDiag.burstRetries += uint32_t(mBurstRetained);
+    }
+    else
+    {
+      mBurstPackets.clear();
+      mBurstStreams.clear();
+    }
+  }
+
+  return ret;
+}
+
+void IasAvbTransmitSequencer::resetTxWindow()
+{
+  mConfig.txWindowWidth = mConfig.txWindowWidthInit;
+  mConfig.txWindowPitch = mConfig.txWindowPitchInit;
+
+  if (NULL != mWindowController)
+  {
+    mWindowController->reset();
+    mConfig.txWindowWidth = mWindowController->getWidth();
+  }
 }
 
 void IasAvbTransmitSequencer::logOutput(float elapsed, float reclaimed)
@@ -1210,59 +1445,50 @@ void IasAvbTransmitSequencer::logOutput(float elapsed, float reclaimed)
         );
     mDiag.debugSkipCount = 0u;
     mDiag.debugTimingViolation = 0u;
-  }
-
-  mDiag.sent = 0u;
-}
 
-void IasAvbTransmitSequencer::sortByLaunchTime(AvbStreamDataList::iterator & nextStreamToService)
-{
-  StreamData & current = *nextStreamToService;
-  AvbStreamDataList::iterator backward = nextStreamToService;
-
-  /* go backwards from the current stream to find packets that need to be sent earlier
-   * NOTE: in most cases, this loop will abort immediately and no reordering takes place
-   */
-  do
-  {
-    backward = prev(backward);
-
-    if ((backward->launchTime != 0u) && (current.launchTime > backward->launchTime))
+    if (0u != mDiag.bursts)
     {
-      break;
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "bursts:", mDiag.bursts,
+          "avg.size:", float(mDiag.burstPackets) / float(mDiag.bursts),
+          "max.size:", mDiag.burstMaxSize,
+          "avg.cost(ns):", mDiag.burstTime / mDiag.bursts,
+          "max.cost(ns):", mDiag.burstMaxTime,
+          "retried:", mDiag.burstRetries
+          );
     }
-  }
-  while (nextStreamToService != backward);
-
-  /* if nextStreamToService == backward the stream gets reordered to the position it already has and needs
-   * to be serviced again immediately, so no action needs to be taken
-   */
-  if (nextStreamToService != backward)
-  {
-    // insert() inserts before the specified position, so we need to advance by one to insert after
-    backward = next(backward);
-
-    if (nextStreamToService != backward)
+    mDiag.bursts = 0u;
+    mDiag.burstPackets = 0u;
+    mDiag.burstMaxSize = 0u;
+    mDiag.burstTime = 0u;
+    mDiag.burstMaxTime = 0u;
+    mDiag.burstRetries = 0u;
+
+    if (NULL != mRenderer)
     {
-      // move current stream to new position and skip nextStreamToService to the next one
-      mSequence.insert(backward, current);
-      nextStreamToService = mSequence.erase(nextStreamToService);
-      // wrap around, if necessary
-      if (mSequence.end() == nextStreamToService)
-      {
-        nextStreamToService = mSequence.begin();
-      }
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "render misses:", mDiag.renderMisses);
+    }
 
-      mDiag.reordered++;
+    if (NULL != mWindowController)
+    {
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "TX window width:", mConfig.txWindowWidth,
+          "max:", mWindowController->getMaxWidth(),
+          "peak demand:", mWindowController->getPeakDemand(),
+          "widened:", mWindowController->getWidenCount(),
+          "narrowed:", mWindowController->getNarrowCount()
+          );
     }
-    else
+    mDiag.renderMisses = 0u;
+
+    IasAvbPacketArena * const arena = IasAvbStreamHandlerEnvironment::getPacketArena();
+    if ((NULL != arena) && (IasAvbSrClass::eIasAvbSrClassHigh == mClass))
     {
-      // just skip nextStreamToService to the next one
-      nextStreamToService = next(nextStreamToService);
+      // shared by all classes, so only one sequencer reports
+      arena->logStatistics();
     }
   }
-}
 
+  mDiag.sent = 0u;
+}
 
 IasResult IasAvbTransmitSequencer::shutDown()
 {
@@ -1469,97 +1695,9 @@ void IasAvbTransmitSequencer::resetPoolsOfActiveStreams()
 
 void IasAvbTransmitSequencer::updateShaper()
 {
-  double bandWidth = 0.0;
-  int32_t  linkSpeed = 0;
-  int32_t  idleSlope = -1;
-  uint32_t linkRate  = TQAVCC_LINKRATE;
-  uint32_t maxInterferenceSize = cTxMaxInterferenceSize;
-
-  uint32_t tqavhcReg   = 0u; // Tx Qav Hi Credit TQAVHC
-  uint32_t tqavccReg   = 0u; // Tx Qav Credit Control TQAVCC
-  uint32_t tqavctrlReg = 0u; // Tx Qav Control TQAVCTRL
-
-  // get current link speed
-  linkSpeed = IasAvbStreamHandlerEnvironment::getLinkSpeed();
-
-  if (100 == linkSpeed)
-  {
-    // the percentage bandwith out of full line rate @ 100Mbps (mCurrentBandwidth = kBit/s)
-    bandWidth = (mCurrentBandwidth * mShaperBwRate / 100) * 1000.0 / 100000000.0;
-    idleSlope = static_cast<uint32_t>(bandWidth * 0.2 * (double)linkRate + 0.5);
-  }
-  else if (1000 == linkSpeed)
-  {
-    // the percentage bandwith out of full line rate @ 1Gbps (mCurrentBandwidth = kBit/s)
-    bandWidth = (mCurrentBandwidth * mShaperBwRate / 100) * 1000.0 / 1000000000.0;
-    idleSlope = static_cast<uint32_t>(bandWidth * 2.0 * (double)linkRate + 0.5);
-  }
-  else
-  {
-    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "unknown link speed", linkSpeed);
-    AVB_ASSERT(false);
-  }
-
-  if (0 == idleSlope)
-  {
-    // reset the registers with default value
-    tqavhcReg = TQAVCH_ZERO_CREDIT;
-    tqavccReg = TQAVCC_QUEUEMODE; // no idle slope
-  }
-  else if ((0 < idleSlope) && (static_cast<uint32_t>(idleSlope) < linkRate))
-  {
-    // idleSlope must be smaller than linkRate = 0x7735 credits/byte.
-
-    if (0u == mQueueIndex)
-    {
-      tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
-    }
-    else
-    {
-      uint32_t idleSlopeClassA = 0u;
-
-      (void) igb_readreg(mIgbDevice, TQAVHC(0), &idleSlopeClassA);
-      idleSlopeClassA ^= TQAVCC_QUEUEMODE;
-
-      if ((0 == idleSlopeClassA) || (0xFFFFu == static_cast<uint16_t>(idleSlopeClassA)))
-      {
-        // idleSlope has not been set. i.e. Class A (Queue0) is not used.
-        tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
-      }
-      else if (static_cast<int32_t>(linkRate - idleSlopeClassA) > 0)
-      {
-        /*
-         * Add 43 bytes to mMaxFrameSizeHigh since it is the size of AVTP payload without media overhead nor header.
-         * (43 = 8 bytes preamble + SFD, 14 bytes Ethernet header, 4 bytes VLAN tag, 4 bytes CRC, 12 bytes IPG, 1 byte SRP)
-         */
-        maxInterferenceSize = maxInterferenceSize + (mMaxFrameSizeHigh + 43u);
-        linkRate = linkRate - idleSlopeClassA;
-        tqavhcReg = TQAVCH_ZERO_CREDIT + (idleSlope * maxInterferenceSize / linkRate);
-      }
-    }
-
-    tqavccReg = (TQAVCC_QUEUEMODE | idleSlope);
-  }
-
-  if ((0u != tqavhcReg) && (0u != tqavccReg))
+  if (NULL != mBackend)
   {
-    // HiCredit
-    (void) igb_writereg(mIgbDevice, TQAVHC(mQueueIndex), tqavhcReg);
-
-    // QueueMode and IdleSlope
-    (void) igb_writereg(mIgbDevice, TQAVCC(mQueueIndex), tqavccReg);
-
-    // implicitly enable the Qav shaper
-    (void) igb_readreg(mIgbDevice, TQAVCTRL, &tqavctrlReg);
-    tqavctrlReg |= TQAVCTRL_TX_ARB;
-    (void) igb_writereg(mIgbDevice, TQAVCTRL, tqavctrlReg);
-
-    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "set shaping params (",
-        "Queue:", mQueueIndex,
-        "Bandwidth:", mCurrentBandwidth * mShaperBwRate / 100, "kBit/s",
-        "HiCredit:", tqavhcReg,
-        "IdleSlope:", idleSlope,
-        "");
+    mBackend->updateShaper(mCurrentBandwidth * mShaperBwRate / 100u, mMaxFrameSizeHigh);
   }
 }
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/**
+ * @file    IasAvbTransmitWindowController.cpp
+ * @brief   The definition of the IasAvbTransmitWindowController class.
+ * @date    2018
+ */
+
+#include "avb_streamhandler/IasAvbTransmitWindowController.hpp"
+
+namespace IasMediaTransportAvb {
+
+static const std::string cClassName = "IasAvbTransmitWindowController::";
+#define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
+
+/*
+ *  Constructor.
+ */
+IasAvbTransmitWindowController::IasAvbTransmitWindowController(DltContext &ctx)
+  : mWidthInit(0u)
+  , mWidth(0u)
+  , mPitch(0u)
+  , mMinWidth(0u)
+  , mMaxWidth(0u)
+  , mMaxWidthConfig(0u)
+  , mPeakDemand(0u)
+  , mLowCycles(0u)
+  , mCapCycles(0u)
+  , mWidenCount(0u)
+  , mNarrowCount(0u)
+  , mLog(&ctx)
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+/*
+ *  Destructor.
+ */
+IasAvbTransmitWindowController::~IasAvbTransmitWindowController()
+{
+  DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
+}
+
+
+IasAvbProcessingResult IasAvbTransmitWindowController::init(uint64_t widthInit, uint64_t pitch, uint64_t minWidth, uint64_t maxWidth)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  if ((minWidth < (pitch + cStep)) || (maxWidth < minWidth) || (widthInit < minWidth) || (widthInit > maxWidth))
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, "bad TX window bounds: min =", minWidth,
+        "max =", maxWidth, "width =", widthInit, "pitch =", pitch);
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    mWidthInit = widthInit;
+    mPitch = pitch;
+    mMinWidth = minWidth;
+    mMaxWidthConfig = maxWidth;
+    mWidenCount = 0u;
+    mNarrowCount = 0u;
+    reset();
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "adaptive TX window: min =", mMinWidth,
+        "max =", mMaxWidth, "init =", mWidthInit);
+  }
+
+  return result;
+}
+
+
+void IasAvbTransmitWindowController::reset()
+{
+  mMaxWidth = mMaxWidthConfig;
+  mWidth = mWidthInit;
+  mPeakDemand = 0u;
+  mLowCycles = 0u;
+  mCapCycles = 0u;
+}
+
+
+bool IasAvbTransmitWindowController::update(uint64_t oversleep, uint64_t serviceTime)
+{
+  bool changed = false;
+  const uint64_t demand = oversleep + serviceTime;
+  const uint64_t slack = mWidth - mPitch;
+
+  if (demand > mPeakDemand)
+  {
+    mPeakDemand = demand;
+  }
+
+  if ((mMaxWidth < mMaxWidthConfig) && (++mCapCycles >= cCapRecoveryPeriod))
+  {
+    // no ring overflow for a while, allow one more step
+    mMaxWidth += cStep;
+    if (mMaxWidth > mMaxWidthConfig)
+    {
+      mMaxWidth = mMaxWidthConfig;
+    }
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "raise TX window width limit to", mMaxWidth);
+    mCapCycles = 0u;
+  }
+
+  if ((demand > (slack * 3u / 4u)) && (mWidth < mMaxWidth))
+  {
+    // under load: react at once, aim for twice the demand as slack
+    uint64_t width = mPitch + ((2u * demand + cStep - 1u) / cStep) * cStep;
+    if (width > mMaxWidth)
+    {
+      width = mMaxWidth;
+    }
+    if (width <= mWidth)
+    {
+      width = mWidth + cStep;
+    }
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "widen TX window:", mWidth, "->", width, "demand:", demand);
+    mWidth = width;
+    mWidenCount++;
+    mPeakDemand = 0u;
+    mLowCycles = 0u;
+    changed = true;
+  }
+  else if (demand < (slack / 4u))
+  {
+    // quiet: narrow slowly, one step per evaluation period
+    mLowCycles++;
+    if (mLowCycles >= cEvalPeriod)
+    {
+      if ((mWidth > mMinWidth) && (mPeakDemand < (slack / 4u)))
+      {
+        mWidth -= cStep;
+        if (mWidth < mMinWidth)
+        {
+          mWidth = mMinWidth;
+        }
+        DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "narrow TX window to", mWidth, "peak demand:", mPeakDemand);
+        mNarrowCount++;
+        changed = true;
+      }
+      mPeakDemand = 0u;
+      mLowCycles = 0u;
+    }
+  }
+  else
+  {
+    // within the comfort zone
+    mLowCycles = 0u;
+  }
+
+  return changed;
+}
+
+
+void IasAvbTransmitWindowController::ringFull()
+{
+  uint64_t cap = (mWidth > (mMinWidth + cStep)) ? (mWidth - cStep) : mMinWidth;
+
+  mCapCycles = 0u;
+
+  if (cap < mMaxWidth)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "TX ring overflow, limiting TX window width to", cap);
+    mMaxWidth = cap;
+  }
+  if (mWidth > mMaxWidth)
+  {
+    mWidth = mMaxWidth;
+    mNarrowCount++;
+  }
+}
+
+} // namespace IasMediaTransportAvb
@@ -24,7 +24,8 @@ namespace IasMediaTransportAvb {
 static const std::string cClassName = "IasLocalAudioBuffer::";
 #define LOG_PREFIX cClassName + __func__ + "(" + std::to_string(__LINE__) + "):"
 
-IasLocalAudioBuffer::DiagData::DiagData()
+template<typename T>
+IasLocalAudioBufferT<T>::DiagData::DiagData()
   : numOverrun(0u)
   , numUnderrun(0u)
   , numOverrunTotal(0u)
@@ -34,36 +35,52 @@ IasLocalAudioBuffer::DiagData::DiagData()
   // do nothing
 }
 
+template<typename T>
+IasLocalAudioBufferT<T>::Reader::Reader()
+  : readIndex(0u)
+  , monotonicReadIndex(0u)
+  , readCnt(0u)
+  , lastRead(0u)
+{
+  (void) padding;
+}
+
 /*
  *  Constructor.
  */
-IasLocalAudioBuffer::IasLocalAudioBuffer()
-  : mReadIndex(0u)
-  , mWriteIndex(0u)
-  , mReadCnt(0u)
-  , mWriteCnt(0u)
-  , mTotalSize(0u)
-  , mReferenceFill(0u)
-  , mBufferState(eIasAudioBufferStateInit)
-  , mBufferStateLast(eIasAudioBufferStateInit)
-  , mDoAnalysis(0u)
-  , mReadIndexLastWriteCall(0u)
-  , mLock()
+template<typename T>
+IasLocalAudioBufferT<T>::IasLocalAudioBufferT()
+  : mTotalSize(0u)
   , mBuffer(NULL)
-  , mLastRead(0u)
+  , mDoAnalysis(0u)
   , mLog(&IasAvbStreamHandlerEnvironment::getDltContext("_LAB"))
-  , mReadReady(false)
   , mReadThreshold(0u)
-  , mMonotonicReadIndex(0u)
+  , mBufferState(eIasAudioBufferStateInit)
+  , mBufferStateLast(eIasAudioBufferStateInit)
+  , mReadIndexLastWriteCall(0u)
+  , mDiagData()
+  , mReaderMask(1u)
+  , mResetRequest(0u)
+  , mResetLevel(0u)
+  , mResetMark(0u)
+  , mResetIndex(0u)
+  , mWriteIndex(0u)
   , mMonotonicWriteIndex(0u)
+  , mReferenceFill(0u)
+  , mReadReady(false)
+  , mWriteCnt(0u)
+  , mReaders()
 {
+  (void) mPadding0;
+  (void) mPadding1;
 }
 
 
 /*
  *  Destructor.
  */
-IasLocalAudioBuffer::~IasLocalAudioBuffer()
+template<typename T>
+IasLocalAudioBufferT<T>::~IasLocalAudioBufferT()
 {
   cleanup();
 }
@@ -72,13 +89,14 @@ IasLocalAudioBuffer::~IasLocalAudioBuffer()
 /*
  *  Initialization method.
  */
-IasAvbProcessingResult IasLocalAudioBuffer::init(uint32_t totalSize, bool doAnalysis)
+template<typename T>
+IasAvbProcessingResult IasLocalAudioBufferT<T>::init(uint32_t totalSize, bool doAnalysis)
 {
   IasAvbProcessingResult error = eIasAvbProcOK;
 
   mTotalSize  = totalSize;
   mDoAnalysis = doAnalysis;
-  mBuffer = new (nothrow) IasLocalAudioBuffer::AudioData[mTotalSize];
+  mBuffer = new (nothrow) AudioData[mTotalSize];
 
   if (NULL == mBuffer)
   {
@@ -91,75 +109,207 @@ IasAvbProcessingResult IasLocalAudioBuffer::init(uint32_t totalSize, bool doAnal
 }
 
 /*
- *  Initialization method.
+ *  Reset method.
+ *
+ *  Only posts the request, the read indices belong to the consumers and the reference fill, the read ready flag and
+ *  the state belong to the producer. Resetting them from here would race with a read() or write() in progress and
+ *  could leave a monotonic read index ahead of the monotonic write index.
  */
-IasAvbProcessingResult IasLocalAudioBuffer::reset(uint32_t optimalFillLevel)
+template<typename T>
+IasAvbProcessingResult IasLocalAudioBufferT<T>::reset(uint32_t optimalFillLevel)
 {
   IasAvbProcessingResult error = eIasAvbProcOK;
 
-  mLock.lock();
+  mResetLevel.store(optimalFillLevel, std::memory_order_relaxed);
+  mResetMark.store(mWriteIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+  // release: the level is visible to the consumer taking over the request
+  (void) mResetRequest.fetch_or(cResetReaders, std::memory_order_release);
 
-  //initialization of the read and write pointer of the ring buffer
-  uint32_t newReadIndex = mWriteIndex - optimalFillLevel;
+  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " requests reset of the local audio buffer. TotalSize=",
+      mTotalSize, ", optimalFillLevel=", optimalFillLevel);
 
-  if (newReadIndex > mTotalSize)
-  {
-    // newReadIndex is effectively negative, wrap back into positive range
-    newReadIndex += mTotalSize;
-  }
+  return error;
+}
 
-  if (getFillLevel() < optimalFillLevel)
+/*
+ *  Trim method.
+ */
+template<typename T>
+IasAvbProcessingResult IasLocalAudioBufferT<T>::trim(uint32_t fillLevel)
+{
+  IasAvbProcessingResult error = eIasAvbProcOK;
+
+  mResetLevel.store(fillLevel, std::memory_order_relaxed);
+  mResetMark.store(mWriteIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+  (void) mResetRequest.fetch_or(cTrimReaders, std::memory_order_release);
+
+  return error;
+}
+
+/*
+ *  Takes over a pending reset or trim request on the consumer side.
+ */
+template<typename T>
+void IasLocalAudioBufferT<T>::applyReaderReset()
+{
+  const uint32_t readerRequests = cResetReaders | cTrimReaders;
+
+  // cheap check first, the request is rare
+  if (0u != (mResetRequest.load(std::memory_order_relaxed) & readerRequests))
   {
-    // not enough samples in buffer, add zeros
-    if (newReadIndex < mReadIndex)
-    {
-      (void) memset(mBuffer + newReadIndex, 0, (mReadIndex - newReadIndex) * sizeof (AudioData));
-    }
-    else
+    // with several consumers only the first one takes over the request, it moves all cursors in use
+    const uint32_t request = mResetRequest.fetch_and(~readerRequests, std::memory_order_acquire) & readerRequests;
+
+    if (0u != request)
     {
-      (void) memset(mBuffer + newReadIndex, 0, (mTotalSize - newReadIndex) * sizeof (AudioData));
-      (void) memset(mBuffer, 0, mReadIndex * sizeof (AudioData));
+      const bool     fullReset = (0u != (request & cResetReaders));
+      const uint32_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+      // only the samples behind the slowest cursor have been released by all consumers
+      const uint32_t readIndex  = mReaders[getSlowestReader(writeIndex)].readIndex.load(std::memory_order_acquire);
+      const uint32_t fill       = getFillLevel(writeIndex, readIndex);
+
+      /*
+       * The samples written since the request has been posted are kept on top of the level requested. No cursor
+       * reads before taking over the request, so the producer can't have wrapped around the write index of then.
+       */
+      uint32_t level = mResetLevel.load(std::memory_order_relaxed)
+                       + getFillLevel(writeIndex, mResetMark.load(std::memory_order_relaxed));
+
+      if (level >= mTotalSize)
+      {
+        // at least one slot stays free to tell a full buffer from an empty one
+        level = mTotalSize - 1u;
+      }
+
+      uint32_t newReadIndex = writeIndex - level;
+
+      if (newReadIndex > mTotalSize)
+      {
+        // newReadIndex is effectively negative, wrap back into positive range
+        newReadIndex += mTotalSize;
+      }
+
+      if (fullReset && (fill < level))
+      {
+        // not enough samples in buffer, add zeros
+        if (newReadIndex < readIndex)
+        {
+          (void) memset(mBuffer + newReadIndex, 0, (readIndex - newReadIndex) * sizeof (AudioData));
+        }
+        else
+        {
+          (void) memset(mBuffer + newReadIndex, 0, (mTotalSize - newReadIndex) * sizeof (AudioData));
+          (void) memset(mBuffer, 0, readIndex * sizeof (AudioData));
+        }
+      }
+
+      uint32_t mask = mReaderMask.load(std::memory_order_acquire);
+      for (uint32_t reader = 0u; 0u != mask; reader++, mask >>= 1)
+      {
+        // a trim only drops samples, the cursors holding less than the level stay where they are
+        if ((0u != (mask & 1u))
+            && (fullReset || (getFillLevel(writeIndex, mReaders[reader].readIndex.load(std::memory_order_acquire)) > level)))
+        {
+          moveReader(reader, newReadIndex);
+        }
+      }
+
+      if (fullReset)
+      {
+        mResetIndex.store(getMonotonicReadIndex(), std::memory_order_relaxed);
+        (void) mResetRequest.fetch_or(cResetWriter, std::memory_order_release);
+      }
+
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, (fullReset ? " reset" : " trim"),
+          "of the local audio buffer, fill level=", level);
     }
   }
+}
 
-  mReadIndex = newReadIndex;
+/*
+ *  Finishes a reset taken over by the consumers on the producer side.
+ */
+template<typename T>
+void IasLocalAudioBufferT<T>::applyWriterReset()
+{
+  if (0u != (mResetRequest.load(std::memory_order_relaxed) & cResetWriter))
+  {
+    (void) mResetRequest.fetch_and(~cResetWriter, std::memory_order_acquire);
 
-  mBufferState = eIasAudioBufferStateOk;
-  mBufferStateLast = eIasAudioBufferStateOk;
+    mBufferState = eIasAudioBufferStateOk;
+    mBufferStateLast = eIasAudioBufferStateOk;
 
-  DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " resets the local audio buffer. TotalSize=",
-      mTotalSize, ", optimalFillLevel=", optimalFillLevel);
+    // reset reference, will be set to new value upon this write
+    mReferenceFill.store(0u, std::memory_order_relaxed);
 
-  // reset reference, will be set to new value upon first write
-  mReferenceFill = 0u;
+    // reset diagnostic counters
+    mDiagData.numOverrun  = 0u;
+    mDiagData.numUnderrun = 0u;
+    mDiagData.numReset++;
 
-  // reset diagnostic counters
-  mDiagData.numOverrun  = 0u;
-  mDiagData.numUnderrun = 0u;
-  mDiagData.numReset++;
+    mReadReady.store(false, std::memory_order_relaxed);
+  }
+}
 
-  mReadReady = false;
-  mMonotonicReadIndex  = 0u;
-  mMonotonicWriteIndex = 0u;
+/*
+ *  Moves a read cursor, the monotonic read index follows by the distance moved.
+ */
+template<typename T>
+void IasLocalAudioBufferT<T>::moveReader(uint32_t reader, uint32_t newReadIndex)
+{
+  Reader & cursor = mReaders[reader];
 
-  mLock.unlock();
+  uint32_t oldReadIndex = cursor.readIndex.load(std::memory_order_acquire);
+  uint32_t oldFill;
+  uint32_t newFill;
 
-  return error;
+  // the owner of the cursor may commit a read in between, retry from its new position then
+  do
+  {
+    // loaded after the read index, so neither index is ahead of it
+    const uint32_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+    oldFill = getFillLevel(writeIndex, oldReadIndex);
+    newFill = getFillLevel(writeIndex, newReadIndex);
+  }
+  while (!cursor.readIndex.compare_exchange_weak(oldReadIndex, newReadIndex, std::memory_order_release,
+                                                 std::memory_order_acquire));
+
+  if (oldFill >= newFill)
+  {
+    (void) cursor.monotonicReadIndex.fetch_add(oldFill - newFill, std::memory_order_relaxed);
+  }
+  else
+  {
+    // moving back re-reads samples (or zeros), which never puts the index below zero
+    const uint64_t back = newFill - oldFill;
+    uint64_t monotonicReadIndex = cursor.monotonicReadIndex.load(std::memory_order_relaxed);
+    while (!cursor.monotonicReadIndex.compare_exchange_weak(monotonicReadIndex,
+                                                            (monotonicReadIndex > back) ? (monotonicReadIndex - back) : 0u,
+                                                            std::memory_order_relaxed))
+    {
+      // retry, the owner has committed a read in between
+    }
+  }
 }
 
 /*
  *  Write method.
  */
-uint32_t IasLocalAudioBuffer::write(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples)
+template<typename T>
+uint32_t IasLocalAudioBufferT<T>::write(AudioData * buffer, uint32_t nrSamples)
 {
   avb_safe_result copyResult;
   size_t size;
   uint32_t samplesWritten = 0u;
 
-  mLock.lock();
+  applyWriterReset();
+
+  // own index relaxed, acquire the consumers' indices so the samples they read are no longer accessed
+  uint32_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+  const uint32_t readIndex = mReaders[getSlowestReader(writeIndex)].readIndex.load(std::memory_order_acquire);
 
   // check of remaining write buffer space
-  const uint32_t remaining = mTotalSize - getFillLevel() - 1u;
+  const uint32_t remaining = mTotalSize - getFillLevel(writeIndex, readIndex) - 1u;
   if(nrSamples > remaining)
   {
     mDiagData.numOverrun++;
@@ -170,57 +320,49 @@ uint32_t IasLocalAudioBuffer::write(IasLocalAudioBuffer::AudioData * buffer, uin
   samplesWritten = nrSamples;
 
   // check of remaining write buffer space
-  const uint32_t beforeWrap = mTotalSize - mWriteIndex;
+  const uint32_t beforeWrap = mTotalSize - writeIndex;
 
   if (nrSamples > beforeWrap)
   {
     size = beforeWrap * sizeof (AudioData);
-    copyResult = avb_safe_memcpy(mBuffer + mWriteIndex, size, buffer, size);
+    copyResult = avb_safe_memcpy(mBuffer + writeIndex, size, buffer, size);
     AVB_ASSERT(e_avb_safe_result_ok == copyResult);
 
     buffer     += beforeWrap;
     nrSamples  -= beforeWrap;
-    mWriteIndex = 0u;
+    writeIndex  = 0u;
   }
 
   size = nrSamples * sizeof (AudioData);
-  copyResult = avb_safe_memcpy(mBuffer + mWriteIndex, size, buffer, size);
+  copyResult = avb_safe_memcpy(mBuffer + writeIndex, size, buffer, size);
   AVB_ASSERT(e_avb_safe_result_ok == copyResult);
   (void) copyResult;
 
-  mWriteIndex += nrSamples;
-
-  // if reference has been reset, set it now
-  if (0u == mReferenceFill)
-  {
-    mReferenceFill = getFillLevel();
-    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " new reference fill:", mReferenceFill);
-  }
+  writeIndex += nrSamples;
 
-  mMonotonicWriteIndex += samplesWritten;
+  commitWrite(writeIndex, samplesWritten, getFillLevel(writeIndex, readIndex));
 
-  if ((false == mReadReady) && (getFillLevel() >= mReadThreshold))
-  {
-    mReadReady = true;
-  }
-
-  mLock.unlock();
   return samplesWritten;
 }
 
 /*
  *  Write method with local iteration.
  */
-uint32_t IasLocalAudioBuffer::write(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples, uint32_t stride)
+template<typename T>
+uint32_t IasLocalAudioBufferT<T>::write(AudioData * buffer, uint32_t nrSamples, uint32_t stride)
 {
   avb_safe_result copyResult;
   size_t size;
   uint32_t samplesWritten = 0u;
+  uint32_t referenceFill = 0u;
+
+  applyWriterReset();
 
-  mLock.lock();
+  uint32_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+  const uint32_t readIndex = mReaders[getSlowestReader(writeIndex)].readIndex.load(std::memory_order_acquire);
 
   // check of remaining write buffer space
-  const uint32_t remaining = mTotalSize - getFillLevel() - 1u;
+  const uint32_t remaining = mTotalSize - getFillLevel(writeIndex, readIndex) - 1u;
   if(nrSamples > remaining)
   {
     mDiagData.numOverrun++;
@@ -231,127 +373,141 @@ uint32_t IasLocalAudioBuffer::write(IasLocalAudioBuffer::AudioData * buffer, uin
   samplesWritten = nrSamples;
 
   // check of remaining write buffer space
-  uint32_t beforeWrap = mTotalSize - mWriteIndex;
+  uint32_t beforeWrap = mTotalSize - writeIndex;
 
-  if (sizeof(IasLocalAudioBuffer::AudioData) == stride)  // not interleaved
+  if (sizeof(AudioData) == stride)  // not interleaved
   {
     if (nrSamples > beforeWrap)
     {
       size = beforeWrap * sizeof (AudioData);
-      copyResult = avb_safe_memcpy(mBuffer + mWriteIndex, size, buffer, size);
+      copyResult = avb_safe_memcpy(mBuffer + writeIndex, size, buffer, size);
       AVB_ASSERT(e_avb_safe_result_ok == copyResult);
 
       buffer     += beforeWrap;
       nrSamples  -= beforeWrap;
-      mWriteIndex = 0u;
+      writeIndex  = 0u;
     }
 
     size = nrSamples * sizeof (AudioData);
-    copyResult = avb_safe_memcpy(mBuffer + mWriteIndex, size, buffer, size);
+    copyResult = avb_safe_memcpy(mBuffer + writeIndex, size, buffer, size);
     AVB_ASSERT(e_avb_safe_result_ok == copyResult);
     (void) copyResult;
 
-    mWriteIndex += nrSamples;
-
-    // if reference has been reset, set it now
-    if (0u == mReferenceFill)
-    {
-      mReferenceFill = getFillLevel();
-      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " new reference fill:", mReferenceFill);
-    }
+    writeIndex += nrSamples;
+    referenceFill = getFillLevel(writeIndex, readIndex);
   }
   else    // interleaved
   {
     for (uint32_t sample = 0u; sample < nrSamples; sample++)
     {
-      *(mBuffer + mWriteIndex) = *buffer;
-      buffer += stride/sizeof(IasLocalAudioBuffer::AudioData);
-      beforeWrap = mTotalSize - mWriteIndex;
+      *(mBuffer + writeIndex) = *buffer;
+      buffer += stride/sizeof(AudioData);
+      beforeWrap = mTotalSize - writeIndex;
 
       if (1u == beforeWrap)
       {
-        mWriteIndex = 0u;
+        writeIndex = 0u;
       }
       else
       {
-        mWriteIndex++;
+        writeIndex++;
       }
 
-      // if reference has been reset, set it now
-      if (0u == mReferenceFill)
+      // a reset reference is taken after the first sample
+      if (0u == sample)
       {
-        mReferenceFill = getFillLevel();
-        DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " new reference fill:", mReferenceFill);
+        referenceFill = getFillLevel(writeIndex, readIndex);
       }
     }
   }
 
-  mMonotonicWriteIndex += samplesWritten;
+  commitWrite(writeIndex, samplesWritten, referenceFill);
+
+  return samplesWritten;
+}
+
+/*
+ *  Publishes the samples written by the producer.
+ */
+template<typename T>
+void IasLocalAudioBufferT<T>::commitWrite(uint32_t newWriteIndex, uint32_t samplesWritten, uint32_t referenceFill)
+{
+  // counted first, so a consumer never sees its monotonic read index ahead of the monotonic write index
+  (void) mMonotonicWriteIndex.fetch_add(samplesWritten, std::memory_order_relaxed);
+
+  // release: the samples are in the buffer before the consumer can see the new index
+  mWriteIndex.store(newWriteIndex, std::memory_order_release);
 
-  if ((false == mReadReady) && (getFillLevel() >= mReadThreshold))
+  // if reference has been reset, set it now
+  if ((0u == mReferenceFill.load(std::memory_order_relaxed)) && (0u != referenceFill))
   {
-    mReadReady = true;
+    mReferenceFill.store(referenceFill, std::memory_order_relaxed);
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " new reference fill:", referenceFill);
   }
 
-  mLock.unlock();
-  return samplesWritten;
+  if ((false == mReadReady.load(std::memory_order_relaxed)) && (getFillLevel() >= mReadThreshold))
+  {
+    mReadReady.store(true, std::memory_order_release);
+  }
 }
 
 /*
  *  Read method.
  */
-uint32_t IasLocalAudioBuffer::read(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples)
+template<typename T>
+uint32_t IasLocalAudioBufferT<T>::read(AudioData * buffer, uint32_t nrSamples)
+{
+  return read(0u, buffer, nrSamples);
+}
+
+/*
+ *  Read method for a given read cursor.
+ */
+template<typename T>
+uint32_t IasLocalAudioBufferT<T>::read(uint32_t reader, AudioData * buffer, uint32_t nrSamples)
 {
   avb_safe_result copyResult;
   size_t size;
   uint32_t samplesRead;
 
-  mLock.lock();
+  AVB_ASSERT(reader < cMaxReaders);
 
-  const uint32_t fill = getFillLevel();
+  applyReaderReset();
+
+  // acquire the producer's index so the samples up to it are visible
+  const uint32_t oldReadIndex = mReaders[reader].readIndex.load(std::memory_order_acquire);
+  const uint32_t writeIndex   = mWriteIndex.load(std::memory_order_acquire);
+  uint32_t readIndex = oldReadIndex;
+
+  const uint32_t fill = getFillLevel(writeIndex, readIndex);
   if (nrSamples > fill)
   {
     nrSamples = fill;
   }
 
   samplesRead = nrSamples;
-  const uint32_t beforeWrap = mTotalSize - mReadIndex;
+  const uint32_t beforeWrap = mTotalSize - readIndex;
 
   if (nrSamples > beforeWrap)
   {
     size = beforeWrap * sizeof (AudioData);
-    copyResult = avb_safe_memcpy(buffer, size, mBuffer + mReadIndex, size);
+    copyResult = avb_safe_memcpy(buffer, size, mBuffer + readIndex, size);
     AVB_ASSERT(e_avb_safe_result_ok == copyResult);
 
     buffer    += beforeWrap;
     nrSamples -= beforeWrap;
-    mReadIndex = 0u;
+    readIndex  = 0u;
   }
 
   size = nrSamples * sizeof (AudioData);
-  copyResult = avb_safe_memcpy(buffer, size, mBuffer + mReadIndex, size);
+  copyResult = avb_safe_memcpy(buffer, size, mBuffer + readIndex, size);
   AVB_ASSERT(e_avb_safe_result_ok == copyResult);
   (void) copyResult;
 
-  mReadIndex          += nrSamples;
-  mMonotonicReadIndex += samplesRead;
-
-  mLock.unlock();
+  readIndex += nrSamples;
 
-  if(mDoAnalysis)
-  {
-    if((0 == (mReadCnt%32000)) || (samplesRead != mLastRead))
-    {
-      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " mReadCnt=", mReadCnt,
-          "mReadIndex=",  mReadIndex,
-          "mWriteIndex=", mWriteIndex,
-          "distance=",    fill,
-          "state=",       int32_t(mBufferState),
-          "numread=",     samplesRead);
-      mLastRead = samplesRead;
-    }
-    mReadCnt++;
-  }
+  commitRead(reader, oldReadIndex, readIndex, samplesRead);
+  logRead(reader, readIndex, writeIndex, fill, samplesRead);
 
   return samplesRead;
 }
@@ -359,88 +515,189 @@ uint32_t IasLocalAudioBuffer::read(IasLocalAudioBuffer::AudioData * buffer, uint
 /*
  *  Read method with local iteration.
  */
-uint32_t IasLocalAudioBuffer::read(IasLocalAudioBuffer::AudioData * buffer, uint32_t nrSamples, uint32_t stride)
+template<typename T>
+uint32_t IasLocalAudioBufferT<T>::read(AudioData * buffer, uint32_t nrSamples, uint32_t stride)
 {
   avb_safe_result copyResult;
   size_t size;
 
-  mLock.lock();
+  applyReaderReset();
 
-  const uint32_t fill = getFillLevel();
+  const uint32_t oldReadIndex = mReaders[0].readIndex.load(std::memory_order_acquire);
+  const uint32_t writeIndex   = mWriteIndex.load(std::memory_order_acquire);
+  uint32_t readIndex = oldReadIndex;
+
+  const uint32_t fill = getFillLevel(writeIndex, readIndex);
   if (nrSamples > fill)
   {
     nrSamples = fill;
   }
 
   uint32_t samplesRead = nrSamples;
-  uint32_t beforeWrap  = mTotalSize - mReadIndex;
+  uint32_t beforeWrap  = mTotalSize - readIndex;
 
-  if (sizeof(IasLocalAudioBuffer::AudioData) == stride)      //not interleaved
+  if (sizeof(AudioData) == stride)      //not interleaved
   {
     if (nrSamples > beforeWrap)
     {
       size = beforeWrap * sizeof (AudioData);
-      copyResult = avb_safe_memcpy(buffer, size, mBuffer + mReadIndex, size);
+      copyResult = avb_safe_memcpy(buffer, size, mBuffer + readIndex, size);
       AVB_ASSERT(e_avb_safe_result_ok == copyResult);
 
       buffer    += beforeWrap;
       nrSamples -= beforeWrap;
-      mReadIndex = 0u;
+      readIndex  = 0u;
     }
 
     size = nrSamples * sizeof (AudioData);
-    copyResult = avb_safe_memcpy(buffer, size, mBuffer + mReadIndex, size);
+    copyResult = avb_safe_memcpy(buffer, size, mBuffer + readIndex, size);
     AVB_ASSERT(e_avb_safe_result_ok == copyResult);
     (void) copyResult;
 
-    mReadIndex += nrSamples;
+    readIndex += nrSamples;
 
   }
   else    // interleaved
   {
-    size = sizeof (AudioData);
     for (uint32_t sample = 0u; sample < nrSamples; sample++)
     {
-      *buffer = *(mBuffer + mReadIndex);
-      buffer += stride/sizeof(IasLocalAudioBuffer::AudioData);
-      beforeWrap = mTotalSize - mReadIndex;
+      *buffer = *(mBuffer + readIndex);
+      buffer += stride/sizeof(AudioData);
+      beforeWrap = mTotalSize - readIndex;
       if (1u == beforeWrap)
       {
-        mReadIndex = 0;
+        readIndex = 0;
       }
       else
       {
-        mReadIndex++;
+        readIndex++;
       }
     }
   }
 
-  mMonotonicReadIndex += samplesRead;
+  commitRead(0u, oldReadIndex, readIndex, samplesRead);
+  logRead(0u, readIndex, writeIndex, fill, samplesRead);
 
-  mLock.unlock();
+  return samplesRead;
+}
+
+/*
+ *  Releases the samples taken by the consumer of the read cursor.
+ */
+template<typename T>
+void IasLocalAudioBufferT<T>::commitRead(uint32_t reader, uint32_t oldReadIndex, uint32_t newReadIndex,
+                                         uint32_t samplesRead)
+{
+  Reader & cursor = mReaders[reader];
+
+  // release: the samples have been copied out before the producer may overwrite them
+  if (cursor.readIndex.compare_exchange_strong(oldReadIndex, newReadIndex, std::memory_order_release,
+                                               std::memory_order_relaxed))
+  {
+    (void) cursor.monotonicReadIndex.fetch_add(samplesRead, std::memory_order_relaxed);
+  }
+  else
+  {
+    // a reset has moved the read index in the meantime, its position wins
+  }
+}
+
+template<typename T>
+void IasLocalAudioBufferT<T>::logRead(uint32_t reader, uint32_t readIndex, uint32_t writeIndex, uint32_t fill,
+                                      uint32_t samplesRead)
+{
+  Reader & cursor = mReaders[reader];
 
   if(mDoAnalysis)
   {
-    if((0 == (mReadCnt%32000)) || (samplesRead != mLastRead))
+    if((0 == (cursor.readCnt%32000)) || (samplesRead != cursor.lastRead))
     {
-      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " mReadCnt=", mReadCnt,
-          "mReadIndex=",  mReadIndex,
-          "mWriteIndex=", mWriteIndex,
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " reader=", reader,
+          "mReadCnt=",    cursor.readCnt,
+          "mReadIndex=",  readIndex,
+          "mWriteIndex=", writeIndex,
           "distance=",    fill,
           "state=",       int32_t(mBufferState),
           "numread=",     samplesRead);
-      mLastRead = samplesRead;
+      cursor.lastRead = samplesRead;
     }
-    mReadCnt++;
+    cursor.readCnt++;
   }
+}
 
-  return samplesRead;
+/*
+ *  Selects the read cursors in use.
+ */
+template<typename T>
+IasAvbProcessingResult IasLocalAudioBufferT<T>::setReaders(uint32_t readerMask)
+{
+  IasAvbProcessingResult error = eIasAvbProcOK;
+
+  if ((0u == readerMask) || (0u != (readerMask >> cMaxReaders)))
+  {
+    error = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    const uint32_t added = readerMask & ~mReaderMask.load(std::memory_order_relaxed);
+
+    if (0u != added)
+    {
+      // new cursors join at the slowest position, so they don't cause an overrun and see the same monotonic indices
+      const Reader & slowest = mReaders[getSlowestReader(mWriteIndex.load(std::memory_order_acquire))];
+      const uint32_t readIndex = slowest.readIndex.load(std::memory_order_acquire);
+      const uint64_t monotonicReadIndex = slowest.monotonicReadIndex.load(std::memory_order_relaxed);
+
+      for (uint32_t reader = 0u; reader < cMaxReaders; reader++)
+      {
+        if (0u != (added & (1u << reader)))
+        {
+          mReaders[reader].monotonicReadIndex.store(monotonicReadIndex, std::memory_order_relaxed);
+          mReaders[reader].readIndex.store(readIndex, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // release: the producer sees the new cursors at their start position
+    mReaderMask.store(readerMask, std::memory_order_release);
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " read cursors in use:", readerMask);
+  }
+
+  return error;
+}
+
+/*
+ *  Reset method for a single read cursor.
+ */
+template<typename T>
+IasAvbProcessingResult IasLocalAudioBufferT<T>::resetReader(uint32_t reader)
+{
+  IasAvbProcessingResult error = eIasAvbProcOK;
+
+  if ((reader >= cMaxReaders) || (0u == (mReaderMask.load(std::memory_order_acquire) & (1u << reader))))
+  {
+    error = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    // the samples behind the slowest cursor may already be overwritten, so that is as far back as the cursor can go
+    const uint32_t readIndex = mReaders[getSlowestReader(mWriteIndex.load(std::memory_order_acquire))].readIndex.load(
+                                 std::memory_order_acquire);
+
+    moveReader(reader, readIndex);
+
+    DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, " resets read cursor", reader, "to readIndex=", readIndex);
+  }
+
+  return error;
 }
 
 /*
  *  Cleanup method.
  */
-void IasLocalAudioBuffer::cleanup()
+template<typename T>
+void IasLocalAudioBufferT<T>::cleanup()
 {
   DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX);
   delete[] mBuffer;
@@ -448,4 +705,8 @@ void IasLocalAudioBuffer::cleanup()
 }
 
 
+template class IasLocalAudioBufferT<int16_t>;
+template class IasLocalAudioBufferT<int32_t>;
+template class IasLocalAudioBufferT<float>;
+
 } // namespace IasMediaTransportAvb
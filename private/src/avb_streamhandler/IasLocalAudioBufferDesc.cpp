@@ -11,6 +11,7 @@
  */
 
 #include "avb_streamhandler/IasLocalAudioBufferDesc.hpp"
+#include <cmath>
 
 namespace IasMediaTransportAvb {
 
@@ -103,4 +104,40 @@ IasAvbProcessingResult IasLocalAudioBufferDesc::peekX(IasLocalAudioBufferDesc::A
   return ret;
 }
 
+IasAvbProcessingResult IasLocalAudioBufferDesc::getPlayoutOffset(uint64_t index, uint64_t now, uint32_t sampleFrequency,
+                                                                  int64_t &offset)
+{
+  IasAvbProcessingResult ret = eIasAvbProcErr;
+
+  lock();
+
+  const std::size_t qSize = mDescQ.size();
+
+  if ((0u != qSize) && (0u != sampleFrequency))
+  {
+    const AudioBufferDesc &desc = mDescQ[qSize - 1u];
+    double timePerSample = 1e9 / double(sampleFrequency);
+
+    if (1u < qSize)
+    {
+      const AudioBufferDesc &next = mDescQ[qSize - 2u];
+      if ((next.timeStamp > desc.timeStamp) && (next.bufIndex > desc.bufIndex))
+      {
+        // timePerSample = ((TSy - TSx) / (CNTy - CNTx))
+        timePerSample = double(next.timeStamp - desc.timeStamp) / double(next.bufIndex - desc.bufIndex);
+      }
+    }
+
+    // take the differences first, the absolute times exceed the precision of a double
+    const double timeOffset = double(int64_t(desc.timeStamp - now)) +
+                                double(int64_t(index - desc.bufIndex)) * timePerSample;
+    offset = int64_t(::round(timeOffset / timePerSample));
+    ret = eIasAvbProcOK;
+  }
+
+  unlock();
+
+  return ret;
+}
+
 } // namespace IasMediaTransportAvb
@@ -14,6 +14,7 @@
 #include "avb_streamhandler/IasLocalAudioStream.hpp"
 #include "avb_streamhandler/IasLocalAudioBuffer.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#include "avb_streamhandler/IasAvbAudioConversion.hpp"
 #include <algorithm>
 #include <cmath>
 #include <dlt_cpp_extension.hpp>
@@ -38,8 +39,6 @@ IasLocalAudioStream::IasLocalAudioStream(DltContext &dltContext, IasAvbStreamDir
     mNumChannels(0),
     mSampleFrequency(0),
     mHasSideChannel(false),
-    mClientState(eIasNotConnected),
-    mClient(NULL),
     mBufferDescQ(NULL),
     mDescMode(AudioBufferDescMode::eIasAudioBufferDescModeOff),
     mPtpProxy(NULL),
@@ -54,7 +53,32 @@ IasLocalAudioStream::IasLocalAudioStream(DltContext &dltContext, IasAvbStreamDir
     mNullData(NULL),
     mPendingDesc(),
     mDiag(),
-    mAlsaRxSyncStart(false)
+    mAlsaRxSyncStart(false),
+    mMixLock(),
+    mMixing(false),
+    mMixBuffer(NULL),
+    mMixSize(0u),
+    mMixAnchored(false),
+    mMixAnchorIndex(0u),
+    mMixAnchorTime(0u),
+    mMixCommitIndex(0u),
+    mMixSources(),
+    mMixMaxLag(0u),
+    mMixStalls(0u),
+    mMixOverrun(0u)
+{
+  for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+  {
+    mClientStates[reader] = eIasNotConnected;
+    mClients[reader] = NULL;
+  }
+}
+
+
+IasLocalAudioStream::MixSource::MixSource()
+  : nextIndex(0u)
+  , delay(0u)
+  , aligned(false)
 {
   // do nothing
 }
@@ -105,6 +129,13 @@ IasAvbProcessingResult IasLocalAudioStream::init(uint8_t channelLayout, uint16_t
     if (totalSize > 0)
     {
       mDiag.setTotalBufferSize(totalSize);
+      // the mix may run ahead of the ring buffers by as much as they hold
+      mMixSize = totalSize;
+
+      // a source that has stalled holds the mix back no longer than the maximum lag
+      uint64_t maxLag = 4000000u;
+      (void) IasAvbStreamHandlerEnvironment::getConfigValue(IasRegKeys::cAudioMixMaxLag, maxLag);
+      mMixMaxLag = uint32_t(std::min(maxLag * sampleFrequency / 1000000000u, uint64_t(totalSize)));
       uint32_t readThreshold = 0u;
       uint32_t baseFillMultiplier = 15u; // the value is 0.1 step so 15 means actually 1.5
 
@@ -160,6 +191,18 @@ IasAvbProcessingResult IasLocalAudioStream::init(uint8_t channelLayout, uint16_t
           readThreshold = (IasAvbStreamDirection::eIasAvbTransmitToNetwork == mDirection) ?
                                                        (readThresholdTx) : (readThresholdRx);
 
+          /*
+           * In presentation mode AvbAlsaWrk places every sample at its presentation time and pads the
+           * gaps with silence, so it doesn't need a fill margin to start reading. The samples only have
+           * to be in the buffer one period ahead of their presentation time.
+           */
+          const bool isPresentationRx = (IasAvbStreamDirection::eIasAvbReceiveFromNetwork == mDirection) &&
+              (AudioBufferDescMode::eIasAudioBufferDescModePresentation == mDescMode);
+          if (isPresentationRx)
+          {
+            readThreshold = 0u;
+          }
+
           DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "local stream =", getStreamId(),
                       (IasAvbStreamDirection::eIasAvbTransmitToNetwork == mDirection) ? "(tx)" : "(rx)",
                           "bufReadStartThreshold =", readThreshold,
@@ -167,7 +210,8 @@ IasAvbProcessingResult IasLocalAudioStream::init(uint8_t channelLayout, uint16_t
                           "baseFillMultiplier =", double(readThreshold) / (double)mPeriodSz);
 
           // time required to fill buffer at readable threshold (default at half-hull)
-          const uint32_t readThresholdDelayRx = uint32_t(double(readThresholdRx) / double(mSampleFrequency) * 1e9);
+          const uint32_t readThresholdDelayRx = uint32_t(double(isPresentationRx ? mPeriodSz : readThresholdRx)
+                                                           / double(mSampleFrequency) * 1e9);
           const uint32_t readThresholdDelayTx = uint32_t(double(readThresholdTx) / double(mSampleFrequency) * 1e9);
 
           mLaunchTimeDelay = readThresholdDelayTx;
@@ -301,8 +345,6 @@ IasAvbProcessingResult IasLocalAudioStream::writeLocalAudioBuffer(uint16_t chann
 {
   IasAvbProcessingResult error = eIasAvbProcOK;
 
-  IasLocalAudioBufferDesc *descQ = mBufferDescQ;
-
   if (!isInitialized())
   {
     error = eIasAvbProcNotInitialized;
@@ -317,168 +359,441 @@ IasAvbProcessingResult IasLocalAudioStream::writeLocalAudioBuffer(uint16_t chann
      * Produce samples to local audio buffer only when the work thread is running,
      * otherwise unexpected buffer overrun would happen.
      */
+    writeChannel(channelIdx, buffer, bufferSize, samplesWritten, timestamp);
+  }
 
-    IasLocalAudioBuffer *ringBuf = getChannelBuffers()[channelIdx];
-    AVB_ASSERT( getChannelBuffers().size() == mNumChannels );
-    AVB_ASSERT(NULL != ringBuf);
+  if (eIasAvbProcOK != error)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Error=", int32_t(error));
+  }
 
-    bool useDesc = hasBufferDesc();
+  return error;
+}
 
-    if (useDesc)
+
+IasAvbProcessingResult IasLocalAudioStream::writeLocalAudioBuffers(uint16_t numChannels,
+                                                                   IasLocalAudioBuffer::AudioData *buffer,
+                                                                   uint32_t bufferSize,
+                                                                   uint16_t &samplesWritten,
+                                                                   uint32_t timestamp,
+                                                                   uint16_t source)
+{
+  IasAvbProcessingResult error = eIasAvbProcOK;
+
+  if (!isInitialized())
+  {
+    error = eIasAvbProcNotInitialized;
+  }
+  else if ((0u == numChannels) || (numChannels > mNumChannels) || (NULL == buffer) || (0u == bufferSize))
+  {
+    error = eIasAvbProcInvalidParam;
+  }
+  else if (source >= cMaxClients)
+  {
+    error = eIasAvbProcInvalidParam;
+  }
+  else if (mWorkerRunning)
+  {
+    if (IasAvbStreamDirection::eIasAvbReceiveFromNetwork == mDirection)
     {
-      if (0 == channelIdx)
+      uint32_t overrun = 0u;
+
       {
-        /*
-         * If no space is available in the buffer of channel_0 we should reset the whole buffers
-         * before calling the write method, otherwise sample count could be differ for each channel.
-         *
-         * e.g. writeLocalAudioBuffer() is called against channel_0, the write method fails due to
-         * buffer overflow, resetBuffers() resets whole channels, next time writeLocalAudioBuffer()
-         * will be called against channel_1, the write method will be successful since the buffer
-         * has been reset, as a result sample count on channel_0 does not consist with the one on
-         * channel_1.
-         *
-         * To avoid such inconsistency we should reset the buffers before calling the write method,
-         * when buffer overflow is predicted.
-         */
-        const uint16_t remaining = uint16_t( ringBuf->getTotalSize() - ringBuf->getFillLevel() - 1u );
-        if((bufferSize > remaining) && (NULL != mClient) && (eIasActive == mClientState))
-        {
-          DLT_LOG(*mLog,  DLT_LOG_WARN, DLT_STRING("[IasLocalAudioStream::writeLocalAudioBuffer]"),
-              DLT_STRING("buffer overrun happened"), DLT_UINT32(bufferSize - remaining));
+        // the receive streams writing to this stream may be served by different receive workers
+        std::lock_guard<std::recursive_mutex> lock(mMixLock);
 
-          if (mClient->signalDiscontinuity(IasLocalAudioStreamClientInterface::eIasOverrun, bufferSize - remaining))
+        if (mMixing)
+        {
+          mixChannels(numChannels, buffer, bufferSize, samplesWritten, timestamp, source);
+        }
+        else
+        {
+          for (uint16_t channelIdx = 0u; channelIdx < numChannels; channelIdx++)
           {
-            resetBuffers();
-            mDiag.setResetBuffersCount(mDiag.getResetBuffersCount() + 1);
+            writeChannel(channelIdx, buffer + (channelIdx * bufferSize), bufferSize, samplesWritten, timestamp,
+                         &mMixOverrun);
           }
         }
 
-        if (descQ->getResetRequest())
-        {
-          mEpoch          = 0u;
-          mLastTimeStamp  = 0u;
-          mLastSampleCnt  = 0u;
-          mPendingSamples = 0u;
-          (void) memset(&mPendingDesc, 0, sizeof (mPendingDesc));
-        }
+        overrun = mMixOverrun;
+        mMixOverrun = 0u;
+      }
+
+      // the clients are notified once mMixLock has been released, they may call back into the stream
+      if (0u != overrun)
+      {
+        signalOverrun(overrun);
       }
     }
+    else
+    {
+      for (uint16_t channelIdx = 0u; channelIdx < numChannels; channelIdx++)
+      {
+        writeChannel(channelIdx, buffer + (channelIdx * bufferSize), bufferSize, samplesWritten, timestamp);
+      }
+    }
+  }
+
+  if (eIasAvbProcOK != error)
+  {
+    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Error=", int32_t(error));
+  }
+
+  return error;
+}
+
+
+void IasLocalAudioStream::writeChannel(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize,
+                                       uint16_t &samplesWritten, uint32_t timestamp, uint32_t *overrun)
+{
+  IasLocalAudioBufferDesc *descQ = mBufferDescQ;
 
-    samplesWritten = uint16_t( ringBuf->write(buffer, bufferSize) );
+  IasLocalAudioBuffer *ringBuf = getChannelBuffers()[channelIdx];
+  AVB_ASSERT( getChannelBuffers().size() == mNumChannels );
+  AVB_ASSERT(NULL != ringBuf);
 
-    if((bufferSize != samplesWritten) && (NULL != mClient) && (eIasActive == mClientState))
+  bool useDesc = hasBufferDesc();
+
+  if (useDesc)
+  {
+    if (0 == channelIdx)
     {
-      if (mClient->signalDiscontinuity(IasLocalAudioStreamClientInterface::eIasOverrun, bufferSize - samplesWritten))
+      /*
+       * If no space is available in the buffer of channel_0 we should reset the whole buffers
+       * before calling the write method, otherwise sample count could be differ for each channel.
+       *
+       * e.g. writeLocalAudioBuffer() is called against channel_0, the write method fails due to
+       * buffer overflow, resetBuffers() resets whole channels, next time writeLocalAudioBuffer()
+       * will be called against channel_1, the write method will be successful since the buffer
+       * has been reset, as a result sample count on channel_0 does not consist with the one on
+       * channel_1.
+       *
+       * To avoid such inconsistency we should reset the buffers before calling the write method,
+       * when buffer overflow is predicted. The samples are only dropped by the consumers' next read,
+       * so this write may still be cut short, but on every channel alike.
+       */
+      const uint16_t remaining = uint16_t( ringBuf->getTotalSize() - ringBuf->getFillLevel() - 1u );
+      if((bufferSize > remaining) && hasActiveClient())
       {
-        resetBuffers();
-        mDiag.setResetBuffersCount(mDiag.getResetBuffersCount() + 1);
+        DLT_LOG(*mLog,  DLT_LOG_WARN, DLT_STRING("[IasLocalAudioStream::writeLocalAudioBuffer]"),
+            DLT_STRING("buffer overrun happened"), DLT_UINT32(bufferSize - remaining));
+
+        if (NULL != overrun)
+        {
+          *overrun = std::max(*overrun, uint32_t(bufferSize - remaining));
+        }
+        else
+        {
+          signalOverrun(bufferSize - remaining);
+        }
+      }
+
+      if (descQ->getResetRequest())
+      {
+        mEpoch          = 0u;
+        mLastTimeStamp  = 0u;
+        mLastSampleCnt  = 0u;
+        mPendingSamples = 0u;
+        (void) memset(&mPendingDesc, 0, sizeof (mPendingDesc));
       }
     }
-    else if (useDesc)
+  }
+
+  samplesWritten = uint16_t( ringBuf->write(buffer, bufferSize) );
+
+  if((bufferSize != samplesWritten) && hasActiveClient())
+  {
+    if (NULL != overrun)
+    {
+      *overrun = std::max(*overrun, uint32_t(bufferSize - samplesWritten));
+    }
+    else
+    {
+      signalOverrun(bufferSize - samplesWritten);
+    }
+  }
+  else if (useDesc)
+  {
+    if ((0 != samplesWritten) && ((getNumChannels() - 1) == channelIdx))
     {
-      if ((0 != samplesWritten) && ((getNumChannels() - 1) == channelIdx))
+      if (0u == mPendingDesc.timeStamp)
       {
-        if (0u == mPendingDesc.timeStamp)
+        uint64_t prev = mLastTimeStamp;
+        (void) updateRxTimestamp(timestamp);  // update mLastTimeStamp
+        uint64_t now = mLastTimeStamp;
+
+        if (0u == mPendingDesc.sampleCnt)
+        {
+          // start recording samples on a new descriptor
+          mPendingDesc.timeStamp = mLastTimeStamp + getAudioRxDelay();
+          mPendingDesc.bufIndex  = ringBuf->getMonotonicWriteIndex() - samplesWritten;
+          mPendingDesc.sampleCnt = samplesWritten;
+        }
+        else
         {
-          uint64_t prev = mLastTimeStamp;
-          (void) updateRxTimestamp(timestamp);  // update mLastTimeStamp
-          uint64_t now = mLastTimeStamp;
+          /*
+           * interpolate samples to the existing pending descriptor
+           * timestamp is not recorded yet, do the linear interpolation
+           */
+          uint64_t  timeOffset = 0u;
 
-          if (0u == mPendingDesc.sampleCnt)
+          if ((now > prev) && (mLastSampleCnt > mPendingDesc.sampleCnt))
           {
-            // start recording samples on a new descriptor
-            mPendingDesc.timeStamp = mLastTimeStamp + getAudioRxDelay();
-            mPendingDesc.bufIndex  = ringBuf->getMonotonicWriteIndex() - samplesWritten;
-            mPendingDesc.sampleCnt = samplesWritten;
+            /*
+             * the number of samples belonged to the previous timestamp fifo
+             * i.e. sampleCnt = 'previous bufferSize' - 'overflow'
+             */
+            uint32_t sampleCnt = mLastSampleCnt - mPendingDesc.sampleCnt;
+
+            // ((TSy - TSx) / (CNTy - CNTx)) * sampleCnt
+            double timePerSample = double(now - prev) / double(mLastSampleCnt);
+            timeOffset = uint64_t(timePerSample * double(sampleCnt));
           }
           else
           {
-            /*
-             * interpolate samples to the existing pending descriptor
-             * timestamp is not recorded yet, do the linear interpolation
-             */
-            uint64_t  timeOffset = 0u;
+            // for debugging purposes although it's unlikely to happen
+            DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "rx timestamp interpolation fail",
+                "now/prev/last-samples/remainings", now, "/", prev, "/", mLastSampleCnt, "/",
+                mPendingDesc.sampleCnt);
+          }
 
-            if ((now > prev) && (mLastSampleCnt > mPendingDesc.sampleCnt))
-            {
-              /*
-               * the number of samples belonged to the previous timestamp fifo
-               * i.e. sampleCnt = 'previous bufferSize' - 'overflow'
-               */
-              uint32_t sampleCnt = mLastSampleCnt - mPendingDesc.sampleCnt;
+          mPendingDesc.timeStamp  = prev + timeOffset + getAudioRxDelay();
+          mPendingDesc.sampleCnt += samplesWritten;
+        }
+      }
+      else
+      {
+        // interpolate samples to the existing pending descriptor
+        mPendingDesc.sampleCnt += samplesWritten;
+      }
 
-              // ((TSy - TSx) / (CNTy - CNTx)) * sampleCnt
-              double timePerSample = double(now - prev) / double(mLastSampleCnt);
-              timeOffset = uint64_t(timePerSample * double(sampleCnt));
-            }
-            else
-            {
-              // for debugging purposes although it's unlikely to happen
-              DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "rx timestamp interpolation fail",
-                  "now/prev/last-samples/remainings", now, "/", prev, "/", mLastSampleCnt, "/",
-                  mPendingDesc.sampleCnt);
-            }
+      mPendingSamples += bufferSize;
+      if (mPendingSamples >= mPeriodSz)
+      {
+        /*
+         * Now we should pass samples to AvbAlsaWrk since we have received the samples of the
+         * alsa period size from AVB stream.
+         */
+        uint32_t overflow = mPendingSamples - mPeriodSz;
+        mPendingDesc.sampleCnt = mPeriodSz;
 
-            mPendingDesc.timeStamp  = prev + timeOffset + getAudioRxDelay();
-            mPendingDesc.sampleCnt += samplesWritten;
-          }
-        }
-        else
+        // enqueue the timestamp to fifo so that AvbAlsaWrk can read samples
+        descQ->enqueue(mPendingDesc);
+
+        // reset the counters to store next samples into a new descriptor
+        (void) memset(&mPendingDesc, 0, sizeof (mPendingDesc));
+        mPendingSamples = 0u;
+        mLastSampleCnt  = 0u;
+
+        // store the overflowed samples in the next descriptor
+        if (0u != overflow)
         {
-          // interpolate samples to the existing pending descriptor
-          mPendingDesc.sampleCnt += samplesWritten;
+          // this case can happen when alsaBasePeriodSz mod numSamplesPerChannelPerPkt != 0
+          // e.g. numSamplesPerChannelPerPkt = 6 (classA) and alsaBasePeriodSz = 128
+
+          mPendingSamples = overflow;
+          mLastSampleCnt  = bufferSize;
+
+          // update mLastTimeStamp
+          (void) updateRxTimestamp(timestamp);
+
+          mPendingDesc.timeStamp = 0u; // to be updated later on receiving next data
+          mPendingDesc.bufIndex  = ringBuf->getMonotonicWriteIndex() - overflow;
+          mPendingDesc.sampleCnt = overflow;
         }
+      }
+      else
+      {
+        // nop: need further samples to be interpolated
+      }
+    }
+  }
+}
 
-        mPendingSamples += bufferSize;
-        if (mPendingSamples >= mPeriodSz)
-        {
-          /*
-           * Now we should pass samples to AvbAlsaWrk since we have received the samples of the
-           * alsa period size from AVB stream.
-           */
-          uint32_t overflow = mPendingSamples - mPeriodSz;
-          mPendingDesc.sampleCnt = mPeriodSz;
 
-          // enqueue the timestamp to fifo so that AvbAlsaWrk can read samples
-          descQ->enqueue(mPendingDesc);
+/*
+ * Each source keeps the offset between its presentation time and its position on the mix time line
+ * that was found when it was aligned. It stays there as long as its presentation times advance with
+ * its samples, so the network jitter doesn't move it. A source that is late for the part of the mix
+ * already written is delayed until it fits. A source that deviates by more than one packet, e.g.
+ * due to lost packets or the drift of its media clock, is aligned again.
+ */
+void IasLocalAudioStream::mixChannels(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize,
+                                      uint16_t &samplesWritten, uint32_t timestamp, uint16_t source)
+{
+  AVB_ASSERT(NULL != mMixBuffer);
+  AVB_ASSERT(bufferSize <= mMixSize);
 
-          // reset the counters to store next samples into a new descriptor
-          (void) memset(&mPendingDesc, 0, sizeof (mPendingDesc));
-          mPendingSamples = 0u;
-          mLastSampleCnt  = 0u;
+  samplesWritten = uint16_t(bufferSize);
 
-          // store the overflowed samples in the next descriptor
-          if (0u != overflow)
-          {
-            // this case can happen when alsaBasePeriodSz mod numSamplesPerChannelPerPkt != 0
-            // e.g. numSamplesPerChannelPerPkt = 6 (classA) and alsaBasePeriodSz = 128
+  if (eIasActive == mClientStates[source])
+  {
+    MixSource &mixSource = mMixSources[source];
 
-            mPendingSamples = overflow;
-            mLastSampleCnt  = bufferSize;
+    if (!mMixAnchored)
+    {
+      // the first source defines the presentation time of the mix time line
+      mMixAnchorIndex = mMixCommitIndex;
+      mMixAnchorTime  = timestamp;
+      mMixAnchored    = true;
+    }
 
-            // update mLastTimeStamp
-            (void) updateRxTimestamp(timestamp);
+    const uint64_t target   = getMixIndex(timestamp);
+    const uint64_t expected = target + mixSource.delay;
+    const uint64_t deviation = (expected > mixSource.nextIndex) ? (expected - mixSource.nextIndex)
+                                                                : (mixSource.nextIndex - expected);
 
-            mPendingDesc.timeStamp = 0u; // to be updated later on receiving next data
-            mPendingDesc.bufIndex  = ringBuf->getMonotonicWriteIndex() - overflow;
-            mPendingDesc.sampleCnt = overflow;
-          }
+    if (!mixSource.aligned || (deviation > bufferSize))
+    {
+      if (mixSource.aligned)
+      {
+        DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "local stream =", getStreamId(), "source", source,
+            "realigned, deviation =", deviation);
+      }
+
+      mixSource.nextIndex = std::max(target, mMixCommitIndex);
+      mixSource.delay     = mixSource.nextIndex - target;
+      mixSource.aligned   = true;
+    }
+
+    uint64_t start  = mixSource.nextIndex;
+    uint32_t offset = 0u;
+    uint32_t count  = bufferSize;
+    mixSource.nextIndex += bufferSize;
+
+    // samples for the part already written are dropped
+    if (start < mMixCommitIndex)
+    {
+      const uint32_t late = uint32_t(std::min(uint64_t(count), mMixCommitIndex - start));
+      start  += late;
+      offset += late;
+      count  -= late;
+    }
+
+    // a source running ahead by more than the mix holds pushes out the part the others haven't delivered yet
+    if ((start + count) > (mMixCommitIndex + mMixSize))
+    {
+      commitMix(start + count - mMixSize);
+    }
+
+    if (0u != count)
+    {
+      const uint32_t pos   = uint32_t(start % mMixSize);
+      const uint32_t first = std::min(count, mMixSize - pos);
+
+      for (uint16_t channelIdx = 0u; channelIdx < numChannels; channelIdx++)
+      {
+        const IasLocalAudioBuffer::AudioData * const src = buffer + (channelIdx * bufferSize) + offset;
+        IasLocalAudioBuffer::AudioData * const dst = mMixBuffer + (channelIdx * mMixSize);
+
+        IasAvbAudioConversion::mix(src, dst + pos, 1.0f, first);
+        if (count > first)
+        {
+          IasAvbAudioConversion::mix(src + first, dst, 1.0f, count - first);
+        }
+      }
+    }
+
+    /*
+     * Everything before the slowest active source is complete. A source lagging behind by more than
+     * mMixMaxLag has stalled, the mix proceeds without it and its part stays silent. It is aligned
+     * again when it returns.
+     */
+    uint64_t horizon = mixSource.nextIndex;
+    for (uint16_t other = 0u; other < cMaxClients; other++)
+    {
+      MixSource &otherSource = mMixSources[other];
+
+      if ((eIasActive == mClientStates[other]) && otherSource.aligned)
+      {
+        if ((otherSource.nextIndex + mMixMaxLag) < mixSource.nextIndex)
+        {
+          otherSource.aligned = false;
+          (void) mMixStalls.fetch_add(1u, std::memory_order_relaxed);
+          DLT_LOG_CXX(*mLog, DLT_LOG_WARN, LOG_PREFIX, "local stream =", getStreamId(), "source", other,
+              "stalled, lag =", mixSource.nextIndex - otherSource.nextIndex);
         }
         else
         {
-          // nop: need further samples to be interpolated
+          horizon = std::min(horizon, otherSource.nextIndex);
         }
       }
     }
+
+    if (horizon > mMixCommitIndex)
+    {
+      commitMix(horizon);
+    }
   }
+}
 
-  if (eIasAvbProcOK != error)
+
+void IasLocalAudioStream::commitMix(uint64_t endIndex)
+{
+  while (mMixCommitIndex < endIndex)
   {
-    DLT_LOG_CXX(*mLog, DLT_LOG_ERROR, LOG_PREFIX, " Error=", int32_t(error));
+    const uint32_t pos   = uint32_t(mMixCommitIndex % mMixSize);
+    const uint32_t count = uint32_t(std::min(std::min(endIndex - mMixCommitIndex, uint64_t(mMixSize - pos)),
+                                             uint64_t(0xFFFFu)));
+
+    // presentation time of the first sample, rounded to the nearest nanosecond
+    const uint64_t elapsed = ((mMixCommitIndex - mMixAnchorIndex) * 1000000000u + (mSampleFrequency >> 1)) / mSampleFrequency;
+    const uint32_t timestamp = mMixAnchorTime + uint32_t(elapsed);
+
+    for (uint16_t channelIdx = 0u; channelIdx < mNumChannels; channelIdx++)
+    {
+      IasLocalAudioBuffer::AudioData * const mix = mMixBuffer + (channelIdx * mMixSize) + pos;
+      uint16_t written = 0u;
+
+      writeChannel(channelIdx, mix, count, written, timestamp, &mMixOverrun);
+      (void) memset(mix, 0, count * sizeof (IasLocalAudioBuffer::AudioData));
+    }
+
+    mMixCommitIndex += count;
   }
 
-  return error;
+  // one second of samples spans exactly 10^9 ns, so moving the anchor by whole seconds is lossless
+  while ((mMixCommitIndex - mMixAnchorIndex) >= mSampleFrequency)
+  {
+    mMixAnchorIndex += mSampleFrequency;
+    mMixAnchorTime  += 1000000000u;
+  }
+}
+
+
+void IasLocalAudioStream::resetMix()
+{
+  if (NULL != mMixBuffer)
+  {
+    (void) memset(mMixBuffer, 0, mNumChannels * mMixSize * sizeof (IasLocalAudioBuffer::AudioData));
+  }
+
+  mMixAnchored     = false;
+  mMixAnchorIndex  = 0u;
+  mMixAnchorTime   = 0u;
+  mMixCommitIndex  = 0u;
+
+  for (uint16_t source = 0u; source < cMaxClients; source++)
+  {
+    mMixSources[source] = MixSource();
+  }
+}
+
+
+uint64_t IasLocalAudioStream::getMixIndex(uint32_t timestamp) const
+{
+  // presentation times are 32 bit, the anchor is kept within one second of the sources
+  const int32_t offset = int32_t(timestamp - mMixAnchorTime);
+  const uint64_t magnitude = (offset < 0) ? (0u - uint64_t(int64_t(offset))) : uint64_t(offset);
+  const uint64_t samples = (magnitude * mSampleFrequency + 500000000u) / 1000000000u;
+
+  uint64_t index = mMixAnchorIndex + samples;
+  if (offset < 0)
+  {
+    index = (mMixAnchorIndex > samples) ? (mMixAnchorIndex - samples) : 0u;
+  }
+
+  return index;
 }
 
 
@@ -486,7 +801,8 @@ IasAvbProcessingResult IasLocalAudioStream::readLocalAudioBuffer(uint16_t channe
                                                                  IasLocalAudioBuffer::AudioData *buffer,
                                                                  uint32_t bufferSize,
                                                                  uint16_t &samplesRead,
-                                                                 uint64_t &timeStamp)
+                                                                 uint64_t &timeStamp,
+                                                                 uint16_t reader)
 {
 
   IasAvbProcessingResult error = eIasAvbProcOK;
@@ -495,161 +811,304 @@ IasAvbProcessingResult IasLocalAudioStream::readLocalAudioBuffer(uint16_t channe
   {
     error = eIasAvbProcNotInitialized;
   }
-  else if ((channelIdx >= mNumChannels) || (NULL == buffer) || (0u == bufferSize))
+  else if ((channelIdx >= mNumChannels) || (NULL == buffer) || (0u == bufferSize) || (reader >= cMaxClients))
   {
     error = eIasAvbProcInvalidParam;
   }
   else
   {
-    AVB_ASSERT(mChannelBuffers.size() > channelIdx);
-    AVB_ASSERT(NULL != getChannelBuffers()[channelIdx]);
+    readChannels(channelIdx, 1u, buffer, bufferSize, samplesRead, timeStamp, reader);
+  }
 
-    bool isReadReady = true;
-    bool useDesc = hasBufferDesc();
-    IasLocalAudioBufferDesc *descQ = mBufferDescQ;
+  return error;
+}
 
-    if (useDesc)
+
+IasAvbProcessingResult IasLocalAudioStream::readLocalAudioBuffers(uint16_t numChannels,
+                                                                  IasLocalAudioBuffer::AudioData *buffer,
+                                                                  uint32_t bufferSize,
+                                                                  uint16_t &samplesRead,
+                                                                  uint64_t &timeStamp,
+                                                                  uint16_t reader)
+{
+  IasAvbProcessingResult error = eIasAvbProcOK;
+
+  if (!isInitialized())
+  {
+    error = eIasAvbProcNotInitialized;
+  }
+  else if ((0u == numChannels) || (numChannels > mNumChannels) || (NULL == buffer) || (0u == bufferSize)
+           || (reader >= cMaxClients))
+  {
+    error = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    readChannels(0u, numChannels, buffer, bufferSize, samplesRead, timeStamp, reader);
+  }
+
+  return error;
+}
+
+
+/*
+ * Reads the ring buffers of the channel range through the given read cursor. Channel 0 of the range
+ * determines the number of samples, so all channels stay aligned to each other.
+ */
+static uint16_t readRingBuffers(const IasLocalAudioStream::LocalAudioBufferVec &buffers, uint16_t firstChannel,
+                                uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize,
+                                uint16_t reader)
+{
+  IasLocalAudioBuffer *ringBuf = buffers[firstChannel];
+  AVB_ASSERT(NULL != ringBuf);
+
+  const uint32_t samplesRead = ringBuf->read(reader, buffer, bufferSize);
+
+  for (uint16_t channel = 1u; channel < numChannels; channel++)
+  {
+    IasLocalAudioBuffer::AudioData * const dst = buffer + (channel * bufferSize);
+    ringBuf = buffers[firstChannel + channel];
+    AVB_ASSERT(NULL != ringBuf);
+
+    const uint32_t samples = ringBuf->read(reader, dst, samplesRead);
+    if (samples < samplesRead)
+    {
+      (void) memset(dst + samples, 0, (samplesRead - samples) * sizeof (IasLocalAudioBuffer::AudioData));
+    }
+  }
+
+  return uint16_t(samplesRead);
+}
+
+
+/*
+ * Looks up the descriptor of the sample at readIndex of the given ring buffer. Descriptors that are
+ * only kept for a slower read cursor are skipped. With a single cursor, the head of the FIFO is returned.
+ */
+static IasAvbProcessingResult peekDesc(IasLocalAudioBufferDesc *descQ, const IasLocalAudioBuffer *ringBuf,
+                                       uint64_t readIndex, IasLocalAudioBufferDesc::AudioBufferDesc &desc,
+                                       uint32_t &descIdx)
+{
+  const uint64_t slowestReadIndex = ringBuf->getMonotonicReadIndex();
+
+  descIdx = 0u;
+  IasAvbProcessingResult ret = descQ->peek(desc);
+
+  while ((eIasAvbProcOK == ret) && ((desc.bufIndex + desc.sampleCnt) <= readIndex)
+         && ((desc.bufIndex + desc.sampleCnt) > slowestReadIndex))
+  {
+    IasLocalAudioBufferDesc::AudioBufferDesc next;
+    if (eIasAvbProcOK != descQ->peekX(next, descIdx + 1u))
     {
-      AVB_ASSERT( NULL != descQ );
-      // allow initial read access once the fill level reached at half full
-      isReadReady = getChannelBuffers()[channelIdx]->isReadReady();
+      break;
     }
+    desc = next;
+    descIdx++;
+  }
+
+  return ret;
+}
+
+
+/*
+ * Returns true if the reader mask selects no more than one read cursor.
+ */
+static inline bool isSingleReader(uint32_t readerMask)
+{
+  return (0u == (readerMask & (readerMask - 1u)));
+}
+
+
+void IasLocalAudioStream::readChannels(uint16_t firstChannel, uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer,
+                                       uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader)
+{
+  const uint16_t lastChannel = uint16_t(firstChannel + numChannels - 1u);
+  AVB_ASSERT(mChannelBuffers.size() > lastChannel);
+  AVB_ASSERT(NULL != getChannelBuffers()[firstChannel]);
+
+  bool isReadReady = true;
+  bool useDesc = hasBufferDesc();
+  IasLocalAudioBufferDesc *descQ = mBufferDescQ;
+
+  if (useDesc)
+  {
+    AVB_ASSERT( NULL != descQ );
+    // allow initial read access once the fill level reached at half full
+    isReadReady = getChannelBuffers()[firstChannel]->isReadReady();
+  }
 
-    if (isReadReady)
+  if (isReadReady)
+  {
+    if (useDesc)
     {
-      if (useDesc)
+      IasLocalAudioBufferDesc::AudioBufferDesc desc;
+      uint32_t descIdx = 0u;
+
+      /*
+       * The clients reading through the other cursors look up and delete descriptors as well, so the
+       * fifo is kept locked from looking up the descriptor until the used ones have been deleted.
+       */
+      descQ->lock();
+
+      // a reset or trim requested in the meantime moves the read index, it has to be in place before the lookup
+      for (uint16_t channel = firstChannel; channel <= lastChannel; channel++)
       {
-        IasLocalAudioBufferDesc::AudioBufferDesc desc;
+        getChannelBuffers()[channel]->applyReaderReset();
+      }
 
-        // read a descriptor w/o dequeuing
-        if (eIasAvbProcOK == descQ->peek(desc))
-        {
-          /*
-           * Because the timestamp contained in the descriptor might be needed later again
-           * if 'bufferSize' is smaller than 'sampleCnt' belonging to the descriptor,
-           * first we need to read it w/o dequeuing.
-           */
-          IasLocalAudioBuffer *ringBuf = getChannelBuffers()[channelIdx];
-          AVB_ASSERT( NULL != ringBuf );
+      // descriptors of samples dropped by a reset or trim have been passed by all cursors, they aren't needed anymore
+      const uint64_t passedIndex = getChannelBuffers()[mNumChannels - 1u]->getMonotonicReadIndex();
+      while ((eIasAvbProcOK == descQ->peek(desc)) && ((desc.bufIndex + desc.sampleCnt) <= passedIndex))
+      {
+        descQ->dequeue(desc);
+      }
 
-          uint64_t readIndex = ringBuf->getMonotonicReadIndex();
+      const uint64_t readIndex = getChannelBuffers()[firstChannel]->getMonotonicReadIndex(reader);
 
-          samplesRead = uint16_t( ringBuf->read(buffer, bufferSize) );
+      // read a descriptor w/o dequeuing
+      if (eIasAvbProcOK == peekDesc(descQ, getChannelBuffers()[firstChannel], readIndex, desc, descIdx))
+      {
+        /*
+         * Because the timestamp contained in the descriptor might be needed later again
+         * if 'bufferSize' is smaller than 'sampleCnt' belonging to the descriptor,
+         * first we need to read it w/o dequeuing.
+         */
+        samplesRead = readRingBuffers(getChannelBuffers(), firstChannel, numChannels, buffer, bufferSize, reader);
 
-          if ((desc.bufIndex <= readIndex) && (readIndex < desc.bufIndex + desc.sampleCnt))
+        if ((desc.bufIndex <= readIndex) && (readIndex < desc.bufIndex + desc.sampleCnt))
+        {
+          // valid descriptor since current readIndex is within its range
+          timeStamp = desc.timeStamp + mLaunchTimeDelay;
+
+          if (readIndex != desc.bufIndex)
           {
-            // valid descriptor since current readIndex is within its range
-            timeStamp = desc.timeStamp + mLaunchTimeDelay;
+            // adjust timestamp
+            uint64_t tstampOffset = 0u;
 
-            if (readIndex != desc.bufIndex)
-            {
-              // adjust timestamp
-              uint64_t tstampOffset = 0u;
+            // we have already sent the number of samples below
+            uint64_t samplesSent = readIndex - desc.bufIndex;
 
-              // we have already sent the number of samples below
-              uint64_t samplesSent = readIndex - desc.bufIndex;
+            IasLocalAudioBufferDesc::AudioBufferDesc descY;
+            IasAvbProcessingResult ret;
 
-              IasLocalAudioBufferDesc::AudioBufferDesc descY;
-              IasAvbProcessingResult ret;
+            ret = descQ->peekX(descY, descIdx + 1u);
 
-              ret = descQ->peekX(descY, 1u);
+            if ((eIasAvbProcOK == ret) &&
+                (descY.timeStamp > desc.timeStamp) && (descY.bufIndex > desc.bufIndex))
+            {
+              // ((TSy - TSx) / (CNTy - CNTx)) * sampleSent
+              double timePerSample = double(descY.timeStamp - desc.timeStamp) /
+                                            double(descY.bufIndex - desc.bufIndex);
 
-              if ((eIasAvbProcOK == ret) &&
-                  (descY.timeStamp > desc.timeStamp) && (descY.bufIndex > desc.bufIndex))
-              {
-                // ((TSy - TSx) / (CNTy - CNTx)) * sampleSent
-                double timePerSample = double(descY.timeStamp - desc.timeStamp) /
-                                              double(descY.bufIndex - desc.bufIndex);
+              tstampOffset = uint64_t(timePerSample * double(samplesSent));
+            }
+            else
+            {
+              /*
+               * Estimate the timestamp value based on the sample frequency.
+               *
+               * Since FIFO holds only one descriptor at the moment, unable to use TSy to
+               * interpolate the timestamp value. This might happen typically at the startup
+               * time when AVB stream starts grabbing samples from the Local Audio buffer.
+               * The TX engine might make bursty reading and the buffer could be close to empty
+               * if the buffer size is short.
+               */
+              tstampOffset = uint64_t(double((samplesSent)) / double(mSampleFrequency) * 1e9);
+            }
 
-                tstampOffset = uint64_t(timePerSample * double(samplesSent));
+            timeStamp = timeStamp + tstampOffset;
+          }
+
+          // delete used descriptors when the samples of the last channel were grabbed
+          if (lastChannel == (mNumChannels - 1))
+          {
+            // delete used descriptors, as far as the slowest read cursor has grabbed their samples
+            uint64_t curReadIndex = getChannelBuffers()[lastChannel]->getMonotonicReadIndex();
+            do
+            {
+              if ((desc.bufIndex + desc.sampleCnt) <= curReadIndex)
+              {
+                // delete the descriptor because all of its samples were read
+                descQ->dequeue(desc);
               }
               else
               {
-                /*
-                 * Estimate the timestamp value based on the sample frequency.
-                 *
-                 * Since FIFO holds only one descriptor at the moment, unable to use TSy to
-                 * interpolate the timestamp value. This might happen typically at the startup
-                 * time when AVB stream starts grabbing samples from the Local Audio buffer.
-                 * The TX engine might make bursty reading and the buffer could be close to empty
-                 * if the buffer size is short.
-                 */
-                tstampOffset = uint64_t(double((samplesSent)) / double(mSampleFrequency) * 1e9);
+                // nop: the descriptor must remain in fifo since it still has remaining samples
+                break;
               }
-
-              timeStamp = timeStamp + tstampOffset;
-            }
-
-            // delete used descriptors when the samples of the last channel were grabbed
-            if (channelIdx == (mNumChannels - 1))
-            {
-              // delete used descriptors
-              uint64_t curReadIndex = ringBuf->getMonotonicReadIndex();
-              do
-              {
-                if ((desc.bufIndex + desc.sampleCnt) <= curReadIndex)
-                {
-                  // delete the descriptor because all of its samples were read
-                  descQ->dequeue(desc);
-                }
-                else
-                {
-                  // nop: the descriptor must remain in fifo since it still has remaining samples
-                  break;
-                }
-                // read the next descriptor
-              } while (eIasAvbProcOK == descQ->peek(desc));
-            }
+              // read the next descriptor
+            } while (eIasAvbProcOK == descQ->peek(desc));
           }
-          else
+        }
+        else
+        {
+          /*
+           * invalid descriptor
+           *
+           * Have we lost timestamp due to buffer overrun? No theoretically it will not happen.
+           * Because IasLocalAudioBuffer::write() never overwrite existing data which is not yet read,
+           * in ring buffer. If there is no space in buffer at all, the write() method will return zero.
+           * Either IasLocalAudioStream::writeLocalAudioBuffer or IasAvbAudioShmProvider::copyJob
+           * does not enqueue a descriptor to fifo in such a case. Thus theoretically there is no
+           * possibility we come across an out-of-date descriptor.
+           */
+          if (lastChannel == (mNumChannels - 1))
           {
+            DLT_LOG(*mLog,  DLT_LOG_ERROR, DLT_STRING("[IasLocalAudioStream::readLocalAudioBuffer]"),
+                    DLT_STRING("detected invalid timestamp"), DLT_STRING("bufIndex="), DLT_UINT64(desc.bufIndex),
+                    DLT_STRING("sampleCnt="), DLT_UINT64(desc.sampleCnt), DLT_STRING("readIndex="), DLT_UINT64(readIndex));
+
             /*
-             * invalid descriptor
-             *
-             * Have we lost timestamp due to buffer overrun? No theoretically it will not happen.
-             * Because IasLocalAudioBuffer::write() never overwrite existing data which is not yet read,
-             * in ring buffer. If there is no space in buffer at all, the write() method will return zero.
-             * Either IasLocalAudioStream::writeLocalAudioBuffer or IasAvbAudioShmProvider::copyJob
-             * does not enqueue a descriptor to fifo in such a case. Thus theoretically there is no
-             * possibility we come across an out-of-date descriptor.
+             * A descriptor behind the head of the fifo or not yet passed by the slowest read cursor
+             * is still needed, by another client or for the samples following the ones without a descriptor.
              */
-            if (channelIdx == (mNumChannels - 1))
+            const IasLocalAudioBuffer * const ringBuf = getChannelBuffers()[lastChannel];
+            if ((0u == descIdx) && ((desc.bufIndex + desc.sampleCnt) <= ringBuf->getMonotonicReadIndex()))
             {
-              DLT_LOG(*mLog,  DLT_LOG_ERROR, DLT_STRING("[IasLocalAudioStream::readLocalAudioBuffer]"),
-                      DLT_STRING("detected invalid timestamp"), DLT_STRING("bufIndex="), DLT_UINT64(desc.bufIndex),
-                      DLT_STRING("sampleCnt="), DLT_UINT64(desc.sampleCnt), DLT_STRING("readIndex="), DLT_UINT64(readIndex));
-
               descQ->dequeue(desc);
             }
           }
         }
       }
-      else
-      {
-        timeStamp = 0u;
-        samplesRead = uint16_t( getChannelBuffers()[channelIdx]->read(buffer, bufferSize) );
-      }
 
-      if((0 == samplesRead) && (NULL != mClient) && (eIasActive == mClientState))
+      descQ->unlock();
+    }
+    else
+    {
+      timeStamp = 0u;
+      samplesRead = readRingBuffers(getChannelBuffers(), firstChannel, numChannels, buffer, bufferSize, reader);
+    }
+
+    // an underrun only concerns the client reading through the cursor
+    IasLocalAudioStreamClientInterface * const client = mClients[reader];
+    if((0 == samplesRead) && (NULL != client) && (eIasActive == getReaderState(reader)))
+    {
+      if (client->signalDiscontinuity(IasLocalAudioStreamClientInterface::eIasUnderrun, bufferSize - samplesRead))
       {
-        if (mClient->signalDiscontinuity(IasLocalAudioStreamClientInterface::eIasUnderrun, bufferSize - samplesRead))
+        if (isSingleReader(getChannelBuffers()[firstChannel]->getReaders()))
         {
           resetBuffers();
-          mDiag.setResetBuffersCount(mDiag.getResetBuffersCount() + 1);
         }
+        else
+        {
+          // the other clients keep reading undisturbed, only the cursor of this one is moved
+          for (uint16_t channel = firstChannel; channel <= lastChannel; channel++)
+          {
+            (void) getChannelBuffers()[channel]->resetReader(reader);
+          }
+        }
+        mDiag.setResetBuffersCount(mDiag.getResetBuffersCount() + 1);
       }
     }
-    else // !isReadReady
-    {
-      samplesRead = 0u;
-    }
   }
-
-  return error;
+  else // !isReadReady
+  {
+    samplesRead = 0u;
+  }
 }
 
 
-IasAvbProcessingResult IasLocalAudioStream::dumpFromLocalAudioBuffer(uint16_t &numSamples)
+IasAvbProcessingResult IasLocalAudioStream::dumpFromLocalAudioBuffer(uint16_t &numSamples, uint16_t reader)
 {
   IasAvbProcessingResult error = eIasAvbProcOK;
 
@@ -657,13 +1116,17 @@ IasAvbProcessingResult IasLocalAudioStream::dumpFromLocalAudioBuffer(uint16_t &n
   {
     error = eIasAvbProcNotInitialized;
   }
+  else if (reader >= cMaxClients)
+  {
+    error = eIasAvbProcInvalidParam;
+  }
   else
   {
-    uint32_t fill = getChannelBuffers()[0]->getFillLevel();
+    uint32_t fill = getChannelBuffers()[0]->getReaderFillLevel(reader);
 
     for (uint32_t channelIdx = 1u; channelIdx < mNumChannels; channelIdx++)
     {
-      fill = std::min(fill, getChannelBuffers()[channelIdx]->getFillLevel());
+      fill = std::min(fill, getChannelBuffers()[channelIdx]->getReaderFillLevel(reader));
     }
 
     if (fill < numSamples)
@@ -678,7 +1141,7 @@ IasAvbProcessingResult IasLocalAudioStream::dumpFromLocalAudioBuffer(uint16_t &n
     {
       uint16_t read      = 0u;
       uint64_t timeStamp = 0u;
-      (void) readLocalAudioBuffer(uint16_t(channelIdx), dummy, uint32_t(numSamples), read, timeStamp);
+      (void) readLocalAudioBuffer(uint16_t(channelIdx), dummy, uint32_t(numSamples), read, timeStamp, reader);
 
       AVB_ASSERT(read == numSamples);
       (void) read;
@@ -714,6 +1177,14 @@ void IasLocalAudioStream::cleanup()
     mNullData = NULL;
   }
 
+  {
+    std::lock_guard<std::recursive_mutex> lock(mMixLock);
+    mMixing = false;
+    delete[] mMixBuffer;
+    mMixBuffer = NULL;
+    mMixSize   = 0u;
+  }
+
   mChannelBuffers.clear();
   mNumChannels     = 0;
   mSampleFrequency = 0;
@@ -727,15 +1198,47 @@ IasAvbProcessingResult IasLocalAudioStream::connect( IasLocalAudioStreamClientIn
   {
     ret = eIasAvbProcInvalidParam;
   }
-  else if (NULL != mClient)
+  else if (cMaxClients != getReader(client))
   {
     ret = eIasAvbProcAlreadyInUse;
   }
   else
   {
-    mClient = client;
-    mClientState = eIasIdle;
+    /*
+     * Several clients can only share ring buffers. Talkers read them through cursors of their own,
+     * listeners are mixed. A side channel can't be mixed. All other streams accept a single client.
+     */
+    const bool shared = !mChannelBuffers.empty()
+                        && ((IasAvbStreamDirection::eIasAvbTransmitToNetwork == mDirection) || !mHasSideChannel);
+    const uint16_t maxClients = shared ? cMaxClients : 1u;
+    uint16_t reader = 0u;
+    while ((reader < maxClients) && (NULL != mClients[reader]))
+    {
+      reader++;
+    }
 
+    if (reader >= maxClients)
+    {
+      ret = eIasAvbProcAlreadyInUse;
+    }
+    else
+    {
+      std::lock_guard<std::recursive_mutex> lock(mMixLock);
+      mClients[reader] = client;
+      mClientStates[reader] = eIasIdle;
+      DLT_LOG_CXX(*mLog, DLT_LOG_DEBUG, LOG_PREFIX, "local stream =", getStreamId(), "client connected, reader =", reader);
+
+      ret = updateMixing();
+      if (eIasAvbProcOK != ret)
+      {
+        mClients[reader] = NULL;
+        mClientStates[reader] = eIasNotConnected;
+      }
+    }
+  }
+
+  if (eIasAvbProcOK == ret)
+  {
     if (hasBufferDesc())
     {
       uint32_t minBufSz   = 0u;
@@ -760,7 +1263,8 @@ IasAvbProcessingResult IasLocalAudioStream::connect( IasLocalAudioStreamClientIn
 
         const uint32_t readThresholdDelayTx = uint32_t(double(minTxBufSz) / double(mSampleFrequency) * 1e9);
 
-        if (ringBuf->getReadThreshold() < minTxBufSz)
+        // don't disturb the clients which are already reading from the buffers
+        if ((ringBuf->getReadThreshold() < minTxBufSz) && !hasActiveClient())
         {
           lock();
 
@@ -810,15 +1314,52 @@ IasAvbProcessingResult IasLocalAudioStream::disconnect()
 {
   IasAvbProcessingResult ret = eIasAvbProcOK;
 
-  mClientState = eIasNotConnected;
-  mClient = NULL;
+  mMixLock.lock();
+  for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+  {
+    mClientStates[reader] = eIasNotConnected;
+    mClients[reader] = NULL;
+  }
+  mMixLock.unlock();
+
+  updateReaders();
+  (void) updateMixing();
+
+  return ret;
+}
+
+IasAvbProcessingResult IasLocalAudioStream::disconnect( IasLocalAudioStreamClientInterface * client )
+{
+  IasAvbProcessingResult ret = eIasAvbProcOK;
+
+  const uint16_t reader = getReader(client);
+  if (reader >= cMaxClients)
+  {
+    ret = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    mMixLock.lock();
+    mClientStates[reader] = eIasNotConnected;
+    mClients[reader] = NULL;
+    mMixLock.unlock();
+
+    updateReaders();
+    (void) updateMixing();
+  }
 
   return ret;
 }
 
 void IasLocalAudioStream::setClientActive( bool active )
 {
-  if (NULL != mClient)
+  setClientActive(getClient(), active);
+}
+
+void IasLocalAudioStream::setClientActive( IasLocalAudioStreamClientInterface * client, bool active )
+{
+  const uint16_t reader = getReader(client);
+  if (reader < cMaxClients)
   {
     if (mAlsaRxSyncStart) // if -k alsa.sync.rx.read.start=1
     {
@@ -837,56 +1378,86 @@ void IasLocalAudioStream::setClientActive( bool active )
 
     if (active)
     {
-      if(eIasActive != mClientState)
+      /*
+       * Further clients join the clients already reading at the position of the slowest one,
+       * the buffers are only reset for the first one.
+       */
+      mMixLock.lock();
+      const bool activated = (eIasActive != mClientStates[reader]);
+      const bool othersActive = hasActiveClient();
+      mClientStates[reader] = eIasActive;
+      mMixLock.unlock();
+
+      if (activated)
       {
-        mClientState = eIasActive;
-        DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX, "=true, resetBuffers");
+        DLT_LOG_CXX(*mLog, DLT_LOG_VERBOSE, LOG_PREFIX, "=true, reader =", reader, othersActive ? "joining" : "resetBuffers");
 
-        if (mAlsaRxSyncStart)  // if -k alsa.sync.rx.read.start=1
-        {
-          /*
-           * The resetBuffers() call at here may change buffer fill level. If ALSA worker has already
-           * started reading samples, changing buffer fill level from outside of ALSA worker affects
-           * calculation of RX path latency. The fix of 'alsaRxSyncStart = true' can be disabled
-           * by the registry key for GP releases to avoid causing any regression for existing users.
-           */
-        }
-        else
+        if (!othersActive)
         {
-          (void) resetBuffers();
-        }
-
-        // initialize the counters to be used to expand received timestamp to 64 bit
-        mLastTimeStamp = mEpoch = 0u;
+          if (mAlsaRxSyncStart)  // if -k alsa.sync.rx.read.start=1
+          {
+            /*
+             * The resetBuffers() call at here may change buffer fill level. If ALSA worker has already
+             * started reading samples, changing buffer fill level from outside of ALSA worker affects
+             * calculation of RX path latency. The fix of 'alsaRxSyncStart = true' can be disabled
+             * by the registry key for GP releases to avoid causing any regression for existing users.
+             */
+          }
+          else
+          {
+            (void) resetBuffers();
+          }
 
-        if (hasBufferDesc() &&
-              getDirection() == IasAvbStreamDirection::eIasAvbTransmitToNetwork)
-        {
-          lock();
+          // initialize the counters to be used to expand received timestamp to 64 bit
+          mLastTimeStamp = mEpoch = 0u;
 
-          // flush all data samples and clear the read threshold flag
-          for (uint32_t i = 0; i < getNumChannels(); i++)
+          if (hasBufferDesc() &&
+                getDirection() == IasAvbStreamDirection::eIasAvbTransmitToNetwork)
           {
-            IasLocalAudioBuffer *ringBuf = getChannelBuffers()[i];
-            AVB_ASSERT(NULL != ringBuf);
-            ringBuf->reset(0u);
-          }
-          getBufferDescQ()->reset();
+            lock();
 
-          unlock();
+            // flush all data samples and clear the read threshold flag
+            for (uint32_t i = 0; i < getNumChannels(); i++)
+            {
+              IasLocalAudioBuffer *ringBuf = getChannelBuffers()[i];
+              AVB_ASSERT(NULL != ringBuf);
+              ringBuf->reset(0u);
+            }
+            getBufferDescQ()->reset();
+
+            unlock();
+          }
         }
+
+        updateReaders();
       }
     }
     else
     {
-      mClientState = eIasIdle;
+      mMixLock.lock();
+      mClientStates[reader] = eIasIdle;
+      const bool othersActive = hasActiveClient();
 
-      if (mAlsaRxSyncStart) // if -k alsa.sync.rx.read.start=1
+      if (isMixing())
+      {
+        // the mix no longer waits for the source, it is aligned again when it returns
+        mMixSources[reader].aligned = false;
+        if (!othersActive)
+        {
+          resetMix();
+        }
+      }
+      mMixLock.unlock();
+
+      updateReaders();
+
+      if (mAlsaRxSyncStart && !othersActive) // if -k alsa.sync.rx.read.start=1
       {
         /* DisconnectStreams: Flush out all samples, otherwise ALSA might pull those samples when
          * streams are reconnected. ALSA stops pulling samples when streams are disconnected,
          * due to that old samples could stay in the local audio buffer which might be read by ALSA
-         * when streams are reconnected next time.
+         * when streams are reconnected next time. As long as another source is still mixed in,
+         * ALSA keeps pulling and the samples in the buffer are still wanted.
          */
 
         lock();
@@ -906,6 +1477,141 @@ void IasLocalAudioStream::setClientActive( bool active )
   }
 }
 
+bool IasLocalAudioStream::hasActiveClient() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mMixLock);
+  bool ret = false;
+
+  for (uint16_t reader = 0u; (reader < cMaxClients) && !ret; reader++)
+  {
+    ret = (NULL != mClients[reader]) && (eIasActive == mClientStates[reader]);
+  }
+
+  return ret;
+}
+
+IasLocalAudioStream::ClientState IasLocalAudioStream::getReaderState(uint16_t reader) const
+{
+  AVB_ASSERT(reader < cMaxClients);
+  std::lock_guard<std::recursive_mutex> lock(mMixLock);
+  return mClientStates[reader];
+}
+
+bool IasLocalAudioStream::signalDiscontinuity(IasLocalAudioStreamClientInterface::DiscontinuityEvent event,
+                                              uint32_t numSamples)
+{
+  bool reset = false;
+  IasLocalAudioStreamClientInterface * active[cMaxClients];
+
+  // the clients are notified w/o holding the lock, they may call back into the stream
+  mMixLock.lock();
+  for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+  {
+    active[reader] = (eIasActive == mClientStates[reader]) ? mClients[reader] : NULL;
+  }
+  mMixLock.unlock();
+
+  for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+  {
+    if (NULL != active[reader])
+    {
+      // notify every active client, not only the first one asking for a reset
+      reset = active[reader]->signalDiscontinuity(event, numSamples) || reset;
+    }
+  }
+
+  return reset;
+}
+
+void IasLocalAudioStream::signalOverrun(uint32_t numSamples)
+{
+  if (signalDiscontinuity(IasLocalAudioStreamClientInterface::eIasOverrun, numSamples))
+  {
+    resetBuffers();
+    mDiag.setResetBuffersCount(mDiag.getResetBuffersCount() + 1);
+  }
+}
+
+void IasLocalAudioStream::updateReaders()
+{
+  uint32_t readerMask = 0u;
+
+  if (IasAvbStreamDirection::eIasAvbTransmitToNetwork == mDirection)
+  {
+    mMixLock.lock();
+    for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+    {
+      if (eIasActive == mClientStates[reader])
+      {
+        readerMask |= (1u << reader);
+      }
+    }
+    mMixLock.unlock();
+  }
+
+  if (0u == readerMask)
+  {
+    // cursor 0 serves the consumers which aren't clients, e.g. the ALSA worker of a receive stream
+    readerMask = 1u;
+  }
+
+  lock();
+
+  for (uint32_t i = 0u; i < mChannelBuffers.size(); i++)
+  {
+    IasLocalAudioBuffer *ringBuf = mChannelBuffers[i];
+    AVB_ASSERT(NULL != ringBuf);
+    (void) ringBuf->setReaders(readerMask);
+  }
+
+  unlock();
+}
+
+IasAvbProcessingResult IasLocalAudioStream::updateMixing()
+{
+  IasAvbProcessingResult ret = eIasAvbProcOK;
+  uint16_t numClients = 0u;
+
+  std::lock_guard<std::recursive_mutex> lock(mMixLock);
+
+  for (uint16_t reader = 0u; reader < cMaxClients; reader++)
+  {
+    if (NULL != mClients[reader])
+    {
+      numClients++;
+    }
+  }
+
+  const bool mixing = (IasAvbStreamDirection::eIasAvbReceiveFromNetwork == mDirection) && (numClients > 1u);
+
+  if (mixing != mMixing)
+  {
+    if (mixing && (NULL == mMixBuffer))
+    {
+      // allocated on first use, most receive streams never have more than one client
+      mMixBuffer = new (nothrow) IasLocalAudioBuffer::AudioData[mNumChannels * mMixSize];
+      if (NULL == mMixBuffer)
+      {
+        ret = eIasAvbProcNotEnoughMemory;
+      }
+    }
+
+    if (eIasAvbProcOK == ret)
+    {
+      /*
+       * When mixing is turned off, the part of the mix that hasn't been written yet is dropped.
+       * The remaining client continues with its next samples.
+       */
+      resetMix();
+      mMixing = mixing;
+      DLT_LOG_CXX(*mLog, DLT_LOG_INFO, LOG_PREFIX, "local stream =", getStreamId(), "mixing",
+          mixing ? "on" : "off", ", clients =", numClients);
+    }
+  }
+
+  return ret;
+}
+
 void IasLocalAudioStream::setWorkerActive(bool active)
 {
   if (hasBufferDesc())
@@ -972,22 +1678,23 @@ void IasLocalAudioStream::updateRxTimestamp(const uint32_t timestamp)
   }
 }
 
-uint64_t IasLocalAudioStream::getCurrentTimestamp()
+uint64_t IasLocalAudioStream::getCurrentTimestamp(uint16_t reader)
 {
   uint64_t timeStamp = 0u;
 
-  if (hasBufferDesc())
+  if (hasBufferDesc() && (reader < cMaxClients))
   {
     lock();
 
     IasLocalAudioBufferDesc *descQ = mBufferDescQ;
     IasLocalAudioBufferDesc::AudioBufferDesc desc;
-    if (eIasAvbProcOK == descQ->peek(desc))
+    uint32_t descIdx = 0u;
+    IasLocalAudioBuffer *ringBuf = getChannelBuffers()[0u];
+    const uint64_t readIndex = ringBuf->getMonotonicReadIndex(reader);
+    if (eIasAvbProcOK == peekDesc(descQ, ringBuf, readIndex, desc, descIdx))
     {
       timeStamp = desc.timeStamp + mLaunchTimeDelay;
 
-      IasLocalAudioBuffer *ringBuf = getChannelBuffers()[0u];
-      uint64_t readIndex = ringBuf->getMonotonicReadIndex();
       if (readIndex != desc.bufIndex)
       {
         // adjust timestamp
@@ -998,7 +1705,7 @@ uint64_t IasLocalAudioStream::getCurrentTimestamp()
 
         IasLocalAudioBufferDesc::AudioBufferDesc descY;
 
-        if ((eIasAvbProcOK == descQ->peekX(descY, 1u)) &&
+        if ((eIasAvbProcOK == descQ->peekX(descY, descIdx + 1u)) &&
             (descY.timeStamp > desc.timeStamp) && (descY.bufIndex > desc.bufIndex))
         {
           // ((TSy - TSx) / (CNTy - CNTx)) * sampleSent
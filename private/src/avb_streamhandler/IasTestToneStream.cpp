@@ -16,10 +16,6 @@
 #include <dlt/dlt_cpp_extension.hpp>
 
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
-#ifdef __SSE__
-#include <xmmintrin.h>
-#include <emmintrin.h>
-#endif // __SSE__
 
 namespace IasMediaTransportAvb {
 
@@ -31,7 +27,7 @@ static const std::string cClassName = "IasTestToneStream::";
  */
 IasTestToneStream::IasTestToneStream(DltContext &dltContext, uint16_t streamId)
   : IasLocalAudioStream(dltContext, IasAvbStreamDirection::eIasAvbTransmitToNetwork, eIasTestToneStream, streamId)
-  , mConversionGain(AudioData(0x7FFF))
+  , mConversionGain(IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::cFullScale)
   , mUseSaturation(true)
 {
   // nothing to do
@@ -188,10 +184,12 @@ IasAvbProcessingResult IasTestToneStream::writeLocalAudioBuffer(uint16_t channel
   return eIasAvbProcNotImplemented;
 }
 
-IasAvbProcessingResult IasTestToneStream::readLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp)
+IasAvbProcessingResult IasTestToneStream::readLocalAudioBuffer(uint16_t channelIdx, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader)
 {
   IasAvbProcessingResult result = eIasAvbProcOK;
 
+  (void) reader;
+
   timeStamp = 0u;
 
   if (!isInitialized())
@@ -212,6 +210,48 @@ IasAvbProcessingResult IasTestToneStream::readLocalAudioBuffer(uint16_t channelI
   return result;
 }
 
+IasAvbProcessingResult IasTestToneStream::writeLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesWritten, uint32_t timeStamp, uint16_t source)
+{
+  (void) numChannels;
+  (void) buffer;
+  (void) bufferSize;
+  (void) samplesWritten;
+  (void) timeStamp;
+  (void) source;
+
+  return eIasAvbProcNotImplemented;
+}
+
+IasAvbProcessingResult IasTestToneStream::readLocalAudioBuffers(uint16_t numChannels, IasLocalAudioBuffer::AudioData *buffer, uint32_t bufferSize, uint16_t &samplesRead, uint64_t &timeStamp, uint16_t reader)
+{
+  IasAvbProcessingResult result = eIasAvbProcOK;
+
+  (void) reader;
+
+  timeStamp = 0u;
+
+  if (!isInitialized())
+  {
+    result = eIasAvbProcNotInitialized;
+  }
+  else if ((0u == numChannels) || (numChannels > mNumChannels) || (NULL == buffer) || (0u == bufferSize))
+  {
+    result = eIasAvbProcInvalidParam;
+  }
+  else
+  {
+    AVB_ASSERT(mChannels.size() == mNumChannels);
+
+    for (uint16_t channelIdx = 0u; channelIdx < numChannels; channelIdx++)
+    {
+      samplesRead = uint16_t( (this->*(mChannels[channelIdx].method))(buffer + (channelIdx * bufferSize), bufferSize,
+          mChannels[channelIdx].params) );
+    }
+  }
+
+  return result;
+}
+
 uint32_t IasTestToneStream::generateSineWave(IasLocalAudioBuffer::AudioData *buf, uint32_t numSamples, GeneratorParams & params)
 {
   for (uint32_t sample = 0u; sample < numSamples; sample++)
@@ -219,7 +259,7 @@ uint32_t IasTestToneStream::generateSineWave(IasLocalAudioBuffer::AudioData *buf
     AudioData tempData = params.coeff * params.buf1 - params.buf2;
     if (mUseSaturation)
     {
-      buf[sample] = convertFloatToPcm16(tempData);
+      buf[sample] = convertFloatToSample(tempData);
     }
     else
     {
@@ -238,7 +278,7 @@ uint32_t IasTestToneStream::generatePulseWave(IasLocalAudioBuffer::AudioData *bu
   {
     if (mUseSaturation)
     {
-      buf[sample] = convertFloatToPcm16(params.peak);
+      buf[sample] = convertFloatToSample(params.peak);
     }
     else
     {
@@ -268,7 +308,7 @@ uint32_t IasTestToneStream::generateSawtoothWaveRising(IasLocalAudioBuffer::Audi
   {
     if (mUseSaturation)
     {
-      buf[sample] = convertFloatToPcm16(params.buf1);
+      buf[sample] = convertFloatToSample(params.buf1);
     }
     else
     {
@@ -293,7 +333,7 @@ uint32_t IasTestToneStream::generateSawtoothWaveFalling(IasLocalAudioBuffer::Aud
   {
     if (mUseSaturation)
     {
-      buf[sample] = convertFloatToPcm16(params.buf1);
+      buf[sample] = convertFloatToSample(params.buf1);
     }
     else
     {
@@ -376,33 +416,13 @@ IasAvbProcessingResult IasTestToneStream::setChannelParams(uint16_t channel,
   return result;
 }
 
-inline int16_t IasTestToneStream::convertFloatToPcm16(AudioData val)
+inline IasLocalAudioBuffer::AudioData IasTestToneStream::convertFloatToSample(AudioData val)
 {
   /**
-   * Apply output gain and store the lowest single-precision floating-point value
-   * of a __m128 register to a int16_t* memory location. This function does a
-   * conversion from float to int16_t.
+   * Apply output gain and convert to the local sample type with saturation.
+   * mConversionGain defaults to the full scale of the local sample type.
    */
-
-  /** NOTE:
-   * This is not fully optimized yet, as the SSE instructions could convert up to four samples
-   * in parallel. Let's wait for the performance toll to decide if it's needed.
-   */
-
-#ifndef __SSE__ // avoid compilation errors on machines used for unit-testing
-  val = val > 1.0f ? 1.0f : (val < -1.0f ? -1.0f : val);
-  return int16_t(val * mConversionGain);
-#else
-
-  const __m128  cConversionFactor_mm  = _mm_load1_ps(&mConversionGain);
-  __m128 a = _mm_load1_ps(&val);;
-  a = _mm_mul_ps(a, cConversionFactor_mm); // multiply with 2^15-1 and apply output gain
-  __m128i b  = _mm_cvtps_epi32(a);         // convert from float to int32_t
-  b = _mm_packs_epi32(b,b);                // convert int32_t to int16_t with saturation
-  int32_t intValue = _mm_cvtsi128_si32(b);   // move the lowest 32 bit to scalar intValue
-  return int16_t(intValue);
-
-#endif
+  return IasLocalAudioSampleTraits<IasLocalAudioBuffer::AudioData>::fromScaledFloat(val * mConversionGain);
 }
 
 } // namespace IasMediaTransportAvb
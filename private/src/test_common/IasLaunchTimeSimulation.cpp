@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasLaunchTimeSimulation.cpp
+ *  @date 2018
+ */
+#include "test_common/IasLaunchTimeSimulation.hpp"
+#include <cstdlib>
+
+namespace IasMediaTransportAvb {
+
+void IasLaunchTimeSimulation::createStreams(std::vector<SimStream> & streams, uint32_t count)
+{
+  streams.clear();
+  for (uint32_t i = 0u; i < count; i++)
+  {
+    SimStream s;
+    // Class A (125us) and Class B (250us) intervals, distinct phases to avoid equal launch times
+    s.interval = (0u == (i % 3u)) ? 250000u : 125000u;
+    s.nextLaunchTime = 1000000u + uint64_t(i) * 37u + uint64_t(rand() % 1000) * 1000u;
+    streams.push_back(s);
+  }
+}
+
+IasLaunchTimeSimulation::EntryList::iterator IasLaunchTimeSimulation::next(EntryList & seq, EntryList::iterator it)
+{
+  it++;
+  if (seq.end() == it)
+  {
+    it = seq.begin();
+  }
+  return it;
+}
+
+IasLaunchTimeSimulation::EntryList::iterator IasLaunchTimeSimulation::prev(EntryList & seq, EntryList::iterator it)
+{
+  if (seq.begin() == it)
+  {
+    it = seq.end();
+  }
+  it--;
+  return it;
+}
+
+void IasLaunchTimeSimulation::sortByLaunchTime(EntryList & seq, EntryList::iterator & it)
+{
+  Entry & current = *it;
+  EntryList::iterator backward = it;
+
+  do
+  {
+    backward = prev(seq, backward);
+    if ((backward->launchTime != 0u) && (current.launchTime > backward->launchTime))
+    {
+      break;
+    }
+  }
+  while (it != backward);
+
+  if (it != backward)
+  {
+    backward = next(seq, backward);
+    if (it != backward)
+    {
+      seq.insert(backward, current);
+      it = seq.erase(it);
+      if (seq.end() == it)
+      {
+        it = seq.begin();
+      }
+    }
+    else
+    {
+      it = next(seq, it);
+    }
+  }
+}
+
+IasLaunchTimeSimulation::DoneState IasLaunchTimeSimulation::serviceList(EntryList & seq, std::vector<SimStream> & streams,
+    uint32_t window, uint64_t windowStart, EntryList::iterator & it, SentList * sent)
+{
+  Entry & current = *it;
+  DoneState done = eNotDone;
+  bool fetch = true;
+
+  if (current.hasPacket)
+  {
+    if (current.launchTime > (windowStart + cWindowWidth))
+    {
+      current.done = done = eEndOfWindow;
+      it = next(seq, it);
+      fetch = false;
+    }
+    else if (NULL != sent)
+    {
+      Sent s = { window, current.stream, current.launchTime };
+      sent->push_back(s);
+    }
+  }
+
+  if (fetch)
+  {
+    SimStream & stream = streams[current.stream];
+    current.hasPacket = true;
+    current.launchTime = stream.nextLaunchTime;
+    stream.nextLaunchTime += stream.interval;
+
+    if (current.launchTime > (windowStart + cWindowWidth))
+    {
+      current.done = done = eEndOfWindow;
+      it = next(seq, it);
+    }
+    else
+    {
+      // 'current' might be invalid after this call
+      sortByLaunchTime(seq, it);
+    }
+  }
+
+  EntryList::iterator startPoint = it;
+  while (it->done != eNotDone)
+  {
+    it = next(seq, it);
+    if (startPoint == it)
+    {
+      break;
+    }
+  }
+
+  return done;
+}
+
+void IasLaunchTimeSimulation::runList(std::vector<SimStream> & streams, uint32_t windows, SentList * sent)
+{
+  EntryList seq;
+  for (uint32_t i = 0u; i < streams.size(); i++)
+  {
+    Entry e = { i, false, 0u, eNotDone };
+    seq.push_front(e);
+  }
+  seq.sort();
+  EntryList::iterator it = seq.begin();
+
+  uint64_t windowStart = 1000000u;
+  for (uint32_t w = 0u; w < windows; w++)
+  {
+    for (EntryList::iterator e = seq.begin(); e != seq.end(); e++)
+    {
+      e->done = eNotDone;
+    }
+
+    size_t streamsToService = seq.size();
+    while (streamsToService > 0u)
+    {
+      if (eNotDone != serviceList(seq, streams, w, windowStart, it, sent))
+      {
+        streamsToService--;
+      }
+    }
+
+    // strict packet order
+    seq.sort();
+    it = seq.begin();
+
+    windowStart += cWindowPitch;
+  }
+}
+
+IasLaunchTimeSimulation::DoneState IasLaunchTimeSimulation::serviceHeap(IasAvbLaunchTimeQueue<Entry> & seq, std::vector<SimStream> & streams,
+    uint32_t window, uint64_t windowStart, SentList * sent)
+{
+  Entry & current = seq.top();
+  bool fetch = true;
+
+  if (current.hasPacket)
+  {
+    if (current.launchTime > (windowStart + cWindowWidth))
+    {
+      current.done = eEndOfWindow;
+      fetch = false;
+    }
+    else if (NULL != sent)
+    {
+      Sent s = { window, current.stream, current.launchTime };
+      sent->push_back(s);
+    }
+  }
+
+  if (fetch)
+  {
+    SimStream & stream = streams[current.stream];
+    current.hasPacket = true;
+    current.launchTime = stream.nextLaunchTime;
+    stream.nextLaunchTime += stream.interval;
+
+    if (current.launchTime > (windowStart + cWindowWidth))
+    {
+      current.done = eEndOfWindow;
+    }
+  }
+
+  const DoneState done = current.done;
+  if (eNotDone == done)
+  {
+    (void) seq.updateTop();
+  }
+  else
+  {
+    seq.parkTop();
+  }
+
+  return done;
+}
+
+void IasLaunchTimeSimulation::runHeap(std::vector<SimStream> & streams, uint32_t windows, SentList * sent)
+{
+  IasAvbLaunchTimeQueue<Entry> seq;
+  seq.reserve(streams.size());
+  for (uint32_t i = 0u; i < streams.size(); i++)
+  {
+    Entry e = { i, false, 0u, eNotDone };
+    seq.push(e);
+  }
+
+  uint64_t windowStart = 1000000u;
+  for (uint32_t w = 0u; w < windows; w++)
+  {
+    for (size_t idx = 0u; idx < seq.size(); idx++)
+    {
+      seq[idx].done = eNotDone;
+    }
+    seq.rearm();
+
+    while (!seq.empty())
+    {
+      (void) serviceHeap(seq, streams, w, windowStart, sent);
+    }
+
+    windowStart += cWindowPitch;
+  }
+}
+
+} // namespace IasMediaTransportAvb
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmark.hpp
+ *  @brief Benchmarks of the stream handler's hot paths, comparing them to the implementations they replaced.
+ *  @date 2018
+ */
+#ifndef IASBENCHMARK_HPP_
+#define IASBENCHMARK_HPP_
+
+#include <cstdint>
+#include <time.h>
+
+namespace IasMediaTransportAvb
+{
+
+/**
+ * @brief runs one benchmark and prints its results
+ *
+ * @returns false if the implementations compared didn't produce the same result
+ */
+typedef bool (*IasBenchmarkFunction)();
+
+/**
+ * @brief returns the time in ns, for benchmarks running several threads
+ */
+inline uint64_t getBenchmarkTime()
+{
+  struct timespec tp;
+  (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+  return uint64_t(tp.tv_sec) * 1000000000u + uint64_t(tp.tv_nsec);
+}
+
+/**
+ * @brief returns the CPU time of the calling thread in ns, for benchmarks running on one core
+ */
+inline uint64_t getBenchmarkThreadTime()
+{
+  struct timespec tp;
+  (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tp);
+  return uint64_t(tp.tv_sec) * 1000000000u + uint64_t(tp.tv_nsec);
+}
+
+/**
+ * @brief lock-free packet pool free list compared to the mutex protected one, see IasBenchmarkAvbPacketPool.cpp
+ */
+bool benchmarkPacketPool();
+
+/**
+ * @brief AAF sample conversion kernels of all instruction sets available, see IasBenchmarkAvbAudioConversion.cpp
+ */
+bool benchmarkAudioConversion();
+
+/**
+ * @brief AM824 packets compared to AAF packets of the same sample width, see IasBenchmarkAvbIec61883.cpp
+ */
+bool benchmarkIec61883();
+
+/**
+ * @brief launch time heap compared to the list based TX sequencing, see IasBenchmarkAvbLaunchTimeQueue.cpp
+ */
+bool benchmarkLaunchTimeQueue();
+
+} // namespace IasMediaTransportAvb
+
+#endif /* IASBENCHMARK_HPP_ */
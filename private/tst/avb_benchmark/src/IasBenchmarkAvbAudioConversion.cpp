@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmarkAvbAudioConversion.cpp
+ *  @brief Throughput of the AAF sample conversion kernels, per instruction set, in samples per second on one core.
+ *  @date 2018
+ */
+#include "IasBenchmark.hpp"
+#include "avb_streamhandler/IasAvbAudioConversion.hpp"
+#include "avb_streamhandler/IasAvbAudioStream.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+
+namespace IasMediaTransportAvb
+{
+
+bool benchmarkAudioConversion()
+{
+  typedef IasAvbAudioConversion::AudioData AudioData;
+
+  // a class A packet worth of samples of one channel, in mono and in an 8 channel payload
+  const uint32_t cSamples = 48u;
+  const uint32_t cRuns = 20000u;
+  const IasAvbAudioFormat cFormats[] = { IasAvbAudioFormat::eIasAvbAudioFormatSaf16,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf24,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf32,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSafFloat };
+  const char * cFormatNames[] = { "saf16", "saf24", "saf32", "float" };
+  const uint16_t cChannels[] = { 1u, 8u };
+
+  std::vector<AudioData> samples(cSamples);
+  for (uint32_t idx = 0u; idx < cSamples; idx++)
+  {
+    samples[idx] = AudioData(uint16_t(idx * 2654435761u >> 16));
+  }
+  std::vector<AudioData> back(cSamples);
+  std::vector<uint8_t> wire(cSamples * 8u * 4u);
+  bool ok = true;
+
+  for (uint32_t fmt = 0u; fmt < (sizeof cFormats / sizeof cFormats[0]); fmt++)
+  {
+    for (uint32_t ch = 0u; ch < (sizeof cChannels / sizeof cChannels[0]); ch++)
+    {
+      const uint32_t stride = IasAvbAudioStream::getSampleSize(cFormats[fmt]) * cChannels[ch];
+      for (uint32_t isa = IasAvbAudioConversion::eIsaScalar; isa <= uint32_t(IasAvbAudioConversion::getIsa()); isa++)
+      {
+        IasAvbAudioConversion::PackFunction pack =
+            IasAvbAudioConversion::getPackFunction(cFormats[fmt], IasAvbAudioConversion::Isa(isa));
+        IasAvbAudioConversion::UnpackFunction unpack =
+            IasAvbAudioConversion::getUnpackFunction(cFormats[fmt], IasAvbAudioConversion::Isa(isa));
+
+        const uint64_t start = getBenchmarkThreadTime();
+        for (uint32_t run = 0u; run < cRuns; run++)
+        {
+          pack(samples.data(), wire.data(), cSamples, stride);
+          __asm__ __volatile__("" : : "r"(wire.data()) : "memory");
+        }
+        const uint64_t middle = getBenchmarkThreadTime();
+        for (uint32_t run = 0u; run < cRuns; run++)
+        {
+          unpack(wire.data(), back.data(), cSamples, stride);
+          __asm__ __volatile__("" : : "r"(back.data()) : "memory");
+        }
+        const uint64_t end = getBenchmarkThreadTime();
+
+        const double numSamples = double(cSamples) * double(cRuns);
+        const double packNs = double(middle - start);
+        const double unpackNs = double(end - middle);
+        printf("[ BENCH    ] %-6s %u ch %-6s: pack %8.1f Msamples/s, unpack %8.1f Msamples/s\n",
+            cFormatNames[fmt], cChannels[ch], IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa)),
+            (packNs > 0.0) ? (numSamples * 1e3 / packNs) : 0.0,
+            (unpackNs > 0.0) ? (numSamples * 1e3 / unpackNs) : 0.0);
+
+        // lossless round trip for 16 bit samples
+        ok = ok && std::equal(samples.begin(), samples.end(), back.begin());
+      }
+    }
+  }
+
+  return ok;
+}
+
+} // namespace IasMediaTransportAvb
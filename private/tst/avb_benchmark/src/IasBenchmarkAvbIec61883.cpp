@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmarkAvbIec61883.cpp
+ *  @brief Cost of an IEC 61883-6 AM824 packet compared to AAF packets of the same sample width.
+ *  @date 2018
+ */
+#include "IasBenchmark.hpp"
+#include "avb_streamhandler/IasAvbAudioConversion.hpp"
+#include "avb_streamhandler/IasAvbAudioStream.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+
+namespace IasMediaTransportAvb
+{
+
+bool benchmarkIec61883()
+{
+  typedef IasAvbAudioConversion::AudioData AudioData;
+
+  // class A packets at 48 kHz, AM824 compared to the AAF formats of the same sample width, both conversion paths
+  const IasAvbAudioFormat cFormats[] = { IasAvbAudioFormat::eIasAvbAudioFormatSaf16,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf32,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatIec61883 };
+  const char * cFormatNames[] = { "saf16", "saf32", "am824" };
+  const uint16_t cChannels[] = { 2u, 4u, 6u, 8u };
+  const uint32_t cSamples = 6u;
+  const uint32_t cRuns = 100000u;
+  bool ok = true;
+
+  for (uint32_t idx = 0u; ok && (idx < (sizeof cChannels / sizeof cChannels[0])); idx++)
+  {
+    const uint16_t channels = cChannels[idx];
+    std::vector<AudioData> planar(channels * cSamples);
+    for (uint32_t sample = 0u; sample < planar.size(); sample++)
+    {
+      planar[sample] = AudioData(uint16_t(sample * 2654435761u >> 16));
+    }
+    std::vector<AudioData> frames(channels * cSamples);
+    std::vector<AudioData> back(channels * cSamples);
+    std::vector<uint8_t> wire(channels * cSamples * 4u);
+
+    for (uint32_t fmt = 0u; ok && (fmt < (sizeof cFormats / sizeof cFormats[0])); fmt++)
+    {
+      const uint32_t sampleSize = IasAvbAudioStream::getSampleSize(cFormats[fmt]);
+      IasAvbAudioConversion::PackFunction pack = IasAvbAudioConversion::getPackFunction(cFormats[fmt]);
+      IasAvbAudioConversion::UnpackFunction unpack = IasAvbAudioConversion::getUnpackFunction(cFormats[fmt]);
+      IasAvbAudioConversion::PackFramesFunction packFrames =
+          IasAvbAudioConversion::getPackFramesFunction(cFormats[fmt], channels);
+      IasAvbAudioConversion::UnpackFramesFunction unpackFrames =
+          IasAvbAudioConversion::getUnpackFramesFunction(cFormats[fmt], channels);
+      ok = (NULL != packFrames) && (NULL != unpackFrames);
+
+      if (ok)
+      {
+        // interleave and convert per channel, as done for channel counts without a frame kernel
+        const uint64_t start = getBenchmarkThreadTime();
+        for (uint32_t run = 0u; run < cRuns; run++)
+        {
+          IasAvbAudioConversion::interleave(planar.data(), cSamples, frames.data(), channels, cSamples);
+          pack(frames.data(), wire.data(), channels * cSamples, sampleSize);
+          unpack(wire.data(), frames.data(), channels * cSamples, sampleSize);
+          IasAvbAudioConversion::deinterleave(frames.data(), back.data(), cSamples, channels, cSamples);
+          __asm__ __volatile__("" : : "r"(back.data()) : "memory");
+        }
+        const uint64_t middle = getBenchmarkThreadTime();
+        ok = std::equal(planar.begin(), planar.end(), back.begin());
+
+        std::fill(back.begin(), back.end(), AudioData(0));
+        for (uint32_t run = 0u; run < cRuns; run++)
+        {
+          packFrames(planar.data(), cSamples, wire.data(), cSamples);
+          unpackFrames(wire.data(), back.data(), cSamples, cSamples);
+          __asm__ __volatile__("" : : "r"(back.data()) : "memory");
+        }
+        const uint64_t end = getBenchmarkThreadTime();
+        ok = ok && std::equal(planar.begin(), planar.end(), back.begin());
+
+        printf("[ BENCH    ] %u ch %-5s class A packet tx+rx: generic %6.1f ns, frame kernel %6.1f ns\n",
+            channels, cFormatNames[fmt], double(middle - start) / double(cRuns), double(end - middle) / double(cRuns));
+      }
+    }
+  }
+
+  return ok;
+}
+
+} // namespace IasMediaTransportAvb
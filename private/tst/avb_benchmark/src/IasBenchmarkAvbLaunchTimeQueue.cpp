@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmarkAvbLaunchTimeQueue.cpp
+ *  @brief TX window sequencing: the launch time heap compared to the list the transmit sequencer used before.
+ *  @date 2018
+ */
+#include "IasBenchmark.hpp"
+#include "test_common/IasLaunchTimeSimulation.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+
+namespace IasMediaTransportAvb
+{
+
+bool benchmarkLaunchTimeQueue()
+{
+  typedef IasLaunchTimeSimulation Sim;
+
+  const uint32_t cStreamCounts[] = { 8u, 64u, 256u };
+  const uint32_t cWindows = 2000u;
+  bool ok = true;
+
+  srand(4711u);
+  for (uint32_t c = 0u; c < (sizeof cStreamCounts / sizeof cStreamCounts[0]); c++)
+  {
+    std::vector<Sim::SimStream> listStreams;
+    Sim::createStreams(listStreams, cStreamCounts[c]);
+    std::vector<Sim::SimStream> heapStreams = listStreams;
+
+    uint64_t start = getBenchmarkTime();
+    Sim::runList(listStreams, cWindows, NULL);
+    const uint64_t listTime = getBenchmarkTime() - start;
+
+    start = getBenchmarkTime();
+    Sim::runHeap(heapStreams, cWindows, NULL);
+    const uint64_t heapTime = getBenchmarkTime() - start;
+
+    printf("[ BENCH    ] %3u streams: list %8.1f ns/window, heap %8.1f ns/window\n", cStreamCounts[c],
+        double(listTime) / double(cWindows), double(heapTime) / double(cWindows));
+
+    // both variants need to have serviced the same number of packets
+    for (size_t i = 0u; i < listStreams.size(); i++)
+    {
+      ok = ok && (listStreams[i].nextLaunchTime == heapStreams[i].nextLaunchTime);
+    }
+  }
+
+  return ok;
+}
+
+} // namespace IasMediaTransportAvb
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmarkAvbPacketPool.cpp
+ *  @brief Contention on the packet pool free list: the lock-free stack compared to the mutex protected list.
+ *  @date 2018
+ */
+#include "IasBenchmark.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace IasMediaTransportAvb
+{
+
+namespace
+{
+
+// the mutex protected free list the pool used before switching to the lock-free stack
+class MutexFreeList
+{
+  public:
+    explicit MutexFreeList(const std::vector<IasAvbPacket*> & packets)
+      : mStack(packets)
+    {
+    }
+
+    IasAvbPacket * getPacket()
+    {
+      IasAvbPacket * ret = NULL;
+      mLock.lock();
+      if (!mStack.empty())
+      {
+        ret = mStack.back();
+        mStack.pop_back();
+      }
+      mLock.unlock();
+      return ret;
+    }
+
+    void returnPacket(IasAvbPacket * packet)
+    {
+      mLock.lock();
+      mStack.push_back(packet);
+      mLock.unlock();
+    }
+
+    std::mutex mLock;
+    std::vector<IasAvbPacket*> mStack;
+};
+
+const uint32_t cHeld = 8u;
+
+// each thread repeatedly takes a handful of packets and returns them, like the TX path does
+template <class Pool>
+void contend(Pool * pool, uint32_t rounds)
+{
+  IasAvbPacket * held[cHeld];
+  for (uint32_t r = 0u; r < rounds; r++)
+  {
+    uint32_t count = 0u;
+    while ((count < cHeld) && (NULL != (held[count] = pool->getPacket())))
+    {
+      count++;
+    }
+    for (uint32_t i = 0u; i < count; i++)
+    {
+      (void) pool->returnPacket(held[i]);
+    }
+  }
+}
+
+template <class Pool>
+uint64_t runContention(Pool * pool, uint32_t threads, uint32_t rounds)
+{
+  std::vector<std::thread> workers;
+  const uint64_t start = getBenchmarkTime();
+  for (uint32_t t = 0u; t < threads; t++)
+  {
+    workers.push_back(std::thread(contend<Pool>, pool, rounds));
+  }
+  for (uint32_t t = 0u; t < threads; t++)
+  {
+    workers[t].join();
+  }
+  return getBenchmarkTime() - start;
+}
+
+} // namespace
+
+
+bool benchmarkPacketPool()
+{
+  DltContext dltContext;
+  DLT_REGISTER_CONTEXT_LL_TS(dltContext, "BNCH", "IasBenchmarkAvbPacketPool", DLT_LOG_WARN, DLT_TRACE_STATUS_OFF);
+
+  const uint32_t cPoolSize = 256u;
+  const uint32_t cRounds = 200000u;
+  const uint32_t cThreadCounts[] = { 1u, 2u, 4u };
+
+  IasAvbPacketPool * pool = new IasAvbPacketPool(dltContext);
+  bool ok = (eIasAvbProcOK == pool->init(1024u, cPoolSize));
+
+  // the reference list holds the same packets, it never hands them back to the pool
+  std::vector<IasAvbPacket*> packets;
+  IasAvbPacket * packet = NULL;
+  while (ok && (NULL != (packet = pool->getPacket())))
+  {
+    packets.push_back(packet);
+  }
+  for (size_t i = 0u; i < packets.size(); i++)
+  {
+    (void) IasAvbPacketPool::returnPacket(packets[i]);
+  }
+
+  for (uint32_t c = 0u; ok && (c < (sizeof cThreadCounts / sizeof cThreadCounts[0])); c++)
+  {
+    MutexFreeList reference(packets);
+    const uint64_t mutexTime = runContention(&reference, cThreadCounts[c], cRounds);
+    const uint64_t lockFreeTime = runContention(pool, cThreadCounts[c], cRounds);
+
+    // each round takes and returns cHeld packets
+    const double numOps = double(cRounds) * double(cThreadCounts[c]) * double(2u * cHeld);
+    printf("[ BENCH    ] %u threads: mutex %6.1f ns/op, lock-free %6.1f ns/op\n", cThreadCounts[c],
+        double(mutexTime) / numOps, double(lockFreeTime) / numOps);
+
+    ok = (cPoolSize == uint32_t(reference.mStack.size())) && (cPoolSize == pool->getFreeCount());
+  }
+
+  delete pool;
+  DLT_UNREGISTER_CONTEXT(dltContext);
+
+  return ok;
+}
+
+} // namespace IasMediaTransportAvb
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasBenchmarkMain.cpp
+ *  @date 2018
+ */
+#include "IasBenchmark.hpp"
+
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#undef protected
+#undef private
+
+#include <cstdio>
+#include <cstring>
+
+using namespace IasMediaTransportAvb;
+
+namespace
+{
+
+struct Benchmark
+{
+  const char * name;
+  IasBenchmarkFunction function;
+};
+
+const Benchmark cBenchmarks[] =
+{
+  { "packet_pool", benchmarkPacketPool },
+  { "audio_conversion", benchmarkAudioConversion },
+  { "iec61883", benchmarkIec61883 },
+  { "launch_time_queue", benchmarkLaunchTimeQueue },
+};
+
+const uint32_t cNumBenchmarks = uint32_t(sizeof cBenchmarks / sizeof cBenchmarks[0]);
+
+bool isSelected(const char * name, int argc, char * argv[])
+{
+  bool selected = (argc < 2);
+
+  for (int idx = 1; !selected && (idx < argc); idx++)
+  {
+    selected = (0 == strcmp(name, argv[idx]));
+  }
+
+  return selected;
+}
+
+} // namespace
+
+
+int main(int argc, char * argv[])
+{
+  int result = 0;
+
+  for (int idx = 1; idx < argc; idx++)
+  {
+    bool known = false;
+    for (uint32_t bench = 0u; bench < cNumBenchmarks; bench++)
+    {
+      known = known || (0 == strcmp(cBenchmarks[bench].name, argv[idx]));
+    }
+
+    if (!known)
+    {
+      printf("unknown benchmark %s, available:", argv[idx]);
+      for (uint32_t bench = 0u; bench < cNumBenchmarks; bench++)
+      {
+        printf(" %s", cBenchmarks[bench].name);
+      }
+      printf("\n");
+      result = 2;
+    }
+  }
+
+  if (0 == result)
+  {
+    DLT_REGISTER_APP("IAAB", "AVB Streamhandler benchmarks");
+
+    // the benchmarks use plain memory, no network device needed
+    IasAvbStreamHandlerEnvironment * environment = new IasAvbStreamHandlerEnvironment(DLT_LOG_WARN);
+    environment->registerDltContexts();
+    environment->setDefaultConfigValues();
+    (void) environment->setConfigValue(IasRegKeys::cXmitBackend, "socket");
+
+    for (uint32_t bench = 0u; bench < cNumBenchmarks; bench++)
+    {
+      if (isSelected(cBenchmarks[bench].name, argc, argv))
+      {
+        printf("[ RUN      ] %s\n", cBenchmarks[bench].name);
+        const bool ok = cBenchmarks[bench].function();
+        printf("[ %s ] %s\n", ok ? "      OK" : " FAILED ", cBenchmarks[bench].name);
+        result = ok ? result : 1;
+      }
+    }
+
+    environment->unregisterDltContexts();
+    delete environment;
+
+    DLT_UNREGISTER_APP();
+  }
+
+  return result;
+}
@@ -18,6 +18,8 @@
 #define protected protected
 #define private private
 #include "test_common/IasSpringVilleInfo.hpp"
+#include <cstring>
+#include <thread>
 
 using namespace IasMediaTransportAvb;
 using std::nothrow;
@@ -298,21 +300,21 @@ TEST_F(IasTestAlsaStream, WriteLocalAudioBuffer)
   ASSERT_EQ(0u, samplesWritten);
 
   samplesWritten = 0u;
-  mAlsaStream->mClient = mTestClient;
+  mAlsaStream->mClients[0] = mTestClient;
   result = mAlsaStream->writeLocalAudioBuffer(channelIdx, otherBuffer, otherBufferSize, samplesWritten, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
   ASSERT_EQ(0u, samplesWritten);
 
   samplesWritten = 0u;
-  mAlsaStream->mClient = mTestClient;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasActive;
+  mAlsaStream->mClients[0] = mTestClient;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasActive;
   result = mAlsaStream->writeLocalAudioBuffer(channelIdx, otherBuffer, otherBufferSize, samplesWritten, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
   ASSERT_EQ(0u, samplesWritten);
 
   samplesWritten = 0u;
   IasLocalAudioStreamClientInterfaceImpl * testClient = new IasLocalAudioStreamClientInterfaceImpl(true);
-  mAlsaStream->mClient = testClient;
+  mAlsaStream->mClients[0] = testClient;
   result = mAlsaStream->writeLocalAudioBuffer(channelIdx, buffer, bufferSize, samplesWritten, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
   ASSERT_EQ(0u, samplesWritten);
@@ -409,6 +411,61 @@ TEST_F(IasTestAlsaStream, ReadLocalAudioBuffer)
   ASSERT_EQ(eIasAvbProcInvalidParam, result);
 }
 
+TEST_F(IasTestAlsaStream, ReadWriteLocalAudioBuffers)
+{
+  ASSERT_TRUE(NULL != mAlsaStream);
+
+  const uint32_t bufferSize = 32u;
+  IasLocalAudioBuffer::AudioData buffer[2u * bufferSize];
+  IasLocalAudioBuffer::AudioData readBuffer[2u * (bufferSize + 16u)];
+  uint16_t samplesWritten = 0u;
+  uint16_t samplesRead = 0u;
+  uint64_t timeStamp = 0u;
+
+  ASSERT_EQ(eIasAvbProcNotInitialized, mAlsaStream->writeLocalAudioBuffers(2u, buffer, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcNotInitialized, mAlsaStream->readLocalAudioBuffers(2u, readBuffer, bufferSize, samplesRead, timeStamp));
+
+  std::string deviceName = "AlsaTest";
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->init(2u, 256u, 128u, 256u, 2u, 48000u, mAlsaAudioFormat, 0u, false, deviceName,
+                                             eIasAlsaVirtualDevice));
+  (void) mAlsaStream->setWorkerActive(true);
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->writeLocalAudioBuffers(0u, buffer, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->writeLocalAudioBuffers(3u, buffer, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->writeLocalAudioBuffers(2u, NULL, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->readLocalAudioBuffers(0u, readBuffer, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->readLocalAudioBuffers(3u, readBuffer, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->readLocalAudioBuffers(2u, readBuffer, 0u, samplesRead, timeStamp));
+
+  // channel n is at buffer[n * bufferSize]
+  for (uint32_t sample = 0u; sample < bufferSize; sample++)
+  {
+    buffer[sample] = IasLocalAudioBuffer::AudioData(sample);
+    buffer[bufferSize + sample] = IasLocalAudioBuffer::AudioData(1000u + sample);
+  }
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(2u, buffer, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(bufferSize, samplesWritten);
+
+  // read with a larger pitch than what has been written
+  const uint32_t readSize = bufferSize + 16u;
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(2u, readBuffer, readSize, samplesRead, timeStamp));
+  ASSERT_EQ(bufferSize, samplesRead);
+  ASSERT_EQ(0u, timeStamp);
+  for (uint32_t sample = 0u; sample < bufferSize; sample++)
+  {
+    ASSERT_EQ(buffer[sample], readBuffer[sample]);
+    ASSERT_EQ(buffer[bufferSize + sample], readBuffer[readSize + sample]);
+  }
+
+  // a channel holding less samples than channel 0 is padded with zeros
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffer(0u, buffer, bufferSize, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffer(1u, buffer + bufferSize, bufferSize / 2u, samplesWritten, 0u));
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(2u, readBuffer, readSize, samplesRead, timeStamp));
+  ASSERT_EQ(bufferSize, samplesRead);
+  ASSERT_EQ(buffer[bufferSize], readBuffer[readSize]);
+  ASSERT_EQ(0, readBuffer[readSize + bufferSize - 1u]);
+}
+
 TEST_F(IasTestAlsaStream, ReadLocalAudioBuffer_branch)
 {
   ASSERT_TRUE(NULL != mAlsaStream);
@@ -438,18 +495,18 @@ TEST_F(IasTestAlsaStream, ReadLocalAudioBuffer_branch)
 
   ASSERT_EQ(eIasAvbProcOK, result);
 
-  mAlsaStream->mClient = mTestClient;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasIdle;
+  mAlsaStream->mClients[0] = mTestClient;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasIdle;
   result = mAlsaStream->readLocalAudioBuffer(channelIdx, buffer, bufferSize, samplesRead, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
 
   samplesRead = 0;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasActive;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasActive;
   result = mAlsaStream->readLocalAudioBuffer(channelIdx, buffer, bufferSize, samplesRead, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
 
   samplesRead = 0;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasActive;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasActive;
   mTestClient->mReturn = true;
   result = mAlsaStream->readLocalAudioBuffer(channelIdx, buffer, bufferSize, samplesRead, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
@@ -510,7 +567,7 @@ TEST_F(IasTestAlsaStream, LocalAudioStream_connect)
 
   ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->connect(NULL));
 
-  mAlsaStream->mClient = mTestClient;
+  mAlsaStream->mClients[0] = mTestClient;
   ASSERT_EQ(eIasAvbProcAlreadyInUse, mAlsaStream->connect(mTestClient));
 }
 
@@ -542,17 +599,332 @@ TEST_F(IasTestAlsaStream, LocalAudioStream_setClientActive)
                                              useAlsaDeviceType));
 
   mAlsaStream->setClientActive(false);
-  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasNotConnected, mAlsaStream->mClientState);
+  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasNotConnected, mAlsaStream->mClientStates[0]);
 
-  mAlsaStream->mClient = mTestClient;
+  mAlsaStream->mClients[0] = mTestClient;
   mAlsaStream->setClientActive(false);
-  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasIdle, mAlsaStream->mClientState);
+  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasIdle, mAlsaStream->mClientStates[0]);
 
   mAlsaStream->setClientActive(true);
-  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasActive, mAlsaStream->mClientState);
+  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasActive, mAlsaStream->mClientStates[0]);
 
   mAlsaStream->setClientActive(true);
-  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasActive, mAlsaStream->mClientState);
+  ASSERT_EQ(IasLocalAudioStream::ClientState::eIasActive, mAlsaStream->mClientStates[0]);
+}
+
+TEST_F(IasTestAlsaStream, LocalAudioStream_multipleClients)
+{
+  ASSERT_TRUE(NULL != mAlsaStream);
+  uint16_t numChannels          = 2u;
+  uint32_t totalLocalBufferSize = 256u;
+  uint32_t optimalFillLevel     = 128u;
+  uint32_t alsaPeriodSize       = 64u;
+  uint32_t numAlsaBuffers       = 4u;
+  uint32_t alsaSampleFrequency  = 48000u;
+  IasAvbAudioFormat format      = mAlsaAudioFormat;
+  uint8_t  channelLayout        = 0u;
+  bool   hasSideChannel         = false;
+  std:string deviceName         = "avbtestdev";
+  IasAlsaDeviceTypes useAlsaDeviceType = eIasAlsaVirtualDevice;
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->init(numChannels,
+                                             totalLocalBufferSize,
+                                             optimalFillLevel,
+                                             alsaPeriodSize,
+                                             numAlsaBuffers,
+                                             alsaSampleFrequency,
+                                             format,
+                                             channelLayout,
+                                             hasSideChannel,
+                                             deviceName,
+                                             useAlsaDeviceType));
+
+  // the first talker asks for a reset upon an underrun
+  IasLocalAudioStreamClientInterfaceImpl clients[IasLocalAudioStream::cMaxClients] =
+  {
+    IasLocalAudioStreamClientInterfaceImpl(true), IasLocalAudioStreamClientInterfaceImpl(false),
+    IasLocalAudioStreamClientInterfaceImpl(false), IasLocalAudioStreamClientInterfaceImpl(false)
+  };
+
+  for (uint16_t i = 0u; i < IasLocalAudioStream::cMaxClients; i++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mAlsaStream->connect(&clients[i]));
+    ASSERT_EQ(i, mAlsaStream->getReader(&clients[i]));
+  }
+  ASSERT_EQ(eIasAvbProcAlreadyInUse, mAlsaStream->connect(&clients[0]));
+  ASSERT_EQ(eIasAvbProcAlreadyInUse, mAlsaStream->connect(mTestClient));
+  ASSERT_EQ(IasLocalAudioStream::cMaxClients, mAlsaStream->getReader(mTestClient));
+
+  // only the first two talkers are active
+  mAlsaStream->setClientActive(&clients[0], true);
+  mAlsaStream->setClientActive(&clients[1], true);
+  ASSERT_EQ(3u, mAlsaStream->getChannelBuffers()[0]->getReaders());
+
+  // both talkers drop the silence the reset upon the first activation has put into the buffers
+  const uint32_t numSamples = 64u;
+  IasLocalAudioBuffer::AudioData readBuffer[numSamples * 2u];
+  uint16_t samplesRead = 0u;
+  uint64_t timeStamp = 0u;
+  for (uint16_t reader = 0u; reader < 2u; reader++)
+  {
+    for (uint32_t samples = 0u; samples < optimalFillLevel; samples += numSamples)
+    {
+      ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead,
+                                                                  timeStamp, reader));
+      ASSERT_EQ(numSamples, samplesRead);
+    }
+  }
+  ASSERT_EQ(0u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  IasLocalAudioBuffer::AudioData buffer[numSamples];
+  for (uint32_t i = 0u; i < numSamples; i++)
+  {
+    buffer[i] = IasLocalAudioBuffer::AudioData(i);
+  }
+
+  uint16_t samplesWritten = 0u;
+  for (uint16_t channel = 0u; channel < numChannels; channel++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffer(channel, buffer, numSamples, samplesWritten, 0u));
+    ASSERT_EQ(numSamples, samplesWritten);
+  }
+
+  // each talker gets all samples, the buffer space is released when the slowest one has read them
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead, timeStamp, 0u));
+  ASSERT_EQ(numSamples, samplesRead);
+  ASSERT_EQ(0, memcmp(buffer, &readBuffer[numSamples], sizeof buffer));
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead, timeStamp, 1u));
+  ASSERT_EQ(numSamples, samplesRead);
+  ASSERT_EQ(0, memcmp(buffer, readBuffer, sizeof buffer));
+  ASSERT_EQ(0u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead,
+                                                                         timeStamp, IasLocalAudioStream::cMaxClients));
+
+  // an underrun of the first talker only moves its own cursor back to the second one
+  for (uint16_t channel = 0u; channel < numChannels; channel++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffer(channel, buffer, numSamples, samplesWritten, 0u));
+  }
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead, timeStamp, 0u));
+  ASSERT_EQ(numSamples, samplesRead);
+  const uint32_t resetCount = mAlsaStream->getDiagnostics()->getResetBuffersCount();
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead, timeStamp, 0u));
+  ASSERT_EQ(0u, samplesRead);
+  ASSERT_EQ(resetCount + 1u, mAlsaStream->getDiagnostics()->getResetBuffersCount());
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getReaderFillLevel(0u));
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[1]->getReaderFillLevel(0u));
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getReaderFillLevel(1u));
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples, samplesRead, timeStamp, 1u));
+  ASSERT_EQ(numSamples, samplesRead);
+  ASSERT_EQ(0, memcmp(buffer, readBuffer, sizeof buffer));
+
+  // the remaining talker keeps its cursor
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->disconnect(&clients[0]));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->disconnect(&clients[0]));
+  ASSERT_EQ(2u, mAlsaStream->getChannelBuffers()[0]->getReaders());
+  ASSERT_TRUE(mAlsaStream->isConnected());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->disconnect());
+  ASSERT_FALSE(mAlsaStream->isConnected());
+  ASSERT_EQ(1u, mAlsaStream->getChannelBuffers()[0]->getReaders());
+}
+
+TEST_F(IasTestAlsaStream, LocalAudioStream_mixing)
+{
+  // several listeners are mixed into a receive stream
+  delete mAlsaStream;
+  mAlsaStream = new (nothrow) IasAlsaVirtualDeviceStream(mDltContext, IasAvbStreamDirection::eIasAvbReceiveFromNetwork, 1u);
+  ASSERT_TRUE(NULL != mAlsaStream);
+
+  uint16_t numChannels          = 2u;
+  uint32_t totalLocalBufferSize = 256u;
+  uint32_t optimalFillLevel     = 128u;
+  uint32_t alsaPeriodSize       = 64u;
+  uint32_t numAlsaBuffers       = 4u;
+  uint32_t alsaSampleFrequency  = 48000u;
+  IasAvbAudioFormat format      = mAlsaAudioFormat;
+  uint8_t  channelLayout        = 0u;
+  bool   hasSideChannel         = false;
+  std:string deviceName         = "avbtestdev";
+  IasAlsaDeviceTypes useAlsaDeviceType = eIasAlsaVirtualDevice;
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->init(numChannels,
+                                             totalLocalBufferSize,
+                                             optimalFillLevel,
+                                             alsaPeriodSize,
+                                             numAlsaBuffers,
+                                             alsaSampleFrequency,
+                                             format,
+                                             channelLayout,
+                                             hasSideChannel,
+                                             deviceName,
+                                             useAlsaDeviceType));
+
+  IasLocalAudioStreamClientInterfaceImpl chime(false);
+  IasLocalAudioStreamClientInterfaceImpl prompt(false);
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->connect(&chime));
+  ASSERT_FALSE(mAlsaStream->isMixing());
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->connect(&prompt));
+  ASSERT_TRUE(mAlsaStream->isMixing());
+  ASSERT_EQ(1u, mAlsaStream->getReader(&prompt));
+
+  mAlsaStream->setClientActive(&chime, true);
+  mAlsaStream->setClientActive(&prompt, true);
+
+  // drop the silence the reset has put into the buffers, the reset is taken over by the first read
+  const uint32_t numSamples = 8u;
+  IasLocalAudioBuffer::AudioData readBuffer[totalLocalBufferSize * 2u];
+  uint16_t samplesRead = 0u;
+  uint64_t timeStamp = 0u;
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, totalLocalBufferSize, samplesRead,
+                                                              timeStamp));
+  ASSERT_EQ(optimalFillLevel, samplesRead);
+  ASSERT_EQ(0u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  IasLocalAudioBuffer::AudioData chimeSamples[numSamples * 2u];
+  IasLocalAudioBuffer::AudioData promptSamples[numSamples * 2u];
+  for (uint32_t i = 0u; i < (numSamples * 2u); i++)
+  {
+    chimeSamples[i]  = IasLocalAudioBuffer::AudioData(100);
+    promptSamples[i] = IasLocalAudioBuffer::AudioData(50);
+  }
+
+  // 8 samples at 48kHz take 166667ns
+  const uint32_t t0 = 1000000u;
+  const uint32_t t1 = t0 + 166667u;
+  uint16_t samplesWritten = 0u;
+
+  // the prompt isn't aligned yet, so the chime is passed on right away
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples, samplesWritten, t0, 0u));
+  ASSERT_EQ(numSamples, samplesWritten);
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  // the prompt starts with the second packet of the chime, the mix waits for the chime to deliver it
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, promptSamples, numSamples, samplesWritten, t1, 1u));
+  ASSERT_EQ(numSamples, samplesWritten);
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples, samplesWritten, t1, 0u));
+  ASSERT_EQ(numSamples * 2u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples * 2u, samplesRead, timeStamp));
+  ASSERT_EQ(numSamples * 2u, samplesRead);
+  for (uint16_t channel = 0u; channel < numChannels; channel++)
+  {
+    for (uint32_t i = 0u; i < (numSamples * 2u); i++)
+    {
+      const IasLocalAudioBuffer::AudioData expected = IasLocalAudioBuffer::AudioData((i < numSamples) ? 100 : 150);
+      ASSERT_EQ(expected, readBuffer[(channel * numSamples * 2u) + i]);
+    }
+  }
+
+  // the mix waits for the prompt up to the maximum lag, then the chime is passed on without it
+  mAlsaStream->mMixMaxLag = numSamples * 2u;
+  ASSERT_EQ(0u, mAlsaStream->getMixStalls());
+  for (uint32_t packet = 2u; packet < 4u; packet++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples, samplesWritten,
+                                                                 t0 + (packet * 166667u), 0u));
+    ASSERT_EQ(0u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+  }
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples, samplesWritten,
+                                                               t0 + (4u * 166667u), 0u));
+  ASSERT_EQ(1u, mAlsaStream->getMixStalls());
+  ASSERT_EQ(numSamples * 3u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->readLocalAudioBuffers(numChannels, readBuffer, numSamples * 3u, samplesRead, timeStamp));
+  ASSERT_EQ(numSamples * 3u, samplesRead);
+  for (uint32_t i = 0u; i < (numSamples * 3u); i++)
+  {
+    ASSERT_EQ(IasLocalAudioBuffer::AudioData(100), readBuffer[i]);
+  }
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples,
+                                                                          samplesWritten, t1, IasLocalAudioStream::cMaxClients));
+
+  // with a single listener left, the samples are written directly
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->disconnect(&prompt));
+  ASSERT_FALSE(mAlsaStream->isMixing());
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, chimeSamples, numSamples, samplesWritten, t0, 0u));
+  ASSERT_EQ(numSamples, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->disconnect());
+}
+
+TEST_F(IasTestAlsaStream, LocalAudioStream_overrunNotification)
+{
+  // the clients of a receive stream learn about an overrun once the mix lock has been released
+  class LockProbe : public IasLocalAudioStreamClientInterfaceImpl
+  {
+  public:
+    explicit LockProbe(IasLocalAudioStream *stream)
+      : IasLocalAudioStreamClientInterfaceImpl(false)
+      , mStream(stream)
+      , mCalls(0u)
+      , mLockFree(true)
+    {}
+
+    virtual bool signalDiscontinuity(DiscontinuityEvent event, uint32_t numSamples)
+    {
+      (void) event;
+      (void) numSamples;
+
+      // the lock is recursive, so it has to be probed from another thread
+      bool lockFree = false;
+      std::thread probe([this, &lockFree]()
+      {
+        lockFree = mStream->mMixLock.try_lock();
+        if (lockFree)
+        {
+          mStream->mMixLock.unlock();
+        }
+      });
+      probe.join();
+
+      mLockFree = mLockFree && lockFree;
+      mCalls++;
+      return mReturn;
+    }
+
+    IasLocalAudioStream *mStream;
+    uint32_t mCalls;
+    bool mLockFree;
+  };
+
+  delete mAlsaStream;
+  mAlsaStream = new (nothrow) IasAlsaVirtualDeviceStream(mDltContext, IasAvbStreamDirection::eIasAvbReceiveFromNetwork, 1u);
+  ASSERT_TRUE(NULL != mAlsaStream);
+
+  const uint16_t numChannels          = 2u;
+  const uint32_t totalLocalBufferSize = 256u;
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->init(numChannels, totalLocalBufferSize, totalLocalBufferSize / 2u, 64u, 4u,
+                                             48000u, mAlsaAudioFormat, 0u, false, "avbtestdev", eIasAlsaVirtualDevice));
+
+  LockProbe probe(mAlsaStream);
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->connect(&probe));
+  mAlsaStream->setClientActive(&probe, true);
+
+  IasLocalAudioBuffer::AudioData samples[totalLocalBufferSize * numChannels];
+  (void) memset(samples, 0, sizeof samples);
+  uint16_t samplesWritten = 0u;
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, samples, totalLocalBufferSize, samplesWritten,
+                                                              0u, 0u));
+  ASSERT_EQ(totalLocalBufferSize, samplesWritten);
+  ASSERT_EQ(0u, probe.mCalls);
+
+  // both overrun checks of both channels end up in a single notification
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->writeLocalAudioBuffers(numChannels, samples, 8u, samplesWritten, 0u, 0u));
+  ASSERT_EQ(0u, samplesWritten);
+  ASSERT_EQ(1u, probe.mCalls);
+  ASSERT_TRUE(probe.mLockFree);
+  ASSERT_EQ(0u, mAlsaStream->mMixOverrun);
+
+  ASSERT_EQ(eIasAvbProcOK, mAlsaStream->disconnect());
 }
 
 TEST_F(IasTestAlsaStream, LocalAudioStream_init)
@@ -698,8 +1070,8 @@ TEST_F(IasTestAlsaStream, WriteLocalAudioBuffer_tstamp)
   (void) mAlsaStream->setWorkerActive(true);
 
   IasLocalAudioStreamClientInterfaceImpl * testClient = new IasLocalAudioStreamClientInterfaceImpl(true);
-  mAlsaStream->mClient = testClient;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasActive;
+  mAlsaStream->mClients[0] = testClient;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasActive;
 
   IasAvbProcessingResult result = eIasAvbProcErr;
 
@@ -726,12 +1098,15 @@ TEST_F(IasTestAlsaStream, WriteLocalAudioBuffer_tstamp)
     }
   }
 
-  // overflow
+  // overflow, the producer only requests the samples to be dropped
   result = mAlsaStream->writeLocalAudioBuffer(0u, buffer, bufferSize, samplesWritten, timeStamp);
   ASSERT_EQ(eIasAvbProcOK, result);
-  ASSERT_EQ(64, samplesWritten);
+  ASSERT_EQ(0u, samplesWritten);
 
+  // the consumer drops the samples beyond the optimal fill level with its next read
   ASSERT_EQ(eIasAvbProcOK, mAlsaStream->resetBuffers());
+  ASSERT_EQ(0u, mAlsaStream->getChannelBuffers()[0]->read(buffer, 0u));
+  ASSERT_EQ(totalLocalBufferSize / 2u, mAlsaStream->getChannelBuffers()[0]->getFillLevel());
 
   bufferSize = totalLocalBufferSize;
   result = mAlsaStream->writeLocalAudioBuffer(0u, buffer, bufferSize, samplesWritten, timeStamp);
@@ -752,8 +1127,8 @@ TEST_F(IasTestAlsaStream, ReadLocalAudioBuffer_tstamp)
   (void) mAlsaStream->setWorkerActive(true);
 
   IasLocalAudioStreamClientInterfaceImpl * testClient = new IasLocalAudioStreamClientInterfaceImpl(true);
-  mAlsaStream->mClient = testClient;
-  mAlsaStream->mClientState = IasLocalAudioStream::ClientState::eIasActive;
+  mAlsaStream->mClients[0] = testClient;
+  mAlsaStream->mClientStates[0] = IasLocalAudioStream::ClientState::eIasActive;
 
   IasAvbProcessingResult result = eIasAvbProcErr;
 
@@ -0,0 +1,575 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbAudioConversion.cpp
+ * @brief   The implementation of the IasTestAvbAudioConversion test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbAudioConversion.hpp"
+#include "avb_streamhandler/IasAvbAudioStream.hpp"
+#undef protected
+#undef private
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbAudioConversion : public ::testing::Test
+{
+protected:
+  typedef IasAvbAudioConversion::AudioData AudioData;
+
+  IasTestAvbAudioConversion()
+  {
+  }
+
+  virtual ~IasTestAvbAudioConversion()
+  {
+  }
+
+  virtual void SetUp()
+  {
+  }
+
+  virtual void TearDown()
+  {
+  }
+
+  static std::vector<AudioData> makeSamples(uint32_t numSamples)
+  {
+    std::vector<AudioData> samples(numSamples);
+    for (uint32_t idx = 0u; idx < numSamples; idx++)
+    {
+      samples[idx] = AudioData(uint16_t(idx * 2654435761u >> 16));
+    }
+    // full scale in both directions
+    if (numSamples > 1u)
+    {
+      samples[0] = std::numeric_limits<AudioData>::min();
+      samples[1] = std::numeric_limits<AudioData>::max();
+    }
+    return samples;
+  }
+
+  // compares all kernels of a format with the scalar one, for a couple of lengths, strides and buffer alignments
+  static void compareWithScalar(IasAvbAudioFormat format)
+  {
+    const uint32_t sampleSize = IasAvbAudioStream::getSampleSize(format);
+    const uint32_t cLengths[] = { 0u, 1u, 7u, 8u, 17u, 33u, 48u, 51u, 63u };
+    const uint32_t cChannels[] = { 1u, 2u, 3u, 8u };
+
+    IasAvbAudioConversion::PackFunction refPack =
+        IasAvbAudioConversion::getPackFunction(format, IasAvbAudioConversion::eIsaScalar);
+    IasAvbAudioConversion::UnpackFunction refUnpack =
+        IasAvbAudioConversion::getUnpackFunction(format, IasAvbAudioConversion::eIsaScalar);
+    ASSERT_TRUE(NULL != refPack);
+    ASSERT_TRUE(NULL != refUnpack);
+
+    for (uint32_t isa = IasAvbAudioConversion::eIsaSse2; isa <= IasAvbAudioConversion::getIsa(); isa++)
+    {
+      IasAvbAudioConversion::PackFunction pack =
+          IasAvbAudioConversion::getPackFunction(format, IasAvbAudioConversion::Isa(isa));
+      IasAvbAudioConversion::UnpackFunction unpack =
+          IasAvbAudioConversion::getUnpackFunction(format, IasAvbAudioConversion::Isa(isa));
+
+      for (uint32_t length : cLengths)
+      {
+        for (uint32_t channels : cChannels)
+        {
+          // wire data off by up to three bytes, samples off by one sample
+          for (uint32_t offset = 0u; offset < 4u; offset++)
+          {
+            const uint32_t stride = sampleSize * channels;
+            const uint32_t sampleOffset = offset & 1u;
+            const std::vector<AudioData> samples = makeSamples(length);
+            std::vector<AudioData> src(sampleOffset, 0);
+            src.insert(src.end(), samples.begin(), samples.end());
+            std::vector<uint8_t> ref(offset + stride * length + 1u, 0xA5u);
+            std::vector<uint8_t> out(offset + stride * length + 1u, 0xA5u);
+
+            refPack(src.data() + sampleOffset, ref.data() + offset, length, stride);
+            pack(src.data() + sampleOffset, out.data() + offset, length, stride);
+            ASSERT_EQ(ref, out) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+                << " length " << length << " channels " << channels << " offset " << offset;
+
+            std::vector<AudioData> refBack(sampleOffset + length + 1u, 0);
+            std::vector<AudioData> back(sampleOffset + length + 1u, 0);
+            refUnpack(ref.data() + offset, refBack.data() + sampleOffset, length, stride);
+            unpack(ref.data() + offset, back.data() + sampleOffset, length, stride);
+            ASSERT_EQ(refBack, back) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+                << " length " << length << " channels " << channels << " offset " << offset;
+
+            // lossless round trip for 16 bit samples
+            ASSERT_TRUE(std::equal(samples.begin(), samples.end(), back.begin() + sampleOffset));
+          }
+        }
+      }
+    }
+  }
+
+  // reference for scale()/mix(): fixed point gain for integer samples, rounded and saturated
+  static AudioData applyGain(AudioData sample, float gain)
+  {
+    AudioData result = AudioData(sample * gain);
+    if (std::numeric_limits<AudioData>::is_integer)
+    {
+      const float limited = std::min(std::max(gain, -IasAvbAudioConversion::cMaxGain), IasAvbAudioConversion::cMaxGain);
+      const int64_t fixed = std::min(std::max(int64_t(lrintf(limited * 4096.0f)), int64_t(INT16_MIN)), int64_t(INT16_MAX));
+      const int64_t value = ((int64_t(sample) * fixed) + 2048) >> 12;
+      result = AudioData(std::min(std::max(value, int64_t(std::numeric_limits<AudioData>::min())),
+                                  int64_t(std::numeric_limits<AudioData>::max())));
+    }
+    return result;
+  }
+
+  static AudioData addSamples(AudioData a, AudioData b)
+  {
+    AudioData result = AudioData(a + b);
+    if (std::numeric_limits<AudioData>::is_integer)
+    {
+      const int64_t value = int64_t(a) + int64_t(b);
+      result = AudioData(std::min(std::max(value, int64_t(std::numeric_limits<AudioData>::min())),
+                                  int64_t(std::numeric_limits<AudioData>::max())));
+    }
+    return result;
+  }
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbAudioConversion, getFunction)
+{
+  ASSERT_TRUE(IasAvbAudioConversion::eIsaScalar <= IasAvbAudioConversion::getIsa());
+  ASSERT_TRUE(NULL != IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883));
+  ASSERT_TRUE(NULL != IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883));
+  ASSERT_TRUE(NULL != IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf16));
+  ASSERT_TRUE(NULL != IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSafFloat));
+
+  // requesting more than available falls back to the best one available
+  ASSERT_EQ(IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf32),
+            IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf32, IasAvbAudioConversion::eIsaAvx2));
+  ASSERT_STREQ("scalar", IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::eIsaScalar));
+  ASSERT_STREQ("avx2", IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::eIsaAvx2));
+}
+
+TEST_F(IasTestAvbAudioConversion, wireFormat)
+{
+  const AudioData samples[] = { AudioData(0x1234), AudioData(-2), AudioData(0x4000) };
+  uint8_t wire[3 * 4];
+  IasAvbAudioConversion::PackFunction pack = NULL;
+
+  pack = IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf16);
+  pack(samples, wire, 3u, 2u);
+  const uint8_t saf16[] = { 0x12, 0x34, 0xFF, 0xFE, 0x40, 0x00 };
+  ASSERT_EQ(0, memcmp(saf16, wire, sizeof saf16));
+
+  pack = IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf24);
+  pack(samples, wire, 3u, 3u);
+  const uint8_t saf24[] = { 0x12, 0x34, 0x00, 0xFF, 0xFE, 0x00, 0x40, 0x00, 0x00 };
+  ASSERT_EQ(0, memcmp(saf24, wire, sizeof saf24));
+
+  pack = IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf32);
+  pack(samples, wire, 3u, 4u);
+  const uint8_t saf32[] = { 0x12, 0x34, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00 };
+  ASSERT_EQ(0, memcmp(saf32, wire, sizeof saf32));
+
+  // 0x4000 / 0x7FFF is slightly above 0.5 (0x3F000100)
+  pack = IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSafFloat);
+  pack(samples, wire, 3u, 4u);
+  ASSERT_EQ(0x3F, wire[8]);
+  ASSERT_EQ(0x00, wire[9]);
+  ASSERT_EQ(0x01, wire[10]);
+  ASSERT_EQ(0x00, wire[11]);
+  // sign bit of -2
+  ASSERT_EQ(0x80, wire[4] & 0x80);
+}
+
+TEST_F(IasTestAvbAudioConversion, truncate)
+{
+  // 24 and 32 bit samples lose their LSBs
+  const uint8_t saf32[] = { 0x12, 0x34, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x01 };
+  AudioData samples[2] = { 0, 0 };
+
+  IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf32)(saf32, samples, 2u, 4u);
+  ASSERT_EQ(AudioData(0x1234), samples[0]);
+  ASSERT_EQ(std::numeric_limits<AudioData>::min(), samples[1]);
+
+  IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf24)(saf32, samples, 2u, 3u);
+  ASSERT_EQ(AudioData(0x1234), samples[0]);
+  ASSERT_EQ(AudioData(0xFF80), samples[1]);
+}
+
+TEST_F(IasTestAvbAudioConversion, saturate)
+{
+  const float values[] = { 2.0f, -2.0f, 1.0f, -1.0f, 0.5f, std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                           1e30f, -1e30f, 0.0f, -0.25f, 0.75f, 3.0f, -3.0f, 0.1f, -0.1f };
+  const AudioData expected[] = { 32767, -32768, 32767, -32767, 16384, 32767,
+                                 32767, -32768,
+                                 32767, -32768, 0, -8192, 24575, 32767, -32768, 3277, -3277 };
+  const uint32_t numSamples = uint32_t(sizeof values / sizeof values[0]);
+  uint8_t wire[sizeof values];
+
+  for (uint32_t idx = 0u; idx < numSamples; idx++)
+  {
+    uint32_t bits = 0u;
+    memcpy(&bits, &values[idx], sizeof bits);
+    wire[(idx * 4u) + 0u] = uint8_t(bits >> 24);
+    wire[(idx * 4u) + 1u] = uint8_t(bits >> 16);
+    wire[(idx * 4u) + 2u] = uint8_t(bits >> 8);
+    wire[(idx * 4u) + 3u] = uint8_t(bits);
+  }
+
+  for (uint32_t isa = IasAvbAudioConversion::eIsaScalar; isa <= IasAvbAudioConversion::getIsa(); isa++)
+  {
+    AudioData samples[sizeof values / sizeof values[0]];
+    IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatSafFloat,
+        IasAvbAudioConversion::Isa(isa))(wire, samples, numSamples, 4u);
+    for (uint32_t idx = 0u; idx < numSamples; idx++)
+    {
+      ASSERT_EQ(expected[idx], samples[idx]) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+          << " sample " << idx;
+    }
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, compareSaf16)
+{
+  compareWithScalar(IasAvbAudioFormat::eIasAvbAudioFormatSaf16);
+}
+
+TEST_F(IasTestAvbAudioConversion, compareSaf24)
+{
+  compareWithScalar(IasAvbAudioFormat::eIasAvbAudioFormatSaf24);
+}
+
+TEST_F(IasTestAvbAudioConversion, compareSaf32)
+{
+  compareWithScalar(IasAvbAudioFormat::eIasAvbAudioFormatSaf32);
+}
+
+TEST_F(IasTestAvbAudioConversion, compareSafFloat)
+{
+  compareWithScalar(IasAvbAudioFormat::eIasAvbAudioFormatSafFloat);
+}
+
+TEST_F(IasTestAvbAudioConversion, compareIec61883)
+{
+  compareWithScalar(IasAvbAudioFormat::eIasAvbAudioFormatIec61883);
+}
+
+TEST_F(IasTestAvbAudioConversion, am824)
+{
+  const AudioData samples[] = { AudioData(0x1234), AudioData(-2), AudioData(0x4000) };
+  const uint8_t am824[] = { 0x40, 0x12, 0x34, 0x00, 0x40, 0xFF, 0xFE, 0x00, 0x40, 0x40, 0x00, 0x00 };
+  uint8_t wire[sizeof am824];
+
+  for (uint32_t isa = IasAvbAudioConversion::eIsaScalar; isa <= IasAvbAudioConversion::getIsa(); isa++)
+  {
+    IasAvbAudioConversion::getPackFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883,
+        IasAvbAudioConversion::Isa(isa))(samples, wire, 3u, 4u);
+    ASSERT_EQ(0, memcmp(am824, wire, sizeof am824)) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa));
+  }
+
+  // labels 0x40..0x43 carry audio, everything else is muted; 16 of them to cover the vector kernels
+  uint8_t labeled[16u * 4u];
+  for (uint32_t idx = 0u; idx < 16u; idx++)
+  {
+    const uint8_t cLabels[] = { 0x40, 0x41, 0x42, 0x43, 0x00, 0x80, 0x44, 0xC0 };
+    labeled[(idx * 4u) + 0u] = cLabels[idx % 8u];
+    labeled[(idx * 4u) + 1u] = 0x81;
+    labeled[(idx * 4u) + 2u] = uint8_t(idx);
+    labeled[(idx * 4u) + 3u] = 0x55;
+  }
+
+  for (uint32_t isa = IasAvbAudioConversion::eIsaScalar; isa <= IasAvbAudioConversion::getIsa(); isa++)
+  {
+    AudioData back[16];
+    IasAvbAudioConversion::getUnpackFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883,
+        IasAvbAudioConversion::Isa(isa))(labeled, back, 16u, 4u);
+    for (uint32_t idx = 0u; idx < 16u; idx++)
+    {
+      const AudioData expected = ((idx % 8u) < 4u) ? IasLocalAudioSampleTraits<AudioData>::fromInt32(
+          int32_t(0x81000000u | (idx << 16) | 0x5500u)) : AudioData(0);
+      ASSERT_EQ(expected, back[idx]) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+          << " sample " << idx;
+    }
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, interleave)
+{
+  const uint32_t cLengths[] = { 0u, 1u, 7u, 8u, 15u, 48u, 51u };
+  const uint32_t cPitch = 64u;
+
+  for (uint16_t channels = 1u; channels <= 18u; channels++)
+  {
+    const std::vector<AudioData> planar = makeSamples(channels * cPitch);
+    for (uint32_t len = 0u; len < sizeof cLengths / sizeof cLengths[0]; len++)
+    {
+      const uint32_t numSamples = cLengths[len];
+      std::vector<AudioData> frames(channels * numSamples + 1u, AudioData(0x5A5A));
+      std::vector<AudioData> back(channels * cPitch, 0);
+
+      IasAvbAudioConversion::interleave(planar.data(), cPitch, frames.data(), channels, numSamples);
+      for (uint32_t sample = 0u; sample < numSamples; sample++)
+      {
+        for (uint32_t channel = 0u; channel < channels; channel++)
+        {
+          ASSERT_EQ(planar[channel * cPitch + sample], frames[sample * channels + channel])
+              << channels << " channels, " << numSamples << " samples";
+        }
+      }
+      // nothing written beyond the frames
+      ASSERT_EQ(AudioData(0x5A5A), frames[channels * numSamples]);
+
+      IasAvbAudioConversion::deinterleave(frames.data(), back.data(), cPitch, channels, numSamples);
+      for (uint32_t channel = 0u; channel < channels; channel++)
+      {
+        ASSERT_TRUE(std::equal(planar.begin() + channel * cPitch, planar.begin() + channel * cPitch + numSamples,
+                               back.begin() + channel * cPitch)) << channels << " channels, " << numSamples << " samples";
+        if (numSamples < cPitch)
+        {
+          ASSERT_EQ(0, back[channel * cPitch + numSamples]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, gain)
+{
+  const uint32_t cLengths[] = { 0u, 1u, 7u, 8u, 17u, 51u };
+  const float cGains[] = { 0.0f, 1.0f, 0.5f, -1.0f, 1.5f, 0.7071f, 7.99f, 100.0f, -100.0f };
+
+  for (uint32_t length : cLengths)
+  {
+    const std::vector<AudioData> src = makeSamples(length);
+    std::vector<AudioData> acc = makeSamples(length);
+    std::reverse(acc.begin(), acc.end());
+
+    for (float gain : cGains)
+    {
+      std::vector<AudioData> out(length + 1u, AudioData(0x5A5A));
+      IasAvbAudioConversion::scale(src.data(), out.data(), gain, length);
+      for (uint32_t idx = 0u; idx < length; idx++)
+      {
+        ASSERT_EQ(applyGain(src[idx], gain), out[idx]) << "gain " << gain << " length " << length << " idx " << idx;
+      }
+      ASSERT_EQ(AudioData(0x5A5A), out[length]);
+
+      std::vector<AudioData> mixed(acc);
+      mixed.push_back(AudioData(0x5A5A));
+      IasAvbAudioConversion::mix(src.data(), mixed.data(), gain, length);
+      for (uint32_t idx = 0u; idx < length; idx++)
+      {
+        ASSERT_EQ(addSamples(acc[idx], applyGain(src[idx], gain)), mixed[idx])
+            << "gain " << gain << " length " << length << " idx " << idx;
+      }
+      ASSERT_EQ(AudioData(0x5A5A), mixed[length]);
+    }
+  }
+
+  // unity gain is lossless, full scale saturates on mixing
+  if (std::numeric_limits<AudioData>::is_integer)
+  {
+    std::vector<AudioData> samples = makeSamples(16u);
+    std::vector<AudioData> out(16u);
+    IasAvbAudioConversion::scale(samples.data(), out.data(), 1.0f, 16u);
+    ASSERT_EQ(samples, out);
+    IasAvbAudioConversion::mix(samples.data(), out.data(), 1.0f, 16u);
+    ASSERT_EQ(std::numeric_limits<AudioData>::min(), out[0]);
+    ASSERT_EQ(std::numeric_limits<AudioData>::max(), out[1]);
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, packetInterleaved)
+{
+  // a packet converted frame-interleaved must match the scalar per channel conversion it replaces
+  const IasAvbAudioFormat cFormats[] = { IasAvbAudioFormat::eIasAvbAudioFormatSaf16,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf24,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf32,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSafFloat };
+  const uint16_t cChannels[] = { 1u, 3u, 8u };
+  const uint32_t cLengths[] = { 1u, 6u, 7u, 48u, 51u };
+  const uint32_t cPitch = 64u;
+  const uint32_t cOffset = 3u; // wire data not aligned
+
+  for (uint32_t fmt = 0u; fmt < sizeof cFormats / sizeof cFormats[0]; fmt++)
+  {
+    const uint32_t sampleSize = IasAvbAudioStream::getSampleSize(cFormats[fmt]);
+    IasAvbAudioConversion::PackFunction refPack =
+        IasAvbAudioConversion::getPackFunction(cFormats[fmt], IasAvbAudioConversion::eIsaScalar);
+    IasAvbAudioConversion::UnpackFunction refUnpack =
+        IasAvbAudioConversion::getUnpackFunction(cFormats[fmt], IasAvbAudioConversion::eIsaScalar);
+
+    for (uint32_t isa = IasAvbAudioConversion::eIsaScalar; isa <= IasAvbAudioConversion::getIsa(); isa++)
+    {
+      IasAvbAudioConversion::PackFunction pack =
+          IasAvbAudioConversion::getPackFunction(cFormats[fmt], IasAvbAudioConversion::Isa(isa));
+      IasAvbAudioConversion::UnpackFunction unpack =
+          IasAvbAudioConversion::getUnpackFunction(cFormats[fmt], IasAvbAudioConversion::Isa(isa));
+
+      for (uint16_t channels : cChannels)
+      {
+        const std::vector<AudioData> planar = makeSamples(channels * cPitch);
+        for (uint32_t numSamples : cLengths)
+        {
+          const uint32_t stride = channels * sampleSize;
+          std::vector<AudioData> frames(channels * numSamples);
+          std::vector<uint8_t> reference(cOffset + stride * numSamples + 1u, 0xA5u);
+          std::vector<uint8_t> wire(cOffset + stride * numSamples + 1u, 0xA5u);
+
+          for (uint16_t channel = 0u; channel < channels; channel++)
+          {
+            refPack(planar.data() + channel * cPitch, reference.data() + cOffset + channel * sampleSize, numSamples, stride);
+          }
+          IasAvbAudioConversion::interleave(planar.data(), cPitch, frames.data(), channels, numSamples);
+          pack(frames.data(), wire.data() + cOffset, channels * numSamples, sampleSize);
+          ASSERT_EQ(reference, wire) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+              << " format " << fmt << ", " << channels << " channels, " << numSamples << " samples";
+
+          std::vector<AudioData> refBack(channels * cPitch, 0);
+          std::vector<AudioData> back(channels * cPitch, 0);
+          for (uint16_t channel = 0u; channel < channels; channel++)
+          {
+            refUnpack(reference.data() + cOffset + channel * sampleSize, refBack.data() + channel * cPitch, numSamples, stride);
+          }
+          unpack(wire.data() + cOffset, frames.data(), channels * numSamples, sampleSize);
+          IasAvbAudioConversion::deinterleave(frames.data(), back.data(), cPitch, channels, numSamples);
+          ASSERT_EQ(refBack, back) << IasAvbAudioConversion::getIsaName(IasAvbAudioConversion::Isa(isa))
+              << " format " << fmt << ", " << channels << " channels, " << numSamples << " samples";
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, frames)
+{
+  const IasAvbAudioFormat cFormats[] = { IasAvbAudioFormat::eIasAvbAudioFormatSaf16,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf24,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSaf32,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatSafFloat,
+                                         IasAvbAudioFormat::eIasAvbAudioFormatIec61883 };
+  const uint32_t cLengths[] = { 0u, 1u, 6u, 7u, 12u, 13u, 51u };
+  const uint32_t cPitch = 64u;
+
+  // there are no frame kernels for odd channel counts above one, the caller falls back to the per channel path
+  ASSERT_TRUE(NULL == IasAvbAudioConversion::getPackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf16, 3u));
+  ASSERT_TRUE(NULL == IasAvbAudioConversion::getUnpackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatSaf16, 3u));
+  ASSERT_TRUE(NULL == IasAvbAudioConversion::getPackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883, 3u));
+  ASSERT_TRUE(NULL == IasAvbAudioConversion::getUnpackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883, 3u));
+
+  for (uint32_t fmt = 0u; fmt < sizeof cFormats / sizeof cFormats[0]; fmt++)
+  {
+    const uint32_t sampleSize = IasAvbAudioStream::getSampleSize(cFormats[fmt]);
+    IasAvbAudioConversion::PackFunction pack =
+        IasAvbAudioConversion::getPackFunction(cFormats[fmt], IasAvbAudioConversion::eIsaScalar);
+    IasAvbAudioConversion::UnpackFunction unpack =
+        IasAvbAudioConversion::getUnpackFunction(cFormats[fmt], IasAvbAudioConversion::eIsaScalar);
+
+    for (uint16_t channels = 0u; channels <= 9u; channels++)
+    {
+      IasAvbAudioConversion::PackFramesFunction packFrames =
+          IasAvbAudioConversion::getPackFramesFunction(cFormats[fmt], channels);
+      IasAvbAudioConversion::UnpackFramesFunction unpackFrames =
+          IasAvbAudioConversion::getUnpackFramesFunction(cFormats[fmt], channels);
+
+      const bool specialized = (1u == channels) || (2u == channels) || (4u == channels) || (6u == channels) || (8u == channels);
+      ASSERT_EQ(specialized, NULL != packFrames) << channels;
+      ASSERT_EQ(specialized, NULL != unpackFrames) << channels;
+      if (!specialized)
+      {
+        continue;
+      }
+
+      // local buffer off by one sample, wire data off by up to three bytes
+      const std::vector<AudioData> planar = makeSamples(channels * cPitch + 1u);
+      for (uint32_t offset = 0u; offset < 4u; offset++)
+      {
+        const uint32_t sampleOffset = offset & 1u;
+        for (uint32_t len = 0u; len < sizeof cLengths / sizeof cLengths[0]; len++)
+        {
+          const uint32_t numSamples = cLengths[len];
+          std::vector<AudioData> frames(channels * numSamples + 1u);
+          std::vector<uint8_t> ref(offset + channels * numSamples * sampleSize + 1u, 0xA5u);
+          std::vector<uint8_t> out(offset + channels * numSamples * sampleSize + 1u, 0xA5u);
+
+          // same as the scalar two step conversion, nothing written beyond the frames
+          IasAvbAudioConversion::interleave(planar.data() + sampleOffset, cPitch, frames.data(), channels, numSamples);
+          pack(frames.data(), ref.data() + offset, channels * numSamples, sampleSize);
+          packFrames(planar.data() + sampleOffset, cPitch, out.data() + offset, numSamples);
+          ASSERT_EQ(ref, out) << channels << " channels, " << numSamples << " samples, offset " << offset;
+
+          std::vector<AudioData> refBack(sampleOffset + channels * cPitch, 0);
+          std::vector<AudioData> back(sampleOffset + channels * cPitch, 0);
+          unpack(ref.data() + offset, frames.data(), channels * numSamples, sampleSize);
+          IasAvbAudioConversion::deinterleave(frames.data(), refBack.data() + sampleOffset, cPitch, channels, numSamples);
+          unpackFrames(ref.data() + offset, back.data() + sampleOffset, cPitch, numSamples);
+          ASSERT_EQ(refBack, back) << channels << " channels, " << numSamples << " samples, offset " << offset;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IasTestAvbAudioConversion, am824Frames)
+{
+  // AM824 frame kernels: every quadlet carries the MBLA label, and the samples survive the round trip
+  const uint16_t cChannels[] = { 2u, 4u, 6u, 8u };
+  const uint32_t cLengths[] = { 1u, 6u, 7u, 13u };
+  const uint32_t cOffset = 1u; // wire data not aligned
+  const uint32_t sampleSize = IasAvbAudioStream::getSampleSize(IasAvbAudioFormat::eIasAvbAudioFormatIec61883);
+  ASSERT_EQ(4u, sampleSize);
+
+  for (uint16_t channels : cChannels)
+  {
+    IasAvbAudioConversion::PackFramesFunction packFrames =
+        IasAvbAudioConversion::getPackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883, channels);
+    IasAvbAudioConversion::UnpackFramesFunction unpackFrames =
+        IasAvbAudioConversion::getUnpackFramesFunction(IasAvbAudioFormat::eIasAvbAudioFormatIec61883, channels);
+    ASSERT_TRUE((NULL != packFrames) && (NULL != unpackFrames));
+
+    for (uint32_t numSamples : cLengths)
+    {
+      const std::vector<AudioData> planar = makeSamples(channels * numSamples);
+      std::vector<uint8_t> wire(cOffset + channels * numSamples * sampleSize + 1u, 0xA5u);
+      std::vector<AudioData> back(channels * numSamples, 0);
+
+      packFrames(planar.data(), numSamples, wire.data() + cOffset, numSamples);
+      for (uint32_t sample = 0u; sample < numSamples; sample++)
+      {
+        for (uint16_t channel = 0u; channel < channels; channel++)
+        {
+          const uint8_t * const quadlet = wire.data() + cOffset + (sample * channels + channel) * sampleSize;
+          const uint16_t value = uint16_t(planar[channel * numSamples + sample]);
+          ASSERT_EQ(0x40, quadlet[0]) << channels << " channels, sample " << sample;
+          ASSERT_EQ(uint8_t(value >> 8), quadlet[1]) << channels << " channels, sample " << sample;
+          ASSERT_EQ(uint8_t(value), quadlet[2]) << channels << " channels, sample " << sample;
+          ASSERT_EQ(0x00, quadlet[3]) << channels << " channels, sample " << sample;
+        }
+      }
+      ASSERT_EQ(0xA5u, wire[0]);
+      ASSERT_EQ(0xA5u, wire[wire.size() - 1u]);
+
+      unpackFrames(wire.data() + cOffset, back.data(), numSamples, numSamples);
+      ASSERT_EQ(planar, back) << channels << " channels, " << numSamples << " samples";
+    }
+  }
+}
@@ -294,9 +294,9 @@ TEST_F(IasTestAvbAudioStream, InitTransmit)
 
   sampleFreq = 48000u;
   format = IasAvbAudioFormat::eIasAvbAudioFormatIec61883;
-  // sampleFreq == 48000u || format != IasAvbAudioFormat::eIasAvbAudioFormatSaf16
+  // more channels than the DBS field can describe
   ASSERT_EQ(eIasAvbProcUnsupportedFormat, mAudioStream->initTransmit(srClass,
-                                                                     maxNumberChannels,
+                                                                     256u,
                                                                      sampleFreq,
                                                                      format,
                                                                      avbStreamIdObj,
@@ -305,6 +305,20 @@ TEST_F(IasTestAvbAudioStream, InitTransmit)
                                                                      avbMacAddr,
                                                                      true));
 
+  // sampleFreq == 48000u && format == IasAvbAudioFormat::eIasAvbAudioFormatIec61883
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->initTransmit(srClass,
+                                                      maxNumberChannels,
+                                                      sampleFreq,
+                                                      format,
+                                                      avbStreamIdObj,
+                                                      poolSize,
+                                                      avbClockDomainObj,
+                                                      avbMacAddr,
+                                                      true));
+  ASSERT_EQ(2u, mAudioStream->mSampleFrequencyCode);
+  ASSERT_EQ(8u, mAudioStream->mSytInterval);
+  mAudioStream->cleanup();
+
   sampleFreq = 12000u;
   format = IasAvbAudioFormat::eIasAvbAudioFormatIec61883;
   // !(48000u == sampleFreq || 24000 == sampleFreq)            (!(F || F ||T))
@@ -475,14 +489,15 @@ TEST_F(IasTestAvbAudioStream, InitReceive)
 
   sampleFreq = 48000u;
 
-  ASSERT_EQ(eIasAvbProcUnsupportedFormat, mAudioStream->initReceive(srClass,
-                                                                    maxNumberChannels,
-                                                                    sampleFreq,
-                                                                    format,
-                                                                    streamId,
-                                                                    dmac,
-                                                                    vid,
-                                                                    true));
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->initReceive(srClass,
+                                                     maxNumberChannels,
+                                                     sampleFreq,
+                                                     format,
+                                                     streamId,
+                                                     dmac,
+                                                     vid,
+                                                     true));
+  mAudioStream->cleanup();
 
   format = IasAvbAudioFormat::eIasAvbAudioFormatSaf16;
   vid = 2u;
@@ -531,6 +546,43 @@ TEST_F(IasTestAvbAudioStream, initTransmit_config_options)
                IasAvbAudioFormat::eIasAvbAudioFormatSaf16, avbStreamIdObj, 2, &avbClockDomainObj, avbMacAddr, true));
 }
 
+TEST_F(IasTestAvbAudioStream, AafFormats)
+{
+  ASSERT_TRUE(mAudioStream != NULL);
+
+  ASSERT_EQ(eIasAvbProcOK, initStreamHandler());
+
+  IasAvbStreamId avbStreamIdObj;
+  IasAvbPtpClockDomain avbClockDomainObj;
+  IasAvbMacAddress avbMacAddr = {};
+  const IasAvbAudioFormat formats[] = { IasAvbAudioFormat::eIasAvbAudioFormatSaf24,
+                                        IasAvbAudioFormat::eIasAvbAudioFormatSaf32,
+                                        IasAvbAudioFormat::eIasAvbAudioFormatSafFloat };
+  const uint8_t bitDepth[] = { 24u, 32u, 32u };
+
+  for (uint32_t idx = 0u; idx < sizeof formats / sizeof formats[0]; idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mAudioStream->initTransmit(IasAvbSrClass::eIasAvbSrClassHigh, 2, 48000u,
+                 formats[idx], avbStreamIdObj, 2, &avbClockDomainObj, avbMacAddr, true));
+    ASSERT_TRUE(IasAvbAudioConversion::getPackFunction(formats[idx]) == mAudioStream->mPackSamples);
+    ASSERT_EQ(IasAvbAudioStream::getFormatCode(formats[idx]), mAudioStream->mAudioFormatCode);
+
+    IasAvbPacket * packet = mAudioStream->getPacketPool().getPacket();
+    ASSERT_TRUE(NULL != packet);
+    const uint8_t* const avtpBase8 = static_cast<uint8_t*>(packet->getBasePtr()) + ETH_HLEN + 4u;
+    ASSERT_EQ(mAudioStream->mAudioFormatCode, avtpBase8[16]);
+    ASSERT_EQ(bitDepth[idx], avtpBase8[19]);
+    ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+    mAudioStream->cleanup();
+    ASSERT_TRUE(NULL == mAudioStream->mPackSamples);
+
+    ASSERT_EQ(eIasAvbProcOK, mAudioStream->initReceive(IasAvbSrClass::eIasAvbSrClassHigh, 2, 48000u,
+                 formats[idx], avbStreamIdObj, avbMacAddr, 2u, true));
+    ASSERT_TRUE(IasAvbAudioConversion::getUnpackFunction(formats[idx]) == mAudioStream->mUnpackSamples);
+    mAudioStream->cleanup();
+  }
+}
+
 #if 1 // TODO: replace JackStream!
 TEST_F(IasTestAvbAudioStream, ConnectTo)
 {
@@ -645,6 +697,131 @@ TEST_F(IasTestAvbAudioStream, GetSampleSize)
   ASSERT_EQ(4, mAudioStream->getSampleSize(IasAvbAudioFormat::eIasAvbAudioFormatIec61883));
 }
 
+TEST_F(IasTestAvbAudioStream, Iec61883CipHeader)
+{
+  ASSERT_TRUE(mAudioStream != NULL);
+
+  ASSERT_EQ(0u, IasAvbAudioStream::getIec61883SampleFrequencyCode(32000u));
+  ASSERT_EQ(2u, IasAvbAudioStream::getIec61883SampleFrequencyCode(48000u));
+  ASSERT_EQ(6u, IasAvbAudioStream::getIec61883SampleFrequencyCode(192000u));
+  ASSERT_EQ(0xFFu, IasAvbAudioStream::getIec61883SampleFrequencyCode(24000u));
+
+  mAudioStream->mAudioFormat = IasAvbAudioFormat::eIasAvbAudioFormatIec61883;
+  mAudioStream->mSytInterval = 8u;
+  mAudioStream->mSampleInterval = IasAvbSampleTime::fromFrequency(48000u);
+  mAudioStream->mRefPlaneSampleTime = 1000000u;
+  mAudioStream->mDbc = 0u;
+
+  uint8_t avtp[cIasAvtpHeaderSize + cIasCipHeaderSize + 2u * 6u * 4u] = {};
+  const uint32_t* const avtp32 = reinterpret_cast<const uint32_t*>(avtp);
+  const uint32_t ptOffset = mAudioStream->getPresentationTimeOffset();
+
+  // 6 samples per packet, SYT_INTERVAL 8: data blocks 0, 8, 16 are time stamped, the fourth packet has none
+  const uint8_t  expectedDbc[]    = { 0u, 6u, 12u, 18u, 24u };
+  const uint16_t expectedOffset[] = { 0u, 2u, 4u, 6u, 0u };
+  for (uint32_t i = 0u; i < sizeof expectedDbc; i++)
+  {
+    mAudioStream->writeCipHeader(avtp, 2u, 6u);
+    ASSERT_EQ(2u, avtp[25]);
+    ASSERT_EQ(expectedDbc[i], avtp[27]);
+    if (expectedOffset[i] < 6u)
+    {
+      ASSERT_EQ(0x01u, avtp[1] & 0x01u);
+      ASSERT_EQ(uint32_t(1000000u + ptOffset + IasAvbSampleTime::toNs(mAudioStream->mSampleInterval, expectedOffset[i])),
+                ntohl(avtp32[3]));
+    }
+    else
+    {
+      ASSERT_EQ(0x00u, avtp[1] & 0x01u);
+    }
+  }
+  ASSERT_EQ(30u, mAudioStream->mDbc);
+
+  // DBC wraps around at 256, which is a multiple of every SYT_INTERVAL
+  mAudioStream->mDbc = 254u;
+  mAudioStream->writeCipHeader(avtp, 2u, 6u);
+  ASSERT_EQ(0x01u, avtp[1] & 0x01u);
+  ASSERT_EQ(4u, mAudioStream->mDbc);
+
+  // stream_data_length includes the CIP header
+  avtp[20] = 0u;
+  avtp[21] = uint8_t(cIasCipHeaderSize + 48u);
+  ASSERT_EQ(48u, mAudioStream->getPayloadLength(avtp));
+  avtp[21] = 4u;
+  ASSERT_EQ(0u, mAudioStream->getPayloadLength(avtp));
+}
+
+TEST_F(IasTestAvbAudioStream, ChannelRouting)
+{
+  ASSERT_TRUE(mAudioStream != NULL);
+  typedef IasLocalAudioBuffer::AudioData AudioData;
+
+  ChannelRoutingList routing;
+  ASSERT_EQ(eIasAvbProcNotInitialized, mAudioStream->setChannelRouting(routing));
+
+  ASSERT_EQ(eIasAvbProcOK, initStreamHandler());
+  IasAvbStreamId avbStreamId(uint64_t(1u));
+  IasAvbMacAddress avbMacAddr = {0};
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->initReceive(IasAvbSrClass::eIasAvbSrClassHigh, 4u, 48000u,
+                                                     IasAvbAudioFormat::eIasAvbAudioFormatSaf16,
+                                                     avbStreamId, avbMacAddr, 2u, true));
+
+  // indices out of range and non finite gains are rejected, the routing is left unchanged
+  routing.push_back(IasAvbChannelRoute{4u, 0u, 1.0f});
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAudioStream->setChannelRouting(routing));
+  routing[0] = IasAvbChannelRoute{0u, 4u, 1.0f};
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAudioStream->setChannelRouting(routing));
+  routing[0] = IasAvbChannelRoute{0u, 0u, NAN};
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAudioStream->setChannelRouting(routing));
+  ASSERT_TRUE(mAudioStream->mRoutes.empty());
+  ASSERT_EQ(2u, mAudioStream->getNetworkChannels(2u));
+
+  // AVB 2 -> local 0, AVB 0 + AVB 1 at half gain -> local 1, local 2 unrouted
+  routing.clear();
+  routing.push_back(IasAvbChannelRoute{1u, 1u, 0.5f});
+  routing.push_back(IasAvbChannelRoute{2u, 0u, 1.0f});
+  routing.push_back(IasAvbChannelRoute{0u, 1u, 0.5f});
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->setChannelRouting(routing));
+  ASSERT_TRUE(mAudioStream->mRouteBuffer != NULL);
+  ASSERT_EQ(3u, mAudioStream->mRoutedChannels);
+  ASSERT_EQ(4u, mAudioStream->getNetworkChannels(3u));
+  ASSERT_EQ(0u, mAudioStream->mRoutes[0].destination);
+
+  const uint32_t numSamples = 4u;
+  AudioData src[3u * numSamples];
+  AudioData dst[3u * numSamples];
+  for (uint32_t i = 0u; i < 3u * numSamples; i++)
+  {
+    src[i] = AudioData(100 * (i / numSamples + 1u));
+    dst[i] = AudioData(1);
+  }
+  mAudioStream->routeChannels(src, numSamples, 3u, dst, numSamples, 3u, numSamples);
+  for (uint32_t i = 0u; i < numSamples; i++)
+  {
+    ASSERT_EQ(AudioData(300), dst[i]);
+    ASSERT_EQ(AudioData(150), dst[numSamples + i]);
+    ASSERT_EQ(AudioData(0), dst[2u * numSamples + i]);
+  }
+
+  // sources beyond the channels of the packet are skipped
+  mAudioStream->routeChannels(src, numSamples, 2u, dst, numSamples, 2u, numSamples);
+  ASSERT_EQ(AudioData(0), dst[0]);
+  ASSERT_EQ(AudioData(150), dst[numSamples]);
+
+  // a new routing keeps the buffer the packet path may be using
+  AudioData * const routeBuffer = mAudioStream->mRouteBuffer;
+  routing.pop_back();
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->setChannelRouting(routing));
+  ASSERT_EQ(routeBuffer, mAudioStream->mRouteBuffer);
+  ASSERT_EQ(2u, mAudioStream->mRoutes.size());
+
+  // an empty list restores the one to one mapping
+  routing.clear();
+  ASSERT_EQ(eIasAvbProcOK, mAudioStream->setChannelRouting(routing));
+  ASSERT_EQ(2u, mAudioStream->getNetworkChannels(2u));
+  ASSERT_EQ(routeBuffer, mAudioStream->mRouteBuffer);
+}
+
 #if 1 // TODO: replace JackStream!
 TEST_F(IasTestAvbAudioStream, WriteToAvbPacket)
 {
@@ -747,7 +924,7 @@ TEST_F(IasTestAvbAudioStream, WriteToAvbPacket)
   mAudioStream->mSeqNum                 = 7u;
   mAudioStream->mDummySamplesSent       = 1u;
   mAudioStream->mDumpCount              = 11u;
-  mAudioStream->mSampleIntervalNs       = -0.08f;
+  mAudioStream->mSampleInterval         = 0u;
   // avtpBase8[22] & 0x10                          (T)
   // !(mSeqNum % 8)                                (F)
   // (eIasAvbCompSaf == mCompatibilityModeAudio)  (F)
@@ -1700,9 +1877,9 @@ TEST_F(IasTestAvbAudioStream, prepareAllPackets)
   ASSERT_EQ(eIasAvbProcOK, mAudioStream->prepareAllPackets());
 
   IasAvbPacketPool * mPool = &mAudioStream->getPacketPool();
-  mPool->mLock.lock();
-  mPool->mFreeBufferStack.clear();
-  mPool->mLock.unlock();
+  // empty the free list
+  mPool->mFreeHead.store(IasAvbPacketPool::cEndOfList);
+  mPool->mFreeCount.store(0u);
   // NULL == referencePacket
   ASSERT_EQ(eIasAvbProcInitializationFailed, mAudioStream->prepareAllPackets());
 }
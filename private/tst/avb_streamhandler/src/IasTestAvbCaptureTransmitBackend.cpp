@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbCaptureTransmitBackend.cpp
+ * @brief   The implementation of the IasTestAvbCaptureTransmitBackend test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbCaptureTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbTransmitSequencer.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#undef protected
+#undef private
+
+#include <unistd.h>
+#include <cstring>
+
+using namespace IasMediaTransportAvb;
+
+extern size_t heapSpaceLeft;
+extern size_t heapSpaceInitSize;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbCaptureTransmitBackend : public ::testing::Test
+{
+protected:
+  IasTestAvbCaptureTransmitBackend()
+    : mEnvironment(NULL)
+    , mBackend(NULL)
+    , mPool(NULL)
+    , mFileName("/tmp/IasTestAvbCaptureTransmitBackend.pcap")
+  {
+    DLT_REGISTER_APP("IATB", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbCaptureTransmitBackend()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    heapSpaceLeft = heapSpaceInitSize;
+
+    dlt_enable_local_print();
+    mEnvironment = new IasAvbStreamHandlerEnvironment(DLT_LOG_INFO);
+    ASSERT_TRUE(NULL != mEnvironment);
+    mEnvironment->registerDltContexts();
+    mEnvironment->setDefaultConfigValues();
+    mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "capture");
+
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbCaptureTransmitBackend",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mBackend = new IasAvbCaptureTransmitBackend(mDltCtx);
+    mPool = new IasAvbPacketPool(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mBackend;
+    mBackend = NULL;
+    delete mPool;
+    mPool = NULL;
+
+    (void) unlink((mFileName + "0").c_str());
+
+    if (NULL != mEnvironment)
+    {
+      mEnvironment->unregisterDltContexts();
+      delete mEnvironment;
+      mEnvironment = NULL;
+    }
+
+    heapSpaceLeft = heapSpaceInitSize;
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  IasAvbPacket * createPacket(uint16_t len, uint8_t fill)
+  {
+    IasAvbPacket * packet = mPool->getPacket();
+    if (NULL != packet)
+    {
+      uint8_t * data = static_cast<uint8_t*>(packet->getBasePtr());
+      std::memset(data, 0xFF, 6u);         // broadcast destination
+      std::memset(data + 6u, 0x02, 6u);    // locally administered source
+      data[12] = 0x81u;                    // VLAN tag
+      data[13] = 0x00u;
+      std::memset(data + 14u, fill, len - 14u);
+      packet->len = len;
+      packet->attime = 0u;
+    }
+    return packet;
+  }
+
+  IasAvbStreamHandlerEnvironment * mEnvironment;
+  IasAvbCaptureTransmitBackend * mBackend;
+  IasAvbPacketPool * mPool;
+  std::string mFileName;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbCaptureTransmitBackend, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mBackend);
+  ASSERT_FALSE(mBackend->mInitialized);
+  ASSERT_FALSE(mBackend->mFile.isOpen());
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, isIgbTransmitBackend)
+{
+  ASSERT_FALSE(IasAvbStreamHandlerEnvironment::isIgbTransmitBackend());
+  ASSERT_TRUE(mEnvironment->validateRegistryEntries());
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, init)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cXmitCaptureFile, "/nonexistent/capture");
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_FALSE(mBackend->mInitialized);
+
+  mEnvironment->setConfigValue(IasRegKeys::cXmitCaptureFile, mFileName);
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_TRUE(mBackend->mFile.isOpen());
+  ASSERT_EQ(0, access((mFileName + "0").c_str(), F_OK));
+
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+
+  mBackend->cleanup();
+  ASSERT_FALSE(mBackend->mInitialized);
+  ASSERT_FALSE(mBackend->mFile.isOpen());
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, xmitNotInitialized)
+{
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+  IasAvbPacket * packet = createPacket(64u, 0u);
+  ASSERT_TRUE(NULL != packet);
+
+  ASSERT_EQ(-ENXIO, mBackend->xmit(packet));
+  ASSERT_EQ(0u, mBackend->reclaim(true));
+
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, xmitCapture)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cXmitCaptureFile, mFileName);
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  IasAvbPacket * burst[4];
+  for (uint32_t i = 0u; i < 4u; i++)
+  {
+    burst[i] = createPacket(uint16_t(64u + i), uint8_t(i));
+    ASSERT_TRUE(NULL != burst[i]);
+    burst[i]->attime = 1000000000u + (i * 125000u);
+  }
+
+  int32_t result = -1;
+  ASSERT_EQ(4u, mBackend->xmitBurst(burst, 4u, result));
+  ASSERT_EQ(0, result);
+  // written right away, all buffers are back in the pool
+  ASSERT_EQ(4u, mPool->getFreeCount());
+  ASSERT_EQ(0u, mBackend->reclaim(true));
+  ASSERT_EQ(4u, mBackend->mPacketCount);
+  mBackend->cleanup();
+
+  IasAvbPcapFile file;
+  ASSERT_EQ(eIasAvbProcOK, file.openRead(mFileName + "0"));
+  uint8_t buffer[128];
+  uint32_t length = 0u;
+  uint64_t time = 0u;
+  for (uint32_t i = 0u; i < 4u; i++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, file.readFrame(buffer, sizeof buffer, length, time));
+    ASSERT_EQ(64u + i, length);
+    ASSERT_EQ(1000000000u + (i * 125000u), time);
+    ASSERT_EQ(0xFF, buffer[0]);
+    ASSERT_EQ(i, buffer[length - 1u]);
+  }
+  ASSERT_EQ(eIasAvbProcOff, file.readFrame(buffer, sizeof buffer, length, time));
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, xmitNoFile)
+{
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_FALSE(mBackend->mFile.isOpen());
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  IasAvbPacket * packet = createPacket(64u, 0u);
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(0, mBackend->xmit(packet));
+  ASSERT_EQ(4u, mPool->getFreeCount());
+  ASSERT_EQ(1u, mBackend->mPacketCount);
+  ASSERT_EQ(64u, mBackend->mByteCount);
+
+  IasAvbPacket notFromPool;
+  ASSERT_EQ(-EINVAL, mBackend->xmit(&notFromPool));
+  ASSERT_EQ(1u, mBackend->mPacketCount);
+}
+
+TEST_F(IasTestAvbCaptureTransmitBackend, sequencerBackend)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+
+  IasAvbTransmitSequencer sequencer(mDltCtx);
+  ASSERT_EQ(eIasAvbProcOK, sequencer.init(0u, IasAvbSrClass::eIasAvbSrClassHigh, true));
+  ASSERT_TRUE(NULL != dynamic_cast<IasAvbCaptureTransmitBackend*>(sequencer.mBackend));
+
+  sequencer.updateShaper();
+  ASSERT_EQ(0u, sequencer.reclaimPackets());
+
+  sequencer.cleanup();
+  ASSERT_TRUE(NULL == sequencer.mBackend);
+}
@@ -192,6 +192,13 @@ class IasAvbStreamHandlerInterfaceImpl: public IasAvbStreamHandlerInterface
       return IasAvbResult::eIasAvbResultOk;
     }
 
+    virtual IasAvbResult setChannelRouting(AvbStreamId networkStreamId, const ChannelRoutingList &routing)
+    {
+      (void) networkStreamId;
+      (void) routing;
+      return IasAvbResult::eIasAvbResultOk;
+    }
+
     virtual IasAvbResult setChannelLayout(uint16_t localStreamId, uint8_t channelLayout)
     {
       (void) localStreamId;
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ *  @file IasTestAvbLaunchTimeQueue.cpp
+ *  @date 2018
+ */
+#include "gtest/gtest.h"
+
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbLaunchTimeQueue.hpp"
+#undef protected
+#undef private
+
+#include "test_common/IasLaunchTimeSimulation.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbLaunchTimeQueue : public ::testing::Test, public IasLaunchTimeSimulation
+{
+protected:
+  IasTestAvbLaunchTimeQueue()
+  {
+  }
+
+  virtual ~IasTestAvbLaunchTimeQueue() {}
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    srand(4711u);
+  }
+
+  virtual void TearDown()
+  {
+  }
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbLaunchTimeQueue, basicOperations)
+{
+  IasAvbLaunchTimeQueue<Entry> seq;
+  ASSERT_TRUE(seq.empty());
+  ASSERT_EQ(0u, seq.size());
+
+  const uint64_t times[] = { 50u, 10u, 40u, 20u, 30u };
+  for (uint32_t i = 0u; i < 5u; i++)
+  {
+    Entry e = { i, true, times[i], eNotDone };
+    seq.push(e);
+  }
+  ASSERT_EQ(5u, seq.size());
+  ASSERT_EQ(5u, seq.readyCount());
+  ASSERT_EQ(10u, seq.top().launchTime);
+
+  // top stays in front
+  seq.top().launchTime = 15u;
+  ASSERT_FALSE(seq.updateTop());
+  ASSERT_EQ(15u, seq.top().launchTime);
+
+  // top moves behind others
+  seq.top().launchTime = 45u;
+  ASSERT_TRUE(seq.updateTop());
+  ASSERT_EQ(20u, seq.top().launchTime);
+
+  // park entries one by one, they must come out in ascending order
+  uint64_t last = 0u;
+  while (!seq.empty())
+  {
+    ASSERT_LE(last, seq.top().launchTime);
+    last = seq.top().launchTime;
+    seq.parkTop();
+  }
+  ASSERT_EQ(50u, last);
+  ASSERT_EQ(5u, seq.size());
+
+  seq.rearm();
+  ASSERT_EQ(5u, seq.readyCount());
+  ASSERT_EQ(20u, seq.top().launchTime);
+
+  // erase the earliest entry by storage index
+  for (size_t idx = 0u; idx < seq.size(); idx++)
+  {
+    if (20u == seq[idx].launchTime)
+    {
+      seq.erase(idx);
+      break;
+    }
+  }
+  ASSERT_EQ(4u, seq.size());
+  ASSERT_EQ(30u, seq.top().launchTime);
+
+  seq.clear();
+  ASSERT_TRUE(seq.empty());
+  ASSERT_EQ(0u, seq.size());
+}
+
+TEST_F(IasTestAvbLaunchTimeQueue, orderingMatchesListSequencer)
+{
+  const uint32_t streamCounts[] = { 1u, 2u, 8u, 40u, 64u };
+  const uint32_t cWindows = 200u;
+
+  for (uint32_t c = 0u; c < (sizeof streamCounts / sizeof streamCounts[0]); c++)
+  {
+    std::vector<SimStream> listStreams;
+    createStreams(listStreams, streamCounts[c]);
+    std::vector<SimStream> heapStreams = listStreams;
+
+    SentList listSent;
+    SentList heapSent;
+    runList(listStreams, cWindows, &listSent);
+    runHeap(heapStreams, cWindows, &heapSent);
+
+    ASSERT_EQ(listSent.size(), heapSent.size()) << "streams: " << streamCounts[c];
+    ASSERT_LT(0u, heapSent.size());
+
+    // the heap has to send packets in strict launch time order
+    for (size_t i = 1u; i < heapSent.size(); i++)
+    {
+      ASSERT_FALSE(heapSent[i] < heapSent[i - 1u]) << "streams: " << streamCounts[c] << " packet: " << i;
+    }
+
+    // within each window, the list based sequencer sends the same packets, though not necessarily in strict order
+    std::stable_sort(listSent.begin(), listSent.end());
+    for (size_t i = 0u; i < heapSent.size(); i++)
+    {
+      ASSERT_EQ(listSent[i].window, heapSent[i].window) << "streams: " << streamCounts[c] << " packet: " << i;
+      ASSERT_EQ(listSent[i].launchTime, heapSent[i].launchTime) << "streams: " << streamCounts[c] << " packet: " << i;
+      ASSERT_EQ(listSent[i].stream, heapSent[i].stream) << "streams: " << streamCounts[c] << " packet: " << i;
+    }
+  }
+}
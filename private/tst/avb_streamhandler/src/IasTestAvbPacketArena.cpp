@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbPacketArena.cpp
+ * @brief   The implementation of the IasTestAvbPacketArena test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbPacketArena.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#undef protected
+#undef private
+
+#include <cstring>
+#include <vector>
+
+using namespace IasMediaTransportAvb;
+
+extern size_t heapSpaceLeft;
+extern size_t heapSpaceInitSize;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbPacketArena : public ::testing::Test
+{
+protected:
+  IasTestAvbPacketArena()
+    : mEnvironment(NULL)
+    , mArena(NULL)
+  {
+    DLT_REGISTER_APP("IAPA", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbPacketArena()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    heapSpaceLeft = heapSpaceInitSize;
+
+    dlt_enable_local_print();
+    mEnvironment = new IasAvbStreamHandlerEnvironment(DLT_LOG_INFO);
+    ASSERT_TRUE(NULL != mEnvironment);
+    mEnvironment->registerDltContexts();
+    mEnvironment->setDefaultConfigValues();
+    // chunks are allocated in plain memory then, no igb device needed
+    mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "socket");
+
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbPacketArena",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mArena = new IasAvbPacketArena(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mArena;
+    mArena = NULL;
+
+    if (NULL != mEnvironment)
+    {
+      mEnvironment->unregisterDltContexts();
+      delete mEnvironment;
+      mEnvironment = NULL;
+    }
+
+    heapSpaceLeft = heapSpaceInitSize;
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  IasAvbStreamHandlerEnvironment * mEnvironment;
+  IasAvbPacketArena * mArena;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbPacketArena, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mArena);
+}
+
+TEST_F(IasTestAvbPacketArena, init)
+{
+  ASSERT_TRUE(NULL != mArena);
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mArena->init(0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mArena->init(IasAvbPacketArena::cMaxChunks * IasAvbPacketArena::cChunkSize + 1u));
+  ASSERT_EQ(eIasAvbProcOK, mArena->init(1000u));
+  ASSERT_EQ(16u, mArena->mMaxChunks);
+
+  // nothing is allocated up front
+  for (uint32_t cl = 0u; cl < IasAvbPacketArena::cNumClasses; cl++)
+  {
+    ASSERT_EQ(0u, mArena->getAllocated(cl));
+  }
+}
+
+TEST_F(IasTestAvbPacketArena, getClassIndex)
+{
+  ASSERT_EQ(0u, IasAvbPacketArena::getClassIndex(1u));
+  ASSERT_EQ(0u, IasAvbPacketArena::getClassIndex(128u));
+  ASSERT_EQ(1u, IasAvbPacketArena::getClassIndex(129u));
+  ASSERT_EQ(3u, IasAvbPacketArena::getClassIndex(1000u));
+  ASSERT_EQ(4u, IasAvbPacketArena::getClassIndex(1536u));
+  ASSERT_EQ(uint32_t(IasAvbPacketArena::cNumClasses), IasAvbPacketArena::getClassIndex(1537u));
+  ASSERT_EQ(size_t(512u), IasAvbPacketArena::getClassSize(2u));
+  ASSERT_EQ(size_t(0u), IasAvbPacketArena::getClassSize(IasAvbPacketArena::cNumClasses));
+}
+
+TEST_F(IasTestAvbPacketArena, leaseGrowsOnDemand)
+{
+  ASSERT_TRUE(NULL != mArena);
+  ASSERT_EQ(eIasAvbProcOK, mArena->init(2u * IasAvbPacketArena::cChunkSize));
+
+  ASSERT_TRUE(NULL == mArena->lease(0u));
+  ASSERT_TRUE(NULL == mArena->lease(2000u));
+
+  std::vector<IasAvbPacket*> packets;
+  IasAvbPacket * packet = mArena->lease(100u);
+  ASSERT_TRUE(NULL != packet);
+  packets.push_back(packet);
+  ASSERT_EQ(uint32_t(IasAvbPacketArena::cChunkSize), mArena->getAllocated(0u));
+  ASSERT_EQ(0u, mArena->getAllocated(1u));
+
+  while (NULL != (packet = mArena->lease(100u)))
+  {
+    packets.push_back(packet);
+  }
+
+  // limited by the configured maximum
+  ASSERT_EQ(size_t(2u * IasAvbPacketArena::cChunkSize), packets.size());
+  ASSERT_EQ(2u * IasAvbPacketArena::cChunkSize, mArena->getAllocated(0u));
+  ASSERT_EQ(2u * IasAvbPacketArena::cChunkSize, mArena->getInUse(0u));
+  ASSERT_EQ(2u * IasAvbPacketArena::cChunkSize, mArena->getHighWaterMark(0u));
+
+  for (size_t idx = 0u; idx < packets.size(); idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packets[idx]));
+    mArena->release(100u);
+  }
+
+  // memory is kept, the high water mark tells how much was needed
+  ASSERT_EQ(0u, mArena->getInUse(0u));
+  ASSERT_EQ(2u * IasAvbPacketArena::cChunkSize, mArena->getHighWaterMark(0u));
+  ASSERT_EQ(2u * IasAvbPacketArena::cChunkSize, mArena->getAllocated(0u));
+
+  mArena->logStatistics();
+}
+
+TEST_F(IasTestAvbPacketArena, sharedPools)
+{
+  ASSERT_TRUE(NULL != mArena);
+  ASSERT_EQ(eIasAvbProcOK, mArena->init(256u));
+
+  IasAvbPacketPool poolA(mDltCtx);
+  IasAvbPacketPool poolB(mDltCtx);
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, poolA.initShared(NULL, 300u, 4u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, poolA.initShared(mArena, 2000u, 4u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, poolA.initShared(mArena, 300u, 0u));
+
+  ASSERT_EQ(eIasAvbProcOK, poolA.initShared(mArena, 300u, 4u));
+  ASSERT_EQ(eIasAvbProcOK, poolB.initShared(mArena, 400u, 8u));
+  ASSERT_EQ(eIasAvbProcInitializationFailed, poolA.init(300u, 4u));
+  ASSERT_TRUE(poolA.isShared());
+  ASSERT_EQ(4u, poolA.getPoolSize());
+  ASSERT_EQ(0u, mArena->getAllocated(2u));
+
+  std::vector<IasAvbPacket*> packetsA;
+  std::vector<IasAvbPacket*> packetsB;
+  IasAvbPacket * packet = NULL;
+
+  while (NULL != (packet = poolA.getPacket()))
+  {
+    ASSERT_EQ(poolA.mLessee, packet->mLessee);
+    packetsA.push_back(packet);
+  }
+  while (NULL != (packet = poolB.getDummyPacket()))
+  {
+    ASSERT_TRUE(packet->isDummyPacket());
+    packetsB.push_back(packet);
+  }
+
+  // each pool is limited by its quota, both share the 512 byte class
+  ASSERT_EQ(size_t(4u), packetsA.size());
+  ASSERT_EQ(size_t(8u), packetsB.size());
+  ASSERT_EQ(0u, poolA.getFreeCount());
+  ASSERT_EQ(12u, mArena->getInUse(2u));
+  ASSERT_EQ(uint32_t(IasAvbPacketArena::cChunkSize), mArena->getAllocated(2u));
+
+  // reset cannot take back leased packets
+  ASSERT_EQ(eIasAvbProcOK, poolA.reset());
+  ASSERT_EQ(0u, poolA.getFreeCount());
+
+  for (size_t idx = 0u; idx < packetsA.size(); idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packetsA[idx]));
+    ASSERT_TRUE(NULL == packetsA[idx]->mLessee);
+  }
+  for (size_t idx = 0u; idx < packetsB.size(); idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packetsB[idx]));
+    ASSERT_FALSE(packetsB[idx]->isDummyPacket());
+  }
+
+  ASSERT_EQ(4u, poolA.getFreeCount());
+  ASSERT_EQ(8u, poolB.getFreeCount());
+  ASSERT_EQ(0u, mArena->getInUse(2u));
+  ASSERT_EQ(12u, mArena->getHighWaterMark(2u));
+}
+
+TEST_F(IasTestAvbPacketArena, cleanupInFlight)
+{
+  ASSERT_TRUE(NULL != mArena);
+  ASSERT_EQ(eIasAvbProcOK, mArena->init(64u));
+
+  IasAvbPacketPool * pool = new IasAvbPacketPool(mDltCtx);
+  ASSERT_EQ(eIasAvbProcOK, pool->initShared(mArena, 200u, 2u));
+  IasAvbPacketLessee * lessee = pool->mLessee;
+  ASSERT_TRUE(NULL != lessee);
+
+  IasAvbPacket * packet = pool->getPacket();
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(1u, lessee->available.load());
+
+  // the stream goes away while its packet is still in flight
+  delete pool;
+  ASSERT_FALSE(lessee->attached);
+  ASSERT_EQ(1u, mArena->getInUse(1u));
+
+  // the handle is busy until the packet is back
+  IasAvbPacketPool other(mDltCtx);
+  ASSERT_EQ(eIasAvbProcOK, other.initShared(mArena, 200u, 2u));
+  ASSERT_TRUE(lessee != other.mLessee);
+  other.cleanup();
+
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+  ASSERT_TRUE(NULL == packet->mLessee);
+  ASSERT_EQ(0u, mArena->getInUse(1u));
+  ASSERT_EQ(2u, lessee->available.load());
+
+  // a new stream reuses a detached handle once all of its packets are back
+  IasAvbPacketPool next(mDltCtx);
+  ASSERT_EQ(eIasAvbProcOK, next.initShared(mArena, 300u, 4u));
+  ASSERT_EQ(lessee, next.mLessee);
+  ASSERT_EQ(4u, next.getFreeCount());
+}
+
+TEST_F(IasTestAvbPacketArena, template)
+{
+  ASSERT_TRUE(NULL != mArena);
+  ASSERT_EQ(eIasAvbProcOK, mArena->init(64u));
+
+  IasAvbPacketPool pool(mDltCtx);
+  ASSERT_EQ(eIasAvbProcNotInitialized, pool.initAllPacketsFromTemplate(NULL));
+  ASSERT_EQ(eIasAvbProcOK, pool.initShared(mArena, 200u, 2u));
+
+  IasAvbPacket * reference = pool.getPacket();
+  ASSERT_TRUE(NULL != reference);
+  ASSERT_EQ(eIasAvbProcInvalidParam, pool.initAllPacketsFromTemplate(NULL));
+
+  uint8_t * data = static_cast<uint8_t*>(reference->getBasePtr());
+  for (uint32_t idx = 0u; idx < 24u; idx++)
+  {
+    data[idx] = uint8_t(idx + 1u);
+  }
+  reference->len = 24u;
+  reference->attime = 0u;
+  reference->setPayloadOffset(24u);
+  ASSERT_EQ(eIasAvbProcOK, pool.initAllPacketsFromTemplate(reference));
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(reference));
+
+  // scribble over the packet memory, the next lease has to get the header again
+  IasAvbPacket * packet = pool.getPacket();
+  ASSERT_TRUE(NULL != packet);
+  std::memset(packet->getBasePtr(), 0xAA, 200u);
+  packet->len = 200u;
+  packet->setPayloadOffset(0u);
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+
+  packet = pool.getPacket();
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(24u, packet->len);
+  ASSERT_EQ(size_t(24u), packet->getPayloadOffset());
+  ASSERT_EQ(0, std::memcmp(packet->getBasePtr(), pool.mTemplate.vaddr, 24u));
+  ASSERT_EQ(uint8_t(24u), static_cast<uint8_t*>(packet->getBasePtr())[23]);
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+}
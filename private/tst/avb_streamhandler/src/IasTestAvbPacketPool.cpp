@@ -18,6 +18,10 @@
 
 #include "test_common/IasSpringVilleInfo.hpp"
 
+#include <thread>
+#include <vector>
+#include <algorithm>
+
 extern size_t heapSpaceLeft;
 extern size_t heapSpaceInitSize;
 
@@ -103,6 +107,24 @@ protected:
     return false;
   }
 
+  // each thread repeatedly takes a handful of packets and returns them, like the TX path does
+  static void contend(IasAvbPacketPool * pool, uint32_t rounds)
+  {
+    IasAvbPacket * held[8];
+    for (uint32_t r = 0u; r < rounds; r++)
+    {
+      uint32_t count = 0u;
+      while ((count < 8u) && (NULL != (held[count] = pool->getPacket())))
+      {
+        count++;
+      }
+      for (uint32_t i = 0u; i < count; i++)
+      {
+        pool->returnPacket(held[i]);
+      }
+    }
+  }
+
   IasAvbStreamHandlerEnvironment * mEnvironment;
   IasAvbPacketPool* mAvbPacketPool;
   DltContext mDltCtx;
@@ -144,7 +166,9 @@ TEST_F(IasTestAvbPacketPool, getPacket)
 
   // already initialized
   ASSERT_EQ(eIasAvbProcInitializationFailed, mAvbPacketPool->init(packetSize, poolSize));
-  mAvbPacketPool->mFreeBufferStack.clear();
+  // empty the free list
+  mAvbPacketPool->mFreeHead.store(IasAvbPacketPool::cEndOfList);
+  mAvbPacketPool->mFreeCount.store(0u);
 
   ASSERT_TRUE(NULL == mAvbPacketPool->getPacket());
 }
@@ -295,17 +319,41 @@ TEST_F(IasTestAvbPacketPool, DoReturnPacket)
   IasAvbPacket *p = mAvbPacketPool->getPacket();
   ASSERT_TRUE(NULL != p);
 
-  // healthy return
+  // packet not taken from the pool
   result = mAvbPacketPool->returnPacket(&packet);
-  ASSERT_EQ(eIasAvbProcOK, result);
+  ASSERT_EQ(eIasAvbProcInvalidParam, result);
 
-  // return once too many - warning message issued
-  result = mAvbPacketPool->returnPacket(&packet);
+  // healthy return
+  result = mAvbPacketPool->returnPacket(p);
   ASSERT_EQ(eIasAvbProcOK, result);
+  ASSERT_EQ(poolSize, mAvbPacketPool->getFreeCount());
 
-  // return twice too many - ignored silently
-  result = mAvbPacketPool->returnPacket(&packet);
-  ASSERT_EQ(eIasAvbProcOK, result);
+  // return once too many - error message issued, packet is not put on the free list again
+  result = mAvbPacketPool->returnPacket(p);
+  ASSERT_EQ(eIasAvbProcInvalidParam, result);
+  ASSERT_EQ(poolSize, mAvbPacketPool->getFreeCount());
+
+  // return twice too many - rejected again
+  result = mAvbPacketPool->returnPacket(p);
+  ASSERT_EQ(eIasAvbProcInvalidParam, result);
+  ASSERT_EQ(poolSize, mAvbPacketPool->getFreeCount());
+
+  // double return while other packets are out, the free count alone would not catch this
+  IasAvbPacket *p1 = mAvbPacketPool->getPacket();
+  IasAvbPacket *p2 = mAvbPacketPool->getPacket();
+  ASSERT_TRUE((NULL != p1) && (NULL != p2));
+  ASSERT_EQ(eIasAvbProcOK, mAvbPacketPool->returnPacket(p1));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAvbPacketPool->returnPacket(p1));
+  ASSERT_EQ(poolSize - 1u, mAvbPacketPool->getFreeCount());
+  ASSERT_EQ(eIasAvbProcOK, mAvbPacketPool->returnPacket(p2));
+
+  // the free list is still consistent
+  for (uint32_t i = 0u; i < poolSize; i++)
+  {
+    ASSERT_TRUE(NULL != mAvbPacketPool->getPacket());
+  }
+  ASSERT_TRUE(NULL == mAvbPacketPool->getPacket());
+  ASSERT_EQ(0u, mAvbPacketPool->getFreeCount());
 }
 
 TEST_F(IasTestAvbPacketPool, InitAllPacketsFromTemplate)
@@ -369,4 +417,45 @@ TEST_F(IasTestAvbPacketPool, Reset)
   ASSERT_EQ(eIasAvbProcNotInitialized, mAvbPacketPool->reset());
 }
 
+TEST_F(IasTestAvbPacketPool, concurrentGetReturn)
+{
+  ASSERT_TRUE(NULL != mAvbPacketPool);
+
+  // the socket backend uses plain memory, so no igb device is needed
+  mEnvironment->setDefaultConfigValues();
+  mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "socket");
+
+  const uint32_t poolSize = 256u;
+  const uint32_t cThreads = 4u;
+  const uint32_t cRounds = 20000u;
+  ASSERT_EQ(eIasAvbProcOK, mAvbPacketPool->init(1024u, poolSize));
+
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0u; t < cThreads; t++)
+  {
+    workers.push_back(std::thread(contend, mAvbPacketPool, cRounds));
+  }
+  for (uint32_t t = 0u; t < cThreads; t++)
+  {
+    workers[t].join();
+  }
+
+  // all packets are back and the free list holds each of them exactly once
+  ASSERT_EQ(poolSize, mAvbPacketPool->getFreeCount());
+  std::vector<IasAvbPacket*> packets;
+  IasAvbPacket * packet = NULL;
+  while (NULL != (packet = mAvbPacketPool->getPacket()))
+  {
+    packets.push_back(packet);
+  }
+  ASSERT_EQ(poolSize, uint32_t(packets.size()));
+  std::sort(packets.begin(), packets.end());
+  ASSERT_TRUE(std::unique(packets.begin(), packets.end()) == packets.end());
+
+  for (size_t i = 0u; i < packets.size(); i++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packets[i]));
+  }
+}
+
 } /* IasMediaTransportAvb */
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbPcapFile.cpp
+ * @brief   The implementation of the IasTestAvbPcapFile test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbPcapFile.hpp"
+#undef protected
+#undef private
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbPcapFile : public ::testing::Test
+{
+protected:
+  IasTestAvbPcapFile()
+    : mFile(NULL)
+    , mFileName()
+  {
+  }
+
+  virtual ~IasTestAvbPcapFile()
+  {
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    char name[] = "/tmp/IasTestAvbPcapFileXXXXXX";
+    int32_t fd = mkstemp(name);
+    if (fd >= 0)
+    {
+      (void) close(fd);
+      mFileName = name;
+    }
+    mFile = new IasAvbPcapFile();
+  }
+
+  virtual void TearDown()
+  {
+    delete mFile;
+    mFile = NULL;
+
+    if (!mFileName.empty())
+    {
+      (void) unlink(mFileName.c_str());
+    }
+  }
+
+  // overwrites the file with raw data
+  void writeRaw(const void * data, size_t length)
+  {
+    FILE * file = fopen(mFileName.c_str(), "wb");
+    ASSERT_TRUE(NULL != file);
+    ASSERT_EQ(length, fwrite(data, 1u, length, file));
+    (void) fclose(file);
+  }
+
+  IasAvbPcapFile * mFile;
+  std::string mFileName;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbPcapFile, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mFile);
+  ASSERT_FALSE(mFile->isOpen());
+  ASSERT_EQ(0u, mFile->getFrameCount());
+}
+
+TEST_F(IasTestAvbPcapFile, NotOpen)
+{
+  uint8_t frame[64] = {0};
+  uint32_t length = 0u;
+  uint64_t time = 0u;
+
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFile->writeFrame(frame, sizeof frame, 0u));
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFile->readFrame(frame, sizeof frame, length, time));
+  ASSERT_EQ(eIasAvbProcErr, mFile->openRead("/nonexistent/file.pcap"));
+  ASSERT_EQ(eIasAvbProcErr, mFile->openWrite("/nonexistent/file.pcap"));
+  ASSERT_FALSE(mFile->isOpen());
+}
+
+TEST_F(IasTestAvbPcapFile, WriteRead)
+{
+  ASSERT_FALSE(mFileName.empty());
+
+  uint8_t frame[128];
+  for (uint32_t idx = 0u; idx < sizeof frame; idx++)
+  {
+    frame[idx] = uint8_t(idx);
+  }
+
+  ASSERT_EQ(eIasAvbProcOK, mFile->openWrite(mFileName));
+  ASSERT_TRUE(mFile->isOpen());
+  ASSERT_EQ(eIasAvbProcInvalidParam, mFile->writeFrame(NULL, 64u, 0u));
+  ASSERT_EQ(eIasAvbProcOK, mFile->writeFrame(frame, 64u, 1000000001u));
+  ASSERT_EQ(eIasAvbProcOK, mFile->writeFrame(frame, 128u, 5123456789u));
+  ASSERT_EQ(eIasAvbProcOK, mFile->writeFrame(frame, 0u, 5123456790u));
+  ASSERT_EQ(3u, mFile->getFrameCount());
+  // not readable while writing
+  uint8_t buffer[128];
+  uint32_t length = 0u;
+  uint64_t time = 0u;
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFile->readFrame(buffer, sizeof buffer, length, time));
+  mFile->close();
+  ASSERT_FALSE(mFile->isOpen());
+
+  ASSERT_EQ(eIasAvbProcOK, mFile->openRead(mFileName));
+  ASSERT_TRUE(mFile->isOpen());
+  ASSERT_TRUE(mFile->mNanoseconds);
+  ASSERT_FALSE(mFile->mSwapped);
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFile->writeFrame(frame, 64u, 0u));
+
+  ASSERT_EQ(eIasAvbProcOK, mFile->readFrame(buffer, sizeof buffer, length, time));
+  ASSERT_EQ(64u, length);
+  ASSERT_EQ(1000000001u, time);
+  ASSERT_EQ(0, memcmp(frame, buffer, length));
+
+  // truncated to the buffer size, the next frame is still found
+  ASSERT_EQ(eIasAvbProcOK, mFile->readFrame(buffer, 32u, length, time));
+  ASSERT_EQ(32u, length);
+  ASSERT_EQ(5123456789u, time);
+  ASSERT_EQ(0, memcmp(frame, buffer, length));
+
+  ASSERT_EQ(eIasAvbProcOK, mFile->readFrame(buffer, sizeof buffer, length, time));
+  ASSERT_EQ(0u, length);
+  ASSERT_EQ(5123456790u, time);
+
+  ASSERT_EQ(eIasAvbProcOff, mFile->readFrame(buffer, sizeof buffer, length, time));
+  ASSERT_EQ(3u, mFile->getFrameCount());
+  ASSERT_EQ(eIasAvbProcInvalidParam, mFile->readFrame(NULL, sizeof buffer, length, time));
+}
+
+TEST_F(IasTestAvbPcapFile, Formats)
+{
+  ASSERT_FALSE(mFileName.empty());
+
+  // microsecond file written on a big endian host
+  const uint8_t swappedMicro[] = {
+    0xA1, 0xB2, 0xC3, 0xD4, 0x00, 0x02, 0x00, 0x04,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01,
+    // 2 s 500 us, 4 bytes
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x01, 0xF4,
+    0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04,
+    0xDE, 0xAD, 0xBE, 0xEF,
+    // truncated record header
+    0x00, 0x00
+  };
+  writeRaw(swappedMicro, sizeof swappedMicro);
+
+  uint8_t buffer[16];
+  uint32_t length = 0u;
+  uint64_t time = 0u;
+  ASSERT_EQ(eIasAvbProcOK, mFile->openRead(mFileName));
+  ASSERT_TRUE(mFile->mSwapped);
+  ASSERT_FALSE(mFile->mNanoseconds);
+  ASSERT_EQ(eIasAvbProcOK, mFile->readFrame(buffer, sizeof buffer, length, time));
+  ASSERT_EQ(4u, length);
+  ASSERT_EQ(2000500000u, time);
+  ASSERT_EQ(0xDE, buffer[0]);
+  ASSERT_EQ(0xEF, buffer[3]);
+  ASSERT_EQ(eIasAvbProcErr, mFile->readFrame(buffer, sizeof buffer, length, time));
+
+  // not Ethernet
+  uint8_t otherLink[sizeof swappedMicro];
+  memcpy(otherLink, swappedMicro, sizeof otherLink);
+  otherLink[23] = 105u;
+  writeRaw(otherLink, sizeof otherLink);
+  ASSERT_EQ(eIasAvbProcUnsupportedFormat, mFile->openRead(mFileName));
+  ASSERT_FALSE(mFile->isOpen());
+
+  // pcapng section header block
+  const uint8_t pcapng[] = {
+    0x0A, 0x0D, 0x0D, 0x0A, 0x1C, 0x00, 0x00, 0x00,
+    0x4D, 0x3C, 0x2B, 0x1A, 0x01, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x1C, 0x00, 0x00, 0x00
+  };
+  writeRaw(pcapng, sizeof pcapng);
+  ASSERT_EQ(eIasAvbProcUnsupportedFormat, mFile->openRead(mFileName));
+
+  // too short for a file header
+  writeRaw(pcapng, 8u);
+  ASSERT_EQ(eIasAvbProcUnsupportedFormat, mFile->openRead(mFileName));
+  ASSERT_FALSE(mFile->isOpen());
+}
@@ -20,6 +20,7 @@
 #include "avb_streamhandler/IasAvbVideoStream.hpp"
 #include "avb_streamhandler/IasAvbClockReferenceStream.hpp"
 #include "avb_streamhandler/IasAvbAudioStream.hpp"
+#include "avb_streamhandler/IasAvbPcapFile.hpp"
 #undef protected
 #undef private
 
@@ -345,13 +346,18 @@ TEST_F(IasTestAvbReceiveEngine, Init)
   // HEAP testing
   heapSpaceLeft = sizeof(IasThread);
   result = mAvbReceiveEngine->init();
+  ASSERT_EQ(eIasAvbProcInitializationFailed, result); // no memory for the worker
+
+  // HEAP testing
+  heapSpaceLeft = sizeof(IasThread) + sizeof(IasAvbReceiveEngine::Worker);
+  result = mAvbReceiveEngine->init();
 #if defined(DIRECT_RX_DMA)
   ASSERT_EQ(eIasAvbProcOK, result); // init() will return OK since receive buffer will not be allocated from heap
 #else
   ASSERT_EQ(eIasAvbProcInitializationFailed, result);
 
   // HEAP testing
-  heapSpaceLeft = sizeof(IasThread) + sizeof(uint8_t) * ETH_FRAME_LEN + 4u;//IasAvbReceiveEngine::cReceiveBufferSize;
+  heapSpaceLeft = sizeof(IasThread) + sizeof(IasAvbReceiveEngine::Worker) + sizeof(uint8_t) * ETH_FRAME_LEN + 4u;//IasAvbReceiveEngine::cReceiveBufferSize;
   result = mAvbReceiveEngine->init();
   ASSERT_EQ(eIasAvbProcOK, result);
 #endif
@@ -701,6 +707,578 @@ TEST_F(IasTestAvbReceiveEngine, DestroyAvbStream)
   ASSERT_EQ(eIasAvbProcOK, result);
 }
 
+TEST_F(IasTestAvbReceiveEngine, StreamTable)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalSetup());
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+  ASSERT_TRUE(NULL == mAvbReceiveEngine->mStreamTable.load());
+
+  IasAvbStreamId streamId1(uint64_t(0x0123456789ABCDEFu));
+  IasAvbStreamId streamId2(uint64_t(2u));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(streamId1));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(streamId2));
+
+  // every change publishes a new table, the receive thread isn't running so nothing waits
+  IasAvbRxStreamTable * table = mAvbReceiveEngine->mStreamTable.load();
+  ASSERT_TRUE(NULL != table);
+  ASSERT_EQ(2u, table->getSize());
+  ASSERT_TRUE(NULL != table->find(uint64_t(streamId1)));
+  ASSERT_EQ(mAvbReceiveEngine->getStreamById(streamId2), table->find(uint64_t(streamId2))->stream);
+  ASSERT_EQ(0u, mAvbReceiveEngine->mWorkers[0]->mReadSeq.load() & 1u);
+
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->destroyAvbStream(streamId1));
+  table = mAvbReceiveEngine->mStreamTable.load();
+  ASSERT_EQ(1u, table->getSize());
+  ASSERT_TRUE(NULL == table->find(uint64_t(streamId1)));
+
+  // wildcard stream is re-keyed in both the stream list and the table
+  IasAvbStreamId wildcardId(uint64_t(0u));
+  IasAvbStreamId streamId3(uint64_t(3u));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(wildcardId));
+  table = mAvbReceiveEngine->beginRead(*mAvbReceiveEngine->mWorkers[0]);
+  ASSERT_TRUE(NULL != table->find(uint64_t(wildcardId)));
+  mAvbReceiveEngine->promoteWildcardStream(*mAvbReceiveEngine->mWorkers[0], table, wildcardId, streamId3);
+  mAvbReceiveEngine->endRead(*mAvbReceiveEngine->mWorkers[0]);
+  ASSERT_EQ(mAvbReceiveEngine->mStreamTable.load(), table);
+  ASSERT_TRUE(NULL == table->find(uint64_t(wildcardId)));
+  ASSERT_TRUE(NULL != table->find(uint64_t(streamId3)));
+  ASSERT_TRUE(mAvbReceiveEngine->isValidStreamId(streamId3));
+  ASSERT_FALSE(mAvbReceiveEngine->isValidStreamId(wildcardId));
+
+  mAvbReceiveEngine->cleanup();
+  ASSERT_TRUE(NULL == mAvbReceiveEngine->mStreamTable.load());
+}
+
+TEST_F(IasTestAvbReceiveEngine, ReceiveWorkers)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalHostSetup());
+
+  mEnvironment->setConfigValue(IasRegKeys::cRxWorkers, 0u);
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mAvbReceiveEngine->init());
+
+  const uint32_t cNumWorkers = 3u;
+  mEnvironment->setConfigValue(IasRegKeys::cRxWorkers, cNumWorkers);
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+
+#if defined(DIRECT_RX_DMA)
+  // single receive queue
+  ASSERT_EQ(1u, mAvbReceiveEngine->mWorkers.size());
+  ASSERT_EQ(0u, mAvbReceiveEngine->getShard(0x0123456789ABCDEFu));
+#else
+  ASSERT_EQ(cNumWorkers, mAvbReceiveEngine->mWorkers.size());
+  ASSERT_EQ(mAvbReceiveEngine->mReceiveSocket, mAvbReceiveEngine->mWorkers[0]->mSocket);
+  ASSERT_TRUE(NULL == mAvbReceiveEngine->mWorkers[0]->mThread);
+  for (uint32_t idx = 1u; idx < cNumWorkers; idx++)
+  {
+    ASSERT_TRUE(NULL != mAvbReceiveEngine->mWorkers[idx]->mThread);
+    ASSERT_LE(0, mAvbReceiveEngine->mWorkers[idx]->mSocket);
+    ASSERT_NE(mAvbReceiveEngine->mReceiveSocket, mAvbReceiveEngine->mWorkers[idx]->mSocket);
+  }
+
+  // the kernel hands each packet to the worker owning its stream ID
+  for (uint32_t idx = 0u; idx < cNumWorkers; idx++)
+  {
+    // no streams created, pass all packets
+    ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(mAvbReceiveEngine->mWorkers[idx]->mSocket));
+  }
+  int32_t txSocket = socket(PF_PACKET, SOCK_RAW, 0);
+  ASSERT_LE(0, txSocket);
+  mSocketFdList.push_back(txSocket);
+  struct sockaddr_ll dest;
+  memset(&dest, 0, sizeof dest);
+  dest.sll_family = AF_PACKET;
+  dest.sll_ifindex = mAvbReceiveEngine->mRcvPortIfIndex;
+  dest.sll_halen = ETH_ALEN;
+
+  for (uint64_t idx = 0u; idx < 30u; idx++)
+  {
+    const uint64_t streamId = 0x91E0F000FE000000u + (idx << 40) + idx;
+    uint8_t frame[64];
+    memset(frame, 0, sizeof frame);
+    memset(frame, 0xFF, ETH_ALEN);
+    frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+    frame[13] = uint8_t(ETH_P_IEEE1722);
+    frame[15] = 0x80; // sv
+    for (uint32_t byte = 0u; byte < 8u; byte++)
+    {
+      frame[18u + byte] = uint8_t(streamId >> (56u - (8u * byte)));
+    }
+    ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+    usleep(1000);
+
+    uint32_t received = 0u;
+    for (uint32_t worker = 0u; worker < cNumWorkers; worker++)
+    {
+      uint8_t buffer[128];
+      while (0 < recv(mAvbReceiveEngine->mWorkers[worker]->mSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+      {
+        ASSERT_EQ(mAvbReceiveEngine->getShard(streamId), worker);
+        received++;
+      }
+    }
+    ASSERT_EQ(1u, received);
+  }
+#endif
+
+  mAvbReceiveEngine->cleanup();
+  ASSERT_TRUE(mAvbReceiveEngine->mWorkers.empty());
+}
+
+TEST_F(IasTestAvbReceiveEngine, ReceiveWorkersWildcard)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalHostSetup());
+
+  const uint32_t cNumWorkers = 3u;
+  mEnvironment->setConfigValue(IasRegKeys::cRxWorkers, cNumWorkers);
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+
+#if !defined(DIRECT_RX_DMA)
+  ASSERT_EQ(cNumWorkers, mAvbReceiveEngine->mNumShards.load());
+
+  // while a wildcard stream exists, packets of unknown streams must all reach the worker handling it
+  IasAvbStreamId wildcardId(uint64_t(0u));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(wildcardId));
+  ASSERT_EQ(1u, mAvbReceiveEngine->mNumShards.load());
+
+  for (uint32_t idx = 0u; idx < cNumWorkers; idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(mAvbReceiveEngine->mWorkers[idx]->mSocket));
+  }
+  int32_t txSocket = socket(PF_PACKET, SOCK_RAW, 0);
+  ASSERT_LE(0, txSocket);
+  mSocketFdList.push_back(txSocket);
+  struct sockaddr_ll dest;
+  memset(&dest, 0, sizeof dest);
+  dest.sll_family = AF_PACKET;
+  dest.sll_ifindex = mAvbReceiveEngine->mRcvPortIfIndex;
+  dest.sll_halen = ETH_ALEN;
+
+  for (uint64_t idx = 0u; idx < 30u; idx++)
+  {
+    const uint64_t streamId = 0x91E0F000FE000000u + (idx << 40) + idx;
+    uint8_t frame[64];
+    memset(frame, 0, sizeof frame);
+    memset(frame, 0xFF, ETH_ALEN);
+    frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+    frame[13] = uint8_t(ETH_P_IEEE1722);
+    frame[15] = 0x80; // sv
+    for (uint32_t byte = 0u; byte < 8u; byte++)
+    {
+      frame[18u + byte] = uint8_t(streamId >> (56u - (8u * byte)));
+    }
+    ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+    usleep(1000);
+
+    uint32_t received = 0u;
+    for (uint32_t worker = 0u; worker < cNumWorkers; worker++)
+    {
+      uint8_t buffer[128];
+      while (0 < recv(mAvbReceiveEngine->mWorkers[worker]->mSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+      {
+        ASSERT_EQ(0u, worker);
+        ASSERT_EQ(0u, mAvbReceiveEngine->getShard(streamId));
+        received++;
+      }
+    }
+    ASSERT_EQ(1u, received);
+  }
+
+  // only worker 0 handles the wildcard
+  IasAvbReceiveEngine::FrameContext context;
+  uint32_t idleWait = 0u;
+  mAvbReceiveEngine->initFrameContext(*mAvbReceiveEngine->mWorkers[0], context, idleWait);
+  ASSERT_TRUE(context.handleWildcard);
+  mAvbReceiveEngine->initFrameContext(*mAvbReceiveEngine->mWorkers[1], context, idleWait);
+  ASSERT_FALSE(context.handleWildcard);
+
+  // promoting the wildcard stream spreads the packets again
+  IasAvbStreamId streamId(uint64_t(0x0123456789ABCDEFu));
+  IasAvbRxStreamTable * table = mAvbReceiveEngine->beginRead(*mAvbReceiveEngine->mWorkers[0]);
+  mAvbReceiveEngine->promoteWildcardStream(*mAvbReceiveEngine->mWorkers[0], table, wildcardId, streamId);
+  mAvbReceiveEngine->endRead(*mAvbReceiveEngine->mWorkers[0]);
+  ASSERT_EQ(cNumWorkers, mAvbReceiveEngine->mNumShards.load());
+
+  // and a new wildcard stream collects them once more, until it is destroyed
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(wildcardId));
+  ASSERT_EQ(1u, mAvbReceiveEngine->mNumShards.load());
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->destroyAvbStream(wildcardId));
+  ASSERT_EQ(cNumWorkers, mAvbReceiveEngine->mNumShards.load());
+#endif
+
+  mAvbReceiveEngine->cleanup();
+  ASSERT_EQ(1u, mAvbReceiveEngine->mNumShards.load());
+}
+
+TEST_F(IasTestAvbReceiveEngine, ReceiveWorkersHandover)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalHostSetup());
+
+  const uint32_t cNumWorkers = 3u;
+  mEnvironment->setConfigValue(IasRegKeys::cRxWorkers, cNumWorkers);
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+
+#if !defined(DIRECT_RX_DMA)
+  const uint64_t cTimeout = 25000000u;
+  uint64_t now = 1000000000u;
+  for (uint32_t idx = 0u; idx < cNumWorkers; idx++)
+  {
+    // the threads are not started, the test runs the workers' cycles
+    ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->mWorkers[idx]->mTimeoutWheel.init(IasAvbReceiveEngine::cTimeoutTick, now));
+  }
+  IasAvbReceiveEngine::Worker & worker0 = *mAvbReceiveEngine->mWorkers[0];
+
+  IasAvbStreamId streamId(uint64_t(0x0123456789ABCDEFu));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(streamId));
+  const uint32_t owner = mAvbReceiveEngine->getShard(uint64_t(streamId));
+  ASSERT_NE(0u, owner);
+  IasAvbReceiveEngine::Worker & previous = *mAvbReceiveEngine->mWorkers[owner];
+
+  // the stopped workers don't hold back the owner
+  IasAvbRxStreamTable * table = mAvbReceiveEngine->mStreamTable.load();
+  mAvbReceiveEngine->processTimeouts(previous, table, now, cTimeout);
+  ASSERT_TRUE(previous.mClaimed);
+  ASSERT_TRUE(IasAvbTimeoutWheel::isLinked(mAvbReceiveEngine->mAvbStreams[streamId]));
+  for (uint32_t idx = 0u; idx < cNumWorkers; idx++)
+  {
+    mAvbReceiveEngine->processTimeouts(*mAvbReceiveEngine->mWorkers[idx], table, now, cTimeout);
+  }
+
+  // a wildcard stream moves all streams to worker 0, but not before the previous owner has let go
+  IasAvbStreamId wildcardId(uint64_t(0u));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(wildcardId));
+  table = mAvbReceiveEngine->mStreamTable.load();
+  ASSERT_EQ(1u, table->getNumShards());
+  ASSERT_TRUE(IasAvbReceiveEngine::isOwner(worker0, table, uint64_t(streamId)));
+  ASSERT_FALSE(IasAvbReceiveEngine::isOwner(previous, table, uint64_t(streamId)));
+
+  now += IasAvbReceiveEngine::cTimeoutTick;
+  mAvbReceiveEngine->processTimeouts(worker0, table, now, cTimeout);
+  ASSERT_FALSE(worker0.mClaimed);
+  ASSERT_EQ(table->getShardGeneration(), worker0.mShardGeneration.load());
+  for (uint32_t idx = 1u; idx < cNumWorkers; idx++)
+  {
+    if (owner != idx)
+    {
+      mAvbReceiveEngine->processTimeouts(*mAvbReceiveEngine->mWorkers[idx], table, now, cTimeout);
+    }
+  }
+  mAvbReceiveEngine->processTimeouts(worker0, table, now, cTimeout);
+  ASSERT_FALSE(worker0.mClaimed);
+
+  mAvbReceiveEngine->processTimeouts(previous, table, now, cTimeout);
+  ASSERT_TRUE(mAvbReceiveEngine->isShardingSettled(table->getShardGeneration()));
+  mAvbReceiveEngine->processTimeouts(worker0, table, now, cTimeout);
+  ASSERT_TRUE(worker0.mClaimed);
+
+  // adding a stream doesn't change the distribution, the streams are kept right away
+  IasAvbStreamId otherId(uint64_t(0x0123456789ABCDEEu));
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(otherId));
+  const uint64_t shardGeneration = table->getShardGeneration();
+  table = mAvbReceiveEngine->mStreamTable.load();
+  ASSERT_EQ(shardGeneration, table->getShardGeneration());
+  mAvbReceiveEngine->processTimeouts(worker0, table, now, cTimeout);
+  ASSERT_TRUE(worker0.mClaimed);
+#endif
+
+  mAvbReceiveEngine->cleanup();
+}
+
+TEST_F(IasTestAvbReceiveEngine, ReceiveFilter)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalHostSetup());
+
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+
+#if !defined(DIRECT_RX_DMA)
+  int32_t txSocket = socket(PF_PACKET, SOCK_RAW, 0);
+  ASSERT_LE(0, txSocket);
+  mSocketFdList.push_back(txSocket);
+  struct sockaddr_ll dest;
+  memset(&dest, 0, sizeof dest);
+  dest.sll_family = AF_PACKET;
+  dest.sll_ifindex = mAvbReceiveEngine->mRcvPortIfIndex;
+  dest.sll_halen = ETH_ALEN;
+
+  const int32_t rxSocket = mAvbReceiveEngine->mReceiveSocket;
+  uint8_t buffer[128];
+  while (0 < recv(rxSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+  {
+  }
+
+  IasAvbMacAddress dmac = {0x91, 0xE0, 0xF0, 0x00, 0xFE, 0x01};
+  const uint64_t cStreamId = 0x0011223344550001u;
+  const uint64_t cOtherId = 0x0011223344550002u;
+  uint32_t received = 0u;
+
+  for (uint32_t step = 0u; step < 4u; step++)
+  {
+    if (1u == step)
+    {
+      ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(IasAvbStreamId(cStreamId)));
+    }
+    else if (2u == step)
+    {
+      // wildcard stream matched by destination MAC
+      ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(IasAvbStreamId(uint64_t(0u)), &dmac));
+    }
+    else if (3u == step)
+    {
+      ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->destroyAvbStream(IasAvbStreamId(cStreamId)));
+      ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->destroyAvbStream(IasAvbStreamId(uint64_t(0u))));
+    }
+
+    for (uint32_t id = 0u; id < 2u; id++)
+    {
+      const uint64_t streamId = (0u == id) ? cStreamId : cOtherId;
+      uint8_t frame[64];
+      memset(frame, 0, sizeof frame);
+      memcpy(frame, dmac, ETH_ALEN);
+      frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+      frame[13] = uint8_t(ETH_P_IEEE1722);
+      frame[15] = 0x80; // sv
+      for (uint32_t byte = 0u; byte < 8u; byte++)
+      {
+        frame[18u + byte] = uint8_t(streamId >> (56u - (8u * byte)));
+      }
+      ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+      usleep(1000);
+
+      received = 0u;
+      while (0 < recv(rxSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+      {
+        received++;
+      }
+
+      const bool subscribed = ((1u == step) && (0u == id)) || (2u == step);
+      ASSERT_EQ(subscribed ? 1u : 0u, received);
+    }
+  }
+#endif
+
+  mAvbReceiveEngine->cleanup();
+}
+
+TEST_F(IasTestAvbReceiveEngine, KernelTimestamps)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+
+  const uint64_t now = 5000000000u;
+  const uint64_t realNow = 1500000000000000000u;
+  // no time stamp
+  ASSERT_EQ(now, IasAvbReceiveEngine::toLocalTime(0u, false, now, realNow));
+  // software time stamps are relative to CLOCK_REALTIME
+  ASSERT_EQ(now - 20000u, IasAvbReceiveEngine::toLocalTime(realNow - 20000u, false, now, realNow));
+  ASSERT_EQ(now + 1000u, IasAvbReceiveEngine::toLocalTime(realNow + 1000u, false, now, realNow));
+  // hardware time stamps are local time already
+  ASSERT_EQ(now - 20000u, IasAvbReceiveEngine::toLocalTime(now - 20000u, true, now, realNow));
+  // time stamps of an unrelated clock
+  ASSERT_EQ(now, IasAvbReceiveEngine::toLocalTime(realNow, true, now, realNow));
+  ASSERT_EQ(now, IasAvbReceiveEngine::toLocalTime(realNow - 2000000000u, false, now, realNow));
+
+  ASSERT_TRUE(LocalHostSetup());
+
+  mEnvironment->setConfigValue(IasRegKeys::cRxTimestamping, 3u);
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mAvbReceiveEngine->init());
+
+#if !defined(DIRECT_RX_DMA)
+  // loopback has no clock of its own, falls back to software time stamps
+  mEnvironment->setConfigValue(IasRegKeys::cRxTimestamping, uint32_t(IasAvbReceiveEngine::cTimestampHardware));
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+  ASSERT_EQ(uint32_t(IasAvbReceiveEngine::cTimestampSoftware), mAvbReceiveEngine->mTimestamping);
+
+  IasAvbReceiveEngine::Worker & worker = *mAvbReceiveEngine->mWorkers[0];
+  ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(worker.mSocket));
+  uint64_t kernelTime = 0u;
+  bool hardware = true;
+  ASSERT_GT(0, mAvbReceiveEngine->receiveFrame(worker, kernelTime, hardware));
+  ASSERT_EQ(0u, kernelTime);
+
+  int32_t txSocket = socket(PF_PACKET, SOCK_RAW, 0);
+  ASSERT_LE(0, txSocket);
+  mSocketFdList.push_back(txSocket);
+  struct sockaddr_ll dest;
+  memset(&dest, 0, sizeof dest);
+  dest.sll_family = AF_PACKET;
+  dest.sll_ifindex = mAvbReceiveEngine->mRcvPortIfIndex;
+  dest.sll_halen = ETH_ALEN;
+  uint8_t frame[64];
+  memset(frame, 0, sizeof frame);
+  memset(frame, 0xFF, ETH_ALEN);
+  frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+  frame[13] = uint8_t(ETH_P_IEEE1722);
+
+  struct timespec tp;
+  (void) clock_gettime(CLOCK_REALTIME, &tp);
+  const uint64_t before = IasLibPtpDaemon::convertTimespecToNs(tp);
+  ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+  usleep(1000);
+  (void) clock_gettime(CLOCK_REALTIME, &tp);
+  const uint64_t after = IasLibPtpDaemon::convertTimespecToNs(tp);
+
+  ASSERT_EQ(int32_t(sizeof frame), mAvbReceiveEngine->receiveFrame(worker, kernelTime, hardware));
+  ASSERT_FALSE(hardware);
+  ASSERT_LE(before, kernelTime);
+  ASSERT_GE(after, kernelTime);
+  mAvbReceiveEngine->cleanup();
+
+  // time of processing
+  mEnvironment->setConfigValue(IasRegKeys::cRxTimestamping, uint32_t(IasAvbReceiveEngine::cTimestampOff));
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+  IasAvbReceiveEngine::Worker & worker2 = *mAvbReceiveEngine->mWorkers[0];
+  ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(worker2.mSocket));
+  ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+  usleep(1000);
+  ASSERT_EQ(int32_t(sizeof frame), mAvbReceiveEngine->receiveFrame(worker2, kernelTime, hardware));
+  ASSERT_EQ(0u, kernelTime);
+#endif
+
+  mAvbReceiveEngine->cleanup();
+}
+
+TEST_F(IasTestAvbReceiveEngine, Replay)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+
+  uint32_t numFrames = 1u;
+  ASSERT_EQ(eIasAvbProcNotInitialized, mAvbReceiveEngine->replay("/nonexistent.pcap", 0.0f, numFrames));
+  ASSERT_EQ(0u, numFrames);
+
+  ASSERT_TRUE(LocalHostSetup());
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+  ASSERT_EQ(eIasAvbProcErr, mAvbReceiveEngine->replay("/nonexistent.pcap", 0.0f, numFrames));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mAvbReceiveEngine->replay("/nonexistent.pcap", -1.0f, numFrames));
+
+  const uint64_t cStreamId = 0x0011223344550001u;
+  const uint64_t cOtherId = 0x0011223344550002u;
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(IasAvbStreamId(cStreamId)));
+
+  // 20 frames of the stream 1ms apart, followed by frames to be ignored
+  const string fileName = cFnBase + "Replay.pcap";
+  const uint64_t cStart = 7000000000u;
+  IasAvbPcapFile file;
+  ASSERT_EQ(eIasAvbProcOK, file.openWrite(fileName));
+  uint8_t frame[64];
+  for (uint32_t idx = 0u; idx < 23u; idx++)
+  {
+    const uint64_t streamId = (20u == idx) ? cOtherId : cStreamId;
+    memset(frame, 0, sizeof frame);
+    memset(frame, 0xFF, ETH_ALEN);
+    frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+    frame[13] = uint8_t(ETH_P_IEEE1722);
+    frame[15] = 0x80; // sv
+    for (uint32_t byte = 0u; byte < 8u; byte++)
+    {
+      frame[18u + byte] = uint8_t(streamId >> (56u - (8u * byte)));
+    }
+    uint32_t length = sizeof frame;
+    if (21u == idx)
+    {
+      // not AVTP
+      frame[12] = 0x08;
+      frame[13] = 0x00;
+    }
+    else if (22u == idx)
+    {
+      // runt
+      length = ETH_HLEN + 8u;
+    }
+    ASSERT_EQ(eIasAvbProcOK, file.writeFrame(frame, length, cStart + (uint64_t(idx < 20u ? idx : 19u) * 1000000u)));
+  }
+  file.close();
+
+  IasAvbRxStreamData * data = mAvbReceiveEngine->mAvbStreams[IasAvbStreamId(cStreamId)];
+  ASSERT_TRUE(NULL != data);
+
+  struct timespec tp;
+  (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+  const uint64_t before = IasLibPtpDaemon::convertTimespecToNs(tp);
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->replay(fileName, 1.0f, numFrames));
+  (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+  ASSERT_LE(before + 19000000u, IasLibPtpDaemon::convertTimespecToNs(tp));
+  ASSERT_EQ(23u, numFrames);
+  // dispatched at the time recorded
+  ASSERT_EQ(cStart + 19000000u, data->lastTimeDispatched);
+  ASSERT_TRUE(IasAvbTimeoutWheel::isLinked(data));
+
+  // as fast as possible, with the same result
+  data->lastTimeDispatched = 0u;
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->replay(fileName, 0.0f, numFrames));
+  ASSERT_EQ(23u, numFrames);
+  ASSERT_EQ(cStart + 19000000u, data->lastTimeDispatched);
+
+  // not while receiving
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->start());
+  ASSERT_EQ(eIasAvbProcAlreadyInUse, mAvbReceiveEngine->replay(fileName, 0.0f, numFrames));
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->stop());
+
+  mAvbReceiveEngine->cleanup();
+  (void) unlink(fileName.c_str());
+}
+
+TEST_F(IasTestAvbReceiveEngine, Record)
+{
+  ASSERT_TRUE(mAvbReceiveEngine != NULL);
+  ASSERT_TRUE(LocalHostSetup());
+
+  mEnvironment->setConfigValue(IasRegKeys::cRxRecordFile, "/nonexistent/record.pcap");
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mAvbReceiveEngine->init());
+  ASSERT_TRUE(NULL == mAvbReceiveEngine->mRecorder);
+
+  const string fileName = cFnBase + "Record.pcap";
+  mEnvironment->setConfigValue(IasRegKeys::cRxRecordFile, fileName);
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->init());
+  ASSERT_TRUE(NULL != mAvbReceiveEngine->mRecorder);
+  ASSERT_TRUE(mAvbReceiveEngine->mRecorder->isOpen());
+
+  const uint64_t cStreamId = 0x0011223344550001u;
+  ASSERT_EQ(eIasAvbProcOK, createProperAudioStream(IasAvbStreamId(cStreamId)));
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->start());
+
+  int32_t txSocket = socket(PF_PACKET, SOCK_RAW, 0);
+  ASSERT_LE(0, txSocket);
+  mSocketFdList.push_back(txSocket);
+  struct sockaddr_ll dest;
+  memset(&dest, 0, sizeof dest);
+  dest.sll_family = AF_PACKET;
+  dest.sll_ifindex = mAvbReceiveEngine->mRcvPortIfIndex;
+  dest.sll_halen = ETH_ALEN;
+  uint8_t frame[64];
+  memset(frame, 0, sizeof frame);
+  memset(frame, 0xFF, ETH_ALEN);
+  frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+  frame[13] = uint8_t(ETH_P_IEEE1722);
+  frame[15] = 0x80; // sv
+  for (uint32_t byte = 0u; byte < 8u; byte++)
+  {
+    frame[18u + byte] = uint8_t(cStreamId >> (56u - (8u * byte)));
+  }
+  ASSERT_EQ(ssize_t(sizeof frame), sendto(txSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+  usleep(100000);
+
+  ASSERT_EQ(eIasAvbProcOK, mAvbReceiveEngine->stop());
+  mAvbReceiveEngine->cleanup();
+  ASSERT_TRUE(NULL == mAvbReceiveEngine->mRecorder);
+
+  // the frame has been recorded as received
+  IasAvbPcapFile file;
+  ASSERT_EQ(eIasAvbProcOK, file.openRead(fileName));
+  uint8_t buffer[128];
+  uint32_t length = 0u;
+  uint64_t time = 0u;
+  bool found = false;
+  while (eIasAvbProcOK == file.readFrame(buffer, sizeof buffer, length, time))
+  {
+    found = found || ((sizeof frame == length) && (0 == memcmp(frame, buffer, length)));
+  }
+  ASSERT_TRUE(found);
+  (void) unlink(fileName.c_str());
+}
+
 TEST_F(IasTestAvbReceiveEngine, ConnectAudioStreams)
 {
   ASSERT_TRUE(mAvbReceiveEngine != NULL);
@@ -1070,7 +1648,7 @@ TEST_F(IasTestAvbReceiveEngine, checkStreamState)
 
   ASSERT_EQ(eIasAvbProcOK, createProperAudioStream());
   IasAvbReceiveEngine::StreamData streamData;
-  streamData.stream = mAvbReceiveEngine->mAvbStreams.begin()->second.stream;
+  streamData.stream = mAvbReceiveEngine->mAvbStreams.begin()->second->stream;
   streamData.lastState = IasAvbStreamState::eIasAvbStreamNoData;
   // streamData.lastState != newState
   ASSERT_FALSE(mAvbReceiveEngine->checkStreamState(streamData));
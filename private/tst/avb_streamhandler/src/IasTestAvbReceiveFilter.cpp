@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbReceiveFilter.cpp
+ * @brief   The implementation of the IasTestAvbReceiveFilter test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbReceiveFilter.hpp"
+#undef protected
+#undef private
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <cstring>
+
+#ifndef ETH_P_IEEE1722
+#define ETH_P_IEEE1722 0x22F0
+#endif
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbReceiveFilter : public ::testing::Test
+{
+protected:
+  IasTestAvbReceiveFilter()
+    : mFilter(NULL)
+    , mRxSocket(-1)
+    , mTxSocket(-1)
+    , mIfIndex(0)
+  {
+  }
+
+  virtual ~IasTestAvbReceiveFilter()
+  {
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    mFilter = new IasAvbReceiveFilter();
+
+    // frames are looped back on the loopback interface
+    mIfIndex = int32_t(if_nametoindex("lo"));
+    mRxSocket = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_IEEE1722));
+    mTxSocket = socket(PF_PACKET, SOCK_RAW, 0);
+
+    struct sockaddr_ll addr;
+    std::memset(&addr, 0, sizeof addr);
+    addr.sll_family = AF_PACKET;
+    addr.sll_ifindex = mIfIndex;
+    addr.sll_protocol = htons(ETH_P_IEEE1722);
+    if (mRxSocket >= 0)
+    {
+      (void) bind(mRxSocket, reinterpret_cast<sockaddr*>(&addr), sizeof addr);
+    }
+  }
+
+  virtual void TearDown()
+  {
+    delete mFilter;
+    mFilter = NULL;
+
+    if (mRxSocket >= 0)
+    {
+      (void) close(mRxSocket);
+      mRxSocket = -1;
+    }
+    if (mTxSocket >= 0)
+    {
+      (void) close(mTxSocket);
+      mTxSocket = -1;
+    }
+  }
+
+  // sends an AVTP stream frame and returns true if the receive socket got it
+  bool passes(uint64_t streamId, const IasAvbMacAddress & dmac, bool streamIdValid = true)
+  {
+    uint8_t frame[64];
+    std::memset(frame, 0, sizeof frame);
+    std::memcpy(frame, dmac, ETH_ALEN);
+    frame[6] = 0x02; // locally administered source
+    frame[12] = uint8_t(ETH_P_IEEE1722 >> 8);
+    frame[13] = uint8_t(ETH_P_IEEE1722);
+    frame[15] = streamIdValid ? 0x80 : 0x00;
+    for (uint32_t byte = 0u; byte < 8u; byte++)
+    {
+      frame[18u + byte] = uint8_t(streamId >> (56u - (8u * byte)));
+    }
+
+    struct sockaddr_ll dest;
+    std::memset(&dest, 0, sizeof dest);
+    dest.sll_family = AF_PACKET;
+    dest.sll_ifindex = mIfIndex;
+    dest.sll_halen = ETH_ALEN;
+    EXPECT_EQ(ssize_t(sizeof frame), sendto(mTxSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&dest), sizeof dest));
+    usleep(1000);
+
+    uint32_t received = 0u;
+    uint8_t buffer[128];
+    while (0 < recv(mRxSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+    {
+      received++;
+    }
+    EXPECT_GE(1u, received);
+
+    return (0u != received);
+  }
+
+  // drops frames which were received before the filter has been attached
+  void flush()
+  {
+    uint8_t buffer[128];
+    while (0 < recv(mRxSocket, buffer, sizeof buffer, MSG_DONTWAIT))
+    {
+    }
+  }
+
+  IasAvbReceiveFilter * mFilter;
+  int32_t mRxSocket;
+  int32_t mTxSocket;
+  int32_t mIfIndex;
+};
+
+} // namespace IasMediaTransportAvb
+
+static const IasAvbMacAddress cMcastMac = {0x91, 0xE0, 0xF0, 0x00, 0xFE, 0x01};
+static const IasAvbMacAddress cOtherMac = {0x91, 0xE0, 0xF0, 0x00, 0xFE, 0x02};
+
+
+TEST_F(IasTestAvbReceiveFilter, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mFilter);
+  ASSERT_EQ(0u, mFilter->getLength());
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFilter->attach(mRxSocket));
+}
+
+TEST_F(IasTestAvbReceiveFilter, Empty)
+{
+  ASSERT_LE(0, mRxSocket);
+  ASSERT_LE(0, mTxSocket);
+
+  ASSERT_TRUE(passes(1u, cMcastMac));
+
+  // no streams, nothing passes
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  flush();
+  ASSERT_FALSE(passes(1u, cMcastMac));
+
+  ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(mRxSocket));
+  ASSERT_TRUE(passes(1u, cMcastMac));
+  // nothing attached
+  ASSERT_EQ(eIasAvbProcOK, IasAvbReceiveFilter::detach(mRxSocket));
+  ASSERT_EQ(eIasAvbProcErr, mFilter->attach(-1));
+}
+
+TEST_F(IasTestAvbReceiveFilter, Streams)
+{
+  ASSERT_LE(0, mRxSocket);
+  ASSERT_LE(0, mTxSocket);
+
+  const uint64_t cTalker1 = 0x0011223344550000u;
+  const uint64_t cTalker2 = 0x0011223366770000u;
+  mFilter->addStream(cTalker1 + 1u);
+  mFilter->addStream(cTalker1 + 2u);
+  mFilter->addStream(cTalker2 + 1u);
+  mFilter->addStream(cTalker1 + 1u);
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  flush();
+
+  ASSERT_TRUE(passes(cTalker1 + 1u, cMcastMac));
+  ASSERT_TRUE(passes(cTalker1 + 2u, cOtherMac));
+  ASSERT_TRUE(passes(cTalker2 + 1u, cMcastMac));
+  ASSERT_FALSE(passes(cTalker1 + 3u, cMcastMac));
+  ASSERT_FALSE(passes(cTalker2 + 2u, cMcastMac));
+  ASSERT_FALSE(passes(0u, cMcastMac));
+  // no stream data
+  ASSERT_FALSE(passes(cTalker1 + 1u, cMcastMac, false));
+
+  // the filter replaced passes the new set only
+  mFilter->clear();
+  mFilter->addStream(cTalker2 + 2u);
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  ASSERT_FALSE(passes(cTalker1 + 1u, cMcastMac));
+  ASSERT_TRUE(passes(cTalker2 + 2u, cMcastMac));
+}
+
+TEST_F(IasTestAvbReceiveFilter, Wildcard)
+{
+  ASSERT_LE(0, mRxSocket);
+  ASSERT_LE(0, mTxSocket);
+
+  mFilter->addStream(5u);
+  mFilter->addWildcard(cMcastMac);
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  flush();
+
+  // any stream sent to the wildcard's MAC address
+  ASSERT_TRUE(passes(0x1234u, cMcastMac));
+  ASSERT_TRUE(passes(5u, cOtherMac));
+  ASSERT_FALSE(passes(0x1234u, cOtherMac));
+
+  // wildcard without MAC address passes any stream
+  const IasAvbMacAddress zeroMac = {0};
+  mFilter->addWildcard(zeroMac);
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  ASSERT_TRUE(passes(0x1234u, cOtherMac));
+  ASSERT_FALSE(passes(0x1234u, cOtherMac, false));
+}
+
+TEST_F(IasTestAvbReceiveFilter, Size)
+{
+  ASSERT_LE(0, mRxSocket);
+  ASSERT_LE(0, mTxSocket);
+
+  // more streams of one talker than a conditional jump can skip
+  const uint64_t cTalker = 0x0011223344550000u;
+  for (uint64_t idx = 0u; idx < 300u; idx++)
+  {
+    mFilter->addStream(cTalker + idx);
+  }
+  mFilter->addStream(0x0011223366770000u);
+  ASSERT_EQ(eIasAvbProcOK, mFilter->build());
+  ASSERT_EQ(eIasAvbProcOK, mFilter->attach(mRxSocket));
+  flush();
+  ASSERT_TRUE(passes(cTalker + 299u, cMcastMac));
+  ASSERT_TRUE(passes(0x0011223366770000u, cMcastMac));
+  ASSERT_FALSE(passes(cTalker + 300u, cMcastMac));
+
+  // too many talkers
+  for (uint64_t idx = 0u; idx < 1500u; idx++)
+  {
+    mFilter->addStream(idx << 32);
+  }
+  ASSERT_EQ(eIasAvbProcNoSpaceLeft, mFilter->build());
+  ASSERT_EQ(0u, mFilter->getLength());
+  ASSERT_EQ(eIasAvbProcNotInitialized, mFilter->attach(mRxSocket));
+}
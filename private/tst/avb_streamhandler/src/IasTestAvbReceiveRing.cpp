@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbReceiveRing.cpp
+ * @brief   The implementation of the IasTestAvbReceiveRing test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbReceiveRing.hpp"
+#undef protected
+#undef private
+
+#include <unistd.h>
+#include <time.h>
+#include <cstring>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+static const uint16_t cEthTypeAvtp = 0x22F0u;
+
+class IasTestAvbReceiveRing : public ::testing::Test
+{
+protected:
+  IasTestAvbReceiveRing()
+    : mRing(NULL)
+    , mRxSocket(-1)
+    , mTxSocket(-1)
+    , mIfIndex(0)
+  {
+    DLT_REGISTER_APP("IARR", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbReceiveRing()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbReceiveRing",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mRing = new IasAvbReceiveRing(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mRing;
+    mRing = NULL;
+
+    if (mRxSocket >= 0)
+    {
+      (void) close(mRxSocket);
+      mRxSocket = -1;
+    }
+    if (mTxSocket >= 0)
+    {
+      (void) close(mTxSocket);
+      mTxSocket = -1;
+    }
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  // packet sockets on the loopback interface, frames sent on one show up on the other
+  bool openSockets()
+  {
+    mIfIndex = int32_t(if_nametoindex("lo"));
+    mRxSocket = socket(PF_PACKET, SOCK_RAW, htons(cEthTypeAvtp));
+    mTxSocket = socket(PF_PACKET, SOCK_RAW, htons(cEthTypeAvtp));
+
+    bool ok = (0 != mIfIndex) && (mRxSocket >= 0) && (mTxSocket >= 0);
+    if (ok)
+    {
+      struct sockaddr_ll sa;
+      std::memset(&sa, 0, sizeof sa);
+      sa.sll_family = AF_PACKET;
+      sa.sll_ifindex = mIfIndex;
+      sa.sll_protocol = htons(cEthTypeAvtp);
+      ok = (0 == bind(mRxSocket, reinterpret_cast<sockaddr*>(&sa), sizeof sa));
+    }
+
+    return ok;
+  }
+
+  bool sendFrame(uint8_t seq)
+  {
+    uint8_t frame[64];
+    std::memset(frame, 0, sizeof frame);
+    std::memset(frame, 0xFF, 6u);             // broadcast destination
+    std::memset(frame + 6u, 0x02, 6u);        // locally administered source
+    frame[12] = uint8_t(cEthTypeAvtp >> 8);
+    frame[13] = uint8_t(cEthTypeAvtp & 0xFFu);
+    frame[14] = seq;
+
+    struct sockaddr_ll sa;
+    std::memset(&sa, 0, sizeof sa);
+    sa.sll_family = AF_PACKET;
+    sa.sll_ifindex = mIfIndex;
+    sa.sll_halen = ETH_ALEN;
+    std::memset(sa.sll_addr, 0xFF, ETH_ALEN);
+
+    return (ssize_t(sizeof frame) == sendto(mTxSocket, frame, sizeof frame, 0, reinterpret_cast<sockaddr*>(&sa), sizeof sa));
+  }
+
+  IasAvbReceiveRing * mRing;
+  int32_t mRxSocket;
+  int32_t mTxSocket;
+  int32_t mIfIndex;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbReceiveRing, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mRing);
+  ASSERT_FALSE(mRing->isInitialized());
+
+  uint32_t length = 0u;
+  uint64_t timestamp = 0u;
+  ASSERT_TRUE(NULL == mRing->nextFrame(length, timestamp));
+
+  uint32_t packets, drops, freezes;
+  ASSERT_FALSE(mRing->getStatistics(packets, drops, freezes));
+}
+
+TEST_F(IasTestAvbReceiveRing, initParams)
+{
+  ASSERT_TRUE(NULL != mRing);
+  ASSERT_EQ(eIasAvbProcInvalidParam, mRing->init(-1, 4096u, 4u, 1u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mRing->init(0, 0u, 4u, 1u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mRing->init(0, 4096u, 0u, 1u));
+
+  // not a packet socket
+  const int32_t udp = socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_LE(0, udp);
+  ASSERT_EQ(eIasAvbProcErr, mRing->init(udp, 4096u, 4u, 1u));
+  ASSERT_FALSE(mRing->isInitialized());
+  (void) close(udp);
+}
+
+TEST_F(IasTestAvbReceiveRing, init)
+{
+  ASSERT_TRUE(NULL != mRing);
+  if (!openSockets())
+  {
+    // packet sockets need CAP_NET_RAW
+    return;
+  }
+
+  // block size is rounded up to whole pages
+  ASSERT_EQ(eIasAvbProcOK, mRing->init(mRxSocket, 1000u, 4u, 1u));
+  ASSERT_TRUE(mRing->isInitialized());
+  ASSERT_EQ(0u, mRing->mBlockSize % uint32_t(sysconf(_SC_PAGESIZE)));
+  ASSERT_LE(uint32_t(IasAvbReceiveRing::cFrameSize), mRing->mBlockSize);
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mRing->init(mRxSocket, 4096u, 4u, 1u));
+
+  mRing->cleanup();
+  ASSERT_FALSE(mRing->isInitialized());
+}
+
+TEST_F(IasTestAvbReceiveRing, receive)
+{
+  ASSERT_TRUE(NULL != mRing);
+  if (!openSockets())
+  {
+    return;
+  }
+  ASSERT_EQ(eIasAvbProcOK, mRing->init(mRxSocket, 4096u, 4u, 1u));
+
+  struct timespec ts;
+  (void) clock_gettime(CLOCK_REALTIME, &ts);
+  const uint64_t start = (uint64_t(ts.tv_sec) * 1000000000u) + uint64_t(ts.tv_nsec);
+
+  const uint32_t cNumFrames = 40u;   // more than fit into one block
+  for (uint32_t i = 0u; i < cNumFrames; i++)
+  {
+    ASSERT_TRUE(sendFrame(uint8_t(i)));
+  }
+
+  // the socket sees outgoing and incoming copies on loopback, count the incoming ones by sequence
+  uint32_t seen[cNumFrames];
+  std::memset(seen, 0, sizeof seen);
+  uint32_t received = 0u;
+
+  for (uint32_t wait = 0u; (wait < 100u) && (received < cNumFrames); wait++)
+  {
+    uint32_t length = 0u;
+    uint64_t timestamp = 0u;
+    const uint8_t * frame = NULL;
+
+    while (NULL != (frame = mRing->nextFrame(length, timestamp)))
+    {
+      ASSERT_EQ(64u, length);
+      ASSERT_EQ(uint8_t(cEthTypeAvtp >> 8), frame[12]);
+      ASSERT_EQ(uint8_t(cEthTypeAvtp & 0xFFu), frame[13]);
+      ASSERT_LE(start, timestamp);
+      // loopback has no clock of its own
+      ASSERT_FALSE(mRing->hasHardwareTimestamp());
+      ASSERT_GT(cNumFrames, uint32_t(frame[14]));
+      if (0u == seen[frame[14]]++)
+      {
+        received++;
+      }
+    }
+    ::usleep(1000u);
+  }
+
+  ASSERT_EQ(cNumFrames, received);
+  ASSERT_LE(2u, mRing->getBlockCount());
+
+  uint32_t packets = 0u;
+  uint32_t drops = 0u;
+  uint32_t freezes = 0u;
+  ASSERT_TRUE(mRing->getStatistics(packets, drops, freezes));
+  ASSERT_LE(cNumFrames, packets);
+  ASSERT_EQ(0u, drops);
+}
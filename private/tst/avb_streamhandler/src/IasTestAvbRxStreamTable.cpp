@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbRxStreamTable.cpp
+ * @brief   The implementation of the IasTestAvbRxStreamTable test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbRxStreamTable.hpp"
+#undef protected
+#undef private
+
+#include <vector>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbRxStreamTable : public ::testing::Test
+{
+protected:
+  IasTestAvbRxStreamTable()
+    : mTable(NULL)
+  {
+  }
+
+  virtual ~IasTestAvbRxStreamTable()
+  {
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    mTable = new IasAvbRxStreamTable();
+  }
+
+  virtual void TearDown()
+  {
+    delete mTable;
+    mTable = NULL;
+  }
+
+  IasAvbRxStreamTable * mTable;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbRxStreamTable, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mTable);
+  ASSERT_EQ(0u, mTable->getSize());
+  ASSERT_TRUE(NULL == mTable->find(0u));
+  ASSERT_TRUE(NULL == mTable->getEntry(0u));
+}
+
+TEST_F(IasTestAvbRxStreamTable, init)
+{
+  ASSERT_TRUE(NULL != mTable);
+  IasAvbRxStreamData data;
+
+  ASSERT_EQ(eIasAvbProcNotInitialized, mTable->insert(1u, &data));
+  ASSERT_EQ(eIasAvbProcOK, mTable->init(0u));
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mTable->init(1u));
+  ASSERT_EQ(uint32_t(IasAvbRxStreamTable::cMinSlots - 1u), mTable->mMask);
+  ASSERT_EQ(eIasAvbProcInvalidParam, mTable->insert(1u, &data));
+
+  IasAvbRxStreamTable table;
+  ASSERT_EQ(eIasAvbProcOK, table.init(5u));
+  ASSERT_EQ(15u, table.mMask);
+  ASSERT_EQ(eIasAvbProcInvalidParam, table.insert(1u, NULL));
+}
+
+TEST_F(IasTestAvbRxStreamTable, insertFind)
+{
+  ASSERT_TRUE(NULL != mTable);
+
+  const uint32_t cNumStreams = 100u;
+  std::vector<IasAvbRxStreamData> data(cNumStreams);
+  ASSERT_EQ(eIasAvbProcOK, mTable->init(cNumStreams));
+
+  // stream IDs typically differ in the lower bits only, the first one is the wildcard ID
+  const uint64_t cBase = 0x91E0F000FE000000u;
+  ASSERT_EQ(eIasAvbProcOK, mTable->insert(0u, &data[0]));
+  for (uint32_t idx = 1u; idx < cNumStreams; idx++)
+  {
+    ASSERT_EQ(eIasAvbProcOK, mTable->insert(cBase + idx, &data[idx]));
+  }
+  ASSERT_EQ(eIasAvbProcInvalidParam, mTable->insert(cBase + cNumStreams, &data[0]));
+  ASSERT_EQ(cNumStreams, mTable->getSize());
+
+  ASSERT_EQ(&data[0], mTable->find(0u));
+  for (uint32_t idx = 1u; idx < cNumStreams; idx++)
+  {
+    ASSERT_EQ(&data[idx], mTable->find(cBase + idx));
+    ASSERT_EQ(&data[idx], mTable->getEntry(idx));
+    ASSERT_EQ(cBase + idx, mTable->getEntryStreamId(idx));
+  }
+  ASSERT_TRUE(NULL == mTable->find(cBase));
+  ASSERT_TRUE(NULL == mTable->find(cBase + cNumStreams));
+  ASSERT_TRUE(NULL == mTable->getEntry(cNumStreams));
+}
+
+TEST_F(IasTestAvbRxStreamTable, duplicate)
+{
+  ASSERT_TRUE(NULL != mTable);
+  IasAvbRxStreamData data1;
+  IasAvbRxStreamData data2;
+
+  ASSERT_EQ(eIasAvbProcOK, mTable->init(2u));
+  ASSERT_EQ(eIasAvbProcOK, mTable->insert(42u, &data1));
+  ASSERT_EQ(eIasAvbProcAlreadyInUse, mTable->insert(42u, &data2));
+  ASSERT_EQ(1u, mTable->getSize());
+  ASSERT_EQ(&data1, mTable->find(42u));
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbSampleTime.cpp
+ * @brief   The implementation of the IasTestAvbSampleTime test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbSampleTime.hpp"
+#undef protected
+#undef private
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbSampleTime : public ::testing::Test
+{
+protected:
+  typedef IasAvbSampleTime::Wide Wide;
+
+  // exact reference: base + round(ns * count / events)
+  static uint64_t exactNs(uint64_t ns, uint64_t events, uint64_t count)
+  {
+    return uint64_t(((Wide(ns) * count) + (events / 2u)) / events);
+  }
+
+  static uint64_t absDiff(uint64_t a, uint64_t b)
+  {
+    return (a > b) ? (a - b) : (b - a);
+  }
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbSampleTime, fromFrequency)
+{
+  const uint32_t frequencies[] = { 8000u, 16000u, 24000u, 32000u, 44100u, 48000u, 88200u, 96000u, 176400u, 192000u };
+  for (uint32_t i = 0u; i < sizeof frequencies / sizeof frequencies[0]; i++)
+  {
+    const uint32_t freq = frequencies[i];
+    const IasAvbSampleTime::Duration duration = IasAvbSampleTime::fromFrequency(freq);
+    ASSERT_NE(0u, duration);
+
+    // one second worth of samples covers exactly one second and vice versa
+    ASSERT_EQ(1000000000u, IasAvbSampleTime::toNs(duration, freq)) << freq;
+    ASSERT_EQ(freq, IasAvbSampleTime::samplesCeil(1000000000u, duration)) << freq;
+    ASSERT_EQ(freq + 1u, IasAvbSampleTime::samplesCeil(1000000001u, duration)) << freq;
+    ASSERT_EQ(uint64_t(std::lround(1.0e9 / double(freq))), IasAvbSampleTime::toNs(duration, 1u)) << freq;
+  }
+
+  ASSERT_EQ(0u, IasAvbSampleTime::fromFrequency(0u));
+  ASSERT_EQ(0u, IasAvbSampleTime::samplesCeil(1000u, 0u));
+}
+
+TEST_F(IasTestAvbSampleTime, ratio)
+{
+  const IasAvbSampleTime::Duration duration = IasAvbSampleTime::fromFrequency(48000u);
+
+  ASSERT_EQ(uint64_t(IasAvbSampleTime::cOne), IasAvbSampleTime::fromRatio(1.0));
+  ASSERT_EQ(0u, IasAvbSampleTime::fromRatio(0.0));
+  ASSERT_EQ(0u, IasAvbSampleTime::fromRatio(-1.0));
+  ASSERT_EQ(duration, IasAvbSampleTime::scale(duration, IasAvbSampleTime::fromRatio(1.0)));
+
+  // 100 ppm fast: 48000 samples take 100 us longer
+  const IasAvbSampleTime::Duration slow = IasAvbSampleTime::scale(duration, IasAvbSampleTime::fromRatio(1.0001));
+  ASSERT_EQ(1000100000u, IasAvbSampleTime::toNs(slow, 48000u));
+
+  // same as the event based duration
+  ASSERT_EQ(IasAvbSampleTime::fromInterval(1000000000u, 48000u) + 1u, duration);
+  ASSERT_EQ(0u, IasAvbSampleTime::fromInterval(1000u, 0u));
+}
+
+TEST_F(IasTestAvbSampleTime, toNsSigned)
+{
+  const IasAvbSampleTime::Duration duration = IasAvbSampleTime::fromFrequency(44100u);
+  for (int64_t count = 0; count < 1000; count += 7)
+  {
+    ASSERT_EQ(-IasAvbSampleTime::toNsSigned(duration, count), IasAvbSampleTime::toNsSigned(duration, -count));
+    ASSERT_EQ(int64_t(IasAvbSampleTime::toNs(duration, uint64_t(count))), IasAvbSampleTime::toNsSigned(duration, count));
+  }
+}
+
+TEST_F(IasTestAvbSampleTime, samplesPerInterval)
+{
+  ASSERT_EQ(6u, IasAvbSampleTime::samplesPerInterval(48000u, 8000u));
+  ASSERT_EQ(6u, IasAvbSampleTime::samplesPerInterval(44100u, 8000u));
+  ASSERT_EQ(12u, IasAvbSampleTime::samplesPerInterval(48000u, 4000u));
+  ASSERT_EQ(0u, IasAvbSampleTime::samplesPerInterval(48000u, 0u));
+}
+
+/*
+ * Runs the reference plane extrapolation of the audio stream for 24 hours of 48 kHz audio,
+ * with the master clock updated every 125 ms and running 20 ppm fast. The fixed point
+ * result must stay within 1 ns of the exact rational value for every update, in
+ * particular it must not drift, and it must be at least as close as the former double math.
+ */
+TEST_F(IasTestAvbSampleTime, longDurationDrift)
+{
+  const uint64_t cUpdateCount = 6000u;                 // samples per master update
+  const uint64_t cUpdateNs = 125000000u + 2500u;       // 125 ms, 20 ppm fast
+  const uint64_t cUpdates = 24u * 3600u * 8u;          // 24 hours
+  const uint64_t cPacketSamples = 6u;
+
+  uint64_t masterTime = 1000000000u;
+  uint64_t masterCount = 0u;
+  uint64_t maxErrFixed = 0u;
+  uint64_t maxErrDouble = 0u;
+
+  for (uint64_t update = 0u; update < cUpdates; update++)
+  {
+    const uint64_t lastMasterTime = masterTime;
+    const uint64_t lastMasterCount = masterCount;
+    masterTime += cUpdateNs;
+    masterCount += cUpdateCount;
+
+    const IasAvbSampleTime::Duration duration = IasAvbSampleTime::fromInterval(masterTime - lastMasterTime,
+        masterCount - lastMasterCount);
+    const double sampleDuration = double(masterTime - lastMasterTime) / double(masterCount - lastMasterCount);
+
+    // check the packet furthest away from the master time and one rolling through the interval
+    const uint64_t deltas[] = { cUpdateCount, (update * cPacketSamples) % cUpdateCount };
+    for (uint32_t i = 0u; i < 2u; i++)
+    {
+      const uint64_t delta = deltas[i];
+      const uint64_t exact = masterTime + exactNs(cUpdateNs, cUpdateCount, delta);
+      const uint64_t fixed = masterTime + uint64_t(IasAvbSampleTime::toNsSigned(duration, int64_t(delta)));
+      const uint64_t dbl = masterTime + uint64_t(int64_t(sampleDuration * double(int64_t(delta))));
+
+      maxErrFixed = std::max(maxErrFixed, absDiff(fixed, exact));
+      maxErrDouble = std::max(maxErrDouble, absDiff(dbl, exact));
+    }
+  }
+
+  ASSERT_EQ(1000000000u + cUpdates * cUpdateNs, masterTime);
+  ASSERT_LE(maxErrFixed, 1u);
+  ASSERT_LE(maxErrFixed, std::max(maxErrDouble, uint64_t(1u)));
+}
+
+/*
+ * Extrapolates 24 hours of samples from a single reference point, without any master
+ * update, and compares against the exact sample times.
+ */
+TEST_F(IasTestAvbSampleTime, longDurationExtrapolation)
+{
+  const uint32_t frequencies[] = { 44100u, 48000u, 96000u };
+  for (uint32_t i = 0u; i < sizeof frequencies / sizeof frequencies[0]; i++)
+  {
+    const uint32_t freq = frequencies[i];
+    const IasAvbSampleTime::Duration duration = IasAvbSampleTime::fromFrequency(freq);
+
+    for (uint64_t second = 0u; second <= 24u * 3600u; second += 61u)
+    {
+      for (uint64_t sample = 0u; sample < freq; sample += 997u)
+      {
+        const uint64_t count = second * freq + sample;
+        ASSERT_LE(absDiff(IasAvbSampleTime::toNs(duration, count), exactNs(1000000000u, freq, count)), 1u)
+          << freq << " " << count;
+      }
+    }
+  }
+}
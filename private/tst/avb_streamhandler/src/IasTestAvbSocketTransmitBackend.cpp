@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbSocketTransmitBackend.cpp
+ * @brief   The implementation of the IasTestAvbSocketTransmitBackend test class.
+ * @details The tests use the loopback interface, so neither an I210 nor an etf qdisc is needed.
+ *          Without etf qdisc the launch time is ignored and packets are sent right away.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbSocketTransmitBackend.hpp"
+#include "avb_streamhandler/IasAvbTransmitSequencer.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#undef protected
+#undef private
+
+#include <unistd.h>
+#include <cstring>
+
+using namespace IasMediaTransportAvb;
+
+extern size_t heapSpaceLeft;
+extern size_t heapSpaceInitSize;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbSocketTransmitBackend : public ::testing::Test
+{
+protected:
+  IasTestAvbSocketTransmitBackend()
+    : mEnvironment(NULL)
+    , mBackend(NULL)
+    , mPool(NULL)
+  {
+    DLT_REGISTER_APP("IATB", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbSocketTransmitBackend()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    heapSpaceLeft = heapSpaceInitSize;
+
+    dlt_enable_local_print();
+    mEnvironment = new IasAvbStreamHandlerEnvironment(DLT_LOG_INFO);
+    ASSERT_TRUE(NULL != mEnvironment);
+    mEnvironment->registerDltContexts();
+    mEnvironment->setDefaultConfigValues();
+    mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "socket");
+
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbSocketTransmitBackend",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mBackend = new IasAvbSocketTransmitBackend(mDltCtx);
+    mPool = new IasAvbPacketPool(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mBackend;
+    mBackend = NULL;
+    delete mPool;
+    mPool = NULL;
+
+    if (NULL != mEnvironment)
+    {
+      mEnvironment->unregisterDltContexts();
+      delete mEnvironment;
+      mEnvironment = NULL;
+    }
+
+    heapSpaceLeft = heapSpaceInitSize;
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  IasAvbPacket * createPacket(uint16_t len)
+  {
+    IasAvbPacket * packet = mPool->getPacket();
+    if (NULL != packet)
+    {
+      uint8_t * data = static_cast<uint8_t*>(packet->getBasePtr());
+      std::memset(data, 0xFF, 6u);         // broadcast destination
+      std::memset(data + 6u, 0x02, 6u);    // locally administered source
+      data[12] = 0x81u;                    // VLAN tag
+      data[13] = 0x00u;
+      std::memset(data + 14u, 0, len - 14u);
+      packet->len = len;
+      packet->attime = 0u;
+    }
+    return packet;
+  }
+
+  IasAvbStreamHandlerEnvironment * mEnvironment;
+  IasAvbSocketTransmitBackend * mBackend;
+  IasAvbPacketPool * mPool;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbSocketTransmitBackend, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mBackend);
+  ASSERT_EQ(-1, mBackend->mSocket);
+  ASSERT_TRUE(NULL == mBackend->mRing);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, isIgbTransmitBackend)
+{
+  ASSERT_FALSE(IasAvbStreamHandlerEnvironment::isIgbTransmitBackend());
+
+  mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "igb");
+  ASSERT_TRUE(IasAvbStreamHandlerEnvironment::isIgbTransmitBackend());
+
+  mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "dummy");
+  ASSERT_FALSE(mEnvironment->validateRegistryEntries());
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, initUnknownInterface)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "nonexistent99");
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_EQ(-1, mBackend->mSocket);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, init)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  mEnvironment->setConfigValue(IasRegKeys::cXmitSocketRingSize, 100u);
+
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_LE(0, mBackend->mSocket);
+  ASSERT_TRUE(NULL != mBackend->mRing);
+  // rounded up to full blocks
+  ASSERT_LE(100u, mBackend->mFrameCount);
+
+  ASSERT_EQ(eIasAvbProcInitializationFailed, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+
+  mBackend->cleanup();
+  ASSERT_EQ(-1, mBackend->mSocket);
+  ASSERT_TRUE(NULL == mBackend->mRing);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, initNoRing)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  mEnvironment->setConfigValue(IasRegKeys::cXmitSocketRingSize, 0u);
+
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(1u, IasAvbSrClass::eIasAvbSrClassLow));
+  ASSERT_TRUE(NULL == mBackend->mRing);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, packetPoolHostMemory)
+{
+  ASSERT_TRUE(NULL == IasAvbStreamHandlerEnvironment::getIgbDevice());
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 16u));
+  ASSERT_TRUE(mPool->mHostMemory);
+
+  IasAvbPacket * packet = mPool->getPacket();
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_TRUE(NULL != packet->getBasePtr());
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitNotInitialized)
+{
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+  IasAvbPacket * packet = createPacket(64u);
+  ASSERT_TRUE(NULL != packet);
+
+  ASSERT_EQ(-ENXIO, mBackend->xmit(packet));
+  ASSERT_EQ(0u, mBackend->reclaim(true));
+
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitRing)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  mEnvironment->setConfigValue(IasRegKeys::cXmitSocketRingSize, 16u);
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  const uint32_t cNumPackets = 8u;
+  for (uint32_t i = 0u; i < cNumPackets; i++)
+  {
+    IasAvbPacket * packet = createPacket(64u);
+    ASSERT_TRUE(NULL != packet);
+    ASSERT_EQ(0, mBackend->xmit(packet));
+  }
+
+  // packets are copied into the ring, so all buffers are back in the pool already
+  ASSERT_EQ(4u, mPool->getFreeCount());
+
+  uint32_t reclaimed = 0u;
+  for (uint32_t i = 0u; (i < 100u) && (reclaimed < cNumPackets); i++)
+  {
+    reclaimed += mBackend->reclaim(false);
+    ::usleep(1000u);
+  }
+  ASSERT_EQ(cNumPackets, reclaimed);
+  ASSERT_EQ(0u, mBackend->mInFlight);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitSendmsg)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  mEnvironment->setConfigValue(IasRegKeys::cXmitSocketRingSize, 0u);
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  IasAvbPacket * packet = createPacket(64u);
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(0, mBackend->xmit(packet));
+  ASSERT_EQ(4u, mPool->getFreeCount());
+  ASSERT_EQ(0u, mBackend->reclaim(false));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitBurst)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_TRUE(NULL == mBackend->mRing);
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 8u));
+
+  IasAvbPacket * burst[8];
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    burst[i] = createPacket(64u);
+    ASSERT_TRUE(NULL != burst[i]);
+  }
+
+  int32_t result = -1;
+  ASSERT_EQ(0u, mBackend->xmitBurst(burst, 0u, result));
+  ASSERT_EQ(0, result);
+
+  ASSERT_EQ(5u, mBackend->xmitBurst(burst, 5u, result));
+  ASSERT_EQ(0, result);
+  ASSERT_EQ(5u, mPool->getFreeCount());
+
+  // burst stops at the first packet that cannot be sent
+  burst[6]->len = IasAvbSocketTransmitBackend::cFrameSize;
+  ASSERT_EQ(1u, mBackend->xmitBurst(&burst[5], 3u, result));
+  ASSERT_EQ(-EINVAL, result);
+  ASSERT_EQ(6u, mPool->getFreeCount());
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(burst[6]));
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(burst[7]));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitBurstRing)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  mEnvironment->setConfigValue(IasRegKeys::cXmitSocketRingSize, 16u);
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_TRUE(NULL != mBackend->mRing);
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  IasAvbPacket * burst[4];
+  for (uint32_t i = 0u; i < 4u; i++)
+  {
+    burst[i] = createPacket(64u);
+    ASSERT_TRUE(NULL != burst[i]);
+  }
+
+  int32_t result = -1;
+  ASSERT_EQ(4u, mBackend->xmitBurst(burst, 4u, result));
+  ASSERT_EQ(0, result);
+  const uint32_t reclaimed = mBackend->reclaim(false);
+  ASSERT_EQ(4u, reclaimed + mBackend->mInFlight);
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitBurstNotInitialized)
+{
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+  IasAvbPacket * packet = createPacket(64u);
+  ASSERT_TRUE(NULL != packet);
+
+  int32_t result = 0;
+  ASSERT_EQ(0u, mBackend->xmitBurst(&packet, 1u, result));
+  ASSERT_EQ(-ENXIO, result);
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, xmitInvalid)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+  ASSERT_EQ(eIasAvbProcOK, mBackend->init(0u, IasAvbSrClass::eIasAvbSrClassHigh));
+  ASSERT_EQ(eIasAvbProcOK, mPool->init(256u, 4u));
+
+  IasAvbPacket * packet = createPacket(64u);
+  ASSERT_TRUE(NULL != packet);
+  packet->len = IasAvbSocketTransmitBackend::cFrameSize;
+  ASSERT_EQ(-EINVAL, mBackend->xmit(packet));
+  ASSERT_EQ(3u, mPool->getFreeCount());
+  ASSERT_EQ(eIasAvbProcOK, IasAvbPacketPool::returnPacket(packet));
+
+  IasAvbPacket notFromPool;
+  ASSERT_EQ(-EINVAL, mBackend->xmit(&notFromPool));
+}
+
+TEST_F(IasTestAvbSocketTransmitBackend, sequencerBackend)
+{
+  mEnvironment->setConfigValue(IasRegKeys::cNwIfName, "lo");
+
+  IasAvbTransmitSequencer sequencer(mDltCtx);
+  ASSERT_EQ(eIasAvbProcOK, sequencer.init(0u, IasAvbSrClass::eIasAvbSrClassHigh, true));
+  ASSERT_TRUE(NULL != dynamic_cast<IasAvbSocketTransmitBackend*>(sequencer.mBackend));
+
+  // shaping is left to the qdisc, must not touch any hardware
+  sequencer.updateShaper();
+  ASSERT_EQ(0u, sequencer.reclaimPackets());
+
+  sequencer.cleanup();
+  ASSERT_TRUE(NULL == sequencer.mBackend);
+}
@@ -25,6 +25,8 @@
 #include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
 
 #include <arpa/inet.h>
+#include <atomic>
+#include <thread>
 
 using namespace IasMediaTransportAvb;
 
@@ -462,3 +464,129 @@ TEST_F(IasTestAvbStream, incFramesTx)
 
   ASSERT_EQ(1u, mStream->incFramesTx());
 }
+
+namespace IasMediaTransportAvb {
+
+  class IasAvbStreamPrefetchMock: public IasAvbStreamMock
+  {
+    public:
+
+      IasAvbStreamPrefetchMock(DltContext &dltContext):
+        IasAvbStreamMock(dltContext, eIasAvbAudioStream),
+        mNextLaunchTime(125000u)
+      {}
+
+      virtual bool writeToAvbPacket(IasAvbPacket* packet, uint64_t n)
+      {
+        (void) n;
+        packet->attime = mNextLaunchTime;
+        mNextLaunchTime += 125000u;
+        return true;
+      }
+
+      uint64_t mNextLaunchTime;
+  };
+
+} // namespace IasMediaTransportAvb
+
+TEST_F(IasTestAvbStream, prefetchPackets)
+{
+  ASSERT_TRUE(initStreamHandler());
+
+  IasAvbStreamPrefetchMock stream(mDltCtx);
+  IasAvbTSpec tspec(1, IasAvbSrClass::eIasAvbSrClassHigh);
+  IasAvbStreamId streamID((uint64_t)1);
+  IasAvbMacAddress macAddr = {0xff};
+  IasAvbHwCaptureClockDomain clockDomain;
+
+  // not initialized yet
+  ASSERT_EQ(0u, stream.prefetchPackets(0u, 1000000u));
+
+  ASSERT_EQ(eIasAvbProcOK, stream.initTransmit(tspec, streamID, 16, &clockDomain, macAddr, 1, true));
+
+  // not active yet
+  ASSERT_EQ(0u, stream.prefetchPackets(0u, 1000000u));
+
+  stream.activate();
+
+  // renders until the newest packet has reached the horizon
+  ASSERT_EQ(8u, stream.prefetchPackets(0u, 1000000u));
+  ASSERT_EQ(8u, stream.getPrefetchedPacketCount());
+  ASSERT_EQ(0u, stream.prefetchPackets(0u, 1000000u));
+
+  // queued packets are handed out in launch time order
+  IasAvbPacket * packet = stream.preparePacket(0u);
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(125000u, packet->attime);
+  ASSERT_EQ(7u, stream.getPrefetchedPacketCount());
+  IasAvbPacketPool::returnPacket(packet);
+
+  // stale packets are discarded when the stream is reset
+  ASSERT_EQ(eIasAvbProcOK, stream.resetPacketPool());
+  ASSERT_EQ(0u, stream.getPrefetchedPacketCount());
+
+  // empty queue renders on demand
+  packet = stream.preparePacket(0u);
+  ASSERT_TRUE(NULL != packet);
+  ASSERT_EQ(1125000u, packet->attime);
+  IasAvbPacketPool::returnPacket(packet);
+
+  // rendering stops when the packet pool runs dry
+  ASSERT_EQ(16u, stream.prefetchPackets(0u, uint64_t(-1)));
+
+  stream.deactivate();
+  ASSERT_EQ(0u, stream.getPrefetchedPacketCount());
+
+  stream.cleanup();
+}
+
+TEST_F(IasTestAvbStream, prefetchPacketsConcurrent)
+{
+  ASSERT_TRUE(initStreamHandler());
+
+  IasAvbStreamPrefetchMock stream(mDltCtx);
+  IasAvbTSpec tspec(1, IasAvbSrClass::eIasAvbSrClassHigh);
+  IasAvbStreamId streamID((uint64_t)1);
+  IasAvbMacAddress macAddr = {0xff};
+  IasAvbHwCaptureClockDomain clockDomain;
+
+  ASSERT_EQ(eIasAvbProcOK, stream.initTransmit(tspec, streamID, 16, &clockDomain, macAddr, 1, true));
+  stream.activate();
+
+  // render thread and sequencer both render, packets must still come out in launch time order
+  std::atomic<bool> endThread(false);
+  std::thread renderer([&stream, &endThread]()
+  {
+    while (!endThread)
+    {
+      (void) stream.prefetchPackets(0u, uint64_t(-1));
+    }
+  });
+
+  uint64_t lastLaunchTime = 0u;
+  for (uint32_t i = 0u; i < 10000u; i++)
+  {
+    IasAvbPacket * packet = stream.preparePacket(0u);
+    if (NULL != packet)
+    {
+      ASSERT_LT(lastLaunchTime, uint64_t(packet->attime));
+      lastLaunchTime = packet->attime;
+      IasAvbPacketPool::returnPacket(packet);
+    }
+
+    if (0u == (i % 1000u))
+    {
+      stream.deactivate();
+      stream.activate();
+    }
+  }
+
+  endThread = true;
+  renderer.join();
+
+  stream.deactivate();
+  ASSERT_EQ(0u, stream.getPrefetchedPacketCount());
+  ASSERT_EQ(16u, stream.mPacketPool->getFreeCount());
+
+  stream.cleanup();
+}
@@ -740,6 +740,21 @@ TEST_F(IasTestAvbStreamHandler, disconnectStreams_noSetup)
   ASSERT_EQ(IasAvbResult::eIasAvbResultErr, mIasAvbStreamHandler->disconnectStreams(networkStreamId));
 }
 
+TEST_F(IasTestAvbStreamHandler, setChannelRouting_noSetup)
+{
+  ASSERT_TRUE(mIasAvbStreamHandler != NULL);
+  AvbStreamId networkStreamId = 0x91E0F000FE000001u;
+  ChannelRoutingList routing;
+  routing.push_back(IasAvbChannelRoute{0u, 1u, 1.0f});
+  ASSERT_EQ(IasAvbResult::eIasAvbResultErr, mIasAvbStreamHandler->setChannelRouting(networkStreamId, routing));
+
+  bool noSetup = false;
+  ASSERT_EQ(eIasAvbProcOK, initAvbStreamHandler(noSetup));
+
+  // no such stream
+  ASSERT_EQ(IasAvbResult::eIasAvbResultErr, mIasAvbStreamHandler->setChannelRouting(networkStreamId, routing));
+}
+
 TEST_F(IasTestAvbStreamHandler, setChannelLayout)
 {
   ASSERT_TRUE(mIasAvbStreamHandler != NULL);
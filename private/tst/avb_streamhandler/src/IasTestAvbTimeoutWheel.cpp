@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbTimeoutWheel.cpp
+ * @brief   The implementation of the IasTestAvbTimeoutWheel test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbTimeoutWheel.hpp"
+#undef protected
+#undef private
+
+#include <cstring>
+#include <limits>
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+class IasTestAvbTimeoutWheel : public ::testing::Test
+{
+protected:
+  IasTestAvbTimeoutWheel()
+    : mWheel(NULL)
+  {
+    std::memset(mNodes, 0, sizeof mNodes);
+  }
+
+  virtual ~IasTestAvbTimeoutWheel()
+  {
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    mWheel = new IasAvbTimeoutWheel();
+  }
+
+  virtual void TearDown()
+  {
+    delete mWheel;
+    mWheel = NULL;
+  }
+
+  // returns the number of nodes in the list, checks they are unlinked
+  uint32_t countExpired(IasAvbTimeoutWheel::Node * list)
+  {
+    uint32_t count = 0u;
+    while (NULL != list)
+    {
+      EXPECT_FALSE(IasAvbTimeoutWheel::isLinked(list));
+      count++;
+      list = list->next;
+    }
+    return count;
+  }
+
+  static const uint64_t cTick = 1000u;
+
+  IasAvbTimeoutWheel * mWheel;
+  IasAvbTimeoutWheel::Node mNodes[4];
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbTimeoutWheel, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mWheel);
+  ASSERT_EQ(0u, mWheel->getSize());
+  ASSERT_EQ(std::numeric_limits<uint64_t>::max(), mWheel->getNextExpiry());
+  ASSERT_TRUE(NULL == mWheel->expire(1000000u));
+}
+
+TEST_F(IasTestAvbTimeoutWheel, Init)
+{
+  ASSERT_EQ(eIasAvbProcInvalidParam, mWheel->init(0u, 0u));
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 5u * cTick));
+
+  mWheel->add(&mNodes[0], 7u * cTick);
+  ASSERT_EQ(1u, mWheel->getSize());
+
+  // init drops all timeouts
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 5u * cTick));
+  ASSERT_EQ(0u, mWheel->getSize());
+  ASSERT_EQ(std::numeric_limits<uint64_t>::max(), mWheel->getNextExpiry());
+}
+
+TEST_F(IasTestAvbTimeoutWheel, AddExpire)
+{
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 0u));
+
+  mWheel->add(&mNodes[0], 10u * cTick + 1u);
+  mWheel->add(&mNodes[1], 3u * cTick);
+  ASSERT_TRUE(IasAvbTimeoutWheel::isLinked(&mNodes[0]));
+  ASSERT_EQ(2u, mWheel->getSize());
+  ASSERT_EQ(3u * cTick, mWheel->getNextExpiry());
+
+  // nothing before the deadline
+  ASSERT_TRUE(NULL == mWheel->expire(3u * cTick - 1u));
+
+  IasAvbTimeoutWheel::Node * expired = mWheel->expire(3u * cTick);
+  ASSERT_EQ(&mNodes[1], expired);
+  ASSERT_EQ(1u, countExpired(expired));
+  ASSERT_EQ(1u, mWheel->getSize());
+
+  // deadline is rounded up to the next tick
+  ASSERT_EQ(11u * cTick, mWheel->getNextExpiry());
+  ASSERT_TRUE(NULL == mWheel->expire(10u * cTick + 1u));
+  expired = mWheel->expire(11u * cTick);
+  ASSERT_EQ(&mNodes[0], expired);
+  ASSERT_EQ(0u, mWheel->getSize());
+  ASSERT_EQ(std::numeric_limits<uint64_t>::max(), mWheel->getNextExpiry());
+
+  // deadline in the past expires with the next tick
+  mWheel->add(&mNodes[0], 0u);
+  ASSERT_EQ(12u * cTick, mWheel->getNextExpiry());
+  mWheel->add(&mNodes[1], 12u * cTick);
+  ASSERT_EQ(2u, countExpired(mWheel->expire(12u * cTick)));
+}
+
+TEST_F(IasTestAvbTimeoutWheel, Remove)
+{
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 0u));
+
+  // all in the same slot
+  mWheel->add(&mNodes[0], 5u * cTick);
+  mWheel->add(&mNodes[1], 5u * cTick);
+  mWheel->add(&mNodes[2], 5u * cTick);
+  mWheel->remove(&mNodes[1]);
+  ASSERT_FALSE(IasAvbTimeoutWheel::isLinked(&mNodes[1]));
+  ASSERT_EQ(2u, mWheel->getSize());
+
+  // removing twice does nothing
+  mWheel->remove(&mNodes[1]);
+  ASSERT_EQ(2u, mWheel->getSize());
+
+  mWheel->remove(&mNodes[2]);
+  IasAvbTimeoutWheel::Node * expired = mWheel->expire(5u * cTick);
+  ASSERT_EQ(&mNodes[0], expired);
+  ASSERT_EQ(1u, countExpired(expired));
+}
+
+TEST_F(IasTestAvbTimeoutWheel, Cascade)
+{
+  const uint64_t level0 = uint64_t(IasAvbTimeoutWheel::cLevel0Size);
+  const uint64_t level1 = uint64_t(IasAvbTimeoutWheel::cLevel1Size);
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 0u));
+
+  // second level, expiry is reported early at the group boundary
+  mWheel->add(&mNodes[0], (level0 + 10u) * cTick);
+  ASSERT_EQ(level0 * cTick, mWheel->getNextExpiry());
+  ASSERT_TRUE(NULL == mWheel->expire(level0 * cTick));
+  ASSERT_EQ(1u, mWheel->getSize());
+  ASSERT_EQ((level0 + 10u) * cTick, mWheel->getNextExpiry());
+  ASSERT_EQ(&mNodes[0], mWheel->expire((level0 + 10u) * cTick));
+
+  // beyond the second level, re-inserted until due
+  const uint64_t far = (level0 * level1 * 3u + 7u) * cTick;
+  mWheel->add(&mNodes[1], far);
+  mWheel->add(&mNodes[2], far + cTick);
+  uint64_t now = (level0 + 10u) * cTick;
+  uint32_t expiredCount = 0u;
+  while (0u != mWheel->getSize())
+  {
+    now = mWheel->getNextExpiry();
+    ASSERT_NE(std::numeric_limits<uint64_t>::max(), now);
+    IasAvbTimeoutWheel::Node * expired = mWheel->expire(now);
+    if (NULL != expired)
+    {
+      // never early
+      ASSERT_GE(now, expired->deadline);
+    }
+    expiredCount += countExpired(expired);
+  }
+  ASSERT_EQ(2u, expiredCount);
+  ASSERT_EQ(far + cTick, now);
+}
+
+TEST_F(IasTestAvbTimeoutWheel, EmptyJump)
+{
+  ASSERT_EQ(eIasAvbProcOK, mWheel->init(cTick, 0u));
+
+  // empty wheel catches up with the time at once
+  ASSERT_TRUE(NULL == mWheel->expire(1000000u * cTick));
+  mWheel->add(&mNodes[0], 1000000u * cTick + 2u * cTick);
+  ASSERT_EQ(1000002u * cTick, mWheel->getNextExpiry());
+  ASSERT_EQ(&mNodes[0], mWheel->expire(1000010u * cTick));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbTransmitRenderer.cpp
+ * @brief   The implementation of the IasTestAvbTransmitRenderer test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbTransmitRenderer.hpp"
+#include "avb_streamhandler/IasAvbStream.hpp"
+#include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
+#undef protected
+#undef private
+
+using namespace IasMediaTransportAvb;
+
+extern size_t heapSpaceLeft;
+extern size_t heapSpaceInitSize;
+
+namespace IasMediaTransportAvb
+{
+
+class IasAvbRenderStreamMock : public IasAvbStream
+{
+  public:
+    IasAvbRenderStreamMock(DltContext &dltContext)
+      : IasAvbStream(dltContext, eIasAvbAudioStream)
+    {}
+
+    virtual void readFromAvbPacket(const void* packet, size_t length) { (void) packet; (void) length; }
+    virtual bool writeToAvbPacket(IasAvbPacket* packet, uint64_t n) { (void) packet; (void) n; return false; }
+    virtual void derivedCleanup() {}
+};
+
+class IasTestAvbTransmitRenderer : public ::testing::Test
+{
+protected:
+  IasTestAvbTransmitRenderer()
+    : mEnvironment(NULL)
+    , mRenderer(NULL)
+  {
+    DLT_REGISTER_APP("IATR", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbTransmitRenderer()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    heapSpaceLeft = heapSpaceInitSize;
+
+    mEnvironment = new IasAvbStreamHandlerEnvironment(DLT_LOG_INFO);
+    ASSERT_TRUE(NULL != mEnvironment);
+    mEnvironment->registerDltContexts();
+    mEnvironment->setDefaultConfigValues();
+
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbTransmitRenderer",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mRenderer = new IasAvbTransmitRenderer(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mRenderer;
+    mRenderer = NULL;
+
+    if (NULL != mEnvironment)
+    {
+      mEnvironment->unregisterDltContexts();
+      delete mEnvironment;
+      mEnvironment = NULL;
+    }
+
+    heapSpaceLeft = heapSpaceInitSize;
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  IasAvbStreamHandlerEnvironment * mEnvironment;
+  IasAvbTransmitRenderer * mRenderer;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbTransmitRenderer, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mRenderer);
+  ASSERT_FALSE(mRenderer->isThreaded());
+}
+
+TEST_F(IasTestAvbTransmitRenderer, init)
+{
+  ASSERT_TRUE(NULL != mRenderer);
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mRenderer->init(IasAvbSrClass::eIasAvbSrClassHigh, 0u, 2000000u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mRenderer->init(IasAvbSrClass::eIasAvbSrClassHigh, 4000000u, 0u));
+
+  ASSERT_EQ(eIasAvbProcOK, mRenderer->init(IasAvbSrClass::eIasAvbSrClassHigh, 4000000u, 2000000u));
+  ASSERT_FALSE(mRenderer->isThreaded());
+  ASSERT_EQ(-1, mRenderer->mCpu);
+
+  // starting/stopping is a no-op when rendering in the TX thread
+  ASSERT_EQ(eIasAvbProcOK, mRenderer->start());
+  ASSERT_EQ(eIasAvbProcOK, mRenderer->stop());
+  mRenderer->cleanup();
+}
+
+TEST_F(IasTestAvbTransmitRenderer, initThreaded)
+{
+  ASSERT_TRUE(NULL != mRenderer);
+
+  mEnvironment->setConfigValue(IasRegKeys::cXmitRenderThread, 1u);
+  mEnvironment->setConfigValue(std::string(IasRegKeys::cXmitRenderCpu) + "high", 1u);
+
+  ASSERT_EQ(eIasAvbProcOK, mRenderer->init(IasAvbSrClass::eIasAvbSrClassHigh, 4000000u, 2000000u));
+  ASSERT_TRUE(mRenderer->isThreaded());
+  ASSERT_EQ(1, mRenderer->mCpu);
+
+  mRenderer->cleanup();
+  ASSERT_FALSE(mRenderer->isThreaded());
+}
+
+TEST_F(IasTestAvbTransmitRenderer, render)
+{
+  ASSERT_TRUE(NULL != mRenderer);
+  ASSERT_EQ(eIasAvbProcOK, mRenderer->init(IasAvbSrClass::eIasAvbSrClassHigh, 4000000u, 2000000u));
+
+  ASSERT_EQ(0u, mRenderer->render(0u));
+
+  // streams that are not initialized for transmission are skipped
+  IasAvbRenderStreamMock stream(mDltCtx);
+  std::vector<IasAvbStream*> streams;
+  streams.push_back(&stream);
+  mRenderer->setStreams(streams);
+  ASSERT_EQ(1u, mRenderer->mStreams.size());
+  ASSERT_EQ(0u, mRenderer->render(0u));
+
+  mRenderer->setStreams(std::vector<IasAvbStream*>());
+  ASSERT_EQ(0u, mRenderer->mStreams.size());
+}
@@ -13,11 +13,14 @@
 #define private public
 #define protected public
 #include "avb_streamhandler/IasAvbTransmitSequencer.hpp"
+#include "avb_streamhandler/IasAvbIgbTransmitBackend.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEnvironment.hpp"
 #include "internal/audio/common/alsa_smartx_plugin/IasAlsaPluginIpc.hpp"
 #include "avb_streamhandler/IasAvbTransmitEngine.hpp"
 #include "lib_ptp_daemon/IasLibPtpDaemon.hpp"
 #include "avb_streamhandler/IasAvbPacket.hpp"
+#include "avb_streamhandler/IasAvbPacketPool.hpp"
+#include "avb_streamhandler/IasAvbAudioStream.hpp"
 #include "avb_streamhandler/IasAvbStreamHandlerEventInterface.hpp"
 #undef protected
 #undef private
@@ -59,6 +62,45 @@ private:
     }
 };
 
+class FakeTransmitBackend: public IasAvbTransmitBackend
+{
+public:
+    FakeTransmitBackend() : mAccept(0u), mResult(EAGAIN) {}
+    ~FakeTransmitBackend() {}
+
+    IasAvbProcessingResult init(uint32_t queueIndex, IasAvbSrClass qavClass)
+    {
+        (void) queueIndex;
+        (void) qavClass;
+        return eIasAvbProcOK;
+    }
+    void cleanup() {}
+    int32_t xmit(IasAvbPacket * packet)
+    {
+        if (0u == mAccept)
+        {
+            return mResult;
+        }
+        mAccept--;
+        mSent.push_back(packet);
+        return 0;
+    }
+    uint32_t reclaim(bool doReclaim)
+    {
+        (void) doReclaim;
+        return 0u;
+    }
+    void updateShaper(uint32_t bandwidth, uint32_t maxFrameSizeHigh)
+    {
+        (void) bandwidth;
+        (void) maxFrameSizeHigh;
+    }
+
+    uint32_t mAccept;  // number of packets accepted before failing with mResult
+    int32_t mResult;
+    std::vector<IasAvbPacket*> mSent;
+};
+
 class IasTestAvbTransmitSequencer : public ::testing::Test
 {
 protected:
@@ -457,6 +499,111 @@ TEST_F(IasTestAvbTransmitSequencer, logOutput)
   mSequencer->mDiag.sent = 1u;
   mSequencer->logOutput(1.0f, 0.0f);
   ASSERT_EQ(0u, mSequencer->mDiag.sent);
+
+  mSequencer->mDiag.debugOutputCount = 400u;
+  mSequencer->mDiag.bursts = 2u;
+  mSequencer->mDiag.burstPackets = 10u;
+  mSequencer->mDiag.burstMaxSize = 6u;
+  mSequencer->mDiag.burstTime = 3000u;
+  mSequencer->mDiag.burstMaxTime = 2000u;
+  mSequencer->logOutput(1.0f, 0.0f);
+  ASSERT_EQ(0u, mSequencer->mDiag.bursts);
+  ASSERT_EQ(0u, mSequencer->mDiag.burstPackets);
+  ASSERT_EQ(0u, mSequencer->mDiag.burstMaxSize);
+  ASSERT_EQ(0u, mSequencer->mDiag.burstTime);
+  ASSERT_EQ(0u, mSequencer->mDiag.burstMaxTime);
+}
+
+TEST_F(IasTestAvbTransmitSequencer, flushBurstEmpty)
+{
+  ASSERT_EQ(eIasAvbProcOK, mSequencer->init(0u, IasAvbSrClass::eIasAvbSrClassHigh, false));
+
+  ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, mSequencer->flushBurst(0u));
+  ASSERT_EQ(0u, mSequencer->mDiag.bursts);
+  ASSERT_LE(size_t(IasAvbTransmitSequencer::cMaxBurstSize), mSequencer->mBurstPackets.capacity());
+}
+
+TEST_F(IasTestAvbTransmitSequencer, flushBurstRetry)
+{
+  // host memory packets, no igb device needed
+  ASSERT_EQ(IasAvbResult::eIasAvbResultOk, mEnvironment->setConfigValue(IasRegKeys::cXmitBackend, "capture"));
+  ASSERT_EQ(eIasAvbProcOK, mSequencer->init(0u, IasAvbSrClass::eIasAvbSrClassHigh, false));
+
+  FakeTransmitBackend * backend = new FakeTransmitBackend();
+  delete mSequencer->mBackend;
+  mSequencer->mBackend = backend;
+
+  IasAvbPacketPool pool(mDltContext);
+  ASSERT_EQ(eIasAvbProcOK, pool.init(256u, 8u));
+  IasAvbAudioStream stream;
+
+  const uint64_t windowStart = 1000000000u;
+  for (uint32_t i = 0u; i < 4u; i++)
+  {
+    IasAvbPacket * packet = pool.getPacket();
+    ASSERT_TRUE(NULL != packet);
+    packet->attime = windowStart + i * 125000u;
+    mSequencer->mBurstPackets.push_back(packet);
+    mSequencer->mBurstStreams.push_back(&stream);
+  }
+
+  // the backend takes one packet, the others are kept in launch time order
+  backend->mAccept = 1u;
+  ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, mSequencer->flushBurst(windowStart));
+  ASSERT_EQ(1u, backend->mSent.size());
+  ASSERT_EQ(3u, mSequencer->mBurstPackets.size());
+  ASSERT_EQ(3u, mSequencer->mBurstRetained);
+  ASSERT_EQ(windowStart + 125000u, mSequencer->mBurstPackets[0]->attime);
+  ASSERT_EQ(0u, mSequencer->mDiag.dropped);
+  ASSERT_EQ(3u, mSequencer->mDiag.burstRetries);
+
+  // next pass, the kept packets go first
+  backend->mAccept = 8u;
+  ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, mSequencer->flushBurst(windowStart + 125000u));
+  ASSERT_EQ(4u, backend->mSent.size());
+  for (uint32_t i = 0u; i < 4u; i++)
+  {
+    ASSERT_EQ(windowStart + i * 125000u, backend->mSent[i]->attime);
+  }
+  ASSERT_TRUE(mSequencer->mBurstPackets.empty());
+  ASSERT_EQ(0u, mSequencer->mBurstRetained);
+  ASSERT_EQ(0u, mSequencer->mDiag.dropped);
+
+  // packets whose launch time passed while waiting for the retry are dropped
+  for (uint32_t i = 0u; i < 2u; i++)
+  {
+    IasAvbPacket * packet = pool.getPacket();
+    ASSERT_TRUE(NULL != packet);
+    packet->attime = windowStart;
+    mSequencer->mBurstPackets.push_back(packet);
+    mSequencer->mBurstStreams.push_back(&stream);
+  }
+  backend->mAccept = 0u;
+  ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, mSequencer->flushBurst(windowStart));
+  ASSERT_EQ(2u, mSequencer->mBurstRetained);
+  backend->mAccept = 8u;
+  ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone,
+            mSequencer->flushBurst(windowStart + mSequencer->mConfig.txWindowCueThreshold + 1u));
+  ASSERT_EQ(4u, backend->mSent.size());
+  ASSERT_EQ(2u, mSequencer->mDiag.dropped);
+  ASSERT_EQ(0u, mSequencer->mBurstRetained);
+
+  // packets of a stream leaving the sequence are given back
+  IasAvbPacket * packet = pool.getPacket();
+  ASSERT_TRUE(NULL != packet);
+  packet->attime = windowStart;
+  mSequencer->mBurstPackets.push_back(packet);
+  mSequencer->mBurstStreams.push_back(&stream);
+  mSequencer->mBurstRetained = 1u;
+  mSequencer->discardBurstPackets(&stream);
+  ASSERT_TRUE(mSequencer->mBurstPackets.empty());
+  ASSERT_EQ(0u, mSequencer->mBurstRetained);
+
+  for (size_t i = 0u; i < backend->mSent.size(); i++)
+  {
+    IasAvbPacketPool::returnPacket(backend->mSent[i]);
+  }
+  ASSERT_EQ(8u, pool.getFreeCount());
 }
 
 TEST_F(IasTestAvbTransmitSequencer, serviceStream)
@@ -478,20 +625,19 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStream)
     sequencer->mLock.lock();
     sequencer->mRequestCount++;
     sequencer->mLock.unlock();
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-    sequencer->updateSequence(nextStreamToService);
+    sequencer->updateSequence();
     sleep(1);
 
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t now = ptp->getLocalTime();
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eTxError;
     (*nextStream).packet = NULL;
 
     IasAvbStream *stream = nextStream->stream;
     (*nextStream).stream = NULL;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->serviceStream(now, nextStream));
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->serviceStream(now));
     nextStream->stream = stream;
 
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
@@ -500,7 +646,9 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStream)
     now = ptp->getLocalTime();
     (*nextStream).packet->attime = now + sequencer->mConfig.txWindowWidth + 1u;
     (*nextStream).launchTime = now;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eEndOfWindow, sequencer->serviceStream(now, nextStream));
+    // the stream has been parked by the previous call, put it back into the sequence
+    sequencer->mSequence.rearm();
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eEndOfWindow, sequencer->serviceStream(now));
 
     now = ptp->getLocalTime();
     (*nextStream).packet->attime = now;
@@ -529,14 +677,13 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamDummyPacket)
     sequencer->mLock.lock();
     sequencer->mRequestCount++;
     sequencer->mLock.unlock();
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-    sequencer->updateSequence(nextStreamToService);
+    sequencer->updateSequence();
     sleep(1);
 
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t now = ptp->getLocalTime();
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
 
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
     IasAvbPacket *packet = new IasAvbPacket();
@@ -545,7 +692,7 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamDummyPacket)
     now = ptp->getLocalTime();
     (*nextStream).packet->attime = now + sequencer->mConfig.txWindowWidth;
     (*nextStream).launchTime = now;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now, nextStream));
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now));
     delete packet;
     (*nextStream).packet = nullptr;
   }
@@ -570,14 +717,13 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamSendPacket)
     sequencer->mLock.lock();
     sequencer->mRequestCount++;
     sequencer->mLock.unlock();
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-    sequencer->updateSequence(nextStreamToService);
+    sequencer->updateSequence();
     sleep(1);
 
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t now = ptp->getLocalTime();
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
 
     now = ptp->getLocalTime();
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
@@ -587,9 +733,15 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamSendPacket)
     (*nextStream).packet->attime = now + sequencer->mConfig.txWindowWidth;
     (*nextStream).launchTime = now;
     sequencer->mDiag.debugLastLaunchTime = (*nextStream).packet->attime;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now, nextStream));
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now));
+    // the packet is queued until the burst is flushed
+    ASSERT_EQ(1u, sequencer->mBurstPackets.size());
+    ASSERT_EQ(packet, sequencer->mBurstPackets[0]);
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->flushBurst());
+    ASSERT_EQ(0u, sequencer->mBurstPackets.size());
+    ASSERT_EQ(1u, sequencer->mDiag.bursts);
+    ASSERT_EQ(1u, sequencer->mDiag.burstPackets);
     delete packet;
-    (*nextStream).packet = nullptr;
   }
 }
 
@@ -650,14 +802,13 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamEINVAL)
     sequencer->mLock.lock();
     sequencer->mRequestCount++;
     sequencer->mLock.unlock();
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-    sequencer->updateSequence(nextStreamToService);
+    sequencer->updateSequence();
     sleep(1);
 
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t now = ptp->getLocalTime();
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
 
     now = ptp->getLocalTime();
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
@@ -666,12 +817,16 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamEINVAL)
     (*nextStream).packet->attime = now + sequencer->mConfig.txWindowWidth;
     (*nextStream).launchTime = now;
     sequencer->mDiag.debugLastLaunchTime = (*nextStream).packet->attime;
-    _device_t * tempDev = sequencer->mIgbDevice;
-    sequencer->mIgbDevice = nullptr;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->serviceStream(now, nextStream));
-    sequencer->mIgbDevice = tempDev;
+    IasAvbPacket *packet = (*nextStream).packet;
+    IasAvbIgbTransmitBackend * backend = static_cast<IasAvbIgbTransmitBackend*>(sequencer->mBackend);
+    _device_t * tempDev = backend->mIgbDevice;
+    backend->mIgbDevice = nullptr;
+    (void) sequencer->serviceStream(now);
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->flushBurst());
+    ASSERT_EQ(0u, sequencer->mBurstPackets.size());
+    backend->mIgbDevice = tempDev;
 
-    delete (*nextStream).packet;
+    delete packet;
   }
 }
 
@@ -694,14 +849,13 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamENXIO)
     sequencer->mLock.lock();
     sequencer->mRequestCount++;
     sequencer->mLock.unlock();
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-    sequencer->updateSequence(nextStreamToService);
+    sequencer->updateSequence();
     sleep(1);
 
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t now = ptp->getLocalTime();
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
 
     now = ptp->getLocalTime();
     (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
@@ -710,12 +864,16 @@ TEST_F(IasTestAvbTransmitSequencer, serviceStreamENXIO)
     (*nextStream).packet->attime = now + sequencer->mConfig.txWindowWidth;
     (*nextStream).launchTime = now;
     sequencer->mDiag.debugLastLaunchTime = (*nextStream).packet->attime;
-    void * tempPrivData = sequencer->mIgbDevice->private_data;
-    sequencer->mIgbDevice->private_data = nullptr;
-    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->serviceStream(now, nextStream));
-    sequencer->mIgbDevice->private_data = tempPrivData;
+    IasAvbPacket *packet = (*nextStream).packet;
+    IasAvbIgbTransmitBackend * backend = static_cast<IasAvbIgbTransmitBackend*>(sequencer->mBackend);
+    void * tempPrivData = backend->mIgbDevice->private_data;
+    backend->mIgbDevice->private_data = nullptr;
+    (void) sequencer->serviceStream(now);
+    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eTxError, sequencer->flushBurst());
+    ASSERT_EQ(0u, sequencer->mBurstPackets.size());
+    backend->mIgbDevice->private_data = tempPrivData;
 
-    delete (*nextStream).packet;
+    delete packet;
   }
 }
 
@@ -809,7 +967,7 @@ TEST_F(IasTestAvbTransmitSequencer, removeStreamFromTransmitList)
   ASSERT_EQ(eIasAvbProcNotInitialized, sequencer->removeStreamFromTransmitList(stream));
 }
 
-TEST_F(IasTestAvbTransmitSequencer, sortByLaunchTime)
+TEST_F(IasTestAvbTransmitSequencer, sequenceByLaunchTime)
 {
   ASSERT_TRUE(LocalSetup());
 
@@ -839,22 +997,34 @@ TEST_F(IasTestAvbTransmitSequencer, sortByLaunchTime)
     sequencer->mRequestCount++;
     sleep(1);
 
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator lastStream = std::prev(sequencer->mSequence.end());
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator middleStream = std::prev(lastStream);
-    IasAvbTransmitSequencer::AvbStreamDataList::iterator firstStream = sequencer->mSequence.begin();
+    ASSERT_EQ(3u, sequencer->mSequence.size());
     IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
     uint64_t customLaunchTime = ptp->getLocalTime();
-    (*firstStream).launchTime = customLaunchTime;
-    (*middleStream).launchTime = customLaunchTime + 2u;
-    (*lastStream).launchTime = customLaunchTime + 1u;
-
-    sequencer->sortByLaunchTime(lastStream);
-
-    (*firstStream).launchTime = 0u;
-
-    sequencer->sortByLaunchTime(lastStream);
-
-    (*firstStream).launchTime = customLaunchTime;
+    IasAvbStream * earliest = sequencer->mSequence[2].stream;
+    sequencer->mSequence[0].launchTime = customLaunchTime + 2u;
+    sequencer->mSequence[1].launchTime = customLaunchTime + 1u;
+    sequencer->mSequence[2].launchTime = customLaunchTime;
+    sequencer->mSequence.rearm();
+
+    ASSERT_EQ(3u, sequencer->mSequence.readyCount());
+    ASSERT_EQ(earliest, sequencer->mSequence.top().stream);
+
+    // move the earliest stream to the end of the sequence
+    sequencer->mSequence.top().launchTime = customLaunchTime + 3u;
+    ASSERT_TRUE(sequencer->mSequence.updateTop());
+    ASSERT_EQ(customLaunchTime + 1u, sequencer->mSequence.top().launchTime);
+
+    // streams without packet (launch time 0) are serviced first
+    sequencer->mSequence.top().launchTime = 0u;
+    ASSERT_FALSE(sequencer->mSequence.updateTop());
+
+    sequencer->mSequence.parkTop();
+    ASSERT_EQ(2u, sequencer->mSequence.readyCount());
+    ASSERT_EQ(customLaunchTime + 2u, sequencer->mSequence.top().launchTime);
+
+    sequencer->mSequence.top().launchTime = customLaunchTime;
+    sequencer->mSequence.rearm();
+    ASSERT_EQ(3u, sequencer->mSequence.readyCount());
   }
 
   mTransmitEngine->stop();
@@ -898,14 +1068,13 @@ TEST_F(IasTestAvbTransmitSequencer, reclaimPackets)
 //    sequencer->mLock.lock();
 //    sequencer->mRequestCount++;
 //    sequencer->mLock.unlock();
-//    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStreamToService = sequencer->mSequence.end();
-//    sequencer->updateSequence(nextStreamToService);
+//    sequencer->updateSequence();
 //    sleep(1);
 
 //    IasLibPtpDaemon * ptp = IasAvbStreamHandlerEnvironment::getPtpProxy();
 //    uint64_t now = ptp->getLocalTime();
 
-//    IasAvbTransmitSequencer::AvbStreamDataList::iterator nextStream = sequencer->mSequence.begin();
+//    IasAvbTransmitSequencer::StreamData * nextStream = &sequencer->mSequence[0];
 
 //    now = ptp->getLocalTime();
 //    (*nextStream).done = IasAvbTransmitSequencer::DoneState::eNotDone;
@@ -918,7 +1087,7 @@ TEST_F(IasTestAvbTransmitSequencer, reclaimPackets)
 //    struct tx_ring *txr = &adapter->tx_rings[sequencer->mQueueIndex];
 //    uint16_t tempTxAvail = txr->tx_avail;
 //    txr->tx_avail = 1u;
-//    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now, nextStream));
+//    ASSERT_EQ(IasAvbTransmitSequencer::DoneState::eNotDone, sequencer->serviceStream(now));
 //    txr->tx_avail = tempTxAvail;
 //  }
 //}
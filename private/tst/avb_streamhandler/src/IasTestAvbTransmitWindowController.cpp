@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2018 Intel Corporation. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+*/
+/**
+ * @file    IasTestAvbTransmitWindowController.cpp
+ * @brief   The implementation of the IasTestAvbTransmitWindowController test class.
+ * @date    2018
+ */
+
+#include "gtest/gtest.h"
+#define private public
+#define protected public
+#include "avb_streamhandler/IasAvbTransmitWindowController.hpp"
+#undef protected
+#undef private
+
+using namespace IasMediaTransportAvb;
+
+namespace IasMediaTransportAvb
+{
+
+static const uint64_t cWidth = 3000000u;
+static const uint64_t cPitch = 2000000u;
+static const uint64_t cMinWidth = 2125000u;
+static const uint64_t cMaxWidth = 6000000u;
+
+class IasTestAvbTransmitWindowController : public ::testing::Test
+{
+protected:
+  IasTestAvbTransmitWindowController()
+    : mController(NULL)
+  {
+    DLT_REGISTER_APP("IATW", "AVB Streamhandler");
+  }
+
+  virtual ~IasTestAvbTransmitWindowController()
+  {
+    DLT_UNREGISTER_APP();
+  }
+
+  // Sets up the test fixture.
+  virtual void SetUp()
+  {
+    DLT_REGISTER_CONTEXT_LL_TS(mDltCtx,
+              "TEST",
+              "IasTestAvbTransmitWindowController",
+              DLT_LOG_INFO,
+              DLT_TRACE_STATUS_OFF);
+
+    mController = new IasAvbTransmitWindowController(mDltCtx);
+  }
+
+  virtual void TearDown()
+  {
+    delete mController;
+    mController = NULL;
+
+    DLT_UNREGISTER_CONTEXT(mDltCtx);
+  }
+
+  IasAvbTransmitWindowController * mController;
+  DltContext mDltCtx;
+};
+
+} // namespace IasMediaTransportAvb
+
+
+TEST_F(IasTestAvbTransmitWindowController, CTor_DTor)
+{
+  ASSERT_TRUE(NULL != mController);
+}
+
+TEST_F(IasTestAvbTransmitWindowController, init)
+{
+  ASSERT_TRUE(NULL != mController);
+
+  // min width must leave some slack
+  ASSERT_EQ(eIasAvbProcInvalidParam, mController->init(cWidth, cPitch, cPitch, cMaxWidth));
+  // inverted bounds
+  ASSERT_EQ(eIasAvbProcInvalidParam, mController->init(cWidth, cPitch, cMaxWidth, cMinWidth));
+  // initial width out of bounds
+  ASSERT_EQ(eIasAvbProcInvalidParam, mController->init(cMaxWidth + 1u, cPitch, cMinWidth, cMaxWidth));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mController->init(cMinWidth - 1u, cPitch, cMinWidth, cMaxWidth));
+
+  ASSERT_EQ(eIasAvbProcOK, mController->init(cWidth, cPitch, cMinWidth, cMaxWidth));
+  ASSERT_EQ(cWidth, mController->getWidth());
+  ASSERT_EQ(cMaxWidth, mController->getMaxWidth());
+}
+
+TEST_F(IasTestAvbTransmitWindowController, widen)
+{
+  ASSERT_EQ(eIasAvbProcOK, mController->init(cWidth, cPitch, cMinWidth, cMaxWidth));
+
+  // demand within the comfort zone of the 1ms slack
+  ASSERT_FALSE(mController->update(300000u, 200000u));
+  ASSERT_EQ(cWidth, mController->getWidth());
+
+  // demand exceeds 3/4 of the slack: widen at once to twice the demand
+  ASSERT_TRUE(mController->update(700000u, 200000u));
+  ASSERT_EQ(cPitch + 1875000u, mController->getWidth());
+  ASSERT_EQ(1u, mController->getWidenCount());
+
+  // never beyond the upper bound
+  ASSERT_TRUE(mController->update(10000000u, 0u));
+  ASSERT_EQ(cMaxWidth, mController->getWidth());
+  ASSERT_FALSE(mController->update(10000000u, 0u));
+  ASSERT_EQ(cMaxWidth, mController->getWidth());
+}
+
+TEST_F(IasTestAvbTransmitWindowController, narrow)
+{
+  ASSERT_EQ(eIasAvbProcOK, mController->init(cWidth, cPitch, cMinWidth, cMaxWidth));
+
+  // quiet system: one step per evaluation period
+  for (uint32_t i = 1u; i < IasAvbTransmitWindowController::cEvalPeriod; i++)
+  {
+    ASSERT_FALSE(mController->update(10000u, 10000u));
+  }
+  ASSERT_TRUE(mController->update(10000u, 10000u));
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getWidth());
+  ASSERT_EQ(1u, mController->getNarrowCount());
+
+  // a cycle outside the quiet zone restarts the evaluation period
+  for (uint32_t i = 1u; i < IasAvbTransmitWindowController::cEvalPeriod; i++)
+  {
+    ASSERT_FALSE(mController->update(10000u, 10000u));
+  }
+  ASSERT_FALSE(mController->update(300000u, 0u));
+  ASSERT_FALSE(mController->update(10000u, 10000u));
+
+  // never below the lower bound
+  for (uint32_t i = 0u; i < 20u * IasAvbTransmitWindowController::cEvalPeriod; i++)
+  {
+    (void) mController->update(0u, 0u);
+  }
+  ASSERT_EQ(cMinWidth, mController->getWidth());
+
+  mController->reset();
+  ASSERT_EQ(cWidth, mController->getWidth());
+}
+
+TEST_F(IasTestAvbTransmitWindowController, ringFull)
+{
+  ASSERT_EQ(eIasAvbProcOK, mController->init(cWidth, cPitch, cMinWidth, cMaxWidth));
+
+  mController->ringFull();
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getWidth());
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getMaxWidth());
+
+  // the cap limits widening
+  ASSERT_FALSE(mController->update(10000000u, 0u));
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getWidth());
+
+  // the cap is raised by one step after a period without overflow
+  for (uint32_t i = 1u; i < IasAvbTransmitWindowController::cCapRecoveryPeriod - 1u; i++)
+  {
+    (void) mController->update(0u, 1000000u);
+  }
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getMaxWidth());
+  (void) mController->update(0u, 1000000u);
+  ASSERT_EQ(cWidth, mController->getMaxWidth());
+
+  // another overflow restarts the period
+  mController->ringFull();
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getMaxWidth());
+  for (uint32_t i = 1u; i < IasAvbTransmitWindowController::cCapRecoveryPeriod; i++)
+  {
+    (void) mController->update(0u, 1000000u);
+  }
+  ASSERT_EQ(cWidth - IasAvbTransmitWindowController::cStep, mController->getMaxWidth());
+
+  // reset restores the configured bound
+  mController->reset();
+  ASSERT_EQ(cWidth, mController->getWidth());
+  ASSERT_EQ(cMaxWidth, mController->getMaxWidth());
+
+  // not below the lower bound
+  for (uint32_t i = 0u; i < 20u; i++)
+  {
+    mController->ringFull();
+  }
+  ASSERT_EQ(cMinWidth, mController->getWidth());
+}
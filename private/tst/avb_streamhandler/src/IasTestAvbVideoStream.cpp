@@ -931,9 +931,9 @@ TEST_F(IasTestAvbVideoStream, prepareAllPackets)
                                                          dmac,
                                                          preconfigured));
   IasAvbPacketPool * mPool = &mAvbVideoStream->getPacketPool();
-  mPool->mLock.lock();
-  mPool->mFreeBufferStack.clear();
-  mPool->mLock.unlock();
+  // empty the free list
+  mPool->mFreeHead.store(IasAvbPacketPool::cEndOfList);
+  mPool->mFreeCount.store(0u);
   // NULL == referencePacket
   ASSERT_EQ(eIasAvbProcInitializationFailed, mAvbVideoStream->prepareAllPackets());
 }
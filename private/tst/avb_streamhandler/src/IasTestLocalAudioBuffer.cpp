@@ -15,6 +15,8 @@
 #define protected protected
 #define private private
 
+#include <thread>
+
 extern size_t heapSpaceLeft;
 extern size_t heapSpaceInitSize;
 
@@ -118,7 +120,7 @@ TEST_F(IasTestLocalAudioBuffer, read)
 
   uint32_t nrSamples = totalSize + 1u;
   IasLocalAudioBuffer::AudioData buffer[nrSamples];
-  mLocalAudioBuffer->mReadIndex = 0u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 0u;
   mLocalAudioBuffer->mWriteIndex = 2u;
 
   ASSERT_EQ(2u, mLocalAudioBuffer->read(buffer, nrSamples));
@@ -159,14 +161,14 @@ TEST_F(IasTestLocalAudioBuffer, read_not_interleaved)
 
   uint32_t nrSamples = totalSize + 1u;
   IasLocalAudioBuffer::AudioData buffer[nrSamples];
-  mLocalAudioBuffer->mReadIndex = 0u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 0u;
   mLocalAudioBuffer->mWriteIndex = 2u;
 
   ASSERT_EQ(nrSamples, mLocalAudioBuffer->read(buffer, nrSamples
                                                , static_cast<uint32_t>(sizeof(IasLocalAudioBuffer::AudioData))));
 
   nrSamples = totalSize;
-  mLocalAudioBuffer->mReadIndex = 0u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 0u;
   mLocalAudioBuffer->mWriteIndex = 0u;
 
   ASSERT_EQ(0u, mLocalAudioBuffer->read(buffer, nrSamples
@@ -183,15 +185,15 @@ TEST_F(IasTestLocalAudioBuffer, read_not_interleaved_branch)
   uint32_t nrSamples = totalSize + 1u;
   IasLocalAudioBuffer::AudioData buffer[nrSamples];
   uint32_t readIndex = 0u;
-  mLocalAudioBuffer->mReadIndex = readIndex;
+  mLocalAudioBuffer->mReaders[0].readIndex = readIndex;
   mLocalAudioBuffer->mWriteIndex = 1u;
 
   ASSERT_EQ(mLocalAudioBuffer->mWriteIndex - readIndex
              , mLocalAudioBuffer->read(buffer, nrSamples, static_cast<uint32_t>(sizeof(IasLocalAudioBuffer::AudioData))));
-  ASSERT_EQ(nrSamples - (totalSize - readIndex), mLocalAudioBuffer->mReadIndex);
+  ASSERT_EQ(nrSamples - (totalSize - readIndex), mLocalAudioBuffer->mReaders[0].readIndex);
 
   nrSamples = totalSize;
-  mLocalAudioBuffer->mReadIndex = 0u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 0u;
   ASSERT_EQ(nrSamples, mLocalAudioBuffer->read(buffer, nrSamples
              , static_cast<uint32_t>(sizeof(IasLocalAudioBuffer::AudioData))));
 }
@@ -212,16 +214,16 @@ TEST_F(IasTestLocalAudioBuffer, write_not_interleaved)
 
   uint32_t writeIdx = 1u;
   mLocalAudioBuffer->mWriteIndex = writeIdx;
-  mLocalAudioBuffer->mReadIndex = 1u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 1u;
   nrSamples = totalSize;
-  ASSERT_EQ(nrSamples - (writeIdx - mLocalAudioBuffer->mReadIndex) - 1u
+  ASSERT_EQ(nrSamples - (writeIdx - mLocalAudioBuffer->mReaders[0].readIndex) - 1u
              , mLocalAudioBuffer->write(buffer, nrSamples, sizeof(IasLocalAudioBuffer::AudioData)));
-  ASSERT_EQ(writeIdx + totalSize - (writeIdx - mLocalAudioBuffer->mReadIndex) -1u, mLocalAudioBuffer->mWriteIndex);
+  ASSERT_EQ(writeIdx + totalSize - (writeIdx - mLocalAudioBuffer->mReaders[0].readIndex) -1u, mLocalAudioBuffer->mWriteIndex);
 
   uint32_t readIdx = 3u;
   writeIdx = 6u;
   mLocalAudioBuffer->mWriteIndex = writeIdx;
-  mLocalAudioBuffer->mReadIndex = readIdx;
+  mLocalAudioBuffer->mReaders[0].readIndex = readIdx;
   nrSamples = totalSize - 5u;
   uint32_t nrSamplesOut = nrSamples;
   // write method returns the number of the written samples
@@ -237,12 +239,12 @@ TEST_F(IasTestLocalAudioBuffer, read_interleaved)
 
   uint32_t nrSamples = totalSize;
   IasLocalAudioBuffer::AudioData buffer[nrSamples];
-  mLocalAudioBuffer->mReadIndex = 0u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 0u;
   mLocalAudioBuffer->mWriteIndex = 2u;
 
   ASSERT_EQ(nrSamples, mLocalAudioBuffer->read(buffer, nrSamples
                                                , 2 * static_cast<uint32_t>(sizeof(IasLocalAudioBuffer::AudioData))));
-  ASSERT_EQ(0u, mLocalAudioBuffer->mReadIndex);
+  ASSERT_EQ(0u, mLocalAudioBuffer->mReaders[0].readIndex);
   ASSERT_EQ(2u, mLocalAudioBuffer->mWriteIndex);
 }
 
@@ -257,7 +259,7 @@ TEST_F(IasTestLocalAudioBuffer, readInterleavedSampleRead)
   IasLocalAudioBuffer::AudioData buffer[nrSamples];
 
   mLocalAudioBuffer->mWriteIndex = 2u;
-  mLocalAudioBuffer->mReadIndex = 1u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 1u;
   ASSERT_EQ(1u, mLocalAudioBuffer->read(buffer, nrSamples
                                                  , 2 * static_cast<uint32_t>(sizeof(IasLocalAudioBuffer::AudioData))));
 }
@@ -269,7 +271,7 @@ TEST_F(IasTestLocalAudioBuffer, write_interleaved)
   bool doAnalysis = true;
   ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(totalSize, doAnalysis));
 
-  mLocalAudioBuffer->mReadIndex = 2u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 2u;
   mLocalAudioBuffer->mWriteIndex = 2u;
   uint32_t nrSamples = 2u;
   IasLocalAudioBuffer::AudioData buffer[nrSamples * 2] = {0u, 0u, 0u, 0u};
@@ -286,7 +288,7 @@ TEST_F(IasTestLocalAudioBuffer, writeInterleaved)
   bool doAnalysis = true;
   ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(totalSize, doAnalysis));
 
-  mLocalAudioBuffer->mReadIndex = 2u;
+  mLocalAudioBuffer->mReaders[0].readIndex = 2u;
   mLocalAudioBuffer->mWriteIndex = 2u;
   uint32_t nrSamples = 2u;
   IasLocalAudioBuffer::AudioData buffer[8u] = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u};
@@ -317,7 +319,12 @@ TEST_F(IasTestLocalAudioBuffer, read_threshold)
   ASSERT_EQ(1u, mLocalAudioBuffer->write(buffer, nrSamples));
   ASSERT_TRUE(mLocalAudioBuffer->isReadReady());
 
+  // the read ready flag belongs to the producer, it is cleared by the write following the read taking over the reset
   ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->reset(0u));
+  ASSERT_TRUE(mLocalAudioBuffer->isReadReady());
+  ASSERT_EQ(0u, mLocalAudioBuffer->read(buffer, 0u));
+  ASSERT_TRUE(mLocalAudioBuffer->isReadReady());
+  ASSERT_EQ(1u, mLocalAudioBuffer->write(buffer, nrSamples));
   ASSERT_FALSE(mLocalAudioBuffer->isReadReady());
 }
 
@@ -339,8 +346,320 @@ TEST_F(IasTestLocalAudioBuffer, get_monotonic_indexes)
     ASSERT_EQ(1u, mLocalAudioBuffer->read(buffer, nrSamples));
   }
 
+  // the indices keep counting across a reset, the samples dropped count as read
+  IasLocalAudioBuffer::AudioData pair[2];
+  ASSERT_EQ(2u, mLocalAudioBuffer->write(pair, 2u));
   ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->reset(0u));
-  ASSERT_EQ(0u, mLocalAudioBuffer->getMonotonicReadIndex());
-  ASSERT_EQ(0u, mLocalAudioBuffer->getMonotonicWriteIndex());
+  ASSERT_EQ(0u, mLocalAudioBuffer->read(pair, 0u));
+  ASSERT_EQ(totalSize + 3u, mLocalAudioBuffer->getMonotonicReadIndex());
+  ASSERT_EQ(totalSize + 3u, mLocalAudioBuffer->getMonotonicWriteIndex());
+}
+
+TEST_F(IasTestLocalAudioBuffer, concurrentProducerConsumer)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  const uint32_t totalSize = 97u;
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(totalSize, false));
+
+  // producer and consumer use odd chunk sizes to hit the wrap-around at every offset
+  const uint32_t numSamples = 20000u;
+  std::thread producer([this, numSamples]()
+  {
+    IasLocalAudioBuffer::AudioData chunk[13];
+    uint32_t next = 0u;
+    while (next < numSamples)
+    {
+      uint32_t count = 0u;
+      for (; (count < 13u) && ((next + count) < numSamples); count++)
+      {
+        chunk[count] = IasLocalAudioBuffer::AudioData(next + count);
+      }
+
+      // on overrun only the part that fit is taken over, resend the rest
+      next += (count <= (totalSize - 1u - mLocalAudioBuffer->getFillLevel())) ?
+          mLocalAudioBuffer->write(chunk, count) : 0u;
+      std::this_thread::yield();
+    }
+  });
+
+  IasLocalAudioBuffer::AudioData chunk[11];
+  uint32_t expected = 0u;
+  bool inOrder = true;
+  while (inOrder && (expected < numSamples))
+  {
+    const uint32_t samplesRead = mLocalAudioBuffer->read(chunk, 11u);
+    for (uint32_t i = 0u; i < samplesRead; i++)
+    {
+      inOrder = inOrder && (IasLocalAudioBuffer::AudioData(expected) == chunk[i]);
+      expected++;
+    }
+  }
+  producer.join();
+
+  ASSERT_TRUE(inOrder);
+  ASSERT_EQ(numSamples, expected);
+  ASSERT_EQ(uint64_t(numSamples), mLocalAudioBuffer->getMonotonicWriteIndex());
+  ASSERT_EQ(uint64_t(numSamples), mLocalAudioBuffer->getMonotonicReadIndex());
+  ASSERT_EQ(0u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numOverrun);
+}
+
+TEST_F(IasTestLocalAudioBuffer, multipleReaders)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  const uint32_t totalSize = 9u;
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(totalSize, false));
+  ASSERT_EQ(1u, mLocalAudioBuffer->getReaders());
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioBuffer->setReaders(0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioBuffer->setReaders(1u << IasLocalAudioBuffer::cMaxReaders));
+
+  IasLocalAudioBuffer::AudioData in[8];
+  IasLocalAudioBuffer::AudioData out[8];
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    in[i] = IasLocalAudioBuffer::AudioData(i + 1u);
+  }
+
+  ASSERT_EQ(4u, mLocalAudioBuffer->write(in, 4u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->read(out, 1u));
+
+  // cursor 2 joins at the position of cursor 0
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x5u));
+  ASSERT_EQ(3u, mLocalAudioBuffer->getReaderFillLevel(2u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->getMonotonicReadIndex(2u));
+
+  // both cursors see the same samples, the slowest one determines the fill level
+  ASSERT_EQ(3u, mLocalAudioBuffer->read(0u, out, 8u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(2), out[0]);
+  ASSERT_EQ(3u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(4u, mLocalAudioBuffer->getMonotonicReadIndex(0u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->getMonotonicReadIndex());
+  ASSERT_EQ(1u, mLocalAudioBuffer->read(2u, out, 1u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(2), out[0]);
+  ASSERT_EQ(2u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(2u, mLocalAudioBuffer->getMonotonicReadIndex());
+
+  // the space left is limited by the slowest cursor, cursor 0 could take 8 more samples
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numOverrun);
+  ASSERT_EQ(6u, mLocalAudioBuffer->write(in, 8u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->mDiagData.numOverrun);
+  ASSERT_EQ(8u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(6u, mLocalAudioBuffer->getReaderFillLevel(0u));
+
+  // a cursor taken out of use doesn't hold back the producer anymore
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x1u));
+  ASSERT_EQ(6u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(2u, mLocalAudioBuffer->write(in, 2u));
+
+  // a reset moves all cursors
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x3u));
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->reset(2u));
+  ASSERT_EQ(0u, mLocalAudioBuffer->read(1u, out, 0u));
+  ASSERT_EQ(2u, mLocalAudioBuffer->getReaderFillLevel(0u));
+  ASSERT_EQ(2u, mLocalAudioBuffer->getReaderFillLevel(1u));
+  ASSERT_EQ(mLocalAudioBuffer->getMonotonicWriteIndex() - 2u, mLocalAudioBuffer->getMonotonicReadIndex(0u));
+  ASSERT_EQ(mLocalAudioBuffer->getMonotonicWriteIndex() - 2u, mLocalAudioBuffer->getMonotonicReadIndex(1u));
+}
+
+TEST_F(IasTestLocalAudioBuffer, resetRequest)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(16u, false));
+
+  IasLocalAudioBuffer::AudioData in[8];
+  IasLocalAudioBuffer::AudioData out[8];
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    in[i] = IasLocalAudioBuffer::AudioData(i + 1u);
+  }
+  ASSERT_EQ(6u, mLocalAudioBuffer->write(in, 6u));
+
+  // a reset posted by another thread leaves the indices alone until the owners take it over
+  std::thread control([this]() { (void) mLocalAudioBuffer->reset(2u); });
+  control.join();
+  ASSERT_EQ(6u, mLocalAudioBuffer->getFillLevel());
+
+  // the samples written after the request are kept
+  ASSERT_EQ(1u, mLocalAudioBuffer->write(in + 6, 1u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->read(out, 1u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(5), out[0]);
+  ASSERT_EQ(2u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(5u, mLocalAudioBuffer->getMonotonicReadIndex());
+  ASSERT_EQ(4u, mLocalAudioBuffer->getMonotonicResetIndex());
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numReset);
+
+  ASSERT_EQ(1u, mLocalAudioBuffer->write(in, 1u));
+  ASSERT_EQ(1u, mLocalAudioBuffer->mDiagData.numReset);
+
+  // missing samples are zeroed, the monotonic read index goes back by the samples read again
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->reset(4u));
+  ASSERT_EQ(4u, mLocalAudioBuffer->read(out, 8u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(0), out[0]);
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(6), out[1]);
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(7), out[2]);
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(1), out[3]);
+  ASSERT_EQ(mLocalAudioBuffer->getMonotonicWriteIndex(), mLocalAudioBuffer->getMonotonicReadIndex());
+}
 
+TEST_F(IasTestLocalAudioBuffer, trim)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(16u, false));
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x3u));
+
+  IasLocalAudioBuffer::AudioData in[8];
+  IasLocalAudioBuffer::AudioData out[8];
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    in[i] = IasLocalAudioBuffer::AudioData(i + 1u);
+  }
+  ASSERT_EQ(8u, mLocalAudioBuffer->write(in, 8u));
+  ASSERT_EQ(6u, mLocalAudioBuffer->read(1u, out, 6u));
+
+  // only the cursor holding more than the level drops samples, the producer's state isn't reset
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->trim(4u));
+  ASSERT_EQ(0u, mLocalAudioBuffer->read(1u, out, 0u));
+  ASSERT_EQ(4u, mLocalAudioBuffer->getReaderFillLevel(0u));
+  ASSERT_EQ(4u, mLocalAudioBuffer->getMonotonicReadIndex(0u));
+  ASSERT_EQ(2u, mLocalAudioBuffer->getReaderFillLevel(1u));
+  ASSERT_EQ(6u, mLocalAudioBuffer->getMonotonicReadIndex(1u));
+
+  ASSERT_EQ(1u, mLocalAudioBuffer->write(in, 1u));
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numReset);
+  ASSERT_EQ(5u, mLocalAudioBuffer->read(0u, out, 8u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(5), out[0]);
+}
+
+TEST_F(IasTestLocalAudioBuffer, resetReader)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(16u, false));
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x3u));
+
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioBuffer->resetReader(2u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioBuffer->resetReader(IasLocalAudioBuffer::cMaxReaders));
+
+  IasLocalAudioBuffer::AudioData in[8];
+  IasLocalAudioBuffer::AudioData out[8];
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    in[i] = IasLocalAudioBuffer::AudioData(i + 1u);
+  }
+
+  ASSERT_EQ(8u, mLocalAudioBuffer->write(in, 8u));
+  ASSERT_EQ(8u, mLocalAudioBuffer->read(0u, out, 8u));
+  ASSERT_EQ(3u, mLocalAudioBuffer->read(1u, out, 3u));
+
+  // the underrun cursor goes back to the slowest one, the other cursor and the producer aren't touched
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->resetReader(0u));
+  ASSERT_EQ(5u, mLocalAudioBuffer->getReaderFillLevel(0u));
+  ASSERT_EQ(3u, mLocalAudioBuffer->getMonotonicReadIndex(0u));
+  ASSERT_EQ(5u, mLocalAudioBuffer->getReaderFillLevel(1u));
+  ASSERT_EQ(8u, mLocalAudioBuffer->getMonotonicWriteIndex());
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numReset);
+
+  ASSERT_EQ(5u, mLocalAudioBuffer->read(0u, out, 8u));
+  ASSERT_EQ(IasLocalAudioBuffer::AudioData(4), out[0]);
+}
+
+TEST_F(IasTestLocalAudioBuffer, concurrentReaders)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBuffer);
+  const uint32_t totalSize = 97u;
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->init(totalSize, false));
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBuffer->setReaders(0x3u));
+
+  // the producer waits for the slower of the two consumers, both get every sample once and in order
+  const uint32_t numSamples = 20000u;
+  std::thread producer([this, numSamples]()
+  {
+    IasLocalAudioBuffer::AudioData chunk[13];
+    uint32_t next = 0u;
+    while (next < numSamples)
+    {
+      uint32_t count = 0u;
+      for (; (count < 13u) && ((next + count) < numSamples); count++)
+      {
+        chunk[count] = IasLocalAudioBuffer::AudioData(next + count);
+      }
+
+      next += (count <= (totalSize - 1u - mLocalAudioBuffer->getFillLevel())) ?
+          mLocalAudioBuffer->write(chunk, count) : 0u;
+      std::this_thread::yield();
+    }
+  });
+
+  bool inOrder[2] = { true, true };
+  uint32_t expected[2] = { 0u, 0u };
+  std::thread consumer([this, numSamples, &inOrder, &expected]()
+  {
+    IasLocalAudioBuffer::AudioData chunk[5];
+    while (inOrder[1] && (expected[1] < numSamples))
+    {
+      const uint32_t samplesRead = mLocalAudioBuffer->read(1u, chunk, 5u);
+      for (uint32_t i = 0u; i < samplesRead; i++)
+      {
+        inOrder[1] = inOrder[1] && (IasLocalAudioBuffer::AudioData(expected[1]) == chunk[i]);
+        expected[1]++;
+      }
+      std::this_thread::yield();
+    }
+  });
+
+  IasLocalAudioBuffer::AudioData chunk[11];
+  while (inOrder[0] && (expected[0] < numSamples))
+  {
+    const uint32_t samplesRead = mLocalAudioBuffer->read(0u, chunk, 11u);
+    for (uint32_t i = 0u; i < samplesRead; i++)
+    {
+      inOrder[0] = inOrder[0] && (IasLocalAudioBuffer::AudioData(expected[0]) == chunk[i]);
+      expected[0]++;
+    }
+  }
+  consumer.join();
+  producer.join();
+
+  ASSERT_TRUE(inOrder[0]);
+  ASSERT_TRUE(inOrder[1]);
+  ASSERT_EQ(numSamples, expected[0]);
+  ASSERT_EQ(numSamples, expected[1]);
+  ASSERT_EQ(uint64_t(numSamples), mLocalAudioBuffer->getMonotonicReadIndex(1u));
+  ASSERT_EQ(0u, mLocalAudioBuffer->getFillLevel());
+  ASSERT_EQ(0u, mLocalAudioBuffer->mDiagData.numOverrun);
+}
+
+TEST_F(IasTestLocalAudioBuffer, sampleTypes)
+{
+  // all sample types are built, independent of the one selected for the local streams
+  IasLocalAudioBufferT<int32_t> buffer32;
+  ASSERT_EQ(eIasAvbProcOK, buffer32.init(8u, false));
+  int32_t in32[3] = { 0x7FFFFFFF, -0x12345678, 1 };
+  int32_t out32[3] = { 0, 0, 0 };
+  ASSERT_EQ(3u, buffer32.write(in32, 3u));
+  ASSERT_EQ(3u, buffer32.read(out32, 3u));
+  ASSERT_EQ(0, memcmp(in32, out32, sizeof in32));
+
+  IasLocalAudioBufferT<float> bufferFloat;
+  ASSERT_EQ(eIasAvbProcOK, bufferFloat.init(8u, false));
+  float inFloat[2] = { 0.5f, -1.0f };
+  float outFloat[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+  ASSERT_EQ(2u, bufferFloat.write(inFloat, 2u, sizeof(float)));
+  ASSERT_EQ(2u, bufferFloat.read(outFloat, 2u, 2u * sizeof(float)));
+  ASSERT_EQ(0.5f, outFloat[0]);
+  ASSERT_EQ(-1.0f, outFloat[2]);
+
+  // left-justified 32 bit representation
+  ASSERT_EQ(int32_t(0x12340000), IasLocalAudioSampleTraits<int16_t>::toInt32(0x1234));
+  ASSERT_EQ(int16_t(-2), IasLocalAudioSampleTraits<int16_t>::fromInt32(int32_t(0xFFFEFFFF)));
+  ASSERT_EQ(-0x12345678, IasLocalAudioSampleTraits<int32_t>::fromInt32(IasLocalAudioSampleTraits<int32_t>::toInt32(-0x12345678)));
+  ASSERT_EQ(0x7FFFFFFF, IasLocalAudioSampleTraits<float>::toInt32(1.0f));
+
+  // float conversions saturate
+  ASSERT_EQ(int16_t(32767), IasLocalAudioSampleTraits<int16_t>::fromFloat(2.0f));
+  ASSERT_EQ(int16_t(-32768), IasLocalAudioSampleTraits<int16_t>::fromFloat(-2.0f));
+  ASSERT_EQ(0x7FFFFFFF, IasLocalAudioSampleTraits<int32_t>::fromFloat(2.0f));
+  ASSERT_EQ(int32_t(-0x7FFFFFFF - 1), IasLocalAudioSampleTraits<int32_t>::fromFloat(-2.0f));
+  ASSERT_EQ(0x40000000, IasLocalAudioSampleTraits<int32_t>::fromFloat(0.5f));
+  ASSERT_EQ(0.25f, IasLocalAudioSampleTraits<float>::fromFloat(0.25f));
 }
@@ -165,6 +165,45 @@ TEST_F(IasTestLocalAudioBufferDesc, peek)
   ASSERT_EQ(eIasAvbProcErr, result);
 }
 
+TEST_F(IasTestLocalAudioBufferDesc, get_playout_offset)
+{
+  ASSERT_TRUE(NULL != mLocalAudioBufferDesc);
+  (void) mLocalAudioBufferDesc->reset();
+
+  struct IasLocalAudioBufferDesc::AudioBufferDesc desc;
+  const uint64_t pt = 1500000000000000000u;
+  int64_t offset = 0;
+
+  // empty
+  ASSERT_EQ(eIasAvbProcErr, mLocalAudioBufferDesc->getPlayoutOffset(0u, pt, 48000u, offset));
+
+  desc.timeStamp = pt;
+  desc.bufIndex  = 0u;
+  desc.sampleCnt = 48u;
+  (void) mLocalAudioBufferDesc->enqueue(desc);
+
+  ASSERT_EQ(eIasAvbProcErr, mLocalAudioBufferDesc->getPlayoutOffset(0u, pt, 0u, offset));
+
+  // one descriptor, nominal sample rate
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBufferDesc->getPlayoutOffset(0u, pt, 48000u, offset));
+  ASSERT_EQ(0, offset);
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBufferDesc->getPlayoutOffset(48u, pt, 48000u, offset));
+  ASSERT_EQ(48, offset);  // early
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBufferDesc->getPlayoutOffset(0u, pt + 2000000u, 48000u, offset));
+  ASSERT_EQ(-96, offset); // late
+
+  // two descriptors, sample rate seen between them (20 us per sample)
+  desc.timeStamp = pt + 2000000u;
+  desc.bufIndex  = 100u;
+  desc.sampleCnt = 48u;
+  (void) mLocalAudioBufferDesc->enqueue(desc);
+
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBufferDesc->getPlayoutOffset(50u, pt, 48000u, offset));
+  ASSERT_EQ(50, offset);
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioBufferDesc->getPlayoutOffset(50u, pt + 1000000u, 48000u, offset));
+  ASSERT_EQ(0, offset);
+}
+
 TEST_F(IasTestLocalAudioBufferDesc, reset_request)
 {
   ASSERT_TRUE(NULL != mLocalAudioBufferDesc);
@@ -185,6 +224,7 @@ TEST_F(IasTestLocalAudioBufferDesc, get_mode_name)
       AudioBufferDescMode::eIasAudioBufferDescModeOff,
       AudioBufferDescMode::eIasAudioBufferDescModeFailSafe,
       AudioBufferDescMode::eIasAudioBufferDescModeHard,
+      AudioBufferDescMode::eIasAudioBufferDescModePresentation,
       AudioBufferDescMode::eIasAudioBufferDescModeLast
   };
 
@@ -193,6 +233,7 @@ TEST_F(IasTestLocalAudioBufferDesc, get_mode_name)
       "off",
       "fail-safe",
       "hard",
+      "presentation",
       "invalid"
   };
 
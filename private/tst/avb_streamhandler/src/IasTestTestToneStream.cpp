@@ -260,6 +260,35 @@ TEST_F(IasTestTestToneStream, LOCAL_AUDIO_ReadLocalAudioBuffer)
   samplesRead = 0;
 }
 
+TEST_F(IasTestTestToneStream, LOCAL_AUDIO_ReadLocalAudioBuffers)
+{
+  ASSERT_TRUE(mLocalAudioStream != NULL);
+
+  const uint32_t bufferSize = 64u;
+  IasLocalAudioBuffer::AudioData buffer[2u * bufferSize];
+  uint16_t samplesRead = 0u;
+  uint64_t timeStamp = 1u;
+
+  ASSERT_EQ(eIasAvbProcNotInitialized, mLocalAudioStream->readLocalAudioBuffers(2u, buffer, bufferSize, samplesRead, timeStamp));
+
+  ASSERT_EQ(eIasAvbProcOK, mTestToneStream->init(2u, 48000u, 0u));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioStream->readLocalAudioBuffers(0u, buffer, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioStream->readLocalAudioBuffers(3u, buffer, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioStream->readLocalAudioBuffers(2u, NULL, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(eIasAvbProcInvalidParam, mLocalAudioStream->readLocalAudioBuffers(2u, buffer, 0u, samplesRead, timeStamp));
+
+  // channel 1 generates a pulse, which starts with its peak value
+  ASSERT_EQ(eIasAvbProcOK, mTestToneStream->setChannelParams(1, 1000, -6, IasAvbTestToneMode::eIasAvbTestTonePulse, 50));
+  ASSERT_EQ(eIasAvbProcOK, mLocalAudioStream->readLocalAudioBuffers(2u, buffer, bufferSize, samplesRead, timeStamp));
+  ASSERT_EQ(bufferSize, samplesRead);
+  ASSERT_EQ(0u, timeStamp);
+  ASSERT_NE(0, buffer[bufferSize]);
+  ASSERT_EQ(buffer[bufferSize], buffer[bufferSize + 1u]);
+
+  uint16_t samplesWritten = 0u;
+  ASSERT_EQ(eIasAvbProcNotImplemented, mLocalAudioStream->writeLocalAudioBuffers(2u, buffer, bufferSize, samplesWritten, 0u));
+}
+
 TEST_F(IasTestTestToneStream, HEAP_fail_testing)
 {
   ASSERT_TRUE(mTestToneStream != NULL);
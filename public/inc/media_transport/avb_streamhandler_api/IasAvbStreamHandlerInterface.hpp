@@ -182,6 +182,30 @@ class IAS_DSO_PUBLIC IasAvbStreamHandlerInterface
      */
     virtual IasAvbResult disconnectStreams(AvbStreamId networkStreamId) = 0;
 
+    /**
+     * @brief Sets the channel routing between an AVB audio stream and its local audio stream.
+     *
+     *  By default, channel i of the AVB stream is connected to channel i of the local stream. A routing
+     *  list replaces this by a matrix: each entry adds a source channel, multiplied by its gain, to a
+     *  destination channel. Any channel can be picked, a source can feed several destinations (fan-out)
+     *  and a destination can sum up several sources (fan-in). Destination channels without an entry
+     *  are silent. The sums are saturated.
+     *
+     *  For transmit streams, the number of channels sent is given by the highest destination index.
+     *  The routing is kept when the AVB stream is connected to another local stream, entries that
+     *  refer to channels the local stream doesn't have are ignored. An empty list restores the default
+     *  routing.
+     *
+     *  Several receive streams connected to the same local stream are mixed. The gains of their
+     *  routing lists set the level of each source within the mix.
+     *
+     * @param[in] networkStreamId   ID of AVB audio stream
+     * @param[in] routing           routing entries, all channel indices must be below the maximum
+     *                              number of channels of the AVB stream
+     * @returns eIasAvbResultOk upon success, an error code otherwise
+     */
+    virtual IasAvbResult setChannelRouting(AvbStreamId networkStreamId, const ChannelRoutingList &routing) = 0;
+
     /**
      * @brief Sets the layout of the audio data within the stream.
      *
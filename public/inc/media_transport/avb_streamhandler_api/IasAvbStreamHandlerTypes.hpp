@@ -924,6 +924,31 @@ typedef std::vector<IasAvbAudioStreamAttributes> AudioStreamInfoList;
 typedef std::vector<IasAvbVideoStreamAttributes> VideoStreamInfoList;
 typedef std::vector<IasAvbClockReferenceStreamAttributes> ClockReferenceStreamInfoList;
 
+/*!
+ * @brief One entry of the channel routing matrix of an AVB audio stream.
+ *
+ * The source channel, multiplied by gain, is added to the destination channel. For receive streams,
+ * the source is a channel of the AVB stream and the destination a channel of the local stream; for
+ * transmit streams it is the other way around.
+ */
+struct IasAvbChannelRoute
+{
+  /*!
+   * index of the source channel
+   */
+  uint16_t source;
+  /*!
+   * index of the destination channel
+   */
+  uint16_t destination;
+  /*!
+   * linear gain, 1.0 passes the channel unchanged
+   */
+  float gain;
+};
+
+typedef std::vector<IasAvbChannelRoute> ChannelRoutingList;
+
 /* const values are implemented through static inline getter functions in CommonAPI.
  * This breaks our table-driven configuration design, so we redeclare them as real constants
  * here.